@@ -30,6 +30,7 @@
 #include <google/protobuf/wire_format.h>
 // @@protoc_insertion_point(includes)
 #include <google/protobuf/port_def.inc>
+extern PROTOBUF_INTERNAL_EXPORT_google_2ffirestore_2fv1_2fquery_2eproto ::PROTOBUF_NAMESPACE_ID::internal::SCCInfo<1> scc_info_Cursor_google_2ffirestore_2fv1_2fquery_2eproto;
 extern PROTOBUF_INTERNAL_EXPORT_google_2ffirestore_2fv1_2fdocument_2eproto ::PROTOBUF_NAMESPACE_ID::internal::SCCInfo<2> scc_info_Document_google_2ffirestore_2fv1_2fdocument_2eproto;
 extern PROTOBUF_INTERNAL_EXPORT_google_2ffirestore_2fv1_2fwrite_2eproto ::PROTOBUF_NAMESPACE_ID::internal::SCCInfo<1> scc_info_DocumentChange_google_2ffirestore_2fv1_2fwrite_2eproto;
 extern PROTOBUF_INTERNAL_EXPORT_google_2ffirestore_2fv1_2fwrite_2eproto ::PROTOBUF_NAMESPACE_ID::internal::SCCInfo<1> scc_info_DocumentDelete_google_2ffirestore_2fv1_2fwrite_2eproto;
@@ -125,6 +126,16 @@ class RunQueryResponseDefaultTypeInternal {
  public:
   ::PROTOBUF_NAMESPACE_ID::internal::ExplicitlyConstructed<RunQueryResponse> _instance;
 } _RunQueryResponse_default_instance_;
+class PartitionQueryRequestDefaultTypeInternal {
+ public:
+  ::PROTOBUF_NAMESPACE_ID::internal::ExplicitlyConstructed<PartitionQueryRequest> _instance;
+  const ::google::firestore::v1::StructuredQuery* structured_query_;
+  const PROTOBUF_NAMESPACE_ID::Timestamp* read_time_;
+} _PartitionQueryRequest_default_instance_;
+class PartitionQueryResponseDefaultTypeInternal {
+ public:
+  ::PROTOBUF_NAMESPACE_ID::internal::ExplicitlyConstructed<PartitionQueryResponse> _instance;
+} _PartitionQueryResponse_default_instance_;
 class WriteRequest_LabelsEntry_DoNotUseDefaultTypeInternal {
  public:
   ::PROTOBUF_NAMESPACE_ID::internal::ExplicitlyConstructed<WriteRequest_LabelsEntry_DoNotUse> _instance;
@@ -435,6 +446,37 @@ static void InitDefaultsscc_info_ListenResponse_google_2ffirestore_2fv1_2ffirest
       &scc_info_DocumentRemove_google_2ffirestore_2fv1_2fwrite_2eproto.base,
       &scc_info_ExistenceFilter_google_2ffirestore_2fv1_2fwrite_2eproto.base,}};
 
+static void InitDefaultsscc_info_PartitionQueryRequest_google_2ffirestore_2fv1_2ffirestore_2eproto() {
+  GOOGLE_PROTOBUF_VERIFY_VERSION;
+
+  {
+    void* ptr = &::google::firestore::v1::_PartitionQueryRequest_default_instance_;
+    new (ptr) ::google::firestore::v1::PartitionQueryRequest();
+    ::PROTOBUF_NAMESPACE_ID::internal::OnShutdownDestroyMessage(ptr);
+  }
+  ::google::firestore::v1::PartitionQueryRequest::InitAsDefaultInstance();
+}
+
+::PROTOBUF_NAMESPACE_ID::internal::SCCInfo<2> scc_info_PartitionQueryRequest_google_2ffirestore_2fv1_2ffirestore_2eproto =
+    {{ATOMIC_VAR_INIT(::PROTOBUF_NAMESPACE_ID::internal::SCCInfoBase::kUninitialized), 2, 0, InitDefaultsscc_info_PartitionQueryRequest_google_2ffirestore_2fv1_2ffirestore_2eproto}, {
+      &scc_info_StructuredQuery_google_2ffirestore_2fv1_2fquery_2eproto.base,
+      &scc_info_Timestamp_google_2fprotobuf_2ftimestamp_2eproto.base,}};
+
+static void InitDefaultsscc_info_PartitionQueryResponse_google_2ffirestore_2fv1_2ffirestore_2eproto() {
+  GOOGLE_PROTOBUF_VERIFY_VERSION;
+
+  {
+    void* ptr = &::google::firestore::v1::_PartitionQueryResponse_default_instance_;
+    new (ptr) ::google::firestore::v1::PartitionQueryResponse();
+    ::PROTOBUF_NAMESPACE_ID::internal::OnShutdownDestroyMessage(ptr);
+  }
+  ::google::firestore::v1::PartitionQueryResponse::InitAsDefaultInstance();
+}
+
+::PROTOBUF_NAMESPACE_ID::internal::SCCInfo<1> scc_info_PartitionQueryResponse_google_2ffirestore_2fv1_2ffirestore_2eproto =
+    {{ATOMIC_VAR_INIT(::PROTOBUF_NAMESPACE_ID::internal::SCCInfoBase::kUninitialized), 1, 0, InitDefaultsscc_info_PartitionQueryResponse_google_2ffirestore_2fv1_2ffirestore_2eproto}, {
+      &scc_info_Cursor_google_2ffirestore_2fv1_2fquery_2eproto.base,}};
+
 static void InitDefaultsscc_info_RollbackRequest_google_2ffirestore_2fv1_2ffirestore_2eproto() {
   GOOGLE_PROTOBUF_VERIFY_VERSION;
 
@@ -606,7 +648,7 @@ static void InitDefaultsscc_info_WriteResponse_google_2ffirestore_2fv1_2ffiresto
       &scc_info_WriteResult_google_2ffirestore_2fv1_2fwrite_2eproto.base,
       &scc_info_Timestamp_google_2fprotobuf_2ftimestamp_2eproto.base,}};
 
-static ::PROTOBUF_NAMESPACE_ID::Metadata file_level_metadata_google_2ffirestore_2fv1_2ffirestore_2eproto[27];
+static ::PROTOBUF_NAMESPACE_ID::Metadata file_level_metadata_google_2ffirestore_2fv1_2ffirestore_2eproto[29];
 static const ::PROTOBUF_NAMESPACE_ID::EnumDescriptor* file_level_enum_descriptors_google_2ffirestore_2fv1_2ffirestore_2eproto[1];
 static constexpr ::PROTOBUF_NAMESPACE_ID::ServiceDescriptor const** file_level_service_descriptors_google_2ffirestore_2fv1_2ffirestore_2eproto = nullptr;
 
@@ -747,6 +789,26 @@ const ::PROTOBUF_NAMESPACE_ID::uint32 TableStruct_google_2ffirestore_2fv1_2ffire
   PROTOBUF_FIELD_OFFSET(::google::firestore::v1::RunQueryResponse, document_),
   PROTOBUF_FIELD_OFFSET(::google::firestore::v1::RunQueryResponse, read_time_),
   PROTOBUF_FIELD_OFFSET(::google::firestore::v1::RunQueryResponse, skipped_results_),
+  ~0u,  // no _has_bits_
+  PROTOBUF_FIELD_OFFSET(::google::firestore::v1::PartitionQueryRequest, _internal_metadata_),
+  ~0u,  // no _extensions_
+  PROTOBUF_FIELD_OFFSET(::google::firestore::v1::PartitionQueryRequest, _oneof_case_[0]),
+  ~0u,  // no _weak_field_map_
+  PROTOBUF_FIELD_OFFSET(::google::firestore::v1::PartitionQueryRequest, parent_),
+  offsetof(::google::firestore::v1::PartitionQueryRequestDefaultTypeInternal, structured_query_),
+  PROTOBUF_FIELD_OFFSET(::google::firestore::v1::PartitionQueryRequest, partition_count_),
+  PROTOBUF_FIELD_OFFSET(::google::firestore::v1::PartitionQueryRequest, page_token_),
+  PROTOBUF_FIELD_OFFSET(::google::firestore::v1::PartitionQueryRequest, page_size_),
+  offsetof(::google::firestore::v1::PartitionQueryRequestDefaultTypeInternal, read_time_),
+  PROTOBUF_FIELD_OFFSET(::google::firestore::v1::PartitionQueryRequest, query_type_),
+  PROTOBUF_FIELD_OFFSET(::google::firestore::v1::PartitionQueryRequest, consistency_selector_),
+  ~0u,  // no _has_bits_
+  PROTOBUF_FIELD_OFFSET(::google::firestore::v1::PartitionQueryResponse, _internal_metadata_),
+  ~0u,  // no _extensions_
+  ~0u,  // no _oneof_case_
+  ~0u,  // no _weak_field_map_
+  PROTOBUF_FIELD_OFFSET(::google::firestore::v1::PartitionQueryResponse, partitions_),
+  PROTOBUF_FIELD_OFFSET(::google::firestore::v1::PartitionQueryResponse, next_page_token_),
   PROTOBUF_FIELD_OFFSET(::google::firestore::v1::WriteRequest_LabelsEntry_DoNotUse, _has_bits_),
   PROTOBUF_FIELD_OFFSET(::google::firestore::v1::WriteRequest_LabelsEntry_DoNotUse, _internal_metadata_),
   ~0u,  // no _extensions_
@@ -874,18 +936,20 @@ static const ::PROTOBUF_NAMESPACE_ID::internal::MigrationSchema schemas[] PROTOB
   { 108, -1, sizeof(::google::firestore::v1::RollbackRequest)},
   { 115, -1, sizeof(::google::firestore::v1::RunQueryRequest)},
   { 127, -1, sizeof(::google::firestore::v1::RunQueryResponse)},
-  { 136, 143, sizeof(::google::firestore::v1::WriteRequest_LabelsEntry_DoNotUse)},
-  { 145, -1, sizeof(::google::firestore::v1::WriteRequest)},
-  { 155, -1, sizeof(::google::firestore::v1::WriteResponse)},
-  { 164, 171, sizeof(::google::firestore::v1::ListenRequest_LabelsEntry_DoNotUse)},
-  { 173, -1, sizeof(::google::firestore::v1::ListenRequest)},
-  { 183, -1, sizeof(::google::firestore::v1::ListenResponse)},
-  { 194, -1, sizeof(::google::firestore::v1::Target_DocumentsTarget)},
-  { 200, -1, sizeof(::google::firestore::v1::Target_QueryTarget)},
-  { 208, -1, sizeof(::google::firestore::v1::Target)},
-  { 221, -1, sizeof(::google::firestore::v1::TargetChange)},
-  { 231, -1, sizeof(::google::firestore::v1::ListCollectionIdsRequest)},
-  { 239, -1, sizeof(::google::firestore::v1::ListCollectionIdsResponse)},
+  { 136, -1, sizeof(::google::firestore::v1::PartitionQueryRequest)},
+  { 149, -1, sizeof(::google::firestore::v1::PartitionQueryResponse)},
+  { 156, 163, sizeof(::google::firestore::v1::WriteRequest_LabelsEntry_DoNotUse)},
+  { 165, -1, sizeof(::google::firestore::v1::WriteRequest)},
+  { 175, -1, sizeof(::google::firestore::v1::WriteResponse)},
+  { 184, 191, sizeof(::google::firestore::v1::ListenRequest_LabelsEntry_DoNotUse)},
+  { 193, -1, sizeof(::google::firestore::v1::ListenRequest)},
+  { 203, -1, sizeof(::google::firestore::v1::ListenResponse)},
+  { 214, -1, sizeof(::google::firestore::v1::Target_DocumentsTarget)},
+  { 220, -1, sizeof(::google::firestore::v1::Target_QueryTarget)},
+  { 228, -1, sizeof(::google::firestore::v1::Target)},
+  { 241, -1, sizeof(::google::firestore::v1::TargetChange)},
+  { 251, -1, sizeof(::google::firestore::v1::ListCollectionIdsRequest)},
+  { 259, -1, sizeof(::google::firestore::v1::ListCollectionIdsResponse)},
 };
 
 static ::PROTOBUF_NAMESPACE_ID::Message const * const file_default_instances[] = {
@@ -904,6 +968,8 @@ static ::PROTOBUF_NAMESPACE_ID::Message const * const file_default_instances[] =
   reinterpret_cast<const ::PROTOBUF_NAMESPACE_ID::Message*>(&::google::firestore::v1::_RollbackRequest_default_instance_),
   reinterpret_cast<const ::PROTOBUF_NAMESPACE_ID::Message*>(&::google::firestore::v1::_RunQueryRequest_default_instance_),
   reinterpret_cast<const ::PROTOBUF_NAMESPACE_ID::Message*>(&::google::firestore::v1::_RunQueryResponse_default_instance_),
+  reinterpret_cast<const ::PROTOBUF_NAMESPACE_ID::Message*>(&::google::firestore::v1::_PartitionQueryRequest_default_instance_),
+  reinterpret_cast<const ::PROTOBUF_NAMESPACE_ID::Message*>(&::google::firestore::v1::_PartitionQueryResponse_default_instance_),
   reinterpret_cast<const ::PROTOBUF_NAMESPACE_ID::Message*>(&::google::firestore::v1::_WriteRequest_LabelsEntry_DoNotUse_default_instance_),
   reinterpret_cast<const ::PROTOBUF_NAMESPACE_ID::Message*>(&::google::firestore::v1::_WriteRequest_default_instance_),
   reinterpret_cast<const ::PROTOBUF_NAMESPACE_ID::Message*>(&::google::firestore::v1::_WriteResponse_default_instance_),
@@ -987,116 +1053,131 @@ const char descriptor_table_protodef_google_2ffirestore_2fv1_2ffirestore_2eproto
   "ransaction\030\002 \001(\014\022/\n\010document\030\001 \001(\0132\035.goo"
   "gle.firestore.v1.Document\022-\n\tread_time\030\003"
   " \001(\0132\032.google.protobuf.Timestamp\022\027\n\017skip"
-  "ped_results\030\004 \001(\005\"\343\001\n\014WriteRequest\022\020\n\010da"
-  "tabase\030\001 \001(\t\022\021\n\tstream_id\030\002 \001(\t\022*\n\006write"
-  "s\030\003 \003(\0132\032.google.firestore.v1.Write\022\024\n\014s"
-  "tream_token\030\004 \001(\014\022=\n\006labels\030\005 \003(\0132-.goog"
-  "le.firestore.v1.WriteRequest.LabelsEntry"
-  "\032-\n\013LabelsEntry\022\013\n\003key\030\001 \001(\t\022\r\n\005value\030\002 "
-  "\001(\t:\0028\001\"\242\001\n\rWriteResponse\022\021\n\tstream_id\030\001"
-  " \001(\t\022\024\n\014stream_token\030\002 \001(\014\0227\n\rwrite_resu"
-  "lts\030\003 \003(\0132 .google.firestore.v1.WriteRes"
-  "ult\022/\n\013commit_time\030\004 \001(\0132\032.google.protob"
-  "uf.Timestamp\"\355\001\n\rListenRequest\022\020\n\010databa"
-  "se\030\001 \001(\t\0221\n\nadd_target\030\002 \001(\0132\033.google.fi"
-  "restore.v1.TargetH\000\022\027\n\rremove_target\030\003 \001"
-  "(\005H\000\022>\n\006labels\030\004 \003(\0132..google.firestore."
-  "v1.ListenRequest.LabelsEntry\032-\n\013LabelsEn"
-  "try\022\013\n\003key\030\001 \001(\t\022\r\n\005value\030\002 \001(\t:\0028\001B\017\n\rt"
-  "arget_change\"\325\002\n\016ListenResponse\022:\n\rtarge"
-  "t_change\030\002 \001(\0132!.google.firestore.v1.Tar"
-  "getChangeH\000\022>\n\017document_change\030\003 \001(\0132#.g"
-  "oogle.firestore.v1.DocumentChangeH\000\022>\n\017d"
-  "ocument_delete\030\004 \001(\0132#.google.firestore."
-  "v1.DocumentDeleteH\000\022>\n\017document_remove\030\006"
-  " \001(\0132#.google.firestore.v1.DocumentRemov"
-  "eH\000\0226\n\006filter\030\005 \001(\0132$.google.firestore.v"
-  "1.ExistenceFilterH\000B\017\n\rresponse_type\"\241\003\n"
-  "\006Target\0228\n\005query\030\002 \001(\0132\'.google.firestor"
-  "e.v1.Target.QueryTargetH\000\022@\n\tdocuments\030\003"
-  " \001(\0132+.google.firestore.v1.Target.Docume"
-  "ntsTargetH\000\022\026\n\014resume_token\030\004 \001(\014H\001\022/\n\tr"
-  "ead_time\030\013 \001(\0132\032.google.protobuf.Timesta"
-  "mpH\001\022\021\n\ttarget_id\030\005 \001(\005\022\014\n\004once\030\006 \001(\010\032$\n"
-  "\017DocumentsTarget\022\021\n\tdocuments\030\002 \003(\t\032m\n\013Q"
-  "ueryTarget\022\016\n\006parent\030\001 \001(\t\022@\n\020structured"
-  "_query\030\002 \001(\0132$.google.firestore.v1.Struc"
-  "turedQueryH\000B\014\n\nquery_typeB\r\n\013target_typ"
-  "eB\r\n\013resume_type\"\252\002\n\014TargetChange\022N\n\022tar"
-  "get_change_type\030\001 \001(\01622.google.firestore"
-  ".v1.TargetChange.TargetChangeType\022\022\n\ntar"
-  "get_ids\030\002 \003(\005\022!\n\005cause\030\003 \001(\0132\022.google.rp"
-  "c.Status\022\024\n\014resume_token\030\004 \001(\014\022-\n\tread_t"
-  "ime\030\006 \001(\0132\032.google.protobuf.Timestamp\"N\n"
-  "\020TargetChangeType\022\r\n\tNO_CHANGE\020\000\022\007\n\003ADD\020"
-  "\001\022\n\n\006REMOVE\020\002\022\013\n\007CURRENT\020\003\022\t\n\005RESET\020\004\"Q\n"
-  "\030ListCollectionIdsRequest\022\016\n\006parent\030\001 \001("
-  "\t\022\021\n\tpage_size\030\002 \001(\005\022\022\n\npage_token\030\003 \001(\t"
-  "\"L\n\031ListCollectionIdsResponse\022\026\n\016collect"
-  "ion_ids\030\001 \003(\t\022\027\n\017next_page_token\030\002 \001(\t2\204"
-  "\022\n\tFirestore\022\217\001\n\013GetDocument\022\'.google.fi"
-  "restore.v1.GetDocumentRequest\032\035.google.f"
-  "irestore.v1.Document\"8\202\323\344\223\0022\0220/v1/{name="
-  "projects/*/databases/*/documents/*/**}\022\262"
-  "\001\n\rListDocuments\022).google.firestore.v1.L"
-  "istDocumentsRequest\032*.google.firestore.v"
-  "1.ListDocumentsResponse\"J\202\323\344\223\002D\022B/v1/{pa"
-  "rent=projects/*/databases/*/documents/*/"
-  "**}/{collection_id}\022\257\001\n\016CreateDocument\022*"
-  ".google.firestore.v1.CreateDocumentReque"
-  "st\032\035.google.firestore.v1.Document\"R\202\323\344\223\002"
-  "L\"@/v1/{parent=projects/*/databases/*/do"
-  "cuments/**}/{collection_id}:\010document\022\250\001"
-  "\n\016UpdateDocument\022*.google.firestore.v1.U"
-  "pdateDocumentRequest\032\035.google.firestore."
-  "v1.Document\"K\202\323\344\223\002E29/v1/{document.name="
-  "projects/*/databases/*/documents/*/**}:\010"
-  "document\022\216\001\n\016DeleteDocument\022*.google.fir"
-  "estore.v1.DeleteDocumentRequest\032\026.google"
-  ".protobuf.Empty\"8\202\323\344\223\0022*0/v1/{name=proje"
-  "cts/*/databases/*/documents/*/**}\022\271\001\n\021Ba"
-  "tchGetDocuments\022-.google.firestore.v1.Ba"
-  "tchGetDocumentsRequest\032..google.firestor"
-  "e.v1.BatchGetDocumentsResponse\"C\202\323\344\223\002=\"8"
-  "/v1/{database=projects/*/databases/*}/do"
-  "cuments:batchGet:\001*0\001\022\274\001\n\020BeginTransacti"
-  "on\022,.google.firestore.v1.BeginTransactio"
-  "nRequest\032-.google.firestore.v1.BeginTran"
-  "sactionResponse\"K\202\323\344\223\002E\"@/v1/{database=p"
-  "rojects/*/databases/*}/documents:beginTr"
-  "ansaction:\001*\022\224\001\n\006Commit\022\".google.firesto"
-  "re.v1.CommitRequest\032#.google.firestore.v"
-  "1.CommitResponse\"A\202\323\344\223\002;\"6/v1/{database="
-  "projects/*/databases/*}/documents:commit"
-  ":\001*\022\215\001\n\010Rollback\022$.google.firestore.v1.R"
-  "ollbackRequest\032\026.google.protobuf.Empty\"C"
-  "\202\323\344\223\002=\"8/v1/{database=projects/*/databas"
-  "es/*}/documents:rollback:\001*\022\337\001\n\010RunQuery"
-  "\022$.google.firestore.v1.RunQueryRequest\032%"
-  ".google.firestore.v1.RunQueryResponse\"\203\001"
-  "\202\323\344\223\002}\"6/v1/{parent=projects/*/databases"
-  "/*/documents}:runQuery:\001*Z@\";/v1/{parent"
-  "=projects/*/databases/*/documents/*/**}:"
-  "runQuery:\001*0\001\022\224\001\n\005Write\022!.google.firesto"
-  "re.v1.WriteRequest\032\".google.firestore.v1"
-  ".WriteResponse\"@\202\323\344\223\002:\"5/v1/{database=pr"
-  "ojects/*/databases/*}/documents:write:\001*"
-  "(\0010\001\022\230\001\n\006Listen\022\".google.firestore.v1.Li"
-  "stenRequest\032#.google.firestore.v1.Listen"
-  "Response\"A\202\323\344\223\002;\"6/v1/{database=projects"
-  "/*/databases/*}/documents:listen:\001*(\0010\001\022"
-  "\213\002\n\021ListCollectionIds\022-.google.firestore"
-  ".v1.ListCollectionIdsRequest\032..google.fi"
-  "restore.v1.ListCollectionIdsResponse\"\226\001\202"
-  "\323\344\223\002\217\001\"\?/v1/{parent=projects/*/databases"
-  "/*/documents}:listCollectionIds:\001*ZI\"D/v"
-  "1/{parent=projects/*/databases/*/documen"
-  "ts/*/**}:listCollectionIds:\001*B\262\001\n\027com.go"
-  "ogle.firestore.v1B\016FirestoreProtoP\001Z<goo"
-  "gle.golang.org/genproto/googleapis/fires"
-  "tore/v1;firestore\242\002\004GCFS\252\002\036Google.Cloud."
-  "Firestore.V1Beta1\312\002\036Google\\Cloud\\Firesto"
-  "re\\V1beta1b\006proto3"
+  "ped_results\030\004 \001(\005\"\200\002\n\025PartitionQueryRequ"
+  "est\022\016\n\006parent\030\001 \001(\t\022@\n\020structured_query\030"
+  "\002 \001(\0132$.google.firestore.v1.StructuredQu"
+  "eryH\000\022\027\n\017partition_count\030\003 \001(\003\022\022\n\npage_t"
+  "oken\030\004 \001(\t\022\021\n\tpage_size\030\005 \001(\005\022/\n\tread_ti"
+  "me\030\006 \001(\0132\032.google.protobuf.TimestampH\001B\014"
+  "\n\nquery_typeB\026\n\024consistency_selector\"b\n\026"
+  "PartitionQueryResponse\022/\n\npartitions\030\001 \003"
+  "(\0132\033.google.firestore.v1.Cursor\022\027\n\017next_"
+  "page_token\030\002 \001(\t\"\343\001\n\014WriteRequest\022\020\n\010dat"
+  "abase\030\001 \001(\t\022\021\n\tstream_id\030\002 \001(\t\022*\n\006writes"
+  "\030\003 \003(\0132\032.google.firestore.v1.Write\022\024\n\014st"
+  "ream_token\030\004 \001(\014\022=\n\006labels\030\005 \003(\0132-.googl"
+  "e.firestore.v1.WriteRequest.LabelsEntry\032"
+  "-\n\013LabelsEntry\022\013\n\003key\030\001 \001(\t\022\r\n\005value\030\002 \001"
+  "(\t:\0028\001\"\242\001\n\rWriteResponse\022\021\n\tstream_id\030\001 "
+  "\001(\t\022\024\n\014stream_token\030\002 \001(\014\0227\n\rwrite_resul"
+  "ts\030\003 \003(\0132 .google.firestore.v1.WriteResu"
+  "lt\022/\n\013commit_time\030\004 \001(\0132\032.google.protobu"
+  "f.Timestamp\"\355\001\n\rListenRequest\022\020\n\010databas"
+  "e\030\001 \001(\t\0221\n\nadd_target\030\002 \001(\0132\033.google.fir"
+  "estore.v1.TargetH\000\022\027\n\rremove_target\030\003 \001("
+  "\005H\000\022>\n\006labels\030\004 \003(\0132..google.firestore.v"
+  "1.ListenRequest.LabelsEntry\032-\n\013LabelsEnt"
+  "ry\022\013\n\003key\030\001 \001(\t\022\r\n\005value\030\002 \001(\t:\0028\001B\017\n\rta"
+  "rget_change\"\325\002\n\016ListenResponse\022:\n\rtarget"
+  "_change\030\002 \001(\0132!.google.firestore.v1.Targ"
+  "etChangeH\000\022>\n\017document_change\030\003 \001(\0132#.go"
+  "ogle.firestore.v1.DocumentChangeH\000\022>\n\017do"
+  "cument_delete\030\004 \001(\0132#.google.firestore.v"
+  "1.DocumentDeleteH\000\022>\n\017document_remove\030\006 "
+  "\001(\0132#.google.firestore.v1.DocumentRemove"
+  "H\000\0226\n\006filter\030\005 \001(\0132$.google.firestore.v1"
+  ".ExistenceFilterH\000B\017\n\rresponse_type\"\241\003\n\006"
+  "Target\0228\n\005query\030\002 \001(\0132\'.google.firestore"
+  ".v1.Target.QueryTargetH\000\022@\n\tdocuments\030\003 "
+  "\001(\0132+.google.firestore.v1.Target.Documen"
+  "tsTargetH\000\022\026\n\014resume_token\030\004 \001(\014H\001\022/\n\tre"
+  "ad_time\030\013 \001(\0132\032.google.protobuf.Timestam"
+  "pH\001\022\021\n\ttarget_id\030\005 \001(\005\022\014\n\004once\030\006 \001(\010\032$\n\017"
+  "DocumentsTarget\022\021\n\tdocuments\030\002 \003(\t\032m\n\013Qu"
+  "eryTarget\022\016\n\006parent\030\001 \001(\t\022@\n\020structured_"
+  "query\030\002 \001(\0132$.google.firestore.v1.Struct"
+  "uredQueryH\000B\014\n\nquery_typeB\r\n\013target_type"
+  "B\r\n\013resume_type\"\252\002\n\014TargetChange\022N\n\022targ"
+  "et_change_type\030\001 \001(\01622.google.firestore."
+  "v1.TargetChange.TargetChangeType\022\022\n\ntarg"
+  "et_ids\030\002 \003(\005\022!\n\005cause\030\003 \001(\0132\022.google.rpc"
+  ".Status\022\024\n\014resume_token\030\004 \001(\014\022-\n\tread_ti"
+  "me\030\006 \001(\0132\032.google.protobuf.Timestamp\"N\n\020"
+  "TargetChangeType\022\r\n\tNO_CHANGE\020\000\022\007\n\003ADD\020\001"
+  "\022\n\n\006REMOVE\020\002\022\013\n\007CURRENT\020\003\022\t\n\005RESET\020\004\"Q\n\030"
+  "ListCollectionIdsRequest\022\016\n\006parent\030\001 \001(\t"
+  "\022\021\n\tpage_size\030\002 \001(\005\022\022\n\npage_token\030\003 \001(\t\""
+  "L\n\031ListCollectionIdsResponse\022\026\n\016collecti"
+  "on_ids\030\001 \003(\t\022\027\n\017next_page_token\030\002 \001(\t2\203\024"
+  "\n\tFirestore\022\217\001\n\013GetDocument\022\'.google.fir"
+  "estore.v1.GetDocumentRequest\032\035.google.fi"
+  "restore.v1.Document\"8\202\323\344\223\0022\0220/v1/{name=p"
+  "rojects/*/databases/*/documents/*/**}\022\262\001"
+  "\n\rListDocuments\022).google.firestore.v1.Li"
+  "stDocumentsRequest\032*.google.firestore.v1"
+  ".ListDocumentsResponse\"J\202\323\344\223\002D\022B/v1/{par"
+  "ent=projects/*/databases/*/documents/*/*"
+  "*}/{collection_id}\022\257\001\n\016CreateDocument\022*."
+  "google.firestore.v1.CreateDocumentReques"
+  "t\032\035.google.firestore.v1.Document\"R\202\323\344\223\002L"
+  "\"@/v1/{parent=projects/*/databases/*/doc"
+  "uments/**}/{collection_id}:\010document\022\250\001\n"
+  "\016UpdateDocument\022*.google.firestore.v1.Up"
+  "dateDocumentRequest\032\035.google.firestore.v"
+  "1.Document\"K\202\323\344\223\002E29/v1/{document.name=p"
+  "rojects/*/databases/*/documents/*/**}:\010d"
+  "ocument\022\216\001\n\016DeleteDocument\022*.google.fire"
+  "store.v1.DeleteDocumentRequest\032\026.google."
+  "protobuf.Empty\"8\202\323\344\223\0022*0/v1/{name=projec"
+  "ts/*/databases/*/documents/*/**}\022\271\001\n\021Bat"
+  "chGetDocuments\022-.google.firestore.v1.Bat"
+  "chGetDocumentsRequest\032..google.firestore"
+  ".v1.BatchGetDocumentsResponse\"C\202\323\344\223\002=\"8/"
+  "v1/{database=projects/*/databases/*}/doc"
+  "uments:batchGet:\001*0\001\022\274\001\n\020BeginTransactio"
+  "n\022,.google.firestore.v1.BeginTransaction"
+  "Request\032-.google.firestore.v1.BeginTrans"
+  "actionResponse\"K\202\323\344\223\002E\"@/v1/{database=pr"
+  "ojects/*/databases/*}/documents:beginTra"
+  "nsaction:\001*\022\224\001\n\006Commit\022\".google.firestor"
+  "e.v1.CommitRequest\032#.google.firestore.v1"
+  ".CommitResponse\"A\202\323\344\223\002;\"6/v1/{database=p"
+  "rojects/*/databases/*}/documents:commit:"
+  "\001*\022\215\001\n\010Rollback\022$.google.firestore.v1.Ro"
+  "llbackRequest\032\026.google.protobuf.Empty\"C\202"
+  "\323\344\223\002=\"8/v1/{database=projects/*/database"
+  "s/*}/documents:rollback:\001*\022\337\001\n\010RunQuery\022"
+  "$.google.firestore.v1.RunQueryRequest\032%."
+  "google.firestore.v1.RunQueryResponse\"\203\001\202"
+  "\323\344\223\002}\"6/v1/{parent=projects/*/databases/"
+  "*/documents}:runQuery:\001*Z@\";/v1/{parent="
+  "projects/*/databases/*/documents/*/**}:r"
+  "unQuery:\001*0\001\022\374\001\n\016PartitionQuery\022*.google"
+  ".firestore.v1.PartitionQueryRequest\032+.go"
+  "ogle.firestore.v1.PartitionQueryResponse"
+  "\"\220\001\202\323\344\223\002\211\001\"</v1/{parent=projects/*/datab"
+  "ases/*/documents}:partitionQuery:\001*ZF\"A/"
+  "v1/{parent=projects/*/databases/*/docume"
+  "nts/*/**}:partitionQuery:\001*\022\224\001\n\005Write\022!."
+  "google.firestore.v1.WriteRequest\032\".googl"
+  "e.firestore.v1.WriteResponse\"@\202\323\344\223\002:\"5/v"
+  "1/{database=projects/*/databases/*}/docu"
+  "ments:write:\001*(\0010\001\022\230\001\n\006Listen\022\".google.f"
+  "irestore.v1.ListenRequest\032#.google.fires"
+  "tore.v1.ListenResponse\"A\202\323\344\223\002;\"6/v1/{dat"
+  "abase=projects/*/databases/*}/documents:"
+  "listen:\001*(\0010\001\022\213\002\n\021ListCollectionIds\022-.go"
+  "ogle.firestore.v1.ListCollectionIdsReque"
+  "st\032..google.firestore.v1.ListCollectionI"
+  "dsResponse\"\226\001\202\323\344\223\002\217\001\"\?/v1/{parent=projec"
+  "ts/*/databases/*/documents}:listCollecti"
+  "onIds:\001*ZI\"D/v1/{parent=projects/*/datab"
+  "ases/*/documents/*/**}:listCollectionIds"
+  ":\001*B\262\001\n\027com.google.firestore.v1B\016Firesto"
+  "reProtoP\001Z<google.golang.org/genproto/go"
+  "ogleapis/firestore/v1;firestore\242\002\004GCFS\252\002"
+  "\036Google.Cloud.Firestore.V1Beta1\312\002\036Google"
+  "\\Cloud\\Firestore\\V1beta1b\006proto3"
   ;
 static const ::PROTOBUF_NAMESPACE_ID::internal::DescriptorTable*const descriptor_table_google_2ffirestore_2fv1_2ffirestore_2eproto_deps[8] = {
   &::descriptor_table_google_2fapi_2fannotations_2eproto,
@@ -1108,7 +1189,7 @@ static const ::PROTOBUF_NAMESPACE_ID::internal::DescriptorTable*const descriptor
   &::descriptor_table_google_2fprotobuf_2ftimestamp_2eproto,
   &::descriptor_table_google_2frpc_2fstatus_2eproto,
 };
-static ::PROTOBUF_NAMESPACE_ID::internal::SCCInfoBase*const descriptor_table_google_2ffirestore_2fv1_2ffirestore_2eproto_sccs[27] = {
+static ::PROTOBUF_NAMESPACE_ID::internal::SCCInfoBase*const descriptor_table_google_2ffirestore_2fv1_2ffirestore_2eproto_sccs[29] = {
   &scc_info_BatchGetDocumentsRequest_google_2ffirestore_2fv1_2ffirestore_2eproto.base,
   &scc_info_BatchGetDocumentsResponse_google_2ffirestore_2fv1_2ffirestore_2eproto.base,
   &scc_info_BeginTransactionRequest_google_2ffirestore_2fv1_2ffirestore_2eproto.base,
@@ -1125,6 +1206,8 @@ static ::PROTOBUF_NAMESPACE_ID::internal::SCCInfoBase*const descriptor_table_goo
   &scc_info_ListenRequest_google_2ffirestore_2fv1_2ffirestore_2eproto.base,
   &scc_info_ListenRequest_LabelsEntry_DoNotUse_google_2ffirestore_2fv1_2ffirestore_2eproto.base,
   &scc_info_ListenResponse_google_2ffirestore_2fv1_2ffirestore_2eproto.base,
+  &scc_info_PartitionQueryRequest_google_2ffirestore_2fv1_2ffirestore_2eproto.base,
+  &scc_info_PartitionQueryResponse_google_2ffirestore_2fv1_2ffirestore_2eproto.base,
   &scc_info_RollbackRequest_google_2ffirestore_2fv1_2ffirestore_2eproto.base,
   &scc_info_RunQueryRequest_google_2ffirestore_2fv1_2ffirestore_2eproto.base,
   &scc_info_RunQueryResponse_google_2ffirestore_2fv1_2ffirestore_2eproto.base,
@@ -1140,10 +1223,10 @@ static ::PROTOBUF_NAMESPACE_ID::internal::SCCInfoBase*const descriptor_table_goo
 static ::PROTOBUF_NAMESPACE_ID::internal::once_flag descriptor_table_google_2ffirestore_2fv1_2ffirestore_2eproto_once;
 static bool descriptor_table_google_2ffirestore_2fv1_2ffirestore_2eproto_initialized = false;
 const ::PROTOBUF_NAMESPACE_ID::internal::DescriptorTable descriptor_table_google_2ffirestore_2fv1_2ffirestore_2eproto = {
-  &descriptor_table_google_2ffirestore_2fv1_2ffirestore_2eproto_initialized, descriptor_table_protodef_google_2ffirestore_2fv1_2ffirestore_2eproto, "google/firestore/v1/firestore.proto", 7098,
-  &descriptor_table_google_2ffirestore_2fv1_2ffirestore_2eproto_once, descriptor_table_google_2ffirestore_2fv1_2ffirestore_2eproto_sccs, descriptor_table_google_2ffirestore_2fv1_2ffirestore_2eproto_deps, 27, 8,
+  &descriptor_table_google_2ffirestore_2fv1_2ffirestore_2eproto_initialized, descriptor_table_protodef_google_2ffirestore_2fv1_2ffirestore_2eproto, "google/firestore/v1/firestore.proto", 7712,
+  &descriptor_table_google_2ffirestore_2fv1_2ffirestore_2eproto_once, descriptor_table_google_2ffirestore_2fv1_2ffirestore_2eproto_sccs, descriptor_table_google_2ffirestore_2fv1_2ffirestore_2eproto_deps, 29, 8,
   schemas, file_default_instances, TableStruct_google_2ffirestore_2fv1_2ffirestore_2eproto::offsets,
-  file_level_metadata_google_2ffirestore_2fv1_2ffirestore_2eproto, 27, file_level_enum_descriptors_google_2ffirestore_2fv1_2ffirestore_2eproto, file_level_service_descriptors_google_2ffirestore_2fv1_2ffirestore_2eproto,
+  file_level_metadata_google_2ffirestore_2fv1_2ffirestore_2eproto, 29, file_level_enum_descriptors_google_2ffirestore_2fv1_2ffirestore_2eproto, file_level_service_descriptors_google_2ffirestore_2fv1_2ffirestore_2eproto,
 };
 
 // Force running AddDescriptors() at dynamic initialization time.
@@ -6180,154 +6263,242 @@ void RunQueryResponse::InternalSwap(RunQueryResponse* other) {
 
 // ===================================================================
 
-WriteRequest_LabelsEntry_DoNotUse::WriteRequest_LabelsEntry_DoNotUse() {}
-WriteRequest_LabelsEntry_DoNotUse::WriteRequest_LabelsEntry_DoNotUse(::PROTOBUF_NAMESPACE_ID::Arena* arena)
-    : SuperType(arena) {}
-void WriteRequest_LabelsEntry_DoNotUse::MergeFrom(const WriteRequest_LabelsEntry_DoNotUse& other) {
-  MergeFromInternal(other);
-}
-::PROTOBUF_NAMESPACE_ID::Metadata WriteRequest_LabelsEntry_DoNotUse::GetMetadata() const {
-  return GetMetadataStatic();
-}
-void WriteRequest_LabelsEntry_DoNotUse::MergeFrom(
-    const ::PROTOBUF_NAMESPACE_ID::Message& other) {
-  ::PROTOBUF_NAMESPACE_ID::Message::MergeFrom(other);
-}
-
-
-// ===================================================================
-
-void WriteRequest::InitAsDefaultInstance() {
+void PartitionQueryRequest::InitAsDefaultInstance() {
+  ::google::firestore::v1::_PartitionQueryRequest_default_instance_.structured_query_ = const_cast< ::google::firestore::v1::StructuredQuery*>(
+      ::google::firestore::v1::StructuredQuery::internal_default_instance());
+  ::google::firestore::v1::_PartitionQueryRequest_default_instance_.read_time_ = const_cast< PROTOBUF_NAMESPACE_ID::Timestamp*>(
+      PROTOBUF_NAMESPACE_ID::Timestamp::internal_default_instance());
 }
-class WriteRequest::_Internal {
+class PartitionQueryRequest::_Internal {
  public:
+  static const ::google::firestore::v1::StructuredQuery& structured_query(const PartitionQueryRequest* msg);
+  static const PROTOBUF_NAMESPACE_ID::Timestamp& read_time(const PartitionQueryRequest* msg);
 };
 
-void WriteRequest::clear_writes() {
-  writes_.Clear();
+const ::google::firestore::v1::StructuredQuery&
+PartitionQueryRequest::_Internal::structured_query(const PartitionQueryRequest* msg) {
+  return *msg->query_type_.structured_query_;
 }
-WriteRequest::WriteRequest()
+const PROTOBUF_NAMESPACE_ID::Timestamp&
+PartitionQueryRequest::_Internal::read_time(const PartitionQueryRequest* msg) {
+  return *msg->consistency_selector_.read_time_;
+}
+void PartitionQueryRequest::set_allocated_structured_query(::google::firestore::v1::StructuredQuery* structured_query) {
+  ::PROTOBUF_NAMESPACE_ID::Arena* message_arena = GetArenaNoVirtual();
+  clear_query_type();
+  if (structured_query) {
+    ::PROTOBUF_NAMESPACE_ID::Arena* submessage_arena = nullptr;
+    if (message_arena != submessage_arena) {
+      structured_query = ::PROTOBUF_NAMESPACE_ID::internal::GetOwnedMessage(
+          message_arena, structured_query, submessage_arena);
+    }
+    set_has_structured_query();
+    query_type_.structured_query_ = structured_query;
+  }
+  // @@protoc_insertion_point(field_set_allocated:google.firestore.v1.PartitionQueryRequest.structured_query)
+}
+void PartitionQueryRequest::clear_structured_query() {
+  if (_internal_has_structured_query()) {
+    delete query_type_.structured_query_;
+    clear_has_query_type();
+  }
+}
+void PartitionQueryRequest::set_allocated_read_time(PROTOBUF_NAMESPACE_ID::Timestamp* read_time) {
+  ::PROTOBUF_NAMESPACE_ID::Arena* message_arena = GetArenaNoVirtual();
+  clear_consistency_selector();
+  if (read_time) {
+    ::PROTOBUF_NAMESPACE_ID::Arena* submessage_arena =
+      reinterpret_cast<::PROTOBUF_NAMESPACE_ID::MessageLite*>(read_time)->GetArena();
+    if (message_arena != submessage_arena) {
+      read_time = ::PROTOBUF_NAMESPACE_ID::internal::GetOwnedMessage(
+          message_arena, read_time, submessage_arena);
+    }
+    set_has_read_time();
+    consistency_selector_.read_time_ = read_time;
+  }
+  // @@protoc_insertion_point(field_set_allocated:google.firestore.v1.PartitionQueryRequest.read_time)
+}
+void PartitionQueryRequest::clear_read_time() {
+  if (_internal_has_read_time()) {
+    delete consistency_selector_.read_time_;
+    clear_has_consistency_selector();
+  }
+}
+PartitionQueryRequest::PartitionQueryRequest()
   : ::PROTOBUF_NAMESPACE_ID::Message(), _internal_metadata_(nullptr) {
   SharedCtor();
-  // @@protoc_insertion_point(constructor:google.firestore.v1.WriteRequest)
+  // @@protoc_insertion_point(constructor:google.firestore.v1.PartitionQueryRequest)
 }
-WriteRequest::WriteRequest(const WriteRequest& from)
+PartitionQueryRequest::PartitionQueryRequest(const PartitionQueryRequest& from)
   : ::PROTOBUF_NAMESPACE_ID::Message(),
-      _internal_metadata_(nullptr),
-      writes_(from.writes_) {
+      _internal_metadata_(nullptr) {
   _internal_metadata_.MergeFrom(from._internal_metadata_);
-  labels_.MergeFrom(from.labels_);
-  database_.UnsafeSetDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
-  if (!from._internal_database().empty()) {
-    database_.AssignWithDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), from.database_);
+  parent_.UnsafeSetDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
+  if (!from._internal_parent().empty()) {
+    parent_.AssignWithDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), from.parent_);
   }
-  stream_id_.UnsafeSetDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
-  if (!from._internal_stream_id().empty()) {
-    stream_id_.AssignWithDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), from.stream_id_);
+  page_token_.UnsafeSetDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
+  if (!from._internal_page_token().empty()) {
+    page_token_.AssignWithDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), from.page_token_);
   }
-  stream_token_.UnsafeSetDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
-  if (!from._internal_stream_token().empty()) {
-    stream_token_.AssignWithDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), from.stream_token_);
+  ::memcpy(&partition_count_, &from.partition_count_,
+    static_cast<size_t>(reinterpret_cast<char*>(&page_size_) -
+    reinterpret_cast<char*>(&partition_count_)) + sizeof(page_size_));
+  clear_has_query_type();
+  switch (from.query_type_case()) {
+    case kStructuredQuery: {
+      _internal_mutable_structured_query()->::google::firestore::v1::StructuredQuery::MergeFrom(from._internal_structured_query());
+      break;
+    }
+    case QUERY_TYPE_NOT_SET: {
+      break;
+    }
   }
-  // @@protoc_insertion_point(copy_constructor:google.firestore.v1.WriteRequest)
+  clear_has_consistency_selector();
+  switch (from.consistency_selector_case()) {
+    case kReadTime: {
+      _internal_mutable_read_time()->PROTOBUF_NAMESPACE_ID::Timestamp::MergeFrom(from._internal_read_time());
+      break;
+    }
+    case CONSISTENCY_SELECTOR_NOT_SET: {
+      break;
+    }
+  }
+  // @@protoc_insertion_point(copy_constructor:google.firestore.v1.PartitionQueryRequest)
 }
 
-void WriteRequest::SharedCtor() {
-  ::PROTOBUF_NAMESPACE_ID::internal::InitSCC(&scc_info_WriteRequest_google_2ffirestore_2fv1_2ffirestore_2eproto.base);
-  database_.UnsafeSetDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
-  stream_id_.UnsafeSetDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
-  stream_token_.UnsafeSetDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
+void PartitionQueryRequest::SharedCtor() {
+  ::PROTOBUF_NAMESPACE_ID::internal::InitSCC(&scc_info_PartitionQueryRequest_google_2ffirestore_2fv1_2ffirestore_2eproto.base);
+  parent_.UnsafeSetDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
+  page_token_.UnsafeSetDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
+  ::memset(&partition_count_, 0, static_cast<size_t>(
+      reinterpret_cast<char*>(&page_size_) -
+      reinterpret_cast<char*>(&partition_count_)) + sizeof(page_size_));
+  clear_has_query_type();
+  clear_has_consistency_selector();
 }
 
-WriteRequest::~WriteRequest() {
-  // @@protoc_insertion_point(destructor:google.firestore.v1.WriteRequest)
+PartitionQueryRequest::~PartitionQueryRequest() {
+  // @@protoc_insertion_point(destructor:google.firestore.v1.PartitionQueryRequest)
   SharedDtor();
 }
 
-void WriteRequest::SharedDtor() {
-  database_.DestroyNoArena(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
-  stream_id_.DestroyNoArena(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
-  stream_token_.DestroyNoArena(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
+void PartitionQueryRequest::SharedDtor() {
+  parent_.DestroyNoArena(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
+  page_token_.DestroyNoArena(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
+  if (has_query_type()) {
+    clear_query_type();
+  }
+  if (has_consistency_selector()) {
+    clear_consistency_selector();
+  }
 }
 
-void WriteRequest::SetCachedSize(int size) const {
+void PartitionQueryRequest::SetCachedSize(int size) const {
   _cached_size_.Set(size);
 }
-const WriteRequest& WriteRequest::default_instance() {
-  ::PROTOBUF_NAMESPACE_ID::internal::InitSCC(&::scc_info_WriteRequest_google_2ffirestore_2fv1_2ffirestore_2eproto.base);
+const PartitionQueryRequest& PartitionQueryRequest::default_instance() {
+  ::PROTOBUF_NAMESPACE_ID::internal::InitSCC(&::scc_info_PartitionQueryRequest_google_2ffirestore_2fv1_2ffirestore_2eproto.base);
   return *internal_default_instance();
 }
 
 
-void WriteRequest::Clear() {
-// @@protoc_insertion_point(message_clear_start:google.firestore.v1.WriteRequest)
+void PartitionQueryRequest::clear_query_type() {
+// @@protoc_insertion_point(one_of_clear_start:google.firestore.v1.PartitionQueryRequest)
+  switch (query_type_case()) {
+    case kStructuredQuery: {
+      delete query_type_.structured_query_;
+      break;
+    }
+    case QUERY_TYPE_NOT_SET: {
+      break;
+    }
+  }
+  _oneof_case_[0] = QUERY_TYPE_NOT_SET;
+}
+
+void PartitionQueryRequest::clear_consistency_selector() {
+// @@protoc_insertion_point(one_of_clear_start:google.firestore.v1.PartitionQueryRequest)
+  switch (consistency_selector_case()) {
+    case kReadTime: {
+      delete consistency_selector_.read_time_;
+      break;
+    }
+    case CONSISTENCY_SELECTOR_NOT_SET: {
+      break;
+    }
+  }
+  _oneof_case_[1] = CONSISTENCY_SELECTOR_NOT_SET;
+}
+
+
+void PartitionQueryRequest::Clear() {
+// @@protoc_insertion_point(message_clear_start:google.firestore.v1.PartitionQueryRequest)
   ::PROTOBUF_NAMESPACE_ID::uint32 cached_has_bits = 0;
   // Prevent compiler warnings about cached_has_bits being unused
   (void) cached_has_bits;
 
-  writes_.Clear();
-  labels_.Clear();
-  database_.ClearToEmptyNoArena(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
-  stream_id_.ClearToEmptyNoArena(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
-  stream_token_.ClearToEmptyNoArena(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
+  parent_.ClearToEmptyNoArena(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
+  page_token_.ClearToEmptyNoArena(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
+  ::memset(&partition_count_, 0, static_cast<size_t>(
+      reinterpret_cast<char*>(&page_size_) -
+      reinterpret_cast<char*>(&partition_count_)) + sizeof(page_size_));
+  clear_query_type();
+  clear_consistency_selector();
   _internal_metadata_.Clear();
 }
 
-const char* WriteRequest::_InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) {
+const char* PartitionQueryRequest::_InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) {
 #define CHK_(x) if (PROTOBUF_PREDICT_FALSE(!(x))) goto failure
   while (!ctx->Done(&ptr)) {
     ::PROTOBUF_NAMESPACE_ID::uint32 tag;
     ptr = ::PROTOBUF_NAMESPACE_ID::internal::ReadTag(ptr, &tag);
     CHK_(ptr);
     switch (tag >> 3) {
-      // string database = 1;
+      // string parent = 1;
       case 1:
         if (PROTOBUF_PREDICT_TRUE(static_cast<::PROTOBUF_NAMESPACE_ID::uint8>(tag) == 10)) {
-          auto str = _internal_mutable_database();
+          auto str = _internal_mutable_parent();
           ptr = ::PROTOBUF_NAMESPACE_ID::internal::InlineGreedyStringParser(str, ptr, ctx);
-          CHK_(::PROTOBUF_NAMESPACE_ID::internal::VerifyUTF8(str, "google.firestore.v1.WriteRequest.database"));
+          CHK_(::PROTOBUF_NAMESPACE_ID::internal::VerifyUTF8(str, "google.firestore.v1.PartitionQueryRequest.parent"));
           CHK_(ptr);
         } else goto handle_unusual;
         continue;
-      // string stream_id = 2;
+      // .google.firestore.v1.StructuredQuery structured_query = 2;
       case 2:
         if (PROTOBUF_PREDICT_TRUE(static_cast<::PROTOBUF_NAMESPACE_ID::uint8>(tag) == 18)) {
-          auto str = _internal_mutable_stream_id();
-          ptr = ::PROTOBUF_NAMESPACE_ID::internal::InlineGreedyStringParser(str, ptr, ctx);
-          CHK_(::PROTOBUF_NAMESPACE_ID::internal::VerifyUTF8(str, "google.firestore.v1.WriteRequest.stream_id"));
+          ptr = ctx->ParseMessage(_internal_mutable_structured_query(), ptr);
           CHK_(ptr);
         } else goto handle_unusual;
         continue;
-      // repeated .google.firestore.v1.Write writes = 3;
+      // int64 partition_count = 3;
       case 3:
-        if (PROTOBUF_PREDICT_TRUE(static_cast<::PROTOBUF_NAMESPACE_ID::uint8>(tag) == 26)) {
-          ptr -= 1;
-          do {
-            ptr += 1;
-            ptr = ctx->ParseMessage(_internal_add_writes(), ptr);
-            CHK_(ptr);
-            if (!ctx->DataAvailable(ptr)) break;
-          } while (::PROTOBUF_NAMESPACE_ID::internal::ExpectTag<26>(ptr));
+        if (PROTOBUF_PREDICT_TRUE(static_cast<::PROTOBUF_NAMESPACE_ID::uint8>(tag) == 24)) {
+          partition_count_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint(&ptr);
+          CHK_(ptr);
         } else goto handle_unusual;
         continue;
-      // bytes stream_token = 4;
+      // string page_token = 4;
       case 4:
         if (PROTOBUF_PREDICT_TRUE(static_cast<::PROTOBUF_NAMESPACE_ID::uint8>(tag) == 34)) {
-          auto str = _internal_mutable_stream_token();
+          auto str = _internal_mutable_page_token();
           ptr = ::PROTOBUF_NAMESPACE_ID::internal::InlineGreedyStringParser(str, ptr, ctx);
+          CHK_(::PROTOBUF_NAMESPACE_ID::internal::VerifyUTF8(str, "google.firestore.v1.PartitionQueryRequest.page_token"));
           CHK_(ptr);
         } else goto handle_unusual;
         continue;
-      // map<string, string> labels = 5;
+      // int32 page_size = 5;
       case 5:
-        if (PROTOBUF_PREDICT_TRUE(static_cast<::PROTOBUF_NAMESPACE_ID::uint8>(tag) == 42)) {
-          ptr -= 1;
-          do {
-            ptr += 1;
-            ptr = ctx->ParseMessage(&labels_, ptr);
-            CHK_(ptr);
-            if (!ctx->DataAvailable(ptr)) break;
-          } while (::PROTOBUF_NAMESPACE_ID::internal::ExpectTag<42>(ptr));
+        if (PROTOBUF_PREDICT_TRUE(static_cast<::PROTOBUF_NAMESPACE_ID::uint8>(tag) == 40)) {
+          page_size_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint(&ptr);
+          CHK_(ptr);
+        } else goto handle_unusual;
+        continue;
+      // .google.protobuf.Timestamp read_time = 6;
+      case 6:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<::PROTOBUF_NAMESPACE_ID::uint8>(tag) == 50)) {
+          ptr = ctx->ParseMessage(_internal_mutable_read_time(), ptr);
+          CHK_(ptr);
         } else goto handle_unusual;
         continue;
       default: {
@@ -6350,25 +6521,655 @@ failure:
 #undef CHK_
 }
 
-::PROTOBUF_NAMESPACE_ID::uint8* WriteRequest::_InternalSerialize(
+::PROTOBUF_NAMESPACE_ID::uint8* PartitionQueryRequest::_InternalSerialize(
     ::PROTOBUF_NAMESPACE_ID::uint8* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const {
-  // @@protoc_insertion_point(serialize_to_array_start:google.firestore.v1.WriteRequest)
+  // @@protoc_insertion_point(serialize_to_array_start:google.firestore.v1.PartitionQueryRequest)
   ::PROTOBUF_NAMESPACE_ID::uint32 cached_has_bits = 0;
   (void) cached_has_bits;
 
-  // string database = 1;
-  if (this->database().size() > 0) {
+  // string parent = 1;
+  if (this->parent().size() > 0) {
     ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::VerifyUtf8String(
-      this->_internal_database().data(), static_cast<int>(this->_internal_database().length()),
+      this->_internal_parent().data(), static_cast<int>(this->_internal_parent().length()),
       ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::SERIALIZE,
-      "google.firestore.v1.WriteRequest.database");
+      "google.firestore.v1.PartitionQueryRequest.parent");
     target = stream->WriteStringMaybeAliased(
-        1, this->_internal_database(), target);
+        1, this->_internal_parent(), target);
   }
 
-  // string stream_id = 2;
-  if (this->stream_id().size() > 0) {
-    ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::VerifyUtf8String(
+  // .google.firestore.v1.StructuredQuery structured_query = 2;
+  if (_internal_has_structured_query()) {
+    target = stream->EnsureSpace(target);
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::
+      InternalWriteMessage(
+        2, _Internal::structured_query(this), target, stream);
+  }
+
+  // int64 partition_count = 3;
+  if (this->partition_count() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::WriteInt64ToArray(3, this->_internal_partition_count(), target);
+  }
+
+  // string page_token = 4;
+  if (this->page_token().size() > 0) {
+    ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::VerifyUtf8String(
+      this->_internal_page_token().data(), static_cast<int>(this->_internal_page_token().length()),
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::SERIALIZE,
+      "google.firestore.v1.PartitionQueryRequest.page_token");
+    target = stream->WriteStringMaybeAliased(
+        4, this->_internal_page_token(), target);
+  }
+
+  // int32 page_size = 5;
+  if (this->page_size() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::WriteInt32ToArray(5, this->_internal_page_size(), target);
+  }
+
+  // .google.protobuf.Timestamp read_time = 6;
+  if (_internal_has_read_time()) {
+    target = stream->EnsureSpace(target);
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::
+      InternalWriteMessage(
+        6, _Internal::read_time(this), target, stream);
+  }
+
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormat::InternalSerializeUnknownFieldsToArray(
+        _internal_metadata_.unknown_fields(), target, stream);
+  }
+  // @@protoc_insertion_point(serialize_to_array_end:google.firestore.v1.PartitionQueryRequest)
+  return target;
+}
+
+size_t PartitionQueryRequest::ByteSizeLong() const {
+// @@protoc_insertion_point(message_byte_size_start:google.firestore.v1.PartitionQueryRequest)
+  size_t total_size = 0;
+
+  ::PROTOBUF_NAMESPACE_ID::uint32 cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  // string parent = 1;
+  if (this->parent().size() > 0) {
+    total_size += 1 +
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::StringSize(
+        this->_internal_parent());
+  }
+
+  // string page_token = 4;
+  if (this->page_token().size() > 0) {
+    total_size += 1 +
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::StringSize(
+        this->_internal_page_token());
+  }
+
+  // int64 partition_count = 3;
+  if (this->partition_count() != 0) {
+    total_size += 1 +
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::Int64Size(
+        this->_internal_partition_count());
+  }
+
+  // int32 page_size = 5;
+  if (this->page_size() != 0) {
+    total_size += 1 +
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::Int32Size(
+        this->_internal_page_size());
+  }
+
+  switch (query_type_case()) {
+    // .google.firestore.v1.StructuredQuery structured_query = 2;
+    case kStructuredQuery: {
+      total_size += 1 +
+        ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::MessageSize(
+          *query_type_.structured_query_);
+      break;
+    }
+    case QUERY_TYPE_NOT_SET: {
+      break;
+    }
+  }
+  switch (consistency_selector_case()) {
+    // .google.protobuf.Timestamp read_time = 6;
+    case kReadTime: {
+      total_size += 1 +
+        ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::MessageSize(
+          *consistency_selector_.read_time_);
+      break;
+    }
+    case CONSISTENCY_SELECTOR_NOT_SET: {
+      break;
+    }
+  }
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    return ::PROTOBUF_NAMESPACE_ID::internal::ComputeUnknownFieldsSize(
+        _internal_metadata_, total_size, &_cached_size_);
+  }
+  int cached_size = ::PROTOBUF_NAMESPACE_ID::internal::ToCachedSize(total_size);
+  SetCachedSize(cached_size);
+  return total_size;
+}
+
+void PartitionQueryRequest::MergeFrom(const ::PROTOBUF_NAMESPACE_ID::Message& from) {
+// @@protoc_insertion_point(generalized_merge_from_start:google.firestore.v1.PartitionQueryRequest)
+  GOOGLE_DCHECK_NE(&from, this);
+  const PartitionQueryRequest* source =
+      ::PROTOBUF_NAMESPACE_ID::DynamicCastToGenerated<PartitionQueryRequest>(
+          &from);
+  if (source == nullptr) {
+  // @@protoc_insertion_point(generalized_merge_from_cast_fail:google.firestore.v1.PartitionQueryRequest)
+    ::PROTOBUF_NAMESPACE_ID::internal::ReflectionOps::Merge(from, this);
+  } else {
+  // @@protoc_insertion_point(generalized_merge_from_cast_success:google.firestore.v1.PartitionQueryRequest)
+    MergeFrom(*source);
+  }
+}
+
+void PartitionQueryRequest::MergeFrom(const PartitionQueryRequest& from) {
+// @@protoc_insertion_point(class_specific_merge_from_start:google.firestore.v1.PartitionQueryRequest)
+  GOOGLE_DCHECK_NE(&from, this);
+  _internal_metadata_.MergeFrom(from._internal_metadata_);
+  ::PROTOBUF_NAMESPACE_ID::uint32 cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  if (from.parent().size() > 0) {
+
+    parent_.AssignWithDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), from.parent_);
+  }
+  if (from.page_token().size() > 0) {
+
+    page_token_.AssignWithDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), from.page_token_);
+  }
+  if (from.partition_count() != 0) {
+    _internal_set_partition_count(from._internal_partition_count());
+  }
+  if (from.page_size() != 0) {
+    _internal_set_page_size(from._internal_page_size());
+  }
+  switch (from.query_type_case()) {
+    case kStructuredQuery: {
+      _internal_mutable_structured_query()->::google::firestore::v1::StructuredQuery::MergeFrom(from._internal_structured_query());
+      break;
+    }
+    case QUERY_TYPE_NOT_SET: {
+      break;
+    }
+  }
+  switch (from.consistency_selector_case()) {
+    case kReadTime: {
+      _internal_mutable_read_time()->PROTOBUF_NAMESPACE_ID::Timestamp::MergeFrom(from._internal_read_time());
+      break;
+    }
+    case CONSISTENCY_SELECTOR_NOT_SET: {
+      break;
+    }
+  }
+}
+
+void PartitionQueryRequest::CopyFrom(const ::PROTOBUF_NAMESPACE_ID::Message& from) {
+// @@protoc_insertion_point(generalized_copy_from_start:google.firestore.v1.PartitionQueryRequest)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+void PartitionQueryRequest::CopyFrom(const PartitionQueryRequest& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:google.firestore.v1.PartitionQueryRequest)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+bool PartitionQueryRequest::IsInitialized() const {
+  return true;
+}
+
+void PartitionQueryRequest::InternalSwap(PartitionQueryRequest* other) {
+  using std::swap;
+  _internal_metadata_.Swap(&other->_internal_metadata_);
+  parent_.Swap(&other->parent_, &::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(),
+    GetArenaNoVirtual());
+  page_token_.Swap(&other->page_token_, &::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(),
+    GetArenaNoVirtual());
+  swap(partition_count_, other->partition_count_);
+  swap(page_size_, other->page_size_);
+  swap(query_type_, other->query_type_);
+  swap(consistency_selector_, other->consistency_selector_);
+  swap(_oneof_case_[0], other->_oneof_case_[0]);
+  swap(_oneof_case_[1], other->_oneof_case_[1]);
+}
+
+::PROTOBUF_NAMESPACE_ID::Metadata PartitionQueryRequest::GetMetadata() const {
+  return GetMetadataStatic();
+}
+
+
+// ===================================================================
+
+void PartitionQueryResponse::InitAsDefaultInstance() {
+}
+class PartitionQueryResponse::_Internal {
+ public:
+};
+
+void PartitionQueryResponse::clear_partitions() {
+  partitions_.Clear();
+}
+PartitionQueryResponse::PartitionQueryResponse()
+  : ::PROTOBUF_NAMESPACE_ID::Message(), _internal_metadata_(nullptr) {
+  SharedCtor();
+  // @@protoc_insertion_point(constructor:google.firestore.v1.PartitionQueryResponse)
+}
+PartitionQueryResponse::PartitionQueryResponse(const PartitionQueryResponse& from)
+  : ::PROTOBUF_NAMESPACE_ID::Message(),
+      _internal_metadata_(nullptr),
+      partitions_(from.partitions_) {
+  _internal_metadata_.MergeFrom(from._internal_metadata_);
+  next_page_token_.UnsafeSetDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
+  if (!from._internal_next_page_token().empty()) {
+    next_page_token_.AssignWithDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), from.next_page_token_);
+  }
+  // @@protoc_insertion_point(copy_constructor:google.firestore.v1.PartitionQueryResponse)
+}
+
+void PartitionQueryResponse::SharedCtor() {
+  ::PROTOBUF_NAMESPACE_ID::internal::InitSCC(&scc_info_PartitionQueryResponse_google_2ffirestore_2fv1_2ffirestore_2eproto.base);
+  next_page_token_.UnsafeSetDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
+}
+
+PartitionQueryResponse::~PartitionQueryResponse() {
+  // @@protoc_insertion_point(destructor:google.firestore.v1.PartitionQueryResponse)
+  SharedDtor();
+}
+
+void PartitionQueryResponse::SharedDtor() {
+  next_page_token_.DestroyNoArena(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
+}
+
+void PartitionQueryResponse::SetCachedSize(int size) const {
+  _cached_size_.Set(size);
+}
+const PartitionQueryResponse& PartitionQueryResponse::default_instance() {
+  ::PROTOBUF_NAMESPACE_ID::internal::InitSCC(&::scc_info_PartitionQueryResponse_google_2ffirestore_2fv1_2ffirestore_2eproto.base);
+  return *internal_default_instance();
+}
+
+
+void PartitionQueryResponse::Clear() {
+// @@protoc_insertion_point(message_clear_start:google.firestore.v1.PartitionQueryResponse)
+  ::PROTOBUF_NAMESPACE_ID::uint32 cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  partitions_.Clear();
+  next_page_token_.ClearToEmptyNoArena(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
+  _internal_metadata_.Clear();
+}
+
+const char* PartitionQueryResponse::_InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) {
+#define CHK_(x) if (PROTOBUF_PREDICT_FALSE(!(x))) goto failure
+  while (!ctx->Done(&ptr)) {
+    ::PROTOBUF_NAMESPACE_ID::uint32 tag;
+    ptr = ::PROTOBUF_NAMESPACE_ID::internal::ReadTag(ptr, &tag);
+    CHK_(ptr);
+    switch (tag >> 3) {
+      // repeated .google.firestore.v1.Cursor partitions = 1;
+      case 1:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<::PROTOBUF_NAMESPACE_ID::uint8>(tag) == 10)) {
+          ptr -= 1;
+          do {
+            ptr += 1;
+            ptr = ctx->ParseMessage(_internal_add_partitions(), ptr);
+            CHK_(ptr);
+            if (!ctx->DataAvailable(ptr)) break;
+          } while (::PROTOBUF_NAMESPACE_ID::internal::ExpectTag<10>(ptr));
+        } else goto handle_unusual;
+        continue;
+      // string next_page_token = 2;
+      case 2:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<::PROTOBUF_NAMESPACE_ID::uint8>(tag) == 18)) {
+          auto str = _internal_mutable_next_page_token();
+          ptr = ::PROTOBUF_NAMESPACE_ID::internal::InlineGreedyStringParser(str, ptr, ctx);
+          CHK_(::PROTOBUF_NAMESPACE_ID::internal::VerifyUTF8(str, "google.firestore.v1.PartitionQueryResponse.next_page_token"));
+          CHK_(ptr);
+        } else goto handle_unusual;
+        continue;
+      default: {
+      handle_unusual:
+        if ((tag & 7) == 4 || tag == 0) {
+          ctx->SetLastTag(tag);
+          goto success;
+        }
+        ptr = UnknownFieldParse(tag, &_internal_metadata_, ptr, ctx);
+        CHK_(ptr != nullptr);
+        continue;
+      }
+    }  // switch
+  }  // while
+success:
+  return ptr;
+failure:
+  ptr = nullptr;
+  goto success;
+#undef CHK_
+}
+
+::PROTOBUF_NAMESPACE_ID::uint8* PartitionQueryResponse::_InternalSerialize(
+    ::PROTOBUF_NAMESPACE_ID::uint8* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const {
+  // @@protoc_insertion_point(serialize_to_array_start:google.firestore.v1.PartitionQueryResponse)
+  ::PROTOBUF_NAMESPACE_ID::uint32 cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  // repeated .google.firestore.v1.Cursor partitions = 1;
+  for (unsigned int i = 0,
+      n = static_cast<unsigned int>(this->_internal_partitions_size()); i < n; i++) {
+    target = stream->EnsureSpace(target);
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::
+      InternalWriteMessage(1, this->_internal_partitions(i), target, stream);
+  }
+
+  // string next_page_token = 2;
+  if (this->next_page_token().size() > 0) {
+    ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::VerifyUtf8String(
+      this->_internal_next_page_token().data(), static_cast<int>(this->_internal_next_page_token().length()),
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::SERIALIZE,
+      "google.firestore.v1.PartitionQueryResponse.next_page_token");
+    target = stream->WriteStringMaybeAliased(
+        2, this->_internal_next_page_token(), target);
+  }
+
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormat::InternalSerializeUnknownFieldsToArray(
+        _internal_metadata_.unknown_fields(), target, stream);
+  }
+  // @@protoc_insertion_point(serialize_to_array_end:google.firestore.v1.PartitionQueryResponse)
+  return target;
+}
+
+size_t PartitionQueryResponse::ByteSizeLong() const {
+// @@protoc_insertion_point(message_byte_size_start:google.firestore.v1.PartitionQueryResponse)
+  size_t total_size = 0;
+
+  ::PROTOBUF_NAMESPACE_ID::uint32 cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  // repeated .google.firestore.v1.Cursor partitions = 1;
+  total_size += 1UL * this->_internal_partitions_size();
+  for (const auto& msg : this->partitions_) {
+    total_size +=
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::MessageSize(msg);
+  }
+
+  // string next_page_token = 2;
+  if (this->next_page_token().size() > 0) {
+    total_size += 1 +
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::StringSize(
+        this->_internal_next_page_token());
+  }
+
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    return ::PROTOBUF_NAMESPACE_ID::internal::ComputeUnknownFieldsSize(
+        _internal_metadata_, total_size, &_cached_size_);
+  }
+  int cached_size = ::PROTOBUF_NAMESPACE_ID::internal::ToCachedSize(total_size);
+  SetCachedSize(cached_size);
+  return total_size;
+}
+
+void PartitionQueryResponse::MergeFrom(const ::PROTOBUF_NAMESPACE_ID::Message& from) {
+// @@protoc_insertion_point(generalized_merge_from_start:google.firestore.v1.PartitionQueryResponse)
+  GOOGLE_DCHECK_NE(&from, this);
+  const PartitionQueryResponse* source =
+      ::PROTOBUF_NAMESPACE_ID::DynamicCastToGenerated<PartitionQueryResponse>(
+          &from);
+  if (source == nullptr) {
+  // @@protoc_insertion_point(generalized_merge_from_cast_fail:google.firestore.v1.PartitionQueryResponse)
+    ::PROTOBUF_NAMESPACE_ID::internal::ReflectionOps::Merge(from, this);
+  } else {
+  // @@protoc_insertion_point(generalized_merge_from_cast_success:google.firestore.v1.PartitionQueryResponse)
+    MergeFrom(*source);
+  }
+}
+
+void PartitionQueryResponse::MergeFrom(const PartitionQueryResponse& from) {
+// @@protoc_insertion_point(class_specific_merge_from_start:google.firestore.v1.PartitionQueryResponse)
+  GOOGLE_DCHECK_NE(&from, this);
+  _internal_metadata_.MergeFrom(from._internal_metadata_);
+  ::PROTOBUF_NAMESPACE_ID::uint32 cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  partitions_.MergeFrom(from.partitions_);
+  if (from.next_page_token().size() > 0) {
+
+    next_page_token_.AssignWithDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), from.next_page_token_);
+  }
+}
+
+void PartitionQueryResponse::CopyFrom(const ::PROTOBUF_NAMESPACE_ID::Message& from) {
+// @@protoc_insertion_point(generalized_copy_from_start:google.firestore.v1.PartitionQueryResponse)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+void PartitionQueryResponse::CopyFrom(const PartitionQueryResponse& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:google.firestore.v1.PartitionQueryResponse)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+bool PartitionQueryResponse::IsInitialized() const {
+  return true;
+}
+
+void PartitionQueryResponse::InternalSwap(PartitionQueryResponse* other) {
+  using std::swap;
+  _internal_metadata_.Swap(&other->_internal_metadata_);
+  partitions_.InternalSwap(&other->partitions_);
+  next_page_token_.Swap(&other->next_page_token_, &::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(),
+    GetArenaNoVirtual());
+}
+
+::PROTOBUF_NAMESPACE_ID::Metadata PartitionQueryResponse::GetMetadata() const {
+  return GetMetadataStatic();
+}
+
+
+// ===================================================================
+
+WriteRequest_LabelsEntry_DoNotUse::WriteRequest_LabelsEntry_DoNotUse() {}
+WriteRequest_LabelsEntry_DoNotUse::WriteRequest_LabelsEntry_DoNotUse(::PROTOBUF_NAMESPACE_ID::Arena* arena)
+    : SuperType(arena) {}
+void WriteRequest_LabelsEntry_DoNotUse::MergeFrom(const WriteRequest_LabelsEntry_DoNotUse& other) {
+  MergeFromInternal(other);
+}
+::PROTOBUF_NAMESPACE_ID::Metadata WriteRequest_LabelsEntry_DoNotUse::GetMetadata() const {
+  return GetMetadataStatic();
+}
+void WriteRequest_LabelsEntry_DoNotUse::MergeFrom(
+    const ::PROTOBUF_NAMESPACE_ID::Message& other) {
+  ::PROTOBUF_NAMESPACE_ID::Message::MergeFrom(other);
+}
+
+
+// ===================================================================
+
+void WriteRequest::InitAsDefaultInstance() {
+}
+class WriteRequest::_Internal {
+ public:
+};
+
+void WriteRequest::clear_writes() {
+  writes_.Clear();
+}
+WriteRequest::WriteRequest()
+  : ::PROTOBUF_NAMESPACE_ID::Message(), _internal_metadata_(nullptr) {
+  SharedCtor();
+  // @@protoc_insertion_point(constructor:google.firestore.v1.WriteRequest)
+}
+WriteRequest::WriteRequest(const WriteRequest& from)
+  : ::PROTOBUF_NAMESPACE_ID::Message(),
+      _internal_metadata_(nullptr),
+      writes_(from.writes_) {
+  _internal_metadata_.MergeFrom(from._internal_metadata_);
+  labels_.MergeFrom(from.labels_);
+  database_.UnsafeSetDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
+  if (!from._internal_database().empty()) {
+    database_.AssignWithDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), from.database_);
+  }
+  stream_id_.UnsafeSetDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
+  if (!from._internal_stream_id().empty()) {
+    stream_id_.AssignWithDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), from.stream_id_);
+  }
+  stream_token_.UnsafeSetDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
+  if (!from._internal_stream_token().empty()) {
+    stream_token_.AssignWithDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), from.stream_token_);
+  }
+  // @@protoc_insertion_point(copy_constructor:google.firestore.v1.WriteRequest)
+}
+
+void WriteRequest::SharedCtor() {
+  ::PROTOBUF_NAMESPACE_ID::internal::InitSCC(&scc_info_WriteRequest_google_2ffirestore_2fv1_2ffirestore_2eproto.base);
+  database_.UnsafeSetDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
+  stream_id_.UnsafeSetDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
+  stream_token_.UnsafeSetDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
+}
+
+WriteRequest::~WriteRequest() {
+  // @@protoc_insertion_point(destructor:google.firestore.v1.WriteRequest)
+  SharedDtor();
+}
+
+void WriteRequest::SharedDtor() {
+  database_.DestroyNoArena(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
+  stream_id_.DestroyNoArena(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
+  stream_token_.DestroyNoArena(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
+}
+
+void WriteRequest::SetCachedSize(int size) const {
+  _cached_size_.Set(size);
+}
+const WriteRequest& WriteRequest::default_instance() {
+  ::PROTOBUF_NAMESPACE_ID::internal::InitSCC(&::scc_info_WriteRequest_google_2ffirestore_2fv1_2ffirestore_2eproto.base);
+  return *internal_default_instance();
+}
+
+
+void WriteRequest::Clear() {
+// @@protoc_insertion_point(message_clear_start:google.firestore.v1.WriteRequest)
+  ::PROTOBUF_NAMESPACE_ID::uint32 cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  writes_.Clear();
+  labels_.Clear();
+  database_.ClearToEmptyNoArena(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
+  stream_id_.ClearToEmptyNoArena(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
+  stream_token_.ClearToEmptyNoArena(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
+  _internal_metadata_.Clear();
+}
+
+const char* WriteRequest::_InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) {
+#define CHK_(x) if (PROTOBUF_PREDICT_FALSE(!(x))) goto failure
+  while (!ctx->Done(&ptr)) {
+    ::PROTOBUF_NAMESPACE_ID::uint32 tag;
+    ptr = ::PROTOBUF_NAMESPACE_ID::internal::ReadTag(ptr, &tag);
+    CHK_(ptr);
+    switch (tag >> 3) {
+      // string database = 1;
+      case 1:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<::PROTOBUF_NAMESPACE_ID::uint8>(tag) == 10)) {
+          auto str = _internal_mutable_database();
+          ptr = ::PROTOBUF_NAMESPACE_ID::internal::InlineGreedyStringParser(str, ptr, ctx);
+          CHK_(::PROTOBUF_NAMESPACE_ID::internal::VerifyUTF8(str, "google.firestore.v1.WriteRequest.database"));
+          CHK_(ptr);
+        } else goto handle_unusual;
+        continue;
+      // string stream_id = 2;
+      case 2:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<::PROTOBUF_NAMESPACE_ID::uint8>(tag) == 18)) {
+          auto str = _internal_mutable_stream_id();
+          ptr = ::PROTOBUF_NAMESPACE_ID::internal::InlineGreedyStringParser(str, ptr, ctx);
+          CHK_(::PROTOBUF_NAMESPACE_ID::internal::VerifyUTF8(str, "google.firestore.v1.WriteRequest.stream_id"));
+          CHK_(ptr);
+        } else goto handle_unusual;
+        continue;
+      // repeated .google.firestore.v1.Write writes = 3;
+      case 3:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<::PROTOBUF_NAMESPACE_ID::uint8>(tag) == 26)) {
+          ptr -= 1;
+          do {
+            ptr += 1;
+            ptr = ctx->ParseMessage(_internal_add_writes(), ptr);
+            CHK_(ptr);
+            if (!ctx->DataAvailable(ptr)) break;
+          } while (::PROTOBUF_NAMESPACE_ID::internal::ExpectTag<26>(ptr));
+        } else goto handle_unusual;
+        continue;
+      // bytes stream_token = 4;
+      case 4:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<::PROTOBUF_NAMESPACE_ID::uint8>(tag) == 34)) {
+          auto str = _internal_mutable_stream_token();
+          ptr = ::PROTOBUF_NAMESPACE_ID::internal::InlineGreedyStringParser(str, ptr, ctx);
+          CHK_(ptr);
+        } else goto handle_unusual;
+        continue;
+      // map<string, string> labels = 5;
+      case 5:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<::PROTOBUF_NAMESPACE_ID::uint8>(tag) == 42)) {
+          ptr -= 1;
+          do {
+            ptr += 1;
+            ptr = ctx->ParseMessage(&labels_, ptr);
+            CHK_(ptr);
+            if (!ctx->DataAvailable(ptr)) break;
+          } while (::PROTOBUF_NAMESPACE_ID::internal::ExpectTag<42>(ptr));
+        } else goto handle_unusual;
+        continue;
+      default: {
+      handle_unusual:
+        if ((tag & 7) == 4 || tag == 0) {
+          ctx->SetLastTag(tag);
+          goto success;
+        }
+        ptr = UnknownFieldParse(tag, &_internal_metadata_, ptr, ctx);
+        CHK_(ptr != nullptr);
+        continue;
+      }
+    }  // switch
+  }  // while
+success:
+  return ptr;
+failure:
+  ptr = nullptr;
+  goto success;
+#undef CHK_
+}
+
+::PROTOBUF_NAMESPACE_ID::uint8* WriteRequest::_InternalSerialize(
+    ::PROTOBUF_NAMESPACE_ID::uint8* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const {
+  // @@protoc_insertion_point(serialize_to_array_start:google.firestore.v1.WriteRequest)
+  ::PROTOBUF_NAMESPACE_ID::uint32 cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  // string database = 1;
+  if (this->database().size() > 0) {
+    ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::VerifyUtf8String(
+      this->_internal_database().data(), static_cast<int>(this->_internal_database().length()),
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::SERIALIZE,
+      "google.firestore.v1.WriteRequest.database");
+    target = stream->WriteStringMaybeAliased(
+        1, this->_internal_database(), target);
+  }
+
+  // string stream_id = 2;
+  if (this->stream_id().size() > 0) {
+    ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::VerifyUtf8String(
       this->_internal_stream_id().data(), static_cast<int>(this->_internal_stream_id().length()),
       ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::SERIALIZE,
       "google.firestore.v1.WriteRequest.stream_id");
@@ -9678,6 +10479,12 @@ template<> PROTOBUF_NOINLINE ::google::firestore::v1::RunQueryRequest* Arena::Cr
 template<> PROTOBUF_NOINLINE ::google::firestore::v1::RunQueryResponse* Arena::CreateMaybeMessage< ::google::firestore::v1::RunQueryResponse >(Arena* arena) {
   return Arena::CreateInternal< ::google::firestore::v1::RunQueryResponse >(arena);
 }
+template<> PROTOBUF_NOINLINE ::google::firestore::v1::PartitionQueryRequest* Arena::CreateMaybeMessage< ::google::firestore::v1::PartitionQueryRequest >(Arena* arena) {
+  return Arena::CreateInternal< ::google::firestore::v1::PartitionQueryRequest >(arena);
+}
+template<> PROTOBUF_NOINLINE ::google::firestore::v1::PartitionQueryResponse* Arena::CreateMaybeMessage< ::google::firestore::v1::PartitionQueryResponse >(Arena* arena) {
+  return Arena::CreateInternal< ::google::firestore::v1::PartitionQueryResponse >(arena);
+}
 template<> PROTOBUF_NOINLINE ::google::firestore::v1::WriteRequest_LabelsEntry_DoNotUse* Arena::CreateMaybeMessage< ::google::firestore::v1::WriteRequest_LabelsEntry_DoNotUse >(Arena* arena) {
   return Arena::CreateInternal< ::google::firestore::v1::WriteRequest_LabelsEntry_DoNotUse >(arena);
 }
@@ -75,7 +75,7 @@ struct TableStruct_google_2ffirestore_2fv1_2ffirestore_2eproto {
     PROTOBUF_SECTION_VARIABLE(protodesc_cold);
   static const ::PROTOBUF_NAMESPACE_ID::internal::AuxillaryParseTableField aux[]
     PROTOBUF_SECTION_VARIABLE(protodesc_cold);
-  static const ::PROTOBUF_NAMESPACE_ID::internal::ParseTable schema[27]
+  static const ::PROTOBUF_NAMESPACE_ID::internal::ParseTable schema[29]
     PROTOBUF_SECTION_VARIABLE(protodesc_cold);
   static const ::PROTOBUF_NAMESPACE_ID::internal::FieldMetadata field_metadata[];
   static const ::PROTOBUF_NAMESPACE_ID::internal::SerializationTable serialization_table[];
@@ -133,6 +133,12 @@ extern ListenRequest_LabelsEntry_DoNotUseDefaultTypeInternal _ListenRequest_Labe
 class ListenResponse;
 class ListenResponseDefaultTypeInternal;
 extern ListenResponseDefaultTypeInternal _ListenResponse_default_instance_;
+class PartitionQueryRequest;
+class PartitionQueryRequestDefaultTypeInternal;
+extern PartitionQueryRequestDefaultTypeInternal _PartitionQueryRequest_default_instance_;
+class PartitionQueryResponse;
+class PartitionQueryResponseDefaultTypeInternal;
+extern PartitionQueryResponseDefaultTypeInternal _PartitionQueryResponse_default_instance_;
 class RollbackRequest;
 class RollbackRequestDefaultTypeInternal;
 extern RollbackRequestDefaultTypeInternal _RollbackRequest_default_instance_;
@@ -186,6 +192,8 @@ template<> ::google::firestore::v1::ListDocumentsResponse* Arena::CreateMaybeMes
 template<> ::google::firestore::v1::ListenRequest* Arena::CreateMaybeMessage<::google::firestore::v1::ListenRequest>(Arena*);
 template<> ::google::firestore::v1::ListenRequest_LabelsEntry_DoNotUse* Arena::CreateMaybeMessage<::google::firestore::v1::ListenRequest_LabelsEntry_DoNotUse>(Arena*);
 template<> ::google::firestore::v1::ListenResponse* Arena::CreateMaybeMessage<::google::firestore::v1::ListenResponse>(Arena*);
+template<> ::google::firestore::v1::PartitionQueryRequest* Arena::CreateMaybeMessage<::google::firestore::v1::PartitionQueryRequest>(Arena*);
+template<> ::google::firestore::v1::PartitionQueryResponse* Arena::CreateMaybeMessage<::google::firestore::v1::PartitionQueryResponse>(Arena*);
 template<> ::google::firestore::v1::RollbackRequest* Arena::CreateMaybeMessage<::google::firestore::v1::RollbackRequest>(Arena*);
 template<> ::google::firestore::v1::RunQueryRequest* Arena::CreateMaybeMessage<::google::firestore::v1::RunQueryRequest>(Arena*);
 template<> ::google::firestore::v1::RunQueryResponse* Arena::CreateMaybeMessage<::google::firestore::v1::RunQueryResponse>(Arena*);
@@ -3070,6 +3078,400 @@ class RunQueryResponse :
 };
 // -------------------------------------------------------------------
 
+class PartitionQueryRequest :
+    public ::PROTOBUF_NAMESPACE_ID::Message /* @@protoc_insertion_point(class_definition:google.firestore.v1.PartitionQueryRequest) */ {
+ public:
+  PartitionQueryRequest();
+  virtual ~PartitionQueryRequest();
+
+  PartitionQueryRequest(const PartitionQueryRequest& from);
+  PartitionQueryRequest(PartitionQueryRequest&& from) noexcept
+    : PartitionQueryRequest() {
+    *this = ::std::move(from);
+  }
+
+  inline PartitionQueryRequest& operator=(const PartitionQueryRequest& from) {
+    CopyFrom(from);
+    return *this;
+  }
+  inline PartitionQueryRequest& operator=(PartitionQueryRequest&& from) noexcept {
+    if (GetArenaNoVirtual() == from.GetArenaNoVirtual()) {
+      if (this != &from) InternalSwap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* descriptor() {
+    return GetDescriptor();
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* GetDescriptor() {
+    return GetMetadataStatic().descriptor;
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Reflection* GetReflection() {
+    return GetMetadataStatic().reflection;
+  }
+  static const PartitionQueryRequest& default_instance();
+
+  enum QueryTypeCase {
+    kStructuredQuery = 2,
+    QUERY_TYPE_NOT_SET = 0,
+  };
+
+  enum ConsistencySelectorCase {
+    kReadTime = 6,
+    CONSISTENCY_SELECTOR_NOT_SET = 0,
+  };
+
+  static void InitAsDefaultInstance();  // FOR INTERNAL USE ONLY
+  static inline const PartitionQueryRequest* internal_default_instance() {
+    return reinterpret_cast<const PartitionQueryRequest*>(
+               &_PartitionQueryRequest_default_instance_);
+  }
+  static constexpr int kIndexInFileMessages =
+    15;
+
+  friend void swap(PartitionQueryRequest& a, PartitionQueryRequest& b) {
+    a.Swap(&b);
+  }
+  inline void Swap(PartitionQueryRequest* other) {
+    if (other == this) return;
+    InternalSwap(other);
+  }
+
+  // implements Message ----------------------------------------------
+
+  inline PartitionQueryRequest* New() const final {
+    return CreateMaybeMessage<PartitionQueryRequest>(nullptr);
+  }
+
+  PartitionQueryRequest* New(::PROTOBUF_NAMESPACE_ID::Arena* arena) const final {
+    return CreateMaybeMessage<PartitionQueryRequest>(arena);
+  }
+  void CopyFrom(const ::PROTOBUF_NAMESPACE_ID::Message& from) final;
+  void MergeFrom(const ::PROTOBUF_NAMESPACE_ID::Message& from) final;
+  void CopyFrom(const PartitionQueryRequest& from);
+  void MergeFrom(const PartitionQueryRequest& from);
+  PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
+  bool IsInitialized() const final;
+
+  size_t ByteSizeLong() const final;
+  const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
+  ::PROTOBUF_NAMESPACE_ID::uint8* _InternalSerialize(
+      ::PROTOBUF_NAMESPACE_ID::uint8* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
+  int GetCachedSize() const final { return _cached_size_.Get(); }
+
+  private:
+  inline void SharedCtor();
+  inline void SharedDtor();
+  void SetCachedSize(int size) const final;
+  void InternalSwap(PartitionQueryRequest* other);
+  friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
+  static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
+    return "google.firestore.v1.PartitionQueryRequest";
+  }
+  private:
+  inline ::PROTOBUF_NAMESPACE_ID::Arena* GetArenaNoVirtual() const {
+    return nullptr;
+  }
+  inline void* MaybeArenaPtr() const {
+    return nullptr;
+  }
+  public:
+
+  ::PROTOBUF_NAMESPACE_ID::Metadata GetMetadata() const final;
+  private:
+  static ::PROTOBUF_NAMESPACE_ID::Metadata GetMetadataStatic() {
+    ::PROTOBUF_NAMESPACE_ID::internal::AssignDescriptors(&::descriptor_table_google_2ffirestore_2fv1_2ffirestore_2eproto);
+    return ::descriptor_table_google_2ffirestore_2fv1_2ffirestore_2eproto.file_level_metadata[kIndexInFileMessages];
+  }
+
+  public:
+
+  // nested types ----------------------------------------------------
+
+  // accessors -------------------------------------------------------
+
+  enum : int {
+    kParentFieldNumber = 1,
+    kPageTokenFieldNumber = 4,
+    kPartitionCountFieldNumber = 3,
+    kPageSizeFieldNumber = 5,
+    kStructuredQueryFieldNumber = 2,
+    kReadTimeFieldNumber = 6,
+  };
+  // string parent = 1;
+  void clear_parent();
+  const std::string& parent() const;
+  void set_parent(const std::string& value);
+  void set_parent(std::string&& value);
+  void set_parent(const char* value);
+  void set_parent(const char* value, size_t size);
+  std::string* mutable_parent();
+  std::string* release_parent();
+  void set_allocated_parent(std::string* parent);
+  private:
+  const std::string& _internal_parent() const;
+  void _internal_set_parent(const std::string& value);
+  std::string* _internal_mutable_parent();
+  public:
+
+  // string page_token = 4;
+  void clear_page_token();
+  const std::string& page_token() const;
+  void set_page_token(const std::string& value);
+  void set_page_token(std::string&& value);
+  void set_page_token(const char* value);
+  void set_page_token(const char* value, size_t size);
+  std::string* mutable_page_token();
+  std::string* release_page_token();
+  void set_allocated_page_token(std::string* page_token);
+  private:
+  const std::string& _internal_page_token() const;
+  void _internal_set_page_token(const std::string& value);
+  std::string* _internal_mutable_page_token();
+  public:
+
+  // int64 partition_count = 3;
+  void clear_partition_count();
+  ::PROTOBUF_NAMESPACE_ID::int64 partition_count() const;
+  void set_partition_count(::PROTOBUF_NAMESPACE_ID::int64 value);
+  private:
+  ::PROTOBUF_NAMESPACE_ID::int64 _internal_partition_count() const;
+  void _internal_set_partition_count(::PROTOBUF_NAMESPACE_ID::int64 value);
+  public:
+
+  // int32 page_size = 5;
+  void clear_page_size();
+  ::PROTOBUF_NAMESPACE_ID::int32 page_size() const;
+  void set_page_size(::PROTOBUF_NAMESPACE_ID::int32 value);
+  private:
+  ::PROTOBUF_NAMESPACE_ID::int32 _internal_page_size() const;
+  void _internal_set_page_size(::PROTOBUF_NAMESPACE_ID::int32 value);
+  public:
+
+  // .google.firestore.v1.StructuredQuery structured_query = 2;
+  bool has_structured_query() const;
+  private:
+  bool _internal_has_structured_query() const;
+  public:
+  void clear_structured_query();
+  const ::google::firestore::v1::StructuredQuery& structured_query() const;
+  ::google::firestore::v1::StructuredQuery* release_structured_query();
+  ::google::firestore::v1::StructuredQuery* mutable_structured_query();
+  void set_allocated_structured_query(::google::firestore::v1::StructuredQuery* structured_query);
+  private:
+  const ::google::firestore::v1::StructuredQuery& _internal_structured_query() const;
+  ::google::firestore::v1::StructuredQuery* _internal_mutable_structured_query();
+  public:
+
+  // .google.protobuf.Timestamp read_time = 6;
+  bool has_read_time() const;
+  private:
+  bool _internal_has_read_time() const;
+  public:
+  void clear_read_time();
+  const PROTOBUF_NAMESPACE_ID::Timestamp& read_time() const;
+  PROTOBUF_NAMESPACE_ID::Timestamp* release_read_time();
+  PROTOBUF_NAMESPACE_ID::Timestamp* mutable_read_time();
+  void set_allocated_read_time(PROTOBUF_NAMESPACE_ID::Timestamp* read_time);
+  private:
+  const PROTOBUF_NAMESPACE_ID::Timestamp& _internal_read_time() const;
+  PROTOBUF_NAMESPACE_ID::Timestamp* _internal_mutable_read_time();
+  public:
+
+  void clear_query_type();
+  QueryTypeCase query_type_case() const;
+  void clear_consistency_selector();
+  ConsistencySelectorCase consistency_selector_case() const;
+  // @@protoc_insertion_point(class_scope:google.firestore.v1.PartitionQueryRequest)
+ private:
+  class _Internal;
+  void set_has_structured_query();
+  void set_has_read_time();
+
+  inline bool has_query_type() const;
+  inline void clear_has_query_type();
+
+  inline bool has_consistency_selector() const;
+  inline void clear_has_consistency_selector();
+
+  ::PROTOBUF_NAMESPACE_ID::internal::InternalMetadataWithArena _internal_metadata_;
+  ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr parent_;
+  ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr page_token_;
+  ::PROTOBUF_NAMESPACE_ID::int64 partition_count_;
+  ::PROTOBUF_NAMESPACE_ID::int32 page_size_;
+  union QueryTypeUnion {
+    QueryTypeUnion() {}
+    ::google::firestore::v1::StructuredQuery* structured_query_;
+  } query_type_;
+  union ConsistencySelectorUnion {
+    ConsistencySelectorUnion() {}
+    PROTOBUF_NAMESPACE_ID::Timestamp* read_time_;
+  } consistency_selector_;
+  mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+  ::PROTOBUF_NAMESPACE_ID::uint32 _oneof_case_[2];
+
+  friend struct ::TableStruct_google_2ffirestore_2fv1_2ffirestore_2eproto;
+};
+// -------------------------------------------------------------------
+
+class PartitionQueryResponse :
+    public ::PROTOBUF_NAMESPACE_ID::Message /* @@protoc_insertion_point(class_definition:google.firestore.v1.PartitionQueryResponse) */ {
+ public:
+  PartitionQueryResponse();
+  virtual ~PartitionQueryResponse();
+
+  PartitionQueryResponse(const PartitionQueryResponse& from);
+  PartitionQueryResponse(PartitionQueryResponse&& from) noexcept
+    : PartitionQueryResponse() {
+    *this = ::std::move(from);
+  }
+
+  inline PartitionQueryResponse& operator=(const PartitionQueryResponse& from) {
+    CopyFrom(from);
+    return *this;
+  }
+  inline PartitionQueryResponse& operator=(PartitionQueryResponse&& from) noexcept {
+    if (GetArenaNoVirtual() == from.GetArenaNoVirtual()) {
+      if (this != &from) InternalSwap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* descriptor() {
+    return GetDescriptor();
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* GetDescriptor() {
+    return GetMetadataStatic().descriptor;
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Reflection* GetReflection() {
+    return GetMetadataStatic().reflection;
+  }
+  static const PartitionQueryResponse& default_instance();
+
+  static void InitAsDefaultInstance();  // FOR INTERNAL USE ONLY
+  static inline const PartitionQueryResponse* internal_default_instance() {
+    return reinterpret_cast<const PartitionQueryResponse*>(
+               &_PartitionQueryResponse_default_instance_);
+  }
+  static constexpr int kIndexInFileMessages =
+    16;
+
+  friend void swap(PartitionQueryResponse& a, PartitionQueryResponse& b) {
+    a.Swap(&b);
+  }
+  inline void Swap(PartitionQueryResponse* other) {
+    if (other == this) return;
+    InternalSwap(other);
+  }
+
+  // implements Message ----------------------------------------------
+
+  inline PartitionQueryResponse* New() const final {
+    return CreateMaybeMessage<PartitionQueryResponse>(nullptr);
+  }
+
+  PartitionQueryResponse* New(::PROTOBUF_NAMESPACE_ID::Arena* arena) const final {
+    return CreateMaybeMessage<PartitionQueryResponse>(arena);
+  }
+  void CopyFrom(const ::PROTOBUF_NAMESPACE_ID::Message& from) final;
+  void MergeFrom(const ::PROTOBUF_NAMESPACE_ID::Message& from) final;
+  void CopyFrom(const PartitionQueryResponse& from);
+  void MergeFrom(const PartitionQueryResponse& from);
+  PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
+  bool IsInitialized() const final;
+
+  size_t ByteSizeLong() const final;
+  const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
+  ::PROTOBUF_NAMESPACE_ID::uint8* _InternalSerialize(
+      ::PROTOBUF_NAMESPACE_ID::uint8* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
+  int GetCachedSize() const final { return _cached_size_.Get(); }
+
+  private:
+  inline void SharedCtor();
+  inline void SharedDtor();
+  void SetCachedSize(int size) const final;
+  void InternalSwap(PartitionQueryResponse* other);
+  friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
+  static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
+    return "google.firestore.v1.PartitionQueryResponse";
+  }
+  private:
+  inline ::PROTOBUF_NAMESPACE_ID::Arena* GetArenaNoVirtual() const {
+    return nullptr;
+  }
+  inline void* MaybeArenaPtr() const {
+    return nullptr;
+  }
+  public:
+
+  ::PROTOBUF_NAMESPACE_ID::Metadata GetMetadata() const final;
+  private:
+  static ::PROTOBUF_NAMESPACE_ID::Metadata GetMetadataStatic() {
+    ::PROTOBUF_NAMESPACE_ID::internal::AssignDescriptors(&::descriptor_table_google_2ffirestore_2fv1_2ffirestore_2eproto);
+    return ::descriptor_table_google_2ffirestore_2fv1_2ffirestore_2eproto.file_level_metadata[kIndexInFileMessages];
+  }
+
+  public:
+
+  // nested types ----------------------------------------------------
+
+  // accessors -------------------------------------------------------
+
+  enum : int {
+    kPartitionsFieldNumber = 1,
+    kNextPageTokenFieldNumber = 2,
+  };
+  // repeated .google.firestore.v1.Cursor partitions = 1;
+  int partitions_size() const;
+  private:
+  int _internal_partitions_size() const;
+  public:
+  void clear_partitions();
+  ::google::firestore::v1::Cursor* mutable_partitions(int index);
+  ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::google::firestore::v1::Cursor >*
+      mutable_partitions();
+  private:
+  const ::google::firestore::v1::Cursor& _internal_partitions(int index) const;
+  ::google::firestore::v1::Cursor* _internal_add_partitions();
+  public:
+  const ::google::firestore::v1::Cursor& partitions(int index) const;
+  ::google::firestore::v1::Cursor* add_partitions();
+  const ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::google::firestore::v1::Cursor >&
+      partitions() const;
+
+  // string next_page_token = 2;
+  void clear_next_page_token();
+  const std::string& next_page_token() const;
+  void set_next_page_token(const std::string& value);
+  void set_next_page_token(std::string&& value);
+  void set_next_page_token(const char* value);
+  void set_next_page_token(const char* value, size_t size);
+  std::string* mutable_next_page_token();
+  std::string* release_next_page_token();
+  void set_allocated_next_page_token(std::string* next_page_token);
+  private:
+  const std::string& _internal_next_page_token() const;
+  void _internal_set_next_page_token(const std::string& value);
+  std::string* _internal_mutable_next_page_token();
+  public:
+
+  // @@protoc_insertion_point(class_scope:google.firestore.v1.PartitionQueryResponse)
+ private:
+  class _Internal;
+
+  ::PROTOBUF_NAMESPACE_ID::internal::InternalMetadataWithArena _internal_metadata_;
+  ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::google::firestore::v1::Cursor > partitions_;
+  ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr next_page_token_;
+  mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+  friend struct ::TableStruct_google_2ffirestore_2fv1_2ffirestore_2eproto;
+};
+// -------------------------------------------------------------------
+
 class WriteRequest_LabelsEntry_DoNotUse : public ::PROTOBUF_NAMESPACE_ID::internal::MapEntry<WriteRequest_LabelsEntry_DoNotUse, 
     std::string, std::string,
     ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::TYPE_STRING,
@@ -3146,7 +3548,7 @@ class WriteRequest :
                &_WriteRequest_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    16;
+    18;
 
   friend void swap(WriteRequest& a, WriteRequest& b) {
     a.Swap(&b);
@@ -3362,7 +3764,7 @@ class WriteResponse :
                &_WriteResponse_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    17;
+    19;
 
   friend void swap(WriteResponse& a, WriteResponse& b) {
     a.Swap(&b);
@@ -3592,7 +3994,7 @@ class ListenRequest :
                &_ListenRequest_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    19;
+    21;
 
   friend void swap(ListenRequest& a, ListenRequest& b) {
     a.Swap(&b);
@@ -3804,7 +4206,7 @@ class ListenResponse :
                &_ListenResponse_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    20;
+    22;
 
   friend void swap(ListenResponse& a, ListenResponse& b) {
     a.Swap(&b);
@@ -4021,7 +4423,7 @@ class Target_DocumentsTarget :
                &_Target_DocumentsTarget_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    21;
+    23;
 
   friend void swap(Target_DocumentsTarget& a, Target_DocumentsTarget& b) {
     a.Swap(&b);
@@ -4169,7 +4571,7 @@ class Target_QueryTarget :
                &_Target_QueryTarget_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    22;
+    24;
 
   friend void swap(Target_QueryTarget& a, Target_QueryTarget& b) {
     a.Swap(&b);
@@ -4344,7 +4746,7 @@ class Target :
                &_Target_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    23;
+    25;
 
   friend void swap(Target& a, Target& b) {
     a.Swap(&b);
@@ -4580,7 +4982,7 @@ class TargetChange :
                &_TargetChange_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    24;
+    26;
 
   friend void swap(TargetChange& a, TargetChange& b) {
     a.Swap(&b);
@@ -4821,7 +5223,7 @@ class ListCollectionIdsRequest :
                &_ListCollectionIdsRequest_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    25;
+    27;
 
   friend void swap(ListCollectionIdsRequest& a, ListCollectionIdsRequest& b) {
     a.Swap(&b);
@@ -4985,7 +5387,7 @@ class ListCollectionIdsResponse :
                &_ListCollectionIdsResponse_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    26;
+    28;
 
   friend void swap(ListCollectionIdsResponse& a, ListCollectionIdsResponse& b) {
     a.Swap(&b);
@@ -8322,6 +8724,376 @@ inline void RunQueryResponse::set_skipped_results(::PROTOBUF_NAMESPACE_ID::int32
 
 // -------------------------------------------------------------------
 
+// PartitionQueryRequest
+
+// string parent = 1;
+inline void PartitionQueryRequest::clear_parent() {
+  parent_.ClearToEmptyNoArena(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
+}
+inline const std::string& PartitionQueryRequest::parent() const {
+  // @@protoc_insertion_point(field_get:google.firestore.v1.PartitionQueryRequest.parent)
+  return _internal_parent();
+}
+inline void PartitionQueryRequest::set_parent(const std::string& value) {
+  _internal_set_parent(value);
+  // @@protoc_insertion_point(field_set:google.firestore.v1.PartitionQueryRequest.parent)
+}
+inline std::string* PartitionQueryRequest::mutable_parent() {
+  // @@protoc_insertion_point(field_mutable:google.firestore.v1.PartitionQueryRequest.parent)
+  return _internal_mutable_parent();
+}
+inline const std::string& PartitionQueryRequest::_internal_parent() const {
+  return parent_.GetNoArena();
+}
+inline void PartitionQueryRequest::_internal_set_parent(const std::string& value) {
+  
+  parent_.SetNoArena(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), value);
+}
+inline void PartitionQueryRequest::set_parent(std::string&& value) {
+  
+  parent_.SetNoArena(
+    &::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), ::std::move(value));
+  // @@protoc_insertion_point(field_set_rvalue:google.firestore.v1.PartitionQueryRequest.parent)
+}
+inline void PartitionQueryRequest::set_parent(const char* value) {
+  GOOGLE_DCHECK(value != nullptr);
+  
+  parent_.SetNoArena(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), ::std::string(value));
+  // @@protoc_insertion_point(field_set_char:google.firestore.v1.PartitionQueryRequest.parent)
+}
+inline void PartitionQueryRequest::set_parent(const char* value, size_t size) {
+  
+  parent_.SetNoArena(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(),
+      ::std::string(reinterpret_cast<const char*>(value), size));
+  // @@protoc_insertion_point(field_set_pointer:google.firestore.v1.PartitionQueryRequest.parent)
+}
+inline std::string* PartitionQueryRequest::_internal_mutable_parent() {
+  
+  return parent_.MutableNoArena(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
+}
+inline std::string* PartitionQueryRequest::release_parent() {
+  // @@protoc_insertion_point(field_release:google.firestore.v1.PartitionQueryRequest.parent)
+  
+  return parent_.ReleaseNoArena(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
+}
+inline void PartitionQueryRequest::set_allocated_parent(std::string* parent) {
+  if (parent != nullptr) {
+    
+  } else {
+    
+  }
+  parent_.SetAllocatedNoArena(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), parent);
+  // @@protoc_insertion_point(field_set_allocated:google.firestore.v1.PartitionQueryRequest.parent)
+}
+
+// .google.firestore.v1.StructuredQuery structured_query = 2;
+inline bool PartitionQueryRequest::_internal_has_structured_query() const {
+  return query_type_case() == kStructuredQuery;
+}
+inline bool PartitionQueryRequest::has_structured_query() const {
+  return _internal_has_structured_query();
+}
+inline void PartitionQueryRequest::set_has_structured_query() {
+  _oneof_case_[0] = kStructuredQuery;
+}
+inline ::google::firestore::v1::StructuredQuery* PartitionQueryRequest::release_structured_query() {
+  // @@protoc_insertion_point(field_release:google.firestore.v1.PartitionQueryRequest.structured_query)
+  if (_internal_has_structured_query()) {
+    clear_has_query_type();
+      ::google::firestore::v1::StructuredQuery* temp = query_type_.structured_query_;
+    query_type_.structured_query_ = nullptr;
+    return temp;
+  } else {
+    return nullptr;
+  }
+}
+inline const ::google::firestore::v1::StructuredQuery& PartitionQueryRequest::_internal_structured_query() const {
+  return _internal_has_structured_query()
+      ? *query_type_.structured_query_
+      : *reinterpret_cast< ::google::firestore::v1::StructuredQuery*>(&::google::firestore::v1::_StructuredQuery_default_instance_);
+}
+inline const ::google::firestore::v1::StructuredQuery& PartitionQueryRequest::structured_query() const {
+  // @@protoc_insertion_point(field_get:google.firestore.v1.PartitionQueryRequest.structured_query)
+  return _internal_structured_query();
+}
+inline ::google::firestore::v1::StructuredQuery* PartitionQueryRequest::_internal_mutable_structured_query() {
+  if (!_internal_has_structured_query()) {
+    clear_query_type();
+    set_has_structured_query();
+    query_type_.structured_query_ = CreateMaybeMessage< ::google::firestore::v1::StructuredQuery >(
+        GetArenaNoVirtual());
+  }
+  return query_type_.structured_query_;
+}
+inline ::google::firestore::v1::StructuredQuery* PartitionQueryRequest::mutable_structured_query() {
+  // @@protoc_insertion_point(field_mutable:google.firestore.v1.PartitionQueryRequest.structured_query)
+  return _internal_mutable_structured_query();
+}
+
+// int64 partition_count = 3;
+inline void PartitionQueryRequest::clear_partition_count() {
+  partition_count_ = PROTOBUF_LONGLONG(0);
+}
+inline ::PROTOBUF_NAMESPACE_ID::int64 PartitionQueryRequest::_internal_partition_count() const {
+  return partition_count_;
+}
+inline ::PROTOBUF_NAMESPACE_ID::int64 PartitionQueryRequest::partition_count() const {
+  // @@protoc_insertion_point(field_get:google.firestore.v1.PartitionQueryRequest.partition_count)
+  return _internal_partition_count();
+}
+inline void PartitionQueryRequest::_internal_set_partition_count(::PROTOBUF_NAMESPACE_ID::int64 value) {
+  
+  partition_count_ = value;
+}
+inline void PartitionQueryRequest::set_partition_count(::PROTOBUF_NAMESPACE_ID::int64 value) {
+  _internal_set_partition_count(value);
+  // @@protoc_insertion_point(field_set:google.firestore.v1.PartitionQueryRequest.partition_count)
+}
+
+// string page_token = 4;
+inline void PartitionQueryRequest::clear_page_token() {
+  page_token_.ClearToEmptyNoArena(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
+}
+inline const std::string& PartitionQueryRequest::page_token() const {
+  // @@protoc_insertion_point(field_get:google.firestore.v1.PartitionQueryRequest.page_token)
+  return _internal_page_token();
+}
+inline void PartitionQueryRequest::set_page_token(const std::string& value) {
+  _internal_set_page_token(value);
+  // @@protoc_insertion_point(field_set:google.firestore.v1.PartitionQueryRequest.page_token)
+}
+inline std::string* PartitionQueryRequest::mutable_page_token() {
+  // @@protoc_insertion_point(field_mutable:google.firestore.v1.PartitionQueryRequest.page_token)
+  return _internal_mutable_page_token();
+}
+inline const std::string& PartitionQueryRequest::_internal_page_token() const {
+  return page_token_.GetNoArena();
+}
+inline void PartitionQueryRequest::_internal_set_page_token(const std::string& value) {
+  
+  page_token_.SetNoArena(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), value);
+}
+inline void PartitionQueryRequest::set_page_token(std::string&& value) {
+  
+  page_token_.SetNoArena(
+    &::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), ::std::move(value));
+  // @@protoc_insertion_point(field_set_rvalue:google.firestore.v1.PartitionQueryRequest.page_token)
+}
+inline void PartitionQueryRequest::set_page_token(const char* value) {
+  GOOGLE_DCHECK(value != nullptr);
+  
+  page_token_.SetNoArena(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), ::std::string(value));
+  // @@protoc_insertion_point(field_set_char:google.firestore.v1.PartitionQueryRequest.page_token)
+}
+inline void PartitionQueryRequest::set_page_token(const char* value, size_t size) {
+  
+  page_token_.SetNoArena(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(),
+      ::std::string(reinterpret_cast<const char*>(value), size));
+  // @@protoc_insertion_point(field_set_pointer:google.firestore.v1.PartitionQueryRequest.page_token)
+}
+inline std::string* PartitionQueryRequest::_internal_mutable_page_token() {
+  
+  return page_token_.MutableNoArena(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
+}
+inline std::string* PartitionQueryRequest::release_page_token() {
+  // @@protoc_insertion_point(field_release:google.firestore.v1.PartitionQueryRequest.page_token)
+  
+  return page_token_.ReleaseNoArena(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
+}
+inline void PartitionQueryRequest::set_allocated_page_token(std::string* page_token) {
+  if (page_token != nullptr) {
+    
+  } else {
+    
+  }
+  page_token_.SetAllocatedNoArena(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), page_token);
+  // @@protoc_insertion_point(field_set_allocated:google.firestore.v1.PartitionQueryRequest.page_token)
+}
+
+// int32 page_size = 5;
+inline void PartitionQueryRequest::clear_page_size() {
+  page_size_ = 0;
+}
+inline ::PROTOBUF_NAMESPACE_ID::int32 PartitionQueryRequest::_internal_page_size() const {
+  return page_size_;
+}
+inline ::PROTOBUF_NAMESPACE_ID::int32 PartitionQueryRequest::page_size() const {
+  // @@protoc_insertion_point(field_get:google.firestore.v1.PartitionQueryRequest.page_size)
+  return _internal_page_size();
+}
+inline void PartitionQueryRequest::_internal_set_page_size(::PROTOBUF_NAMESPACE_ID::int32 value) {
+  
+  page_size_ = value;
+}
+inline void PartitionQueryRequest::set_page_size(::PROTOBUF_NAMESPACE_ID::int32 value) {
+  _internal_set_page_size(value);
+  // @@protoc_insertion_point(field_set:google.firestore.v1.PartitionQueryRequest.page_size)
+}
+
+// .google.protobuf.Timestamp read_time = 6;
+inline bool PartitionQueryRequest::_internal_has_read_time() const {
+  return consistency_selector_case() == kReadTime;
+}
+inline bool PartitionQueryRequest::has_read_time() const {
+  return _internal_has_read_time();
+}
+inline void PartitionQueryRequest::set_has_read_time() {
+  _oneof_case_[1] = kReadTime;
+}
+inline PROTOBUF_NAMESPACE_ID::Timestamp* PartitionQueryRequest::release_read_time() {
+  // @@protoc_insertion_point(field_release:google.firestore.v1.PartitionQueryRequest.read_time)
+  if (_internal_has_read_time()) {
+    clear_has_consistency_selector();
+      PROTOBUF_NAMESPACE_ID::Timestamp* temp = consistency_selector_.read_time_;
+    consistency_selector_.read_time_ = nullptr;
+    return temp;
+  } else {
+    return nullptr;
+  }
+}
+inline const PROTOBUF_NAMESPACE_ID::Timestamp& PartitionQueryRequest::_internal_read_time() const {
+  return _internal_has_read_time()
+      ? *consistency_selector_.read_time_
+      : *reinterpret_cast< PROTOBUF_NAMESPACE_ID::Timestamp*>(&PROTOBUF_NAMESPACE_ID::_Timestamp_default_instance_);
+}
+inline const PROTOBUF_NAMESPACE_ID::Timestamp& PartitionQueryRequest::read_time() const {
+  // @@protoc_insertion_point(field_get:google.firestore.v1.PartitionQueryRequest.read_time)
+  return _internal_read_time();
+}
+inline PROTOBUF_NAMESPACE_ID::Timestamp* PartitionQueryRequest::_internal_mutable_read_time() {
+  if (!_internal_has_read_time()) {
+    clear_consistency_selector();
+    set_has_read_time();
+    consistency_selector_.read_time_ = CreateMaybeMessage< PROTOBUF_NAMESPACE_ID::Timestamp >(
+        GetArenaNoVirtual());
+  }
+  return consistency_selector_.read_time_;
+}
+inline PROTOBUF_NAMESPACE_ID::Timestamp* PartitionQueryRequest::mutable_read_time() {
+  // @@protoc_insertion_point(field_mutable:google.firestore.v1.PartitionQueryRequest.read_time)
+  return _internal_mutable_read_time();
+}
+
+inline bool PartitionQueryRequest::has_query_type() const {
+  return query_type_case() != QUERY_TYPE_NOT_SET;
+}
+inline void PartitionQueryRequest::clear_has_query_type() {
+  _oneof_case_[0] = QUERY_TYPE_NOT_SET;
+}
+inline bool PartitionQueryRequest::has_consistency_selector() const {
+  return consistency_selector_case() != CONSISTENCY_SELECTOR_NOT_SET;
+}
+inline void PartitionQueryRequest::clear_has_consistency_selector() {
+  _oneof_case_[1] = CONSISTENCY_SELECTOR_NOT_SET;
+}
+inline PartitionQueryRequest::QueryTypeCase PartitionQueryRequest::query_type_case() const {
+  return PartitionQueryRequest::QueryTypeCase(_oneof_case_[0]);
+}
+inline PartitionQueryRequest::ConsistencySelectorCase PartitionQueryRequest::consistency_selector_case() const {
+  return PartitionQueryRequest::ConsistencySelectorCase(_oneof_case_[1]);
+}
+// -------------------------------------------------------------------
+
+// PartitionQueryResponse
+
+// repeated .google.firestore.v1.Cursor partitions = 1;
+inline int PartitionQueryResponse::_internal_partitions_size() const {
+  return partitions_.size();
+}
+inline int PartitionQueryResponse::partitions_size() const {
+  return _internal_partitions_size();
+}
+inline ::google::firestore::v1::Cursor* PartitionQueryResponse::mutable_partitions(int index) {
+  // @@protoc_insertion_point(field_mutable:google.firestore.v1.PartitionQueryResponse.partitions)
+  return partitions_.Mutable(index);
+}
+inline ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::google::firestore::v1::Cursor >*
+PartitionQueryResponse::mutable_partitions() {
+  // @@protoc_insertion_point(field_mutable_list:google.firestore.v1.PartitionQueryResponse.partitions)
+  return &partitions_;
+}
+inline const ::google::firestore::v1::Cursor& PartitionQueryResponse::_internal_partitions(int index) const {
+  return partitions_.Get(index);
+}
+inline const ::google::firestore::v1::Cursor& PartitionQueryResponse::partitions(int index) const {
+  // @@protoc_insertion_point(field_get:google.firestore.v1.PartitionQueryResponse.partitions)
+  return _internal_partitions(index);
+}
+inline ::google::firestore::v1::Cursor* PartitionQueryResponse::_internal_add_partitions() {
+  return partitions_.Add();
+}
+inline ::google::firestore::v1::Cursor* PartitionQueryResponse::add_partitions() {
+  // @@protoc_insertion_point(field_add:google.firestore.v1.PartitionQueryResponse.partitions)
+  return _internal_add_partitions();
+}
+inline const ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::google::firestore::v1::Cursor >&
+PartitionQueryResponse::partitions() const {
+  // @@protoc_insertion_point(field_list:google.firestore.v1.PartitionQueryResponse.partitions)
+  return partitions_;
+}
+
+// string next_page_token = 2;
+inline void PartitionQueryResponse::clear_next_page_token() {
+  next_page_token_.ClearToEmptyNoArena(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
+}
+inline const std::string& PartitionQueryResponse::next_page_token() const {
+  // @@protoc_insertion_point(field_get:google.firestore.v1.PartitionQueryResponse.next_page_token)
+  return _internal_next_page_token();
+}
+inline void PartitionQueryResponse::set_next_page_token(const std::string& value) {
+  _internal_set_next_page_token(value);
+  // @@protoc_insertion_point(field_set:google.firestore.v1.PartitionQueryResponse.next_page_token)
+}
+inline std::string* PartitionQueryResponse::mutable_next_page_token() {
+  // @@protoc_insertion_point(field_mutable:google.firestore.v1.PartitionQueryResponse.next_page_token)
+  return _internal_mutable_next_page_token();
+}
+inline const std::string& PartitionQueryResponse::_internal_next_page_token() const {
+  return next_page_token_.GetNoArena();
+}
+inline void PartitionQueryResponse::_internal_set_next_page_token(const std::string& value) {
+  
+  next_page_token_.SetNoArena(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), value);
+}
+inline void PartitionQueryResponse::set_next_page_token(std::string&& value) {
+  
+  next_page_token_.SetNoArena(
+    &::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), ::std::move(value));
+  // @@protoc_insertion_point(field_set_rvalue:google.firestore.v1.PartitionQueryResponse.next_page_token)
+}
+inline void PartitionQueryResponse::set_next_page_token(const char* value) {
+  GOOGLE_DCHECK(value != nullptr);
+  
+  next_page_token_.SetNoArena(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), ::std::string(value));
+  // @@protoc_insertion_point(field_set_char:google.firestore.v1.PartitionQueryResponse.next_page_token)
+}
+inline void PartitionQueryResponse::set_next_page_token(const char* value, size_t size) {
+  
+  next_page_token_.SetNoArena(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(),
+      ::std::string(reinterpret_cast<const char*>(value), size));
+  // @@protoc_insertion_point(field_set_pointer:google.firestore.v1.PartitionQueryResponse.next_page_token)
+}
+inline std::string* PartitionQueryResponse::_internal_mutable_next_page_token() {
+  
+  return next_page_token_.MutableNoArena(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
+}
+inline std::string* PartitionQueryResponse::release_next_page_token() {
+  // @@protoc_insertion_point(field_release:google.firestore.v1.PartitionQueryResponse.next_page_token)
+  
+  return next_page_token_.ReleaseNoArena(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
+}
+inline void PartitionQueryResponse::set_allocated_next_page_token(std::string* next_page_token) {
+  if (next_page_token != nullptr) {
+    
+  } else {
+    
+  }
+  next_page_token_.SetAllocatedNoArena(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), next_page_token);
+  // @@protoc_insertion_point(field_set_allocated:google.firestore.v1.PartitionQueryResponse.next_page_token)
+}
+
+// -------------------------------------------------------------------
+
 // -------------------------------------------------------------------
 
 // WriteRequest
@@ -10290,6 +11062,10 @@ inline void ListCollectionIdsResponse::set_allocated_next_page_token(std::string
 
 // -------------------------------------------------------------------
 
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+
 
 // @@protoc_insertion_point(namespace_scope)
 
@@ -104,6 +104,15 @@ typedef struct _google_firestore_v1_ListenRequest_LabelsEntry {
 /* @@protoc_insertion_point(struct:google_firestore_v1_ListenRequest_LabelsEntry) */
 } google_firestore_v1_ListenRequest_LabelsEntry;
 
+typedef struct _google_firestore_v1_PartitionQueryResponse {
+    pb_size_t partitions_count;
+    struct _google_firestore_v1_Cursor *partitions;
+    pb_bytes_array_t *next_page_token;
+
+    std::string ToString(int indent = 0) const;
+/* @@protoc_insertion_point(struct:google_firestore_v1_PartitionQueryResponse) */
+} google_firestore_v1_PartitionQueryResponse;
+
 typedef struct _google_firestore_v1_RollbackRequest {
     pb_bytes_array_t *database;
     pb_bytes_array_t *transaction;
@@ -246,6 +255,24 @@ typedef struct _google_firestore_v1_ListDocumentsRequest {
 /* @@protoc_insertion_point(struct:google_firestore_v1_ListDocumentsRequest) */
 } google_firestore_v1_ListDocumentsRequest;
 
+typedef struct _google_firestore_v1_PartitionQueryRequest {
+    pb_bytes_array_t *parent;
+    pb_size_t which_query_type;
+    union {
+        google_firestore_v1_StructuredQuery structured_query;
+    } query_type;
+    int64_t partition_count;
+    pb_bytes_array_t *page_token;
+    int32_t page_size;
+    pb_size_t which_consistency_selector;
+    union {
+        google_protobuf_Timestamp read_time;
+    } consistency_selector;
+
+    std::string ToString(int indent = 0) const;
+/* @@protoc_insertion_point(struct:google_firestore_v1_PartitionQueryRequest) */
+} google_firestore_v1_PartitionQueryRequest;
+
 typedef struct _google_firestore_v1_RunQueryRequest {
     pb_bytes_array_t *parent;
     pb_size_t which_query_type;
@@ -382,6 +409,8 @@ typedef struct _google_firestore_v1_ListenRequest {
 #define google_firestore_v1_RollbackRequest_init_default {NULL, NULL}
 #define google_firestore_v1_RunQueryRequest_init_default {NULL, 0, {google_firestore_v1_StructuredQuery_init_default}, 0, {NULL}}
 #define google_firestore_v1_RunQueryResponse_init_default {google_firestore_v1_Document_init_default, NULL, google_protobuf_Timestamp_init_default, 0}
+#define google_firestore_v1_PartitionQueryRequest_init_default {NULL, 0, {google_firestore_v1_StructuredQuery_init_default}, 0, NULL, 0, 0, {google_protobuf_Timestamp_init_default}}
+#define google_firestore_v1_PartitionQueryResponse_init_default {0, NULL, NULL}
 #define google_firestore_v1_WriteRequest_init_default {NULL, NULL, 0, NULL, NULL, 0, NULL}
 #define google_firestore_v1_WriteRequest_LabelsEntry_init_default {NULL, NULL}
 #define google_firestore_v1_WriteResponse_init_default {NULL, NULL, 0, NULL, google_protobuf_Timestamp_init_default}
@@ -409,6 +438,8 @@ typedef struct _google_firestore_v1_ListenRequest {
 #define google_firestore_v1_RollbackRequest_init_zero {NULL, NULL}
 #define google_firestore_v1_RunQueryRequest_init_zero {NULL, 0, {google_firestore_v1_StructuredQuery_init_zero}, 0, {NULL}}
 #define google_firestore_v1_RunQueryResponse_init_zero {google_firestore_v1_Document_init_zero, NULL, google_protobuf_Timestamp_init_zero, 0}
+#define google_firestore_v1_PartitionQueryRequest_init_zero {NULL, 0, {google_firestore_v1_StructuredQuery_init_zero}, 0, NULL, 0, 0, {google_protobuf_Timestamp_init_zero}}
+#define google_firestore_v1_PartitionQueryResponse_init_zero {0, NULL, NULL}
 #define google_firestore_v1_WriteRequest_init_zero {NULL, NULL, 0, NULL, NULL, 0, NULL}
 #define google_firestore_v1_WriteRequest_LabelsEntry_init_zero {NULL, NULL}
 #define google_firestore_v1_WriteResponse_init_zero {NULL, NULL, 0, NULL, google_protobuf_Timestamp_init_zero}
@@ -433,6 +464,8 @@ typedef struct _google_firestore_v1_ListenRequest {
 #define google_firestore_v1_ListDocumentsResponse_next_page_token_tag 2
 #define google_firestore_v1_ListenRequest_LabelsEntry_key_tag 1
 #define google_firestore_v1_ListenRequest_LabelsEntry_value_tag 2
+#define google_firestore_v1_PartitionQueryResponse_partitions_tag 1
+#define google_firestore_v1_PartitionQueryResponse_next_page_token_tag 2
 #define google_firestore_v1_RollbackRequest_database_tag 1
 #define google_firestore_v1_RollbackRequest_transaction_tag 2
 #define google_firestore_v1_Target_DocumentsTarget_documents_tag 2
@@ -480,6 +513,12 @@ typedef struct _google_firestore_v1_ListenRequest {
 #define google_firestore_v1_ListDocumentsRequest_order_by_tag 6
 #define google_firestore_v1_ListDocumentsRequest_mask_tag 7
 #define google_firestore_v1_ListDocumentsRequest_show_missing_tag 12
+#define google_firestore_v1_PartitionQueryRequest_structured_query_tag 2
+#define google_firestore_v1_PartitionQueryRequest_read_time_tag 6
+#define google_firestore_v1_PartitionQueryRequest_parent_tag 1
+#define google_firestore_v1_PartitionQueryRequest_partition_count_tag 3
+#define google_firestore_v1_PartitionQueryRequest_page_token_tag 4
+#define google_firestore_v1_PartitionQueryRequest_page_size_tag 5
 #define google_firestore_v1_RunQueryRequest_structured_query_tag 2
 #define google_firestore_v1_RunQueryRequest_transaction_tag 5
 #define google_firestore_v1_RunQueryRequest_new_transaction_tag 6
@@ -536,6 +575,8 @@ extern const pb_field_t google_firestore_v1_CommitResponse_fields[3];
 extern const pb_field_t google_firestore_v1_RollbackRequest_fields[3];
 extern const pb_field_t google_firestore_v1_RunQueryRequest_fields[6];
 extern const pb_field_t google_firestore_v1_RunQueryResponse_fields[5];
+extern const pb_field_t google_firestore_v1_PartitionQueryRequest_fields[7];
+extern const pb_field_t google_firestore_v1_PartitionQueryResponse_fields[3];
 extern const pb_field_t google_firestore_v1_WriteRequest_fields[6];
 extern const pb_field_t google_firestore_v1_WriteRequest_LabelsEntry_fields[3];
 extern const pb_field_t google_firestore_v1_WriteResponse_fields[5];
@@ -565,6 +606,8 @@ extern const pb_field_t google_firestore_v1_ListCollectionIdsResponse_fields[3];
 /* google_firestore_v1_RollbackRequest_size depends on runtime parameters */
 /* google_firestore_v1_RunQueryRequest_size depends on runtime parameters */
 /* google_firestore_v1_RunQueryResponse_size depends on runtime parameters */
+/* google_firestore_v1_PartitionQueryRequest_size depends on runtime parameters */
+/* google_firestore_v1_PartitionQueryResponse_size depends on runtime parameters */
 /* google_firestore_v1_WriteRequest_size depends on runtime parameters */
 /* google_firestore_v1_WriteRequest_LabelsEntry_size depends on runtime parameters */
 /* google_firestore_v1_WriteResponse_size depends on runtime parameters */
@@ -42,6 +42,7 @@ ABSL_CONST_INIT extern "C" const int64_t kFIRFirestoreCacheSizeUnlimited =
     _dispatchQueue = dispatch_get_main_queue();
     _persistenceEnabled = Settings::DefaultPersistenceEnabled;
     _cacheSizeBytes = Settings::DefaultCacheSizeBytes;
+    _writeCoalescingEnabled = Settings::DefaultWriteCoalescingEnabled;
   }
   return self;
 }
@@ -58,7 +59,8 @@ ABSL_CONST_INIT extern "C" const int64_t kFIRFirestoreCacheSizeUnlimited =
          self.isSSLEnabled == otherSettings.isSSLEnabled &&
          self.dispatchQueue == otherSettings.dispatchQueue &&
          self.isPersistenceEnabled == otherSettings.isPersistenceEnabled &&
-         self.cacheSizeBytes == otherSettings.cacheSizeBytes;
+         self.cacheSizeBytes == otherSettings.cacheSizeBytes &&
+         self.isWriteCoalescingEnabled == otherSettings.isWriteCoalescingEnabled;
 }
 
 - (NSUInteger)hash {
@@ -67,6 +69,7 @@ ABSL_CONST_INIT extern "C" const int64_t kFIRFirestoreCacheSizeUnlimited =
   // Ignore the dispatchQueue to avoid having to deal with sizeof(dispatch_queue_t).
   result = 31 * result + (self.isPersistenceEnabled ? 1231 : 1237);
   result = 31 * result + (NSUInteger)self.cacheSizeBytes;
+  result = 31 * result + (self.isWriteCoalescingEnabled ? 1231 : 1237);
   return result;
 }
 
@@ -77,6 +80,7 @@ ABSL_CONST_INIT extern "C" const int64_t kFIRFirestoreCacheSizeUnlimited =
   copy.dispatchQueue = _dispatchQueue;
   copy.persistenceEnabled = _persistenceEnabled;
   copy.cacheSizeBytes = _cacheSizeBytes;
+  copy.writeCoalescingEnabled = _writeCoalescingEnabled;
   return copy;
 }
 
@@ -119,6 +123,7 @@ ABSL_CONST_INIT extern "C" const int64_t kFIRFirestoreCacheSizeUnlimited =
   settings.set_ssl_enabled(_sslEnabled);
   settings.set_persistence_enabled(_persistenceEnabled);
   settings.set_cache_size_bytes(_cacheSizeBytes);
+  settings.set_write_coalescing_enabled(_writeCoalescingEnabled);
   return settings;
 }
 
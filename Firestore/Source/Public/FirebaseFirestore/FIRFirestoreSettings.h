@@ -57,6 +57,14 @@ NS_SWIFT_NAME(FirestoreSettings)
  */
 @property(nonatomic, assign) int64_t cacheSizeBytes;
 
+/**
+ * Set to true to merge consecutive writes to a document while they wait to be sent, so that a
+ * document written many times while offline is sent once. Only sets and updates without field
+ * transforms are merged, and the backend accepts or rejects a merged write as a whole. Defaults to
+ * false.
+ */
+@property(nonatomic, getter=isWriteCoalescingEnabled) BOOL writeCoalescingEnabled;
+
 @end
 
 NS_ASSUME_NONNULL_END
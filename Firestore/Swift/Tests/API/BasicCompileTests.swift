@@ -73,6 +73,7 @@ func initializeDb() -> Firestore {
   settings.host = "localhost"
   settings.isPersistenceEnabled = true
   settings.cacheSizeBytes = FirestoreCacheSizeUnlimited
+  settings.isWriteCoalescingEnabled = false
   firestore.settings = settings
 
   return firestore
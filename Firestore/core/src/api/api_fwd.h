@@ -19,6 +19,7 @@
 
 #include <functional>
 #include <memory>
+#include <vector>
 
 #include "absl/types/optional.h"
 
@@ -31,8 +32,18 @@ class EventListener;
 class Query;
 }  // namespace core
 
+namespace local {
+struct QueryProfile;
+}  // namespace local
+
+namespace util {
+template <typename T>
+class StatusOr;
+}  // namespace util
+
 namespace api {
 
+class BulkWriter;
 class CollectionReference;
 class DocumentChange;
 class DocumentReference;
@@ -50,11 +61,28 @@ enum class Source;
 using DocumentSnapshotListener =
     std::unique_ptr<core::EventListener<DocumentSnapshot>>;
 
+using DocumentSnapshotsListener =
+    std::unique_ptr<core::EventListener<std::vector<DocumentSnapshot>>>;
+
 using QuerySnapshotListener =
     std::unique_ptr<core::EventListener<QuerySnapshot>>;
 
 using QueryCallback = std::function<void(core::Query, bool)>;
 
+/**
+ * Receives a page of query results and whether more pages follow. Returning
+ * false stops reading further pages.
+ */
+using QueryPageListener =
+    std::function<bool(util::StatusOr<QuerySnapshot> page, bool has_more)>;
+
+/** Receives the queries that a query was split into, in query order. */
+using QueryPartitionsCallback =
+    std::function<void(util::StatusOr<std::vector<Query>> partitions)>;
+
+/** Receives a description of how a query was executed against the cache. */
+using QueryProfileCallback = std::function<void(local::QueryProfile profile)>;
+
 }  // namespace api
 }  // namespace firestore
 }  // namespace firebase
@@ -0,0 +1,102 @@
+/*
+ * Copyright 2021 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Firestore/core/src/api/bulk_writer.h"
+
+#include "Firestore/core/src/api/document_reference.h"
+#include "Firestore/core/src/api/firestore.h"
+#include "Firestore/core/src/core/firestore_client.h"
+#include "Firestore/core/src/core/user_data.h"
+#include "Firestore/core/src/model/delete_mutation.h"
+#include "Firestore/core/src/util/exception.h"
+
+namespace firebase {
+namespace firestore {
+namespace api {
+
+using model::DeleteMutation;
+using model::Mutation;
+using model::Precondition;
+using util::StatusCallback;
+using util::ThrowIllegalState;
+using util::ThrowInvalidArgument;
+
+void BulkWriter::SetData(const DocumentReference& reference,
+                         core::ParsedSetData&& set_data,
+                         StatusCallback callback) {
+  VerifyNotClosed();
+  ValidateReference(reference);
+
+  Write(std::move(set_data).ToMutation(reference.key(), Precondition::None()),
+        std::move(callback));
+}
+
+void BulkWriter::UpdateData(const DocumentReference& reference,
+                            core::ParsedUpdateData&& update_data,
+                            StatusCallback callback) {
+  VerifyNotClosed();
+  ValidateReference(reference);
+
+  Write(std::move(update_data)
+            .ToMutation(reference.key(), Precondition::Exists(true)),
+        std::move(callback));
+}
+
+void BulkWriter::DeleteData(const DocumentReference& reference,
+                            StatusCallback callback) {
+  VerifyNotClosed();
+  ValidateReference(reference);
+
+  Write(DeleteMutation(reference.key(), Precondition::None()),
+        std::move(callback));
+}
+
+void BulkWriter::Flush(StatusCallback callback) {
+  VerifyNotClosed();
+
+  firestore_->client()->FlushBulkWriter(bulk_writer_, std::move(callback));
+}
+
+void BulkWriter::Close(StatusCallback callback) {
+  VerifyNotClosed();
+
+  closed_ = true;
+  firestore_->client()->FlushBulkWriter(bulk_writer_, std::move(callback));
+}
+
+void BulkWriter::Write(Mutation&& mutation, StatusCallback callback) {
+  firestore_->client()->BulkWrite(bulk_writer_, std::move(mutation),
+                                  std::move(callback));
+}
+
+void BulkWriter::VerifyNotClosed() const {
+  if (closed_) {
+    ThrowIllegalState(
+        "A bulk writer can no longer be used after close has been called.");
+  }
+}
+
+void BulkWriter::ValidateReference(const DocumentReference& reference) const {
+  if (reference.firestore() != firestore_) {
+    ThrowInvalidArgument(
+        "Provided document reference is from a different Cloud Firestore "
+        "instance.");
+  }
+}
+
+}  // namespace api
+}  // namespace firestore
+}  // namespace firebase
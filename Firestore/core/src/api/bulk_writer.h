@@ -0,0 +1,88 @@
+/*
+ * Copyright 2021 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FIRESTORE_CORE_SRC_API_BULK_WRITER_H_
+#define FIRESTORE_CORE_SRC_API_BULK_WRITER_H_
+
+#include <memory>
+#include <utility>
+
+#include "Firestore/core/src/api/api_fwd.h"
+#include "Firestore/core/src/core/core_fwd.h"
+#include "Firestore/core/src/model/mutation.h"
+#include "Firestore/core/src/util/status_fwd.h"
+
+namespace firebase {
+namespace firestore {
+namespace api {
+
+/**
+ * Writes a large number of documents, committing them to the backend in
+ * batches without going through the local cache.
+ *
+ * Unlike a `WriteBatch`, the writes are independent: each is reported to its
+ * own callback, and a write that fails doesn't fail the others. Writes are sent
+ * once enough of them are added to fill a batch; `Flush` and `Close` send the
+ * rest.
+ */
+class BulkWriter {
+ public:
+  BulkWriter(std::shared_ptr<Firestore> firestore,
+             std::shared_ptr<core::BulkWriter> bulk_writer)
+      : firestore_{std::move(firestore)}, bulk_writer_{std::move(bulk_writer)} {
+  }
+
+  void SetData(const DocumentReference& reference,
+               core::ParsedSetData&& set_data,
+               util::StatusCallback callback);
+  void UpdateData(const DocumentReference& reference,
+                  core::ParsedUpdateData&& update_data,
+                  util::StatusCallback callback);
+  void DeleteData(const DocumentReference& reference,
+                  util::StatusCallback callback);
+
+  /**
+   * Sends all writes added so far, and notifies `callback` once all of them
+   * have been committed or have failed.
+   */
+  void Flush(util::StatusCallback callback);
+
+  /**
+   * Flushes the writes added so far. The bulk writer can no longer be used
+   * after it's closed.
+   */
+  void Close(util::StatusCallback callback);
+
+  const std::shared_ptr<Firestore>& firestore() const {
+    return firestore_;
+  }
+
+ private:
+  void Write(model::Mutation&& mutation, util::StatusCallback callback);
+
+  void VerifyNotClosed() const;
+  void ValidateReference(const DocumentReference& reference) const;
+
+  std::shared_ptr<Firestore> firestore_;
+  std::shared_ptr<core::BulkWriter> bulk_writer_;
+  bool closed_ = false;
+};
+
+}  // namespace api
+}  // namespace firestore
+}  // namespace firebase
+
+#endif  // FIRESTORE_CORE_SRC_API_BULK_WRITER_H_
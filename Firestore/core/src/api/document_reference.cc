@@ -74,12 +74,12 @@ size_t DocumentReference::Hash() const {
   return util::Hash(firestore_.get(), key_);
 }
 
-const std::string& DocumentReference::document_id() const {
-  return key_.path().last_segment();
+std::string DocumentReference::document_id() const {
+  return std::string(key_.document_id());
 }
 
 CollectionReference DocumentReference::Parent() const {
-  return CollectionReference{key_.path().PopLast(), firestore_};
+  return CollectionReference{key_.collection_path(), firestore_};
 }
 
 std::string DocumentReference::Path() const {
@@ -18,12 +18,15 @@
 
 #include <utility>
 
+#include "Firestore/core/src/api/bulk_writer.h"
 #include "Firestore/core/src/api/collection_reference.h"
 #include "Firestore/core/src/api/document_reference.h"
 #include "Firestore/core/src/api/listener_registration.h"
 #include "Firestore/core/src/api/settings.h"
 #include "Firestore/core/src/api/snapshots_in_sync_listener_registration.h"
+#include "Firestore/core/src/api/source.h"
 #include "Firestore/core/src/api/write_batch.h"
+#include "Firestore/core/src/core/bulk_writer.h"
 #include "Firestore/core/src/core/event_listener.h"
 #include "Firestore/core/src/core/firestore_client.h"
 #include "Firestore/core/src/core/query.h"
@@ -35,6 +38,7 @@
 #include "Firestore/core/src/remote/firebase_metadata_provider.h"
 #include "Firestore/core/src/remote/grpc_connection.h"
 #include "Firestore/core/src/util/async_queue.h"
+#include "Firestore/core/src/util/exception.h"
 #include "Firestore/core/src/util/executor.h"
 #include "Firestore/core/src/util/hard_assert.h"
 #include "Firestore/core/src/util/status.h"
@@ -148,6 +152,11 @@ WriteBatch Firestore::GetBatch() {
   return WriteBatch(shared_from_this());
 }
 
+BulkWriter Firestore::GetBulkWriter(const core::BulkWriterOptions& options) {
+  EnsureClientConfigured();
+  return BulkWriter(shared_from_this(), client_->CreateBulkWriter(options));
+}
+
 core::Query Firestore::GetCollectionGroup(std::string collection_id) {
   EnsureClientConfigured();
 
@@ -155,6 +164,22 @@ core::Query Firestore::GetCollectionGroup(std::string collection_id) {
                                                 std::move(collection_id)));
 }
 
+void Firestore::GetAll(std::vector<DocumentReference> documents,
+                       Source source,
+                       DocumentSnapshotsListener&& callback) {
+  EnsureClientConfigured();
+
+  for (const DocumentReference& document : documents) {
+    if (document.firestore().get() != this) {
+      util::ThrowInvalidArgument(
+          "Provided document reference is from a different Cloud Firestore "
+          "instance.");
+    }
+  }
+
+  client_->GetAll(std::move(documents), source, std::move(callback));
+}
+
 void Firestore::RunTransaction(
     core::TransactionUpdateCallback update_callback,
     core::TransactionResultCallback result_callback) {
@@ -236,7 +261,7 @@ void Firestore::EnsureClientConfigured() {
 
 DatabaseInfo Firestore::MakeDatabaseInfo() const {
   return DatabaseInfo(database_id_, persistence_key_, settings_.host(),
-                      settings_.ssl_enabled());
+                      settings_.ssl_enabled(), settings_.grpc_options());
 }
 
 std::shared_ptr<LoadBundleTask> Firestore::LoadBundle(
@@ -255,6 +280,18 @@ void Firestore::GetNamedQuery(const std::string& name,
   client_->GetNamedQuery(name, std::move(callback));
 }
 
+void Firestore::ExportCacheSnapshot(const util::Path& file,
+                                    util::StatusCallback callback) {
+  EnsureClientConfigured();
+  client_->ExportCacheSnapshot(file, std::move(callback));
+}
+
+void Firestore::ImportCacheSnapshot(const util::Path& file,
+                                    util::StatusCallback callback) {
+  EnsureClientConfigured();
+  client_->ImportCacheSnapshot(file, std::move(callback));
+}
+
 }  // namespace api
 }  // namespace firestore
 }  // namespace firebase
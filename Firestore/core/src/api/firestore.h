@@ -20,6 +20,7 @@
 #include <memory>
 #include <mutex>  // NOLINT(build/c++11)
 #include <string>
+#include <vector>
 
 #include "Firestore/core/src/api/api_fwd.h"
 #include "Firestore/core/src/api/load_bundle_task.h"
@@ -40,6 +41,7 @@ class FirebaseMetadataProvider;
 namespace util {
 class AsyncQueue;
 class Executor;
+class Path;
 
 struct Empty;
 }  // namespace util
@@ -89,8 +91,27 @@ class Firestore : public std::enable_shared_from_this<Firestore> {
   CollectionReference GetCollection(const std::string& collection_path);
   DocumentReference GetDocument(const std::string& document_path);
   WriteBatch GetBatch();
+
+  /**
+   * Returns a `BulkWriter` that commits its writes in batches paced by the
+   * given options.
+   */
+  BulkWriter GetBulkWriter(const core::BulkWriterOptions& options);
   core::Query GetCollectionGroup(std::string collection_id);
 
+  /**
+   * Reads the given documents and delivers a snapshot of each, in the same
+   * order, to `callback`.
+   *
+   * Unless `source` is `Source::Cache`, all of the documents are read from the
+   * server in a single round trip, and the results are stored in the cache.
+   * With `Source::Default`, the documents are read from the cache instead if
+   * the server can't be reached.
+   */
+  void GetAll(std::vector<DocumentReference> documents,
+              Source source,
+              DocumentSnapshotsListener&& callback);
+
   void RunTransaction(core::TransactionUpdateCallback update_callback,
                       core::TransactionResultCallback result_callback);
 
@@ -107,6 +128,20 @@ class Firestore : public std::enable_shared_from_this<Firestore> {
       std::unique_ptr<util::ByteStream> bundle_data);
   void GetNamedQuery(const std::string& name, api::QueryCallback callback);
 
+  /**
+   * Writes the cached documents and targets to a new cache snapshot at `file`,
+   * which another client can seed its cache with.
+   */
+  void ExportCacheSnapshot(const util::Path& file,
+                           util::StatusCallback callback);
+
+  /**
+   * Seeds the cache with the cache snapshot at `file`. The cache must be empty
+   * and no queries may be listened to.
+   */
+  void ImportCacheSnapshot(const util::Path& file,
+                           util::StatusCallback callback);
+
   /**
    * Sets the language of the public API in the format of
    * "gl-<language>/<version>" where version might be blank, e.g. `gl-objc/`.
@@ -180,6 +180,38 @@ void Query::GetDocuments(Source source, QuerySnapshotListener&& callback) {
   listener_unowned->Resolve(std::move(registration));
 }
 
+void Query::GetDocumentPagesFromCache(size_t page_size,
+                                      QueryPageListener&& listener) {
+  ValidateHasExplicitOrderByForLimitToLast();
+  if (page_size == 0) {
+    ThrowInvalidArgument("Invalid page size. The page size must be positive.");
+  }
+  firestore_->client()->GetDocumentPagesFromLocalCache(*this, page_size,
+                                                       std::move(listener));
+}
+
+void Query::ProfileFromCache(QueryProfileCallback&& callback) {
+  ValidateHasExplicitOrderByForLimitToLast();
+  firestore_->client()->ProfileQueryFromLocalCache(*this, std::move(callback));
+}
+
+void Query::GetPartitions(int64_t partition_count,
+                          QueryPartitionsCallback&& callback) {
+  if (partition_count <= 0) {
+    ThrowInvalidArgument(
+        "Invalid partition count. The partition count must be positive.");
+  }
+  if (!query_.IsCollectionGroupQuery() || !query_.MatchesAllDocuments() ||
+      !query_.order_bys().front().ascending()) {
+    ThrowInvalidArgument(
+        "Invalid query. Only collection group queries without filters, "
+        "limits, cursors or orders other than ascending by document ID can be "
+        "partitioned.");
+  }
+  firestore_->client()->PartitionQuery(*this, partition_count,
+                                       std::move(callback));
+}
+
 std::unique_ptr<ListenerRegistration> Query::AddSnapshotListener(
     ListenOptions options, QuerySnapshotListener&& user_listener) {
   ValidateHasExplicitOrderByForLimitToLast();
@@ -17,6 +17,7 @@
 #ifndef FIRESTORE_CORE_SRC_API_QUERY_CORE_H_
 #define FIRESTORE_CORE_SRC_API_QUERY_CORE_H_
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <utility>
@@ -67,6 +68,48 @@ class Query {
    */
   void GetDocuments(Source source, QuerySnapshotListener&& callback);
 
+  /**
+   * Reads the documents matching this query from the cache in pages of at
+   * most `page_size` documents, in query order.
+   *
+   * Each page is delivered to `listener` as a snapshot of its own. The next
+   * page is only read once `listener` has returned for the previous one, so
+   * that a slow consumer doesn't accumulate pages. For queries in the default
+   * order (by document key), documents are also read from the cache a page at
+   * a time, so memory use doesn't grow with the size of the result; other
+   * queries are executed in full once and then delivered in pages.
+   *
+   * Pages aren't a consistent snapshot: local writes made while the pages are
+   * being read are reflected in the pages read after them.
+   */
+  void GetDocumentPagesFromCache(size_t page_size,
+                                 QueryPageListener&& listener);
+
+  /**
+   * Executes this query against the cache, as `GetDocuments(Source::Cache)`
+   * does, and reports how it was executed rather than its results: whether
+   * the results of earlier executions could be reused or the collection had
+   * to be scanned, how many documents were read, decoded and matched, how
+   * many pending writes were applied, and how long that took.
+   *
+   * Intended for diagnosing slow queries. Executing the query this way
+   * doesn't affect later executions.
+   */
+  void ProfileFromCache(QueryProfileCallback&& callback);
+
+  /**
+   * Splits this query into at most `partition_count` queries whose results
+   * together are the results of this query, so that they can be read in
+   * parallel. The backend chooses the split points so that the partitions are
+   * roughly the same size, and may return fewer partitions than requested.
+   *
+   * Only collection group queries without filters, limits, cursors or orders
+   * other than ascending by document ID can be partitioned. The partitions are
+   * bounded by document ID and delivered in order.
+   */
+  void GetPartitions(int64_t partition_count,
+                     QueryPartitionsCallback&& callback);
+
   /**
    * Attaches a listener for QuerySnapshot events.
    *
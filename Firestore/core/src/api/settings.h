@@ -20,6 +20,8 @@
 
 #include <string>
 
+#include "Firestore/core/src/remote/grpc_options.h"
+
 namespace firebase {
 namespace firestore {
 namespace api {
@@ -40,6 +42,7 @@ class Settings {
   static constexpr int64_t DefaultCacheSizeBytes = 100 * 1024 * 1024;
   static constexpr int64_t MinimumCacheSizeBytes = 1 * 1024 * 1024;
   static constexpr int64_t CacheSizeUnlimited = -1;
+  static constexpr bool DefaultWriteCoalescingEnabled = false;
 
   Settings() = default;
 
@@ -74,6 +77,26 @@ class Settings {
     return cache_size_bytes_ != CacheSizeUnlimited;
   }
 
+  /**
+   * Whether consecutive writes of single documents are merged while they wait
+   * to be sent, so that a document written many times while offline is sent
+   * once. Only sets and updates without transforms are merged, and a merged
+   * write is accepted or rejected by the backend as a whole.
+   */
+  void set_write_coalescing_enabled(bool value) {
+    write_coalescing_enabled_ = value;
+  }
+  bool write_coalescing_enabled() const {
+    return write_coalescing_enabled_;
+  }
+
+  void set_grpc_options(const remote::GrpcOptions& value) {
+    grpc_options_ = value;
+  }
+  const remote::GrpcOptions& grpc_options() const {
+    return grpc_options_;
+  }
+
   friend bool operator==(const Settings& lhs, const Settings& rhs);
 
   size_t Hash() const;
@@ -83,6 +106,8 @@ class Settings {
   bool ssl_enabled_ = DefaultSslEnabled;
   bool persistence_enabled_ = DefaultPersistenceEnabled;
   int64_t cache_size_bytes_ = DefaultCacheSizeBytes;
+  bool write_coalescing_enabled_ = DefaultWriteCoalescingEnabled;
+  remote::GrpcOptions grpc_options_;
 };
 
 }  // namespace api
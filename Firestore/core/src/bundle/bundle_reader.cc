@@ -18,6 +18,10 @@
 
 #include <algorithm>
 
+#include "Firestore/Protos/nanopb/firestore/bundle.nanopb.h"
+#include "Firestore/core/src/bundle/indexed_bundle.h"
+#include "Firestore/core/src/nanopb/message.h"
+#include "Firestore/core/src/nanopb/reader.h"
 #include "absl/memory/memory.h"
 #include "absl/strings/numbers.h"
 #include "absl/strings/string_view.h"
@@ -26,12 +30,29 @@ namespace firebase {
 namespace firestore {
 namespace bundle {
 
+using nanopb::Message;
+using nanopb::StringReader;
 using nlohmann::json;
 using util::ByteStream;
 using util::StreamReadResult;
 
 namespace {
 
+// Length string of size 16 indicates an element about 1PB, which is impossible
+// for valid bundles.
+constexpr size_t kMaxLengthPrefixSize = 16;
+
+constexpr bool Contains(const char* s, char c) {
+  return *s != '\0' && (*s == c || Contains(s + 1, c));
+}
+
+// The format of a bundle is detected by reading its first length prefix, which
+// is the magic string in full for binary bundles.
+static_assert(sizeof(kBinaryBundleMagic) - 1 == kMaxLengthPrefixSize,
+              "The binary bundle magic must be read as a single length prefix");
+static_assert(!Contains(kBinaryBundleMagic, '{'),
+              "The binary bundle magic must not end the length prefix early");
+
 json Parse(absl::string_view s) {
   return json::parse(s.begin(), s.end(), /*callback=*/nullptr,
                      /*allow_exceptions=*/false);
@@ -68,11 +89,24 @@ std::unique_ptr<BundleElement> BundleReader::GetNextElement() {
 }
 
 std::unique_ptr<BundleElement> BundleReader::ReadNextElement() {
+  if (format_ == Format::Binary) {
+    return ReadNextBinaryElement();
+  }
+
   auto length_prefix = ReadLengthPrefix();
   if (!length_prefix.has_value()) {
     return nullptr;
   }
 
+  if (format_ == Format::Unknown) {
+    // The magic string has no "{", so it is read as the first length prefix.
+    if (length_prefix.value() == kBinaryBundleMagic) {
+      format_ = Format::Binary;
+      return ReadNextBinaryElement();
+    }
+    format_ = Format::Json;
+  }
+
   size_t prefix_value = 0;
   auto ok = absl::SimpleAtoi<size_t>(length_prefix.value(), &prefix_value);
   if (!ok) {
@@ -81,7 +115,7 @@ std::unique_ptr<BundleElement> BundleReader::ReadNextElement() {
   }
 
   buffer_.clear();
-  ReadJsonToBuffer(prefix_value);
+  ReadToBuffer(prefix_value);
   if (!reader_status_.ok()) {
     return nullptr;
   }
@@ -96,10 +130,70 @@ std::unique_ptr<BundleElement> BundleReader::ReadNextElement() {
   return result;
 }
 
+std::unique_ptr<BundleElement> BundleReader::ReadNextBinaryElement() {
+  if (finished_ || !reader_status_.ok()) {
+    return nullptr;
+  }
+
+  size_t prefix_size = 0;
+  absl::optional<uint64_t> element_size = ReadVarint(&prefix_size);
+  if (!element_size.has_value()) {
+    return nullptr;
+  }
+  if (element_size.value() == 0) {
+    finished_ = true;
+    return nullptr;
+  }
+
+  buffer_.clear();
+  ReadToBuffer(static_cast<size_t>(element_size.value()));
+  if (!reader_status_.ok()) {
+    return nullptr;
+  }
+
+  // metadata's size does not count in `bytes_read_`.
+  if (metadata_loaded_) {
+    bytes_read_ += prefix_size + buffer_.size();
+  }
+
+  StringReader reader{buffer_};
+  auto message = Message<firestore_BundleElement>::TryParse(&reader);
+  std::unique_ptr<BundleElement> result;
+  if (reader.ok()) {
+    result = serializer_.DecodeBundleElement(reader.context(), *message);
+  }
+  reader_status_.Update(reader.status());
+
+  return reader_status_.ok() ? std::move(result) : nullptr;
+}
+
+absl::optional<uint64_t> BundleReader::ReadVarint(size_t* size) {
+  uint64_t value = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    StreamReadResult result = input_->Read(1);
+    if (!result.ok()) {
+      reader_status_.Update(result.status());
+      return absl::nullopt;
+    }
+    if (result.ValueOrDie().empty()) {
+      Fail("Bundle ended before its end marker");
+      return absl::nullopt;
+    }
+
+    ++*size;
+    auto byte = static_cast<uint8_t>(result.ValueOrDie()[0]);
+    value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+    if ((byte & 0x80) == 0) {
+      return value;
+    }
+  }
+
+  Fail("Length prefix is not a valid varint");
+  return absl::nullopt;
+}
+
 absl::optional<std::string> BundleReader::ReadLengthPrefix() {
-  // length string of size 16 indicates an element about 1PB, which is
-  // impossible for valid bundles.
-  StreamReadResult result = input_->ReadUntil('{', 16);
+  StreamReadResult result = input_->ReadUntil('{', kMaxLengthPrefixSize);
   if (!result.ok()) {
     reader_status_.Update(result.status());
     return absl::nullopt;
@@ -114,7 +208,7 @@ absl::optional<std::string> BundleReader::ReadLengthPrefix() {
   return absl::make_optional(std::move(result).ValueOrDie());
 }
 
-void BundleReader::ReadJsonToBuffer(size_t required_size) {
+void BundleReader::ReadToBuffer(size_t required_size) {
   if (!reader_status_.ok()) {
     return;
   }
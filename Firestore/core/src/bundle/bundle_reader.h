@@ -31,10 +31,13 @@ namespace firestore {
 namespace bundle {
 
 /**
- * Reads the length-prefixed JSON stream for Bundles.
+ * Reads the length-prefixed stream for Bundles, in either the JSON or the
+ * binary format (see `kBinaryBundleMagic`), which is detected from the start of
+ * the stream.
  *
  * The class takes a bundle stream and presents abstractions to read bundled
- * elements out of the underlying content.
+ * elements out of the underlying content. Binary bundles are read in order,
+ * without using their index.
  */
 class BundleReader {
  public:
@@ -87,6 +90,18 @@ class BundleReader {
    */
   std::unique_ptr<BundleElement> ReadNextElement();
 
+  /**
+   * Reads the next varint-prefixed element of a binary bundle. Returns null
+   * once the end marker has been read.
+   */
+  std::unique_ptr<BundleElement> ReadNextBinaryElement();
+
+  /**
+   * Reads a varint from the stream, adding the number of bytes it took to
+   * `size`. Returns `nullopt` if the stream fails or ends first.
+   */
+  absl::optional<uint64_t> ReadVarint(size_t* size);
+
   /**
    * Reads the length prefix string from bundle stream. Returns `nullopt` when
    * at the end of stream.
@@ -100,7 +115,7 @@ class BundleReader {
   /**
    * Reads `required_size` number of chars from stream into internal `buffer_`.
    */
-  void ReadJsonToBuffer(size_t required_size);
+  void ReadToBuffer(size_t required_size);
 
   /**
    * Decodes internal `buffer_` into a `BundleElement`, returned as a unique_ptr
@@ -110,8 +125,14 @@ class BundleReader {
    */
   std::unique_ptr<BundleElement> DecodeBundleElementFromBuffer();
 
+  enum class Format { Unknown, Json, Binary };
+
   BundleSerializer serializer_;
   JsonReader json_reader_;
+  Format format_ = Format::Unknown;
+
+  // Whether the end marker of a binary bundle has been read.
+  bool finished_ = false;
 
   // Input stream holding bundle data.
   std::unique_ptr<util::ByteStream> input_;
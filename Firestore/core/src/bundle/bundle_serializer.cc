@@ -37,6 +37,7 @@
 #include "Firestore/core/src/util/statusor.h"
 #include "Firestore/core/src/util/string_format.h"
 #include "Firestore/core/src/util/string_util.h"
+#include "absl/memory/memory.h"
 #include "absl/strings/escaping.h"
 #include "absl/strings/numbers.h"
 #include "absl/time/time.h"
@@ -807,6 +808,89 @@ BundleDocument BundleSerializer::DecodeDocument(JsonReader& reader,
       ObjectValue::FromMapValue(std::move(map_value))));
 }
 
+// MARK: - Binary bundles
+
+std::unique_ptr<BundleElement> BundleSerializer::DecodeBundleElement(
+    util::ReadContext* context, firestore_BundleElement& element) const {
+  switch (element.which_element_type) {
+    case firestore_BundleElement_metadata_tag:
+      return absl::make_unique<BundleMetadata>(
+          DecodeBundleMetadata(context, element.metadata));
+    case firestore_BundleElement_named_query_tag:
+      return absl::make_unique<NamedQuery>(
+          DecodeNamedQuery(context, element.named_query));
+    case firestore_BundleElement_document_metadata_tag:
+      return absl::make_unique<BundledDocumentMetadata>(
+          DecodeDocumentMetadata(context, element.document_metadata));
+    case firestore_BundleElement_document_tag:
+      return absl::make_unique<BundleDocument>(
+          DecodeDocument(context, element.document));
+    default:
+      context->Fail(StringFormat("Unrecognized BundleElement type: %s",
+                                 element.which_element_type));
+      return nullptr;
+  }
+}
+
+BundleMetadata BundleSerializer::DecodeBundleMetadata(
+    util::ReadContext* context,
+    const firestore_BundleMetadata& metadata) const {
+  return BundleMetadata(
+      nanopb::MakeString(metadata.id), static_cast<int>(metadata.version),
+      rpc_serializer_.DecodeVersion(context, metadata.create_time),
+      metadata.total_documents, metadata.total_bytes);
+}
+
+NamedQuery BundleSerializer::DecodeNamedQuery(
+    util::ReadContext* context, firestore_NamedQuery& named_query) const {
+  firestore_BundledQuery& query = named_query.bundled_query;
+  // The query_type oneof only has a single valid value.
+  if (query.which_query_type != firestore_BundledQuery_structured_query_tag) {
+    context->Fail(StringFormat("Unknown bundled query_type: %s",
+                               query.which_query_type));
+    return {};
+  }
+
+  LimitType limit_type =
+      query.limit_type == firestore_BundledQuery_LimitType_LAST
+          ? LimitType::Last
+          : LimitType::First;
+  Target target = rpc_serializer_.DecodeStructuredQuery(
+      context, query.parent, query.structured_query);
+
+  return NamedQuery(
+      nanopb::MakeString(named_query.name),
+      BundledQuery(std::move(target), limit_type),
+      rpc_serializer_.DecodeVersion(context, named_query.read_time));
+}
+
+BundledDocumentMetadata BundleSerializer::DecodeDocumentMetadata(
+    util::ReadContext* context,
+    const firestore_BundledDocumentMetadata& document_metadata) const {
+  DocumentKey key = rpc_serializer_.DecodeKey(context, document_metadata.name);
+  SnapshotVersion read_time =
+      rpc_serializer_.DecodeVersion(context, document_metadata.read_time);
+
+  std::vector<std::string> queries;
+  for (pb_size_t i = 0; i < document_metadata.queries_count; ++i) {
+    queries.push_back(nanopb::MakeString(document_metadata.queries[i]));
+  }
+
+  return BundledDocumentMetadata(std::move(key), read_time,
+                                 document_metadata.exists, std::move(queries));
+}
+
+BundleDocument BundleSerializer::DecodeDocument(
+    util::ReadContext* context, google_firestore_v1_Document& document) const {
+  DocumentKey key = rpc_serializer_.DecodeKey(context, document.name);
+  SnapshotVersion update_time =
+      rpc_serializer_.DecodeVersion(context, document.update_time);
+
+  return BundleDocument(MutableDocument::FoundDocument(
+      std::move(key), update_time,
+      ObjectValue::FromFieldsEntry(document.fields, document.fields_count)));
+}
+
 }  // namespace bundle
 }  // namespace firestore
 }  // namespace firebase
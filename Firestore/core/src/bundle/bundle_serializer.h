@@ -17,10 +17,12 @@
 #ifndef FIRESTORE_CORE_SRC_BUNDLE_BUNDLE_SERIALIZER_H_
 #define FIRESTORE_CORE_SRC_BUNDLE_BUNDLE_SERIALIZER_H_
 
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "Firestore/Protos/nanopb/firestore/bundle.nanopb.h"
 #include "Firestore/core/src/bundle/bundle_document.h"
 #include "Firestore/core/src/bundle/bundle_metadata.h"
 #include "Firestore/core/src/bundle/bundled_document_metadata.h"
@@ -88,7 +90,10 @@ class JsonReader : public util::ReadContext {
   double DecodeDouble(const nlohmann::json& value);
 };
 
-/** A JSON serializer to deserialize Firestore Bundles. */
+/**
+ * A serializer to deserialize Firestore Bundles, from either their JSON or
+ * their binary encoding.
+ */
 class BundleSerializer {
  public:
   explicit BundleSerializer(remote::Serializer serializer)
@@ -106,7 +111,27 @@ class BundleSerializer {
   BundleDocument DecodeDocument(JsonReader& reader,
                                 const nlohmann::json& document) const;
 
+  /**
+   * Decodes an element of a binary bundle. Modifies the provided proto to
+   * release ownership of any values moved into the result.
+   *
+   * Fails `context` if the element cannot be decoded.
+   */
+  std::unique_ptr<BundleElement> DecodeBundleElement(
+      util::ReadContext* context, firestore_BundleElement& element) const;
+
  private:
+  BundleMetadata DecodeBundleMetadata(
+      util::ReadContext* context,
+      const firestore_BundleMetadata& metadata) const;
+  NamedQuery DecodeNamedQuery(util::ReadContext* context,
+                              firestore_NamedQuery& named_query) const;
+  BundledDocumentMetadata DecodeDocumentMetadata(
+      util::ReadContext* context,
+      const firestore_BundledDocumentMetadata& document_metadata) const;
+  BundleDocument DecodeDocument(util::ReadContext* context,
+                                google_firestore_v1_Document& document) const;
+
   BundledQuery DecodeBundledQuery(JsonReader& reader,
                                   const nlohmann::json& query) const;
   core::FilterList DecodeWhere(JsonReader& reader,
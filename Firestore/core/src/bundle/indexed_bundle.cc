@@ -0,0 +1,263 @@
+/*
+ * Copyright 2021 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Firestore/core/src/bundle/indexed_bundle.h"
+
+#include <cstdint>
+#include <utility>
+
+#include "Firestore/Protos/nanopb/firestore/bundle.nanopb.h"
+#include "Firestore/core/src/nanopb/message.h"
+#include "Firestore/core/src/nanopb/reader.h"
+#include "Firestore/core/src/util/hard_assert.h"
+#include "Firestore/core/src/util/status.h"
+#include "Firestore/core/src/util/string_format.h"
+#include "absl/strings/match.h"
+
+namespace firebase {
+namespace firestore {
+namespace bundle {
+
+using nanopb::Message;
+using nanopb::StringReader;
+using util::Status;
+using util::StatusOr;
+using util::StringFormat;
+
+namespace {
+
+constexpr size_t kMagicSize = sizeof(kBinaryBundleMagic) - 1;
+constexpr size_t kTrailerSize = sizeof(uint64_t) + kMagicSize;
+
+/**
+ * Reads a varint from `data` at `*offset`, advancing `*offset` past it.
+ * Returns false if `data` ends before the varint does.
+ */
+bool ReadVarint(absl::string_view data, size_t* offset, uint64_t* value) {
+  *value = 0;
+  for (int shift = 0; shift < 64 && *offset < data.size(); shift += 7) {
+    auto byte = static_cast<uint8_t>(data[(*offset)++]);
+    *value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+    if ((byte & 0x80) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Reads an offset from the footer in `data`, which must point into the
+ * elements that end at `elements_end`.
+ */
+bool ReadOffset(absl::string_view data,
+                size_t* position,
+                size_t elements_end,
+                size_t* result) {
+  uint64_t offset = 0;
+  if (!ReadVarint(data, position, &offset) || offset < kMagicSize ||
+      offset >= elements_end) {
+    return false;
+  }
+  *result = static_cast<size_t>(offset);
+  return true;
+}
+
+Status CorruptFooter() {
+  return Status(Error::kErrorDataLoss, "Bundle footer is corrupt");
+}
+
+}  // namespace
+
+IndexedBundle::IndexedBundle(BundleSerializer serializer,
+                             absl::string_view data)
+    : serializer_(std::move(serializer)), data_(data) {
+}
+
+StatusOr<IndexedBundle> IndexedBundle::Open(BundleSerializer serializer,
+                                            absl::string_view data) {
+  absl::string_view magic{kBinaryBundleMagic, kMagicSize};
+  if (data.size() < kMagicSize + kTrailerSize ||
+      !absl::StartsWith(data, magic) || !absl::EndsWith(data, magic)) {
+    return Status(Error::kErrorInvalidArgument, "Not a binary bundle");
+  }
+
+  // Find the footer from the little-endian offset in the trailer.
+  size_t trailer = data.size() - kTrailerSize;
+  uint64_t footer_offset = 0;
+  for (size_t i = 0; i < sizeof(uint64_t); ++i) {
+    auto byte = static_cast<uint8_t>(data[trailer + i]);
+    footer_offset |= static_cast<uint64_t>(byte) << (8 * i);
+  }
+  if (footer_offset <= kMagicSize || footer_offset > trailer) {
+    return CorruptFooter();
+  }
+
+  IndexedBundle bundle{std::move(serializer), data};
+  size_t elements_end = static_cast<size_t>(footer_offset);
+  bundle.elements_ = data.substr(0, elements_end);
+
+  absl::string_view footer = data.substr(0, trailer);
+  size_t position = elements_end;
+
+  uint64_t query_count = 0;
+  if (!ReadVarint(footer, &position, &query_count)) {
+    return CorruptFooter();
+  }
+  for (uint64_t i = 0; i < query_count; ++i) {
+    uint64_t name_size = 0;
+    if (!ReadVarint(footer, &position, &name_size) ||
+        name_size > footer.size() - position) {
+      return CorruptFooter();
+    }
+    std::string name{footer.substr(position, name_size)};
+    position += name_size;
+
+    size_t offset = 0;
+    if (!ReadOffset(footer, &position, elements_end, &offset)) {
+      return CorruptFooter();
+    }
+    bundle.named_query_offsets_[std::move(name)] = offset;
+  }
+
+  uint64_t document_count = 0;
+  // Every offset takes at least one byte, which bounds the reservation below.
+  if (!ReadVarint(footer, &position, &document_count) ||
+      document_count > footer.size() - position) {
+    return CorruptFooter();
+  }
+  bundle.document_offsets_.reserve(document_count);
+  for (uint64_t i = 0; i < document_count; ++i) {
+    size_t offset = 0;
+    if (!ReadOffset(footer, &position, elements_end, &offset)) {
+      return CorruptFooter();
+    }
+    bundle.document_offsets_.push_back(offset);
+  }
+
+  if (position != footer.size()) {
+    return CorruptFooter();
+  }
+
+  return bundle;
+}
+
+StatusOr<BundleMetadata> IndexedBundle::GetBundleMetadata() const {
+  StatusOr<std::unique_ptr<BundleElement>> element =
+      DecodeElement(kMagicSize, BundleElement::Type::Metadata, nullptr);
+  if (!element.ok()) {
+    return element.status();
+  }
+  return static_cast<BundleMetadata&>(*element.ValueOrDie());
+}
+
+StatusOr<NamedQuery> IndexedBundle::GetNamedQuery(
+    const std::string& name) const {
+  auto found = named_query_offsets_.find(name);
+  if (found == named_query_offsets_.end()) {
+    return Status(Error::kErrorNotFound,
+                  StringFormat("Bundle has no named query '%s'", name));
+  }
+
+  StatusOr<std::unique_ptr<BundleElement>> element =
+      DecodeElement(found->second, BundleElement::Type::NamedQuery, nullptr);
+  if (!element.ok()) {
+    return element.status();
+  }
+  return std::move(static_cast<NamedQuery&>(*element.ValueOrDie()));
+}
+
+StatusOr<BundledDocumentMetadata> IndexedBundle::GetDocumentMetadata(
+    size_t index) const {
+  HARD_ASSERT(index < document_offsets_.size(),
+              "Document index %s out of range", index);
+
+  StatusOr<std::unique_ptr<BundleElement>> element =
+      DecodeElement(document_offsets_[index],
+                    BundleElement::Type::DocumentMetadata, nullptr);
+  if (!element.ok()) {
+    return element.status();
+  }
+  return std::move(
+      static_cast<BundledDocumentMetadata&>(*element.ValueOrDie()));
+}
+
+StatusOr<BundleDocument> IndexedBundle::GetDocument(size_t index) const {
+  HARD_ASSERT(index < document_offsets_.size(),
+              "Document index %s out of range", index);
+
+  size_t document_offset = 0;
+  StatusOr<std::unique_ptr<BundleElement>> metadata =
+      DecodeElement(document_offsets_[index],
+                    BundleElement::Type::DocumentMetadata, &document_offset);
+  if (!metadata.ok()) {
+    return metadata.status();
+  }
+  const auto& document_metadata =
+      static_cast<const BundledDocumentMetadata&>(*metadata.ValueOrDie());
+  if (!document_metadata.exists()) {
+    return Status(Error::kErrorNotFound,
+                  StringFormat("Document %s was deleted",
+                               document_metadata.key().ToString()));
+  }
+
+  StatusOr<std::unique_ptr<BundleElement>> element =
+      DecodeElement(document_offset, BundleElement::Type::Document, nullptr);
+  if (!element.ok()) {
+    return element.status();
+  }
+  auto& document = static_cast<BundleDocument&>(*element.ValueOrDie());
+  if (document.key() != document_metadata.key()) {
+    return Status(Error::kErrorDataLoss,
+                  StringFormat("Bundle has document %s where document %s "
+                               "was expected",
+                               document.key().ToString(),
+                               document_metadata.key().ToString()));
+  }
+  return std::move(document);
+}
+
+StatusOr<std::unique_ptr<BundleElement>> IndexedBundle::DecodeElement(
+    size_t offset, BundleElement::Type expected, size_t* next_offset) const {
+  uint64_t size = 0;
+  if (!ReadVarint(elements_, &offset, &size) || size == 0 ||
+      size > elements_.size() - offset) {
+    return Status(Error::kErrorDataLoss,
+                  "Bundle element extends past the end of the bundle");
+  }
+
+  StringReader reader{elements_.substr(offset, static_cast<size_t>(size))};
+  auto message = Message<firestore_BundleElement>::TryParse(&reader);
+  std::unique_ptr<BundleElement> element;
+  if (reader.ok()) {
+    element = serializer_.DecodeBundleElement(reader.context(), *message);
+  }
+  if (!reader.ok()) {
+    return reader.status();
+  }
+
+  if (element->element_type() != expected) {
+    return Status(Error::kErrorDataLoss,
+                  "Bundle index points to an element of the wrong type");
+  }
+  if (next_offset) {
+    *next_offset = offset + static_cast<size_t>(size);
+  }
+  return {std::move(element)};
+}
+
+}  // namespace bundle
+}  // namespace firestore
+}  // namespace firebase
@@ -0,0 +1,125 @@
+/*
+ * Copyright 2021 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FIRESTORE_CORE_SRC_BUNDLE_INDEXED_BUNDLE_H_
+#define FIRESTORE_CORE_SRC_BUNDLE_INDEXED_BUNDLE_H_
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Firestore/core/src/bundle/bundle_document.h"
+#include "Firestore/core/src/bundle/bundle_element.h"
+#include "Firestore/core/src/bundle/bundle_metadata.h"
+#include "Firestore/core/src/bundle/bundle_serializer.h"
+#include "Firestore/core/src/bundle/bundled_document_metadata.h"
+#include "Firestore/core/src/bundle/named_query.h"
+#include "Firestore/core/src/util/statusor.h"
+#include "absl/strings/string_view.h"
+
+namespace firebase {
+namespace firestore {
+namespace bundle {
+
+/**
+ * The string that binary bundles start and end with. JSON bundles start with a
+ * decimal length prefix instead, which tells the two apart.
+ *
+ * A binary bundle holds the same elements as a JSON bundle, each encoded as a
+ * `BundleElement` proto, followed by an index of where they are:
+ *
+ *   bundle  := magic element* end footer trailer
+ *   element := varint length, serialized BundleElement
+ *   end     := varint 0
+ *   footer  := varint count, (varint name length, name, varint offset)*,
+ *              varint count, (varint offset)*
+ *   trailer := offset of footer (little-endian fixed64), magic
+ *
+ * The first element is the bundle metadata, whose `total_bytes` counts the
+ * elements after it, including their length prefixes. The footer lists the
+ * offset of every named query element by name, then the offset of every
+ * document metadata element; the document element, if the document exists,
+ * directly follows its metadata.
+ */
+constexpr char kBinaryBundleMagic[] = "firestore-bundle";
+
+/**
+ * Provides random access to the elements of a binary bundle that is held in
+ * memory, such as a mapped file, using the index in its footer.
+ *
+ * Elements are decoded on demand, so reading the metadata or a named query
+ * doesn't touch the documents. All methods are const and may be called
+ * concurrently, which allows decoding documents in parallel.
+ */
+class IndexedBundle {
+ public:
+  /**
+   * Reads the footer of the binary bundle in `data`. The returned instance
+   * refers to `data`, which must outlive it.
+   */
+  static util::StatusOr<IndexedBundle> Open(BundleSerializer serializer,
+                                            absl::string_view data);
+
+  util::StatusOr<BundleMetadata> GetBundleMetadata() const;
+
+  /**
+   * Returns the named query with the given name, or a `NotFound` error if the
+   * bundle doesn't contain one.
+   */
+  util::StatusOr<NamedQuery> GetNamedQuery(const std::string& name) const;
+
+  /** Returns the number of documents, including deleted ones. */
+  size_t document_count() const {
+    return document_offsets_.size();
+  }
+
+  /** Returns the metadata of the document at `index`. */
+  util::StatusOr<BundledDocumentMetadata> GetDocumentMetadata(
+      size_t index) const;
+
+  /**
+   * Returns the document at `index`, or a `NotFound` error if the bundle only
+   * records that it was deleted.
+   */
+  util::StatusOr<BundleDocument> GetDocument(size_t index) const;
+
+ private:
+  IndexedBundle(BundleSerializer serializer, absl::string_view data);
+
+  /**
+   * Decodes the element at `offset`, which must be of the `expected` type, and
+   * sets `next_offset` (if not null) to the offset of the element after it.
+   */
+  util::StatusOr<std::unique_ptr<BundleElement>> DecodeElement(
+      size_t offset, BundleElement::Type expected, size_t* next_offset) const;
+
+  BundleSerializer serializer_;
+
+  // The whole bundle, and the part of it that holds the elements.
+  absl::string_view data_;
+  absl::string_view elements_;
+
+  std::map<std::string, size_t> named_query_offsets_;
+  std::vector<size_t> document_offsets_;
+};
+
+}  // namespace bundle
+}  // namespace firestore
+}  // namespace firebase
+
+#endif  // FIRESTORE_CORE_SRC_BUNDLE_INDEXED_BUNDLE_H_
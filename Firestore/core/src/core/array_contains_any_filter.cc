@@ -20,6 +20,7 @@
 #include <utility>
 
 #include "Firestore/core/src/model/document.h"
+#include "Firestore/core/src/model/value_set.h"
 #include "Firestore/core/src/model/value_util.h"
 #include "Firestore/core/src/util/hard_assert.h"
 #include "absl/algorithm/container.h"
@@ -28,10 +29,10 @@ namespace firebase {
 namespace firestore {
 namespace core {
 
-using model::Contains;
 using model::Document;
 using model::FieldPath;
 using model::IsArray;
+using model::ValueSet;
 using nanopb::SharedMessage;
 
 using Operator = Filter::Operator;
@@ -43,6 +44,7 @@ class ArrayContainsAnyFilter::Rep : public FieldFilter::Rep {
             std::move(field), Operator::ArrayContainsAny, std::move(value)) {
     HARD_ASSERT(IsArray(this->value()),
                 "ArrayContainsAnyFilter expects an ArrayValue");
+    values_ = ValueSet(this->value().array_value);
   }
 
   Type type() const override {
@@ -50,6 +52,10 @@ class ArrayContainsAnyFilter::Rep : public FieldFilter::Rep {
   }
 
   bool Matches(const model::Document& doc) const override;
+
+ private:
+  /** The elements of the filter's value. */
+  ValueSet values_;
 };
 
 ArrayContainsAnyFilter::ArrayContainsAnyFilter(
@@ -59,7 +65,6 @@ ArrayContainsAnyFilter::ArrayContainsAnyFilter(
 }
 
 bool ArrayContainsAnyFilter::Rep::Matches(const Document& doc) const {
-  const google_firestore_v1_ArrayValue& array_value = value().array_value;
   absl::optional<google_firestore_v1_Value> maybe_lhs = doc->field(field());
   if (!maybe_lhs) return false;
 
@@ -67,7 +72,7 @@ bool ArrayContainsAnyFilter::Rep::Matches(const Document& doc) const {
   if (!IsArray(lhs)) return false;
 
   for (pb_size_t i = 0; i < lhs.array_value.values_count; ++i) {
-    if (Contains(array_value, lhs.array_value.values[i])) {
+    if (values_.Contains(lhs.array_value.values[i])) {
       return true;
     }
   }
@@ -0,0 +1,247 @@
+/*
+ * Copyright 2021 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Firestore/core/src/core/bulk_writer.h"
+
+#include <algorithm>
+#include <chrono>  // NOLINT(build/c++11)
+#include <iterator>
+
+#include "Firestore/core/src/remote/datastore.h"
+#include "Firestore/core/src/util/hard_assert.h"
+#include "Firestore/core/src/util/log.h"
+#include "Firestore/core/src/util/status.h"
+#include "absl/memory/memory.h"
+
+namespace firebase {
+namespace firestore {
+namespace core {
+
+namespace {
+
+using model::Mutation;
+using remote::Datastore;
+using util::AsyncQueue;
+using util::Status;
+using util::StatusCallback;
+using util::TimerId;
+
+/** Maximum number of times a batch can be attempted before failing. */
+constexpr int kMaxAttemptsCount = 10;
+
+/** The rate limiter grows its rate by this factor every interval. */
+constexpr double kRateMultiplier = 1.5;
+constexpr std::chrono::minutes kRateMultiplierInterval{5};
+
+}  // namespace
+
+BulkWriter::Batch::Batch(const std::shared_ptr<AsyncQueue>& worker_queue,
+                         std::vector<Operation> operations)
+    : operations{std::move(operations)},
+      backoff{worker_queue, TimerId::RetryBulkWrite} {
+}
+
+BulkWriter::BulkWriter(const std::shared_ptr<AsyncQueue>& worker_queue,
+                       CommitFunction commit,
+                       BulkWriterOptions options)
+    : worker_queue_{NOT_NULL(worker_queue)},
+      commit_{std::move(commit)},
+      options_{options} {
+  HARD_ASSERT(options_.max_batch_size > 0, "Batch size must be positive");
+  HARD_ASSERT(options_.max_concurrent_batches > 0,
+              "Concurrent batches must be positive");
+
+  if (options_.rate_limiting_enabled) {
+    rate_limiter_ = absl::make_unique<RateLimiter>(
+        options_.initial_writes_per_second, kRateMultiplier,
+        kRateMultiplierInterval, options_.max_writes_per_second,
+        RateLimiter::Clock::now());
+  }
+}
+
+void BulkWriter::Write(Mutation mutation, StatusCallback callback) {
+  worker_queue_->VerifyIsCurrentQueue();
+
+  uint64_t id = next_id_++;
+  unresolved_.insert(id);
+  pending_.push_back(Operation{id, std::move(mutation), std::move(callback)});
+  SendBatches();
+}
+
+void BulkWriter::Flush(StatusCallback callback) {
+  worker_queue_->VerifyIsCurrentQueue();
+
+  flushes_.push_back(PendingFlush{next_id_, std::move(callback)});
+  SendBatches();
+  NotifyFlushes();
+}
+
+void BulkWriter::SendBatches() {
+  while (batches_in_flight_ < options_.max_concurrent_batches) {
+    std::shared_ptr<Batch> batch = PeekNextBatch();
+    if (!batch) {
+      return;
+    }
+
+    if (rate_limiter_) {
+      int count = static_cast<int>(batch->operations.size());
+      auto now = RateLimiter::Clock::now();
+      if (!rate_limiter_->TryAcquire(count, now)) {
+        if (!send_scheduled_) {
+          send_scheduled_ = true;
+          auto shared_this = shared_from_this();
+          worker_queue_->EnqueueAfterDelay(
+              rate_limiter_->GetDelay(count, now), TimerId::BulkWriterRateLimit,
+              [shared_this] {
+                shared_this->send_scheduled_ = false;
+                shared_this->SendBatches();
+              });
+        }
+        return;
+      }
+    }
+
+    TakeNextBatch(batch);
+    Send(batch);
+  }
+}
+
+std::shared_ptr<BulkWriter::Batch> BulkWriter::PeekNextBatch() {
+  // Retries go first, since their writes have been waiting the longest.
+  if (!ready_.empty()) {
+    return ready_.front();
+  }
+  if (pending_.empty()) {
+    return nullptr;
+  }
+
+  // A partial batch is only sent once a flush is waiting for its writes.
+  size_t batch_size = static_cast<size_t>(options_.max_batch_size);
+  bool flushing = !flushes_.empty() &&
+                  pending_.front().id < flushes_.back().end_id;
+  if (pending_.size() < batch_size && !flushing) {
+    return nullptr;
+  }
+
+  size_t count = std::min(pending_.size(), batch_size);
+  std::vector<Operation> operations(
+      std::make_move_iterator(pending_.begin()),
+      std::make_move_iterator(pending_.begin() + count));
+  pending_.erase(pending_.begin(), pending_.begin() + count);
+  ready_.push_back(
+      std::make_shared<Batch>(worker_queue_, std::move(operations)));
+  return ready_.front();
+}
+
+void BulkWriter::TakeNextBatch(const std::shared_ptr<Batch>& batch) {
+  HARD_ASSERT(!ready_.empty() && ready_.front() == batch,
+              "Can only take the batch that was peeked");
+  ready_.pop_front();
+}
+
+void BulkWriter::Send(const std::shared_ptr<Batch>& batch) {
+  ++batches_in_flight_;
+  ++batch->attempts;
+
+  std::vector<Mutation> mutations;
+  mutations.reserve(batch->operations.size());
+  for (const Operation& operation : batch->operations) {
+    mutations.push_back(operation.mutation);
+  }
+
+  auto shared_this = shared_from_this();
+  commit_(mutations, [shared_this, batch](const Status& status) {
+    shared_this->OnCommitted(batch, status);
+  });
+}
+
+void BulkWriter::OnCommitted(const std::shared_ptr<Batch>& batch,
+                             const Status& status) {
+  worker_queue_->VerifyIsCurrentQueue();
+  --batches_in_flight_;
+
+  bool permanent = !status.ok() && Datastore::IsPermanentWriteError(status);
+  if (status.ok()) {
+    Resolve(batch, status);
+
+  } else if (!permanent && batch->attempts < kMaxAttemptsCount) {
+    if (status.code() == Error::kErrorResourceExhausted) {
+      LOG_DEBUG("BulkWriter using maximum backoff delay to prevent "
+                "overloading the backend.");
+      batch->backoff.ResetToMax();
+    }
+    auto shared_this = shared_from_this();
+    batch->backoff.BackoffAndRun([shared_this, batch] {
+      shared_this->ready_.push_front(batch);
+      shared_this->SendBatches();
+    });
+
+  } else if (permanent && batch->operations.size() > 1) {
+    Split(batch);
+
+  } else {
+    LOG_DEBUG("BulkWriter batch of %s writes failed after %s attempts: %s",
+              batch->operations.size(), batch->attempts, status.ToString());
+    Resolve(batch, status);
+  }
+
+  SendBatches();
+  NotifyFlushes();
+}
+
+void BulkWriter::Split(const std::shared_ptr<Batch>& batch) {
+  LOG_DEBUG("BulkWriter retrying a failed batch of %s writes one at a time",
+            batch->operations.size());
+
+  // Push in reverse so that the writes are retried in their original order.
+  for (auto it = batch->operations.rbegin(); it != batch->operations.rend();
+       ++it) {
+    std::vector<Operation> operations;
+    operations.push_back(std::move(*it));
+    ready_.push_front(
+        std::make_shared<Batch>(worker_queue_, std::move(operations)));
+  }
+}
+
+void BulkWriter::Resolve(const std::shared_ptr<Batch>& batch,
+                         const Status& status) {
+  for (Operation& operation : batch->operations) {
+    unresolved_.erase(operation.id);
+    if (operation.callback) {
+      operation.callback(status);
+    }
+  }
+}
+
+void BulkWriter::NotifyFlushes() {
+  // Flushes are added in order of their end IDs, so they finish in order too.
+  while (!flushes_.empty()) {
+    const PendingFlush& flush = flushes_.front();
+    if (!unresolved_.empty() && *unresolved_.begin() < flush.end_id) {
+      return;
+    }
+
+    StatusCallback callback = std::move(flushes_.front().callback);
+    flushes_.pop_front();
+    if (callback) {
+      callback(Status::OK());
+    }
+  }
+}
+
+}  // namespace core
+}  // namespace firestore
+}  // namespace firebase
@@ -0,0 +1,171 @@
+/*
+ * Copyright 2021 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FIRESTORE_CORE_SRC_CORE_BULK_WRITER_H_
+#define FIRESTORE_CORE_SRC_CORE_BULK_WRITER_H_
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "Firestore/core/src/core/rate_limiter.h"
+#include "Firestore/core/src/model/mutation.h"
+#include "Firestore/core/src/remote/exponential_backoff.h"
+#include "Firestore/core/src/util/async_queue.h"
+#include "Firestore/core/src/util/status_fwd.h"
+
+namespace firebase {
+namespace firestore {
+namespace core {
+
+/** Configures how a `BulkWriter` batches and paces its writes. */
+struct BulkWriterOptions {
+  /** The maximum number of writes sent in a single commit. */
+  int max_batch_size = 20;
+
+  /** The maximum number of commits that may be in flight at once. */
+  int max_concurrent_batches = 10;
+
+  /**
+   * Whether writes are paced by a rate limiter. The limiter starts at
+   * `initial_writes_per_second` and grows by half every five minutes, up to
+   * `max_writes_per_second`.
+   */
+  bool rate_limiting_enabled = true;
+  double initial_writes_per_second = 500;
+  double max_writes_per_second = 10000;
+};
+
+/**
+ * Commits a stream of independent writes directly to the backend, bypassing
+ * the local cache and the write pipeline of `RemoteStore`.
+ *
+ * Writes are grouped into batches of up to `max_batch_size`, and each batch is
+ * sent in its own commit. Up to `max_concurrent_batches` commits are in flight
+ * at once, and commits are paced by a rate limiter that ramps up over time.
+ * A batch is sent once it is full, or once `Flush` asks for the writes made so
+ * far.
+ *
+ * Each write is reported to its own callback. A commit that fails with a
+ * retryable error is retried with backoff. A commit is atomic, so when it fails
+ * with a permanent error the server doesn't say which write caused it; the
+ * writes of such a batch are then retried one per commit, so that only the
+ * writes that fail on their own are reported as failed.
+ *
+ * Writes in different batches are not ordered with respect to each other.
+ *
+ * All methods must be called on the worker queue, and callbacks are invoked on
+ * it.
+ */
+class BulkWriter : public std::enable_shared_from_this<BulkWriter> {
+ public:
+  using CommitCallback = std::function<void(const util::Status&)>;
+
+  /**
+   * Commits the given mutations, and invokes the callback on the worker queue
+   * with the result.
+   */
+  using CommitFunction = std::function<void(
+      const std::vector<model::Mutation>& mutations, CommitCallback&&)>;
+
+  BulkWriter(const std::shared_ptr<util::AsyncQueue>& worker_queue,
+             CommitFunction commit,
+             BulkWriterOptions options);
+
+  /**
+   * Adds the given mutation, and invokes the callback once it's committed or
+   * has permanently failed.
+   */
+  void Write(model::Mutation mutation, util::StatusCallback callback);
+
+  /**
+   * Sends all writes made so far, including partial batches, and invokes the
+   * callback once all of them have been committed or have failed.
+   */
+  void Flush(util::StatusCallback callback);
+
+  /** The number of writes that were added but have not been resolved yet. */
+  size_t pending_writes() const {
+    return unresolved_.size();
+  }
+
+ private:
+  struct Operation {
+    uint64_t id;
+    model::Mutation mutation;
+    util::StatusCallback callback;
+  };
+
+  struct Batch {
+    Batch(const std::shared_ptr<util::AsyncQueue>& worker_queue,
+          std::vector<Operation> operations);
+
+    std::vector<Operation> operations;
+    remote::ExponentialBackoff backoff;
+    int attempts = 0;
+  };
+
+  struct PendingFlush {
+    /** The flush is done once all writes with lower IDs are resolved. */
+    uint64_t end_id;
+    util::StatusCallback callback;
+  };
+
+  /** Sends as many batches as the concurrency and rate limits allow. */
+  void SendBatches();
+
+  /** Returns the next batch to send, or null if nothing should be sent yet. */
+  std::shared_ptr<Batch> PeekNextBatch();
+  void TakeNextBatch(const std::shared_ptr<Batch>& batch);
+
+  void Send(const std::shared_ptr<Batch>& batch);
+  void OnCommitted(const std::shared_ptr<Batch>& batch,
+                   const util::Status& status);
+
+  /** Retries each operation of the batch in a commit of its own. */
+  void Split(const std::shared_ptr<Batch>& batch);
+  void Resolve(const std::shared_ptr<Batch>& batch,
+               const util::Status& status);
+  void NotifyFlushes();
+
+  std::shared_ptr<util::AsyncQueue> worker_queue_;
+  CommitFunction commit_;
+  BulkWriterOptions options_;
+  std::unique_ptr<RateLimiter> rate_limiter_;
+
+  /** Writes that haven't been put in a batch yet. */
+  std::vector<Operation> pending_;
+
+  /** Batches that are ready to be sent again, in the order to send them. */
+  std::deque<std::shared_ptr<Batch>> ready_;
+
+  int batches_in_flight_ = 0;
+  bool send_scheduled_ = false;
+
+  uint64_t next_id_ = 0;
+  std::set<uint64_t> unresolved_;
+  std::deque<PendingFlush> flushes_;
+};
+
+}  // namespace core
+}  // namespace firestore
+}  // namespace firebase
+
+#endif  // FIRESTORE_CORE_SRC_CORE_BULK_WRITER_H_
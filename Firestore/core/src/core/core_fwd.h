@@ -40,6 +40,8 @@ using StatusCallback = std::function<void(Status)>;
 namespace core {
 
 class Bound;
+class BulkWriter;
+struct BulkWriterOptions;
 class DatabaseInfo;
 class Direction;
 class EventManager;
@@ -25,11 +25,13 @@ namespace core {
 DatabaseInfo::DatabaseInfo(model::DatabaseId database_id,
                            std::string persistence_key,
                            std::string host,
-                           bool ssl_enabled)
+                           bool ssl_enabled,
+                           remote::GrpcOptions grpc_options)
     : database_id_{std::move(database_id)},
       persistence_key_{std::move(persistence_key)},
       host_{std::move(host)},
-      ssl_enabled_{ssl_enabled} {
+      ssl_enabled_{ssl_enabled},
+      grpc_options_{grpc_options} {
 }
 
 }  // namespace core
@@ -20,6 +20,7 @@
 #include <string>
 
 #include "Firestore/core/src/model/database_id.h"
+#include "Firestore/core/src/remote/grpc_options.h"
 
 namespace firebase {
 namespace firestore {
@@ -36,11 +37,13 @@ class DatabaseInfo {
    *        storage. Usually derived from -[FIRApp appName].
    * @param host The hostname of the Firestore backend.
    * @param ssl_enabled Whether to use SSL when connecting.
+   * @param grpc_options Tuning for the gRPC channel and calls.
    */
   DatabaseInfo(model::DatabaseId database_id,
                std::string persistence_key,
                std::string host,
-               bool ssl_enabled);
+               bool ssl_enabled,
+               remote::GrpcOptions grpc_options = {});
 
   DatabaseInfo() = default;
 
@@ -60,11 +63,16 @@ class DatabaseInfo {
     return ssl_enabled_;
   }
 
+  const remote::GrpcOptions& grpc_options() const {
+    return grpc_options_;
+  }
+
  private:
   model::DatabaseId database_id_;
   std::string persistence_key_;
   std::string host_;
   bool ssl_enabled_ = false;
+  remote::GrpcOptions grpc_options_;
 };
 
 }  // namespace core
@@ -16,46 +16,60 @@
 
 #include "Firestore/core/src/core/firestore_client.h"
 
+#include <algorithm>
 #include <functional>
 #include <future>  // NOLINT(build/c++11)
 #include <memory>
+#include <mutex>  // NOLINT(build/c++11)
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "Firestore/core/src/api/document_reference.h"
 #include "Firestore/core/src/api/document_snapshot.h"
 #include "Firestore/core/src/api/query_core.h"
 #include "Firestore/core/src/api/query_snapshot.h"
 #include "Firestore/core/src/api/settings.h"
+#include "Firestore/core/src/api/source.h"
 #include "Firestore/core/src/bundle/bundle_reader.h"
+#include "Firestore/core/src/core/bound.h"
+#include "Firestore/core/src/core/bulk_writer.h"
 #include "Firestore/core/src/core/database_info.h"
 #include "Firestore/core/src/core/event_manager.h"
 #include "Firestore/core/src/core/query_listener.h"
 #include "Firestore/core/src/core/sync_engine.h"
 #include "Firestore/core/src/core/view.h"
 #include "Firestore/core/src/credentials/credentials_provider.h"
+#include "Firestore/core/src/local/garbage_collection_scheduler.h"
 #include "Firestore/core/src/local/leveldb_opener.h"
 #include "Firestore/core/src/local/leveldb_persistence.h"
 #include "Firestore/core/src/local/local_documents_view.h"
+#include "Firestore/core/src/local/local_reader.h"
 #include "Firestore/core/src/local/local_serializer.h"
 #include "Firestore/core/src/local/local_store.h"
+#include "Firestore/core/src/local/lru_garbage_collector.h"
 #include "Firestore/core/src/local/memory_persistence.h"
 #include "Firestore/core/src/local/query_engine.h"
+#include "Firestore/core/src/local/query_profile.h"
 #include "Firestore/core/src/local/query_result.h"
+#include "Firestore/core/src/local/startup_timings.h"
 #include "Firestore/core/src/model/database_id.h"
 #include "Firestore/core/src/model/document.h"
 #include "Firestore/core/src/model/document_set.h"
 #include "Firestore/core/src/model/mutation.h"
+#include "Firestore/core/src/model/value_util.h"
 #include "Firestore/core/src/remote/connectivity_monitor.h"
 #include "Firestore/core/src/remote/datastore.h"
 #include "Firestore/core/src/remote/firebase_metadata_provider.h"
 #include "Firestore/core/src/remote/remote_store.h"
 #include "Firestore/core/src/remote/serializer.h"
 #include "Firestore/core/src/util/async_queue.h"
+#include "Firestore/core/src/util/comparison.h"
 #include "Firestore/core/src/util/delayed_constructor.h"
 #include "Firestore/core/src/util/exception.h"
 #include "Firestore/core/src/util/hard_assert.h"
 #include "Firestore/core/src/util/log.h"
+#include "Firestore/core/src/util/path.h"
 #include "Firestore/core/src/util/status.h"
 #include "Firestore/core/src/util/statusor.h"
 #include "Firestore/core/src/util/string_apple.h"
@@ -68,6 +82,7 @@ namespace core {
 using api::DocumentReference;
 using api::DocumentSnapshot;
 using api::DocumentSnapshotListener;
+using api::DocumentSnapshotsListener;
 using api::QuerySnapshot;
 using api::QuerySnapshotListener;
 using api::Settings;
@@ -75,15 +90,24 @@ using api::SnapshotMetadata;
 using credentials::AuthCredentialsProvider;
 using credentials::User;
 using firestore::Error;
+using local::DocumentPage;
+using local::GarbageCollectionScheduler;
 using local::LevelDbOpener;
+using local::LocalDocumentsView;
+using local::LocalReader;
 using local::LocalStore;
 using local::LruParams;
+using local::LruResults;
 using local::MemoryPersistence;
 using local::QueryEngine;
+using local::QueryProfile;
 using local::QueryResult;
+using local::StartupTimings;
 using model::Document;
+using model::DocumentKey;
 using model::DocumentKeySet;
 using model::DocumentMap;
+using model::DocumentSet;
 using model::Mutation;
 using model::OnlineState;
 using remote::ConnectivityMonitor;
@@ -103,6 +127,116 @@ using util::TimerId;
 
 static const size_t kMaxConcurrentLimboResolutions = 100;
 
+namespace {
+
+// Cache-only reads that run concurrently with the worker queue. They mostly
+// wait on the disk, so a few threads suffice.
+const int kReaderThreads = 2;
+
+/** Computes the snapshot of a query from its results in the local store. */
+ViewSnapshot ToViewSnapshot(const Query& query,
+                            const QueryResult& query_result) {
+  View view(query, query_result.remote_keys());
+  ViewDocumentChanges view_doc_changes =
+      view.ComputeDocumentChanges(query_result.documents());
+  ViewChange view_change = view.ApplyChanges(view_doc_changes);
+  HARD_ASSERT(
+      view_change.limbo_changes().empty(),
+      "View returned limbo documents during local-only query execution.");
+
+  HARD_ASSERT(view_change.snapshot().has_value(), "Expected a snapshot");
+  return std::move(view_change.snapshot()).value();
+}
+
+/**
+ * Converts the local views in `documents` into a snapshot for each of `docs`,
+ * in order. Fails if it isn't known whether one of the documents exists.
+ */
+StatusOr<std::vector<DocumentSnapshot>> ToDocumentSnapshots(
+    const std::vector<DocumentReference>& docs,
+    const DocumentMap& documents,
+    bool from_cache) {
+  std::vector<DocumentSnapshot> snapshots;
+  snapshots.reserve(docs.size());
+
+  for (const DocumentReference& doc : docs) {
+    absl::optional<Document> document = documents.get(doc.key());
+    if (document && (*document)->is_found_document()) {
+      snapshots.push_back(DocumentSnapshot::FromDocument(
+          doc.firestore(), *document,
+          SnapshotMetadata{(*document)->has_local_mutations(), from_cache}));
+    } else if (document && (*document)->is_no_document()) {
+      snapshots.push_back(DocumentSnapshot::FromNoDocument(
+          doc.firestore(), doc.key(),
+          SnapshotMetadata{/*pending_writes=*/false, from_cache}));
+    } else if (from_cache) {
+      return Status{
+          Error::kErrorUnavailable,
+          "Failed to get documents from cache. (However, these documents may "
+          "exist on the server. Run again without setting source to "
+          "FirestoreSourceCache to attempt to retrieve the documents from the "
+          "server.)"};
+    } else {
+      return Status{Error::kErrorInternal,
+                    "The server did not return document " +
+                        doc.key().ToString()};
+    }
+  }
+
+  StatusOr<std::vector<DocumentSnapshot>> result{std::move(snapshots)};
+  return result;
+}
+
+/** Orders partition points by their position in query order. */
+bool PartitionPointLess(const Bound& lhs, const Bound& rhs) {
+  const google_firestore_v1_ArrayValue& left = *lhs.position();
+  const google_firestore_v1_ArrayValue& right = *rhs.position();
+  pb_size_t size = std::min(left.values_count, right.values_count);
+  for (pb_size_t i = 0; i < size; ++i) {
+    util::ComparisonResult result =
+        model::Compare(left.values[i], right.values[i]);
+    if (!util::Same(result)) {
+      return util::Ascending(result);
+    }
+  }
+  return left.values_count < right.values_count;
+}
+
+/**
+ * Splits `query` at the given partition points. Each partition starts at a
+ * point and ends before the next one; the first and last partitions are open
+ * ended. Pages of points from the backend aren't ordered with respect to each
+ * other, so the points are sorted first.
+ */
+std::vector<api::Query> SplitQuery(const api::Query& query,
+                                   std::vector<Bound> points) {
+  std::sort(points.begin(), points.end(), PartitionPointLess);
+  points.erase(std::unique(points.begin(), points.end(),
+                           [](const Bound& lhs, const Bound& rhs) {
+                             return !PartitionPointLess(lhs, rhs) &&
+                                    !PartitionPointLess(rhs, lhs);
+                           }),
+               points.end());
+
+  std::vector<api::Query> partitions;
+  partitions.reserve(points.size() + 1);
+  for (size_t i = 0; i <= points.size(); ++i) {
+    api::Query partition = query;
+    if (i > 0) {
+      partition = partition.StartAt(
+          Bound::FromValue(points[i - 1].position(), /*is_before=*/true));
+    }
+    if (i < points.size()) {
+      partition = partition.EndAt(
+          Bound::FromValue(points[i].position(), /*is_before=*/true));
+    }
+    partitions.push_back(std::move(partition));
+  }
+  return partitions;
+}
+
+}  // namespace
+
 std::shared_ptr<FirestoreClient> FirestoreClient::Create(
     const DatabaseInfo& database_info,
     const api::Settings& settings,
@@ -140,6 +274,7 @@ std::shared_ptr<FirestoreClient> FirestoreClient::Create(
 
         LOG_DEBUG("Credential Changed. Current user: %s", user.uid());
         shared_client->sync_engine_->HandleCredentialChange(user);
+        shared_client->UpdateLocalReader(user);
       });
     }
   };
@@ -181,6 +316,7 @@ void FirestoreClient::Initialize(const User& user, const Settings& settings) {
   // Do all of our initialization on our own dispatch queue.
   worker_queue_->VerifyIsCurrentQueue();
   LOG_DEBUG("Initializing. Current user: %s", user.uid());
+  StartupTimings timings;
 
   // Note: The initialization work must all be synchronous (we can't dispatch
   // more work) since external write/listen operations could get queued to run
@@ -199,13 +335,18 @@ void FirestoreClient::Initialize(const User& user, const Settings& settings) {
 
     auto ldb = std::move(created).ValueOrDie();
     lru_delegate_ = ldb->reference_delegate();
+    leveldb_persistence_ = ldb.get();
+    timings.Append("persistence ", ldb->startup_timings());
 
     persistence_ = std::move(ldb);
     if (settings.gc_enabled()) {
+      gc_scheduler_ = absl::make_unique<GarbageCollectionScheduler>(
+          settings.cache_size_bytes());
       ScheduleLruGarbageCollection();
     }
   } else {
     persistence_ = MemoryPersistence::WithEagerGarbageCollector();
+    timings.EndPhase("persistence");
   }
 
   query_engine_ = absl::make_unique<QueryEngine>();
@@ -223,19 +364,29 @@ void FirestoreClient::Initialize(const User& user, const Settings& settings) {
         sync_engine_->HandleOnlineStateChange(online_state);
       });
 
-  sync_engine_ =
-      absl::make_unique<SyncEngine>(local_store_.get(), remote_store_.get(),
-                                    user, kMaxConcurrentLimboResolutions);
+  sync_engine_ = absl::make_unique<SyncEngine>(
+      local_store_.get(), remote_store_.get(), user,
+      kMaxConcurrentLimboResolutions, LimboResolutionStrategy::BatchLookup,
+      settings.write_coalescing_enabled());
 
   event_manager_ = absl::make_unique<EventManager>(sync_engine_.get());
 
   // Setup wiring for remote store.
   remote_store_->set_sync_engine(sync_engine_.get());
 
+  timings.EndPhase("components");
+
   // NOTE: RemoteStore depends on LocalStore (for persisting stream tokens,
   // refilling mutation queue, etc.) so must be started after LocalStore.
   local_store_->Start();
+  UpdateLocalReader(user);
+  timings.EndPhase("local store");
   remote_store_->Start();
+  timings.EndPhase("remote store");
+
+  LOG_DEBUG("Initialized in %sms (%s)",
+            static_cast<double>(timings.total().count()) / 1000,
+            timings.ToString());
 }
 
 FirestoreClient::~FirestoreClient() {
@@ -297,6 +448,19 @@ void FirestoreClient::TerminateInternal() {
   lru_callback_.Cancel();
 
   remote_store_->Shutdown();
+
+  // Reads on the reader pool use persistence, and disposing of the pool would
+  // drop those that haven't started yet, so wait for all of them to finish.
+  // Reads requested from now on fall back to the worker queue.
+  std::shared_ptr<Executor> reader_executor;
+  {
+    std::unique_lock<std::mutex> lock(reader_mutex_);
+    local_reader_.reset();
+    reads_finished_.wait(lock, [this] { return running_reads_ == 0; });
+    reader_executor = std::move(reader_executor_);
+  }
+  if (reader_executor) reader_executor->Dispose();
+
   persistence_->Shutdown();
 
   local_store_.reset();
@@ -308,17 +472,26 @@ void FirestoreClient::TerminateInternal() {
 }
 
 /**
- * Schedules a callback to try running LRU garbage collection. Reschedules
- * itself after the GC has run.
+ * Schedules a callback that asks `gc_scheduler_` whether to run LRU garbage
+ * collection, and runs it if so. Reschedules itself after the check.
  */
 void FirestoreClient::ScheduleLruGarbageCollection() {
-  std::chrono::milliseconds delay =
-      gc_has_run_ ? regular_gc_delay_ : initial_gc_delay_;
-
   lru_callback_ = worker_queue_->EnqueueAfterDelay(
-      delay, TimerId::GarbageCollectionDelay, [this] {
-        local_store_->CollectGarbage(lru_delegate_->garbage_collector());
-        gc_has_run_ = true;
+      gc_scheduler_->next_delay(), TimerId::GarbageCollectionDelay, [this] {
+        using Clock = GarbageCollectionScheduler::Clock;
+
+        Clock::time_point start = Clock::now();
+        if (gc_scheduler_->Decide(lru_delegate_->GetWriteStats(), start) ==
+            GarbageCollectionScheduler::Decision::Collect) {
+          LruResults results =
+              local_store_->CollectGarbage(lru_delegate_->garbage_collector());
+          // The collection writes to the cache itself, which mustn't count as
+          // growth towards the next collection.
+          gc_scheduler_->RecordCollection(
+              lru_delegate_->GetWriteStats(), results,
+              std::chrono::duration_cast<std::chrono::milliseconds>(
+                  Clock::now() - start));
+        }
         ScheduleLruGarbageCollection();
       });
 }
@@ -406,8 +579,7 @@ void FirestoreClient::GetDocumentFromLocalCache(
 
   // TODO(c++14): move `callback` into lambda.
   auto shared_callback = absl::ShareUniquePtr(std::move(callback));
-  worker_queue_->Enqueue([this, doc, shared_callback] {
-    Document document = local_store_->ReadDocument(doc.key());
+  auto deliver = [this, doc, shared_callback](const Document& document) {
     StatusOr<DocumentSnapshot> maybe_snapshot;
 
     if (document->is_found_document()) {
@@ -432,30 +604,87 @@ void FirestoreClient::GetDocumentFromLocalCache(
       user_executor_->Execute(
           [=] { shared_callback->OnEvent(std::move(maybe_snapshot)); });
     }
+  };
+
+  bool reading = ReadFromCacheConcurrently([doc, deliver](LocalReader& reader) {
+    deliver(reader.ReadDocument(doc.key()));
   });
+  if (!reading) {
+    worker_queue_->Enqueue([this, doc, deliver] {
+      deliver(local_store_->ReadDocument(doc.key()));
+    });
+  }
 }
 
-void FirestoreClient::GetDocumentsFromLocalCache(
-    const api::Query& query, QuerySnapshotListener&& callback) {
+void FirestoreClient::GetAll(std::vector<DocumentReference> docs,
+                             api::Source source,
+                             DocumentSnapshotsListener&& callback) {
   VerifyNotTerminated();
 
-  // TODO(c++14): move `callback` into lambda.
+  // TODO(c++14): move `callback` and `docs` into lambdas.
   auto shared_callback = absl::ShareUniquePtr(std::move(callback));
-  worker_queue_->Enqueue([this, query, shared_callback] {
-    QueryResult query_result = local_store_->ExecuteQuery(
-        query.query(), /* use_previous_results= */ true);
+  auto shared_docs =
+      std::make_shared<const std::vector<DocumentReference>>(std::move(docs));
+  auto deliver = [this, shared_docs, shared_callback](
+                     const StatusOr<DocumentMap>& documents, bool from_cache) {
+    StatusOr<std::vector<DocumentSnapshot>> maybe_snapshots =
+        documents.ok() ? ToDocumentSnapshots(*shared_docs,
+                                             documents.ValueOrDie(), from_cache)
+                       : documents.status();
+
+    if (shared_callback) {
+      user_executor_->Execute(
+          [=] { shared_callback->OnEvent(std::move(maybe_snapshots)); });
+    }
+  };
 
-    View view(query.query(), query_result.remote_keys());
-    ViewDocumentChanges view_doc_changes =
-        view.ComputeDocumentChanges(query_result.documents());
-    ViewChange view_change = view.ApplyChanges(view_doc_changes);
-    HARD_ASSERT(
-        view_change.limbo_changes().empty(),
-        "View returned limbo documents during local-only query execution.");
+  DocumentKeySet keys;
+  for (const DocumentReference& doc : *shared_docs) {
+    keys = keys.insert(doc.key());
+  }
 
-    HARD_ASSERT(view_change.snapshot().has_value(), "Expected a snapshot");
+  auto read_from_cache = [this, keys, deliver] {
+    bool reading =
+        ReadFromCacheConcurrently([keys, deliver](LocalReader& reader) {
+          deliver(reader.ReadDocuments(keys), /*from_cache=*/true);
+        });
+    if (!reading) {
+      worker_queue_->Enqueue([this, keys, deliver] {
+        deliver(local_store_->ReadDocuments(keys), /*from_cache=*/true);
+      });
+    }
+  };
+
+  if (source == api::Source::Cache) {
+    read_from_cache();
+    return;
+  }
+
+  std::vector<DocumentKey> unique_keys{keys.begin(), keys.end()};
+  worker_queue_->Enqueue([this, unique_keys, source, deliver, read_from_cache] {
+    sync_engine_->LookupDocuments(
+        unique_keys, [source, deliver, read_from_cache](
+                         const StatusOr<DocumentMap>& result) {
+          // Like `DocumentReference::GetDocument`, fall back to the cache
+          // while offline unless the server was asked for explicitly.
+          if (!result.ok() &&
+              result.status().code() == Error::kErrorUnavailable &&
+              source == api::Source::Default) {
+            read_from_cache();
+            return;
+          }
+          deliver(result, /*from_cache=*/false);
+        });
+  });
+}
+
+void FirestoreClient::GetDocumentsFromLocalCache(
+    const api::Query& query, QuerySnapshotListener&& callback) {
+  VerifyNotTerminated();
 
-    ViewSnapshot snapshot = std::move(view_change.snapshot()).value();
+  // TODO(c++14): move `callback` into lambda.
+  auto shared_callback = absl::ShareUniquePtr(std::move(callback));
+  auto deliver = [this, query, shared_callback](ViewSnapshot snapshot) {
     SnapshotMetadata metadata(snapshot.has_pending_writes(),
                               snapshot.from_cache());
 
@@ -466,6 +695,179 @@ void FirestoreClient::GetDocumentsFromLocalCache(
       user_executor_->Execute(
           [=] { shared_callback->OnEvent(std::move(result)); });
     }
+  };
+
+  bool reading =
+      ReadFromCacheConcurrently([query, deliver](LocalReader& reader) {
+        deliver(ToViewSnapshot(query.query(),
+                               reader.ExecuteQuery(query.query())));
+      });
+  if (!reading) {
+    worker_queue_->Enqueue([this, query, deliver] {
+      deliver(ExecuteQueryFromCache(query.query()));
+    });
+  }
+}
+
+ViewSnapshot FirestoreClient::ExecuteQueryFromCache(const Query& query) {
+  return ToViewSnapshot(query, local_store_->ExecuteQuery(
+                                   query, /* use_previous_results= */ true));
+}
+
+void FirestoreClient::UpdateLocalReader(const User& user) {
+  std::shared_ptr<LocalReader> reader =
+      LocalReader::Create(persistence_.get(), user);
+
+  std::lock_guard<std::mutex> lock(reader_mutex_);
+  if (reader && !reader_executor_) {
+    reader_executor_ =
+        Executor::CreateConcurrent("com.google.firebase.firestore.reader",
+                                   kReaderThreads);
+  }
+  local_reader_ = std::move(reader);
+}
+
+bool FirestoreClient::ReadFromCacheConcurrently(
+    std::function<void(LocalReader&)> read) {
+  std::shared_ptr<LocalReader> reader;
+  std::shared_ptr<Executor> executor;
+  {
+    std::lock_guard<std::mutex> lock(reader_mutex_);
+    // Writes are applied to the cache on the worker queue, and reads must see
+    // every write made before them.
+    if (!local_reader_ || pending_local_writes_ > 0) return false;
+
+    // Once the client is terminating, its reads go to the worker queue like
+    // all other work, rather than to a pool that's about to be disposed.
+    if (is_terminated()) return false;
+
+    reader = local_reader_;
+    executor = reader_executor_;
+    ++running_reads_;
+  }
+
+  executor->Execute([this, reader, read] {
+    read(*reader);
+
+    std::lock_guard<std::mutex> lock(reader_mutex_);
+    --running_reads_;
+    if (running_reads_ == 0) reads_finished_.notify_all();
+  });
+  return true;
+}
+
+/** The progress of reading the results of a query from the cache in pages. */
+struct FirestoreClient::CachedPages {
+  api::Query query;
+  size_t page_size = 0;
+  api::QueryPageListener listener;
+
+  /** The number of documents delivered so far. */
+  size_t delivered = 0;
+
+  /** For queries read in key order, the key the next page starts after. */
+  DocumentKey last_key;
+
+  /**
+   * For other queries, all of their results in query order. Set when the
+   * first page is read.
+   */
+  absl::optional<std::vector<Document>> results;
+};
+
+void FirestoreClient::GetDocumentPagesFromLocalCache(
+    const api::Query& query,
+    size_t page_size,
+    api::QueryPageListener&& listener) {
+  VerifyNotTerminated();
+
+  auto pages = std::make_shared<CachedPages>();
+  pages->query = query;
+  pages->page_size = page_size;
+  pages->listener = std::move(listener);
+  worker_queue_->Enqueue([this, pages] { ReadNextCachedPage(pages); });
+}
+
+void FirestoreClient::ProfileQueryFromLocalCache(
+    const api::Query& query, api::QueryProfileCallback&& callback) {
+  VerifyNotTerminated();
+
+  // TODO(c++14): move `callback` into lambda.
+  worker_queue_->Enqueue([this, query, callback] {
+    QueryProfile profile;
+    local_store_->ExecuteQuery(query.query(),
+                               /* use_previous_results= */ true, &profile);
+    user_executor_->Execute([callback, profile] { callback(profile); });
+  });
+}
+
+void FirestoreClient::ReadNextCachedPage(std::shared_ptr<CachedPages> pages) {
+  const Query& query = pages->query.query();
+  std::vector<Document> documents;
+  bool has_more = false;
+
+  if (LocalDocumentsView::CanReadInPages(query)) {
+    size_t page_size = pages->page_size;
+    size_t remaining = 0;
+    if (query.has_limit_to_first()) {
+      remaining = static_cast<size_t>(query.limit()) - pages->delivered;
+      page_size = std::min(page_size, remaining);
+    }
+    DocumentPage page =
+        local_store_->ReadDocumentsPage(query, pages->last_key, page_size);
+    documents = std::move(page.documents);
+    has_more = page.has_more;
+    pages->last_key = std::move(page.last_key);
+
+    if (query.has_limit_to_first() && documents.size() >= remaining) {
+      has_more = false;
+    }
+  } else {
+    if (!pages->results) {
+      ViewSnapshot snapshot = ExecuteQueryFromCache(query);
+      pages->results = std::vector<Document>(snapshot.documents().begin(),
+                                             snapshot.documents().end());
+    }
+    auto begin = pages->results->begin() + pages->delivered;
+    auto end = pages->results->begin() +
+               std::min(pages->results->size(),
+                        pages->delivered + pages->page_size);
+    documents.assign(begin, end);
+    has_more = end != pages->results->end();
+  }
+  pages->delivered += documents.size();
+
+  DocumentSet document_set(query.Comparator());
+  DocumentKeySet mutated_keys;
+  for (const Document& document : documents) {
+    document_set = document_set.insert(document);
+    if (document->has_local_mutations()) {
+      mutated_keys = mutated_keys.insert(document->key());
+    }
+  }
+  bool has_pending_writes = !mutated_keys.empty();
+  ViewSnapshot snapshot = ViewSnapshot::FromInitialDocuments(
+      query, std::move(document_set), std::move(mutated_keys),
+      /*from_cache=*/true, /*excludes_metadata_changes=*/false);
+  QuerySnapshot result(pages->query.firestore(), query, std::move(snapshot),
+                       SnapshotMetadata(has_pending_writes, true));
+
+  // The next page is read once the listener has consumed this one, which keeps
+  // at most one page in flight.
+  std::weak_ptr<FirestoreClient> weak_this = shared_from_this();
+  user_executor_->Execute([weak_this, pages, result, has_more] {
+    bool more = pages->listener(result, has_more);
+    if (!more || !has_more) return;
+
+    auto shared_this = weak_this.lock();
+    FirestoreClient* client = shared_this.get();
+    if (!client ||
+        !client->worker_queue_->Enqueue(
+            [client, pages] { client->ReadNextCachedPage(pages); })) {
+      pages->listener(Status{Error::kErrorFailedPrecondition,
+                             "The client has already been terminated."},
+                      false);
+    }
   });
 }
 
@@ -473,6 +875,13 @@ void FirestoreClient::WriteMutations(std::vector<Mutation>&& mutations,
                                      StatusCallback callback) {
   VerifyNotTerminated();
 
+  // Cache-only reads wait for this write on the worker queue until it has
+  // been applied locally.
+  {
+    std::lock_guard<std::mutex> lock(reader_mutex_);
+    ++pending_local_writes_;
+  }
+
   // TODO(c++14): move `mutations` into lambda (C++14).
   worker_queue_->Enqueue([this, mutations, callback]() mutable {
     if (mutations.empty()) {
@@ -488,6 +897,80 @@ void FirestoreClient::WriteMutations(std::vector<Mutation>&& mutations,
             }
           });
     }
+
+    std::lock_guard<std::mutex> lock(reader_mutex_);
+    --pending_local_writes_;
+  });
+}
+
+void FirestoreClient::PartitionQuery(const api::Query& query,
+                                     int64_t partition_count,
+                                     api::QueryPartitionsCallback&& callback) {
+  VerifyNotTerminated();
+
+  // A single partition is the query itself.
+  if (partition_count == 1) {
+    user_executor_->Execute([query, callback] {
+      callback(std::vector<api::Query>{query});
+    });
+    return;
+  }
+
+  // The backend returns the points between partitions, one fewer than the
+  // number of partitions.
+  worker_queue_->Enqueue([this, query, partition_count, callback] {
+    remote_store_->PartitionQuery(
+        query.query().ToTarget(), partition_count - 1,
+        [this, query, callback](const StatusOr<std::vector<Bound>>& points) {
+          StatusOr<std::vector<api::Query>> result =
+              points.ok() ? StatusOr<std::vector<api::Query>>(
+                                SplitQuery(query, points.ValueOrDie()))
+                          : StatusOr<std::vector<api::Query>>(points.status());
+          user_executor_->Execute(
+              [result, callback] { callback(std::move(result)); });
+        });
+  });
+}
+
+std::shared_ptr<BulkWriter> FirestoreClient::CreateBulkWriter(
+    const BulkWriterOptions& options) {
+  VerifyNotTerminated();
+
+  // Commits are issued by the `BulkWriter` on the worker queue.
+  auto commit = [this](const std::vector<Mutation>& mutations,
+                       BulkWriter::CommitCallback&& callback) {
+    remote_store_->CommitMutations(mutations, std::move(callback));
+  };
+  return std::make_shared<BulkWriter>(worker_queue_, std::move(commit),
+                                      options);
+}
+
+void FirestoreClient::BulkWrite(const std::shared_ptr<BulkWriter>& bulk_writer,
+                                Mutation&& mutation,
+                                StatusCallback callback) {
+  VerifyNotTerminated();
+
+  // TODO(c++14): move `mutation` into lambda (C++14).
+  worker_queue_->Enqueue([this, bulk_writer, mutation, callback]() mutable {
+    bulk_writer->Write(std::move(mutation), [this, callback](Status status) {
+      // Dispatch the result back onto the user dispatch queue.
+      if (callback) {
+        user_executor_->Execute([=] { callback(std::move(status)); });
+      }
+    });
+  });
+}
+
+void FirestoreClient::FlushBulkWriter(
+    const std::shared_ptr<BulkWriter>& bulk_writer, StatusCallback callback) {
+  VerifyNotTerminated();
+
+  worker_queue_->Enqueue([this, bulk_writer, callback] {
+    bulk_writer->Flush([this, callback](Status status) {
+      if (callback) {
+        user_executor_->Execute([=] { callback(std::move(status)); });
+      }
+    });
   });
 }
 
@@ -562,8 +1045,69 @@ void FirestoreClient::GetNamedQuery(const std::string& name,
         }
       };
 
-  worker_queue_->Enqueue([this, name, async_callback] {
-    async_callback(local_store_->GetNamedQuery(name));
+  bool reading =
+      ReadFromCacheConcurrently([name, async_callback](LocalReader& reader) {
+        async_callback(reader.GetNamedQuery(name));
+      });
+  if (!reading) {
+    worker_queue_->Enqueue([this, name, async_callback] {
+      async_callback(local_store_->GetNamedQuery(name));
+    });
+  }
+}
+
+void FirestoreClient::ExportCacheSnapshot(const util::Path& file,
+                                          StatusCallback callback) {
+  VerifyNotTerminated();
+
+  worker_queue_->Enqueue([this, file, callback] {
+    Status status;
+    if (leveldb_persistence_) {
+      status = leveldb_persistence_->ExportCacheSnapshot(file);
+    } else {
+      status = Status{Error::kErrorFailedPrecondition,
+                      "Cache snapshots require persistence to be enabled"};
+    }
+
+    if (callback) {
+      user_executor_->Execute([=] { callback(status); });
+    }
+  });
+}
+
+void FirestoreClient::ImportCacheSnapshot(const util::Path& file,
+                                          StatusCallback callback) {
+  VerifyNotTerminated();
+
+  // Cache-only reads wait for the import on the worker queue, so that none of
+  // them sees a partially imported cache.
+  {
+    std::lock_guard<std::mutex> lock(reader_mutex_);
+    ++pending_local_writes_;
+  }
+
+  worker_queue_->Enqueue([this, file, callback] {
+    Status status;
+    if (!leveldb_persistence_) {
+      status = Status{Error::kErrorFailedPrecondition,
+                      "Cache snapshots require persistence to be enabled"};
+    } else if (local_store_->HasAllocatedTargets()) {
+      status = Status{Error::kErrorFailedPrecondition,
+                      "Cache snapshots can't be imported while queries are "
+                      "being listened to"};
+    } else {
+      status = leveldb_persistence_->ImportCacheSnapshot(file);
+      if (status.ok()) local_store_->HandleCacheSnapshotImport();
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(reader_mutex_);
+      --pending_local_writes_;
+    }
+
+    if (callback) {
+      user_executor_->Execute([=] { callback(status); });
+    }
   });
 }
 
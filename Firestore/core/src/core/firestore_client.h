@@ -17,7 +17,11 @@
 #ifndef FIRESTORE_CORE_SRC_CORE_FIRESTORE_CLIENT_H_
 #define FIRESTORE_CORE_SRC_CORE_FIRESTORE_CLIENT_H_
 
+#include <condition_variable>  // NOLINT(build/c++11)
+#include <cstdint>
+#include <functional>
 #include <memory>
+#include <mutex>  // NOLINT(build/c++11)
 #include <string>
 #include <vector>
 
@@ -40,6 +44,9 @@ namespace firebase {
 namespace firestore {
 
 namespace local {
+class GarbageCollectionScheduler;
+class LevelDbPersistence;
+class LocalReader;
 class LocalStore;
 class LruDelegate;
 class Persistence;
@@ -50,6 +57,10 @@ namespace model {
 class Mutation;
 }  // namespace model
 
+namespace util {
+class Path;
+}  // namespace util
+
 namespace remote {
 class ConnectivityMonitor;
 class FirebaseMetadataProvider;
@@ -128,6 +139,15 @@ class FirestoreClient : public std::enable_shared_from_this<FirestoreClient> {
   void GetDocumentFromLocalCache(const api::DocumentReference& doc,
                                  api::DocumentSnapshotListener&& callback);
 
+  /**
+   * Retrieves the given documents via the indicated callback, in the same
+   * order. Unless `source` is `Source::Cache`, all of them are read from the
+   * server with a single BatchGetDocuments call; see `api::Firestore::GetAll`.
+   */
+  void GetAll(std::vector<api::DocumentReference> docs,
+              api::Source source,
+              api::DocumentSnapshotsListener&& callback);
+
   /**
    * Retrieves a (possibly empty) set of documents from the cache via the
    * indicated callback.
@@ -135,6 +155,29 @@ class FirestoreClient : public std::enable_shared_from_this<FirestoreClient> {
   void GetDocumentsFromLocalCache(const api::Query& query,
                                   api::QuerySnapshotListener&& callback);
 
+  /**
+   * Retrieves the documents matching `query` from the cache in pages of at
+   * most `page_size` documents; see `api::Query::GetDocumentPagesFromCache`.
+   */
+  void GetDocumentPagesFromLocalCache(const api::Query& query,
+                                      size_t page_size,
+                                      api::QueryPageListener&& listener);
+
+  /**
+   * Executes `query` against the cache like `GetDocumentsFromLocalCache`, and
+   * delivers a profile of its execution to `callback` instead of the results.
+   */
+  void ProfileQueryFromLocalCache(const api::Query& query,
+                                  api::QueryProfileCallback&& callback);
+
+  /**
+   * Splits `query` into at most `partition_count` queries at points chosen by
+   * the backend; see `api::Query::GetPartitions`.
+   */
+  void PartitionQuery(const api::Query& query,
+                      int64_t partition_count,
+                      api::QueryPartitionsCallback&& callback);
+
   /**
    * Write mutations. callback will be notified when it's written to the
    * backend.
@@ -142,6 +185,27 @@ class FirestoreClient : public std::enable_shared_from_this<FirestoreClient> {
   void WriteMutations(std::vector<model::Mutation>&& mutations,
                       util::StatusCallback callback);
 
+  /**
+   * Creates a `BulkWriter` that commits its writes directly to the backend.
+   */
+  std::shared_ptr<BulkWriter> CreateBulkWriter(
+      const BulkWriterOptions& options);
+
+  /**
+   * Adds a write to `bulk_writer`. callback will be notified when the write is
+   * committed to the backend or has failed.
+   */
+  void BulkWrite(const std::shared_ptr<BulkWriter>& bulk_writer,
+                 model::Mutation&& mutation,
+                 util::StatusCallback callback);
+
+  /**
+   * Sends all writes added to `bulk_writer` so far. callback will be notified
+   * once all of them are committed or have failed.
+   */
+  void FlushBulkWriter(const std::shared_ptr<BulkWriter>& bulk_writer,
+                       util::StatusCallback callback);
+
   /**
    * Tries to execute the transaction in update_callback up to retries times.
    */
@@ -180,6 +244,23 @@ class FirestoreClient : public std::enable_shared_from_this<FirestoreClient> {
 
   void GetNamedQuery(const std::string& name, api::QueryCallback callback);
 
+  /**
+   * Writes the remote documents, targets and collection parents in the cache
+   * to a new cache snapshot at `file`. Fails if persistence is disabled.
+   */
+  void ExportCacheSnapshot(const util::Path& file,
+                           util::StatusCallback callback);
+
+  /**
+   * Seeds the cache with the contents of the cache snapshot at `file`, and
+   * makes the local store pick up the imported targets.
+   *
+   * Fails if persistence is disabled, if any queries are being listened to,
+   * or if the cache already contains targets or remote documents.
+   */
+  void ImportCacheSnapshot(const util::Path& file,
+                           util::StatusCallback callback);
+
   /** For usage in this class and testing only. */
   const std::shared_ptr<util::AsyncQueue>& worker_queue() const {
     return worker_queue_;
@@ -205,6 +286,26 @@ class FirestoreClient : public std::enable_shared_from_this<FirestoreClient> {
 
   void ScheduleLruGarbageCollection();
 
+  /** Runs `query` against the local store and returns its results. */
+  ViewSnapshot ExecuteQueryFromCache(const Query& query);
+
+  /** Replaces the reader used for cache-only reads with one for `user`. */
+  void UpdateLocalReader(const credentials::User& user);
+
+  /**
+   * Schedules `read` on the reader pool, unless reading there could miss
+   * writes that haven't been applied to the cache yet or the client is
+   * terminating. Returns false if `read` wasn't scheduled, in which case the
+   * caller reads on the worker queue.
+   */
+  bool ReadFromCacheConcurrently(
+      std::function<void(local::LocalReader&)> read);
+
+  struct CachedPages;
+
+  /** Reads and delivers the next page of `pages`. */
+  void ReadNextCachedPage(std::shared_ptr<CachedPages> pages);
+
   DatabaseInfo database_info_;
   std::shared_ptr<credentials::AppCheckCredentialsProvider>
       app_check_credentials_provider_;
@@ -223,6 +324,8 @@ class FirestoreClient : public std::enable_shared_from_this<FirestoreClient> {
   std::unique_ptr<remote::FirebaseMetadataProvider> firebase_metadata_provider_;
 
   std::unique_ptr<local::Persistence> persistence_;
+  // Null if persistence is disabled.
+  local::LevelDbPersistence* _Nullable leveldb_persistence_ = nullptr;
   std::unique_ptr<local::LocalStore> local_store_;
   std::unique_ptr<local::QueryEngine> query_engine_;
   std::unique_ptr<remote::ConnectivityMonitor> connectivity_monitor_;
@@ -230,11 +333,25 @@ class FirestoreClient : public std::enable_shared_from_this<FirestoreClient> {
   std::unique_ptr<SyncEngine> sync_engine_;
   std::unique_ptr<EventManager> event_manager_;
 
-  std::chrono::milliseconds initial_gc_delay_ = std::chrono::minutes(1);
-  std::chrono::milliseconds regular_gc_delay_ = std::chrono::minutes(5);
-  bool gc_has_run_ = false;
+  /**
+   * Cache-only reads run on `reader_executor_`, so that they don't wait for
+   * remote events being applied on the worker queue. The reader is null until
+   * the client is initialized, and whenever persistence can't be read
+   * concurrently with its transactions.
+   */
+  std::mutex reader_mutex_;
+  std::shared_ptr<local::LocalReader> local_reader_;
+  std::shared_ptr<util::Executor> reader_executor_;
+  // The number of writes that haven't been applied to the cache yet.
+  int pending_local_writes_ = 0;
+  // The number of reads scheduled on `reader_executor_` that haven't finished
+  // yet. Terminating waits for them, so that none are dropped.
+  int running_reads_ = 0;
+  std::condition_variable reads_finished_;
+
   bool credentials_initialized_ = false;
   local::LruDelegate* _Nullable lru_delegate_;
+  std::unique_ptr<local::GarbageCollectionScheduler> gc_scheduler_;
   util::DelayedOperation lru_callback_;
 };
 
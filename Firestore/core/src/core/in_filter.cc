@@ -20,6 +20,7 @@
 #include <utility>
 
 #include "Firestore/core/src/model/document.h"
+#include "Firestore/core/src/model/value_set.h"
 #include "Firestore/core/src/model/value_util.h"
 #include "Firestore/core/src/util/hard_assert.h"
 #include "absl/algorithm/container.h"
@@ -28,10 +29,10 @@ namespace firebase {
 namespace firestore {
 namespace core {
 
-using model::Contains;
 using model::Document;
 using model::FieldPath;
 using model::IsArray;
+using model::ValueSet;
 using nanopb::SharedMessage;
 
 using Operator = Filter::Operator;
@@ -41,6 +42,7 @@ class InFilter::Rep : public FieldFilter::Rep {
   Rep(FieldPath field, SharedMessage<google_firestore_v1_Value> value)
       : FieldFilter::Rep(std::move(field), Operator::In, std::move(value)) {
     HARD_ASSERT(IsArray(this->value()), "InFilter expects an ArrayValue");
+    values_ = ValueSet(this->value().array_value);
   }
 
   Type type() const override {
@@ -48,6 +50,10 @@ class InFilter::Rep : public FieldFilter::Rep {
   }
 
   bool Matches(const model::Document& doc) const override;
+
+ private:
+  /** The elements of the filter's value. */
+  ValueSet values_;
 };
 
 InFilter::InFilter(const FieldPath& field,
@@ -56,10 +62,9 @@ InFilter::InFilter(const FieldPath& field,
 }
 
 bool InFilter::Rep::Matches(const Document& doc) const {
-  const google_firestore_v1_ArrayValue& array_value = value().array_value;
   absl::optional<google_firestore_v1_Value> maybe_lhs = doc->field(field());
   if (!maybe_lhs) return false;
-  return Contains(array_value, *maybe_lhs);
+  return values_.Contains(*maybe_lhs);
 }
 
 }  // namespace core
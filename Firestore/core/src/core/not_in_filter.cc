@@ -20,6 +20,7 @@
 #include <utility>
 
 #include "Firestore/core/src/model/document.h"
+#include "Firestore/core/src/model/value_set.h"
 #include "Firestore/core/src/model/value_util.h"
 #include "Firestore/core/src/util/hard_assert.h"
 #include "absl/algorithm/container.h"
@@ -33,6 +34,7 @@ using model::Document;
 using model::FieldPath;
 using model::IsArray;
 using model::NullValue;
+using model::ValueSet;
 using nanopb::SharedMessage;
 
 using Operator = Filter::Operator;
@@ -42,6 +44,8 @@ class NotInFilter::Rep : public FieldFilter::Rep {
   Rep(FieldPath field, SharedMessage<google_firestore_v1_Value> value)
       : FieldFilter::Rep(std::move(field), Operator::NotIn, std::move(value)) {
     HARD_ASSERT(IsArray(this->value()), "NotInFilter expects an ArrayValue");
+    values_ = ValueSet(this->value().array_value);
+    contains_null_ = values_.Contains(*NullValue());
   }
 
   Type type() const override {
@@ -49,6 +53,11 @@ class NotInFilter::Rep : public FieldFilter::Rep {
   }
 
   bool Matches(const model::Document& doc) const override;
+
+ private:
+  /** The elements of the filter's value. */
+  ValueSet values_;
+  bool contains_null_ = false;
 };
 
 NotInFilter::NotInFilter(const FieldPath& field,
@@ -57,12 +66,11 @@ NotInFilter::NotInFilter(const FieldPath& field,
 }
 
 bool NotInFilter::Rep::Matches(const Document& doc) const {
-  const google_firestore_v1_ArrayValue& array_value = value().array_value;
-  if (Contains(array_value, *NullValue())) {
+  if (contains_null_) {
     return false;
   }
   absl::optional<google_firestore_v1_Value> maybe_lhs = doc->field(field());
-  return maybe_lhs && !Contains(array_value, *maybe_lhs);
+  return maybe_lhs && !values_.Contains(*maybe_lhs);
 }
 
 }  // namespace core
@@ -19,6 +19,7 @@
 #include <ostream>
 
 #include "Firestore/core/src/model/document.h"
+#include "Firestore/core/src/model/sort_key.h"
 #include "Firestore/core/src/model/value_util.h"
 #include "Firestore/core/src/util/string_format.h"
 #include "absl/strings/str_cat.h"
@@ -47,6 +48,22 @@ ComparisonResult OrderBy::Compare(const Document& lhs,
   return direction_.ApplyTo(result);
 }
 
+void OrderBy::WriteSortKey(std::string* dest, const Document& doc) const {
+  size_t start = dest->size();
+  if (field_ == FieldPath::KeyFieldPath()) {
+    model::WriteSortKey(dest, doc->key());
+  } else {
+    absl::optional<google_firestore_v1_Value> value = doc->field(field_);
+    HARD_ASSERT(value.has_value(),
+                "Trying to compare documents on fields that don't exist.");
+    model::WriteSortKey(dest, *value);
+  }
+
+  if (!ascending()) {
+    model::InvertSortKey(dest, start);
+  }
+}
+
 std::string OrderBy::CanonicalId() const {
   return absl::StrCat(field_.CanonicalString(), direction_.CanonicalId());
 }
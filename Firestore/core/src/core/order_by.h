@@ -79,6 +79,13 @@ class OrderBy {
   util::ComparisonResult Compare(const model::Document& lhs,
                                  const model::Document& rhs) const;
 
+  /**
+   * Appends the sort key of the document's value for this sort order to
+   * `dest`. Comparing the bytes of two documents' sort keys gives the same
+   * result as `Compare`.
+   */
+  void WriteSortKey(std::string* dest, const model::Document& doc) const;
+
   /** A unique ID identifying the filter; used when serializing queries. */
   std::string CanonicalId() const;
 
@@ -17,11 +17,13 @@
 #include "Firestore/core/src/core/query.h"
 
 #include <algorithm>
+#include <memory>
 #include <ostream>
 
 #include "Firestore/core/src/core/bound.h"
 #include "Firestore/core/src/core/field_filter.h"
 #include "Firestore/core/src/core/operator.h"
+#include "Firestore/core/src/core/query_matcher.h"
 #include "Firestore/core/src/model/document.h"
 #include "Firestore/core/src/model/document_key.h"
 #include "Firestore/core/src/model/document_set.h"
@@ -221,53 +223,30 @@ Query Query::AsCollectionQueryAtPath(ResourcePath path) const {
 
 bool Query::Matches(const Document& doc) const {
   return doc->is_found_document() && MatchesPathAndCollectionGroup(doc) &&
-         MatchesOrderBy(doc) && MatchesFilters(doc) && MatchesBounds(doc);
+         matcher().Matches(doc);
 }
 
 bool Query::MatchesPathAndCollectionGroup(const Document& doc) const {
-  const ResourcePath& doc_path = doc->key().path();
+  const DocumentKey& key = doc->key();
   if (collection_group_) {
     // NOTE: path_ is currently always empty since we don't expose Collection
     // Group queries rooted at a document path yet.
-    return doc->key().HasCollectionId(*collection_group_) &&
-           path_.IsPrefixOf(doc_path);
+    return key.HasCollectionId(*collection_group_) &&
+           path_.IsPrefixOf(key.collection_path());
   } else if (DocumentKey::IsDocumentKey(path_)) {
     // Exact match for document queries.
-    return path_ == doc_path;
+    return path_ == key.path();
   } else {
     // Shallow ancestor queries by default.
-    return path_.IsImmediateParentOf(doc_path);
+    return path_ == key.collection_path();
   }
 }
 
-bool Query::MatchesFilters(const Document& doc) const {
-  for (const auto& filter : filters_) {
-    if (!filter.Matches(doc)) return false;
-  }
-  return true;
-}
-
-bool Query::MatchesOrderBy(const Document& doc) const {
-  for (const OrderBy& order_by : explicit_order_bys_) {
-    const FieldPath& field_path = order_by.field();
-    // order by key always matches
-    if (field_path != FieldPath::KeyFieldPath() &&
-        doc->field(field_path) == absl::nullopt) {
-      return false;
-    }
-  }
-  return true;
-}
-
-bool Query::MatchesBounds(const Document& doc) const {
-  const OrderByList& ordering = order_bys();
-  if (start_at_ && !start_at_->SortsBeforeDocument(ordering, doc)) {
-    return false;
-  }
-  if (end_at_ && end_at_->SortsBeforeDocument(ordering, doc)) {
-    return false;
+const QueryMatcher& Query::matcher() const {
+  if (memoized_matcher_ == nullptr) {
+    memoized_matcher_ = std::make_shared<QueryMatcher>(*this);
   }
-  return true;
+  return *memoized_matcher_;
 }
 
 model::DocumentComparator Query::Comparator() const {
@@ -283,14 +262,32 @@ model::DocumentComparator Query::Comparator() const {
   HARD_ASSERT(has_key_ordering,
               "QueryComparator needs to have a key ordering.");
 
-  return DocumentComparator(
-      [ordering](const Document& doc1, const Document& doc2) {
-        for (const OrderBy& order_by : ordering) {
-          ComparisonResult comp = order_by.Compare(doc1, doc2);
-          if (!util::Same(comp)) return comp;
-        }
-        return ComparisonResult::Same;
-      });
+  if (ordering.size() == 1) {
+    // Only ordered by key, which needs no encoding.
+    return DocumentComparator(
+        [ordering](const Document& doc1, const Document& doc2) {
+          return ordering.front().Compare(doc1, doc2);
+        });
+  }
+
+  // Comparing sort keys is equivalent to applying each order by in turn, and
+  // a `DocumentSet` keeps the key of each document it holds.
+  return DocumentComparator::BySortKey(
+      [ordering](const Document& doc) { return SortKey(ordering, doc); });
+}
+
+std::string Query::SortKey(const Document& doc) const {
+  return SortKey(order_bys(), doc);
+}
+
+std::string Query::SortKey(const OrderByList& ordering, const Document& doc) {
+  // Comparing sort keys is equivalent to applying each order by in turn, see
+  // `OrderBy::WriteSortKey`.
+  std::string result;
+  for (const OrderBy& order_by : ordering) {
+    order_by.WriteSortKey(&result, doc);
+  }
+  return result;
 }
 
 const std::string Query::CanonicalId() const {
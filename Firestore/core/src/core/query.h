@@ -36,6 +36,7 @@ namespace firestore {
 namespace core {
 
 class Bound;
+class QueryMatcher;
 
 using CollectionGroupId = std::shared_ptr<const std::string>;
 
@@ -226,10 +227,19 @@ class Query {
 
   /**
    * Returns a comparator that will sort documents according to the order by
-   * clauses in this query.
+   * clauses in this query. Unless the query is only ordered by key, it
+   * compares the documents' `SortKey`s.
    */
   model::DocumentComparator Comparator() const;
 
+  /**
+   * Returns a key for the document whose bytes sort in the same order as
+   * `Comparator()` sorts the document. When sorting many documents, computing
+   * their keys once is cheaper than comparing their fields on every
+   * comparison.
+   */
+  std::string SortKey(const model::Document& doc) const;
+
   const std::string CanonicalId() const;
 
   std::string ToString() const;
@@ -247,9 +257,15 @@ class Query {
 
  private:
   bool MatchesPathAndCollectionGroup(const model::Document& doc) const;
-  bool MatchesFilters(const model::Document& doc) const;
-  bool MatchesOrderBy(const model::Document& doc) const;
-  bool MatchesBounds(const model::Document& doc) const;
+
+  static std::string SortKey(const OrderByList& ordering,
+                             const model::Document& doc);
+
+  /**
+   * Returns the compiled filters, order-by constraints and bounds of this
+   * query, compiling them on first use.
+   */
+  const QueryMatcher& matcher() const;
 
   model::ResourcePath path_;
   std::shared_ptr<const std::string> collection_group_;
@@ -275,6 +291,9 @@ class Query {
 
   // The corresponding Target of this Query instance.
   mutable std::shared_ptr<const Target> memoized_target;
+
+  // The compiled constraints of this Query instance.
+  mutable std::shared_ptr<const QueryMatcher> memoized_matcher_;
 };
 
 bool operator==(const Query& lhs, const Query& rhs);
@@ -0,0 +1,367 @@
+/*
+ * Copyright 2021 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Firestore/core/src/core/query_matcher.h"
+
+#include <array>
+
+#include "Firestore/core/src/core/field_filter.h"
+#include "Firestore/core/src/core/order_by.h"
+#include "Firestore/core/src/core/query.h"
+#include "Firestore/core/src/immutable/append_only_list.h"
+#include "Firestore/core/src/model/document.h"
+#include "Firestore/core/src/nanopb/nanopb_util.h"
+#include "Firestore/core/src/util/comparison.h"
+#include "Firestore/core/src/util/hard_assert.h"
+
+namespace firebase {
+namespace firestore {
+namespace core {
+
+using model::Document;
+using model::DocumentKey;
+using model::FieldPath;
+using model::GetTypeOrder;
+using model::TypeOrder;
+using model::ValueSet;
+using util::ComparisonResult;
+
+namespace {
+
+/** The number of field slots that `FieldValues` stores without allocating. */
+const size_t kInlineFieldSlots = 8;
+
+ComparisonResult CompareBooleans(const google_firestore_v1_Value& lhs,
+                                 const google_firestore_v1_Value& rhs) {
+  return util::Compare(lhs.boolean_value, rhs.boolean_value);
+}
+
+ComparisonResult CompareTimestampValues(const google_firestore_v1_Value& lhs,
+                                        const google_firestore_v1_Value& rhs) {
+  return model::CompareTimestamps(lhs.timestamp_value, rhs.timestamp_value);
+}
+
+uint8_t ResultBit(ComparisonResult result) {
+  return static_cast<uint8_t>(1 << (static_cast<int>(result) + 1));
+}
+
+uint8_t AcceptedResults(Filter::Operator op) {
+  uint8_t ascending = ResultBit(ComparisonResult::Ascending);
+  uint8_t same = ResultBit(ComparisonResult::Same);
+  uint8_t descending = ResultBit(ComparisonResult::Descending);
+
+  switch (op) {
+    case Filter::Operator::LessThan:
+      return ascending;
+    case Filter::Operator::LessThanOrEqual:
+      return ascending | same;
+    case Filter::Operator::Equal:
+      return same;
+    case Filter::Operator::NotEqual:
+      return ascending | descending;
+    case Filter::Operator::GreaterThanOrEqual:
+      return descending | same;
+    case Filter::Operator::GreaterThan:
+      return descending;
+    default:
+      HARD_FAIL("Operator %s unsuitable for comparison", op);
+  }
+}
+
+}  // namespace
+
+/**
+ * The values of the fields read by a `QueryMatcher` from a single document.
+ * Each field is read on first use.
+ */
+class QueryMatcher::FieldValues {
+ public:
+  FieldValues(const std::vector<FieldPath>& fields, const Document& doc)
+      : fields_{fields}, doc_{doc} {
+    if (fields.size() > kInlineFieldSlots) {
+      overflow_slots_.resize(fields.size());
+    }
+  }
+
+  const absl::optional<google_firestore_v1_Value>& Get(size_t slot) {
+    Slot& entry = overflow_slots_.empty() ? inline_slots_[slot]
+                                          : overflow_slots_[slot];
+    if (!entry.fetched) {
+      entry.value = doc_->field(fields_[slot]);
+      entry.fetched = true;
+    }
+    return entry.value;
+  }
+
+ private:
+  struct Slot {
+    bool fetched = false;
+    absl::optional<google_firestore_v1_Value> value;
+  };
+
+  const std::vector<FieldPath>& fields_;
+  const Document& doc_;
+  std::array<Slot, kInlineFieldSlots> inline_slots_;
+  std::vector<Slot> overflow_slots_;
+};
+
+QueryMatcher::QueryMatcher(const Query& query) {
+  // Checking the order-by fields first mirrors the constraints' order in the
+  // original, per-filter evaluation.
+  for (const OrderBy& order_by : query.explicit_order_bys()) {
+    // Order by key always matches.
+    if (order_by.field().IsKeyFieldPath()) continue;
+
+    Instruction instruction;
+    instruction.op = OpCode::kExists;
+    instruction.slot = SlotFor(order_by.field());
+    instructions_.push_back(std::move(instruction));
+  }
+
+  for (const Filter& filter : query.filters()) {
+    CompileFilter(filter);
+  }
+
+  start_at_ = CompileBound(query.start_at(), query);
+  end_at_ = CompileBound(query.end_at(), query);
+}
+
+size_t QueryMatcher::SlotFor(const FieldPath& field) {
+  for (size_t slot = 0; slot < fields_.size(); ++slot) {
+    if (fields_[slot] == field) return slot;
+  }
+  fields_.push_back(field);
+  return fields_.size() - 1;
+}
+
+void QueryMatcher::CompileFilter(const Filter& filter) {
+  Instruction instruction;
+  instruction.filter = filter;
+
+  switch (filter.type()) {
+    case Filter::Type::kKeyFieldFilter:
+    case Filter::Type::kKeyFieldInFilter:
+    case Filter::Type::kKeyFieldNotInFilter:
+      // These only look at the document key, which they have already parsed.
+      instruction.op = OpCode::kFilter;
+      instructions_.push_back(std::move(instruction));
+      return;
+    default:
+      break;
+  }
+
+  FieldFilter field_filter{filter};
+  instruction.slot = SlotFor(field_filter.field());
+  instruction.operand = &field_filter.value();
+  instruction.operand_type = GetTypeOrder(field_filter.value());
+
+  switch (filter.type()) {
+    case Filter::Type::kArrayContainsFilter:
+      instruction.op = OpCode::kArrayContains;
+      break;
+    case Filter::Type::kArrayContainsAnyFilter:
+      instruction.op = OpCode::kArrayContainsAny;
+      instruction.operand_elements = ValueSet(field_filter.value().array_value);
+      break;
+    case Filter::Type::kInFilter:
+      instruction.op = OpCode::kIn;
+      instruction.operand_elements = ValueSet(field_filter.value().array_value);
+      break;
+    case Filter::Type::kNotInFilter:
+      instruction.operand_elements = ValueSet(field_filter.value().array_value);
+      instruction.op =
+          instruction.operand_elements.Contains(*model::NullValue())
+              ? OpCode::kNever
+              : OpCode::kNotIn;
+      break;
+    case Filter::Type::kFieldFilter: {
+      Filter::Operator op = field_filter.op();
+      // Types do not have to match in NotEqual filters.
+      instruction.op = op == Filter::Operator::NotEqual
+                           ? OpCode::kCompareAnyType
+                           : OpCode::kCompare;
+      instruction.accepted_results = AcceptedResults(op);
+
+      // Only values with the operand's type order are ever compared to it, so
+      // the comparison can skip the type dispatch in `model::Compare`.
+      switch (instruction.operand_type) {
+        case TypeOrder::kBoolean:
+          instruction.compare = CompareBooleans;
+          break;
+        case TypeOrder::kNumber:
+          instruction.compare = model::CompareNumbers;
+          break;
+        case TypeOrder::kTimestamp:
+          instruction.compare = CompareTimestampValues;
+          break;
+        case TypeOrder::kString:
+          instruction.compare = model::CompareStrings;
+          break;
+        default:
+          instruction.compare = model::Compare;
+          break;
+      }
+      break;
+    }
+    default:
+      HARD_FAIL("Unknown filter type: %s", filter.ToString());
+  }
+
+  instructions_.push_back(std::move(instruction));
+}
+
+absl::optional<QueryMatcher::CompiledBound> QueryMatcher::CompileBound(
+    const absl::optional<Bound>& bound, const Query& query) {
+  if (!bound) return absl::nullopt;
+
+  const OrderByList& ordering = query.order_bys();
+  CompiledBound compiled{*bound};
+  const google_firestore_v1_ArrayValue& position = *compiled.bound.position();
+  HARD_ASSERT(position.values_count <= ordering.size(),
+              "Bound has more components than the provided order by.");
+
+  for (pb_size_t i = 0; i < position.values_count; ++i) {
+    const google_firestore_v1_Value& value = position.values[i];
+    const OrderBy& order_by = ordering[i];
+
+    BoundComponent component;
+    component.value = &value;
+    component.direction = order_by.direction();
+    if (order_by.field().IsKeyFieldPath()) {
+      HARD_ASSERT(
+          GetTypeOrder(value) == TypeOrder::kReference,
+          "Bound has a non-key value where the key path is being used %s",
+          value.ToString());
+      component.key =
+          DocumentKey::FromName(nanopb::MakeString(value.reference_value));
+    } else {
+      component.slot = SlotFor(order_by.field());
+    }
+    compiled.components.push_back(std::move(component));
+  }
+
+  return compiled;
+}
+
+bool QueryMatcher::Matches(const Document& doc) const {
+  FieldValues values{fields_, doc};
+
+  for (const Instruction& instruction : instructions_) {
+    if (!Execute(instruction, values, doc)) return false;
+  }
+
+  // See `Bound::SortsBeforeDocument`.
+  if (start_at_) {
+    ComparisonResult result = CompareToBound(*start_at_, values, doc);
+    bool sorts_before = start_at_->bound.before()
+                            ? result <= ComparisonResult::Same
+                            : result < ComparisonResult::Same;
+    if (!sorts_before) return false;
+  }
+  if (end_at_) {
+    ComparisonResult result = CompareToBound(*end_at_, values, doc);
+    bool sorts_before = end_at_->bound.before()
+                            ? result <= ComparisonResult::Same
+                            : result < ComparisonResult::Same;
+    if (sorts_before) return false;
+  }
+  return true;
+}
+
+bool QueryMatcher::Execute(const Instruction& instruction,
+                           FieldValues& values,
+                           const Document& doc) {
+  switch (instruction.op) {
+    case OpCode::kFilter:
+      return instruction.filter->Matches(doc);
+    case OpCode::kNever:
+      return false;
+    default:
+      break;
+  }
+
+  const absl::optional<google_firestore_v1_Value>& maybe_lhs =
+      values.Get(instruction.slot);
+  if (!maybe_lhs) return false;
+  const google_firestore_v1_Value& lhs = *maybe_lhs;
+  const google_firestore_v1_Value& operand = *instruction.operand;
+
+  switch (instruction.op) {
+    case OpCode::kExists:
+      return true;
+
+    case OpCode::kCompare:
+      return GetTypeOrder(lhs) == instruction.operand_type &&
+             (instruction.accepted_results &
+              ResultBit(instruction.compare(lhs, operand))) != 0;
+
+    case OpCode::kCompareAnyType:
+      return GetTypeOrder(lhs) != instruction.operand_type ||
+             (instruction.accepted_results &
+              ResultBit(instruction.compare(lhs, operand))) != 0;
+
+    case OpCode::kArrayContains:
+      return model::IsArray(lhs) &&
+             model::Contains(lhs.array_value, operand);
+
+    case OpCode::kArrayContainsAny:
+      if (!model::IsArray(lhs)) return false;
+      for (pb_size_t i = 0; i < lhs.array_value.values_count; ++i) {
+        if (instruction.operand_elements.Contains(lhs.array_value.values[i])) {
+          return true;
+        }
+      }
+      return false;
+
+    case OpCode::kIn:
+      return instruction.operand_elements.Contains(lhs);
+
+    case OpCode::kNotIn:
+      return !instruction.operand_elements.Contains(lhs);
+
+    case OpCode::kNever:
+    case OpCode::kFilter:
+      break;
+  }
+
+  UNREACHABLE();
+}
+
+ComparisonResult QueryMatcher::CompareToBound(const CompiledBound& bound,
+                                              FieldValues& values,
+                                              const Document& doc) {
+  for (const BoundComponent& component : bound.components) {
+    ComparisonResult comparison;
+    if (component.key) {
+      comparison = component.key->CompareTo(doc->key());
+    } else {
+      const absl::optional<google_firestore_v1_Value>& doc_value =
+          values.Get(component.slot);
+      HARD_ASSERT(
+          doc_value.has_value(),
+          "Field should exist since document matched the orderBy already.");
+      comparison = model::Compare(*component.value, *doc_value);
+    }
+
+    comparison = component.direction.ApplyTo(comparison);
+    if (!util::Same(comparison)) return comparison;
+  }
+  return ComparisonResult::Same;
+}
+
+}  // namespace core
+}  // namespace firestore
+}  // namespace firebase
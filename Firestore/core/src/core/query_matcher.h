@@ -0,0 +1,157 @@
+/*
+ * Copyright 2021 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FIRESTORE_CORE_SRC_CORE_QUERY_MATCHER_H_
+#define FIRESTORE_CORE_SRC_CORE_QUERY_MATCHER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "Firestore/Protos/nanopb/google/firestore/v1/document.nanopb.h"
+#include "Firestore/core/src/core/bound.h"
+#include "Firestore/core/src/core/direction.h"
+#include "Firestore/core/src/core/filter.h"
+#include "Firestore/core/src/model/document_key.h"
+#include "Firestore/core/src/model/field_path.h"
+#include "Firestore/core/src/model/model_fwd.h"
+#include "Firestore/core/src/model/value_set.h"
+#include "Firestore/core/src/model/value_util.h"
+#include "absl/types/optional.h"
+
+namespace firebase {
+namespace firestore {
+
+namespace util {
+enum class ComparisonResult;
+}  // namespace util
+
+namespace core {
+
+class Query;
+
+/**
+ * The filters, order-by constraints and bounds of a `Query`, compiled into a
+ * flat program for matching documents.
+ *
+ * Compilation assigns each field path the query reads a slot, so that a field
+ * used by several constraints is read from a document only once, and picks
+ * the comparison function for each relational filter based on the type of its
+ * operand. Document keys used in bounds are parsed once, up front.
+ *
+ * The path and collection group of the query are not part of the program; see
+ * `Query::Matches`.
+ */
+class QueryMatcher {
+ public:
+  explicit QueryMatcher(const Query& query);
+
+  /**
+   * Returns true if the document satisfies the compiled constraints. The
+   * document must be a found document.
+   */
+  bool Matches(const model::Document& doc) const;
+
+ private:
+  using CompareFunction =
+      util::ComparisonResult (*)(const google_firestore_v1_Value& lhs,
+                                 const google_firestore_v1_Value& rhs);
+
+  enum class OpCode {
+    /** Matches if the field exists. */
+    kExists,
+    /**
+     * Matches if the field has the operand's type order and compares to the
+     * operand with one of the `accepted_results`.
+     */
+    kCompare,
+    /**
+     * Matches if the field has a different type order than the operand, or
+     * compares to it with one of the `accepted_results`.
+     */
+    kCompareAnyType,
+    kArrayContains,
+    kArrayContainsAny,
+    kIn,
+    kNotIn,
+    /** Never matches, e.g. for a `not-in` filter whose operand has null. */
+    kNever,
+    /** Defers to `Filter::Matches`, for filters that don't read fields. */
+    kFilter,
+  };
+
+  struct Instruction {
+    OpCode op = OpCode::kNever;
+    size_t slot = 0;
+    const google_firestore_v1_Value* operand = nullptr;
+    model::TypeOrder operand_type = model::TypeOrder::kNull;
+    CompareFunction compare = nullptr;
+    /** A bit set indexed by `ComparisonResult` + 1. */
+    uint8_t accepted_results = 0;
+    /** The elements of an array operand, for `in`-like filters. */
+    model::ValueSet operand_elements;
+    /** The compiled filter, which also owns `operand`. */
+    absl::optional<Filter> filter;
+  };
+
+  struct BoundComponent {
+    /** Set if the component is for the key path. */
+    absl::optional<model::DocumentKey> key;
+    size_t slot = 0;
+    const google_firestore_v1_Value* value = nullptr;
+    Direction direction;
+  };
+
+  struct CompiledBound {
+    explicit CompiledBound(Bound bound) : bound{std::move(bound)} {
+    }
+
+    /** Owns the values that `components` point to. */
+    Bound bound;
+    std::vector<BoundComponent> components;
+  };
+
+  class FieldValues;
+
+  /** Returns the slot for the given field, allocating one if needed. */
+  size_t SlotFor(const model::FieldPath& field);
+
+  void CompileFilter(const Filter& filter);
+  absl::optional<CompiledBound> CompileBound(const absl::optional<Bound>& bound,
+                                             const Query& query);
+
+  static bool Execute(const Instruction& instruction,
+                      FieldValues& values,
+                      const model::Document& doc);
+  static util::ComparisonResult CompareToBound(const CompiledBound& bound,
+                                               FieldValues& values,
+                                               const model::Document& doc);
+
+  /** The field paths read by the program, indexed by slot. */
+  std::vector<model::FieldPath> fields_;
+
+  std::vector<Instruction> instructions_;
+
+  absl::optional<CompiledBound> start_at_;
+  absl::optional<CompiledBound> end_at_;
+};
+
+}  // namespace core
+}  // namespace firestore
+}  // namespace firebase
+
+#endif  // FIRESTORE_CORE_SRC_CORE_QUERY_MATCHER_H_
@@ -0,0 +1,100 @@
+/*
+ * Copyright 2021 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Firestore/core/src/core/rate_limiter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include "Firestore/core/src/util/hard_assert.h"
+
+namespace firebase {
+namespace firestore {
+namespace core {
+
+namespace chr = std::chrono;
+
+RateLimiter::RateLimiter(double initial_rate,
+                         double multiplier,
+                         Milliseconds multiplier_interval,
+                         double max_rate,
+                         Clock::time_point start_time)
+    : initial_rate_(initial_rate),
+      multiplier_(multiplier),
+      multiplier_interval_(multiplier_interval),
+      max_rate_(max_rate),
+      start_time_(start_time),
+      available_(initial_rate),
+      last_refill_time_(start_time) {
+  HARD_ASSERT(initial_rate > 0, "Rate must be positive");
+  HARD_ASSERT(multiplier >= 1.0, "Multiplier must be at least 1");
+  HARD_ASSERT(multiplier_interval.count() > 0, "Interval must be positive");
+  HARD_ASSERT(initial_rate <= max_rate,
+              "Initial rate can't be greater than max rate");
+}
+
+bool RateLimiter::TryAcquire(int count, Clock::time_point now) {
+  Refill(now);
+
+  // A request for more than one second's worth of operations goes through
+  // once the bucket is full, and leaves the bucket in debt.
+  double needed = std::min(static_cast<double>(count), GetRate(now));
+  if (available_ < needed) {
+    return false;
+  }
+  available_ -= count;
+  return true;
+}
+
+RateLimiter::Milliseconds RateLimiter::GetDelay(int count,
+                                                Clock::time_point now) {
+  Refill(now);
+
+  double rate = GetRate(now);
+  double needed = std::min(static_cast<double>(count), rate);
+  if (available_ >= needed) {
+    return Milliseconds::zero();
+  }
+  double seconds = (needed - available_) / rate;
+  return Milliseconds(static_cast<int64_t>(std::ceil(seconds * 1000)));
+}
+
+double RateLimiter::GetRate(Clock::time_point now) const {
+  if (now <= start_time_) {
+    return initial_rate_;
+  }
+  auto intervals = (now - start_time_) / multiplier_interval_;
+  double rate =
+      initial_rate_ * std::pow(multiplier_, static_cast<double>(intervals));
+  return std::min(rate, max_rate_);
+}
+
+void RateLimiter::Refill(Clock::time_point now) {
+  if (now <= last_refill_time_) {
+    return;
+  }
+  double rate = GetRate(now);
+  double elapsed =
+      chr::duration_cast<chr::duration<double>>(now - last_refill_time_)
+          .count();
+  available_ = std::min(available_ + elapsed * rate, rate);
+  last_refill_time_ = now;
+}
+
+}  // namespace core
+}  // namespace firestore
+}  // namespace firebase
@@ -0,0 +1,79 @@
+/*
+ * Copyright 2021 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FIRESTORE_CORE_SRC_CORE_RATE_LIMITER_H_
+#define FIRESTORE_CORE_SRC_CORE_RATE_LIMITER_H_
+
+#include <chrono>  // NOLINT(build/c++11)
+
+namespace firebase {
+namespace firestore {
+namespace core {
+
+/**
+ * A token bucket whose rate ramps up over time.
+ *
+ * The limiter allows `initial_rate` operations per second to begin with, and
+ * multiplies the rate by `multiplier` every `multiplier_interval`, up to
+ * `max_rate`. Up to one second's worth of operations may be made in a burst.
+ *
+ * Times are passed in rather than read, so that the limiter is deterministic.
+ */
+class RateLimiter {
+ public:
+  using Clock = std::chrono::steady_clock;
+  using Milliseconds = std::chrono::milliseconds;
+
+  RateLimiter(double initial_rate,
+              double multiplier,
+              Milliseconds multiplier_interval,
+              double max_rate,
+              Clock::time_point start_time);
+
+  /**
+   * Takes `count` operations from the bucket if they are available at `now`.
+   * Returns false, and takes nothing, otherwise.
+   */
+  bool TryAcquire(int count, Clock::time_point now);
+
+  /**
+   * Returns how long to wait after `now` until `count` operations are
+   * available. Returns zero if they are available already.
+   */
+  Milliseconds GetDelay(int count, Clock::time_point now);
+
+  /** Returns the number of operations allowed per second at `now`. */
+  double GetRate(Clock::time_point now) const;
+
+ private:
+  /** Refills the bucket for the time that passed since the last refill. */
+  void Refill(Clock::time_point now);
+
+  double initial_rate_ = 0;
+  double multiplier_ = 0;
+  Milliseconds multiplier_interval_;
+  double max_rate_ = 0;
+  Clock::time_point start_time_;
+
+  double available_ = 0;
+  Clock::time_point last_refill_time_;
+};
+
+}  // namespace core
+}  // namespace firestore
+}  // namespace firebase
+
+#endif  // FIRESTORE_CORE_SRC_CORE_RATE_LIMITER_H_
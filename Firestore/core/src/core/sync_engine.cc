@@ -57,6 +57,7 @@ using local::QueryPurpose;
 using local::QueryResult;
 using local::TargetData;
 using model::BatchId;
+using model::Document;
 using model::DocumentKey;
 using model::DocumentKeySet;
 using model::DocumentMap;
@@ -64,6 +65,7 @@ using model::DocumentUpdateMap;
 using model::kBatchIdUnknown;
 using model::ListenSequenceNumber;
 using model::MutableDocument;
+using model::MutableDocumentMap;
 using model::SnapshotVersion;
 using model::TargetId;
 using remote::RemoteEvent;
@@ -71,11 +73,18 @@ using remote::TargetChange;
 using util::AsyncQueue;
 using util::Status;
 using util::StatusCallback;
+using util::StatusOr;
 
 // Limbo documents don't use persistence, and are eagerly GC'd. So, listens for
 // them don't need real sequence numbers.
 const ListenSequenceNumber kIrrelevantSequenceNumber = -1;
 
+/** The maximum number of documents in limbo to look up with a single call. */
+const size_t kMaxLimboLookupBatchSize = 500;
+
+/** The maximum number of concurrent limbo lookups. */
+const size_t kMaxConcurrentLimboLookups = 4;
+
 bool ErrorIsInteresting(const Status& error) {
   bool missing_index =
       (error.code() == Error::kErrorFailedPrecondition &&
@@ -89,12 +98,16 @@ bool ErrorIsInteresting(const Status& error) {
 SyncEngine::SyncEngine(LocalStore* local_store,
                        remote::RemoteStore* remote_store,
                        const credentials::User& initial_user,
-                       size_t max_concurrent_limbo_resolutions)
+                       size_t max_concurrent_limbo_resolutions,
+                       LimboResolutionStrategy limbo_resolution_strategy,
+                       bool coalesce_writes)
     : local_store_(local_store),
       remote_store_(remote_store),
       current_user_(initial_user),
       target_id_generator_(TargetIdGenerator::SyncEngineTargetIdGenerator()),
-      max_concurrent_limbo_resolutions_(max_concurrent_limbo_resolutions) {
+      max_concurrent_limbo_resolutions_(max_concurrent_limbo_resolutions),
+      limbo_resolution_strategy_(limbo_resolution_strategy),
+      coalesce_writes_(coalesce_writes) {
 }
 
 void SyncEngine::AssertCallbackExists(absl::string_view source) {
@@ -204,9 +217,32 @@ void SyncEngine::WriteMutations(std::vector<model::Mutation>&& mutations,
                                 StatusCallback callback) {
   AssertCallbackExists("WriteMutations");
 
-  LocalWriteResult result = local_store_->WriteLocally(std::move(mutations));
-  mutation_callbacks_[current_user_].insert(
-      std::make_pair(result.batch_id(), std::move(callback)));
+  // Batches that were ever added to the write pipeline may already have been
+  // sent, so only later batches can take further writes.
+  absl::optional<BatchId> coalesce_after;
+  if (coalesce_writes_) {
+    coalesce_after = remote_store_->LastBatchIdAddedToWritePipeline();
+  }
+  LocalWriteResult result =
+      local_store_->WriteLocally(std::move(mutations), coalesce_after);
+
+  std::unordered_map<BatchId, StatusCallback>& callbacks =
+      mutation_callbacks_[current_user_];
+  auto existing = callbacks.find(result.batch_id());
+  if (existing == callbacks.end()) {
+    callbacks.insert(std::make_pair(result.batch_id(), std::move(callback)));
+  } else {
+    // The write was merged into an earlier batch, which now completes both.
+    StatusCallback earlier = std::move(existing->second);
+    existing->second = [earlier, callback](const Status& status) {
+      if (earlier) {
+        earlier(status);
+      }
+      if (callback) {
+        callback(status);
+      }
+    };
+  }
 
   EmitNewSnapshotsAndNotifyLocalStore(result.changes(), absl::nullopt);
   remote_store_->FillWritePipeline();
@@ -248,6 +284,33 @@ void SyncEngine::Transaction(int retries,
   runner->Run();
 }
 
+void SyncEngine::LookupDocuments(const std::vector<DocumentKey>& keys,
+                                 DocumentLookupCallback callback) {
+  remote_store_->LookupDocuments(
+      keys,
+      [this, callback](const StatusOr<std::vector<Document>>& result) {
+        if (!result.ok()) {
+          callback(result.status());
+          return;
+        }
+
+        DocumentUpdateMap document_updates;
+        MutableDocumentMap looked_up;
+        for (const Document& doc : result.ValueOrDie()) {
+          document_updates.emplace(doc->key(), doc.get());
+          looked_up = looked_up.insert(doc->key(), doc.get());
+        }
+
+        // Only documents that are newer than the cached ones change views,
+        // but the caller gets exactly what the server returned.
+        DocumentMap changes =
+            local_store_->ApplyDocumentLookup(document_updates);
+        EmitNewSnapshotsAndNotifyLocalStore(changes, absl::nullopt);
+
+        callback(local_store_->GetLocalViewOfDocuments(looked_up));
+      });
+}
+
 void SyncEngine::HandleCredentialChange(const credentials::User& user) {
   bool user_changed = (current_user_ != user);
   current_user_ = user;
@@ -319,33 +382,36 @@ void SyncEngine::HandleRejectedListen(TargetId target_id, Status error) {
     PumpEnqueuedLimboResolutions();
 
     // TODO(dimond): Retry on transient errors?
-
-    // It's a limbo doc. Create a synthetic event saying it was deleted. This is
-    // kind of a hack. Ideally, we would have a method in the local store to
-    // purge a document. However, it would be tricky to keep all of the local
-    // store's invariants with another method.
-    MutableDocument doc =
-        MutableDocument::NoDocument(limbo_key, SnapshotVersion::None());
-
-    // Explicitly instantiate these to work around a bug in the default
-    // constructor of the std::unordered_map that comes with GCC 4.8. Without
-    // this GCC emits a spurious "chosen constructor is explicit in
-    // copy-initialization" error.
-    DocumentKeySet limbo_documents{limbo_key};
-    RemoteEvent::TargetChangeMap target_changes;
-    RemoteEvent::TargetSet target_mismatches;
-    DocumentUpdateMap document_updates{{limbo_key, doc}};
-
-    RemoteEvent event{SnapshotVersion::None(), std::move(target_changes),
-                      std::move(target_mismatches), std::move(document_updates),
-                      std::move(limbo_documents)};
-    ApplyRemoteEvent(event);
+    RemoveInaccessibleLimboDocument(limbo_key);
   } else {
     local_store_->ReleaseTarget(target_id);
     RemoveAndCleanupTarget(target_id, error);
   }
 }
 
+void SyncEngine::RemoveInaccessibleLimboDocument(const DocumentKey& key) {
+  // It's a limbo doc. Create a synthetic event saying it was deleted. This is
+  // kind of a hack. Ideally, we would have a method in the local store to
+  // purge a document. However, it would be tricky to keep all of the local
+  // store's invariants with another method.
+  MutableDocument doc =
+      MutableDocument::NoDocument(key, SnapshotVersion::None());
+
+  // Explicitly instantiate these to work around a bug in the default
+  // constructor of the std::unordered_map that comes with GCC 4.8. Without
+  // this GCC emits a spurious "chosen constructor is explicit in
+  // copy-initialization" error.
+  DocumentKeySet limbo_documents{key};
+  RemoteEvent::TargetChangeMap target_changes;
+  RemoteEvent::TargetSet target_mismatches;
+  DocumentUpdateMap document_updates{{key, doc}};
+
+  RemoteEvent event{SnapshotVersion::None(), std::move(target_changes),
+                    std::move(target_mismatches), std::move(document_updates),
+                    std::move(limbo_documents)};
+  ApplyRemoteEvent(event);
+}
+
 void SyncEngine::HandleSuccessfulWrite(
     model::MutationBatchResult batch_result) {
   AssertCallbackExists("HandleSuccessfulWrite");
@@ -402,6 +468,11 @@ void SyncEngine::HandleOnlineStateChange(model::OnlineState online_state) {
 
   sync_engine_callback_->OnViewSnapshots(std::move(new_view_snapshot));
   sync_engine_callback_->HandleOnlineStateChange(online_state);
+
+  online_state_ = online_state;
+  if (online_state == model::OnlineState::Online) {
+    PumpEnqueuedLimboLookups();
+  }
 }
 
 DocumentKeySet SyncEngine::GetRemoteKeys(TargetId target_id) const {
@@ -531,18 +602,32 @@ void SyncEngine::UpdateTrackedLimboDocuments(
         HARD_FAIL("Unknown limbo change type: %s", limbo_change.type());
     }
   }
+
+  PumpEnqueuedLimboResolutions();
 }
 
 void SyncEngine::TrackLimboChange(const LimboDocumentChange& limbo_change) {
   const DocumentKey& key = limbo_change.key();
-  if (active_limbo_targets_by_key_.find(key) ==
-          active_limbo_targets_by_key_.end() &&
-      enqueued_limbo_resolutions_.push_back(key)) {
-    LOG_DEBUG("New document in limbo: %s", key.ToString());
-    PumpEnqueuedLimboResolutions();
+  if (IsLimboResolutionTracked(key)) {
+    return;
+  }
+
+  LOG_DEBUG("New document in limbo: %s", key.ToString());
+  if (limbo_resolution_strategy_ == LimboResolutionStrategy::BatchLookup) {
+    enqueued_limbo_lookups_.push_back(key);
+  } else {
+    enqueued_limbo_resolutions_.push_back(key);
   }
 }
 
+bool SyncEngine::IsLimboResolutionTracked(const DocumentKey& key) const {
+  return active_limbo_targets_by_key_.find(key) !=
+             active_limbo_targets_by_key_.end() ||
+         active_limbo_lookups_.find(key) != active_limbo_lookups_.end() ||
+         enqueued_limbo_resolutions_.contains(key) ||
+         enqueued_limbo_lookups_.contains(key);
+}
+
 void SyncEngine::PumpEnqueuedLimboResolutions() {
   while (!enqueued_limbo_resolutions_.empty() &&
          active_limbo_targets_by_key_.size() <
@@ -557,10 +642,98 @@ void SyncEngine::PumpEnqueuedLimboResolutions() {
                                      limbo_target_id, kIrrelevantSequenceNumber,
                                      QueryPurpose::LimboResolution));
   }
+
+  PumpEnqueuedLimboLookups();
+}
+
+void SyncEngine::PumpEnqueuedLimboLookups() {
+  // Lookups that are sent while offline fail immediately, which would hand
+  // their documents over to listens. Keep them enqueued instead.
+  if (online_state_ != model::OnlineState::Online) {
+    return;
+  }
+
+  while (!enqueued_limbo_lookups_.empty() &&
+         limbo_lookups_in_flight_ < kMaxConcurrentLimboLookups) {
+    std::vector<DocumentKey> keys;
+    while (!enqueued_limbo_lookups_.empty() &&
+           keys.size() < kMaxLimboLookupBatchSize) {
+      keys.push_back(enqueued_limbo_lookups_.front());
+      enqueued_limbo_lookups_.pop_front();
+    }
+    LookupLimboDocuments(std::move(keys));
+  }
+}
+
+void SyncEngine::LookupLimboDocuments(std::vector<DocumentKey> keys) {
+  for (const DocumentKey& key : keys) {
+    active_limbo_lookups_.insert(key);
+  }
+  ++limbo_lookups_in_flight_;
+
+  LOG_DEBUG("Looking up %s documents in limbo", keys.size());
+  remote_store_->LookupDocuments(
+      keys, [this, keys](const StatusOr<std::vector<Document>>& result) {
+        HandleLimboLookupResult(keys, result);
+      });
+}
+
+void SyncEngine::HandleLimboLookupResult(
+    const std::vector<DocumentKey>& keys,
+    const StatusOr<std::vector<Document>>& result) {
+  --limbo_lookups_in_flight_;
+
+  // Documents that left limbo while the lookup was outstanding are ignored,
+  // just like changes for a limbo target that was already unlistened.
+  DocumentKeySet active_keys;
+  for (const DocumentKey& key : keys) {
+    if (active_limbo_lookups_.erase(key) > 0) {
+      active_keys = active_keys.insert(key);
+    }
+  }
+
+  if (!result.ok()) {
+    // A lookup fails as a whole even if only one of its documents is
+    // inaccessible, and transient errors would need their own retry logic.
+    // Listens already handle both, so resolve the documents that way.
+    LOG_DEBUG("Limbo lookup failed (%s); resolving %s documents with listens",
+              result.status().ToString(), active_keys.size());
+    for (const DocumentKey& key : active_keys) {
+      enqueued_limbo_resolutions_.push_back(key);
+    }
+  } else {
+    DocumentUpdateMap document_updates;
+    for (const Document& doc : result.ValueOrDie()) {
+      if (active_keys.contains(doc->key())) {
+        document_updates.emplace(doc->key(), doc.get());
+      }
+    }
+
+    DocumentMap changes =
+        local_store_->ApplyDocumentLookup(document_updates);
+    EmitNewSnapshotsAndNotifyLocalStore(changes, absl::nullopt);
+
+    // A document that still matches its query stays in limbo until watch
+    // reports it for the query's target, which the lookup can't do. Keep it
+    // resolved with a listen until it leaves limbo, as with the `Listen`
+    // strategy.
+    for (const DocumentKey& key : active_keys) {
+      if (limbo_document_refs_.ContainsKey(key) &&
+          !IsLimboResolutionTracked(key)) {
+        enqueued_limbo_resolutions_.push_back(key);
+      }
+    }
+  }
+
+  PumpEnqueuedLimboResolutions();
 }
 
 void SyncEngine::RemoveLimboTarget(const DocumentKey& key) {
   enqueued_limbo_resolutions_.remove(key);
+  enqueued_limbo_lookups_.remove(key);
+  // An outstanding lookup can't be cancelled; its result for this document
+  // will be ignored.
+  active_limbo_lookups_.erase(key);
   auto it = active_limbo_targets_by_key_.find(key);
   if (it == active_limbo_targets_by_key_.end()) {
     // This target already got removed, because the query failed.
@@ -19,8 +19,10 @@
 
 #include <cstddef>
 #include <deque>
+#include <functional>
 #include <map>
 #include <memory>
+#include <set>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -37,6 +39,7 @@
 #include "Firestore/core/src/remote/remote_store.h"
 #include "Firestore/core/src/util/random_access_queue.h"
 #include "Firestore/core/src/util/status.h"
+#include "Firestore/core/src/util/statusor.h"
 #include "absl/strings/string_view.h"
 
 namespace firebase {
@@ -78,6 +81,22 @@ class QueryEventSource {
   virtual void StopListening(const Query& query) = 0;
 };
 
+/** Determines how `SyncEngine` resolves documents that are in limbo. */
+enum class LimboResolutionStrategy {
+  /**
+   * Opens a dedicated watch target for each document in limbo, and keeps it
+   * open for as long as the document stays in limbo.
+   */
+  Listen,
+
+  /**
+   * Looks up documents in limbo in batches, with one BatchGetDocuments call
+   * per batch. Documents that are still in limbo once their lookup returns,
+   * or whose lookup failed, are resolved with a listen instead.
+   */
+  BatchLookup,
+};
+
 /**
  * SyncEngine is the central controller in the client SDK architecture. It is
  * the glue code between the EventManager, LocalStore, and RemoteStore. Some of
@@ -94,10 +113,16 @@ class QueryEventSource {
  */
 class SyncEngine : public remote::RemoteStoreCallback, public QueryEventSource {
  public:
+  using DocumentLookupCallback =
+      std::function<void(const util::StatusOr<model::DocumentMap>&)>;
+
   SyncEngine(local::LocalStore* local_store,
              remote::RemoteStore* remote_store,
              const credentials::User& initial_user,
-             size_t max_concurrent_limbo_resolutions);
+             size_t max_concurrent_limbo_resolutions,
+             LimboResolutionStrategy limbo_resolution_strategy =
+                 LimboResolutionStrategy::Listen,
+             bool coalesce_writes = false);
 
   // Implements `QueryEventSource`.
   void SetCallback(SyncEngineCallback* callback) override {
@@ -112,6 +137,11 @@ class SyncEngine : public remote::RemoteStoreCallback, public QueryEventSource {
    * mutations, and raising events for any changes this write caused. The
    * provided callback will be called once the write has been acked or
    * rejected by the backend (or failed locally for any other reason).
+   *
+   * If write coalescing is enabled, a write to a single document may instead
+   * be merged into the last queued batch if that batch hasn't been sent to the
+   * backend yet; see `LocalStore::WriteLocally`. The callbacks of all writes
+   * merged into a batch are called once that batch has been acked or rejected.
    */
   void WriteMutations(std::vector<model::Mutation>&& mutations,
                       util::StatusCallback callback);
@@ -138,6 +168,15 @@ class SyncEngine : public remote::RemoteStoreCallback, public QueryEventSource {
                    core::TransactionUpdateCallback update_callback,
                    core::TransactionResultCallback result_callback);
 
+  /**
+   * Looks up the given documents with a single BatchGetDocuments call, and
+   * stores the results in the remote document cache like limbo lookups. The
+   * callback receives the local view of each document as the server returned
+   * it, with pending writes applied, or the error that failed the lookup.
+   */
+  void LookupDocuments(const std::vector<model::DocumentKey>& keys,
+                       DocumentLookupCallback callback);
+
   void HandleCredentialChange(const credentials::User& user);
 
   // Implements `RemoteStoreCallback`
@@ -255,9 +294,38 @@ class SyncEngine : public remote::RemoteStoreCallback, public QueryEventSource {
    * Without bounding the number of concurrent resolutions, the server can fail
    * with "resource exhausted" errors which can lead to pathological client
    * behavior as seen in https://github.com/firebase/firebase-js-sdk/issues/2683
+   *
+   * Also starts any lookups that can be started (see
+   * `PumpEnqueuedLimboLookups`).
    */
   void PumpEnqueuedLimboResolutions();
 
+  /**
+   * Starts lookups for documents in limbo that are enqueued for lookup, in
+   * batches of up to `kMaxLimboLookupBatchSize` documents. Lookups are only
+   * started while the client is online.
+   */
+  void PumpEnqueuedLimboLookups();
+
+  /**
+   * Returns true if the given document is enqueued for or undergoing limbo
+   * resolution.
+   */
+  bool IsLimboResolutionTracked(const model::DocumentKey& key) const;
+
+  /**
+   * Creates a synthetic event saying that the given document in limbo was
+   * deleted, used when the backend refuses to resolve it.
+   */
+  void RemoveInaccessibleLimboDocument(const model::DocumentKey& key);
+
+  /** Looks up the given documents in limbo with a single call. */
+  void LookupLimboDocuments(std::vector<model::DocumentKey> keys);
+
+  void HandleLimboLookupResult(
+      const std::vector<model::DocumentKey>& keys,
+      const util::StatusOr<std::vector<model::Document>>& result);
+
   void NotifyUser(model::BatchId batch_id, util::Status status);
 
   /**
@@ -307,6 +375,11 @@ class SyncEngine : public remote::RemoteStoreCallback, public QueryEventSource {
 
   const size_t max_concurrent_limbo_resolutions_;
 
+  const LimboResolutionStrategy limbo_resolution_strategy_;
+
+  /** Whether consecutive writes to a document are merged while queued. */
+  const bool coalesce_writes_;
+
   /**
    * The keys of documents that are in limbo for which we haven't yet started a
    * limbo resolution query.
@@ -327,6 +400,26 @@ class SyncEngine : public remote::RemoteStoreCallback, public QueryEventSource {
   std::map<model::TargetId, LimboResolution>
       active_limbo_resolutions_by_target_;
 
+  /**
+   * The keys of documents in limbo that are part of an outstanding lookup. Only
+   * used by `LimboResolutionStrategy::BatchLookup`.
+   */
+  std::set<model::DocumentKey> active_limbo_lookups_;
+
+  /** The number of outstanding limbo lookups. */
+  size_t limbo_lookups_in_flight_ = 0;
+
+  /**
+   * The keys of documents that are in limbo for which we haven't yet started a
+   * lookup. Only used by `LimboResolutionStrategy::BatchLookup`; documents
+   * whose lookup fails are enqueued in `enqueued_limbo_resolutions_` instead.
+   */
+  util::RandomAccessQueue<model::DocumentKey, model::DocumentKeyHash>
+      enqueued_limbo_lookups_;
+
+  /** The last online state reported by the remote store. */
+  model::OnlineState online_state_ = model::OnlineState::Unknown;
+
   /** Used to track any documents that are currently in limbo. */
   local::ReferenceSet limbo_document_refs_;
 };
@@ -16,7 +16,10 @@
 
 #include "Firestore/core/src/core/view.h"
 
+#include <algorithm>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include "Firestore/core/src/core/target.h"
 #include "Firestore/core/src/model/document_set.h"
@@ -80,6 +83,40 @@ int GetDocumentViewChangeTypePosition(DocumentViewChange::Type change_type) {
   HARD_FAIL("Unknown DocumentViewChange::Type %s", change_type);
 }
 
+/**
+ * Sorts the changes by type and then in query order. Each document's sort key
+ * is computed once up front rather than on every comparison.
+ */
+void SortChanges(const Query& query, std::vector<DocumentViewChange>* changes) {
+  struct SortableChange {
+    int type_position;
+    std::string sort_key;
+    DocumentViewChange change;
+  };
+
+  std::vector<SortableChange> sortable;
+  sortable.reserve(changes->size());
+  for (DocumentViewChange& change : *changes) {
+    int type_position = GetDocumentViewChangeTypePosition(change.type());
+    std::string sort_key = query.SortKey(change.document());
+    sortable.push_back(
+        SortableChange{type_position, std::move(sort_key), std::move(change)});
+  }
+
+  std::sort(sortable.begin(), sortable.end(),
+            [](const SortableChange& lhs, const SortableChange& rhs) {
+              if (lhs.type_position != rhs.type_position) {
+                return lhs.type_position < rhs.type_position;
+              }
+              return lhs.sort_key < rhs.sort_key;
+            });
+
+  changes->clear();
+  for (SortableChange& entry : sortable) {
+    changes->push_back(std::move(entry.change));
+  }
+}
+
 }  // namespace
 
 View::View(Query query, DocumentKeySet remote_documents)
@@ -263,16 +300,7 @@ ViewChange View::ApplyChanges(
   // Sort changes based on type and query comparator.
   std::vector<DocumentViewChange> changes =
       doc_changes.change_set().GetChanges();
-  std::sort(
-      changes.begin(), changes.end(),
-      [this](const DocumentViewChange& lhs, const DocumentViewChange& rhs) {
-        int pos1 = GetDocumentViewChangeTypePosition(lhs.type());
-        int pos2 = GetDocumentViewChangeTypePosition(rhs.type());
-        if (pos1 != pos2) {
-          return pos1 < pos2;
-        }
-        return util::Ascending(Compare(lhs.document(), rhs.document()));
-      });
+  SortChanges(query_, &changes);
 
   ApplyTargetChange(target_change);
   std::vector<LimboDocumentChange> limbo_changes = UpdateLimboDocuments();
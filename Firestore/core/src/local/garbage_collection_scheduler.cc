@@ -0,0 +1,146 @@
+/*
+ * Copyright 2021 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Firestore/core/src/local/garbage_collection_scheduler.h"
+
+#include <algorithm>
+
+#include "Firestore/core/src/util/log.h"
+#include "absl/strings/str_cat.h"
+
+namespace firebase {
+namespace firestore {
+namespace local {
+
+namespace {
+
+using Decision = GarbageCollectionScheduler::Decision;
+using Milliseconds = GarbageCollectionScheduler::Milliseconds;
+
+// The first check waits for the client to finish starting up. It always
+// collects, since the cache may have outgrown its threshold in an earlier
+// session.
+const Milliseconds kInitialDelay = std::chrono::minutes(1);
+
+// Checks are cheap, since they don't size the cache on disk.
+const Milliseconds kCheckInterval = std::chrono::minutes(1);
+
+// How soon to check again after a collection that found the cache over its
+// threshold.
+const Milliseconds kFollowUpDelay = std::chrono::seconds(10);
+
+// The cache counts as busy if it was written to this recently. Deferred
+// collections back off from this delay up to `kCheckInterval`.
+const Milliseconds kIdleWindow = std::chrono::seconds(2);
+
+// Collections aren't deferred more than this many times in a row, so that a
+// cache that is never idle is still collected.
+const int kMaxDeferrals = 5;
+
+// A collection is worthwhile once a tenth of the threshold was written, but
+// not for less than this many bytes.
+const int64_t kMinGrowthThreshold = 1024 * 1024;
+
+// Collections aren't deferred once this many times the growth threshold was
+// written, however busy the cache is.
+const int64_t kUrgentGrowthFactor = 10;
+
+const char* DecisionName(Decision decision) {
+  switch (decision) {
+    case Decision::Collect:
+      return "collect";
+    case Decision::SkipWithoutGrowth:
+      return "skip without growth";
+    case Decision::DeferWhileBusy:
+      return "defer while busy";
+  }
+  return "unknown";
+}
+
+}  // namespace
+
+std::string GarbageCollectionScheduler::Stats::ToString() const {
+  return absl::StrCat(
+      "collections: ", collections, ", skipped: ", skipped,
+      ", deferred: ", deferred,
+      ", last decision: ", DecisionName(last_decision),
+      ", last collection: ", last_collection_duration.count(),
+      "ms, total: ", total_collection_duration.count(), "ms");
+}
+
+GarbageCollectionScheduler::GarbageCollectionScheduler(
+    int64_t cache_size_threshold)
+    : growth_threshold_(
+          std::max(cache_size_threshold / 10, kMinGrowthThreshold)),
+      next_delay_(kInitialDelay) {
+}
+
+Decision GarbageCollectionScheduler::Decide(const CacheWriteStats& writes,
+                                            Clock::time_point now) {
+  int64_t growth = writes.bytes_written - bytes_written_at_last_collection_;
+  bool due = !has_collected_ || over_threshold_ || growth >= growth_threshold_;
+  bool busy = now - writes.last_write_time < kIdleWindow;
+  bool urgent = consecutive_deferrals_ >= kMaxDeferrals ||
+                growth >= kUrgentGrowthFactor * growth_threshold_;
+
+  Decision decision;
+  if (!due) {
+    decision = Decision::SkipWithoutGrowth;
+    ++stats_.skipped;
+    next_delay_ = kCheckInterval;
+  } else if (busy && !urgent) {
+    decision = Decision::DeferWhileBusy;
+    ++stats_.deferred;
+    ++consecutive_deferrals_;
+    next_delay_ = std::min(kIdleWindow * (1 << consecutive_deferrals_),
+                           kCheckInterval);
+  } else {
+    decision = Decision::Collect;
+    consecutive_deferrals_ = 0;
+    next_delay_ = kCheckInterval;
+  }
+
+  stats_.last_decision = decision;
+  LOG_DEBUG("Garbage collection: %s after %s bytes written; next check in %sms",
+            DecisionName(decision), growth, next_delay_.count());
+  return decision;
+}
+
+void GarbageCollectionScheduler::RecordCollection(
+    const CacheWriteStats& writes,
+    const LruResults& results,
+    Milliseconds duration) {
+  has_collected_ = true;
+  bytes_written_at_last_collection_ = writes.bytes_written;
+
+  // A pass is bounded, so a cache that was over its threshold may still be.
+  // Check again soon, unless the pass found nothing left to remove.
+  bool removed_any =
+      results.targets_removed > 0 || results.documents_removed > 0;
+  over_threshold_ = results.did_run && removed_any;
+  next_delay_ = over_threshold_ ? kFollowUpDelay : kCheckInterval;
+
+  ++stats_.collections;
+  stats_.last_results = results;
+  stats_.last_collection_duration = duration;
+  stats_.total_collection_duration += duration;
+  LOG_DEBUG("Garbage collection took %sms; %s", duration.count(),
+            stats_.ToString());
+}
+
+}  // namespace local
+}  // namespace firestore
+}  // namespace firebase
@@ -0,0 +1,124 @@
+/*
+ * Copyright 2021 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FIRESTORE_CORE_SRC_LOCAL_GARBAGE_COLLECTION_SCHEDULER_H_
+#define FIRESTORE_CORE_SRC_LOCAL_GARBAGE_COLLECTION_SCHEDULER_H_
+
+#include <chrono>  // NOLINT(build/c++11)
+#include <cstdint>
+#include <string>
+
+#include "Firestore/core/src/local/lru_garbage_collector.h"
+
+namespace firebase {
+namespace firestore {
+namespace local {
+
+/**
+ * Decides when to run LRU garbage collection, based on how much the cache
+ * grew and on how busy it is.
+ *
+ * The owner checks with the scheduler periodically, after `next_delay()`.
+ * The scheduler asks for a collection when enough was written to the cache
+ * since the last one. It defers the collection while the cache is being
+ * written to, so that it doesn't compete with a burst of remote events. After
+ * a collection that found the cache over its threshold, it checks again soon,
+ * since a single pass may not bring the cache back under.
+ *
+ * Times are passed in rather than read, so that decisions are deterministic.
+ */
+class GarbageCollectionScheduler {
+ public:
+  using Clock = std::chrono::steady_clock;
+  using Milliseconds = std::chrono::milliseconds;
+
+  enum class Decision {
+    /** Garbage collection should run now. */
+    Collect,
+
+    /** The cache didn't grow enough since the last collection. */
+    SkipWithoutGrowth,
+
+    /** The cache is being written to; collection waits for it to be idle. */
+    DeferWhileBusy,
+  };
+
+  /** Counts the decisions made and the time spent collecting. */
+  struct Stats {
+    /** Returns a description like "collections: 2, skipped: 10, ...". */
+    std::string ToString() const;
+
+    int collections = 0;
+    int skipped = 0;
+    int deferred = 0;
+    Decision last_decision = Decision::SkipWithoutGrowth;
+    LruResults last_results = LruResults::DidNotRun();
+    Milliseconds last_collection_duration{0};
+    Milliseconds total_collection_duration{0};
+  };
+
+  /**
+   * Creates a scheduler for a cache that is collected down to
+   * `cache_size_threshold` bytes.
+   */
+  explicit GarbageCollectionScheduler(int64_t cache_size_threshold);
+
+  /**
+   * Decides whether to collect garbage at `now`, given the writes made to the
+   * cache so far. Also decides when to check again; see `next_delay`.
+   */
+  Decision Decide(const CacheWriteStats& writes, Clock::time_point now);
+
+  /**
+   * Records the collection that ran after `Decide` returned `Collect`.
+   * `writes` are the writes made to the cache as of the end of the
+   * collection, including its own, so that growth is measured from there.
+   */
+  void RecordCollection(const CacheWriteStats& writes,
+                        const LruResults& results,
+                        Milliseconds duration);
+
+  /** Returns how long to wait before calling `Decide` again. */
+  Milliseconds next_delay() const {
+    return next_delay_;
+  }
+
+  /** The number of bytes written that make a collection worthwhile. */
+  int64_t growth_threshold() const {
+    return growth_threshold_;
+  }
+
+  const Stats& stats() const {
+    return stats_;
+  }
+
+ private:
+  int64_t growth_threshold_ = 0;
+  Milliseconds next_delay_;
+
+  bool has_collected_ = false;
+  bool over_threshold_ = false;
+  int64_t bytes_written_at_last_collection_ = 0;
+  int consecutive_deferrals_ = 0;
+
+  Stats stats_;
+};
+
+}  // namespace local
+}  // namespace firestore
+}  // namespace firebase
+
+#endif  // FIRESTORE_CORE_SRC_LOCAL_GARBAGE_COLLECTION_SCHEDULER_H_
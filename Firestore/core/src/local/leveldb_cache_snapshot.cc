@@ -0,0 +1,453 @@
+/*
+ * Copyright 2021 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Firestore/core/src/local/leveldb_cache_snapshot.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Firestore/core/src/local/leveldb_key.h"
+#include "Firestore/core/src/local/leveldb_migrations.h"
+#include "Firestore/core/src/local/leveldb_util.h"
+#include "Firestore/core/src/util/defer.h"
+#include "Firestore/core/src/util/filesystem.h"
+#include "Firestore/core/src/util/path.h"
+#include "Firestore/core/src/util/read_context.h"
+#include "Firestore/core/src/util/status.h"
+#include "Firestore/core/src/util/string_format.h"
+#include "absl/strings/match.h"
+#include "absl/strings/string_view.h"
+#include "leveldb/db.h"
+#include "leveldb/iterator.h"
+#include "leveldb/write_batch.h"
+
+namespace firebase {
+namespace firestore {
+namespace local {
+namespace {
+
+using util::Defer;
+using util::Filesystem;
+using util::Path;
+using util::Status;
+using util::StringFormat;
+
+const char kMagic[] = "FSTCACHE";
+const size_t kMagicSize = sizeof(kMagic) - 1;
+
+/** The version of the snapshot file format written by this client. */
+const uint32_t kFormatVersion = 1;
+
+/** Keys and values larger than this are taken to be a sign of corruption. */
+const uint64_t kMaxFieldSize = 64 * 1024 * 1024;
+
+/** The approximate number of bytes written to LevelDB at once on import. */
+const size_t kImportBatchSize = 4 * 1024 * 1024;
+
+/** Returns the key prefixes of the tables in a snapshot, in key order. */
+std::vector<std::string> SnapshotTables() {
+  std::vector<std::string> result = {
+      LevelDbRemoteDocumentKey::KeyPrefix(),
+      LevelDbRemoteDocumentReadTimeKey::KeyPrefix(),
+      LevelDbTargetKey::KeyPrefix(),
+      LevelDbQueryTargetKey::KeyPrefix(),
+      LevelDbTargetDocumentKey::KeyPrefix(),
+      LevelDbDocumentTargetKey::KeyPrefix(),
+      LevelDbCollectionParentKey::KeyPrefix(),
+      LevelDbTargetGlobalKey::Key(),
+  };
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+/**
+ * Returns whether the given table may already have rows when a snapshot is
+ * imported. Mutations add to the collection parent index as well, and the
+ * target metadata always exists; neither can be cleared if importing fails,
+ * so their rows are only written once the whole snapshot has been verified.
+ */
+bool IsSharedTable(absl::string_view prefix) {
+  return prefix == LevelDbCollectionParentKey::KeyPrefix() ||
+         prefix == LevelDbTargetGlobalKey::Key();
+}
+
+/** Extends the CRC-32C (Castagnoli) checksum `crc` with `data`. */
+uint32_t ExtendCrc32c(uint32_t crc, absl::string_view data) {
+  static const std::array<uint32_t, 256> table = [] {
+    std::array<uint32_t, 256> result{};
+    for (uint32_t i = 0; i < result.size(); ++i) {
+      uint32_t value = i;
+      for (int bit = 0; bit < 8; ++bit) {
+        value = (value >> 1) ^ ((value & 1) ? 0x82F63B78u : 0);
+      }
+      result[i] = value;
+    }
+    return result;
+  }();
+
+  crc = ~crc;
+  for (char c : data) {
+    crc = table[(crc ^ static_cast<uint8_t>(c)) & 0xFF] ^ (crc >> 8);
+  }
+  return ~crc;
+}
+
+/** Writes the fields of a snapshot, keeping a checksum of each section. */
+class SnapshotWriter {
+ public:
+  explicit SnapshotWriter(std::ostream* out) : out_(out) {
+  }
+
+  void WriteRaw(absl::string_view bytes) {
+    out_->write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    crc_ = ExtendCrc32c(crc_, bytes);
+  }
+
+  void WriteFixed32(uint32_t value) {
+    char bytes[4];
+    for (int i = 0; i < 4; ++i) {
+      bytes[i] = static_cast<char>(value >> (8 * i));
+    }
+    WriteRaw(absl::string_view{bytes, sizeof(bytes)});
+  }
+
+  void WriteVarint(uint64_t value) {
+    char bytes[10];
+    size_t size = 0;
+    while (value >= 0x80) {
+      bytes[size++] = static_cast<char>(value | 0x80);
+      value >>= 7;
+    }
+    bytes[size++] = static_cast<char>(value);
+    WriteRaw(absl::string_view{bytes, size});
+  }
+
+  void WriteBytes(absl::string_view bytes) {
+    WriteVarint(bytes.size());
+    WriteRaw(bytes);
+  }
+
+  /** Writes the checksum of everything written since the last checksum. */
+  void WriteChecksum() {
+    WriteFixed32(crc_);
+    crc_ = 0;
+  }
+
+ private:
+  std::ostream* out_ = nullptr;
+  uint32_t crc_ = 0;
+};
+
+/** Reads the fields written by a `SnapshotWriter`. */
+class SnapshotReader : public util::ReadContext {
+ public:
+  explicit SnapshotReader(std::istream* in) : in_(in) {
+  }
+
+  void ReadRaw(char* dest, size_t size) {
+    if (!ok()) return;
+
+    in_->read(dest, static_cast<std::streamsize>(size));
+    if (static_cast<size_t>(in_->gcount()) != size) {
+      Fail("Unexpected end of cache snapshot");
+      return;
+    }
+    crc_ = ExtendCrc32c(crc_, absl::string_view{dest, size});
+  }
+
+  uint32_t ReadFixed32() {
+    unsigned char bytes[4] = {};
+    ReadRaw(reinterpret_cast<char*>(bytes), sizeof(bytes));
+
+    uint32_t result = 0;
+    for (int i = 3; i >= 0; --i) {
+      result = (result << 8) | bytes[i];
+    }
+    return result;
+  }
+
+  uint64_t ReadVarint() {
+    uint64_t result = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      char byte = 0;
+      ReadRaw(&byte, 1);
+      if (!ok()) return 0;
+
+      result |= static_cast<uint64_t>(byte & 0x7F) << shift;
+      if ((byte & 0x80) == 0) return result;
+    }
+    Fail("Malformed varint in cache snapshot");
+    return 0;
+  }
+
+  void ReadBytes(std::string* dest) {
+    uint64_t size = ReadVarint();
+    if (size > kMaxFieldSize) {
+      Fail("Field of %s bytes in cache snapshot exceeds the limit", size);
+    }
+    if (!ok()) return;
+
+    dest->resize(static_cast<size_t>(size));
+    ReadRaw(&(*dest)[0], dest->size());
+  }
+
+  /**
+   * Reads a checksum and verifies it against everything read since the last
+   * checksum.
+   */
+  void ReadChecksum() {
+    uint32_t expected = crc_;
+    uint32_t actual = ReadFixed32();
+    crc_ = 0;
+    if (ok() && actual != expected) {
+      Fail("Checksum mismatch in cache snapshot");
+    }
+  }
+
+  bool AtEnd() {
+    return in_->peek() == std::istream::traits_type::eof();
+  }
+
+ private:
+  std::istream* in_ = nullptr;
+  uint32_t crc_ = 0;
+};
+
+leveldb::ReadOptions SnapshotReadOptions(const leveldb::Snapshot* snapshot) {
+  leveldb::ReadOptions options;
+  options.verify_checksums = true;
+  // A snapshot may be much larger than the block cache; reading it shouldn't
+  // evict what the client is using.
+  options.fill_cache = false;
+  options.snapshot = snapshot;
+  return options;
+}
+
+bool HasRows(leveldb::DB* db, const std::string& prefix) {
+  std::unique_ptr<leveldb::Iterator> it{
+      db->NewIterator(SnapshotReadOptions(nullptr))};
+  it->Seek(prefix);
+  return it->Valid() && absl::StartsWith(MakeStringView(it->key()), prefix);
+}
+
+/** Deletes all rows of the given table. */
+Status ClearTable(leveldb::DB* db, const std::string& prefix) {
+  std::unique_ptr<leveldb::Iterator> it{
+      db->NewIterator(SnapshotReadOptions(nullptr))};
+  leveldb::WriteBatch batch;
+  for (it->Seek(prefix);
+       it->Valid() && absl::StartsWith(MakeStringView(it->key()), prefix);
+       it->Next()) {
+    batch.Delete(it->key());
+    if (batch.ApproximateSize() >= kImportBatchSize) {
+      leveldb::Status status = db->Write(leveldb::WriteOptions(), &batch);
+      if (!status.ok()) return ConvertStatus(status);
+      batch.Clear();
+    }
+  }
+  if (!it->status().ok()) return ConvertStatus(it->status());
+
+  return ConvertStatus(db->Write(leveldb::WriteOptions(), &batch));
+}
+
+void WriteSnapshot(leveldb::DB* db, SnapshotWriter* writer, Status* status) {
+  writer->WriteRaw(absl::string_view{kMagic, kMagicSize});
+  writer->WriteFixed32(kFormatVersion);
+  writer->WriteFixed32(
+      static_cast<uint32_t>(LevelDbMigrations::ReadSchemaVersion(db)));
+  writer->WriteChecksum();
+
+  const leveldb::Snapshot* snapshot = db->GetSnapshot();
+  Defer release([&] { db->ReleaseSnapshot(snapshot); });
+
+  std::unique_ptr<leveldb::Iterator> it{
+      db->NewIterator(SnapshotReadOptions(snapshot))};
+  for (const std::string& prefix : SnapshotTables()) {
+    writer->WriteBytes(prefix);
+    for (it->Seek(prefix);
+         it->Valid() && absl::StartsWith(MakeStringView(it->key()), prefix);
+         it->Next()) {
+      writer->WriteBytes(MakeStringView(it->key()));
+      writer->WriteBytes(MakeStringView(it->value()));
+    }
+    if (!it->status().ok()) {
+      *status = ConvertStatus(it->status());
+      return;
+    }
+
+    // No row has an empty key, so one marks the end of the table.
+    writer->WriteBytes("");
+    writer->WriteChecksum();
+  }
+  writer->WriteBytes("");
+}
+
+void ReadHeader(leveldb::DB* db, SnapshotReader* reader) {
+  char magic[kMagicSize];
+  reader->ReadRaw(magic, kMagicSize);
+  if (reader->ok() && absl::string_view(magic, kMagicSize) != kMagic) {
+    reader->Fail("File is not a cache snapshot");
+  }
+  uint32_t format_version = reader->ReadFixed32();
+  uint32_t schema_version = reader->ReadFixed32();
+  reader->ReadChecksum();
+  if (!reader->ok()) return;
+
+  if (format_version != kFormatVersion) {
+    reader->set_status(
+        Status{Error::kErrorFailedPrecondition,
+               StringFormat("Unsupported cache snapshot format version %s",
+                            format_version)});
+    return;
+  }
+
+  auto db_version = LevelDbMigrations::ReadSchemaVersion(db);
+  if (static_cast<uint32_t>(db_version) != schema_version) {
+    reader->set_status(Status{
+        Error::kErrorFailedPrecondition,
+        StringFormat("Cache snapshot has schema version %s, but the database "
+                     "has schema version %s",
+                     schema_version, db_version)});
+  }
+}
+
+void ReadRows(leveldb::DB* db, SnapshotReader* reader) {
+  leveldb::WriteBatch batch;
+  leveldb::WriteBatch shared_rows;
+  auto flush = [&](bool sync) {
+    leveldb::WriteOptions options;
+    options.sync = sync;
+    leveldb::Status status = db->Write(options, &batch);
+    if (!status.ok()) reader->set_status(ConvertStatus(status));
+    batch.Clear();
+  };
+
+  std::string prefix;
+  std::string key;
+  std::string last_key;
+  std::string value;
+  for (const std::string& table : SnapshotTables()) {
+    reader->ReadBytes(&prefix);
+    if (reader->ok() && prefix != table) {
+      reader->Fail("Unexpected table in cache snapshot");
+    }
+
+    while (reader->ok()) {
+      reader->ReadBytes(&key);
+      if (key.empty()) break;
+      reader->ReadBytes(&value);
+      if (!reader->ok()) return;
+
+      // Rows are exported in key order, which is also the order in which
+      // LevelDB ingests them the fastest.
+      if (!absl::StartsWith(key, table) || key <= last_key) {
+        reader->Fail("Rows of cache snapshot are out of order");
+        return;
+      }
+
+      if (IsSharedTable(table)) {
+        shared_rows.Put(key, value);
+      } else {
+        batch.Put(key, value);
+        if (batch.ApproximateSize() >= kImportBatchSize) flush(false);
+      }
+      std::swap(key, last_key);
+    }
+
+    reader->ReadChecksum();
+    if (!reader->ok()) return;
+  }
+
+  reader->ReadBytes(&prefix);
+  if (reader->ok() && (!prefix.empty() || !reader->AtEnd())) {
+    reader->Fail("Unexpected data at the end of cache snapshot");
+  }
+  if (reader->ok()) {
+    batch.Append(shared_rows);
+    flush(true);
+  }
+}
+
+}  // namespace
+
+Status ExportCacheSnapshot(leveldb::DB* db, const Path& file) {
+  std::ofstream out{file.native_value(), std::ios::binary | std::ios::trunc};
+  if (!out) {
+    return Status{Error::kErrorInternal,
+                  StringFormat("Failed to create cache snapshot at '%s'",
+                               file.ToUtf8String())};
+  }
+
+  Status status;
+  SnapshotWriter writer{&out};
+  WriteSnapshot(db, &writer, &status);
+  out.close();
+  if (status.ok() && !out) {
+    status = Status{Error::kErrorInternal,
+                    StringFormat("Failed to write cache snapshot to '%s'",
+                                 file.ToUtf8String())};
+  }
+
+  if (!status.ok()) {
+    Filesystem::Default()->RemoveFile(file).IgnoreError();
+  }
+  return status;
+}
+
+Status ImportCacheSnapshot(leveldb::DB* db, const Path& file) {
+  std::ifstream in{file.native_value(), std::ios::binary};
+  if (!in) {
+    return Status{Error::kErrorNotFound,
+                  StringFormat("Cache snapshot at '%s' cannot be opened",
+                               file.ToUtf8String())};
+  }
+
+  std::vector<std::string> tables = SnapshotTables();
+  for (const std::string& prefix : tables) {
+    if (!IsSharedTable(prefix) && HasRows(db, prefix)) {
+      return Status{Error::kErrorFailedPrecondition,
+                    "Cache snapshots can only be imported into an empty cache"};
+    }
+  }
+
+  SnapshotReader reader{&in};
+  ReadHeader(db, &reader);
+  if (!reader.ok()) return reader.status();
+
+  ReadRows(db, &reader);
+  if (!reader.ok()) {
+    for (const std::string& prefix : tables) {
+      if (!IsSharedTable(prefix)) {
+        // The original error is more useful than any failure to clean up.
+        ClearTable(db, prefix).IgnoreError();
+      }
+    }
+    return reader.status();
+  }
+  return Status::OK();
+}
+
+}  // namespace local
+}  // namespace firestore
+}  // namespace firebase
@@ -0,0 +1,75 @@
+/*
+ * Copyright 2021 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FIRESTORE_CORE_SRC_LOCAL_LEVELDB_CACHE_SNAPSHOT_H_
+#define FIRESTORE_CORE_SRC_LOCAL_LEVELDB_CACHE_SNAPSHOT_H_
+
+#include "Firestore/core/src/util/status_fwd.h"
+
+namespace leveldb {
+class DB;
+}  // namespace leveldb
+
+namespace firebase {
+namespace firestore {
+
+namespace util {
+class Path;
+}  // namespace util
+
+namespace local {
+
+/**
+ * Cache snapshots copy the rows of the remote document cache, the target cache
+ * and the collection parent index from one LevelDB database to another as they
+ * are stored, so that a new install can be seeded with a large cache without
+ * parsing and indexing every document the way loading a bundle does.
+ *
+ * A snapshot file consists of:
+ *
+ *   - a header: the magic string "FSTCACHE", followed by the format version
+ *     and the schema version of the exported database;
+ *   - one section per table, in key order: the table's key prefix, then its
+ *     rows in key order, each a key followed by a value, then an empty key;
+ *   - an empty key prefix marking the end of the snapshot.
+ *
+ * Strings are prefixed with their length as a varint. The header and each
+ * section end with a CRC-32C of their contents. Fixed-size integers are
+ * little-endian.
+ */
+
+/**
+ * Writes the cached rows of `db` to a new snapshot at `file`. The rows are read
+ * from a LevelDB snapshot, so writes that happen meanwhile are either included
+ * in full or not at all.
+ */
+util::Status ExportCacheSnapshot(leveldb::DB* db, const util::Path& file);
+
+/**
+ * Writes the rows of the snapshot at `file` to `db`.
+ *
+ * `db` must be at the same schema version as the database the snapshot was
+ * exported from, and must not contain any targets or remote documents yet.
+ * The rows are written in key order in large batches. If the snapshot turns
+ * out to be corrupt, the rows written so far are removed again.
+ */
+util::Status ImportCacheSnapshot(leveldb::DB* db, const util::Path& file);
+
+}  // namespace local
+}  // namespace firestore
+}  // namespace firebase
+
+#endif  // FIRESTORE_CORE_SRC_LOCAL_LEVELDB_CACHE_SNAPSHOT_H_
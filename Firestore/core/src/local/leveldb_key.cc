@@ -39,6 +39,7 @@ namespace {
 const char* kVersionGlobalTable = "version";
 const char* kMutationsTable = "mutation";
 const char* kDocumentMutationsTable = "document_mutation";
+const char* kCollectionMutationsTable = "collection_mutation";
 const char* kMutationQueuesTable = "mutation_queue";
 const char* kTargetGlobalTable = "target_global";
 const char* kTargetsTable = "target";
@@ -50,6 +51,7 @@ const char* kCollectionParentsTable = "collection_parent";
 const char* kRemoteDocumentReadTimeTable = "remote_document_read_time";
 const char* kBundlesTable = "bundles";
 const char* kNamedQueriesTable = "named_queries";
+const char* kMigrationProgressTable = "migration_progress";
 
 /**
  * Labels for the components of keys. These serve to make keys self-describing.
@@ -650,6 +652,16 @@ class Writer {
     }
   }
 
+  /**
+   * Writes the path of the given document key, equivalent to
+   * `WriteResourcePath(key.path())` without building the path.
+   */
+  void WriteDocumentKey(const DocumentKey& key) {
+    WriteResourcePath(key.collection_path());
+    WriteComponentLabel(ComponentLabel::PathSegment);
+    OrderedCode::WriteString(&dest_, key.document_id());
+  }
+
  private:
   /** Writes a component label to the given key destination. */
   void WriteComponentLabel(ComponentLabel label) {
@@ -702,6 +714,13 @@ std::string LevelDbVersionKey::Key() {
   return writer.result();
 }
 
+std::string LevelDbMigrationProgressKey::Key() {
+  Writer writer;
+  writer.WriteTableName(kMigrationProgressTable);
+  writer.WriteTerminator();
+  return writer.result();
+}
+
 std::string LevelDbMutationKey::KeyPrefix() {
   Writer writer;
   writer.WriteTableName(kMutationsTable);
@@ -762,7 +781,7 @@ std::string LevelDbDocumentMutationKey::Key(absl::string_view user_id,
   Writer writer;
   writer.WriteTableName(kDocumentMutationsTable);
   writer.WriteUserId(user_id);
-  writer.WriteResourcePath(document_key.path());
+  writer.WriteDocumentKey(document_key);
   writer.WriteBatchId(batch_id);
   writer.WriteTerminator();
   return writer.result();
@@ -778,6 +797,53 @@ bool LevelDbDocumentMutationKey::Decode(absl::string_view key) {
   return reader.ok();
 }
 
+std::string LevelDbCollectionMutationKey::KeyPrefix() {
+  Writer writer;
+  writer.WriteTableName(kCollectionMutationsTable);
+  return writer.result();
+}
+
+std::string LevelDbCollectionMutationKey::KeyPrefix(
+    absl::string_view user_id) {
+  Writer writer;
+  writer.WriteTableName(kCollectionMutationsTable);
+  writer.WriteUserId(user_id);
+  return writer.result();
+}
+
+std::string LevelDbCollectionMutationKey::KeyPrefix(
+    absl::string_view user_id, const ResourcePath& collection_path) {
+  Writer writer;
+  writer.WriteTableName(kCollectionMutationsTable);
+  writer.WriteUserId(user_id);
+  writer.WriteResourcePath(collection_path);
+  return writer.result();
+}
+
+std::string LevelDbCollectionMutationKey::Key(absl::string_view user_id,
+                                              const DocumentKey& document_key,
+                                              model::BatchId batch_id) {
+  Writer writer;
+  writer.WriteTableName(kCollectionMutationsTable);
+  writer.WriteUserId(user_id);
+  writer.WriteResourcePath(document_key.collection_path());
+  writer.WriteDocumentId(document_key.document_id());
+  writer.WriteBatchId(batch_id);
+  writer.WriteTerminator();
+  return writer.result();
+}
+
+bool LevelDbCollectionMutationKey::Decode(absl::string_view key) {
+  Reader reader{key};
+  reader.ReadTableNameMatching(kCollectionMutationsTable);
+  user_id_ = reader.ReadUserId();
+  collection_path_ = reader.ReadResourcePath();
+  document_id_ = reader.ReadDocumentId();
+  batch_id_ = reader.ReadBatchId();
+  reader.ReadTerminator();
+  return reader.ok();
+}
+
 std::string LevelDbMutationQueueKey::KeyPrefix() {
   Writer writer;
   writer.WriteTableName(kMutationQueuesTable);
@@ -886,7 +952,7 @@ std::string LevelDbTargetDocumentKey::Key(model::TargetId target_id,
   Writer writer;
   writer.WriteTableName(kTargetDocumentsTable);
   writer.WriteTargetId(target_id);
-  writer.WriteResourcePath(document_key.path());
+  writer.WriteDocumentKey(document_key);
   writer.WriteTerminator();
   return writer.result();
 }
@@ -918,7 +984,7 @@ std::string LevelDbDocumentTargetKey::Key(const DocumentKey& document_key,
                                           model::TargetId target_id) {
   Writer writer;
   writer.WriteTableName(kDocumentTargetsTable);
-  writer.WriteResourcePath(document_key.path());
+  writer.WriteDocumentKey(document_key);
   writer.WriteTargetId(target_id);
   writer.WriteTerminator();
   return writer.result();
@@ -971,7 +1037,7 @@ std::string LevelDbRemoteDocumentKey::KeyPrefix(
 std::string LevelDbRemoteDocumentKey::Key(const DocumentKey& key) {
   Writer writer;
   writer.WriteTableName(kRemoteDocumentsTable);
-  writer.WriteResourcePath(key.path());
+  writer.WriteDocumentKey(key);
   writer.WriteTerminator();
   return writer.result();
 }
@@ -1017,6 +1083,12 @@ bool LevelDbCollectionParentKey::Decode(absl::string_view key) {
   return reader.ok();
 }
 
+std::string LevelDbRemoteDocumentReadTimeKey::KeyPrefix() {
+  Writer writer;
+  writer.WriteTableName(kRemoteDocumentReadTimeTable);
+  return writer.result();
+}
+
 std::string LevelDbRemoteDocumentReadTimeKey::KeyPrefix(
     const model::ResourcePath& collection_path,
     model::SnapshotVersion read_time) {
@@ -49,6 +49,13 @@ namespace local {
 //   - path: ResourcePath
 //   - batch_id: model::BatchId
 //
+// collection_mutations:
+//   - table_name: string = "collection_mutation"
+//   - user_id: string
+//   - collection: ResourcePath
+//   - document_id: string
+//   - batch_id: model::BatchId
+//
 // mutation_queues:
 //   - table_name: string = "mutation_queue"
 //   - user_id: string
@@ -97,6 +104,9 @@ namespace local {
 // named_queries:
 //   - table_name: string = "named_queries"
 //   - name: string
+//
+// migration_progress:
+//   - table_name: string = "migration_progress"
 
 /**
  * Parses the given key and returns a human readable description of its
@@ -116,6 +126,19 @@ class LevelDbVersionKey {
   static std::string Key();
 };
 
+/**
+ * A key to a singleton row storing how far a schema migration that runs in
+ * batches has progressed. The row only exists while a migration is incomplete.
+ */
+class LevelDbMigrationProgressKey {
+ public:
+  /**
+   * Returns the key pointing to the singleton row storing the migration
+   * progress.
+   */
+  static std::string Key();
+};
+
 /** A key in the mutations table. */
 class LevelDbMutationKey {
  public:
@@ -228,6 +251,82 @@ class LevelDbDocumentMutationKey {
   model::BatchId batch_id_ = model::kBatchIdUnknown;
 };
 
+/**
+ * A key in the collection_mutations table, an index of the document_mutations
+ * table keyed by the parent collection of each document.
+ *
+ * Because document IDs are written with a component label that sorts before
+ * path segments, all the rows for the immediate children of a collection are
+ * contiguous and precede the rows for any of its subcollections. A scan for a
+ * collection query can therefore stop as soon as it reads a row whose
+ * collection path differs from the queried one.
+ */
+class LevelDbCollectionMutationKey {
+ public:
+  /**
+   * Creates a key prefix that points just before the first key in the table.
+   */
+  static std::string KeyPrefix();
+
+  /**
+   * Creates a key prefix that points just before the first key for the given
+   * user_id.
+   */
+  static std::string KeyPrefix(absl::string_view user_id);
+
+  /**
+   * Creates a key prefix that points just before the first key for the user_id
+   * and collection path.
+   */
+  static std::string KeyPrefix(absl::string_view user_id,
+                               const model::ResourcePath& collection_path);
+
+  /**
+   * Creates a complete key that points to a specific user_id, document key,
+   * and batch_id.
+   */
+  static std::string Key(absl::string_view user_id,
+                         const model::DocumentKey& document_key,
+                         model::BatchId batch_id);
+
+  /**
+   * Decodes the given complete key, storing the decoded values in this
+   * instance.
+   *
+   * @return true if the key successfully decoded, false otherwise. If false is
+   * returned, this instance is in an undefined state until the next call to
+   * `Decode()`.
+   */
+  ABSL_MUST_USE_RESULT
+  bool Decode(absl::string_view key);
+
+  /** The user that owns the mutation batches. */
+  const std::string& user_id() const {
+    return user_id_;
+  }
+
+  /** The path to the collection containing the document. */
+  const model::ResourcePath& collection_path() const {
+    return collection_path_;
+  }
+
+  /** The ID of the document within its collection. */
+  const std::string& document_id() const {
+    return document_id_;
+  }
+
+  /** The batch_id in which the document participates. */
+  model::BatchId batch_id() const {
+    return batch_id_;
+  }
+
+ private:
+  std::string user_id_;
+  model::ResourcePath collection_path_;
+  std::string document_id_;
+  model::BatchId batch_id_ = model::kBatchIdUnknown;
+};
+
 /**
  * A key in the mutation_queues table.
  *
@@ -597,6 +696,11 @@ class LevelDbCollectionParentKey {
  */
 class LevelDbRemoteDocumentReadTimeKey {
  public:
+  /**
+   * Creates a key prefix that points just before the first key in the table.
+   */
+  static std::string KeyPrefix();
+
   /**
    * Creates a key prefix that points just before the first key for the given
    * collection_path and read_time.
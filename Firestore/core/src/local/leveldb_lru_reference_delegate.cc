@@ -110,6 +110,10 @@ StatusOr<int64_t> LevelDbLruReferenceDelegate::CalculateByteSize() {
   return db_->CalculateByteSize();
 }
 
+CacheWriteStats LevelDbLruReferenceDelegate::GetWriteStats() {
+  return db_->write_stats();
+}
+
 size_t LevelDbLruReferenceDelegate::GetSequenceNumberCount() {
   size_t total_count = db_->target_cache()->size();
   EnumerateOrphanedDocuments(
@@ -58,6 +58,7 @@ class LevelDbLruReferenceDelegate : public LruDelegate {
   LruGarbageCollector* garbage_collector() override;
 
   util::StatusOr<int64_t> CalculateByteSize() override;
+  CacheWriteStats GetWriteStats() override;
   size_t GetSequenceNumberCount() override;
 
   void EnumerateTargetSequenceNumbers(
@@ -16,8 +16,11 @@
 
 #include "Firestore/core/src/local/leveldb_migrations.h"
 
+#include <cstdint>
+#include <functional>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "Firestore/Protos/nanopb/firestore/local/mutation.nanopb.h"
 #include "Firestore/Protos/nanopb/firestore/local/target.nanopb.h"
@@ -30,8 +33,10 @@
 #include "Firestore/core/src/nanopb/reader.h"
 #include "Firestore/core/src/nanopb/writer.h"
 #include "Firestore/core/src/util/log.h"
+#include "Firestore/core/src/util/ordered_code.h"
 #include "Firestore/core/src/util/statusor.h"
 #include "absl/strings/match.h"
+#include "absl/strings/string_view.h"
 
 namespace firebase {
 namespace firestore {
@@ -43,6 +48,9 @@ using model::DocumentKey;
 using model::ResourcePath;
 using nanopb::Message;
 using nanopb::StringReader;
+using util::OrderedCode;
+
+using SchemaVersion = LevelDbMigrations::SchemaVersion;
 
 /**
  * Schema version for the iOS client.
@@ -65,8 +73,9 @@ using nanopb::StringReader;
  *   * Migration 5 drops held write acks.
  *   * Migration 6 populates the collection_parents index.
  *   * Migration 7 rewrites query_targets canonical ids in new format.
+ *   * Migration 8 populates the collection_mutations index.
  */
-const LevelDbMigrations::SchemaVersion kSchemaVersion = 7;
+const SchemaVersion kSchemaVersion = 8;
 
 /**
  * Save the given version number as the current version of the schema of the
@@ -74,13 +83,236 @@ const LevelDbMigrations::SchemaVersion kSchemaVersion = 7;
  * @param version The version to save
  * @param transaction The transaction in which to save the new version number
  */
-void SaveVersion(LevelDbMigrations::SchemaVersion version,
+void SaveVersion(SchemaVersion version,
                  LevelDbTransaction* transaction) {
   std::string key = LevelDbVersionKey::Key();
   std::string version_string = std::to_string(version);
   transaction->Put(key, version_string);
 }
 
+/** The initial value of `MigrationCursor::fingerprint`. */
+const uint64_t kFingerprintBasis = 14695981039346656037ULL;
+
+/**
+ * Extends a 64-bit FNV-1a hash with the given row key. The hash is persisted,
+ * so it must not depend on the platform or the build.
+ */
+uint64_t ExtendFingerprint(uint64_t fingerprint, absl::string_view key) {
+  const uint64_t prime = 1099511628211ULL;
+  for (char c : key) {
+    fingerprint ^= static_cast<uint8_t>(c);
+    fingerprint *= prime;
+  }
+  // Terminate the key so that adjacent keys can't run into each other.
+  fingerprint ^= 0xFF;
+  fingerprint *= prime;
+  return fingerprint;
+}
+
+/** How migrations that run in batches commit and report their progress. */
+struct BatchOptions {
+  size_t batch_size = LevelDbMigrations::kDefaultBatchSize;
+  LevelDbMigrations::ProgressListener listener;
+};
+
+/**
+ * The position of a migration that runs in batches, stored in the
+ * migration_progress row after every batch.
+ */
+struct MigrationCursor {
+  SchemaVersion version = 0;
+
+  /** The index of the table being scanned. */
+  int64_t table = 0;
+
+  int64_t rows_processed = 0;
+
+  /**
+   * The last row of the table that has been processed, or empty if the scan
+   * of the table hasn't started.
+   */
+  std::string last_key;
+
+  /** A hash of the keys of all the rows processed so far. */
+  uint64_t fingerprint = kFingerprintBasis;
+};
+
+void SaveCursor(const MigrationCursor& cursor,
+                LevelDbTransaction* transaction) {
+  std::string value;
+  OrderedCode::WriteSignedNumIncreasing(&value, cursor.version);
+  OrderedCode::WriteSignedNumIncreasing(&value, cursor.table);
+  OrderedCode::WriteSignedNumIncreasing(&value, cursor.rows_processed);
+  OrderedCode::WriteString(&value, cursor.last_key);
+  OrderedCode::WriteNumIncreasing(&value, cursor.fingerprint);
+  transaction->Put(LevelDbMigrationProgressKey::Key(), value);
+}
+
+/**
+ * Reads the position of an interrupted migration to `version`. Returns a
+ * cursor at the start of the first table if the migration hasn't started.
+ */
+MigrationCursor ReadCursor(SchemaVersion version,
+                           LevelDbTransaction* transaction) {
+  MigrationCursor cursor;
+  cursor.version = version;
+
+  std::string value;
+  Status status =
+      transaction->Get(LevelDbMigrationProgressKey::Key(), &value);
+  if (status.IsNotFound()) return cursor;
+  HARD_ASSERT(status.ok(), "Failed to read migration progress, error: '%s'",
+              status.ToString());
+
+  absl::string_view src = value;
+  int64_t saved_version = 0;
+  MigrationCursor saved;
+  bool decoded =
+      OrderedCode::ReadSignedNumIncreasing(&src, &saved_version) &&
+      OrderedCode::ReadSignedNumIncreasing(&src, &saved.table) &&
+      OrderedCode::ReadSignedNumIncreasing(&src, &saved.rows_processed) &&
+      OrderedCode::ReadString(&src, &saved.last_key) &&
+      OrderedCode::ReadNumIncreasing(&src, &saved.fingerprint) && src.empty();
+  HARD_ASSERT(decoded, "Failed to decode migration progress");
+
+  // Progress left behind by a different migration can't be resumed.
+  if (saved_version != version) return cursor;
+
+  saved.version = version;
+  return saved;
+}
+
+/** Returns true if `cursor` is past the first row of the first table. */
+bool HasStarted(const MigrationCursor& cursor) {
+  return cursor.table > 0 || !cursor.last_key.empty();
+}
+
+/**
+ * Returns true if the rows up to `cursor` are still the rows that were
+ * processed before the migration was interrupted. Another client (e.g. one
+ * that doesn't know about the migration) may have added or removed rows in
+ * the meantime.
+ */
+bool MatchesProcessedRows(const MigrationCursor& cursor,
+                          const std::vector<std::string>& prefixes,
+                          LevelDbTransaction* transaction) {
+  int64_t rows = 0;
+  uint64_t fingerprint = kFingerprintBasis;
+
+  auto it = transaction->NewIterator();
+  auto table_count = static_cast<int64_t>(prefixes.size());
+  for (int64_t table = 0; table <= cursor.table && table < table_count;
+       ++table) {
+    const std::string& prefix = prefixes[table];
+    for (it->Seek(prefix); it->Valid() && absl::StartsWith(it->key(), prefix);
+         it->Next()) {
+      if (table == cursor.table &&
+          (cursor.last_key.empty() || it->key() > cursor.last_key)) {
+        break;
+      }
+      fingerprint = ExtendFingerprint(fingerprint, it->key());
+      ++rows;
+    }
+  }
+  return rows == cursor.rows_processed && fingerprint == cursor.fingerprint;
+}
+
+/** Processes a single row of a table that is being migrated. */
+using RowVisitor = std::function<void(LevelDbTransaction* transaction,
+                                      const std::string& key,
+                                      const std::string& value)>;
+
+/**
+ * Calls `visit` for every row of the tables with the given key prefixes, one
+ * table after the other, and then saves `version` as the schema version.
+ *
+ * The rows are processed in transactions of `options.batch_size` rows, which
+ * bounds the number of writes buffered in memory. Each transaction also
+ * records the last row it processed, so an interrupted migration resumes
+ * after the last committed batch. `visit` must therefore tolerate a row being
+ * visited in a later run without the state it built up in an earlier one.
+ *
+ * If `start_over` is given, the migration only resumes if the rows processed
+ * before the interruption are unchanged, and otherwise starts over from the
+ * first row. `start_over` is called whenever the migration starts from the
+ * first row, so it can drop whatever an earlier run wrote.
+ */
+void MigrateInBatches(leveldb::DB* db,
+                      SchemaVersion version,
+                      absl::string_view label,
+                      const std::vector<std::string>& prefixes,
+                      const BatchOptions& options,
+                      const RowVisitor& visit,
+                      const std::function<void()>& start_over = {}) {
+  HARD_ASSERT(options.batch_size > 0, "Migration batch size must be positive");
+
+  MigrationCursor cursor;
+  {
+    LevelDbTransaction transaction(db, "Read migration progress");
+    cursor = ReadCursor(version, &transaction);
+    if (start_over && HasStarted(cursor) &&
+        !MatchesProcessedRows(cursor, prefixes, &transaction)) {
+      LOG_DEBUG("Restarting migration to schema version %s, its rows changed "
+                "since it was interrupted",
+                version);
+      cursor = MigrationCursor{};
+      cursor.version = version;
+    }
+  }
+  if (start_over && !HasStarted(cursor)) {
+    start_over();
+  }
+  if (cursor.rows_processed > 0) {
+    LOG_DEBUG("Resuming migration to schema version %s after %s rows",
+              version, cursor.rows_processed);
+  }
+
+  auto table_count = static_cast<int64_t>(prefixes.size());
+  while (cursor.table < table_count) {
+    const std::string& prefix = prefixes[cursor.table];
+    LevelDbTransaction transaction(db, label);
+
+    auto it = transaction.NewIterator();
+    if (cursor.last_key.empty()) {
+      it->Seek(prefix);
+    } else {
+      it->Seek(cursor.last_key);
+      if (it->Valid() && it->key() == cursor.last_key) it->Next();
+    }
+
+    size_t rows = 0;
+    for (; rows < options.batch_size && it->Valid() &&
+           absl::StartsWith(it->key(), prefix);
+         it->Next()) {
+      visit(&transaction, it->key(), it->value());
+      cursor.last_key = it->key();
+      cursor.fingerprint = ExtendFingerprint(cursor.fingerprint, it->key());
+      ++rows;
+    }
+    cursor.rows_processed += static_cast<int64_t>(rows);
+
+    if (!it->Valid() || !absl::StartsWith(it->key(), prefix)) {
+      ++cursor.table;
+      cursor.last_key.clear();
+    }
+
+    if (cursor.table < table_count) {
+      SaveCursor(cursor, &transaction);
+    } else {
+      transaction.Delete(LevelDbMigrationProgressKey::Key());
+      SaveVersion(version, &transaction);
+    }
+    transaction.Commit();
+
+    if (options.listener) {
+      LevelDbMigrations::Progress progress;
+      progress.version = version;
+      progress.rows_processed = cursor.rows_processed;
+      options.listener(progress);
+    }
+  }
+}
+
 void DeleteEverythingWithPrefix(const std::string& prefix, leveldb::DB* db) {
   bool more_deletes = true;
   while (more_deletes) {
@@ -220,28 +452,27 @@ void EnsureSentinelRow(LevelDbTransaction* transaction,
  * Ensure each document in the remote document table has a corresponding
  * sentinel row in the document target index.
  */
-void EnsureSentinelRows(leveldb::DB* db) {
-  LevelDbTransaction transaction(db, "Ensure sentinel rows");
-
+void EnsureSentinelRows(leveldb::DB* db, const BatchOptions& options) {
   // Get the value we'll use for anything that's missing a row.
-  model::ListenSequenceNumber sequence_number =
-      GetHighestSequenceNumber(&transaction);
-  std::string sentinel_value =
-      LevelDbDocumentTargetKey::EncodeSentinelValue(sequence_number);
+  std::string sentinel_value;
+  {
+    LevelDbTransaction transaction(db, "Read highest sequence number");
+    model::ListenSequenceNumber sequence_number =
+        GetHighestSequenceNumber(&transaction);
+    sentinel_value =
+        LevelDbDocumentTargetKey::EncodeSentinelValue(sequence_number);
+  }
 
-  std::string documents_prefix = LevelDbRemoteDocumentKey::KeyPrefix();
-  auto it = transaction.NewIterator();
-  it->Seek(documents_prefix);
   LevelDbRemoteDocumentKey document_key;
-  for (; it->Valid() && absl::StartsWith(it->key(), documents_prefix);
-       it->Next()) {
-    HARD_ASSERT(document_key.Decode(it->key()),
-                "Failed to decode document key");
-    EnsureSentinelRow(&transaction, document_key.document_key(),
-                      sentinel_value);
-  }
-  SaveVersion(4, &transaction);
-  transaction.Commit();
+  MigrateInBatches(
+      db, 4, "Ensure sentinel rows", {LevelDbRemoteDocumentKey::KeyPrefix()},
+      options,
+      [&](LevelDbTransaction* transaction, const std::string& key,
+          const std::string&) {
+        HARD_ASSERT(document_key.Decode(key), "Failed to decode document key");
+        EnsureSentinelRow(transaction, document_key.document_key(),
+                          sentinel_value);
+      });
 }
 
 // Helper to add an index entry iff we haven't already written it (as determined
@@ -249,7 +480,7 @@ void EnsureSentinelRows(leveldb::DB* db) {
 void EnsureCollectionParentRow(LevelDbTransaction* transaction,
                                MemoryCollectionParentIndex* cache,
                                const DocumentKey& key) {
-  const ResourcePath& collection_path = key.path().PopLast();
+  const ResourcePath& collection_path = key.collection_path();
   if (cache->Add(collection_path)) {
     std::string collection_id = collection_path.last_segment();
     ResourcePath parent_path = collection_path.PopLast();
@@ -267,40 +498,34 @@ void EnsureCollectionParentRow(LevelDbTransaction* transaction,
  * Creates appropriate LevelDbCollectionParentKey rows for all collections
  * of documents in the remote document cache and mutation queue.
  */
-void EnsureCollectionParentsIndex(leveldb::DB* db) {
-  LevelDbTransaction transaction(db, "Ensure Collection Parents Index");
-
+void EnsureCollectionParentsIndex(leveldb::DB* db,
+                                  const BatchOptions& options) {
+  // Only avoids writing the same row more than once per run; rewriting a row
+  // after resuming is harmless.
   MemoryCollectionParentIndex cache;
 
-  // Index existing remote documents.
+  // Index existing remote documents, then existing mutations.
   std::string documents_prefix = LevelDbRemoteDocumentKey::KeyPrefix();
-  auto it = transaction.NewIterator();
-  it->Seek(documents_prefix);
-  LevelDbRemoteDocumentKey document_key;
-  for (; it->Valid() && absl::StartsWith(it->key(), documents_prefix);
-       it->Next()) {
-    HARD_ASSERT(document_key.Decode(it->key()),
-                "Failed to decode document key");
-
-    EnsureCollectionParentRow(&transaction, &cache,
-                              document_key.document_key());
-  }
-
-  // Index existing mutations.
   std::string mutations_prefix = LevelDbDocumentMutationKey::KeyPrefix();
-  it = transaction.NewIterator();
-  it->Seek(mutations_prefix);
-  LevelDbDocumentMutationKey key;
-  for (; it->Valid() && absl::StartsWith(it->key(), mutations_prefix);
-       it->Next()) {
-    HARD_ASSERT(key.Decode(it->key()),
-                "Failed to decode document-mutation key");
-
-    EnsureCollectionParentRow(&transaction, &cache, key.document_key());
-  }
-
-  SaveVersion(6, &transaction);
-  transaction.Commit();
+  LevelDbRemoteDocumentKey document_key;
+  LevelDbDocumentMutationKey mutation_key;
+  MigrateInBatches(
+      db, 6, "Ensure Collection Parents Index",
+      {documents_prefix, mutations_prefix}, options,
+      [&](LevelDbTransaction* transaction, const std::string& key,
+          const std::string&) {
+        if (absl::StartsWith(key, documents_prefix)) {
+          HARD_ASSERT(document_key.Decode(key),
+                      "Failed to decode document key");
+          EnsureCollectionParentRow(transaction, &cache,
+                                    document_key.document_key());
+        } else {
+          HARD_ASSERT(mutation_key.Decode(key),
+                      "Failed to decode document-mutation key");
+          EnsureCollectionParentRow(transaction, &cache,
+                                    mutation_key.document_key());
+        }
+      });
 }
 
 /**
@@ -346,37 +571,67 @@ util::StatusOr<TargetData> ReadTargetData(
  * Rewrites targets canonical IDs with new format.
  */
 void RewriteTargetsCanonicalIds(leveldb::DB* db,
-                                const LocalSerializer& serializer) {
-  LevelDbTransaction transaction(db, "Rewrite Targets Canonical Ids");
-
-  std::string query_targets_prefix = LevelDbQueryTargetKey::KeyPrefix();
-  auto it = transaction.NewIterator();
-  it->Seek(query_targets_prefix);
+                                const LocalSerializer& serializer,
+                                const BatchOptions& options) {
   LevelDbQueryTargetKey query_target_key;
-  for (; it->Valid() && absl::StartsWith(it->key(), query_targets_prefix);
-       it->Next()) {
-    HARD_ASSERT(query_target_key.Decode(it->key()),
-                "Failed to decode query_targets key");
-
-    util::StatusOr<TargetData> target_data =
-        ReadTargetData(query_target_key, serializer, transaction);
-    if (!target_data.ok()) {
-      LOG_WARN("Reading target data failed: %s",
-               target_data.status().error_message());
-      continue;
-    }
-
-    auto new_key = LevelDbQueryTargetKey::Key(
-        target_data.ValueOrDie().target().CanonicalId(),
-        target_data.ValueOrDie().target_id());
-
-    transaction.Delete(it->key());
-    std::string empty_buffer;
-    transaction.Put(new_key, empty_buffer);
-  }
+  MigrateInBatches(
+      db, 7, "Rewrite Targets Canonical Ids",
+      {LevelDbQueryTargetKey::KeyPrefix()}, options,
+      [&](LevelDbTransaction* transaction, const std::string& key,
+          const std::string&) {
+        HARD_ASSERT(query_target_key.Decode(key),
+                    "Failed to decode query_targets key");
+
+        util::StatusOr<TargetData> target_data =
+            ReadTargetData(query_target_key, serializer, *transaction);
+        if (!target_data.ok()) {
+          LOG_WARN("Reading target data failed: %s",
+                   target_data.status().error_message());
+          return;
+        }
+
+        auto new_key = LevelDbQueryTargetKey::Key(
+            target_data.ValueOrDie().target().CanonicalId(),
+            target_data.ValueOrDie().target_id());
+
+        transaction->Delete(key);
+        std::string empty_buffer;
+        transaction->Put(new_key, empty_buffer);
+      });
+}
 
-  SaveVersion(7, &transaction);
-  transaction.Commit();
+/**
+ * Migration 8.
+ *
+ * Creates LevelDbCollectionMutationKey rows for every row in the
+ * document_mutations index. Any existing rows are dropped first: a client
+ * that downgraded past this migration may have removed mutation batches
+ * without maintaining the collection_mutations index. For the same reason,
+ * an interrupted run is only resumed if the document_mutations rows it
+ * indexed are unchanged.
+ */
+void EnsureCollectionMutationsIndex(leveldb::DB* db,
+                                    const BatchOptions& options) {
+  LevelDbDocumentMutationKey mutation_key;
+  std::string empty_buffer;
+  MigrateInBatches(
+      db, 8, "Ensure Collection Mutations Index",
+      {LevelDbDocumentMutationKey::KeyPrefix()}, options,
+      [&](LevelDbTransaction* transaction, const std::string& key,
+          const std::string&) {
+        HARD_ASSERT(mutation_key.Decode(key),
+                    "Failed to decode document-mutation key");
+
+        transaction->Put(
+            LevelDbCollectionMutationKey::Key(mutation_key.user_id(),
+                                              mutation_key.document_key(),
+                                              mutation_key.batch_id()),
+            empty_buffer);
+      },
+      [db] {
+        DeleteEverythingWithPrefix(LevelDbCollectionMutationKey::KeyPrefix(),
+                                   db);
+      });
 }
 
 }  // namespace
@@ -397,20 +652,41 @@ LevelDbMigrations::SchemaVersion LevelDbMigrations::ReadSchemaVersion(
   }
 }
 
+constexpr size_t LevelDbMigrations::kDefaultBatchSize;
+
 void LevelDbMigrations::RunMigrations(leveldb::DB* db,
                                       const LocalSerializer& serializer) {
   RunMigrations(db, kSchemaVersion, serializer);
 }
 
+void LevelDbMigrations::RunMigrations(leveldb::DB* db,
+                                      const LocalSerializer& serializer,
+                                      const ProgressListener& listener) {
+  RunMigrations(db, kSchemaVersion, serializer, listener);
+}
+
 void LevelDbMigrations::RunMigrations(leveldb::DB* db,
                                       SchemaVersion to_version,
                                       const LocalSerializer& serializer) {
+  RunMigrations(db, to_version, serializer, ProgressListener{});
+}
+
+void LevelDbMigrations::RunMigrations(leveldb::DB* db,
+                                      SchemaVersion to_version,
+                                      const LocalSerializer& serializer,
+                                      const ProgressListener& listener,
+                                      size_t batch_size) {
+  BatchOptions options;
+  options.batch_size = batch_size;
+  options.listener = listener;
+
   SchemaVersion from_version = ReadSchemaVersion(db);
   // If this is a downgrade, just save the downgrade version so we can
   // detect it when we go to upgrade again, allowing us to rerun the
   // data migrations.
   if (from_version > to_version) {
     LevelDbTransaction transaction(db, "Save downgrade version");
+    transaction.Delete(LevelDbMigrationProgressKey::Key());
     SaveVersion(to_version, &transaction);
     transaction.Commit();
     return;
@@ -424,7 +700,7 @@ void LevelDbMigrations::RunMigrations(leveldb::DB* db,
   }
 
   if (from_version < 4 && to_version >= 4) {
-    EnsureSentinelRows(db);
+    EnsureSentinelRows(db, options);
   }
 
   if (from_version < 5 && to_version >= 5) {
@@ -432,11 +708,15 @@ void LevelDbMigrations::RunMigrations(leveldb::DB* db,
   }
 
   if (from_version < 6 && to_version >= 6) {
-    EnsureCollectionParentsIndex(db);
+    EnsureCollectionParentsIndex(db, options);
   }
 
   if (from_version < 7 && to_version >= 7) {
-    RewriteTargetsCanonicalIds(db, serializer);
+    RewriteTargetsCanonicalIds(db, serializer, options);
+  }
+
+  if (from_version < 8 && to_version >= 8) {
+    EnsureCollectionMutationsIndex(db, options);
   }
 }
 
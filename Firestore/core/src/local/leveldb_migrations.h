@@ -17,7 +17,9 @@
 #ifndef FIRESTORE_CORE_SRC_LOCAL_LEVELDB_MIGRATIONS_H_
 #define FIRESTORE_CORE_SRC_LOCAL_LEVELDB_MIGRATIONS_H_
 
+#include <cstddef>
 #include <cstdint>
+#include <functional>
 
 #include "Firestore/core/src/local/leveldb_transaction.h"
 #include "Firestore/core/src/local/local_serializer.h"
@@ -31,6 +33,27 @@ class LevelDbMigrations {
  public:
   using SchemaVersion = int32_t;
 
+  /** The progress of a migration that processes the rows of a table. */
+  struct Progress {
+    /** The schema version that the migration upgrades to. */
+    SchemaVersion version = 0;
+
+    /**
+     * The number of rows processed so far, including those processed before
+     * the migration was interrupted.
+     */
+    int64_t rows_processed = 0;
+  };
+
+  /** Called after each batch of a migration has been committed. */
+  using ProgressListener = std::function<void(const Progress&)>;
+
+  /**
+   * The default number of rows that a migration processes in a single
+   * transaction.
+   */
+  static constexpr size_t kDefaultBatchSize = 1000;
+
   /**
    * Returns the current version of the schema for the given database
    */
@@ -42,6 +65,14 @@ class LevelDbMigrations {
    */
   static void RunMigrations(leveldb::DB* db, const LocalSerializer& serializer);
 
+  /**
+   * Runs any migrations needed to bring the given database up to the current
+   * schema version, notifying `listener` of the progress of long migrations.
+   */
+  static void RunMigrations(leveldb::DB* db,
+                            const LocalSerializer& serializer,
+                            const ProgressListener& listener);
+
   /**
    * Runs any migrations needed to bring the given database up to the given
    * schema version
@@ -49,6 +80,22 @@ class LevelDbMigrations {
   static void RunMigrations(leveldb::DB* db,
                             SchemaVersion version,
                             const LocalSerializer& serializer);
+
+  /**
+   * Runs any migrations needed to bring the given database up to the given
+   * schema version.
+   *
+   * Migrations that rewrite whole tables commit every `batch_size` rows and
+   * record how far they got, so that memory use is bounded and a migration
+   * that is interrupted (for example because the app is killed) resumes where
+   * it left off the next time the database is opened. `listener` (which may
+   * be empty) is notified after every batch.
+   */
+  static void RunMigrations(leveldb::DB* db,
+                            SchemaVersion version,
+                            const LocalSerializer& serializer,
+                            const ProgressListener& listener,
+                            size_t batch_size = kDefaultBatchSize);
 };
 
 }  // namespace local
@@ -16,6 +16,7 @@
 
 #include "Firestore/core/src/local/leveldb_mutation_queue.h"
 
+#include <algorithm>
 #include <memory>
 #include <utility>
 
@@ -55,6 +56,43 @@ using nanopb::ByteString;
 using nanopb::Message;
 using nanopb::StringReader;
 
+namespace {
+
+/**
+ * Adds the batch_ids of the mutations on immediate children of `collection` to
+ * `batch_ids`.
+ *
+ * The collection-mutation index groups rows by the parent collection of each
+ * document, and the rows for immediate children sort before those for any
+ * subcollection, so this only visits mutations on documents directly within
+ * the collection. The batch_ids it encounters are neither necessarily unique
+ * nor in order, so an efficient simultaneous scan of the main table isn't
+ * possible.
+ */
+void CollectBatchIdsInCollection(LevelDbTransaction::Iterator* index_iterator,
+                                 const std::string& user_id,
+                                 const ResourcePath& collection,
+                                 std::set<BatchId>* batch_ids) {
+  std::string index_prefix =
+      LevelDbCollectionMutationKey::KeyPrefix(user_id, collection);
+  index_iterator->Seek(index_prefix);
+
+  LevelDbCollectionMutationKey row_key;
+  for (; index_iterator->Valid(); index_iterator->Next()) {
+    // The first row for a subcollection (or for a different collection) ends
+    // the run of immediate children.
+    if (!absl::StartsWith(index_iterator->key(), index_prefix) ||
+        !row_key.Decode(index_iterator->key()) ||
+        row_key.collection_path() != collection) {
+      break;
+    }
+
+    batch_ids->insert(row_key.batch_id());
+  }
+}
+
+}  // namespace
+
 BatchId LoadNextBatchIdFromDb(DB* db) {
   // TODO(gsoltis): implement Prev() and SeekToLast() on
   // LevelDbTransaction::Iterator, then port this to a transaction.
@@ -133,7 +171,10 @@ LevelDbMutationQueue::LevelDbMutationQueue(const User& user,
 }
 
 void LevelDbMutationQueue::Start() {
-  next_batch_id_ = LoadNextBatchIdFromDb(db_->ptr());
+  // The next batch ID requires a scan of the mutation queues of all users,
+  // and isn't needed until the first write, so it is loaded then.
+  next_batch_id_ = kBatchIdUnknown;
+  highest_removed_batch_id_ = kBatchIdUnknown;
   metadata_ = MetadataForKey(mutation_queue_key());
 }
 
@@ -159,6 +200,10 @@ MutationBatch LevelDbMutationQueue::AddMutationBatch(
     const Timestamp& local_write_time,
     std::vector<Mutation>&& base_mutations,
     std::vector<Mutation>&& mutations) {
+  if (next_batch_id_ == kBatchIdUnknown) {
+    next_batch_id_ = std::max(LoadNextBatchIdFromDb(db_->ptr()),
+                              highest_removed_batch_id_ + 1);
+  }
   BatchId batch_id = next_batch_id_;
   next_batch_id_++;
 
@@ -177,8 +222,11 @@ MutationBatch LevelDbMutationQueue::AddMutationBatch(
     key = LevelDbDocumentMutationKey::Key(user_id_, mutation.key(), batch_id);
     db_->current_transaction()->Put(key, empty_buffer);
 
+    key = LevelDbCollectionMutationKey::Key(user_id_, mutation.key(), batch_id);
+    db_->current_transaction()->Put(key, empty_buffer);
+
     db_->index_manager()->AddToCollectionParentIndex(
-        mutation.key().path().PopLast());
+        mutation.key().collection_path());
   }
 
   return batch;
@@ -201,14 +249,33 @@ void LevelDbMutationQueue::RemoveMutationBatch(const MutationBatch& batch) {
               DescribeKey(check_iterator->key()));
 
   db_->current_transaction()->Delete(key);
+  highest_removed_batch_id_ = std::max(highest_removed_batch_id_, batch_id);
 
   for (const Mutation& mutation : batch.mutations()) {
     key = LevelDbDocumentMutationKey::Key(user_id_, mutation.key(), batch_id);
     db_->current_transaction()->Delete(key);
+
+    key = LevelDbCollectionMutationKey::Key(user_id_, mutation.key(), batch_id);
+    db_->current_transaction()->Delete(key);
     db_->reference_delegate()->RemoveMutationReference(mutation.key());
   }
 }
 
+void LevelDbMutationQueue::ReplaceMutationBatch(const MutationBatch& batch) {
+  std::string key = mutation_batch_key(batch.batch_id());
+
+  // The index entries are keyed by document and batch ID, so they stay valid
+  // as long as the replacement affects the same documents.
+  std::string existing;
+  Status status = db_->current_transaction()->Get(key, &existing);
+  HARD_ASSERT(status.ok(), "Mutation batch %s did not exist", DescribeKey(key));
+  HARD_ASSERT(ParseMutationBatch(existing).keys() == batch.keys(),
+              "Replacement of batch %s must affect the same documents",
+              DescribeKey(key));
+
+  db_->current_transaction()->Put(key, serializer_->EncodeMutationBatch(batch));
+}
+
 std::vector<MutationBatch> LevelDbMutationQueue::AllMutationBatches() {
   std::string user_key = LevelDbMutationKey::KeyPrefix(user_id_);
 
@@ -274,32 +341,10 @@ LevelDbMutationQueue::AllMutationBatchesAffectingQuery(const Query& query) {
       !query.IsCollectionGroupQuery(),
       "CollectionGroup queries should be handled in LocalDocumentsView");
 
-  const ResourcePath& query_path = query.path();
-  size_t immediate_children_path_length = query_path.size() + 1;
-
-  // TODO(mcg): Actually implement a single-collection query
-  //
-  // This is actually executing an ancestor query, traversing the whole subtree
-  // below the collection which can be horrifically inefficient for some
-  // structures. The right way to solve this is to implement the full value
-  // index, but that's not in the cards in the near future so this is the best
-  // we can do for the moment.
-  //
   // Since we don't yet index the actual properties in the mutations, our
   // current approach is to just return all mutation batches that affect
   // documents in the collection being queried.
   //
-  // Unlike AllMutationBatchesAffectingDocumentKey, this iteration will scan the
-  // document-mutation index for more than a single document so the associated
-  // batch_ids will be neither necessarily unique nor in order. This means an
-  // efficient simultaneous scan isn't possible.
-  std::string index_prefix =
-      LevelDbDocumentMutationKey::KeyPrefix(user_id_, query_path);
-  auto index_iterator = db_->current_transaction()->NewIterator();
-  index_iterator->Seek(index_prefix);
-
-  LevelDbDocumentMutationKey row_key;
-
   // Collect up unique batch_ids encountered during a scan of the index. Use a
   // set<BatchId> to accumulate the IDs so they can be traversed in order in a
   // scan of the main table.
@@ -309,23 +354,22 @@ LevelDbMutationQueue::AllMutationBatchesAffectingQuery(const Query& query) {
   // performance difference is minor for small numbers of keys but > 30% faster
   // for larger numbers of keys.
   std::set<BatchId> unique_batch_ids;
-  for (; index_iterator->Valid(); index_iterator->Next()) {
-    if (!absl::StartsWith(index_iterator->key(), index_prefix) ||
-        !row_key.Decode(index_iterator->key())) {
-      break;
-    }
+  auto index_iterator = db_->current_transaction()->NewIterator();
+  CollectBatchIdsInCollection(index_iterator.get(), user_id_, query.path(),
+                              &unique_batch_ids);
 
-    // Rows with document keys more than one segment longer than the query path
-    // can't be matches. For example, a query on 'rooms' can't match the
-    // document /rooms/abc/messages/xyx.
-    // TODO(mcg): we'll need a different scanner when we implement ancestor
-    // queries.
-    if (row_key.document_key().path().size() !=
-        immediate_children_path_length) {
-      continue;
-    }
+  return AllMutationBatchesWithIds(unique_batch_ids);
+}
 
-    unique_batch_ids.insert(row_key.batch_id());
+std::vector<MutationBatch>
+LevelDbMutationQueue::AllMutationBatchesAffectingCollections(
+    const std::vector<ResourcePath>& collections) {
+  // Each collection costs a single seek, most of which find no rows at all.
+  std::set<BatchId> unique_batch_ids;
+  auto index_iterator = db_->current_transaction()->NewIterator();
+  for (const ResourcePath& collection : collections) {
+    CollectBatchIdsInCollection(index_iterator.get(), user_id_, collection,
+                                &unique_batch_ids);
   }
 
   return AllMutationBatchesWithIds(unique_batch_ids);
@@ -396,21 +440,23 @@ void LevelDbMutationQueue::PerformConsistencyCheck() {
     return;
   }
 
-  // Verify that there are no entries in the document-mutation index if the
-  // queue is empty.
-  std::string index_prefix = LevelDbDocumentMutationKey::KeyPrefix(user_id_);
-  auto index_iterator = db_->current_transaction()->NewIterator();
-  index_iterator->Seek(index_prefix);
-
+  // Verify that there are no entries in the document-mutation or
+  // collection-mutation indexes if the queue is empty.
   std::vector<std::string> dangling_mutation_references;
 
-  for (; index_iterator->Valid(); index_iterator->Next()) {
-    // Only consider rows matching this index prefix for the current user.
-    if (!absl::StartsWith(index_iterator->key(), index_prefix)) {
-      break;
-    }
+  auto index_iterator = db_->current_transaction()->NewIterator();
+  for (const std::string& index_prefix :
+       {LevelDbDocumentMutationKey::KeyPrefix(user_id_),
+        LevelDbCollectionMutationKey::KeyPrefix(user_id_)}) {
+    for (index_iterator->Seek(index_prefix); index_iterator->Valid();
+         index_iterator->Next()) {
+      // Only consider rows matching this index prefix for the current user.
+      if (!absl::StartsWith(index_iterator->key(), index_prefix)) {
+        break;
+      }
 
-    dangling_mutation_references.push_back(DescribeKey(index_iterator));
+      dangling_mutation_references.push_back(DescribeKey(index_iterator));
+    }
   }
 
   HARD_ASSERT(dangling_mutation_references.empty(),
@@ -24,6 +24,7 @@
 #include "Firestore/Protos/nanopb/firestore/local/mutation.nanopb.h"
 #include "Firestore/core/src/local/mutation_queue.h"
 #include "Firestore/core/src/model/model_fwd.h"
+#include "Firestore/core/src/model/mutation_batch.h"
 #include "Firestore/core/src/model/types.h"
 #include "Firestore/core/src/nanopb/message.h"
 #include "absl/strings/string_view.h"
@@ -69,6 +70,8 @@ class LevelDbMutationQueue : public MutationQueue {
 
   void RemoveMutationBatch(const model::MutationBatch& batch) override;
 
+  void ReplaceMutationBatch(const model::MutationBatch& batch) override;
+
   std::vector<model::MutationBatch> AllMutationBatches() override;
 
   std::vector<model::MutationBatch> AllMutationBatchesAffectingDocumentKeys(
@@ -80,6 +83,9 @@ class LevelDbMutationQueue : public MutationQueue {
   std::vector<model::MutationBatch> AllMutationBatchesAffectingQuery(
       const core::Query& query) override;
 
+  std::vector<model::MutationBatch> AllMutationBatchesAffectingCollections(
+      const std::vector<model::ResourcePath>& collections) override;
+
   absl::optional<model::MutationBatch> LookupMutationBatch(
       model::BatchId batch_id) override;
 
@@ -130,8 +136,17 @@ class LevelDbMutationQueue : public MutationQueue {
    * NOTE: There can only be one LevelDbMutationQueue for a given db at a time,
    * hence it is safe to track next_batch_id_ as an instance-level property.
    * Should we ever relax this constraint we'll need to revisit this.
+   *
+   * `kBatchIdUnknown` until the first batch is added.
+   */
+  model::BatchId next_batch_id_ = model::kBatchIdUnknown;
+
+  /**
+   * The highest ID of the batches removed since the queue was started. Batches
+   * removed before `next_batch_id_` is loaded no longer show up in the
+   * database, so their IDs must not be reused either.
    */
-  model::BatchId next_batch_id_;
+  model::BatchId highest_removed_batch_id_ = model::kBatchIdUnknown;
 
   /**
    * A write-through cache copy of the metadata describing the current queue.
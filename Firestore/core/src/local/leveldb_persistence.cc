@@ -16,11 +16,13 @@
 
 #include "Firestore/core/src/local/leveldb_persistence.h"
 
+#include <chrono>  // NOLINT(build/c++11)
 #include <limits>
 #include <utility>
 
 #include "Firestore/core/src/core/database_info.h"
 #include "Firestore/core/src/credentials/user.h"
+#include "Firestore/core/src/local/leveldb_cache_snapshot.h"
 #include "Firestore/core/src/local/leveldb_key.h"
 #include "Firestore/core/src/local/leveldb_lru_reference_delegate.h"
 #include "Firestore/core/src/local/leveldb_migrations.h"
@@ -31,6 +33,7 @@
 #include "Firestore/core/src/local/reference_delegate.h"
 #include "Firestore/core/src/local/sizer.h"
 #include "Firestore/core/src/util/filesystem.h"
+#include "Firestore/core/src/util/defer.h"
 #include "Firestore/core/src/util/hard_assert.h"
 #include "Firestore/core/src/util/log.h"
 #include "Firestore/core/src/util/string_util.h"
@@ -45,12 +48,24 @@ namespace {
 using credentials::User;
 using leveldb::DB;
 using model::ListenSequenceNumber;
+using util::Defer;
 using util::Filesystem;
 using util::Path;
 using util::Status;
 using util::StatusOr;
 using util::StringFormat;
 
+/** A read-only transaction running on some thread. */
+struct ReadOnlyTransaction {
+  const LevelDbPersistence* persistence;
+  LevelDbTransaction* transaction;
+};
+
+// Read-only transactions may run on any thread, concurrently with each other
+// and with the read-write transaction, so each thread tracks its own.
+thread_local ReadOnlyTransaction current_read_only_transaction = {nullptr,
+                                                                  nullptr};
+
 /**
  * Finds all user ids in the database based on the existence of a mutation
  * queue.
@@ -78,6 +93,7 @@ std::set<std::string> CollectUserSet(LevelDbTransaction* transaction) {
 
 StatusOr<std::unique_ptr<LevelDbPersistence>> LevelDbPersistence::Create(
     util::Path dir, LocalSerializer serializer, const LruParams& lru_params) {
+  StartupTimings timings;
   auto* fs = Filesystem::Default();
   Status status = EnsureDirectory(dir);
   if (!status.ok()) return status;
@@ -87,30 +103,32 @@ StatusOr<std::unique_ptr<LevelDbPersistence>> LevelDbPersistence::Create(
 
   StatusOr<std::unique_ptr<DB>> created = OpenDb(dir);
   if (!created.ok()) return created.status();
+  timings.EndPhase("open");
 
   std::unique_ptr<DB> db = std::move(created).ValueOrDie();
-  LevelDbMigrations::RunMigrations(db.get(), serializer);
-
-  LevelDbTransaction transaction(db.get(), "Start LevelDB");
-  std::set<std::string> users = CollectUserSet(&transaction);
-  transaction.Commit();
+  LevelDbMigrations::RunMigrations(
+      db.get(), serializer, [](const LevelDbMigrations::Progress& progress) {
+        LOG_DEBUG("Migrating to schema version %s: %s rows processed",
+                  progress.version, progress.rows_processed);
+      });
+  timings.EndPhase("migrations");
 
   // Explicit conversion is required to allow the StatusOr to be created.
-  std::unique_ptr<LevelDbPersistence> result(
-      new LevelDbPersistence(std::move(db), std::move(dir), std::move(users),
-                             std::move(serializer), lru_params));
+  std::unique_ptr<LevelDbPersistence> result(new LevelDbPersistence(
+      std::move(db), std::move(dir), std::move(serializer), lru_params,
+      std::move(timings)));
   return {std::move(result)};
 }
 
 LevelDbPersistence::LevelDbPersistence(std::unique_ptr<leveldb::DB> db,
                                        util::Path directory,
-                                       std::set<std::string> users,
                                        LocalSerializer serializer,
-                                       const LruParams& lru_params)
+                                       const LruParams& lru_params,
+                                       StartupTimings startup_timings)
     : db_(std::move(db)),
       directory_(std::move(directory)),
-      users_(std::move(users)),
-      serializer_(std::move(serializer)) {
+      serializer_(std::move(serializer)),
+      startup_timings_(std::move(startup_timings)) {
   target_cache_ = absl::make_unique<LevelDbTargetCache>(this, &serializer_);
   document_cache_ =
       absl::make_unique<LevelDbRemoteDocumentCache>(this, &serializer_);
@@ -121,7 +139,9 @@ LevelDbPersistence::LevelDbPersistence(std::unique_ptr<leveldb::DB> db,
 
   // TODO(gsoltis): set up a leveldb transaction for these operations.
   target_cache_->Start();
+  startup_timings_.EndPhase("target cache");
   reference_delegate_->Start();
+  startup_timings_.EndPhase("reference delegate");
   started_ = true;
 }
 
@@ -161,6 +181,9 @@ StatusOr<std::unique_ptr<DB>> LevelDbPersistence::OpenDb(const Path& dir) {
 // MARK: - LevelDB utilities
 
 LevelDbTransaction* LevelDbPersistence::current_transaction() {
+  if (current_read_only_transaction.persistence == this) {
+    return current_read_only_transaction.transaction;
+  }
   HARD_ASSERT(transaction_ != nullptr,
               "Attempting to access transaction before one has started");
   return transaction_.get();
@@ -212,6 +235,23 @@ StatusOr<int64_t> LevelDbPersistence::CalculateByteSize() {
   return static_cast<int64_t>(count);
 }
 
+Status LevelDbPersistence::ExportCacheSnapshot(const Path& file) {
+  return local::ExportCacheSnapshot(db_.get(), file);
+}
+
+Status LevelDbPersistence::ImportCacheSnapshot(const Path& file) {
+  HARD_ASSERT(transaction_ == nullptr,
+              "Importing a cache snapshot while a transaction is in progress");
+
+  Status status = local::ImportCacheSnapshot(db_.get(), file);
+  if (!status.ok()) return status;
+
+  // The target metadata was replaced, so reload everything derived from it.
+  target_cache_->Start();
+  reference_delegate_->Start();
+  return Status::OK();
+}
+
 // MARK: - Persistence
 
 model::ListenSequenceNumber LevelDbPersistence::current_sequence_number()
@@ -225,6 +265,16 @@ void LevelDbPersistence::Shutdown() {
   db_.reset();
 }
 
+const std::set<std::string>& LevelDbPersistence::users() {
+  if (!users_loaded_) {
+    LevelDbTransaction transaction(db_.get(), "Collect users");
+    std::set<std::string> stored_users = CollectUserSet(&transaction);
+    users_.insert(stored_users.begin(), stored_users.end());
+    users_loaded_ = true;
+  }
+  return users_;
+}
+
 LevelDbMutationQueue* LevelDbPersistence::GetMutationQueueForUser(
     const credentials::User& user) {
   users_.insert(user.uid());
@@ -233,6 +283,12 @@ LevelDbMutationQueue* LevelDbPersistence::GetMutationQueueForUser(
   return current_mutation_queue_.get();
 }
 
+std::unique_ptr<MutationQueue> LevelDbPersistence::NewMutationQueueForReading(
+    const credentials::User& user) {
+  // The queue isn't started, because reads don't need its metadata.
+  return absl::make_unique<LevelDbMutationQueue>(user, this, &serializer_);
+}
+
 LevelDbTargetCache* LevelDbPersistence::target_cache() {
   return target_cache_.get();
 }
@@ -264,8 +320,32 @@ void LevelDbPersistence::RunInternal(absl::string_view label,
   block();
 
   reference_delegate_->OnTransactionCommitted();
-  transaction_->Commit();
+  size_t bytes_written = transaction_->Commit();
   transaction_.reset();
+
+  if (bytes_written > 0) {
+    write_stats_.bytes_written += static_cast<int64_t>(bytes_written);
+    write_stats_.last_write_time = std::chrono::steady_clock::now();
+  }
+}
+
+void LevelDbPersistence::RunReadOnlyInternal(absl::string_view label,
+                                             std::function<void()> block) {
+  HARD_ASSERT(current_read_only_transaction.persistence == nullptr,
+              "Starting a read-only transaction while one is already in "
+              "progress on this thread");
+
+  // LevelDB applies each write batch atomically, so a snapshot sees all or
+  // none of the changes of every transaction.
+  const leveldb::Snapshot* snapshot = db_->GetSnapshot();
+  Defer release([&] {
+    current_read_only_transaction = {nullptr, nullptr};
+    db_->ReleaseSnapshot(snapshot);
+  });
+
+  LevelDbTransaction transaction(db_.get(), label, snapshot);
+  current_read_only_transaction = {this, &transaction};
+  block();
 }
 
 leveldb::ReadOptions StandardReadOptions() {
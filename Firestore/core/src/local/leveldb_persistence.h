@@ -30,7 +30,9 @@
 #include "Firestore/core/src/local/leveldb_target_cache.h"
 #include "Firestore/core/src/local/leveldb_transaction.h"
 #include "Firestore/core/src/local/local_serializer.h"
+#include "Firestore/core/src/local/lru_garbage_collector.h"
 #include "Firestore/core/src/local/persistence.h"
+#include "Firestore/core/src/local/startup_timings.h"
 #include "Firestore/core/src/util/path.h"
 #include "Firestore/core/src/util/statusor.h"
 
@@ -58,20 +60,53 @@ class LevelDbPersistence : public Persistence {
 
   ~LevelDbPersistence();
 
+  /**
+   * Returns the transaction of the block that is running on this thread: a
+   * read-only one within `RunReadOnly`, otherwise the one started by `Run`.
+   */
   LevelDbTransaction* current_transaction();
 
   leveldb::DB* ptr() {
     return db_.get();
   }
 
-  const std::set<std::string> users() const {
-    return users_;
+  /**
+   * Returns the IDs of all users that have a mutation queue. The database is
+   * only scanned for them when they are first needed, which is not until
+   * garbage collection runs.
+   */
+  const std::set<std::string>& users();
+
+  /** Returns how long each phase of opening the database took. */
+  const StartupTimings& startup_timings() const {
+    return startup_timings_;
   }
 
   static util::Status ClearPersistence(const core::DatabaseInfo& database_info);
 
   util::StatusOr<int64_t> CalculateByteSize();
 
+  /**
+   * Writes the remote documents, targets and collection parents in the cache
+   * to a new cache snapshot at `file`. See leveldb_cache_snapshot.h.
+   */
+  util::Status ExportCacheSnapshot(const util::Path& file);
+
+  /**
+   * Seeds the cache with the contents of the cache snapshot at `file`. Fails
+   * if the cache already contains targets or remote documents.
+   *
+   * Must not be called while a transaction is running. A LocalStore that was
+   * already started on this persistence must be told about the import with
+   * `LocalStore::HandleCacheSnapshotImport`.
+   */
+  util::Status ImportCacheSnapshot(const util::Path& file);
+
+  /** Returns how much was written by the transactions run so far. */
+  const CacheWriteStats& write_stats() const {
+    return write_stats_;
+  }
+
   // MARK: Persistence overrides
 
   model::ListenSequenceNumber current_sequence_number() const override;
@@ -83,6 +118,9 @@ class LevelDbPersistence : public Persistence {
   LevelDbMutationQueue* GetMutationQueueForUser(
       const credentials::User& user) override;
 
+  std::unique_ptr<MutationQueue> NewMutationQueueForReading(
+      const credentials::User& user) override;
+
   LevelDbTargetCache* target_cache() override;
 
   LevelDbRemoteDocumentCache* remote_document_cache() override;
@@ -95,12 +133,15 @@ class LevelDbPersistence : public Persistence {
   void RunInternal(absl::string_view label,
                    std::function<void()> block) override;
 
+  void RunReadOnlyInternal(absl::string_view label,
+                           std::function<void()> block) override;
+
  private:
   LevelDbPersistence(std::unique_ptr<leveldb::DB> db,
                      util::Path directory,
-                     std::set<std::string> users,
                      LocalSerializer serializer,
-                     const LruParams& lru_params);
+                     const LruParams& lru_params,
+                     StartupTimings startup_timings);
 
   /**
    * Ensures that the given directory exists.
@@ -115,7 +156,9 @@ class LevelDbPersistence : public Persistence {
 
   util::Path directory_;
   std::set<std::string> users_;
+  bool users_loaded_ = false;
   LocalSerializer serializer_;
+  StartupTimings startup_timings_;
   bool started_ = false;
 
   std::unique_ptr<LevelDbBundleCache> bundle_cache_;
@@ -126,6 +169,7 @@ class LevelDbPersistence : public Persistence {
   std::unique_ptr<LevelDbLruReferenceDelegate> reference_delegate_;
 
   std::unique_ptr<LevelDbTransaction> transaction_;
+  CacheWriteStats write_stats_;
 };
 
 /** Returns a standard set of read options. */
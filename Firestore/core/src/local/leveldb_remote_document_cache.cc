@@ -25,6 +25,7 @@
 #include "Firestore/core/src/local/leveldb_key.h"
 #include "Firestore/core/src/local/leveldb_persistence.h"
 #include "Firestore/core/src/local/local_serializer.h"
+#include "Firestore/core/src/local/query_profile.h"
 #include "Firestore/core/src/model/document_key_set.h"
 #include "Firestore/core/src/model/mutable_document.h"
 #include "Firestore/core/src/nanopb/message.h"
@@ -105,18 +106,16 @@ LevelDbRemoteDocumentCache::~LevelDbRemoteDocumentCache() = default;
 void LevelDbRemoteDocumentCache::Add(const MutableDocument& document,
                                      const SnapshotVersion& read_time) {
   const DocumentKey& key = document.key();
-  const ResourcePath& path = key.path();
 
   std::string ldb_document_key = LevelDbRemoteDocumentKey::Key(key);
   db_->current_transaction()->Put(ldb_document_key,
                                   serializer_->EncodeMaybeDocument(document));
 
   std::string ldb_read_time_key = LevelDbRemoteDocumentReadTimeKey::Key(
-      path.PopLast(), read_time, path.last_segment());
+      key.collection_path(), read_time, key.document_id());
   db_->current_transaction()->Put(ldb_read_time_key, "");
 
-  db_->index_manager()->AddToCollectionParentIndex(
-      document.key().path().PopLast());
+  db_->index_manager()->AddToCollectionParentIndex(key.collection_path());
 }
 
 void LevelDbRemoteDocumentCache::Remove(const DocumentKey& key) {
@@ -129,8 +128,10 @@ MutableDocument LevelDbRemoteDocumentCache::Get(const DocumentKey& key) {
   std::string value;
   Status status = db_->current_transaction()->Get(ldb_key, &value);
   if (status.IsNotFound()) {
+    QueryProfile::CountDocuments(1, 0);
     return MutableDocument::InvalidDocument(key);
   } else if (status.ok()) {
+    QueryProfile::CountDocuments(1, 1);
     return DecodeMaybeDocument(value, key);
   } else {
     HARD_FAIL("Fetch document for key (%s) failed with status: %s",
@@ -145,6 +146,7 @@ MutableDocumentMap LevelDbRemoteDocumentCache::GetAll(
 
   LevelDbRemoteDocumentKey current_key;
   auto it = db_->current_transaction()->NewIterator();
+  size_t decoded = 0;
 
   for (const DocumentKey& key : keys) {
     it->Seek(LevelDbRemoteDocumentKey::Key(key));
@@ -154,6 +156,7 @@ MutableDocumentMap LevelDbRemoteDocumentCache::GetAll(
           std::make_pair(key, MutableDocument::InvalidDocument(key)));
     } else {
       const std::string& contents = it->value();
+      ++decoded;
       tasks.Execute([this, &results, &key, contents] {
         results.Insert(std::make_pair(key, DecodeMaybeDocument(contents, key)));
       });
@@ -161,6 +164,7 @@ MutableDocumentMap LevelDbRemoteDocumentCache::GetAll(
   }
 
   tasks.AwaitAll();
+  QueryProfile::CountDocuments(keys.size(), decoded);
 
   MutableDocumentMap map;
   for (const auto& entry : results.Result()) {
@@ -169,101 +173,162 @@ MutableDocumentMap LevelDbRemoteDocumentCache::GetAll(
   return map;
 }
 
-MutableDocumentMap LevelDbRemoteDocumentCache::GetAllExisting(
-    const DocumentKeySet& keys) {
-  MutableDocumentMap docs = LevelDbRemoteDocumentCache::GetAll(keys);
-  MutableDocumentMap result;
-  for (const auto& kv : docs) {
-    const DocumentKey& key = kv.first;
-    auto& document = kv.second;
-    if (document.is_found_document()) {
-      result = result.insert(key, document);
-    }
-  }
-
-  return result;
-}
-
 MutableDocumentMap LevelDbRemoteDocumentCache::GetMatching(
     const Query& query, const SnapshotVersion& since_read_time) {
   HARD_ASSERT(
       !query.IsCollectionGroupQuery(),
       "CollectionGroup queries should be handled in LocalDocumentsView");
 
-  // Use the query path as a prefix for testing if a document matches the query.
-  const ResourcePath& query_path = query.path();
-  size_t immediate_children_path_length = query_path.size() + 1;
-
-  if (since_read_time != SnapshotVersion::None()) {
-    // Execute an index-free query and filter by read time. This is safe since
-    // all document changes to queries that have a
-    // last_limbo_free_snapshot_version (`since_read_time`) have a read time
-    // set.
-    std::string start_key = LevelDbRemoteDocumentReadTimeKey::KeyPrefix(
-        query_path, since_read_time);
-    auto it = db_->current_transaction()->NewIterator();
-    it->Seek(util::ImmediateSuccessor(start_key));
-
-    DocumentKeySet remote_keys;
-
-    LevelDbRemoteDocumentReadTimeKey current_key;
-    for (; it->Valid() && current_key.Decode(it->key()); it->Next()) {
-      const ResourcePath& collection_path = current_key.collection_path();
-      if (collection_path != query_path) {
-        break;
-      }
+  return ScanCollections({query.path()}, since_read_time)[0];
+}
+
+std::vector<MutableDocumentMap>
+LevelDbRemoteDocumentCache::GetMatchingCollectionGroup(
+    const Query& query,
+    const std::vector<ResourcePath>& collections,
+    const SnapshotVersion& since_read_time) {
+  HARD_ASSERT(query.IsCollectionGroupQuery(),
+              "GetMatchingCollectionGroup requires a collection group query");
+
+  return ScanCollections(collections, since_read_time);
+}
 
-      const SnapshotVersion& read_time = current_key.read_time();
-      if (read_time > since_read_time) {
-        DocumentKey document_key(query_path.Append(current_key.document_id()));
-        remote_keys = remote_keys.insert(document_key);
+std::vector<MutableDocumentMap> LevelDbRemoteDocumentCache::ScanCollections(
+    const std::vector<ResourcePath>& collections,
+    const SnapshotVersion& since_read_time) {
+  BackgroundQueue tasks(executor_.get());
+  AsyncResults<std::pair<size_t, MutableDocument>> results;
+  size_t scanned = 0;
+  size_t decoded = 0;
+
+  // Decodes the given contents on the query executor, attributing the result
+  // to the collection at `index`.
+  auto decode = [&](size_t index, DocumentKey document_key,
+                    std::string contents) {
+    ++decoded;
+    tasks.Execute([this, &results, index, document_key, contents] {
+      MutableDocument document = DecodeMaybeDocument(contents, document_key);
+      if (document.is_found_document()) {
+        results.Insert(std::make_pair(index, std::move(document)));
       }
-    }
+    });
+  };
 
-    return LevelDbRemoteDocumentCache::GetAllExisting(remote_keys);
-  } else {
-    BackgroundQueue tasks(executor_.get());
-    AsyncResults<MutableDocument> results;
+  auto it = db_->current_transaction()->NewIterator();
 
-    // Documents are ordered by key, so we can use a prefix scan to narrow down
-    // the documents we need to match the query against.
-    std::string start_key = LevelDbRemoteDocumentKey::KeyPrefix(query_path);
-    auto it = db_->current_transaction()->NewIterator();
-    it->Seek(start_key);
+  for (size_t index = 0; index != collections.size(); ++index) {
+    // Use the collection path as a prefix for testing if a document belongs
+    // to the collection.
+    const ResourcePath& query_path = collections[index];
+    size_t immediate_children_path_length = query_path.size() + 1;
+
+    if (since_read_time != SnapshotVersion::None()) {
+      // Execute an index-free query and filter by read time. This is safe
+      // since all document changes to queries that have a
+      // last_limbo_free_snapshot_version (`since_read_time`) have a read time
+      // set.
+      std::string start_key = LevelDbRemoteDocumentReadTimeKey::KeyPrefix(
+          query_path, since_read_time);
+      auto read_time_it = db_->current_transaction()->NewIterator();
+      read_time_it->Seek(util::ImmediateSuccessor(start_key));
+
+      LevelDbRemoteDocumentReadTimeKey read_time_key;
+      LevelDbRemoteDocumentKey current_key;
+      for (; read_time_it->Valid() && read_time_key.Decode(read_time_it->key());
+           read_time_it->Next()) {
+        if (read_time_key.collection_path() != query_path) {
+          break;
+        }
+        ++scanned;
 
-    LevelDbRemoteDocumentKey current_key;
-    for (; it->Valid() && current_key.Decode(it->key()); it->Next()) {
-      // The query is actually returning any path that starts with the query
-      // path prefix which may include documents in subcollections. For example,
-      // a query on 'rooms' will return rooms/abc/messages/xyx but we shouldn't
-      // match it. Fix this by discarding rows with document keys more than one
-      // segment longer than the query path.
-      const DocumentKey& document_key = current_key.document_key();
-      if (document_key.path().size() != immediate_children_path_length) {
-        continue;
-      }
+        if (read_time_key.read_time() <= since_read_time) {
+          continue;
+        }
 
-      if (!query_path.IsPrefixOf(document_key.path())) {
-        break;
+        DocumentKey document_key(
+            query_path.Append(read_time_key.document_id()));
+        it->Seek(LevelDbRemoteDocumentKey::Key(document_key));
+        if (it->Valid() && current_key.Decode(it->key()) &&
+            current_key.document_key() == document_key) {
+          decode(index, std::move(document_key), it->value());
+        }
       }
+    } else {
+      // Documents are ordered by key, so we can use a prefix scan to narrow
+      // down the documents we need to match the query against.
+      std::string start_key = LevelDbRemoteDocumentKey::KeyPrefix(query_path);
+      it->Seek(start_key);
+
+      LevelDbRemoteDocumentKey current_key;
+      for (; it->Valid() && current_key.Decode(it->key()); it->Next()) {
+        ++scanned;
+
+        // The query is actually returning any path that starts with the query
+        // path prefix which may include documents in subcollections. For
+        // example, a query on 'rooms' will return rooms/abc/messages/xyx but
+        // we shouldn't match it. Fix this by discarding rows with document
+        // keys more than one segment longer than the query path.
+        const DocumentKey& document_key = current_key.document_key();
+        const ResourcePath& collection_path = document_key.collection_path();
+        if (collection_path.size() + 1 != immediate_children_path_length) {
+          continue;
+        }
 
-      const std::string& contents = it->value();
-      tasks.Execute([this, &results, document_key, contents] {
-        MutableDocument document = DecodeMaybeDocument(contents, document_key);
-        if (document.is_found_document()) {
-          results.Insert(document);
+        if (!query_path.IsPrefixOf(collection_path)) {
+          break;
         }
-      });
+
+        decode(index, document_key, it->value());
+      }
     }
+  }
+
+  tasks.AwaitAll();
+  QueryProfile::CountDocuments(scanned, decoded);
+
+  std::vector<MutableDocumentMap> maps(collections.size());
+  for (auto& entry : results.Result()) {
+    MutableDocumentMap& map = maps[entry.first];
+    map = map.insert(entry.second.key(), entry.second);
+  }
+  return maps;
+}
+
+MutableDocumentMap LevelDbRemoteDocumentCache::GetPage(
+    const ResourcePath& collection,
+    const DocumentKey& start_after,
+    size_t limit) {
+  MutableDocumentMap results;
+  if (limit == 0) return results;
 
-    tasks.AwaitAll();
+  auto it = db_->current_transaction()->NewIterator();
+  if (start_after.empty()) {
+    it->Seek(LevelDbRemoteDocumentKey::KeyPrefix(collection));
+  } else {
+    std::string start_key = LevelDbRemoteDocumentKey::Key(start_after);
+    it->Seek(start_key);
+    if (it->Valid() && it->key() == start_key) it->Next();
+  }
 
-    MutableDocumentMap map;
-    for (const MutableDocument& doc : results.Result()) {
-      map = map.insert(doc.key(), doc);
+  // Like the prefix scan in `ScanCollections`, this skips over the documents
+  // of subcollections, which sort right after their parent document.
+  LevelDbRemoteDocumentKey current_key;
+  for (; it->Valid() && current_key.Decode(it->key()); it->Next()) {
+    const DocumentKey& document_key = current_key.document_key();
+    const ResourcePath& collection_path = document_key.collection_path();
+    if (collection_path.size() != collection.size()) {
+      if (!collection.IsPrefixOf(collection_path)) break;
+      continue;
     }
-    return map;
+    if (collection_path != collection) break;
+
+    MutableDocument document = DecodeMaybeDocument(it->value(), document_key);
+    if (!document.is_found_document()) continue;
+
+    results = results.insert(document_key, std::move(document));
+    if (results.size() == limit) break;
   }
+  return results;
 }
 
 MutableDocument LevelDbRemoteDocumentCache::DecodeMaybeDocument(
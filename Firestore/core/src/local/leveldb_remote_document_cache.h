@@ -54,13 +54,28 @@ class LevelDbRemoteDocumentCache : public RemoteDocumentCache {
   model::MutableDocumentMap GetMatching(
       const core::Query& query,
       const model::SnapshotVersion& since_read_time) override;
+  std::vector<model::MutableDocumentMap> GetMatchingCollectionGroup(
+      const core::Query& query,
+      const std::vector<model::ResourcePath>& collections,
+      const model::SnapshotVersion& since_read_time) override;
+
+  model::MutableDocumentMap GetPage(const model::ResourcePath& collection,
+                                    const model::DocumentKey& start_after,
+                                    size_t limit) override;
 
  private:
   /**
-   * Looks up a set of entries in the cache, returning only existing entries of
-   * Type::Document.
+   * Scans the immediate children of each of the given collections, returning
+   * only existing entries of Type::Document, in the same order as
+   * `collections`.
+   *
+   * The scans themselves run on the calling thread, but documents are decoded
+   * concurrently on the query executor, with a single wait for all
+   * collections.
    */
-  model::MutableDocumentMap GetAllExisting(const model::DocumentKeySet& keys);
+  std::vector<model::MutableDocumentMap> ScanCollections(
+      const std::vector<model::ResourcePath>& collections,
+      const model::SnapshotVersion& since_read_time);
 
   model::MutableDocument DecodeMaybeDocument(absl::string_view encoded,
                                              const model::DocumentKey& key);
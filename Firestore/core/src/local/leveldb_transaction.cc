@@ -17,6 +17,7 @@
 #include "Firestore/core/src/local/leveldb_transaction.h"
 
 #include "Firestore/core/src/local/leveldb_key.h"
+#include "Firestore/core/src/local/leveldb_util.h"
 #include "Firestore/core/src/util/hard_assert.h"
 #include "Firestore/core/src/util/log.h"
 #include "absl/memory/memory.h"
@@ -38,7 +39,7 @@ LevelDbTransaction::Iterator::Iterator(LevelDbTransaction* txn)
     : db_iter_(txn->db_->NewIterator(txn->read_options_)),
       last_version_(txn->version_),
       txn_(txn),
-      mutations_iter_(txn->mutations_.begin()),
+      changes_iter_(txn->changes_.begin()),
       current_(),
       is_mutation_(false),
       // Iterator doesn't really point to anything yet, so is
@@ -47,26 +48,41 @@ LevelDbTransaction::Iterator::Iterator(LevelDbTransaction* txn)
 }
 
 void LevelDbTransaction::Iterator::UpdateCurrent() {
-  bool mutation_is_valid = mutations_iter_ != txn_->mutations_.end();
-  is_valid_ = mutation_is_valid || db_iter_->Valid();
+  while (true) {
+    bool change_is_valid = changes_iter_ != txn_->changes_.end();
+    is_valid_ = change_is_valid || db_iter_->Valid();
+    if (!is_valid_) return;
 
-  if (is_valid_) {
-    if (!mutation_is_valid) {
+    if (!change_is_valid) {
       is_mutation_ = false;
     } else if (!db_iter_->Valid()) {
       is_mutation_ = true;
     } else {
       // Both iterators are valid. If the leveldb key is equal to or greater
-      // than the current mutation key, we are looking at a mutation next. It's
+      // than the current change key, we are looking at a change next. It's
       // either sooner in the iteration or directly shadowing the underlying
       // committed value in leveldb.
-      is_mutation_ = db_iter_->key().compare(mutations_iter_->first) >= 0;
+      is_mutation_ =
+          db_iter_->key().compare(MakeSlice(changes_iter_->first)) >= 0;
     }
-    if (is_mutation_) {
-      current_ = *mutations_iter_;
-    } else {
+
+    if (!is_mutation_) {
       current_ = {db_iter_->key().ToString(), db_iter_->value().ToString()};
+      return;
+    }
+
+    const Change& change = changes_iter_->second;
+    if (!change.deleted) {
+      current_ = {std::string(changes_iter_->first), std::string(change.value)};
+      return;
     }
+
+    // A deletion hides the committed value it shadows, if any.
+    if (db_iter_->Valid() &&
+        db_iter_->key() == MakeSlice(changes_iter_->first)) {
+      AdvanceLDB();
+    }
+    ++changes_iter_;
   }
 }
 
@@ -74,11 +90,7 @@ void LevelDbTransaction::Iterator::Seek(const std::string& key) {
   db_iter_->Seek(key);
   HARD_ASSERT(db_iter_->status().ok(), "leveldb iterator reported an error: %s",
               db_iter_->status().ToString());
-  for (; db_iter_->Valid() && IsDeleted(db_iter_->key()); db_iter_->Next()) {
-  }
-  HARD_ASSERT(db_iter_->status().ok(), "leveldb iterator reported an error: %s",
-              db_iter_->status().ToString());
-  mutations_iter_ = txn_->mutations_.lower_bound(key);
+  changes_iter_ = txn_->changes_.lower_bound(key);
   UpdateCurrent();
   last_version_ = txn_->version_;
 }
@@ -93,10 +105,6 @@ const std::string& LevelDbTransaction::Iterator::value() const {
   return current_.second;
 }
 
-bool LevelDbTransaction::Iterator::IsDeleted(leveldb::Slice slice) {
-  return txn_->deletions_.find(slice.ToString()) != txn_->deletions_.end();
-}
-
 bool LevelDbTransaction::Iterator::SyncToTransaction() {
   if (last_version_ < txn_->version_) {
     // Intentionally copying here since Seek() may update current_. We need the
@@ -111,9 +119,7 @@ bool LevelDbTransaction::Iterator::SyncToTransaction() {
 }
 
 void LevelDbTransaction::Iterator::AdvanceLDB() {
-  do {
-    db_iter_->Next();
-  } while (db_iter_->Valid() && IsDeleted(db_iter_->key()));
+  db_iter_->Next();
   HARD_ASSERT(db_iter_->status().ok(), "leveldb iterator reported an error: %s",
               db_iter_->status().ToString());
 }
@@ -123,11 +129,12 @@ void LevelDbTransaction::Iterator::Next() {
   bool advanced = SyncToTransaction();
   if (!advanced && is_valid_) {
     if (is_mutation_) {
-      // A mutation might be shadowing leveldb. If so, advance both.
-      if (db_iter_->Valid() && db_iter_->key() == mutations_iter_->first) {
+      // A change might be shadowing leveldb. If so, advance both.
+      if (db_iter_->Valid() &&
+          db_iter_->key() == MakeSlice(changes_iter_->first)) {
         AdvanceLDB();
       }
-      ++mutations_iter_;
+      ++changes_iter_;
     } else {
       AdvanceLDB();
     }
@@ -140,11 +147,20 @@ LevelDbTransaction::LevelDbTransaction(DB* db,
                                        const ReadOptions& read_options,
                                        const WriteOptions& write_options)
     : db_(NOT_NULL(db)),
+      changes_(Changes::allocator_type(&arena_)),
       read_options_(read_options),
       write_options_(write_options),
       label_(label) {
 }
 
+LevelDbTransaction::LevelDbTransaction(DB* db,
+                                       absl::string_view label,
+                                       const leveldb::Snapshot* snapshot)
+    : LevelDbTransaction(db, label) {
+  read_options_.snapshot = NOT_NULL(snapshot);
+  read_only_ = true;
+}
+
 const ReadOptions& LevelDbTransaction::DefaultReadOptions() {
   // ReadOptions is trivial so it does not need to be heap-allocated.
   static ReadOptions options = [] {
@@ -161,9 +177,21 @@ const WriteOptions& LevelDbTransaction::DefaultWriteOptions() {
   return options;
 }
 
-void LevelDbTransaction::Put(std::string key, std::string value) {
-  deletions_.erase(key);
-  mutations_[std::move(key)] = std::move(value);
+void LevelDbTransaction::Put(absl::string_view key, absl::string_view value) {
+  SetChange(key, Change{arena_.CopyString(value), false});
+}
+
+void LevelDbTransaction::SetChange(absl::string_view key, Change change) {
+  HARD_ASSERT(!read_only_, "Write to %s in read-only transaction %s",
+              DescribeKey(key), label_);
+
+  auto iter = changes_.lower_bound(key);
+  if (iter != changes_.end() && iter->first == key) {
+    // The previous value stays in the arena until the transaction ends.
+    iter->second = change;
+  } else {
+    changes_.emplace_hint(iter, arena_.CopyString(key), change);
+  }
   version_++;
 }
 
@@ -173,35 +201,36 @@ LevelDbTransaction::NewIterator() {
 }
 
 Status LevelDbTransaction::Get(absl::string_view key, std::string* value) {
-  std::string key_string(key);
-  if (deletions_.find(key_string) != deletions_.end()) {
-    return Status::NotFound(key_string + " is not present in the transaction");
-  } else {
-    Mutations::iterator iter{mutations_.find(key_string)};
-    if (iter != mutations_.end()) {
-      *value = iter->second;
-      return Status::OK();
-    } else {
-      return db_->Get(read_options_, key_string, value);
-    }
+  auto iter = changes_.find(key);
+  if (iter == changes_.end()) {
+    return db_->Get(read_options_, MakeSlice(key), value);
+  }
+
+  const Change& change = iter->second;
+  if (change.deleted) {
+    return Status::NotFound(
+        absl::StrCat(key, " is not present in the transaction"));
   }
+  value->assign(change.value.data(), change.value.size());
+  return Status::OK();
 }
 
 void LevelDbTransaction::Delete(absl::string_view key) {
-  std::string to_delete(key);
-  deletions_.insert(to_delete);
-  mutations_.erase(to_delete);
-  version_++;
+  SetChange(key, Change{absl::string_view(), true});
 }
 
-void LevelDbTransaction::Commit() {
-  WriteBatch batch;
-  for (const auto& deletion : deletions_) {
-    batch.Delete(deletion);
-  }
+size_t LevelDbTransaction::Commit() {
+  HARD_ASSERT(!read_only_, "Read-only transaction %s can't be committed",
+              label_);
+  if (changes_.empty()) return 0;
 
-  for (const auto& entry : mutations_) {
-    batch.Put(entry.first, entry.second);
+  WriteBatch batch;
+  for (const auto& entry : changes_) {
+    if (entry.second.deleted) {
+      batch.Delete(MakeSlice(entry.first));
+    } else {
+      batch.Put(MakeSlice(entry.first), MakeSlice(entry.second.value));
+    }
   }
 
   LOG_DEBUG("Committing transaction: %s", ToString());
@@ -209,19 +238,24 @@ void LevelDbTransaction::Commit() {
   Status status = db_->Write(write_options_, &batch);
   HARD_ASSERT(status.ok(), "Failed to commit transaction:\n%s\n Failed: %s",
               ToString(), status.ToString());
+  return batch.ApproximateSize();
 }
 
 std::string LevelDbTransaction::ToString() {
   std::string dest = absl::StrCat("<LevelDbTransaction ", label_, ": ");
-  size_t changes = deletions_.size() + mutations_.size();
+  size_t changes = changes_.size();
   size_t bytes = 0;  // accumulator for size of individual mutations.
   dest += std::to_string(changes) + " changes ";
   std::string items;  // accumulator for individual changes.
-  for (const auto& deletion : deletions_) {
-    absl::StrAppend(&items, "\n  - Delete ", DescribeKey(deletion));
+  for (const auto& entry : changes_) {
+    if (entry.second.deleted) {
+      absl::StrAppend(&items, "\n  - Delete ", DescribeKey(entry.first));
+    }
   }
-  for (const auto& entry : mutations_) {
-    size_t change_bytes = entry.second.size();
+  for (const auto& entry : changes_) {
+    if (entry.second.deleted) continue;
+
+    size_t change_bytes = entry.second.value.size();
     bytes += change_bytes;
     absl::StrAppend(&items, "\n  - Put ", DescribeKey(entry.first), " (",
                     change_bytes, " bytes)");
@@ -18,15 +18,16 @@
 #define FIRESTORE_CORE_SRC_LOCAL_LEVELDB_TRANSACTION_H_
 
 #include <cstdint>
+#include <functional>
 #include <map>
 #include <memory>
-#include <set>
 #include <string>
 #include <utility>
 
 #include "Firestore/core/src/nanopb/byte_string.h"
 #include "Firestore/core/src/nanopb/message.h"
 #include "Firestore/core/src/nanopb/writer.h"
+#include "Firestore/core/src/util/arena.h"
 #include "absl/strings/string_view.h"
 #include "leveldb/db.h"
 
@@ -38,10 +39,23 @@ namespace local {
  * LevelDBTransaction tracks pending changes to entries in leveldb, including
  * deletions. It also provides an Iterator to traverse a merged view of pending
  * changes and committed values.
+ *
+ * Pending changes are kept sorted by key, with deletions recorded as
+ * tombstones. The keys, values and map nodes all live in an arena owned by the
+ * transaction, so large transactions don't allocate for every row they touch.
  */
 class LevelDbTransaction {
-  using Deletions = std::set<std::string>;
-  using Mutations = std::map<std::string, std::string>;
+  /** A pending change to a row: either a new value or a deletion. */
+  struct Change {
+    absl::string_view value;
+    bool deleted;
+  };
+
+  using Changes = std::map<
+      absl::string_view,
+      Change,
+      std::less<absl::string_view>,
+      util::ArenaAllocator<std::pair<const absl::string_view, Change>>>;
 
  public:
   /**
@@ -82,16 +96,10 @@ class LevelDbTransaction {
 
    private:
     /**
-     * Advances to the next non-deleted key in leveldb.
+     * Advances to the next key in leveldb.
      */
     void AdvanceLDB();
 
-    /**
-     * Returns true if the given slice matches a key present in the deletions_
-     * set.
-     */
-    bool IsDeleted(leveldb::Slice slice);
-
     /**
      * Syncs with the underlying transaction. If the transaction has been
      * updated, the mutation iterator may need to be reset. Returns true if this
@@ -102,7 +110,8 @@ class LevelDbTransaction {
 
     /**
      * Given the current state of the internal iterators, set is_valid_,
-     * is_mutation_, and current_.
+     * is_mutation_, and current_. Skips past pending deletions, along with the
+     * committed values they hide.
      */
     void UpdateCurrent();
 
@@ -112,12 +121,12 @@ class LevelDbTransaction {
     int32_t last_version_;
     // The underlying transaction.
     LevelDbTransaction* txn_;
-    Mutations::iterator mutations_iter_;
+    Changes::iterator changes_iter_;
     // We save the current key and value so that once an iterator is Valid(), it
     // remains so at least until the next call to Seek() or Next(), even if the
     // underlying data is deleted.
     std::pair<std::string, std::string> current_;
-    // True if current_ represents an entry in the mutations_ map, rather than
+    // True if current_ represents an entry in the changes_ map, rather than
     // committed data.
     bool is_mutation_;
     // True if the iterator pointed to a valid entry the last time Next() or
@@ -131,6 +140,14 @@ class LevelDbTransaction {
       const leveldb::ReadOptions& read_options = DefaultReadOptions(),
       const leveldb::WriteOptions& write_options = DefaultWriteOptions());
 
+  /**
+   * Creates a transaction that reads the given snapshot of `db`. Writing to it
+   * is an error, and it doesn't need to be committed.
+   */
+  LevelDbTransaction(leveldb::DB* db,
+                     absl::string_view label,
+                     const leveldb::Snapshot* snapshot);
+
   LevelDbTransaction(const LevelDbTransaction& other) = delete;
 
   LevelDbTransaction& operator=(const LevelDbTransaction& other) = delete;
@@ -146,7 +163,7 @@ class LevelDbTransaction {
   static const leveldb::WriteOptions& DefaultWriteOptions();
 
   size_t changed_keys() const {
-    return mutations_.size() + deletions_.size();
+    return changes_.size();
   }
 
   /**
@@ -159,15 +176,15 @@ class LevelDbTransaction {
    * Schedules the row identified by `key` to be set to `value` when this
    * transaction commits.
    */
-  void Put(std::string key, std::string value);
+  void Put(absl::string_view key, absl::string_view value);
 
   /**
    * Schedules the row identified by `key` to be set to the given protocol
    * buffer message when this transaction commits.
    */
   template <typename T>
-  void Put(std::string key, const nanopb::Message<T>& message) {
-    Put(std::move(key), MakeStdString(message));
+  void Put(absl::string_view key, const nanopb::Message<T>& message) {
+    Put(key, MakeStdString(message));
   }
 
   /**
@@ -187,19 +204,31 @@ class LevelDbTransaction {
   /**
    * Commits the transaction. All pending changes are written. The transaction
    * should not be used after calling this method.
+   *
+   * @return The approximate number of bytes written, or zero if there were no
+   *     changes to write.
    */
-  void Commit();
+  size_t Commit();
 
   std::string ToString();
 
+  /** Returns the number of bytes allocated to hold the pending changes. */
+  size_t memory_usage() const {
+    return arena_.memory_usage();
+  }
+
  private:
+  void SetChange(absl::string_view key, Change change);
+
   leveldb::DB* db_ = nullptr;
-  Mutations mutations_;
-  Deletions deletions_;
+  // Holds the keys and values of changes_, so it must be declared first.
+  util::Arena arena_;
+  Changes changes_;
   leveldb::ReadOptions read_options_;
   leveldb::WriteOptions write_options_;
   int32_t version_ = 0;
   std::string label_;
+  bool read_only_ = false;
 };
 
 /**
@@ -16,12 +16,15 @@
 
 #include "Firestore/core/src/local/local_documents_view.h"
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "Firestore/core/src/core/query.h"
 #include "Firestore/core/src/local/mutation_queue.h"
+#include "Firestore/core/src/local/query_profile.h"
 #include "Firestore/core/src/local/remote_document_cache.h"
 #include "Firestore/core/src/model/document.h"
 #include "Firestore/core/src/model/document_key.h"
@@ -48,18 +51,67 @@ using model::MutationBatch;
 using model::ResourcePath;
 using model::SnapshotVersion;
 
+namespace {
+
+/**
+ * Returns true if the document identified by `key` is an immediate child of the
+ * collection queried by `query`, or of any collection in its group.
+ */
+bool BelongsToQueriedCollection(const Query& query, const DocumentKey& key) {
+  if (query.IsCollectionGroupQuery()) {
+    return key.HasCollectionId(*query.collection_group());
+  }
+  return query.path() == key.collection_path();
+}
+
+/**
+ * Combines maps with disjoint keys into a single map, adding the entries of the
+ * smaller maps to the largest one.
+ */
+MutableDocumentMap MergeByKey(std::vector<MutableDocumentMap> maps) {
+  if (maps.empty()) {
+    return MutableDocumentMap{};
+  }
+
+  auto largest = std::max_element(
+      maps.begin(), maps.end(),
+      [](const MutableDocumentMap& lhs, const MutableDocumentMap& rhs) {
+        return lhs.size() < rhs.size();
+      });
+  MutableDocumentMap result = std::move(*largest);
+  for (auto it = maps.begin(); it != maps.end(); ++it) {
+    if (it == largest) continue;
+    for (const auto& kv : *it) {
+      result = result.insert(kv.first, kv.second);
+    }
+  }
+  return result;
+}
+
+}  // namespace
+
 const Document LocalDocumentsView::GetDocument(const DocumentKey& key) {
-  std::vector<MutationBatch> batches =
-      mutation_queue_->AllMutationBatchesAffectingDocumentKey(key);
+  std::vector<MutationBatch> batches;
+  {
+    QueryPhaseTimer timer(&QueryProfile::apply_mutations_time);
+    batches = mutation_queue_->AllMutationBatchesAffectingDocumentKey(key);
+  }
   return GetDocument(key, batches);
 }
 
 Document LocalDocumentsView::GetDocument(
     const DocumentKey& key, const std::vector<MutationBatch>& batches) {
-  MutableDocument document = remote_document_cache_->Get(key);
+  MutableDocument document;
+  {
+    QueryPhaseTimer timer(&QueryProfile::read_documents_time);
+    document = remote_document_cache_->Get(key);
+  }
+
+  QueryPhaseTimer timer(&QueryProfile::apply_mutations_time);
   for (const MutationBatch& batch : batches) {
     batch.ApplyToLocalDocument(document);
   }
+  QueryProfile::CountMutationBatches(batches.size());
   return Document{std::move(document)};
 }
 
@@ -73,16 +125,22 @@ DocumentMap LocalDocumentsView::ApplyLocalMutationsToDocuments(
     }
     results = results.insert(kv.first, std::move(local_view));
   }
+  QueryProfile::CountMutationBatches(batches.size());
   return results;
 }
 
 DocumentMap LocalDocumentsView::GetDocuments(const DocumentKeySet& keys) {
-  MutableDocumentMap docs = remote_document_cache_->GetAll(keys);
+  MutableDocumentMap docs;
+  {
+    QueryPhaseTimer timer(&QueryProfile::read_documents_time);
+    docs = remote_document_cache_->GetAll(keys);
+  }
   return GetLocalViewOfDocuments(std::move(docs));
 }
 
 DocumentMap LocalDocumentsView::GetLocalViewOfDocuments(
     MutableDocumentMap docs) {
+  QueryPhaseTimer timer(&QueryProfile::apply_mutations_time);
   DocumentKeySet all_keys;
   for (const auto& kv : docs) {
     all_keys = all_keys.insert(kv.first);
@@ -121,55 +179,90 @@ model::DocumentMap LocalDocumentsView::GetDocumentsMatchingCollectionGroupQuery(
       "Currently we only support collection group queries at the root.");
 
   const std::string& collection_id = *query.collection_group();
-  std::vector<ResourcePath> parents =
-      index_manager_->GetCollectionParents(collection_id);
-  DocumentMap results;
+  std::vector<ResourcePath> collections;
+  for (const ResourcePath& parent :
+       index_manager_->GetCollectionParents(collection_id)) {
+    collections.push_back(parent.Append(collection_id));
+  }
 
-  // Perform a collection query against each parent that contains the
-  // collection_id and aggregate the results.
-  for (const ResourcePath& parent : parents) {
-    Query collection_query =
-        query.AsCollectionQueryAtPath(parent.Append(collection_id));
-    DocumentMap collection_results =
-        GetDocumentsMatchingCollectionQuery(collection_query, since_read_time);
-    for (const auto& kv : collection_results) {
-      const DocumentKey& key = kv.first;
-      results = results.insert(key, Document(kv.second));
-    }
+  // Scan every collection in the group at once, letting the cache process them
+  // concurrently, and combine the per-collection results, each of which is
+  // already ordered by key.
+  MutableDocumentMap remote_documents;
+  {
+    QueryPhaseTimer timer(&QueryProfile::read_documents_time);
+    remote_documents =
+        MergeByKey(remote_document_cache_->GetMatchingCollectionGroup(
+            query, collections, since_read_time));
   }
-  return results;
+
+  // Fetch the mutation batches once for the whole group, using the same
+  // parents, rather than once per collection.
+  std::vector<MutationBatch> matching_batches;
+  {
+    QueryPhaseTimer timer(&QueryProfile::apply_mutations_time);
+    matching_batches =
+        mutation_queue_->AllMutationBatchesAffectingCollections(collections);
+  }
+
+  return ApplyMutationsAndFilter(query, matching_batches,
+                                 std::move(remote_documents));
 }
 
 DocumentMap LocalDocumentsView::GetDocumentsMatchingCollectionQuery(
     const Query& query, const SnapshotVersion& since_read_time) {
-  MutableDocumentMap remote_documents =
-      remote_document_cache_->GetMatching(query, since_read_time);
+  MutableDocumentMap remote_documents;
+  {
+    QueryPhaseTimer timer(&QueryProfile::read_documents_time);
+    remote_documents =
+        remote_document_cache_->GetMatching(query, since_read_time);
+  }
+
   // Get locally persisted mutation batches.
-  std::vector<MutationBatch> matching_batches =
-      mutation_queue_->AllMutationBatchesAffectingQuery(query);
+  std::vector<MutationBatch> matching_batches;
+  {
+    QueryPhaseTimer timer(&QueryProfile::apply_mutations_time);
+    matching_batches = mutation_queue_->AllMutationBatchesAffectingQuery(query);
+  }
 
-  remote_documents =
-      AddMissingBaseDocuments(matching_batches, std::move(remote_documents));
+  return ApplyMutationsAndFilter(query, matching_batches,
+                                 std::move(remote_documents));
+}
 
-  for (const MutationBatch& batch : matching_batches) {
-    for (const Mutation& mutation : batch.mutations()) {
-      // Only process documents belonging to the collection.
-      if (!query.path().IsImmediateParentOf(mutation.key().path())) {
-        continue;
-      }
+DocumentMap LocalDocumentsView::ApplyMutationsAndFilter(
+    const Query& query,
+    const std::vector<MutationBatch>& matching_batches,
+    MutableDocumentMap remote_documents) {
+  {
+    QueryPhaseTimer timer(&QueryProfile::read_documents_time);
+    remote_documents =
+        AddMissingBaseDocuments(matching_batches, std::move(remote_documents));
+  }
 
-      const DocumentKey& key = mutation.key();
-      // base_doc may be unset for the documents that weren't yet written to
-      // the backend.
-      absl::optional<MutableDocument> document = remote_documents.get(key);
-      if (!document) {
-        // Create invalid document to apply mutations on top of
-        document = MutableDocument::InvalidDocument(key);
-      }
+  {
+    QueryPhaseTimer timer(&QueryProfile::apply_mutations_time);
+    for (const MutationBatch& batch : matching_batches) {
+      for (const Mutation& mutation : batch.mutations()) {
+        // Only process documents belonging to the collection (or, for
+        // collection group queries, to any collection in the group).
+        if (!BelongsToQueriedCollection(query, mutation.key())) {
+          continue;
+        }
 
-      mutation.ApplyToLocalView(*document, batch.local_write_time());
-      remote_documents = remote_documents.insert(key, *document);
+        const DocumentKey& key = mutation.key();
+        // base_doc may be unset for the documents that weren't yet written to
+        // the backend.
+        absl::optional<MutableDocument> document = remote_documents.get(key);
+        if (!document) {
+          // Create invalid document to apply mutations on top of
+          document = MutableDocument::InvalidDocument(key);
+        }
+
+        mutation.ApplyToLocalView(*document, batch.local_write_time());
+        remote_documents = remote_documents.insert(key, *document);
+      }
     }
+    QueryProfile::CountMutationBatches(matching_batches.size());
   }
 
   // Finally, filter out any documents that don't actually match the query. Note
@@ -187,6 +280,81 @@ DocumentMap LocalDocumentsView::GetDocumentsMatchingCollectionQuery(
   return results;
 }
 
+bool LocalDocumentsView::CanReadInPages(const Query& query) {
+  if (query.IsDocumentQuery() || query.IsCollectionGroupQuery() ||
+      query.has_limit_to_last()) {
+    return false;
+  }
+  const core::OrderByList& order_bys = query.order_bys();
+  return order_bys.size() == 1 && order_bys[0].field().IsKeyFieldPath() &&
+         order_bys[0].ascending();
+}
+
+DocumentPage LocalDocumentsView::GetDocumentsMatchingQueryPage(
+    const Query& query, const DocumentKey& start_after, size_t page_size) {
+  HARD_ASSERT(CanReadInPages(query), "Query %s can't be read in pages",
+              query.ToString());
+  HARD_ASSERT(page_size > 0, "Page size must be positive");
+
+  // Pending writes are few compared to the size of the cache, so they are
+  // read once and the mutations of each range are picked out below.
+  std::vector<MutationBatch> matching_batches =
+      mutation_queue_->AllMutationBatchesAffectingQuery(query);
+
+  DocumentPage page;
+  page.last_key = start_after;
+  page.has_more = true;
+  while (page.has_more && page.documents.size() < page_size) {
+    MutableDocumentMap remote_documents = remote_document_cache_->GetPage(
+        query.path(), page.last_key, page_size);
+
+    // This round covers the keys after `page.last_key`, up to and including
+    // the last document read, or all of them if the collection ran out.
+    bool exhausted = remote_documents.size() < page_size;
+    DocumentKey range_end;
+    if (!exhausted) range_end = remote_documents.max()->first;
+    auto in_range = [&](const DocumentKey& key) {
+      return page.last_key < key && (exhausted || key <= range_end) &&
+             BelongsToQueriedCollection(query, key);
+    };
+
+    // `remote_documents` already holds every cached document in the range, so
+    // the mutations in the range only need to be applied on top of it.
+    for (const MutationBatch& batch : matching_batches) {
+      for (const Mutation& mutation : batch.mutations()) {
+        const DocumentKey& key = mutation.key();
+        if (!in_range(key)) continue;
+
+        absl::optional<MutableDocument> document = remote_documents.get(key);
+        if (!document) {
+          document = MutableDocument::InvalidDocument(key);
+        }
+        mutation.ApplyToLocalView(*document, batch.local_write_time());
+        remote_documents = remote_documents.insert(key, *document);
+      }
+    }
+
+    for (const auto& kv : remote_documents) {
+      if (!query.Matches(kv.second)) continue;
+
+      page.documents.push_back(kv.second);
+      if (page.documents.size() == page_size) {
+        // Documents created by local writes can overfill the page; the next
+        // page picks up after the last document that fit.
+        page.last_key = kv.first;
+        return page;
+      }
+    }
+
+    if (exhausted) {
+      page.has_more = false;
+    } else {
+      page.last_key = range_end;
+    }
+  }
+  return page;
+}
+
 MutableDocumentMap LocalDocumentsView::AddMissingBaseDocuments(
     const std::vector<MutationBatch>& matching_batches,
     MutableDocumentMap existing_docs) {
@@ -17,11 +17,14 @@
 #ifndef FIRESTORE_CORE_SRC_LOCAL_LOCAL_DOCUMENTS_VIEW_H_
 #define FIRESTORE_CORE_SRC_LOCAL_LOCAL_DOCUMENTS_VIEW_H_
 
+#include <cstddef>
 #include <vector>
 
 #include "Firestore/core/src/local/index_manager.h"
 #include "Firestore/core/src/local/mutation_queue.h"
 #include "Firestore/core/src/local/remote_document_cache.h"
+#include "Firestore/core/src/model/document.h"
+#include "Firestore/core/src/model/document_key.h"
 #include "Firestore/core/src/model/model_fwd.h"
 
 namespace firebase {
@@ -31,12 +34,23 @@ namespace core {
 class Query;
 }  // namespace core
 
-namespace model {
-class Document;
-}  // namespace model
-
 namespace local {
 
+/** A page of the local view of the documents that match a query. */
+struct DocumentPage {
+  /** The documents in the page that match the query, in key order. */
+  std::vector<model::Document> documents;
+
+  /**
+   * The key that the next page starts after. All documents up to and
+   * including this key have been considered.
+   */
+  model::DocumentKey last_key;
+
+  /** False if there are no documents after `last_key`. */
+  bool has_more = false;
+};
+
 /**
  * A readonly view of the local state of all documents we're tracking (i.e. we
  * have a cached version in the RemoteDocumentCache or local mutations for the
@@ -89,6 +103,29 @@ class LocalDocumentsView {
   virtual model::DocumentMap GetDocumentsMatchingQuery(
       const core::Query& query, const model::SnapshotVersion& since_read_time);
 
+  /**
+   * Returns true if the results of `query` can be read in pages with
+   * `GetDocumentsMatchingQueryPage`. That requires a collection query whose
+   * results are in ascending key order, which is the default order.
+   */
+  static bool CanReadInPages(const core::Query& query);
+
+  /**
+   * Returns a page of at most `page_size` documents that match `query`, from
+   * the local view of the documents whose keys sort after `start_after`.
+   *
+   * Cached documents are read from the RemoteDocumentCache a page at a time,
+   * so memory use is proportional to `page_size` rather than to the size of
+   * the collection. Pages are read independently, so writes between reading
+   * two pages are reflected in the later page only.
+   *
+   * Does not apply the query's limit.
+   */
+  DocumentPage GetDocumentsMatchingQueryPage(
+      const core::Query& query,
+      const model::DocumentKey& start_after,
+      size_t page_size);
+
  private:
   friend class CountingQueryEngine;  // For testing
 
@@ -115,6 +152,16 @@ class LocalDocumentsView {
   model::DocumentMap GetDocumentsMatchingCollectionQuery(
       const core::Query& query, const model::SnapshotVersion& since_read_time);
 
+  /**
+   * Overlays the mutations in `matching_batches` onto the given
+   * `remote_documents` and filters out any documents that don't match
+   * `query`.
+   */
+  model::DocumentMap ApplyMutationsAndFilter(
+      const core::Query& query,
+      const std::vector<model::MutationBatch>& matching_batches,
+      model::MutableDocumentMap remote_documents);
+
   /**
    * It is possible that a `PatchMutation` can make a document match a query,
    * even if the version in the `RemoteDocumentCache` is not a match yet
@@ -0,0 +1,105 @@
+/*
+ * Copyright 2021 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Firestore/core/src/local/local_reader.h"
+
+#include <utility>
+
+#include "Firestore/core/src/core/query.h"
+#include "Firestore/core/src/core/target.h"
+#include "Firestore/core/src/local/bundle_cache.h"
+#include "Firestore/core/src/local/mutation_queue.h"
+#include "Firestore/core/src/local/persistence.h"
+#include "Firestore/core/src/local/query_result.h"
+#include "Firestore/core/src/local/target_cache.h"
+#include "Firestore/core/src/local/target_data.h"
+#include "Firestore/core/src/model/snapshot_version.h"
+
+namespace firebase {
+namespace firestore {
+namespace local {
+
+using credentials::User;
+using model::Document;
+using model::DocumentKey;
+using model::DocumentKeySet;
+using model::DocumentMap;
+using model::SnapshotVersion;
+
+std::shared_ptr<LocalReader> LocalReader::Create(Persistence* persistence,
+                                                 const User& user) {
+  std::unique_ptr<MutationQueue> mutation_queue =
+      persistence->NewMutationQueueForReading(user);
+  if (!mutation_queue) return nullptr;
+
+  return std::make_shared<LocalReader>(persistence, std::move(mutation_queue));
+}
+
+LocalReader::LocalReader(Persistence* persistence,
+                         std::unique_ptr<MutationQueue> mutation_queue)
+    : persistence_(persistence),
+      mutation_queue_(std::move(mutation_queue)),
+      local_documents_(persistence->remote_document_cache(),
+                       mutation_queue_.get(),
+                       persistence->index_manager()) {
+  query_engine_.SetLocalDocumentsView(&local_documents_);
+}
+
+LocalReader::~LocalReader() = default;
+
+Document LocalReader::ReadDocument(const DocumentKey& key) {
+  return persistence_->RunReadOnly(
+      "ReadDocument", [&] { return local_documents_.GetDocument(key); });
+}
+
+DocumentMap LocalReader::ReadDocuments(const DocumentKeySet& keys) {
+  return persistence_->RunReadOnly(
+      "ReadDocuments", [&] { return local_documents_.GetDocuments(keys); });
+}
+
+QueryResult LocalReader::ExecuteQuery(const core::Query& query) {
+  return persistence_->RunReadOnly("ExecuteQuery", [&] {
+    // Unlike LocalStore, this only knows the targets that were persisted,
+    // whose limbo-free snapshot versions may be older. That only means more
+    // documents are checked for changes.
+    TargetCache* target_cache = persistence_->target_cache();
+    absl::optional<TargetData> target_data =
+        target_cache->GetTarget(query.ToTarget());
+    SnapshotVersion last_limbo_free_snapshot_version;
+    DocumentKeySet remote_keys;
+
+    if (target_data) {
+      last_limbo_free_snapshot_version =
+          target_data->last_limbo_free_snapshot_version();
+      remote_keys = target_cache->GetMatchingKeys(target_data->target_id());
+    }
+
+    model::DocumentMap documents = query_engine_.GetDocumentsMatchingQuery(
+        query, last_limbo_free_snapshot_version, remote_keys);
+    return QueryResult(std::move(documents), std::move(remote_keys));
+  });
+}
+
+absl::optional<bundle::NamedQuery> LocalReader::GetNamedQuery(
+    const std::string& name) {
+  return persistence_->RunReadOnly("Get named query", [&] {
+    return persistence_->bundle_cache()->GetNamedQuery(name);
+  });
+}
+
+}  // namespace local
+}  // namespace firestore
+}  // namespace firebase
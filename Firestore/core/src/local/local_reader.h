@@ -0,0 +1,95 @@
+/*
+ * Copyright 2021 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FIRESTORE_CORE_SRC_LOCAL_LOCAL_READER_H_
+#define FIRESTORE_CORE_SRC_LOCAL_LOCAL_READER_H_
+
+#include <memory>
+#include <string>
+
+#include "Firestore/core/src/bundle/named_query.h"
+#include "Firestore/core/src/local/local_documents_view.h"
+#include "Firestore/core/src/local/query_engine.h"
+#include "Firestore/core/src/model/document.h"
+#include "absl/types/optional.h"
+
+namespace firebase {
+namespace firestore {
+
+namespace credentials {
+class User;
+}  // namespace credentials
+
+namespace core {
+class Query;
+}  // namespace core
+
+namespace local {
+
+class MutationQueue;
+class Persistence;
+class QueryResult;
+
+/**
+ * Reads the local view of documents, like `LocalStore`, from a snapshot of
+ * persistence. A LocalReader keeps no state that LocalStore changes, so it can
+ * be used from any thread, while LocalStore keeps writing on the worker queue.
+ *
+ * A LocalReader reads the pending writes of the user it was created for, and
+ * doesn't know about writes that LocalStore hasn't committed yet.
+ */
+class LocalReader {
+ public:
+  /**
+   * Creates a reader for the documents seen by `user`, or returns nullptr if
+   * `persistence` can't be read concurrently with its transactions.
+   */
+  static std::shared_ptr<LocalReader> Create(Persistence* persistence,
+                                             const credentials::User& user);
+
+  LocalReader(Persistence* persistence,
+              std::unique_ptr<MutationQueue> mutation_queue);
+
+  ~LocalReader();
+
+  /** Returns the local view of the document identified by `key`. */
+  model::Document ReadDocument(const model::DocumentKey& key);
+
+  /** Returns the local view of the documents identified by `keys`. */
+  model::DocumentMap ReadDocuments(const model::DocumentKeySet& keys);
+
+  /**
+   * Runs the specified query against the local store and returns the results,
+   * potentially taking advantage of the results of a previous execution of
+   * the query that was persisted.
+   */
+  QueryResult ExecuteQuery(const core::Query& query);
+
+  /** Returns the named query with the given name, if it was saved. */
+  absl::optional<bundle::NamedQuery> GetNamedQuery(const std::string& name);
+
+ private:
+  Persistence* persistence_ = nullptr;
+  std::unique_ptr<MutationQueue> mutation_queue_;
+  LocalDocumentsView local_documents_;
+  QueryEngine query_engine_;
+};
+
+}  // namespace local
+}  // namespace firestore
+}  // namespace firebase
+
+#endif  // FIRESTORE_CORE_SRC_LOCAL_LOCAL_READER_H_
@@ -16,6 +16,7 @@
 
 #include "Firestore/core/src/local/local_store.h"
 
+#include <algorithm>
 #include <string>
 #include <utility>
 
@@ -26,6 +27,7 @@
 #include "Firestore/core/src/local/lru_garbage_collector.h"
 #include "Firestore/core/src/local/persistence.h"
 #include "Firestore/core/src/local/query_engine.h"
+#include "Firestore/core/src/local/query_profile.h"
 #include "Firestore/core/src/local/query_result.h"
 #include "Firestore/core/src/local/reference_delegate.h"
 #include "Firestore/core/src/local/target_cache.h"
@@ -53,6 +55,7 @@ using model::DocumentKeySet;
 using model::DocumentMap;
 using model::DocumentUpdateMap;
 using model::DocumentVersionMap;
+using model::kBatchIdUnknown;
 using model::ListenSequenceNumber;
 using model::MutableDocument;
 using model::MutableDocumentMap;
@@ -100,13 +103,32 @@ LocalStore::~LocalStore() = default;
 
 void LocalStore::Start() {
   StartMutationQueue();
+  StartTargetIdGenerator();
+}
+
+void LocalStore::HandleCacheSnapshotImport() {
+  HARD_ASSERT(target_data_by_target_.empty(),
+              "Cache snapshots can only be imported while no targets are "
+              "allocated");
+  StartTargetIdGenerator();
+}
+
+bool LocalStore::HasAllocatedTargets() const {
+  return !target_data_by_target_.empty();
+}
+
+void LocalStore::StartTargetIdGenerator() {
   TargetId target_id = target_cache_->highest_target_id();
   target_id_generator_ =
       TargetIdGenerator::TargetCacheTargetIdGenerator(target_id);
 }
 
 void LocalStore::StartMutationQueue() {
-  persistence_->Run("Start MutationQueue", [&] { mutation_queue_->Start(); });
+  persistence_->Run("Start MutationQueue", [&] {
+    mutation_queue_->Start();
+    last_batch_id_at_start_ =
+        mutation_queue_->GetHighestUnacknowledgedBatchId();
+  });
 }
 
 DocumentMap LocalStore::HandleUserChange(const User& user) {
@@ -147,7 +169,8 @@ DocumentMap LocalStore::HandleUserChange(const User& user) {
   });
 }
 
-LocalWriteResult LocalStore::WriteLocally(std::vector<Mutation>&& mutations) {
+LocalWriteResult LocalStore::WriteLocally(
+    std::vector<Mutation>&& mutations, absl::optional<BatchId> coalesce_after) {
   Timestamp local_write_time = Timestamp::Now();
   DocumentKeySet keys;
   for (const Mutation& mutation : mutations) {
@@ -155,6 +178,14 @@ LocalWriteResult LocalStore::WriteLocally(std::vector<Mutation>&& mutations) {
   }
 
   return persistence_->Run("Locally write mutations", [&] {
+    if (coalesce_after) {
+      absl::optional<LocalWriteResult> coalesced =
+          CoalesceWrite(mutations, *coalesce_after);
+      if (coalesced) {
+        return std::move(*coalesced);
+      }
+    }
+
     // Load and apply all existing mutations. This lets us compute the current
     // base state for all non-idempotent transforms before applying any
     // additional user-provided writes.
@@ -188,6 +219,41 @@ LocalWriteResult LocalStore::WriteLocally(std::vector<Mutation>&& mutations) {
   });
 }
 
+absl::optional<LocalWriteResult> LocalStore::CoalesceWrite(
+    const std::vector<Mutation>& mutations, BatchId coalesce_after) {
+  if (mutations.size() != 1) {
+    return absl::nullopt;
+  }
+
+  // Batches that were queued before the mutation queue was started may have
+  // been sent already, by an earlier instance or before a user change.
+  BatchId last_batch_id = mutation_queue_->GetHighestUnacknowledgedBatchId();
+  if (last_batch_id == kBatchIdUnknown || last_batch_id <= coalesce_after ||
+      last_batch_id <= last_batch_id_at_start_) {
+    return absl::nullopt;
+  }
+
+  absl::optional<MutationBatch> last_batch =
+      mutation_queue_->LookupMutationBatch(last_batch_id);
+  if (!last_batch || last_batch->mutations().size() != 1 ||
+      !last_batch->base_mutations().empty()) {
+    return absl::nullopt;
+  }
+
+  absl::optional<Mutation> merged =
+      CoalesceMutations(last_batch->mutations().front(), mutations.front());
+  if (!merged) {
+    return absl::nullopt;
+  }
+
+  MutationBatch batch(last_batch_id, last_batch->local_write_time(), {},
+                      {std::move(*merged)});
+  mutation_queue_->ReplaceMutationBatch(batch);
+
+  DocumentMap changes = local_documents_->GetDocuments(batch.keys());
+  return LocalWriteResult{last_batch_id, std::move(changes)};
+}
+
 DocumentMap LocalStore::AcknowledgeBatch(
     const MutationBatchResult& batch_result) {
   return persistence_->Run("Acknowledge batch", [&] {
@@ -327,6 +393,26 @@ model::DocumentMap LocalStore::ApplyRemoteEvent(
   });
 }
 
+DocumentMap LocalStore::ApplyDocumentLookup(
+    const DocumentUpdateMap& documents) {
+  const SnapshotVersion& last_remote_version =
+      target_cache_->GetLastRemoteSnapshotVersion();
+
+  return persistence_->Run("Apply document lookup", [&] {
+    DocumentVersionMap read_times;
+    for (const auto& kv : documents) {
+      const DocumentKey& key = kv.first;
+      const MutableDocument& doc = kv.second;
+      persistence_->reference_delegate()->UpdateLimboDocument(key);
+      read_times.emplace(key, std::max(doc.version(), last_remote_version));
+    }
+
+    auto changed_docs = PopulateDocumentChanges(documents, read_times,
+                                                SnapshotVersion::None());
+    return local_documents_->GetLocalViewOfDocuments(changed_docs);
+  });
+}
+
 bool LocalStore::ShouldPersistTargetData(const TargetData& new_target_data,
                                          const TargetData& old_target_data,
                                          const TargetChange& change) const {
@@ -413,6 +499,18 @@ const Document LocalStore::ReadDocument(const DocumentKey& key) {
                            [&] { return local_documents_->GetDocument(key); });
 }
 
+DocumentMap LocalStore::ReadDocuments(const DocumentKeySet& keys) {
+  return persistence_->Run(
+      "ReadDocuments", [&] { return local_documents_->GetDocuments(keys); });
+}
+
+DocumentMap LocalStore::GetLocalViewOfDocuments(
+    const MutableDocumentMap& documents) {
+  return persistence_->Run("GetLocalViewOfDocuments", [&] {
+    return local_documents_->GetLocalViewOfDocuments(documents);
+  });
+}
+
 BatchId LocalStore::GetHighestUnacknowledgedBatchId() {
   return persistence_->Run("GetHighestUnacknowledgedBatchId", [&] {
     return mutation_queue_->GetHighestUnacknowledgedBatchId();
@@ -469,8 +567,12 @@ void LocalStore::ReleaseTarget(TargetId target_id) {
 }
 
 QueryResult LocalStore::ExecuteQuery(const Query& query,
-                                     bool use_previous_results) {
+                                     bool use_previous_results,
+                                     QueryProfile* profile) {
   return persistence_->Run("ExecuteQuery", [&] {
+    ScopedQueryProfile profile_scope(profile);
+    QueryPhaseTimer total_timer(&QueryProfile::total_time);
+
     absl::optional<TargetData> target_data = GetTargetData(query.ToTarget());
     SnapshotVersion last_limbo_free_snapshot_version;
     DocumentKeySet remote_keys;
@@ -486,10 +588,20 @@ QueryResult LocalStore::ExecuteQuery(const Query& query,
         use_previous_results ? last_limbo_free_snapshot_version
                              : SnapshotVersion::None(),
         use_previous_results ? remote_keys : DocumentKeySet{});
+    if (profile) profile->documents_matched = documents.size();
     return QueryResult(std::move(documents), std::move(remote_keys));
   });
 }
 
+DocumentPage LocalStore::ReadDocumentsPage(const Query& query,
+                                           const DocumentKey& start_after,
+                                           size_t page_size) {
+  return persistence_->Run("ReadDocumentsPage", [&] {
+    return local_documents_->GetDocumentsMatchingQueryPage(query, start_after,
+                                                           page_size);
+  });
+}
+
 DocumentKeySet LocalStore::GetRemoteDocumentKeys(TargetId target_id) {
   return persistence_->Run("RemoteDocumentKeysForTarget", [&] {
     return target_cache_->GetMatchingKeys(target_id);
@@ -498,7 +610,7 @@ DocumentKeySet LocalStore::GetRemoteDocumentKeys(TargetId target_id) {
 
 LruResults LocalStore::CollectGarbage(LruGarbageCollector* garbage_collector) {
   return persistence_->Run("Collect garbage", [&] {
-    return garbage_collector->Collect(target_data_by_target_);
+    return garbage_collector->CollectProportionally(target_data_by_target_);
   });
 }
 
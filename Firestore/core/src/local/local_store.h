@@ -26,10 +26,12 @@
 #include "Firestore/core/src/bundle/bundle_metadata.h"
 #include "Firestore/core/src/bundle/named_query.h"
 #include "Firestore/core/src/core/target_id_generator.h"
+#include "Firestore/core/src/local/local_documents_view.h"
 #include "Firestore/core/src/local/reference_set.h"
 #include "Firestore/core/src/local/target_data.h"
 #include "Firestore/core/src/model/document.h"
 #include "Firestore/core/src/model/model_fwd.h"
+#include "Firestore/core/src/model/mutation_batch.h"
 #include "absl/types/optional.h"
 
 namespace firebase {
@@ -51,7 +53,6 @@ class TargetChange;
 namespace local {
 
 class BundleCache;
-class LocalDocumentsView;
 class LocalViewChanges;
 class LocalWriteResult;
 class LruGarbageCollector;
@@ -63,6 +64,7 @@ class RemoteDocumentCache;
 class TargetCache;
 
 struct LruResults;
+struct QueryProfile;
 
 /**
  * Local storage in the Firestore client. Coordinates persistence components
@@ -115,6 +117,19 @@ class LocalStore : public bundle::BundleCallback {
   /** Performs any initial startup actions required by the local store. */
   void Start();
 
+  /**
+   * Picks up the targets that importing a cache snapshot added to the target
+   * cache, so that the IDs of new targets don't collide with theirs. Must be
+   * called after each `LevelDbPersistence::ImportCacheSnapshot` once the store
+   * was started, and while no targets are allocated.
+   *
+   * `FirestoreClient::ImportCacheSnapshot` takes care of this.
+   */
+  void HandleCacheSnapshotImport();
+
+  /** Returns true if any targets are allocated, e.g. by active listens. */
+  bool HasAllocatedTargets() const;
+
   /**
    * Tells the LocalStore that the currently authenticated user has changed.
    *
@@ -123,8 +138,19 @@ class LocalStore : public bundle::BundleCallback {
    */
   model::DocumentMap HandleUserChange(const credentials::User& user);
 
-  /** Accepts locally generated Mutations and commits them to storage. */
-  LocalWriteResult WriteLocally(std::vector<model::Mutation>&& mutations);
+  /**
+   * Accepts locally generated Mutations and commits them to storage.
+   *
+   * If `coalesce_after` is set, a write of a single set or patch may instead
+   * be merged into the last batch in the mutation queue, which is then
+   * returned in place of a new batch. This is only done if the last batch has
+   * an ID greater than `coalesce_after`, was added since the mutation queue
+   * was started, and consists of a single mutation to the same document that
+   * can be merged with the new one; see `CoalesceMutations`.
+   */
+  LocalWriteResult WriteLocally(
+      std::vector<model::Mutation>&& mutations,
+      absl::optional<model::BatchId> coalesce_after = absl::nullopt);
 
   /**
    * Returns the current value of a document with a given key, or an invalid
@@ -132,6 +158,19 @@ class LocalStore : public bundle::BundleCallback {
    */
   const model::Document ReadDocument(const model::DocumentKey& key);
 
+  /**
+   * Returns the current values of the documents with the given keys. Keys
+   * that aren't cached map to an invalid document.
+   */
+  model::DocumentMap ReadDocuments(const model::DocumentKeySet& keys);
+
+  /**
+   * Returns the local view of the given remote documents, with any pending
+   * mutations applied, without reading the documents from the cache.
+   */
+  model::DocumentMap GetLocalViewOfDocuments(
+      const model::MutableDocumentMap& documents);
+
   /**
    * Acknowledges the given batch.
    *
@@ -183,6 +222,21 @@ class LocalStore : public bundle::BundleCallback {
    */
   model::DocumentMap ApplyRemoteEvent(const remote::RemoteEvent& remote_event);
 
+  /**
+   * Applies the results of a direct lookup of documents, such as those in
+   * limbo, to the "ground-state" (remote) documents.
+   *
+   * Unlike `ApplyRemoteEvent`, this does not advance the last remote snapshot
+   * version: lookups are not part of the watch stream's consistent snapshots.
+   * Each document is instead stored with its own version, and found documents
+   * are never stored with a read time older than the last remote snapshot.
+   *
+   * LocalDocuments are re-calculated if there are remaining mutations in the
+   * queue.
+   */
+  model::DocumentMap ApplyDocumentLookup(
+      const model::DocumentUpdateMap& documents);
+
   /**
    * Returns the keys of the documents that are associated with the given
    * target_id in the remote table.
@@ -213,8 +267,21 @@ class LocalStore : public bundle::BundleCallback {
    *
    * @param use_previous_results Whether results from previous executions can be
    *     used to optimize this query execution.
+   * @param profile If not null, receives a description of how the query was
+   *     executed and how long its phases took.
+   */
+  QueryResult ExecuteQuery(const core::Query& query,
+                           bool use_previous_results,
+                           QueryProfile* profile = nullptr);
+
+  /**
+   * Reads a page of at most `page_size` documents matching `query` from the
+   * local store, starting after `start_after`. The query must satisfy
+   * `LocalDocumentsView::CanReadInPages`.
    */
-  QueryResult ExecuteQuery(const core::Query& query, bool use_previous_results);
+  DocumentPage ReadDocumentsPage(const core::Query& query,
+                                 const model::DocumentKey& start_after,
+                                 size_t page_size);
 
   /**
    * Notify the local store of the changed views to locally pin / unpin
@@ -240,6 +307,11 @@ class LocalStore : public bundle::BundleCallback {
    */
   model::BatchId GetHighestUnacknowledgedBatchId();
 
+  /**
+   * Runs a pass of garbage collection if the cache is over its size threshold,
+   * sized by how far over it is; see
+   * `LruGarbageCollector::CollectProportionally`.
+   */
   LruResults CollectGarbage(LruGarbageCollector* garbage_collector);
 
   /**
@@ -276,8 +348,17 @@ class LocalStore : public bundle::BundleCallback {
   friend class LocalStoreTest;  // for `GetTargetData()`
 
   void StartMutationQueue();
+  void StartTargetIdGenerator();
   void ApplyBatchResult(const model::MutationBatchResult& batch_result);
 
+  /**
+   * Merges `mutations` into the last batch of the mutation queue if possible,
+   * and returns the result of the write if it was merged.
+   */
+  absl::optional<LocalWriteResult> CoalesceWrite(
+      const std::vector<model::Mutation>& mutations,
+      model::BatchId coalesce_after);
+
   /**
    * Returns true if the new_target_data should be persisted during an update of
    * an active target. TargetData should always be persisted when a target is
@@ -338,6 +419,12 @@ class LocalStore : public bundle::BundleCallback {
    */
   MutationQueue* mutation_queue_ = nullptr;
 
+  /**
+   * The ID of the last batch in `mutation_queue_` when it was started. Writes
+   * are never coalesced into this batch or earlier ones.
+   */
+  model::BatchId last_batch_id_at_start_ = model::kBatchIdUnknown;
+
   /** The set of all cached remote documents. */
   RemoteDocumentCache* remote_document_cache_ = nullptr;
 
@@ -16,6 +16,7 @@
 
 #include "Firestore/core/src/local/lru_garbage_collector.h"
 
+#include <algorithm>
 #include <chrono>  // NOLINT(build/c++11)
 #include <queue>
 #include <string>
@@ -41,6 +42,10 @@ using util::StatusOr;
 
 using Millis = std::chrono::milliseconds;
 
+// The largest share of sequence numbers collected in one pass, however far the
+// cache is over its threshold.
+const int kMaxPercentileToCollect = 50;
+
 static Millis::rep MillisecondsBetween(const Timestamp& start,
                                        const Timestamp& end) {
   return std::chrono::duration_cast<Millis>(end.ToTimePoint() -
@@ -115,9 +120,38 @@ StatusOr<int64_t> LruGarbageCollector::CalculateByteSize() const {
 }
 
 LruResults LruGarbageCollector::Collect(const LiveQueryMap& live_targets) {
+  absl::optional<int64_t> current_size = SizeIfOverThreshold();
+  if (!current_size) return LruResults::DidNotRun();
+
+  LOG_DEBUG("Running garbage collection on cache of size: %s", *current_size);
+  return RunGarbageCollection(live_targets, params_.percentile_to_collect);
+}
+
+LruResults LruGarbageCollector::CollectProportionally(
+    const LiveQueryMap& live_targets) {
+  absl::optional<int64_t> current_size = SizeIfOverThreshold();
+  if (!current_size) return LruResults::DidNotRun();
+
+  // Collecting the share of the cache that is over the threshold would bring
+  // it back under, if all entries were the same size.
+  int excess_percentile = 0;
+  if (*current_size > 0) {
+    excess_percentile = static_cast<int>(
+        100 * (*current_size - params_.min_bytes_threshold) / *current_size);
+  }
+  int percentile =
+      std::min(std::max(params_.percentile_to_collect, excess_percentile),
+               kMaxPercentileToCollect);
+
+  LOG_DEBUG("Running garbage collection of %s%% on cache of size: %s",
+            percentile, *current_size);
+  return RunGarbageCollection(live_targets, percentile);
+}
+
+absl::optional<int64_t> LruGarbageCollector::SizeIfOverThreshold() {
   if (params_.min_bytes_threshold == Settings::CacheSizeUnlimited) {
     LOG_DEBUG("Garbage collection skipped; disabled");
-    return LruResults::DidNotRun();
+    return absl::nullopt;
   }
 
   StatusOr<int64_t> maybe_current_size = CalculateByteSize();
@@ -126,7 +160,7 @@ LruResults LruGarbageCollector::Collect(const LiveQueryMap& live_targets) {
         "Garbage collection skipped; failed to estimate the size of the "
         "cache: %s",
         maybe_current_size.status().ToString());
-    return LruResults::DidNotRun();
+    return absl::nullopt;
   }
 
   int64_t current_size = maybe_current_size.ValueOrDie();
@@ -135,19 +169,17 @@ LruResults LruGarbageCollector::Collect(const LiveQueryMap& live_targets) {
     LOG_DEBUG(
         "Garbage collection skipped; Cache size %s is lower than threshold %s",
         current_size, params_.min_bytes_threshold);
-    return LruResults::DidNotRun();
+    return absl::nullopt;
   }
-
-  LOG_DEBUG("Running garbage collection on cache of size: %s", current_size);
-  return RunGarbageCollection(live_targets);
+  return current_size;
 }
 
 LruResults LruGarbageCollector::RunGarbageCollection(
-    const LiveQueryMap& live_targets) {
+    const LiveQueryMap& live_targets, int percentile) {
   Timestamp start = Timestamp::Now();
 
   // Cap at the configured max
-  int sequence_numbers = QueryCountForPercentile(params_.percentile_to_collect);
+  int sequence_numbers = QueryCountForPercentile(percentile);
   if (sequence_numbers > params_.maximum_sequence_numbers_to_collect) {
     sequence_numbers = params_.maximum_sequence_numbers_to_collect;
   }
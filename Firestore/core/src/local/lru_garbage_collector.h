@@ -17,6 +17,8 @@
 #ifndef FIRESTORE_CORE_SRC_LOCAL_LRU_GARBAGE_COLLECTOR_H_
 #define FIRESTORE_CORE_SRC_LOCAL_LRU_GARBAGE_COLLECTOR_H_
 
+#include <chrono>  // NOLINT(build/c++11)
+#include <cstdint>
 #include <unordered_map>
 
 #include "Firestore/core/src/local/reference_delegate.h"
@@ -24,6 +26,7 @@
 #include "Firestore/core/src/local/target_data.h"
 #include "Firestore/core/src/model/types.h"
 #include "Firestore/core/src/util/status_fwd.h"
+#include "absl/types/optional.h"
 
 namespace firebase {
 namespace firestore {
@@ -60,6 +63,18 @@ struct LruResults {
 
 using LiveQueryMap = std::unordered_map<model::TargetId, TargetData>;
 
+/** Describes the writes made to a cache, to schedule garbage collection by. */
+struct CacheWriteStats {
+  /**
+   * The number of bytes written since the cache was opened, including the
+   * bytes of overwritten and deleted entries.
+   */
+  int64_t bytes_written = 0;
+
+  /** When the cache was last written to, or the epoch if it never was. */
+  std::chrono::steady_clock::time_point last_write_time;
+};
+
 /**
  * Persistence layers intending to use LRU Garbage collection should implement
  * this interface. This interface defines the operations that the LRU garbage
@@ -74,6 +89,12 @@ class LruDelegate : public ReferenceDelegate {
 
   virtual util::StatusOr<int64_t> CalculateByteSize() = 0;
 
+  /**
+   * Returns how much was written to the cache, and when. Unlike
+   * `CalculateByteSize`, this is cheap enough to call often.
+   */
+  virtual CacheWriteStats GetWriteStats() = 0;
+
   /** Returns the number of targets and orphaned documents cached. */
   virtual size_t GetSequenceNumberCount() = 0;
 
@@ -147,8 +168,23 @@ class LruGarbageCollector {
 
   local::LruResults Collect(const LiveQueryMap& live_targets);
 
+  /**
+   * Like `Collect`, but sizes the pass by how far the cache is over the
+   * threshold: the share of sequence numbers collected grows with the excess,
+   * from `percentile_to_collect` up to half of them. The pass is still capped
+   * at `maximum_sequence_numbers_to_collect`.
+   */
+  local::LruResults CollectProportionally(const LiveQueryMap& live_targets);
+
  private:
-  LruResults RunGarbageCollection(const LiveQueryMap& live_targets);
+  /**
+   * Returns the size of the cache if it is over the threshold, or nullopt if
+   * collection should be skipped.
+   */
+  absl::optional<int64_t> SizeIfOverThreshold();
+
+  LruResults RunGarbageCollection(const LiveQueryMap& live_targets,
+                                  int percentile);
 
   // Delegate owns the LruGarbageCollector; this is a back pointer.
   LruDelegate* delegate_;
@@ -189,6 +189,11 @@ StatusOr<int64_t> MemoryLruReferenceDelegate::CalculateByteSize() {
   return count;
 }
 
+CacheWriteStats MemoryLruReferenceDelegate::GetWriteStats() {
+  // Writes aren't tracked, since this delegate is only used for testing.
+  return CacheWriteStats();
+}
+
 }  // namespace local
 }  // namespace firestore
 }  // namespace firebase
@@ -100,7 +100,7 @@ MutationBatch MemoryMutationQueue::AddMutationBatch(
         DocumentKeyReference{mutation.key(), batch_id});
 
     persistence_->index_manager()->AddToCollectionParentIndex(
-        mutation.key().path().PopLast());
+        mutation.key().collection_path());
   }
 
   return batch;
@@ -125,6 +125,19 @@ void MemoryMutationQueue::RemoveMutationBatch(const MutationBatch& batch) {
   }
 }
 
+void MemoryMutationQueue::ReplaceMutationBatch(const MutationBatch& batch) {
+  int index = IndexOfBatchId(batch.batch_id());
+  HARD_ASSERT(index >= 0 && static_cast<size_t>(index) < queue_.size(),
+              "Trying to replace batch %s, which is not in the queue",
+              batch.batch_id());
+
+  MutationBatch& existing = queue_[index];
+  HARD_ASSERT(existing.keys() == batch.keys(),
+              "Replacement of batch %s must affect the same documents",
+              batch.batch_id());
+  existing = batch;
+}
+
 std::vector<MutationBatch>
 MemoryMutationQueue::AllMutationBatchesAffectingDocumentKeys(
     const DocumentKeySet& document_keys) {
@@ -166,31 +179,46 @@ MemoryMutationQueue::AllMutationBatchesAffectingQuery(const Query& query) {
       !query.IsCollectionGroupQuery(),
       "CollectionGroup queries should be handled in LocalDocumentsView");
 
-  // Use the query path as a prefix for testing if a document matches the query.
-  const ResourcePath& prefix = query.path();
+  std::set<BatchId> unique_batch_ids;
+  CollectBatchIdsInCollection(query.path(), &unique_batch_ids);
+  return AllMutationBatchesWithIds(unique_batch_ids);
+}
+
+std::vector<MutationBatch>
+MemoryMutationQueue::AllMutationBatchesAffectingCollections(
+    const std::vector<ResourcePath>& collections) {
+  std::set<BatchId> unique_batch_ids;
+  for (const ResourcePath& collection : collections) {
+    CollectBatchIdsInCollection(collection, &unique_batch_ids);
+  }
+  return AllMutationBatchesWithIds(unique_batch_ids);
+}
+
+void MemoryMutationQueue::CollectBatchIdsInCollection(
+    const ResourcePath& collection, std::set<BatchId>* batch_ids) {
+  // Use the collection path as a prefix for testing if a document is in it.
+  const ResourcePath& prefix = collection;
   size_t immediate_children_path_length = prefix.size() + 1;
 
   // Construct a document reference for actually scanning the index. Unlike the
   // prefix, the document key in this reference must have an even number of
-  // segments. The empty segment can be used as a suffix of the query path
+  // segments. The empty segment can be used as a suffix of the collection path
   // because it precedes all other segments in an ordered traversal.
-  ResourcePath start_path = query.path();
+  ResourcePath start_path = collection;
   if (!DocumentKey::IsDocumentKey(start_path)) {
     start_path = start_path.Append("");
   }
   DocumentKeyReference start{DocumentKey{start_path}, 0};
 
-  // Find unique batch_ids referenced by all documents potentially matching the
-  // query.
-  std::set<BatchId> unique_batch_ids;
+  // Find unique batch_ids referenced by all documents in the collection.
   for (const auto& reference : batches_by_document_key_.values_from(start)) {
     const ResourcePath& row_key_path = reference.key().path();
     if (!prefix.IsPrefixOf(row_key_path)) {
       break;
     }
 
-    // Rows with document keys more than one segment longer than the query path
-    // can't be matches. For example, a query on 'rooms' can't match the
+    // Rows with document keys more than one segment longer than the collection
+    // path can't be matches. For example, a query on 'rooms' can't match the
     // document /rooms/abc/messages/xyx.
     // TODO(mcg): we'll need a different scanner when we implement ancestor
     // queries.
@@ -198,10 +226,8 @@ MemoryMutationQueue::AllMutationBatchesAffectingQuery(const Query& query) {
       continue;
     }
 
-    unique_batch_ids.insert(reference.ref_id());
+    batch_ids->insert(reference.ref_id());
   }
-
-  return AllMutationBatchesWithIds(unique_batch_ids);
 }
 
 absl::optional<MutationBatch>
@@ -54,6 +54,8 @@ class MemoryMutationQueue : public MutationQueue {
 
   void RemoveMutationBatch(const model::MutationBatch& batch) override;
 
+  void ReplaceMutationBatch(const model::MutationBatch& batch) override;
+
   std::vector<model::MutationBatch> AllMutationBatches() override {
     return queue_;
   }
@@ -67,6 +69,9 @@ class MemoryMutationQueue : public MutationQueue {
   std::vector<model::MutationBatch> AllMutationBatchesAffectingQuery(
       const core::Query& query) override;
 
+  std::vector<model::MutationBatch> AllMutationBatchesAffectingCollections(
+      const std::vector<model::ResourcePath>& collections) override;
+
   absl::optional<model::MutationBatch> LookupMutationBatch(
       model::BatchId batch_id) override;
 
@@ -91,6 +96,13 @@ class MemoryMutationQueue : public MutationQueue {
   std::vector<model::MutationBatch> AllMutationBatchesWithIds(
       const std::set<model::BatchId>& batch_ids);
 
+  /**
+   * Adds the batch_ids of the mutations on immediate children of `collection`
+   * to `batch_ids`.
+   */
+  void CollectBatchIdsInCollection(const model::ResourcePath& collection,
+                                   std::set<model::BatchId>* batch_ids);
+
   /**
    * Finds the index of the given batch_id in the mutation queue. This operation
    * is O(1).
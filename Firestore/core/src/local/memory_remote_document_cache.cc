@@ -16,9 +16,12 @@
 
 #include "Firestore/core/src/local/memory_remote_document_cache.h"
 
+#include <vector>
+
 #include "Firestore/core/src/core/query.h"
 #include "Firestore/core/src/local/memory_lru_reference_delegate.h"
 #include "Firestore/core/src/local/memory_persistence.h"
+#include "Firestore/core/src/local/query_profile.h"
 #include "Firestore/core/src/local/sizer.h"
 #include "Firestore/core/src/model/document.h"
 #include "Firestore/core/src/util/hard_assert.h"
@@ -34,8 +37,23 @@ using model::DocumentKeySet;
 using model::ListenSequenceNumber;
 using model::MutableDocument;
 using model::MutableDocumentMap;
+using model::ResourcePath;
 using model::SnapshotVersion;
 
+namespace {
+
+/** Returns the smallest read time that sorts after `read_time`. */
+SnapshotVersion NextReadTime(const SnapshotVersion& read_time) {
+  const Timestamp& timestamp = read_time.timestamp();
+  if (timestamp.nanoseconds() < 999999999) {
+    return SnapshotVersion(
+        Timestamp(timestamp.seconds(), timestamp.nanoseconds() + 1));
+  }
+  return SnapshotVersion(Timestamp(timestamp.seconds() + 1, 0));
+}
+
+}  // namespace
+
 MemoryRemoteDocumentCache::MemoryRemoteDocumentCache(
     MemoryPersistence* persistence) {
   persistence_ = persistence;
@@ -43,22 +61,57 @@ MemoryRemoteDocumentCache::MemoryRemoteDocumentCache(
 
 void MemoryRemoteDocumentCache::Add(const MutableDocument& document,
                                     const model::SnapshotVersion& read_time) {
+  const DocumentKey& key = document.key();
+  const ResourcePath& collection_path = key.collection_path();
+  Collection& collection = collections_[collection_path];
+
+  auto existing = collection.entries.find(key);
+  if (existing != collection.entries.end()) {
+    collection.by_read_time.erase({existing->second.read_time, key});
+    collection.by_key.erase(key);
+    collection.entries.erase(existing);
+  }
+
   // Note: We create an explicit copy to prevent further modifications.
-  docs_ = docs_.insert(document.key(), std::make_pair(document, read_time));
+  collection.entries.emplace(key, Entry{document, read_time});
+  collection.by_read_time.emplace(read_time, key);
+  collection.by_key.insert(key);
 
-  persistence_->index_manager()->AddToCollectionParentIndex(
-      document.key().path().PopLast());
+  persistence_->index_manager()->AddToCollectionParentIndex(collection_path);
 }
 
 void MemoryRemoteDocumentCache::Remove(const DocumentKey& key) {
-  docs_ = docs_.erase(key);
+  auto collection = collections_.find(key.collection_path());
+  if (collection == collections_.end()) {
+    return;
+  }
+
+  auto existing = collection->second.entries.find(key);
+  if (existing == collection->second.entries.end()) {
+    return;
+  }
+
+  collection->second.by_read_time.erase({existing->second.read_time, key});
+  collection->second.by_key.erase(key);
+  collection->second.entries.erase(existing);
+  if (collection->second.entries.empty()) {
+    collections_.erase(collection);
+  }
 }
 
 MutableDocument MemoryRemoteDocumentCache::Get(const DocumentKey& key) {
-  const auto& entry = docs_.get(key);
+  QueryProfile::CountDocuments(1, 0);
+  auto collection = collections_.find(key.collection_path());
+  if (collection == collections_.end()) {
+    return MutableDocument::InvalidDocument(key);
+  }
+
+  auto found = collection->second.entries.find(key);
   // Note: We create an explicit copy to prevent modifications of the backing
   // data.
-  return entry ? entry->first.Clone() : MutableDocument::InvalidDocument(key);
+  return found != collection->second.entries.end()
+             ? found->second.document.Clone()
+             : MutableDocument::InvalidDocument(key);
 }
 
 MutableDocumentMap MemoryRemoteDocumentCache::GetAll(
@@ -81,21 +134,24 @@ MutableDocumentMap MemoryRemoteDocumentCache::GetMatching(
 
   MutableDocumentMap results;
 
-  // Documents are ordered by key, so we can use a prefix scan to narrow down
-  // the documents we need to match the query against.
-  DocumentKey prefix{query.path().Append("")};
-  for (auto it = docs_.lower_bound(prefix); it != docs_.end(); ++it) {
-    const DocumentKey& key = it->first;
-    if (!query.path().IsPrefixOf(key.path())) {
-      break;
-    }
-    const MutableDocument& document = it->second.first;
-    if (!document.is_found_document()) {
-      continue;
-    }
+  // Documents are partitioned by collection, so only the immediate children of
+  // the query path are visited. Within the collection, entries are ordered by
+  // read time, so we can skip straight to documents read after
+  // `since_read_time`.
+  auto collection = collections_.find(query.path());
+  if (collection == collections_.end()) {
+    return results;
+  }
 
-    const SnapshotVersion& read_time = it->second.second;
-    if (read_time <= since_read_time) {
+  const Collection& entries = collection->second;
+  auto it = entries.by_read_time.lower_bound(
+      {NextReadTime(since_read_time), DocumentKey::Empty()});
+  size_t scanned = 0;
+  for (; it != entries.by_read_time.end(); ++it) {
+    ++scanned;
+    const DocumentKey& key = it->second;
+    const MutableDocument& document = entries.entries.at(key).document;
+    if (!document.is_found_document()) {
       continue;
     }
 
@@ -107,6 +163,46 @@ MutableDocumentMap MemoryRemoteDocumentCache::GetMatching(
     // data.
     results = results.insert(key, document.Clone());
   }
+  QueryProfile::CountDocuments(scanned, 0);
+  return results;
+}
+
+std::vector<MutableDocumentMap>
+MemoryRemoteDocumentCache::GetMatchingCollectionGroup(
+    const Query& query,
+    const std::vector<ResourcePath>& collections,
+    const SnapshotVersion& since_read_time) {
+  // Each collection is a direct lookup into its own partition, so there's
+  // nothing to gain from scanning them concurrently.
+  std::vector<MutableDocumentMap> results;
+  results.reserve(collections.size());
+  for (const ResourcePath& collection : collections) {
+    results.push_back(GetMatching(query.AsCollectionQueryAtPath(collection),
+                                  since_read_time));
+  }
+  return results;
+}
+
+MutableDocumentMap MemoryRemoteDocumentCache::GetPage(
+    const ResourcePath& collection,
+    const DocumentKey& start_after,
+    size_t limit) {
+  MutableDocumentMap results;
+  auto found = collections_.find(collection);
+  if (found == collections_.end() || limit == 0) {
+    return results;
+  }
+
+  // Seek to the first key after `start_after` rather than rescanning the
+  // collection, so that reading a collection page by page stays linear.
+  const Collection& entries = found->second;
+  for (auto it = entries.by_key.upper_bound(start_after);
+       it != entries.by_key.end() && results.size() < limit; ++it) {
+    const MutableDocument& document = entries.entries.at(*it).document;
+    if (document.is_found_document()) {
+      results = results.insert(*it, document.Clone());
+    }
+  }
   return results;
 }
 
@@ -114,23 +210,37 @@ std::vector<DocumentKey> MemoryRemoteDocumentCache::RemoveOrphanedDocuments(
     MemoryLruReferenceDelegate* reference_delegate,
     ListenSequenceNumber upper_bound) {
   std::vector<DocumentKey> removed;
-  auto updated_docs = docs_;
-  for (const auto& kv : docs_) {
-    const DocumentKey& key = kv.first;
-    if (!reference_delegate->IsPinnedAtSequenceNumber(upper_bound, key)) {
-      updated_docs = updated_docs.erase(key);
-      removed.push_back(key);
+  for (auto collection = collections_.begin();
+       collection != collections_.end();) {
+    Collection& entries = collection->second;
+    for (auto it = entries.entries.begin(); it != entries.entries.end();) {
+      const DocumentKey& key = it->first;
+      if (!reference_delegate->IsPinnedAtSequenceNumber(upper_bound, key)) {
+        removed.push_back(key);
+        entries.by_read_time.erase({it->second.read_time, key});
+        entries.by_key.erase(key);
+        it = entries.entries.erase(it);
+      } else {
+        ++it;
+      }
+    }
+
+    if (entries.entries.empty()) {
+      collection = collections_.erase(collection);
+    } else {
+      ++collection;
     }
   }
-  docs_ = updated_docs;
   return removed;
 }
 
 int64_t MemoryRemoteDocumentCache::CalculateByteSize(const Sizer& sizer) {
   int64_t count = 0;
-  for (const auto& kv : docs_) {
-    const MutableDocument& document = kv.second.first;
-    count += sizer.CalculateByteSize(document);
+  for (const auto& collection : collections_) {
+    for (const auto& kv : collection.second.entries) {
+      const MutableDocument& document = kv.second.document;
+      count += sizer.CalculateByteSize(document);
+    }
   }
   return count;
 }
@@ -17,14 +17,17 @@
 #ifndef FIRESTORE_CORE_SRC_LOCAL_MEMORY_REMOTE_DOCUMENT_CACHE_H_
 #define FIRESTORE_CORE_SRC_LOCAL_MEMORY_REMOTE_DOCUMENT_CACHE_H_
 
+#include <set>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
-#include "Firestore/core/src/immutable/sorted_map.h"
 #include "Firestore/core/src/local/remote_document_cache.h"
 #include "Firestore/core/src/model/document_key.h"
 #include "Firestore/core/src/model/model_fwd.h"
 #include "Firestore/core/src/model/mutable_document.h"
+#include "Firestore/core/src/model/resource_path.h"
+#include "Firestore/core/src/model/snapshot_version.h"
 #include "Firestore/core/src/model/types.h"
 
 namespace firebase {
@@ -35,6 +38,16 @@ class MemoryLruReferenceDelegate;
 class MemoryPersistence;
 class Sizer;
 
+/**
+ * An in-memory implementation of RemoteDocumentCache.
+ *
+ * Documents are partitioned by their parent collection path. Each partition
+ * keeps a hash map from key to document, making point lookups O(1), and
+ * indexes ordered by read time and by key, so that collection scans only ever
+ * visit the immediate children of the collection, index-free queries only
+ * visit the documents read after their last limbo-free snapshot, and each
+ * page of a paged read seeks straight to where the previous page ended.
+ */
 class MemoryRemoteDocumentCache : public RemoteDocumentCache {
  public:
   explicit MemoryRemoteDocumentCache(MemoryPersistence* persistence);
@@ -48,6 +61,13 @@ class MemoryRemoteDocumentCache : public RemoteDocumentCache {
   model::MutableDocumentMap GetMatching(
       const core::Query& query,
       const model::SnapshotVersion& since_read_time) override;
+  std::vector<model::MutableDocumentMap> GetMatchingCollectionGroup(
+      const core::Query& query,
+      const std::vector<model::ResourcePath>& collections,
+      const model::SnapshotVersion& since_read_time) override;
+  model::MutableDocumentMap GetPage(const model::ResourcePath& collection,
+                                    const model::DocumentKey& start_after,
+                                    size_t limit) override;
 
   std::vector<model::DocumentKey> RemoveOrphanedDocuments(
       MemoryLruReferenceDelegate* reference_delegate,
@@ -56,11 +76,34 @@ class MemoryRemoteDocumentCache : public RemoteDocumentCache {
   int64_t CalculateByteSize(const Sizer& sizer);
 
  private:
+  struct Entry {
+    model::MutableDocument document;
+    model::SnapshotVersion read_time;
+  };
+
+  using ReadTimeAndKey = std::pair<model::SnapshotVersion, model::DocumentKey>;
+
+  /** The cached documents whose parent is a single collection. */
+  struct Collection {
+    std::unordered_map<model::DocumentKey, Entry, model::DocumentKeyHash>
+        entries;
+
+    /** The keys of `entries`, ordered by read time and then by key. */
+    std::set<ReadTimeAndKey> by_read_time;
+
+    /** The keys of `entries`, in key order. */
+    std::set<model::DocumentKey> by_key;
+  };
+
+  struct ResourcePathHash {
+    size_t operator()(const model::ResourcePath& path) const {
+      return path.Hash();
+    }
+  };
+
   /** Underlying cache of documents and their read times. */
-  immutable::SortedMap<
-      model::DocumentKey,
-      std::pair<model::MutableDocument, model::SnapshotVersion>>
-      docs_;
+  std::unordered_map<model::ResourcePath, Collection, ResourcePathHash>
+      collections_;
 
   // This instance is owned by MemoryPersistence; avoid a retain cycle.
   MemoryPersistence* persistence_;
@@ -79,6 +79,16 @@ class MutationQueue {
    */
   virtual void RemoveMutationBatch(const model::MutationBatch& batch) = 0;
 
+  /**
+   * Replaces the batch in the queue that has the same ID as `batch` with
+   * `batch`. The replacement must affect the same documents as the batch it
+   * replaces.
+   *
+   * This is only valid for batches that haven't been sent to the backend yet,
+   * and is used to merge writes to the same document into a single batch.
+   */
+  virtual void ReplaceMutationBatch(const model::MutationBatch& batch) = 0;
+
   /** Gets all mutation batches in the mutation queue. */
   // TODO(mikelehen): PERF: Current consumer only needs mutated keys; if we can
   // provide that cheaply, we should replace this.
@@ -131,6 +141,17 @@ class MutationQueue {
   virtual std::vector<model::MutationBatch> AllMutationBatchesAffectingQuery(
       const core::Query& query) = 0;
 
+  /**
+   * Finds all mutation batches that could affect documents that are immediate
+   * children of any of the given collections, as needed by a collection group
+   * query whose parents are already known. As with
+   * `AllMutationBatchesAffectingQuery`, the caller still has to check each
+   * mutation in the returned batches.
+   */
+  virtual std::vector<model::MutationBatch>
+  AllMutationBatchesAffectingCollections(
+      const std::vector<model::ResourcePath>& collections) = 0;
+
   /** Loads the mutation batch with the given batch_id. */
   virtual absl::optional<model::MutationBatch> LookupMutationBatch(
       model::BatchId batch_id) = 0;
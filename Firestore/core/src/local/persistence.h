@@ -18,8 +18,10 @@
 #define FIRESTORE_CORE_SRC_LOCAL_PERSISTENCE_H_
 
 #include <functional>
+#include <memory>
 #include <utility>
 
+#include "Firestore/core/src/local/mutation_queue.h"
 #include "Firestore/core/src/model/types.h"
 #include "absl/strings/string_view.h"
 
@@ -35,7 +37,6 @@ namespace local {
 
 class BundleCache;
 class IndexManager;
-class MutationQueue;
 class ReferenceDelegate;
 class RemoteDocumentCache;
 class TargetCache;
@@ -157,9 +158,62 @@ class Persistence {
     return result;
   }
 
+  /**
+   * Returns a new MutationQueue for the given user that is only read from
+   * within `RunReadOnly`, or nullptr if this persistence layer can't be read
+   * concurrently with its transactions. The queue shares no state with the one
+   * returned by `GetMutationQueueForUser`.
+   */
+  virtual std::unique_ptr<MutationQueue> NewMutationQueueForReading(
+      const credentials::User& user) {
+    (void)user;
+    return nullptr;
+  }
+
+  /**
+   * Accepts a function that only reads and runs it against a consistent view of
+   * the stored data.
+   *
+   * If `NewMutationQueueForReading` returns a queue, this may be called from
+   * any thread, concurrently with transactions started by `Run`. Only the
+   * caches, the index manager and queues returned by
+   * `NewMutationQueueForReading` may be used within `block`. Otherwise it must
+   * be called where `Run` is.
+   *
+   * @param label A semi-unique name for the transaction, for logging.
+   * @param block A void-returning function to be executed within the
+   *     transaction.
+   */
+  template <typename F>
+  auto RunReadOnly(absl::string_view label, F block) ->
+      typename std::enable_if<std::is_same<void, decltype(block())>::value,
+                              void>::type {
+    RunReadOnlyInternal(label, std::forward<F>(block));
+  }
+
+  /**
+   * Accepts a function that only reads, runs it against a consistent view of
+   * the stored data, and returns its result. See the overload above.
+   */
+  template <typename F>
+  auto RunReadOnly(absl::string_view label, F block) ->
+      typename std::enable_if<!std::is_same<void, decltype(block())>::value,
+                              decltype(block())>::type {
+    decltype(block()) result;
+
+    RunReadOnlyInternal(label, [&]() mutable { result = block(); });
+
+    return result;
+  }
+
  private:
   virtual void RunInternal(absl::string_view label,
                            std::function<void()> block) = 0;
+
+  virtual void RunReadOnlyInternal(absl::string_view label,
+                                   std::function<void()> block) {
+    RunInternal(label, std::move(block));
+  }
 };
 
 }  // namespace local
@@ -21,6 +21,7 @@
 #include "Firestore/core/src/core/query.h"
 #include "Firestore/core/src/core/target.h"
 #include "Firestore/core/src/local/local_documents_view.h"
+#include "Firestore/core/src/local/query_profile.h"
 #include "Firestore/core/src/model/document.h"
 #include "Firestore/core/src/model/document_set.h"
 #include "Firestore/core/src/model/mutable_document.h"
@@ -50,12 +51,15 @@ DocumentMap QueryEngine::GetDocumentsMatchingQuery(
   // lookups. It is more efficient to scan all documents in a collection, rather
   // than to perform individual lookups.
   if (query.MatchesAllDocuments()) {
+    QueryProfile::RecordStrategy(QueryStrategy::FullScanMatchesAllDocuments);
     return ExecuteFullCollectionScan(query);
   }
 
   // Queries that have never seen a snapshot without limbo free documents should
   // also be run as a full collection scan.
   if (last_limbo_free_snapshot_version == SnapshotVersion::None()) {
+    QueryProfile::RecordStrategy(
+        QueryStrategy::FullScanWithoutLimboFreeSnapshot);
     return ExecuteFullCollectionScan(query);
   }
 
@@ -65,9 +69,11 @@ DocumentMap QueryEngine::GetDocumentsMatchingQuery(
   if (query.limit_type() != LimitType::None &&
       NeedsRefill(query.limit_type(), previous_results, remote_keys,
                   last_limbo_free_snapshot_version)) {
+    QueryProfile::RecordStrategy(QueryStrategy::FullScanNeedsRefill);
     return ExecuteFullCollectionScan(query);
   }
 
+  QueryProfile::RecordStrategy(QueryStrategy::IndexFree);
   LOG_DEBUG("Re-using previous result from %s to execute query: %s",
             last_limbo_free_snapshot_version.ToString(), query.ToString());
 
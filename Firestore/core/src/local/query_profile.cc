@@ -0,0 +1,106 @@
+/*
+ * Copyright 2021 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Firestore/core/src/local/query_profile.h"
+
+#include "absl/strings/str_cat.h"
+
+namespace firebase {
+namespace firestore {
+namespace local {
+
+namespace {
+
+thread_local QueryProfile* current_profile = nullptr;
+
+const char* StrategyName(QueryStrategy strategy) {
+  switch (strategy) {
+    case QueryStrategy::IndexFree:
+      return "IndexFree";
+    case QueryStrategy::FullScanMatchesAllDocuments:
+      return "FullScanMatchesAllDocuments";
+    case QueryStrategy::FullScanWithoutLimboFreeSnapshot:
+      return "FullScanWithoutLimboFreeSnapshot";
+    case QueryStrategy::FullScanNeedsRefill:
+      return "FullScanNeedsRefill";
+  }
+  return "Unknown";
+}
+
+double Milliseconds(QueryProfile::Duration duration) {
+  return static_cast<double>(duration.count()) / 1000;
+}
+
+}  // namespace
+
+QueryProfile* QueryProfile::Current() {
+  return current_profile;
+}
+
+void QueryProfile::CountDocuments(size_t scanned, size_t decoded) {
+  if (QueryProfile* profile = current_profile) {
+    profile->documents_scanned += scanned;
+    profile->documents_decoded += decoded;
+  }
+}
+
+void QueryProfile::CountMutationBatches(size_t count) {
+  if (QueryProfile* profile = current_profile) {
+    profile->mutation_batches_applied += count;
+  }
+}
+
+void QueryProfile::RecordStrategy(QueryStrategy strategy) {
+  if (QueryProfile* profile = current_profile) {
+    profile->strategy = strategy;
+  }
+}
+
+std::string QueryProfile::ToString() const {
+  return absl::StrCat(
+      "strategy: ", StrategyName(strategy), ", scanned: ", documents_scanned,
+      ", decoded: ", documents_decoded,
+      ", mutation batches: ", mutation_batches_applied,
+      ", matched: ", documents_matched,
+      ", read documents: ", Milliseconds(read_documents_time),
+      "ms, apply mutations: ", Milliseconds(apply_mutations_time),
+      "ms, total: ", Milliseconds(total_time), "ms");
+}
+
+ScopedQueryProfile::ScopedQueryProfile(QueryProfile* profile)
+    : previous_(current_profile) {
+  current_profile = profile;
+}
+
+ScopedQueryProfile::~ScopedQueryProfile() {
+  current_profile = previous_;
+}
+
+QueryPhaseTimer::QueryPhaseTimer(QueryProfile::Duration QueryProfile::*phase)
+    : profile_(current_profile), phase_(phase) {
+  if (profile_) start_ = QueryProfile::Clock::now();
+}
+
+QueryPhaseTimer::~QueryPhaseTimer() {
+  if (profile_) {
+    profile_->*phase_ += std::chrono::duration_cast<QueryProfile::Duration>(
+        QueryProfile::Clock::now() - start_);
+  }
+}
+
+}  // namespace local
+}  // namespace firestore
+}  // namespace firebase
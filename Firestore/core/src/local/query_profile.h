@@ -0,0 +1,153 @@
+/*
+ * Copyright 2021 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FIRESTORE_CORE_SRC_LOCAL_QUERY_PROFILE_H_
+#define FIRESTORE_CORE_SRC_LOCAL_QUERY_PROFILE_H_
+
+#include <cstddef>
+#include <chrono>  // NOLINT(build/c++11)
+#include <string>
+
+namespace firebase {
+namespace firestore {
+namespace local {
+
+/** How the QueryEngine executed a query against the local cache. */
+enum class QueryStrategy {
+  /**
+   * Only the documents that matched the query at its last limbo-free snapshot
+   * were read, plus the documents that changed since.
+   */
+  IndexFree,
+
+  /** The collection was scanned because the query matches all of it. */
+  FullScanMatchesAllDocuments,
+
+  /** The collection was scanned because the query was never limbo-free. */
+  FullScanWithoutLimboFreeSnapshot,
+
+  /**
+   * The collection was scanned because the previous results of a limit query
+   * may no longer fill the limit.
+   */
+  FullScanNeedsRefill,
+};
+
+/**
+ * Describes how a query was executed against the local cache, and where the
+ * time went. Collected by `LocalStore::ExecuteQuery` when asked for.
+ *
+ * Components that take part in executing a query report to the profile that
+ * is current on their thread (see `ScopedQueryProfile`), so that collecting a
+ * profile needs no changes to their interfaces. When no profile is being
+ * collected, reporting costs a thread-local lookup per call.
+ */
+struct QueryProfile {
+  using Clock = std::chrono::steady_clock;
+  using Duration = std::chrono::microseconds;
+
+  /**
+   * Returns the profile being collected on this thread, or nullptr if there
+   * is none.
+   */
+  static QueryProfile* Current();
+
+  /**
+   * Records that `scanned` entries of the remote document cache were read, of
+   * which `decoded` were parsed into documents.
+   */
+  static void CountDocuments(size_t scanned, size_t decoded);
+
+  /** Records that `count` mutation batches were applied to documents. */
+  static void CountMutationBatches(size_t count);
+
+  /** Records the strategy chosen by the QueryEngine. */
+  static void RecordStrategy(QueryStrategy strategy);
+
+  /** Returns a description like "strategy: IndexFree, scanned: 3, ...". */
+  std::string ToString() const;
+
+  QueryStrategy strategy = QueryStrategy::FullScanMatchesAllDocuments;
+
+  /** Entries of the remote document cache that were read. */
+  size_t documents_scanned = 0;
+
+  /**
+   * Documents that were parsed from persistence. Always zero with memory
+   * persistence, which keeps documents parsed.
+   */
+  size_t documents_decoded = 0;
+
+  /** Mutation batches that were applied to the documents read. */
+  size_t mutation_batches_applied = 0;
+
+  /** Documents in the result. */
+  size_t documents_matched = 0;
+
+  /** Time spent reading documents from the remote document cache. */
+  Duration read_documents_time{0};
+
+  /** Time spent reading mutation batches and applying them. */
+  Duration apply_mutations_time{0};
+
+  /** Time spent executing the query, including the phases above. */
+  Duration total_time{0};
+};
+
+/**
+ * Makes a profile current on this thread for the lifetime of the scope, so
+ * that the query executed in the scope is recorded in it. Restores the
+ * previously current profile on destruction.
+ */
+class ScopedQueryProfile {
+ public:
+  /** `profile` may be nullptr, in which case nothing is recorded. */
+  explicit ScopedQueryProfile(QueryProfile* profile);
+
+  ~ScopedQueryProfile();
+
+  ScopedQueryProfile(const ScopedQueryProfile&) = delete;
+  ScopedQueryProfile& operator=(const ScopedQueryProfile&) = delete;
+
+ private:
+  QueryProfile* previous_ = nullptr;
+};
+
+/**
+ * Adds the time from its construction to its destruction to one of the
+ * durations of the current profile. Doesn't read the clock if there is no
+ * current profile.
+ */
+class QueryPhaseTimer {
+ public:
+  explicit QueryPhaseTimer(QueryProfile::Duration QueryProfile::*phase);
+
+  ~QueryPhaseTimer();
+
+  QueryPhaseTimer(const QueryPhaseTimer&) = delete;
+  QueryPhaseTimer& operator=(const QueryPhaseTimer&) = delete;
+
+ private:
+  QueryProfile* profile_ = nullptr;
+  QueryProfile::Duration QueryProfile::*phase_ = nullptr;
+  QueryProfile::Clock::time_point start_;
+};
+
+}  // namespace local
+}  // namespace firestore
+}  // namespace firebase
+
+#endif  // FIRESTORE_CORE_SRC_LOCAL_QUERY_PROFILE_H_
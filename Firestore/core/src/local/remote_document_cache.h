@@ -17,6 +17,9 @@
 #ifndef FIRESTORE_CORE_SRC_LOCAL_REMOTE_DOCUMENT_CACHE_H_
 #define FIRESTORE_CORE_SRC_LOCAL_REMOTE_DOCUMENT_CACHE_H_
 
+#include <cstddef>
+#include <vector>
+
 #include "Firestore/core/src/model/model_fwd.h"
 
 namespace firebase {
@@ -90,6 +93,44 @@ class RemoteDocumentCache {
   virtual model::MutableDocumentMap GetMatching(
       const core::Query& query,
       const model::SnapshotVersion& since_read_time) = 0;
+
+  /**
+   * Executes a collection group query against the cached Document entries of
+   * each of the given collections.
+   *
+   * This is equivalent to calling `GetMatching` once per collection, but
+   * allows implementations to scan all collections in a single pass and to
+   * process their documents concurrently.
+   *
+   * @param query The collection group query to match documents against.
+   * @param collections The paths of the collections in the group to scan.
+   * @param since_read_time If not set to SnapshotVersion::None(), return only
+   * documents that have been read since this snapshot version (exclusive).
+   * @return The set of matching documents of each collection, in the same
+   * order as `collections`.
+   */
+  virtual std::vector<model::MutableDocumentMap> GetMatchingCollectionGroup(
+      const core::Query& query,
+      const std::vector<model::ResourcePath>& collections,
+      const model::SnapshotVersion& since_read_time) = 0;
+
+  /**
+   * Returns a page of the cached Document entries of a single collection, in
+   * key order. Used to read the results of large queries a page at a time.
+   *
+   * Cached DeletedDocument entries are skipped and don't count towards
+   * `limit`.
+   *
+   * @param collection The path of the collection to read.
+   * @param start_after The page contains documents whose keys sort after this
+   * key. The empty key starts at the beginning of the collection.
+   * @param limit The maximum number of documents to return. If fewer are
+   * returned, the collection has no more documents after the page.
+   */
+  virtual model::MutableDocumentMap GetPage(
+      const model::ResourcePath& collection,
+      const model::DocumentKey& start_after,
+      size_t limit) = 0;
 };
 
 }  // namespace local
@@ -0,0 +1,66 @@
+/*
+ * Copyright 2021 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Firestore/core/src/local/startup_timings.h"
+
+#include <utility>
+
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+
+namespace firebase {
+namespace firestore {
+namespace local {
+
+StartupTimings::StartupTimings() : phase_start_(Clock::now()) {
+}
+
+void StartupTimings::EndPhase(std::string name) {
+  Clock::time_point now = Clock::now();
+  phases_.push_back(
+      {std::move(name),
+       std::chrono::duration_cast<Duration>(now - phase_start_)});
+  phase_start_ = now;
+}
+
+void StartupTimings::Append(const std::string& prefix,
+                            const StartupTimings& other) {
+  for (const Phase& phase : other.phases_) {
+    phases_.push_back({absl::StrCat(prefix, phase.name), phase.duration});
+  }
+  phase_start_ = Clock::now();
+}
+
+StartupTimings::Duration StartupTimings::total() const {
+  Duration result{0};
+  for (const Phase& phase : phases_) {
+    result += phase.duration;
+  }
+  return result;
+}
+
+std::string StartupTimings::ToString() const {
+  return absl::StrJoin(
+      phases_, ", ", [](std::string* out, const Phase& phase) {
+        absl::StrAppend(out, phase.name, ": ",
+                        static_cast<double>(phase.duration.count()) / 1000,
+                        "ms");
+      });
+}
+
+}  // namespace local
+}  // namespace firestore
+}  // namespace firebase
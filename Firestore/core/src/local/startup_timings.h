@@ -0,0 +1,76 @@
+/*
+ * Copyright 2021 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FIRESTORE_CORE_SRC_LOCAL_STARTUP_TIMINGS_H_
+#define FIRESTORE_CORE_SRC_LOCAL_STARTUP_TIMINGS_H_
+
+#include <chrono>  // NOLINT(build/c++11)
+#include <string>
+#include <vector>
+
+namespace firebase {
+namespace firestore {
+namespace local {
+
+/**
+ * Records how long each phase of starting up the client took, so that slow
+ * startups can be attributed to opening the database, migrations and so on.
+ *
+ * A phase runs from the end of the previous phase (or from the construction
+ * of the timings) until `EndPhase` is called.
+ */
+class StartupTimings {
+ public:
+  using Clock = std::chrono::steady_clock;
+  using Duration = std::chrono::microseconds;
+
+  struct Phase {
+    std::string name;
+    Duration duration;
+  };
+
+  StartupTimings();
+
+  /** Ends the current phase, records it as `name` and starts the next. */
+  void EndPhase(std::string name);
+
+  /**
+   * Ends the current phase by recording the phases of `other` in its place,
+   * with their names prefixed with `prefix`, and starts the next phase. Used
+   * when the current phase was timed in more detail elsewhere.
+   */
+  void Append(const std::string& prefix, const StartupTimings& other);
+
+  const std::vector<Phase>& phases() const {
+    return phases_;
+  }
+
+  /** Returns the total duration of all recorded phases. */
+  Duration total() const;
+
+  /** Returns a description like "open: 1.5ms, migrations: 0.2ms". */
+  std::string ToString() const;
+
+ private:
+  Clock::time_point phase_start_;
+  std::vector<Phase> phases_;
+};
+
+}  // namespace local
+}  // namespace firestore
+}  // namespace firebase
+
+#endif  // FIRESTORE_CORE_SRC_LOCAL_STARTUP_TIMINGS_H_
@@ -18,6 +18,7 @@
 #define FIRESTORE_CORE_SRC_MODEL_DOCUMENT_H_
 
 #include <iosfwd>
+#include <memory>
 #include <string>
 #include <utility>
 
@@ -52,8 +53,37 @@ class Document {
     return document_.ToString();
   }
 
+  /**
+   * Returns a copy of this document that remembers `sort_key` as its sort key
+   * under `ordering`, an object that identifies the ordering for as long as
+   * the key is kept.
+   */
+  Document WithSortKey(std::shared_ptr<const void> ordering,
+                       std::string sort_key) const {
+    Document result = *this;
+    result.sort_key_ = std::make_shared<const SortKey>(
+        SortKey{std::move(ordering), std::move(sort_key)});
+    return result;
+  }
+
+  /**
+   * Returns the sort key remembered for `ordering` by `WithSortKey`, or null
+   * if there's none.
+   */
+  const std::string* sort_key(const void* ordering) const {
+    return sort_key_ && sort_key_->ordering.get() == ordering
+               ? &sort_key_->bytes
+               : nullptr;
+  }
+
  private:
+  struct SortKey {
+    std::shared_ptr<const void> ordering;
+    std::string bytes;
+  };
+
   MutableDocument document_;
+  std::shared_ptr<const SortKey> sort_key_;
 };
 
 inline bool operator==(const Document& lhs, const Document& rhs) {
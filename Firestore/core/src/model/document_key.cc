@@ -16,37 +16,196 @@
 
 #include "Firestore/core/src/model/document_key.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>  // NOLINT(build/c++11)
+#include <new>
 #include <ostream>
+#include <unordered_map>
 #include <utility>
 
 #include "Firestore/core/src/model/resource_path.h"
 #include "Firestore/core/src/util/comparison.h"
 #include "Firestore/core/src/util/hard_assert.h"
 #include "Firestore/core/src/util/hashing.h"
+#include "absl/hash/hash.h"
 
 namespace firebase {
 namespace firestore {
 namespace model {
 namespace {
 
+using util::ComparisonResult;
+
 void AssertValidPath(const ResourcePath& path) {
   HARD_ASSERT(DocumentKey::IsDocumentKey(path), "invalid document key path: %s",
               path.CanonicalString());
 }
 
+/** An interned collection path, along with its hash. */
+struct CollectionPath {
+  CollectionPath(ResourcePath path, size_t hash)
+      : path(std::move(path)), hash(hash) {
+  }
+
+  ResourcePath path;
+  size_t hash;
+};
+
+struct ResourcePathHash {
+  size_t operator()(const ResourcePath& path) const {
+    return path.Hash();
+  }
+};
+
+/**
+ * Interns the collection paths of document keys. A path is shared by the keys
+ * of all documents in the collection for as long as any of them exists.
+ */
+class CollectionPathTable {
+ public:
+  static CollectionPathTable& Instance() {
+    static auto* table = new CollectionPathTable();
+    return *table;
+  }
+
+  std::shared_ptr<const CollectionPath> Intern(ResourcePath&& path) {
+    size_t hash = path.Hash();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::weak_ptr<const CollectionPath>& entry = paths_[path];
+    std::shared_ptr<const CollectionPath> result = entry.lock();
+    if (!result) {
+      result = std::make_shared<const CollectionPath>(std::move(path), hash);
+      entry = result;
+      if (paths_.size() >= sweep_threshold_) Sweep();
+    }
+    return result;
+  }
+
+ private:
+  /**
+   * Removes the paths that are no longer used by any key, so that the table
+   * only grows with the number of collections in use.
+   */
+  void Sweep() {
+    for (auto it = paths_.begin(); it != paths_.end();) {
+      if (it->second.expired()) {
+        it = paths_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    sweep_threshold_ = std::max(kMinSweepThreshold, paths_.size() * 2);
+  }
+
+  static constexpr size_t kMinSweepThreshold = 1024;
+
+  std::mutex mutex_;
+  std::unordered_map<ResourcePath,
+                     std::weak_ptr<const CollectionPath>,
+                     ResourcePathHash>
+      paths_;
+  size_t sweep_threshold_ = kMinSweepThreshold;
+};
+
+constexpr size_t CollectionPathTable::kMinSweepThreshold;
+
 }  // namespace
 
-DocumentKey::DocumentKey() : path_{std::make_shared<ResourcePath>()} {
-}
+/**
+ * The shared state of a non-empty document key, allocated along with the
+ * bytes of the document ID that follow it.
+ */
+class DocumentKey::Rep {
+ public:
+  static const Rep* Create(std::shared_ptr<const CollectionPath> collection,
+                           absl::string_view document_id) {
+    void* memory = ::operator new(sizeof(Rep) + document_id.size());
+    Rep* rep = new (memory) Rep(std::move(collection), document_id.size());
+    std::memcpy(rep->document_id_data(), document_id.data(),
+                document_id.size());
+    return rep;
+  }
+
+  void Ref() const {
+    ref_count_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void Unref() const {
+    if (ref_count_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      this->~Rep();
+      ::operator delete(const_cast<Rep*>(this));
+    }
+  }
+
+  const CollectionPath& collection() const {
+    return *collection_;
+  }
+
+  absl::string_view document_id() const {
+    return absl::string_view(
+        reinterpret_cast<const char*>(this + 1), document_id_size_);
+  }
+
+ private:
+  Rep(std::shared_ptr<const CollectionPath> collection, size_t size)
+      : document_id_size_(static_cast<uint32_t>(size)),
+        collection_(std::move(collection)) {
+  }
+
+  char* document_id_data() {
+    return reinterpret_cast<char*>(this + 1);
+  }
+
+  mutable std::atomic<uint32_t> ref_count_{1};
+  uint32_t document_id_size_;
+  std::shared_ptr<const CollectionPath> collection_;
+};
 
 DocumentKey::DocumentKey(const ResourcePath& path)
-    : path_{std::make_shared<ResourcePath>(path)} {
-  AssertValidPath(*path_);
+    : DocumentKey(ResourcePath(path)) {
+}
+
+DocumentKey::DocumentKey(ResourcePath&& path) {
+  ResourcePath owned_path = std::move(path);
+  AssertValidPath(owned_path);
+  if (owned_path.empty()) return;
+
+  rep_ = Rep::Create(
+      CollectionPathTable::Instance().Intern(owned_path.PopLast()),
+      owned_path.last_segment());
+}
+
+DocumentKey::DocumentKey(const DocumentKey& other) : rep_(other.rep_) {
+  if (rep_) rep_->Ref();
+}
+
+DocumentKey::DocumentKey(DocumentKey&& other) noexcept : rep_(other.rep_) {
+  other.rep_ = nullptr;
+}
+
+DocumentKey& DocumentKey::operator=(const DocumentKey& other) {
+  if (other.rep_) other.rep_->Ref();
+  if (rep_) rep_->Unref();
+  rep_ = other.rep_;
+  return *this;
 }
 
-DocumentKey::DocumentKey(ResourcePath&& path)
-    : path_{std::make_shared<ResourcePath>(std::move(path))} {
-  AssertValidPath(*path_);
+DocumentKey& DocumentKey::operator=(DocumentKey&& other) noexcept {
+  if (this != &other) {
+    if (rep_) rep_->Unref();
+    rep_ = other.rep_;
+    other.rep_ = nullptr;
+  }
+  return *this;
+}
+
+DocumentKey::~DocumentKey() {
+  if (rep_) rep_->Unref();
 }
 
 DocumentKey DocumentKey::FromPathString(const std::string& path) {
@@ -75,12 +234,50 @@ bool DocumentKey::IsDocumentKey(const ResourcePath& path) {
   return path.size() % 2 == 0;
 }
 
-util::ComparisonResult DocumentKey::CompareTo(const DocumentKey& other) const {
-  return path().CompareTo(other.path());
+ComparisonResult DocumentKey::CompareTo(const DocumentKey& other) const {
+  if (rep_ == other.rep_) return ComparisonResult::Same;
+  if (!rep_ || !other.rep_) {
+    // The empty key sorts before all other keys.
+    return rep_ ? ComparisonResult::Descending : ComparisonResult::Ascending;
+  }
+
+  const ResourcePath& lhs_collection = collection_path();
+  const ResourcePath& rhs_collection = other.collection_path();
+  if (&lhs_collection == &rhs_collection) {
+    return util::Compare(document_id(), other.document_id());
+  }
+
+  // Compares the segments of the paths, where the document IDs are the last
+  // segments. One collection can be a prefix of the other.
+  size_t common_size = std::min(lhs_collection.size(), rhs_collection.size());
+  for (size_t i = 0; i < common_size; ++i) {
+    ComparisonResult result =
+        util::Compare(lhs_collection[i], rhs_collection[i]);
+    if (!util::Same(result)) return result;
+  }
+
+  if (lhs_collection.size() == rhs_collection.size()) {
+    return util::Compare(document_id(), other.document_id());
+  } else if (lhs_collection.size() < rhs_collection.size()) {
+    ComparisonResult result = util::Compare(
+        document_id(), absl::string_view(rhs_collection[common_size]));
+    return util::Same(result) ? ComparisonResult::Ascending : result;
+  } else {
+    ComparisonResult result = util::Compare(
+        absl::string_view(lhs_collection[common_size]), other.document_id());
+    return util::Same(result) ? ComparisonResult::Descending : result;
+  }
 }
 
 bool operator==(const DocumentKey& lhs, const DocumentKey& rhs) {
-  return lhs.path() == rhs.path();
+  if (lhs.rep_ == rhs.rep_) return true;
+  if (!lhs.rep_ || !rhs.rep_) return false;
+
+  // Interning makes equal collection paths the same object.
+  const CollectionPath& lhs_collection = lhs.rep_->collection();
+  const CollectionPath& rhs_collection = rhs.rep_->collection();
+  return &lhs_collection == &rhs_collection &&
+         lhs.document_id() == rhs.document_id();
 }
 
 bool operator<(const DocumentKey& lhs, const DocumentKey& rhs) {
@@ -91,29 +288,45 @@ bool operator>(const DocumentKey& lhs, const DocumentKey& rhs) {
 }
 
 size_t DocumentKey::Hash() const {
-  return util::Hash(ToString());
+  if (!rep_) return 0;
+  return util::Hash(rep_->collection().hash,
+                    absl::Hash<absl::string_view>()(document_id()));
 }
 
 std::string DocumentKey::ToString() const {
-  return path().CanonicalString();
+  if (!rep_) return "";
+  std::string result = collection_path().CanonicalString();
+  result += '/';
+  result.append(document_id().data(), document_id().size());
+  return result;
 }
 
 std::ostream& operator<<(std::ostream& os, const DocumentKey& key) {
   return os << key.ToString();
 }
 
-const ResourcePath& DocumentKey::path() const {
-  return path_ ? *path_ : Empty().path();
+ResourcePath DocumentKey::path() const {
+  if (!rep_) return ResourcePath{};
+  return collection_path().Append(std::string(document_id()));
+}
+
+const ResourcePath& DocumentKey::collection_path() const {
+  static const auto* empty = new ResourcePath();
+  return rep_ ? rep_->collection().path : *empty;
+}
+
+absl::string_view DocumentKey::document_id() const {
+  return rep_ ? rep_->document_id() : absl::string_view();
 }
 
 /** Returns true if the document is in the specified collection_id. */
 bool DocumentKey::HasCollectionId(const std::string& collection_id) const {
-  size_t size = path().size();
-  return size >= 2 && path()[size - 2] == collection_id;
+  const ResourcePath& collection = collection_path();
+  return !collection.empty() && collection.last_segment() == collection_id;
 }
 
 size_t DocumentKeyHash::operator()(const DocumentKey& key) const {
-  return util::Hash(key.path());
+  return key.Hash();
 }
 
 }  // namespace model
@@ -20,7 +20,6 @@
 #include <functional>
 #include <initializer_list>
 #include <iosfwd>
-#include <memory>
 #include <string>
 
 #include "absl/strings/string_view.h"
@@ -38,11 +37,16 @@ class ResourcePath;
 
 /**
  * DocumentKey represents the location of a document in the Firestore database.
+ *
+ * Keys are compact, since caches hold many of them: a key is a pointer to a
+ * single reference-counted allocation that holds the ID of the document and a
+ * shared reference to the path of its collection. Collection paths are
+ * interned, so all keys in a collection share the same path.
  */
 class DocumentKey {
  public:
   /** Creates a "blank" document key not associated with any document. */
-  DocumentKey();
+  DocumentKey() = default;
 
   /** Creates a new document key containing a copy of the given path. */
   explicit DocumentKey(const ResourcePath& path);
@@ -50,6 +54,12 @@ class DocumentKey {
   /** Creates a new document key, taking ownership of the given path. */
   explicit DocumentKey(ResourcePath&& path);
 
+  DocumentKey(const DocumentKey& other);
+  DocumentKey(DocumentKey&& other) noexcept;
+  DocumentKey& operator=(const DocumentKey& other);
+  DocumentKey& operator=(DocumentKey&& other) noexcept;
+  ~DocumentKey();
+
   /**
    * Creates and returns a new document key using '/' to split the string into
    * segments.
@@ -78,16 +88,34 @@ class DocumentKey {
 
   friend std::ostream& operator<<(std::ostream& os, const DocumentKey& key);
 
-  /** The path to the document. */
-  const ResourcePath& path() const;
+  /**
+   * The path to the document. The path is built on each call; prefer
+   * `collection_path()` and `document_id()` where they suffice.
+   */
+  ResourcePath path() const;
+
+  /**
+   * The path to the collection that contains the document, i.e. `path()`
+   * without its last segment. Empty for the empty key.
+   */
+  const ResourcePath& collection_path() const;
+
+  /** The ID of the document, i.e. the last segment of `path()`. */
+  absl::string_view document_id() const;
 
   /** Returns true if the document is in the specified collection_id. */
   bool HasCollectionId(const std::string& collection_id) const;
 
+  /** Returns true for the empty key, such as a default-constructed one. */
+  bool empty() const {
+    return rep_ == nullptr;
+  }
+
  private:
-  // This is an optimization to make passing DocumentKey around cheaper (it's
-  // copied often).
-  std::shared_ptr<const ResourcePath> path_;
+  class Rep;
+
+  // Null for the empty key.
+  const Rep* rep_ = nullptr;
 };
 
 inline bool operator!=(const DocumentKey& lhs, const DocumentKey& rhs) {
@@ -16,7 +16,9 @@
 
 #include "Firestore/core/src/model/document_set.h"
 
+#include <memory>
 #include <ostream>
+#include <string>
 #include <utility>
 
 #include "Firestore/core/src/immutable/sorted_set.h"
@@ -24,6 +26,7 @@
 #include "Firestore/core/src/util/hashing.h"
 #include "Firestore/core/src/util/to_string.h"
 #include "absl/algorithm/container.h"
+#include "absl/strings/string_view.h"
 
 namespace firebase {
 namespace firestore {
@@ -34,6 +37,22 @@ inline absl::optional<Document> none() {
   return absl::optional<Document>{};
 }
 
+/**
+ * Returns the sort key `doc` carries for `sort_key`, or otherwise computes it
+ * into `scratch`.
+ */
+absl::string_view SortKeyOf(
+    const std::shared_ptr<const DocumentComparator::SortKeyFunction>& sort_key,
+    const Document& doc,
+    std::string* scratch) {
+  const std::string* memoized = doc.sort_key(sort_key.get());
+  if (memoized) {
+    return *memoized;
+  }
+  *scratch = (*sort_key)(doc);
+  return *scratch;
+}
+
 }  // namespace
 
 DocumentComparator DocumentComparator::ByKey() {
@@ -42,6 +61,27 @@ DocumentComparator DocumentComparator::ByKey() {
   });
 }
 
+DocumentComparator DocumentComparator::BySortKey(SortKeyFunction sort_key) {
+  auto shared_sort_key =
+      std::make_shared<const SortKeyFunction>(std::move(sort_key));
+  DocumentComparator result(
+      [shared_sort_key](const Document& lhs, const Document& rhs) {
+        std::string lhs_scratch;
+        std::string rhs_scratch;
+        return util::Compare(SortKeyOf(shared_sort_key, lhs, &lhs_scratch),
+                             SortKeyOf(shared_sort_key, rhs, &rhs_scratch));
+      });
+  result.sort_key_ = std::move(shared_sort_key);
+  return result;
+}
+
+Document DocumentComparator::WithSortKey(const Document& doc) const {
+  if (!sort_key_ || doc.sort_key(sort_key_.get())) {
+    return doc;
+  }
+  return doc.WithSortKey(sort_key_, (*sort_key_)(doc));
+}
+
 DocumentSet::DocumentSet(DocumentComparator&& comparator)
     : index_{}, sorted_set_{std::move(comparator)} {
 }
@@ -99,8 +139,11 @@ DocumentSet DocumentSet::insert(
   const DocumentKey& key = (*document)->key();
   DocumentSet removed = erase(key);
 
-  DocumentMap index = removed.index_.insert(key, *document);
-  SetType set = removed.sorted_set_.insert(*document);
+  // The document is compared with many others on its way into the set, and
+  // again whenever it is looked up later, so its sort key is computed once.
+  Document doc = comparator().WithSortKey(*document);
+  DocumentMap index = removed.index_.insert(key, doc);
+  SetType set = removed.sorted_set_.insert(doc);
   return {std::move(index), std::move(set)};
 }
 
@@ -17,6 +17,7 @@
 #ifndef FIRESTORE_CORE_SRC_MODEL_DOCUMENT_SET_H_
 #define FIRESTORE_CORE_SRC_MODEL_DOCUMENT_SET_H_
 
+#include <functional>
 #include <iosfwd>
 #include <memory>
 #include <string>
@@ -35,14 +36,33 @@ namespace model {
 
 class DocumentComparator : public util::FunctionComparator<Document> {
  public:
+  using SortKeyFunction = std::function<std::string(const Document&)>;
+
   using FunctionComparator<Document>::FunctionComparator;
 
   static DocumentComparator ByKey();
 
+  /**
+   * Returns a comparator that orders documents by the bytes of the sort keys
+   * that `sort_key` returns for them. Documents that carry their key, see
+   * `WithSortKey`, aren't encoded again when they are compared.
+   */
+  static DocumentComparator BySortKey(SortKeyFunction sort_key);
+
+  /**
+   * Returns a copy of `doc` that carries its sort key if this comparator
+   * compares sort keys, or `doc` itself otherwise.
+   */
+  Document WithSortKey(const Document& doc) const;
+
   // TODO(wilhuff): Remove this using statement
   // This exists to put these two overloads on equal footing. Once the overload
   // below is gone, this using statement can be removed as well.
   using FunctionComparator<Document>::Compare;
+
+ private:
+  // Identifies the ordering of the sort keys that documents carry.
+  std::shared_ptr<const SortKeyFunction> sort_key_;
 };
 
 /**
@@ -65,7 +85,8 @@ class DocumentSet : public immutable::SortedContainer {
 
   /**
    * Creates a new, empty DocumentSet sorted by the given comparator, then by
-   * keys.
+   * keys. If the comparator compares sort keys, the set keeps the key of each
+   * document it holds.
    */
   explicit DocumentSet(DocumentComparator&& comparator);
 
@@ -76,6 +76,7 @@ class MutationResult;
 class ObjectValue;
 class PatchMutation;
 class Precondition;
+class ResourcePath;
 class SetMutation;
 class SnapshotVersion;
 class TransformOperation;
@@ -98,7 +98,7 @@ MutableDocument& MutableDocument::SetHasLocalMutations() {
 MutableDocument MutableDocument::Clone() const {
   return MutableDocument(
       key_, document_type_, version_,
-      std::make_shared<ObjectValue>(DeepClone(value_->Get())), document_state_);
+      std::make_shared<ObjectValue>(*value_), document_state_);
 }
 
 size_t MutableDocument::Hash() const {
@@ -18,6 +18,7 @@
 
 #include <cstdlib>
 #include <ostream>
+#include <set>
 #include <sstream>
 #include <utility>
 
@@ -25,6 +26,8 @@
 #include "Firestore/core/src/model/field_path.h"
 #include "Firestore/core/src/model/mutable_document.h"
 #include "Firestore/core/src/model/object_value.h"
+#include "Firestore/core/src/model/patch_mutation.h"
+#include "Firestore/core/src/model/set_mutation.h"
 #include "Firestore/core/src/nanopb/message.h"
 #include "Firestore/core/src/util/hard_assert.h"
 #include "Firestore/core/src/util/to_string.h"
@@ -160,6 +163,67 @@ size_t Mutation::Rep::Hash() const {
   return util::Hash(type(), key(), precondition(), field_transforms());
 }
 
+absl::optional<Mutation> CoalesceMutations(const Mutation& earlier,
+                                           const Mutation& later) {
+  auto is_set_or_patch = [](const Mutation& mutation) {
+    return (mutation.type() == Mutation::Type::Set ||
+            mutation.type() == Mutation::Type::Patch) &&
+           mutation.field_transforms().empty();
+  };
+  if (earlier.key() != later.key() || !is_set_or_patch(earlier) ||
+      !is_set_or_patch(later)) {
+    return absl::nullopt;
+  }
+
+  // A write without a precondition creates the document, so any precondition
+  // of the later write holds once the earlier one is applied. A later write
+  // that requires the document to exist fails exactly when an earlier one that
+  // does so fails; a later set would succeed on its own.
+  const Precondition& precondition = earlier.precondition();
+  const Precondition& later_precondition = later.precondition();
+  Precondition exists = Precondition::Exists(true);
+  bool compatible =
+      precondition.is_none()
+          ? later_precondition.is_none() || later_precondition == exists
+          : precondition == exists && later_precondition == exists;
+  if (!compatible) {
+    return absl::nullopt;
+  }
+
+  if (later.type() == Mutation::Type::Set) {
+    return SetMutation(later.key(), SetMutation(later).value(), precondition);
+  }
+
+  // Apply the later patch to the fields written by the earlier mutation.
+  bool earlier_is_set = earlier.type() == Mutation::Type::Set;
+  ObjectValue earlier_value = earlier_is_set
+                                  ? SetMutation(earlier).value()
+                                  : PatchMutation(earlier).value();
+  MutableDocument document = MutableDocument::FoundDocument(
+      earlier.key(), SnapshotVersion::None(), std::move(earlier_value));
+  later.ApplyToLocalView(document, Timestamp::Now());
+
+  if (earlier_is_set) {
+    return SetMutation(earlier.key(), document.data(), precondition);
+  }
+
+  const FieldMask& earlier_mask = PatchMutation(earlier).mask();
+  const FieldMask& later_mask = PatchMutation(later).mask();
+  std::set<FieldPath> union_fields(earlier_mask.begin(), earlier_mask.end());
+  union_fields.insert(later_mask.begin(), later_mask.end());
+
+  // A field already writes everything nested in it. Paths sort right after
+  // their prefixes, so it is enough to compare with the last path kept.
+  std::set<FieldPath> fields;
+  for (const FieldPath& field : union_fields) {
+    if (fields.empty() || !fields.rbegin()->IsPrefixOf(field)) {
+      fields.insert(fields.end(), field);
+    }
+  }
+  return PatchMutation(earlier.key(), document.data(),
+                       FieldMask(std::move(fields)), precondition);
+}
+
 std::ostream& operator<<(std::ostream& os, const Mutation& mutation) {
   return os << mutation.ToString();
 }
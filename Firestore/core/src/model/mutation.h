@@ -343,6 +343,19 @@ inline bool operator!=(const Mutation& lhs, const Mutation& rhs) {
   return !(lhs == rhs);
 }
 
+/**
+ * Returns a single mutation that has the same effect as applying `earlier` and
+ * then `later` to the same document, or `nullopt` if the two can't be merged.
+ *
+ * Only sets and patches without transforms are merged. The merged mutation
+ * keeps the precondition of `earlier`, so they are only merged if the merged
+ * mutation fails exactly when one of the two would: a write without a
+ * precondition may be followed by any set or patch, and an update that
+ * requires the document to exist may only be followed by another such update.
+ */
+absl::optional<Mutation> CoalesceMutations(const Mutation& earlier,
+                                           const Mutation& later);
+
 }  // namespace model
 }  // namespace firestore
 }  // namespace firebase
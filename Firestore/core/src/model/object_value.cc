@@ -16,9 +16,11 @@
 
 #include "Firestore/core/src/model/object_value.h"
 
+#include <cstdlib>
 #include <algorithm>
 #include <map>
 #include <set>
+#include <vector>
 
 #include "Firestore/Protos/nanopb/google/firestore/v1/document.nanopb.h"
 #include "Firestore/core/src/nanopb/fields_array.h"
@@ -34,8 +36,8 @@ namespace model {
 namespace {
 
 using nanopb::CheckedSize;
+using nanopb::CopyBytesArray;
 using nanopb::FreeFieldsArray;
-using nanopb::FreeNanopbMessage;
 using nanopb::MakeArray;
 using nanopb::MakeBytesArray;
 using nanopb::MakeString;
@@ -44,13 +46,21 @@ using nanopb::Message;
 using nanopb::ReleaseFieldOwnership;
 using nanopb::SetRepeatedField;
 
+using MapEntry = google_firestore_v1_MapValue_FieldsEntry;
+
+/**
+ * The number of entry storages a map may reference before its entries are
+ * copied into a single storage. Storages keep the entries that a map no longer
+ * uses alive, so this bounds the memory retained by a map that is modified
+ * repeatedly.
+ */
+const size_t kMaxEntryStorages = 8;
+
 struct MapEntryKeyCompare {
-  bool operator()(const google_firestore_v1_MapValue_FieldsEntry& entry,
-                  absl::string_view segment) const {
+  bool operator()(const MapEntry& entry, absl::string_view segment) const {
     return nanopb::MakeStringView(entry.key) < segment;
   }
-  bool operator()(absl::string_view segment,
-                  const google_firestore_v1_MapValue_FieldsEntry& entry) const {
+  bool operator()(absl::string_view segment, const MapEntry& entry) const {
     return segment < nanopb::MakeStringView(entry.key);
   }
 };
@@ -59,13 +69,8 @@ struct MapEntryKeyCompare {
  * Finds an entry by key in the provided map value. Returns `nullptr` if the
  * entry does not exist.
  */
-google_firestore_v1_MapValue_FieldsEntry* FindEntry(
-    const google_firestore_v1_Value& value, absl::string_view segment) {
-  if (!IsMap(value)) {
-    return nullptr;
-  }
-  const google_firestore_v1_MapValue& map_value = value.map_value;
-
+const MapEntry* FindEntry(const google_firestore_v1_MapValue& map_value,
+                          absl::string_view segment) {
   // MapValues in iOS are always stored in sorted order.
   auto found = std::equal_range(map_value.fields,
                                 map_value.fields + map_value.fields_count,
@@ -78,123 +83,280 @@ google_firestore_v1_MapValue_FieldsEntry* FindEntry(
   return found.first;
 }
 
-size_t CalculateSizeOfUnion(
-    const google_firestore_v1_MapValue& map_value,
-    const std::map<std::string, Message<google_firestore_v1_Value>>& upserts,
-    const std::set<std::string>& deletes) {
-  // Compute the size of the map after applying all mutations. The final size is
-  // the number of existing entries, plus the number of new entries
-  // minus the number of deleted entries.
-  return upserts.size() +
-         std::count_if(
-             map_value.fields, map_value.fields + map_value.fields_count,
-             [&](const google_firestore_v1_MapValue_FieldsEntry& entry) {
-               std::string field = MakeString(entry.key);
-               // Don't count if entry is deleted or if it is a replacement
-               // rather than an insert.
-               return deletes.find(field) == deletes.end() &&
-                      upserts.find(field) == upserts.end();
-             });
+google_firestore_v1_Value MakeMapValue(
+    const google_firestore_v1_MapValue& map_value) {
+  google_firestore_v1_Value result{};
+  result.which_value_type = google_firestore_v1_Value_map_value_tag;
+  result.map_value = map_value;
+  return result;
 }
 
 /**
- * Modifies `parent_map` by adding, replacing or deleting the specified
- * entries.
+ * Owns the keys and values of an array of map entries, except for values that
+ * are maps. Those are owned by the `MapNode` of the nested map.
  */
-void ApplyChanges(
-    google_firestore_v1_MapValue* parent,
-    std::map<std::string, Message<google_firestore_v1_Value>> upserts,
-    std::set<std::string> deletes) {
-  // TODO(mrschmidt): Consider using `absl::btree_map` and `absl::btree_set` for
-  // potentially better performance.
-  auto source_count = parent->fields_count;
-  auto* source_fields = parent->fields;
-
-  size_t target_count = CalculateSizeOfUnion(*parent, upserts, deletes);
-  auto* target_fields = MakeArray<google_firestore_v1_MapValue_FieldsEntry>(
-      CheckedSize(target_count));
-
-  auto delete_it = deletes.begin();
-  auto upsert_it = upserts.begin();
-
-  // Merge the existing data with the deletes and updates
-  pb_size_t source_index = 0, target_index = 0;
-  while (target_index < target_count) {
-    auto& target_entry = target_fields[target_index];
-
-    if (source_index < source_count) {
-      auto& source_entry = source_fields[source_index];
-      std::string source_key = MakeString(source_entry.key);
-
-      // Check if the source key is deleted
-      if (delete_it != deletes.end() && *delete_it == source_key) {
-        FreeFieldsArray(&source_entry);
-
-        ++delete_it;
-        ++source_index;
-        continue;
-      }
+class EntryStorage {
+ public:
+  explicit EntryStorage(pb_size_t count)
+      : entries_(MakeArray<MapEntry>(count)), count_(count) {
+  }
 
-      // Check if the source key is updated by the next upsert
-      if (upsert_it != upserts.end() && upsert_it->first == source_key) {
-        FreeFieldsArray(&source_entry.value);
+  /** Takes ownership of `entries`. */
+  EntryStorage(MapEntry* entries, pb_size_t count)
+      : entries_(entries), count_(count) {
+  }
 
-        target_entry.key = source_entry.key;
-        target_entry.value = *(upsert_it->second.release());
-        SortFields(target_entry.value);
+  EntryStorage(const EntryStorage&) = delete;
+  EntryStorage& operator=(const EntryStorage&) = delete;
 
-        ++upsert_it;
-        ++source_index;
-        ++target_index;
-        continue;
+  ~EntryStorage() {
+    for (pb_size_t i = 0; i < count_; ++i) {
+      if (IsMap(entries_[i].value)) {
+        entries_[i].value = {};
       }
+      FreeFieldsArray(&entries_[i]);
+    }
+    free(entries_);
+  }
+
+  MapEntry* entries() const {
+    return entries_;
+  }
 
-      // Check if the source key comes before the next upsert
-      if (upsert_it == upserts.end() || upsert_it->first > source_key) {
-        target_entry = source_entry;
+ private:
+  MapEntry* entries_;
+  pb_size_t count_;
+};
 
-        ++source_index;
-        ++target_index;
-        continue;
+/** The changes to apply to a single map, by key. */
+struct MapChanges {
+  /** New values, which may be nested maps. */
+  std::map<std::string, Message<google_firestore_v1_Value>> upserts;
+  std::set<std::string> deletes;
+
+  bool empty() const {
+    return upserts.empty() && deletes.empty();
+  }
+};
+
+}  // namespace
+
+/**
+ * An immutable map in the tree of an ObjectValue, along with the nodes of its
+ * nested maps.
+ *
+ * The entries of the map are shallow copies whose keys and values are owned by
+ * one of the node's `EntryStorage`s, except that values that are maps point to
+ * the entries of the child node. Nodes that are derived from another node by
+ * applying changes share its storages and the children that didn't change.
+ */
+class ObjectValue::MapNode {
+ public:
+  /** Creates a node for an empty map. */
+  MapNode() = default;
+
+  MapNode(const MapNode&) = delete;
+  MapNode& operator=(const MapNode&) = delete;
+
+  ~MapNode() {
+    if (owns_fields_) {
+      free(map_value_.fields);
+    }
+  }
+
+  /** Returns a shared node for the empty map. */
+  static const std::shared_ptr<const MapNode>& Empty() {
+    static const auto* empty =
+        new std::shared_ptr<const MapNode>(std::make_shared<MapNode>());
+    return *empty;
+  }
+
+  /**
+   * Creates a node that takes ownership of `map_value` and all of its nested
+   * data. The map must be sorted, see `SortFields`.
+   */
+  static std::shared_ptr<const MapNode> Adopt(
+      const google_firestore_v1_MapValue& map_value) {
+    auto node = std::make_shared<MapNode>();
+    node->map_value_ = map_value;
+    node->storages_.push_back(std::make_shared<const EntryStorage>(
+        map_value.fields, map_value.fields_count));
+    node->children_.resize(map_value.fields_count);
+    for (pb_size_t i = 0; i < map_value.fields_count; ++i) {
+      if (IsMap(map_value.fields[i].value)) {
+        node->children_[i] = Adopt(map_value.fields[i].value.map_value);
       }
     }
+    return node;
+  }
+
+  const google_firestore_v1_MapValue& map_value() const {
+    return map_value_;
+  }
+
+  /**
+   * Returns a node with `changes` applied to the map at `path` (given as the
+   * range of segments from `begin` to `end`), creating maps along the path
+   * that don't exist or aren't maps.
+   */
+  std::shared_ptr<const MapNode> Apply(FieldPath::const_iterator begin,
+                                       FieldPath::const_iterator end,
+                                       MapChanges changes) const {
+    if (begin == end) {
+      return WithChanges(std::move(changes), {});
+    }
+
+    const std::shared_ptr<const MapNode>& child = FindChild(*begin);
+    std::shared_ptr<const MapNode> new_child =
+        (child ? *child : *Empty()).Apply(begin + 1, end, std::move(changes));
+
+    std::map<std::string, std::shared_ptr<const MapNode>> new_children;
+    new_children[*begin] = std::move(new_child);
+    return WithChanges({}, std::move(new_children));
+  }
+
+ private:
+  /**
+   * Returns the node of the nested map at `segment`, or null if there is no
+   * entry or it isn't a map.
+   */
+  const std::shared_ptr<const MapNode>& FindChild(
+      absl::string_view segment) const {
+    static const auto* none = new std::shared_ptr<const MapNode>();
+    const MapEntry* entry = FindEntry(map_value_, segment);
+    return entry ? children_[entry - map_value_.fields] : *none;
+  }
 
-    // Otherwise, insert the next upsert.
-    target_entry.key = MakeBytesArray(upsert_it->first);
-    target_entry.value = *(upsert_it->second.release());
-    SortFields(target_entry.value);
+  /**
+   * Returns a node for this map with `changes` applied and the nested maps in
+   * `new_children` replaced.
+   */
+  std::shared_ptr<const MapNode> WithChanges(
+      MapChanges changes,
+      std::map<std::string, std::shared_ptr<const MapNode>> new_children)
+      const;
 
-    ++upsert_it;
-    ++target_index;
+  /**
+   * Copies the keys and values of the map into a single storage if the node
+   * references too many, see `kMaxEntryStorages`.
+   */
+  void CompactIfNeeded();
+
+  google_firestore_v1_MapValue map_value_{};
+
+  /** Whether the node allocated `map_value_.fields` itself. */
+  bool owns_fields_ = false;
+
+  /** The nodes of nested maps, by entry index. Null for other values. */
+  std::vector<std::shared_ptr<const MapNode>> children_;
+
+  std::vector<std::shared_ptr<const EntryStorage>> storages_;
+};
+
+std::shared_ptr<const ObjectValue::MapNode> ObjectValue::MapNode::WithChanges(
+    MapChanges changes,
+    std::map<std::string, std::shared_ptr<const MapNode>> new_children) const {
+  // Entries for new values and for replaced nested maps share a new storage.
+  // Upserts and new children never have the same keys.
+  size_t new_count = changes.upserts.size() + new_children.size();
+  std::map<absl::string_view, pb_size_t> new_entries;
+  auto storage = std::make_shared<EntryStorage>(CheckedSize(new_count));
+  std::vector<std::shared_ptr<const MapNode>> new_entry_children(new_count);
+
+  for (auto& upsert : changes.upserts) {
+    pb_size_t index = CheckedSize(new_entries.size());
+    MapEntry& entry = storage->entries()[index];
+    entry.key = MakeBytesArray(upsert.first);
+    entry.value = *upsert.second.release();
+    SortFields(entry.value);
+    if (IsMap(entry.value)) {
+      new_entry_children[index] = Adopt(entry.value.map_value);
+    }
+    new_entries[upsert.first] = index;
+  }
+  for (auto& child : new_children) {
+    pb_size_t index = CheckedSize(new_entries.size());
+    MapEntry& entry = storage->entries()[index];
+    entry.key = MakeBytesArray(child.first);
+    entry.value = MakeMapValue(child.second->map_value());
+    new_entry_children[index] = std::move(child.second);
+    new_entries[child.first] = index;
   }
 
-  // Delete any remaining fields in the original map. This only includes fields
-  // that were deleted.
-  for (; source_index < source_count; ++source_index) {
-    FreeFieldsArray(&source_fields[source_index]);
+  // Merge the existing entries with the deletes and new entries, which are
+  // both sorted by key.
+  auto result = std::make_shared<MapNode>();
+  std::vector<MapEntry> fields;
+  fields.reserve(map_value_.fields_count + new_count);
+
+  auto new_it = new_entries.begin();
+  auto new_end = new_entries.end();
+  for (pb_size_t i = 0; i < map_value_.fields_count; ++i) {
+    absl::string_view key = MakeStringView(map_value_.fields[i].key);
+    for (; new_it != new_end && new_it->first < key; ++new_it) {
+      fields.push_back(storage->entries()[new_it->second]);
+      result->children_.push_back(new_entry_children[new_it->second]);
+    }
+
+    if (new_it != new_end && new_it->first == key) {
+      // Replaced by a new entry.
+      fields.push_back(storage->entries()[new_it->second]);
+      result->children_.push_back(new_entry_children[new_it->second]);
+      ++new_it;
+    } else if (changes.deletes.find(std::string(key)) ==
+               changes.deletes.end()) {
+      fields.push_back(map_value_.fields[i]);
+      result->children_.push_back(children_[i]);
+    }
   }
+  for (; new_it != new_end; ++new_it) {
+    fields.push_back(storage->entries()[new_it->second]);
+    result->children_.push_back(new_entry_children[new_it->second]);
+  }
+
+  result->map_value_.fields_count = CheckedSize(fields.size());
+  result->map_value_.fields =
+      MakeArray<MapEntry>(result->map_value_.fields_count);
+  std::copy(fields.begin(), fields.end(), result->map_value_.fields);
+  result->owns_fields_ = true;
 
-  free(parent->fields);
-  parent->fields = target_fields;
-  parent->fields_count = CheckedSize(target_count);
+  result->storages_ = storages_;
+  if (new_count > 0) {
+    result->storages_.push_back(std::move(storage));
+  }
+  result->CompactIfNeeded();
+  return result;
 }
 
-}  // namespace
+void ObjectValue::MapNode::CompactIfNeeded() {
+  if (storages_.size() <= kMaxEntryStorages) return;
+
+  pb_size_t count = map_value_.fields_count;
+  auto storage = std::make_shared<EntryStorage>(count);
+  for (pb_size_t i = 0; i < count; ++i) {
+    const MapEntry& entry = map_value_.fields[i];
+    MapEntry& copy = storage->entries()[i];
+    copy.key = CopyBytesArray(entry.key);
+    copy.value =
+        children_[i] ? entry.value : *DeepClone(entry.value).release();
+  }
 
-ObjectValue::ObjectValue() {
-  value_->which_value_type = google_firestore_v1_Value_map_value_tag;
-  value_->map_value = {};
+  if (owns_fields_) {
+    free(map_value_.fields);
+  }
+  map_value_.fields = storage->entries();
+  owns_fields_ = false;
+  storages_ = {std::move(storage)};
 }
 
-ObjectValue::ObjectValue(Message<google_firestore_v1_Value> value)
-    : value_(std::move(value)) {
-  HARD_ASSERT(value_ && IsMap(*value_),
-              "ObjectValues should be backed by a MapValue");
-  SortFields(*value_);
+ObjectValue::ObjectValue() : root_(MapNode::Empty()) {
 }
 
-ObjectValue::ObjectValue(const ObjectValue& other)
-    : value_(DeepClone(*other.value_)) {
+ObjectValue::ObjectValue(Message<google_firestore_v1_Value> value) {
+  HARD_ASSERT(value && IsMap(*value),
+              "ObjectValues should be backed by a MapValue");
+  SortFields(*value);
+  root_ = MapNode::Adopt(value.release()->map_value);
 }
 
 ObjectValue ObjectValue::FromMapValue(
@@ -222,7 +384,7 @@ ObjectValue ObjectValue::FromFieldsEntry(
 }
 
 FieldMask ObjectValue::ToFieldMask() const {
-  return ExtractFieldMask(value_->map_value);
+  return ExtractFieldMask(root_->map_value());
 }
 
 FieldMask ObjectValue::ExtractFieldMask(
@@ -255,14 +417,10 @@ FieldMask ObjectValue::ExtractFieldMask(
 
 absl::optional<google_firestore_v1_Value> ObjectValue::Get(
     const FieldPath& path) const {
-  if (path.empty()) {
-    return *value_;
-  }
-
-  google_firestore_v1_Value nested_value = *value_;
+  google_firestore_v1_Value nested_value = Get();
   for (const std::string& segment : path) {
-    google_firestore_v1_MapValue_FieldsEntry* entry =
-        FindEntry(nested_value, segment);
+    if (!IsMap(nested_value)) return absl::nullopt;
+    const MapEntry* entry = FindEntry(nested_value.map_value, segment);
     if (!entry) return absl::nullopt;
     nested_value = entry->value;
   }
@@ -270,26 +428,21 @@ absl::optional<google_firestore_v1_Value> ObjectValue::Get(
 }
 
 google_firestore_v1_Value ObjectValue::Get() const {
-  return *value_;
+  return MakeMapValue(root_->map_value());
 }
 
 void ObjectValue::Set(const FieldPath& path,
                       Message<google_firestore_v1_Value> value) {
   HARD_ASSERT(!path.empty(), "Cannot set field for empty path on ObjectValue");
 
-  google_firestore_v1_MapValue* parent_map = ParentMap(path.PopLast());
-
-  std::map<std::string, Message<google_firestore_v1_Value>> upserts;
-  upserts[path.last_segment()] = std::move(value);
-
-  ApplyChanges(parent_map, std::move(upserts), /*deletes=*/{});
+  MapChanges changes;
+  changes.upserts[path.last_segment()] = std::move(value);
+  root_ = root_->Apply(path.begin(), path.end() - 1, std::move(changes));
 }
 
 void ObjectValue::SetAll(TransformMap data) {
   FieldPath parent;
-
-  std::map<std::string, Message<google_firestore_v1_Value>> upserts;
-  std::set<std::string> deletes;
+  MapChanges changes;
 
   for (auto& it : data) {
     const FieldPath& path = it.first;
@@ -298,84 +451,42 @@ void ObjectValue::SetAll(TransformMap data) {
 
     if (!parent.IsImmediateParentOf(path)) {
       // Insert the accumulated changes at this parent location
-      google_firestore_v1_MapValue* parent_map = ParentMap(parent);
-      ApplyChanges(parent_map, std::move(upserts), std::move(deletes));
-      upserts.clear();
-      deletes.clear();
+      if (!changes.empty()) {
+        root_ = root_->Apply(parent.begin(), parent.end(), std::move(changes));
+        changes = {};
+      }
       parent = path.PopLast();
     }
 
     if (value) {
-      upserts[path.last_segment()] = std::move(*value);
+      changes.upserts[path.last_segment()] = std::move(*value);
     } else {
-      deletes.insert(path.last_segment());
+      changes.deletes.insert(path.last_segment());
     }
   }
 
-  google_firestore_v1_MapValue* parent_map = ParentMap(parent);
-  ApplyChanges(parent_map, std::move(upserts), std::move(deletes));
+  if (!changes.empty()) {
+    root_ = root_->Apply(parent.begin(), parent.end(), std::move(changes));
+  }
 }
 
 void ObjectValue::Delete(const FieldPath& path) {
   HARD_ASSERT(!path.empty(), "Cannot delete field with empty path");
 
-  google_firestore_v1_Value* nested_value = value_.get();
-  for (const std::string& segment : path.PopLast()) {
-    auto* entry = FindEntry(*nested_value, segment);
-    // If the entry is not found, exit early. There is nothing to delete.
-    if (!entry) return;
-    nested_value = &entry->value;
-  }
+  // There is nothing to delete unless the parent is a map with the entry.
+  if (!Get(path)) return;
 
-  // We can only delete a leaf entry if its parent is a map.
-  if (IsMap(*nested_value)) {
-    std::set<std::string> deletes{path.last_segment()};
-    ApplyChanges(&nested_value->map_value, /*upserts=*/{}, deletes);
-  }
+  MapChanges changes;
+  changes.deletes.insert(path.last_segment());
+  root_ = root_->Apply(path.begin(), path.end() - 1, std::move(changes));
 }
 
 std::string ObjectValue::ToString() const {
-  return CanonicalId(*value_);
+  return CanonicalId(Get());
 }
 
 size_t ObjectValue::Hash() const {
-  return util::Hash(CanonicalId(*value_));
-}
-
-google_firestore_v1_MapValue* ObjectValue::ParentMap(const FieldPath& path) {
-  google_firestore_v1_Value* parent = value_.get();
-
-  // Find a or create a parent map entry for `path`.
-  for (const std::string& segment : path) {
-    google_firestore_v1_MapValue_FieldsEntry* entry =
-        FindEntry(*parent, segment);
-
-    if (entry) {
-      if (entry->value.which_value_type !=
-          google_firestore_v1_Value_map_value_tag) {
-        // Since the element is not a map value, free all existing data and
-        // change it to a map type.
-        FreeFieldsArray(&entry->value);
-        entry->value.which_value_type = google_firestore_v1_Value_map_value_tag;
-        entry->value.map_value = {};
-      }
-
-      parent = &entry->value;
-    } else {
-      // Create a new map value for the current segment.
-      Message<google_firestore_v1_Value> new_entry;
-      new_entry->which_value_type = google_firestore_v1_Value_map_value_tag;
-      new_entry->map_value = {};
-
-      std::map<std::string, Message<google_firestore_v1_Value>> upserts;
-      upserts[segment] = std::move(new_entry);
-      ApplyChanges(&parent->map_value, std::move(upserts), /*deletes=*/{});
-
-      parent = &(FindEntry(*parent, segment)->value);
-    }
-  }
-
-  return &parent->map_value;
+  return util::Hash(CanonicalId(Get()));
 }
 
 }  // namespace model
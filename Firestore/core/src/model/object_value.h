@@ -18,6 +18,7 @@
 #define FIRESTORE_CORE_SRC_MODEL_OBJECT_VALUE_H_
 
 #include <map>
+#include <memory>
 #include <ostream>
 #include <set>
 #include <string>
@@ -37,7 +38,13 @@ namespace firestore {
 
 namespace model {
 
-/** A structured object value stored in Firestore. */
+/**
+ * A structured object value stored in Firestore.
+ *
+ * The maps of an ObjectValue are immutable and shared between copies, so that
+ * copying an ObjectValue is constant time. Modifications copy the maps along
+ * the modified path and share all other maps with the original.
+ */
 class ObjectValue {
  public:
   ObjectValue();
@@ -47,7 +54,7 @@ class ObjectValue {
 
   ObjectValue(ObjectValue&& other) noexcept = default;
   ObjectValue& operator=(ObjectValue&& other) noexcept = default;
-  ObjectValue(const ObjectValue& other);
+  ObjectValue(const ObjectValue& other) = default;
 
   ObjectValue& operator=(const ObjectValue&) = delete;
 
@@ -122,17 +129,13 @@ class ObjectValue {
   /** Returns the field mask for the provided map value. */
   FieldMask ExtractFieldMask(const google_firestore_v1_MapValue& value) const;
 
-  /**
-   * Returns the map that contains the leaf element of `path`. If the parent
-   * entry does not yet exist, or if it is not a map, a new map will be created.
-   */
-  google_firestore_v1_MapValue* ParentMap(const FieldPath& path);
+  class MapNode;
 
-  nanopb::Message<google_firestore_v1_Value> value_;
+  std::shared_ptr<const MapNode> root_;
 };
 
 inline bool operator==(const ObjectValue& lhs, const ObjectValue& rhs) {
-  return *lhs.value_ == *rhs.value_;
+  return lhs.Get() == rhs.Get();
 }
 
 inline bool operator!=(const ObjectValue& lhs, const ObjectValue& rhs) {
@@ -141,7 +144,7 @@ inline bool operator!=(const ObjectValue& lhs, const ObjectValue& rhs) {
 
 inline std::ostream& operator<<(std::ostream& out,
                                 const ObjectValue& object_value) {
-  return out << "ObjectValue(" << *object_value.value_ << ")";
+  return out << "ObjectValue(" << object_value.Get() << ")";
 }
 
 }  // namespace model
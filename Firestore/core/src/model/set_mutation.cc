@@ -20,7 +20,6 @@
 #include <utility>
 
 #include "Firestore/core/src/model/mutable_document.h"
-#include "Firestore/core/src/model/value_util.h"
 #include "Firestore/core/src/util/hard_assert.h"
 #include "Firestore/core/src/util/hashing.h"
 #include "Firestore/core/src/util/to_string.h"
@@ -74,7 +73,7 @@ void SetMutation::Rep::ApplyToRemoteDocument(
   // the server has accepted the mutation so the precondition must have held.
   auto transform_results = ServerTransformResults(
       document.data(), mutation_result.transform_results());
-  ObjectValue new_data{DeepClone(value_.Get())};
+  ObjectValue new_data = value_;
   new_data.SetAll(std::move(transform_results));
   document
       .ConvertToFoundDocument(mutation_result.version(), std::move(new_data))
@@ -91,7 +90,7 @@ void SetMutation::Rep::ApplyToLocalView(
 
   auto transform_results =
       LocalTransformResults(document.data(), local_write_time);
-  ObjectValue new_data{DeepClone(value_.Get())};
+  ObjectValue new_data = value_;
   new_data.SetAll(std::move(transform_results));
   document
       .ConvertToFoundDocument(GetPostMutationVersion(document),
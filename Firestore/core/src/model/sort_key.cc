@@ -0,0 +1,243 @@
+/*
+ * Copyright 2021 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Firestore/core/src/model/sort_key.h"
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+#include "Firestore/core/src/model/document_key.h"
+#include "Firestore/core/src/model/resource_path.h"
+#include "Firestore/core/src/model/server_timestamp_util.h"
+#include "Firestore/core/src/model/value_util.h"
+#include "Firestore/core/src/nanopb/nanopb_util.h"
+#include "Firestore/core/src/util/hard_assert.h"
+#include "Firestore/core/src/util/ordered_code.h"
+#include "absl/base/casts.h"
+#include "absl/strings/str_split.h"
+#include "absl/strings/string_view.h"
+
+namespace firebase {
+namespace firestore {
+namespace model {
+
+namespace {
+
+using util::OrderedCode;
+
+// Markers for the elements of arrays, maps and paths. An element sorts after
+// the end of a sequence, so that a prefix sorts first.
+const uint64_t kEndOfSequence = 0;
+const uint64_t kSequenceElement = 1;
+
+// The ranges that numbers fall into, in order. Numbers inside the range of
+// int64_t are encoded as their integral and fractional part, so that integers
+// and doubles with the same value encode the same.
+enum class NumberRange : uint64_t {
+  kNaN = 0,
+  kBelowInt64 = 1,
+  kInt64 = 2,
+  kAboveInt64 = 3,
+};
+
+// -2^63 can be represented exactly, 2^63 is the first double past INT64_MAX.
+constexpr double kInt64MinAsDouble =
+    static_cast<double>(std::numeric_limits<int64_t>::min());
+constexpr double kInt64MaxAsDouble =
+    static_cast<double>(std::numeric_limits<int64_t>::max());
+
+void WriteNumberRange(std::string* dest, NumberRange range) {
+  OrderedCode::WriteNumIncreasing(dest, static_cast<uint64_t>(range));
+}
+
+/**
+ * Writes the bits of a double that is not NaN such that they sort in numeric
+ * order. Both zeros encode the same.
+ */
+void WriteOrderedDouble(std::string* dest, double value) {
+  if (value == 0) value = 0;  // Normalizes -0.0.
+  auto bits = absl::bit_cast<uint64_t>(value);
+  const uint64_t sign_bit = uint64_t{1} << 63;
+  bits = (bits & sign_bit) ? ~bits : bits | sign_bit;
+  OrderedCode::WriteNumIncreasing(dest, bits);
+}
+
+/** Writes a double in the order of `util::Compare`, with NaN first. */
+void WriteDouble(std::string* dest, double value) {
+  if (std::isnan(value)) {
+    OrderedCode::WriteNumIncreasing(dest, 0);
+  } else {
+    OrderedCode::WriteNumIncreasing(dest, 1);
+    WriteOrderedDouble(dest, value);
+  }
+}
+
+void WriteNumber(std::string* dest, const google_firestore_v1_Value& value) {
+  if (value.which_value_type == google_firestore_v1_Value_integer_value_tag) {
+    WriteNumberRange(dest, NumberRange::kInt64);
+    OrderedCode::WriteSignedNumIncreasing(dest, value.integer_value);
+    OrderedCode::WriteNumIncreasing(dest, 0);
+    return;
+  }
+
+  double number = value.double_value;
+  if (std::isnan(number)) {
+    WriteNumberRange(dest, NumberRange::kNaN);
+  } else if (number < kInt64MinAsDouble) {
+    WriteNumberRange(dest, NumberRange::kBelowInt64);
+    WriteOrderedDouble(dest, number);
+  } else if (number >= kInt64MaxAsDouble) {
+    WriteNumberRange(dest, NumberRange::kAboveInt64);
+    WriteOrderedDouble(dest, number);
+  } else {
+    // The fractional part is exact and in [0, 1), where the bits of a positive
+    // double sort in numeric order.
+    double integral = std::floor(number);
+    double fraction = number - integral;
+    WriteNumberRange(dest, NumberRange::kInt64);
+    OrderedCode::WriteSignedNumIncreasing(dest, static_cast<int64_t>(integral));
+    OrderedCode::WriteNumIncreasing(
+        dest, fraction == 0 ? 0 : absl::bit_cast<uint64_t>(fraction));
+  }
+}
+
+void WriteTimestamp(std::string* dest,
+                    const google_protobuf_Timestamp& timestamp) {
+  OrderedCode::WriteSignedNumIncreasing(dest, timestamp.seconds);
+  OrderedCode::WriteSignedNumIncreasing(dest, timestamp.nanos);
+}
+
+void WriteBlob(std::string* dest, const google_firestore_v1_Value& value) {
+  // An empty blob is represented by a nullptr (or an empty byte array).
+  absl::string_view bytes;
+  if (value.bytes_value) {
+    bytes = absl::string_view(
+        reinterpret_cast<const char*>(value.bytes_value->bytes),
+        value.bytes_value->size);
+  }
+  OrderedCode::WriteString(dest, bytes);
+}
+
+void WriteReference(std::string* dest, const google_firestore_v1_Value& value) {
+  // Matches `CompareReferences`, which compares the segments of the resource
+  // names.
+  for (absl::string_view segment :
+       absl::StrSplit(nanopb::MakeStringView(value.reference_value), '/',
+                      absl::SkipEmpty())) {
+    OrderedCode::WriteNumIncreasing(dest, kSequenceElement);
+    OrderedCode::WriteString(dest, segment);
+  }
+  OrderedCode::WriteNumIncreasing(dest, kEndOfSequence);
+}
+
+void WriteArray(std::string* dest, const google_firestore_v1_Value& value) {
+  const google_firestore_v1_ArrayValue& array = value.array_value;
+  for (pb_size_t i = 0; i < array.values_count; ++i) {
+    OrderedCode::WriteNumIncreasing(dest, kSequenceElement);
+    WriteSortKey(dest, array.values[i]);
+  }
+  OrderedCode::WriteNumIncreasing(dest, kEndOfSequence);
+}
+
+void WriteMap(std::string* dest, const google_firestore_v1_Value& value) {
+  // Like `CompareObjects`, this relies on the fields being sorted by key.
+  const google_firestore_v1_MapValue& map = value.map_value;
+  for (pb_size_t i = 0; i < map.fields_count; ++i) {
+    OrderedCode::WriteNumIncreasing(dest, kSequenceElement);
+    OrderedCode::WriteString(dest, nanopb::MakeStringView(map.fields[i].key));
+    WriteSortKey(dest, map.fields[i].value);
+  }
+  OrderedCode::WriteNumIncreasing(dest, kEndOfSequence);
+}
+
+}  // namespace
+
+void WriteSortKey(std::string* dest, const google_firestore_v1_Value& value) {
+  TypeOrder type = GetTypeOrder(value);
+  OrderedCode::WriteNumIncreasing(dest, static_cast<uint64_t>(type));
+
+  switch (type) {
+    case TypeOrder::kNull:
+      return;
+
+    case TypeOrder::kBoolean:
+      OrderedCode::WriteNumIncreasing(dest, value.boolean_value ? 1 : 0);
+      return;
+
+    case TypeOrder::kNumber:
+      WriteNumber(dest, value);
+      return;
+
+    case TypeOrder::kTimestamp:
+      WriteTimestamp(dest, value.timestamp_value);
+      return;
+
+    case TypeOrder::kServerTimestamp:
+      WriteTimestamp(dest, GetLocalWriteTime(value));
+      return;
+
+    case TypeOrder::kString:
+      OrderedCode::WriteString(dest,
+                               nanopb::MakeStringView(value.string_value));
+      return;
+
+    case TypeOrder::kBlob:
+      WriteBlob(dest, value);
+      return;
+
+    case TypeOrder::kReference:
+      WriteReference(dest, value);
+      return;
+
+    case TypeOrder::kGeoPoint:
+      WriteDouble(dest, value.geo_point_value.latitude);
+      WriteDouble(dest, value.geo_point_value.longitude);
+      return;
+
+    case TypeOrder::kArray:
+      WriteArray(dest, value);
+      return;
+
+    case TypeOrder::kMap:
+      WriteMap(dest, value);
+      return;
+  }
+
+  UNREACHABLE();
+}
+
+void WriteSortKey(std::string* dest, const DocumentKey& key) {
+  for (const std::string& segment : key.collection_path()) {
+    OrderedCode::WriteNumIncreasing(dest, kSequenceElement);
+    OrderedCode::WriteString(dest, segment);
+  }
+  if (!key.collection_path().empty()) {
+    OrderedCode::WriteNumIncreasing(dest, kSequenceElement);
+    OrderedCode::WriteString(dest, key.document_id());
+  }
+  OrderedCode::WriteNumIncreasing(dest, kEndOfSequence);
+}
+
+void InvertSortKey(std::string* dest, size_t start) {
+  for (size_t i = start; i < dest->size(); ++i) {
+    (*dest)[i] = static_cast<char>(~(*dest)[i]);
+  }
+}
+
+}  // namespace model
+}  // namespace firestore
+}  // namespace firebase
@@ -0,0 +1,60 @@
+/*
+ * Copyright 2021 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FIRESTORE_CORE_SRC_MODEL_SORT_KEY_H_
+#define FIRESTORE_CORE_SRC_MODEL_SORT_KEY_H_
+
+#include <cstddef>
+#include <string>
+
+#include "Firestore/Protos/nanopb/google/firestore/v1/document.nanopb.h"
+
+namespace firebase {
+namespace firestore {
+namespace model {
+
+class DocumentKey;
+
+// Sort keys are binary encodings of values whose lexicographic (`memcmp`)
+// order matches the order defined by `model::Compare`, including the ordering
+// across types. Values that compare the same encode to the same bytes, e.g.
+// `1`, `1.0` and `-0.0` vs `0`.
+//
+// The encodings are built with `util::OrderedCode` and are prefix-free, so the
+// keys of several values can be concatenated to sort by a tuple of values,
+// and any one of them can be inverted with `InvertSortKey` to sort it in
+// descending order.
+
+/** Appends the sort key of `value` to `dest`. */
+void WriteSortKey(std::string* dest, const google_firestore_v1_Value& value);
+
+/**
+ * Appends the sort key of a document key to `dest`. Document keys sort in the
+ * order of `DocumentKey::CompareTo`.
+ */
+void WriteSortKey(std::string* dest, const DocumentKey& key);
+
+/**
+ * Complements the bytes of `dest` starting at `start`, which reverses the
+ * order of the sort key written there.
+ */
+void InvertSortKey(std::string* dest, size_t start);
+
+}  // namespace model
+}  // namespace firestore
+}  // namespace firebase
+
+#endif  // FIRESTORE_CORE_SRC_MODEL_SORT_KEY_H_
@@ -23,6 +23,7 @@
 
 #include "Firestore/core/include/firebase/firestore/timestamp.h"
 #include "Firestore/core/src/model/server_timestamp_util.h"
+#include "Firestore/core/src/model/value_set.h"
 #include "Firestore/core/src/model/value_util.h"
 #include "Firestore/core/src/nanopb/nanopb_util.h"
 #include "Firestore/core/src/util/comparison.h"
@@ -221,8 +222,7 @@ size_t ArrayTransform::Rep::Hash() const {
   size_t result = 37;
   result = 31 * result + (type() == Type::ArrayUnion ? 1231 : 1237);
   for (size_t i = 0; i < elements_->values_count; i++) {
-    result = 31 * result +
-             std::hash<std::string>()(CanonicalId(elements_->values[i]));
+    result = 31 * result + model::Hash(elements_->values[i]);
   }
   return result;
 }
@@ -248,15 +248,13 @@ Message<google_firestore_v1_Value> ArrayTransform::Rep::Apply(
   Message<google_firestore_v1_ArrayValue> array_value =
       CoercedFieldValueArray(previous_value);
   if (type_ == Type::ArrayUnion) {
-    // Gather the list of elements that have to be added.
+    // Gather the list of elements that have to be added. `present` holds
+    // the existing elements and the ones that are already being added.
+    ValueSet present(*array_value);
     std::vector<Message<google_firestore_v1_Value>> new_elements;
     for (pb_size_t i = 0; i < elements_->values_count; ++i) {
       const google_firestore_v1_Value& new_element = elements_->values[i];
-      if (!Contains(*array_value, new_element) &&
-          !std::any_of(new_elements.begin(), new_elements.end(),
-                       [&](const Message<google_firestore_v1_Value>& value) {
-                         return *value == new_element;
-                       })) {
+      if (present.Insert(new_element)) {
         new_elements.push_back(DeepClone(new_element));
       }
     }
@@ -271,10 +269,11 @@ Message<google_firestore_v1_Value> ArrayTransform::Rep::Apply(
     }
   } else {
     HARD_ASSERT(type_ == Type::ArrayRemove);
+    ValueSet removed(*elements_);
     pb_size_t new_index = 0;
     for (pb_size_t old_index = 0; old_index < array_value->values_count;
          ++old_index) {
-      if (Contains(*elements_, array_value->values[old_index])) {
+      if (removed.Contains(array_value->values[old_index])) {
         nanopb::FreeFieldsArray(&array_value->values[old_index]);
       } else {
         array_value->values[new_index] = array_value->values[old_index];
@@ -0,0 +1,53 @@
+/*
+ * Copyright 2021 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Firestore/core/src/model/value_set.h"
+
+#include "Firestore/core/src/model/value_util.h"
+
+namespace firebase {
+namespace firestore {
+namespace model {
+
+ValueSet::ValueSet(const google_firestore_v1_ArrayValue& array) {
+  values_.reserve(array.values_count);
+  for (pb_size_t i = 0; i < array.values_count; ++i) {
+    values_.insert(&array.values[i]);
+  }
+}
+
+bool ValueSet::Insert(const google_firestore_v1_Value& value) {
+  return values_.insert(&value).second;
+}
+
+bool ValueSet::Contains(const google_firestore_v1_Value& value) const {
+  return values_.find(&value) != values_.end();
+}
+
+size_t ValueSet::ValueHash::operator()(
+    const google_firestore_v1_Value* value) const {
+  return Hash(*value);
+}
+
+bool ValueSet::ValueEquals::operator()(
+    const google_firestore_v1_Value* lhs,
+    const google_firestore_v1_Value* rhs) const {
+  return Equals(*lhs, *rhs);
+}
+
+}  // namespace model
+}  // namespace firestore
+}  // namespace firebase
@@ -0,0 +1,79 @@
+/*
+ * Copyright 2021 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FIRESTORE_CORE_SRC_MODEL_VALUE_SET_H_
+#define FIRESTORE_CORE_SRC_MODEL_VALUE_SET_H_
+
+#include <cstddef>
+#include <unordered_set>
+
+#include "Firestore/Protos/nanopb/google/firestore/v1/document.nanopb.h"
+
+namespace firebase {
+namespace firestore {
+namespace model {
+
+/**
+ * A hashed set of values, for membership tests that take constant time
+ * instead of a scan with `Equals`. Values are considered the same if they are
+ * `Equals`.
+ *
+ * The set does not own its values: values that are added must outlive the
+ * set, and must not be modified while they're in it.
+ */
+class ValueSet {
+ public:
+  ValueSet() = default;
+
+  /** Creates a set of the elements of `array`. */
+  explicit ValueSet(const google_firestore_v1_ArrayValue& array);
+
+  /**
+   * Adds `value` to the set. Returns false if the set already contained an
+   * equal value, in which case the set is unchanged.
+   */
+  bool Insert(const google_firestore_v1_Value& value);
+
+  /** Returns true if the set contains a value equal to `value`. */
+  bool Contains(const google_firestore_v1_Value& value) const;
+
+  size_t size() const {
+    return values_.size();
+  }
+
+  bool empty() const {
+    return values_.empty();
+  }
+
+ private:
+  struct ValueHash {
+    size_t operator()(const google_firestore_v1_Value* value) const;
+  };
+
+  struct ValueEquals {
+    bool operator()(const google_firestore_v1_Value* lhs,
+                    const google_firestore_v1_Value* rhs) const;
+  };
+
+  std::unordered_set<const google_firestore_v1_Value*, ValueHash, ValueEquals>
+      values_;
+};
+
+}  // namespace model
+}  // namespace firestore
+}  // namespace firebase
+
+#endif  // FIRESTORE_CORE_SRC_MODEL_VALUE_SET_H_
@@ -28,6 +28,8 @@
 #include "Firestore/core/src/nanopb/nanopb_util.h"
 #include "Firestore/core/src/util/comparison.h"
 #include "Firestore/core/src/util/hard_assert.h"
+#include "Firestore/core/src/util/hashing.h"
+#include "absl/hash/hash.h"
 #include "absl/strings/escaping.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
@@ -388,6 +390,103 @@ bool Equals(const google_firestore_v1_ArrayValue& lhs,
   return ArrayEquals(lhs, rhs);
 }
 
+size_t HashBytes(absl::string_view bytes) {
+  return absl::Hash<absl::string_view>{}(bytes);
+}
+
+size_t HashTimestamp(const google_protobuf_Timestamp& timestamp) {
+  return util::Hash(timestamp.seconds, timestamp.nanos);
+}
+
+size_t HashNumber(const google_firestore_v1_Value& value) {
+  // Integers and doubles are never equal, see `NumberEquals`.
+  if (value.which_value_type == google_firestore_v1_Value_integer_value_tag) {
+    return util::Hash(value.integer_value);
+  }
+  return util::DoubleBitwiseHash(value.double_value);
+}
+
+size_t HashGeoPoint(const google_firestore_v1_Value& value) {
+  // Coordinates are compared with `==`, where both zeros are equal.
+  double latitude = value.geo_point_value.latitude;
+  double longitude = value.geo_point_value.longitude;
+  return util::Hash(latitude == 0 ? 0.0 : latitude,
+                    longitude == 0 ? 0.0 : longitude);
+}
+
+size_t HashArray(const google_firestore_v1_ArrayValue& value) {
+  size_t result = value.values_count;
+  for (pb_size_t i = 0; i < value.values_count; ++i) {
+    result = 31 * result + Hash(value.values[i]);
+  }
+  return result;
+}
+
+size_t HashMap(const google_firestore_v1_MapValue& value) {
+  size_t result = value.fields_count;
+  for (pb_size_t i = 0; i < value.fields_count; ++i) {
+    absl::string_view key = nanopb::MakeStringView(value.fields[i].key);
+    result = 31 * result + HashBytes(key);
+    result = 31 * result + Hash(value.fields[i].value);
+  }
+  return result;
+}
+
+size_t Hash(const google_firestore_v1_Value& value) {
+  TypeOrder type = GetTypeOrder(value);
+  size_t result;
+  switch (type) {
+    case TypeOrder::kNull:
+      result = 0;
+      break;
+
+    case TypeOrder::kBoolean:
+      result = value.boolean_value ? 1231 : 1237;
+      break;
+
+    case TypeOrder::kNumber:
+      result = HashNumber(value);
+      break;
+
+    case TypeOrder::kTimestamp:
+      result = HashTimestamp(value.timestamp_value);
+      break;
+
+    case TypeOrder::kServerTimestamp:
+      result = HashTimestamp(GetLocalWriteTime(value));
+      break;
+
+    case TypeOrder::kString:
+      result = HashBytes(nanopb::MakeStringView(value.string_value));
+      break;
+
+    case TypeOrder::kBlob:
+      // An empty blob is represented by a nullptr (or an empty byte array).
+      result = HashBytes(nanopb::MakeStringView(value.bytes_value));
+      break;
+
+    case TypeOrder::kReference:
+      result = HashBytes(nanopb::MakeStringView(value.reference_value));
+      break;
+
+    case TypeOrder::kGeoPoint:
+      result = HashGeoPoint(value);
+      break;
+
+    case TypeOrder::kArray:
+      result = HashArray(value.array_value);
+      break;
+
+    case TypeOrder::kMap:
+      result = HashMap(value.map_value);
+      break;
+
+    default:
+      HARD_FAIL("Invalid type value: %s", type);
+  }
+  return util::Hash(type, result);
+}
+
 std::string CanonifyTimestamp(const google_firestore_v1_Value& value) {
   return absl::StrFormat("time(%d,%d)", value.timestamp_value.seconds,
                          value.timestamp_value.nanos);
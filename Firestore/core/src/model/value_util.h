@@ -17,6 +17,7 @@
 #ifndef FIRESTORE_CORE_SRC_MODEL_VALUE_UTIL_H_
 #define FIRESTORE_CORE_SRC_MODEL_VALUE_UTIL_H_
 
+#include <cstddef>
 #include <ostream>
 #include <string>
 #include <vector>
@@ -67,12 +68,34 @@ void SortFields(google_firestore_v1_ArrayValue& value);
 util::ComparisonResult Compare(const google_firestore_v1_Value& left,
                                const google_firestore_v1_Value& right);
 
+// The following compare two values that are both known to have the given
+// `TypeOrder`, skipping the type dispatch in `Compare`.
+
+/** Compares two values of `TypeOrder::kNumber`. */
+util::ComparisonResult CompareNumbers(const google_firestore_v1_Value& left,
+                                      const google_firestore_v1_Value& right);
+
+/** Compares two values of `TypeOrder::kString`. */
+util::ComparisonResult CompareStrings(const google_firestore_v1_Value& left,
+                                      const google_firestore_v1_Value& right);
+
+/** Compares the timestamps of two values of `TypeOrder::kTimestamp`. */
+util::ComparisonResult CompareTimestamps(
+    const google_protobuf_Timestamp& left,
+    const google_protobuf_Timestamp& right);
+
 bool Equals(const google_firestore_v1_Value& left,
             const google_firestore_v1_Value& right);
 
 bool Equals(const google_firestore_v1_ArrayValue& left,
             const google_firestore_v1_ArrayValue& right);
 
+/**
+ * Returns a hash of the value that is consistent with `Equals`: values that
+ * are equal have the same hash.
+ */
+size_t Hash(const google_firestore_v1_Value& value);
+
 /**
  * Generates the canonical ID for the provided field value (as used in Target
  * serialization).
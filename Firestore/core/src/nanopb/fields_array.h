@@ -101,6 +101,18 @@ inline const pb_field_t* FieldsArray<google_firestore_v1_ListenResponse>() {
   return google_firestore_v1_ListenResponse_fields;
 }
 
+template <>
+inline const pb_field_t*
+FieldsArray<google_firestore_v1_PartitionQueryRequest>() {
+  return google_firestore_v1_PartitionQueryRequest_fields;
+}
+
+template <>
+inline const pb_field_t*
+FieldsArray<google_firestore_v1_PartitionQueryResponse>() {
+  return google_firestore_v1_PartitionQueryResponse_fields;
+}
+
 template <>
 inline const pb_field_t* FieldsArray<google_firestore_v1_RunQueryRequest>() {
   return google_firestore_v1_RunQueryRequest_fields;
@@ -169,6 +181,11 @@ inline const pb_field_t* FieldsArray<google_firestore_v1_WriteResult>() {
   return google_firestore_v1_WriteResult_fields;
 }
 
+template <>
+inline const pb_field_t* FieldsArray<firestore_BundleElement>() {
+  return firestore_BundleElement_fields;
+}
+
 template <>
 inline const pb_field_t* FieldsArray<firestore_BundleMetadata>() {
   return firestore_BundleMetadata_fields;
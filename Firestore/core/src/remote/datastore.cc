@@ -20,7 +20,9 @@
 #include <utility>
 
 #include "Firestore/core/include/firebase/firestore/firestore_errors.h"
+#include "Firestore/core/src/core/bound.h"
 #include "Firestore/core/src/core/database_info.h"
+#include "Firestore/core/src/core/target.h"
 #include "Firestore/core/src/credentials/auth_token.h"
 #include "Firestore/core/src/credentials/credentials_provider.h"
 #include "Firestore/core/src/model/database_id.h"
@@ -62,6 +64,8 @@ using util::StatusOr;
 
 const auto kRpcNameCommit = "/google.firestore.v1.Firestore/Commit";
 const auto kRpcNameLookup = "/google.firestore.v1.Firestore/BatchGetDocuments";
+const auto kRpcNamePartitionQuery =
+    "/google.firestore.v1.Firestore/PartitionQuery";
 
 std::unique_ptr<Executor> CreateExecutor() {
   return Executor::CreateSerial("com.google.firebase.firestore.rpc");
@@ -256,6 +260,78 @@ void Datastore::OnLookupDocumentsResponse(
   callback(datastore_serializer_.MergeLookupResponses(responses));
 }
 
+void Datastore::PartitionQuery(const core::Target& target,
+                               int64_t partition_count,
+                               PartitionQueryCallback&& callback) {
+  ResumeRpcWithCredentials(
+      // TODO(c++14): move into lambda.
+      [this, target, partition_count, callback](
+          const StatusOr<AuthToken>& auth_token,
+          const std::string& app_check_token) mutable {
+        if (!auth_token.ok()) {
+          callback(auth_token.status());
+          return;
+        }
+        PartitionQueryWithCredentials(auth_token.ValueOrDie(), app_check_token,
+                                      target, partition_count, "", {},
+                                      std::move(callback));
+      });
+}
+
+void Datastore::PartitionQueryWithCredentials(
+    const credentials::AuthToken& auth_token,
+    const std::string& app_check_token,
+    const core::Target& target,
+    int64_t partition_count,
+    const std::string& page_token,
+    std::vector<core::Bound> partitions,
+    PartitionQueryCallback&& callback) {
+  grpc::ByteBuffer message =
+      MakeByteBuffer(datastore_serializer_.EncodePartitionQueryRequest(
+          target, partition_count, page_token));
+
+  std::unique_ptr<GrpcUnaryCall> call_owning = grpc_connection_.CreateUnaryCall(
+      kRpcNamePartitionQuery, auth_token, app_check_token, std::move(message));
+  GrpcUnaryCall* call = call_owning.get();
+  active_calls_.push_back(std::move(call_owning));
+
+  call->Start(
+      // TODO(c++14): move into lambda.
+      [this, call, auth_token, app_check_token, target, partition_count,
+       partitions, callback](const StatusOr<grpc::ByteBuffer>& result) mutable {
+        LogGrpcCallFinished("PartitionQuery", call, result.status());
+        HandleCallStatus(result.status());
+        RemoveGrpcCall(call);
+
+        if (!result.ok()) {
+          callback(result.status());
+          return;
+        }
+
+        std::string next_page_token;
+        StatusOr<std::vector<core::Bound>> page =
+            datastore_serializer_.DecodePartitionQueryResponse(
+                result.ValueOrDie(), &next_page_token);
+        if (!page.ok()) {
+          callback(page.status());
+          return;
+        }
+
+        std::vector<core::Bound> page_partitions = page.ConsumeValueOrDie();
+        partitions.insert(partitions.end(), page_partitions.begin(),
+                          page_partitions.end());
+        if (next_page_token.empty()) {
+          callback(std::move(partitions));
+          return;
+        }
+
+        PartitionQueryWithCredentials(auth_token, app_check_token, target,
+                                      partition_count, next_page_token,
+                                      std::move(partitions),
+                                      std::move(callback));
+      });
+}
+
 void Datastore::ResumeRpcWithCredentials(const OnCredentials& on_credentials) {
   // Auth/AppCheck may outlive Firestore
   std::weak_ptr<Datastore> weak_this{shared_from_this()};
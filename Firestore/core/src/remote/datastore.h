@@ -17,6 +17,7 @@
 #ifndef FIRESTORE_CORE_SRC_REMOTE_DATASTORE_H_
 #define FIRESTORE_CORE_SRC_REMOTE_DATASTORE_H_
 
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <string>
@@ -71,6 +72,8 @@ class Datastore : public std::enable_shared_from_this<Datastore> {
   using LookupCallback =
       std::function<void(const util::StatusOr<std::vector<model::Document>>&)>;
   using CommitCallback = std::function<void(const util::Status&)>;
+  using PartitionQueryCallback =
+      std::function<void(const util::StatusOr<std::vector<core::Bound>>&)>;
 
   Datastore(
       const core::DatabaseInfo& database_info,
@@ -103,8 +106,18 @@ class Datastore : public std::enable_shared_from_this<Datastore> {
 
   void CommitMutations(const std::vector<model::Mutation>& mutations,
                        CommitCallback&& callback);
-  void LookupDocuments(const std::vector<model::DocumentKey>& keys,
-                       LookupCallback&& callback);
+  virtual /*virtual for tests only*/ void LookupDocuments(
+      const std::vector<model::DocumentKey>& keys, LookupCallback&& callback);
+
+  /**
+   * Asks the backend for up to `partition_count` points that split the results
+   * of `target` into partitions of roughly equal size. All pages of the
+   * response are read before `callback` is invoked. The points are in the
+   * order the backend returned them, which isn't necessarily query order.
+   */
+  void PartitionQuery(const core::Target& target,
+                      int64_t partition_count,
+                      PartitionQueryCallback&& callback);
 
   /** Returns true if the given error is a gRPC ABORTED error. */
   static bool IsAbortedError(const util::Status& error);
@@ -181,6 +194,19 @@ class Datastore : public std::enable_shared_from_this<Datastore> {
       const util::StatusOr<std::vector<grpc::ByteBuffer>>& result,
       const LookupCallback& callback);
 
+  /**
+   * Requests the page of partition points identified by `page_token`, and
+   * keeps requesting pages until the last one has been read. `partitions`
+   * holds the points of the pages read so far.
+   */
+  void PartitionQueryWithCredentials(const credentials::AuthToken& auth_token,
+                                     const std::string& app_check_token,
+                                     const core::Target& target,
+                                     int64_t partition_count,
+                                     const std::string& page_token,
+                                     std::vector<core::Bound> partitions,
+                                     PartitionQueryCallback&& callback);
+
   using OnCredentials = std::function<void(
       const util::StatusOr<credentials::AuthToken>&, const std::string&)>;
   void ResumeRpcWithCredentials(const OnCredentials& on_credentials);
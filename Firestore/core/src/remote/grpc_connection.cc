@@ -278,6 +278,15 @@ std::unique_ptr<grpc::ClientContext> GrpcConnection::CreateContext(
   return context;
 }
 
+void GrpcConnection::SetCompression(grpc::ClientContext* context) const {
+  GrpcOptions::Compression compression =
+      database_info_->grpc_options().compression();
+  // For `None`, leave the gRPC default in place.
+  if (compression != GrpcOptions::Compression::None) {
+    context->set_compression_algorithm(ToGrpcCompression(compression));
+  }
+}
+
 void GrpcConnection::EnsureActiveStub() {
   // TODO(varconst): find out in which cases a gRPC channel might shut down.
   // This might be overkill.
@@ -292,11 +301,21 @@ void GrpcConnection::EnsureActiveStub() {
 std::shared_ptr<grpc::Channel> GrpcConnection::CreateChannel() const {
   const std::string& host = database_info_->host();
 
+  const GrpcOptions& options = database_info_->grpc_options();
+
   grpc::ChannelArguments args;
   // Ensure gRPC recovers from a dead connection. (Not typically necessary, as
   // the OS will usually notify gRPC when a connection dies. But not always.
   // This acts as a failsafe.)
-  args.SetInt(GRPC_ARG_KEEPALIVE_TIME_MS, 30 * 1000);
+  args.SetInt(GRPC_ARG_KEEPALIVE_TIME_MS, options.keepalive_time_ms());
+  if (options.keepalive_timeout_ms() !=
+      GrpcOptions::DefaultKeepaliveTimeoutMs) {
+    args.SetInt(GRPC_ARG_KEEPALIVE_TIMEOUT_MS, options.keepalive_timeout_ms());
+  }
+  if (options.max_receive_message_size() !=
+      GrpcOptions::DefaultMaxReceiveMessageSize) {
+    args.SetMaxReceiveMessageSize(options.max_receive_message_size());
+  }
 
   const HostConfig* host_config = Config().find(host);
   if (!host_config) {
@@ -333,6 +352,7 @@ std::unique_ptr<GrpcStream> GrpcConnection::CreateStream(
   EnsureActiveStub();
 
   auto context = CreateContext(auth_token, app_check_token);
+  SetCompression(context.get());
   auto call =
       grpc_stub_->PrepareCall(context.get(), MakeString(rpc_name), grpc_queue_);
   return absl::make_unique<GrpcStream>(std::move(context), std::move(call),
@@ -361,6 +381,7 @@ std::unique_ptr<GrpcStreamingReader> GrpcConnection::CreateStreamingReader(
   EnsureActiveStub();
 
   auto context = CreateContext(auth_token, app_check_token);
+  SetCompression(context.get());
   auto call =
       grpc_stub_->PrepareCall(context.get(), MakeString(rpc_name), grpc_queue_);
   return absl::make_unique<GrpcStreamingReader>(
@@ -395,6 +416,19 @@ void GrpcConnection::Unregister(GrpcCall* call) {
   active_calls_.erase(found);
 }
 
+grpc_compression_algorithm GrpcConnection::ToGrpcCompression(
+    GrpcOptions::Compression compression) {
+  switch (compression) {
+    case GrpcOptions::Compression::None:
+      return GRPC_COMPRESS_NONE;
+    case GrpcOptions::Compression::Deflate:
+      return GRPC_COMPRESS_DEFLATE;
+    case GrpcOptions::Compression::Gzip:
+      return GRPC_COMPRESS_GZIP;
+  }
+  UNREACHABLE();
+}
+
 void GrpcConnection::SetClientLanguage(std::string language_token) {
   LanguageToken().Set(std::move(language_token));
 }
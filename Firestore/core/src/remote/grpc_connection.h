@@ -26,6 +26,7 @@
 #include "Firestore/core/src/credentials/auth_token.h"
 #include "Firestore/core/src/remote/connectivity_monitor.h"
 #include "Firestore/core/src/remote/grpc_call.h"
+#include "Firestore/core/src/remote/grpc_options.h"
 #include "Firestore/core/src/remote/grpc_stream.h"
 #include "Firestore/core/src/remote/grpc_stream_observer.h"
 #include "Firestore/core/src/remote/grpc_streaming_reader.h"
@@ -94,6 +95,10 @@ class GrpcConnection {
 
   static void SetClientLanguage(std::string language_token);
 
+  /** Returns the gRPC algorithm that implements the given compression. */
+  static grpc_compression_algorithm ToGrpcCompression(
+      GrpcOptions::Compression compression);
+
   /**
    * Don't use SSL, send all traffic unencrypted. Call before creating any
    * streams or calls.
@@ -112,6 +117,8 @@ class GrpcConnection {
   std::unique_ptr<grpc::ClientContext> CreateContext(
       const credentials::AuthToken& auth_token,
       const std::string& app_check_token) const;
+  // Applies the configured compression to a streaming call.
+  void SetCompression(grpc::ClientContext* context) const;
   std::shared_ptr<grpc::Channel> CreateChannel() const;
   void EnsureActiveStub();
 
@@ -0,0 +1,43 @@
+/*
+ * Copyright 2021 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Firestore/core/src/remote/grpc_options.h"
+
+#include "Firestore/core/src/util/hashing.h"
+
+namespace firebase {
+namespace firestore {
+namespace remote {
+
+constexpr int GrpcOptions::DefaultMaxReceiveMessageSize;
+constexpr int GrpcOptions::DefaultKeepaliveTimeMs;
+constexpr int GrpcOptions::DefaultKeepaliveTimeoutMs;
+
+size_t GrpcOptions::Hash() const {
+  return util::Hash(static_cast<int>(compression_), max_receive_message_size_,
+                    keepalive_time_ms_, keepalive_timeout_ms_);
+}
+
+bool operator==(const GrpcOptions& lhs, const GrpcOptions& rhs) {
+  return lhs.compression_ == rhs.compression_ &&
+         lhs.max_receive_message_size_ == rhs.max_receive_message_size_ &&
+         lhs.keepalive_time_ms_ == rhs.keepalive_time_ms_ &&
+         lhs.keepalive_timeout_ms_ == rhs.keepalive_timeout_ms_;
+}
+
+}  // namespace remote
+}  // namespace firestore
+}  // namespace firebase
@@ -0,0 +1,112 @@
+/*
+ * Copyright 2021 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FIRESTORE_CORE_SRC_REMOTE_GRPC_OPTIONS_H_
+#define FIRESTORE_CORE_SRC_REMOTE_GRPC_OPTIONS_H_
+
+#include <cstddef>
+
+namespace firebase {
+namespace firestore {
+namespace remote {
+
+/**
+ * Tunes the gRPC channel and calls that `GrpcConnection` creates.
+ *
+ * The defaults match the behavior of the SDK before these options existed.
+ */
+class GrpcOptions {
+ public:
+  /** Message compression applied to streaming calls. */
+  enum class Compression {
+    None,
+    Deflate,
+    Gzip,
+  };
+
+  /** Leaves the limit imposed by gRPC itself in place. */
+  static constexpr int DefaultMaxReceiveMessageSize = -1;
+  static constexpr int DefaultKeepaliveTimeMs = 30 * 1000;
+  /** Leaves the timeout imposed by gRPC itself in place. */
+  static constexpr int DefaultKeepaliveTimeoutMs = -1;
+
+  GrpcOptions() = default;
+
+  /**
+   * The compression requested for messages sent on the watch and write streams
+   * and on `BatchGetDocuments` calls. The algorithm is also advertised to the
+   * server, which may then compress its responses.
+   */
+  void set_compression(Compression value) {
+    compression_ = value;
+  }
+  Compression compression() const {
+    return compression_;
+  }
+
+  /**
+   * The largest message, in bytes, that the client will accept from the
+   * server, or `DefaultMaxReceiveMessageSize`.
+   */
+  void set_max_receive_message_size(int value) {
+    max_receive_message_size_ = value;
+  }
+  int max_receive_message_size() const {
+    return max_receive_message_size_;
+  }
+
+  /**
+   * How often to send HTTP/2 keepalive pings to detect a dead connection when
+   * the OS doesn't report it.
+   */
+  void set_keepalive_time_ms(int value) {
+    keepalive_time_ms_ = value;
+  }
+  int keepalive_time_ms() const {
+    return keepalive_time_ms_;
+  }
+
+  /**
+   * How long to wait for a keepalive ping to be acknowledged before the
+   * connection is considered dead, or `DefaultKeepaliveTimeoutMs`.
+   */
+  void set_keepalive_timeout_ms(int value) {
+    keepalive_timeout_ms_ = value;
+  }
+  int keepalive_timeout_ms() const {
+    return keepalive_timeout_ms_;
+  }
+
+  friend bool operator==(const GrpcOptions& lhs, const GrpcOptions& rhs);
+
+  size_t Hash() const;
+
+ private:
+  Compression compression_ = Compression::None;
+  int max_receive_message_size_ = DefaultMaxReceiveMessageSize;
+  int keepalive_time_ms_ = DefaultKeepaliveTimeMs;
+  int keepalive_timeout_ms_ = DefaultKeepaliveTimeoutMs;
+};
+
+inline bool operator!=(const GrpcOptions& lhs, const GrpcOptions& rhs) {
+  return !(lhs == rhs);
+}
+
+}  // namespace remote
+}  // namespace firestore
+}  // namespace firebase
+
+#endif  // FIRESTORE_CORE_SRC_REMOTE_GRPC_OPTIONS_H_
@@ -135,6 +135,22 @@ void GrpcStream::Read() {
   call_->Read(completion->message(), completion.get());
 }
 
+void GrpcStream::SuspendReads() {
+  are_reads_suspended_ = true;
+}
+
+void GrpcStream::ResumeReads() {
+  if (!are_reads_suspended_) {
+    return;
+  }
+
+  are_reads_suspended_ = false;
+  if (has_deferred_read_) {
+    has_deferred_read_ = false;
+    Read();
+  }
+}
+
 void GrpcStream::Write(grpc::ByteBuffer&& message) {
   MaybeWrite(buffered_writer_.EnqueueWrite(std::move(message)));
 }
@@ -294,10 +310,14 @@ GrpcStream::Metadata GrpcStream::GetResponseHeaders() const {
 void GrpcStream::OnRead(const grpc::ByteBuffer& message) {
   if (observer_) {
     // Continue waiting for new messages indefinitely as long as there is an
-    // interested observer.
+    // interested observer that hasn't suspended reads.
     // Order is important here -- any call to observer can potentially end this
     // stream's lifetime, so call `Read` before notifying.
-    Read();
+    if (are_reads_suspended_) {
+      has_deferred_read_ = true;
+    } else {
+      Read();
+    }
     observer_->OnStreamRead(message);
   }
 }
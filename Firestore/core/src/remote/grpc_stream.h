@@ -169,6 +169,21 @@ class GrpcStream : public GrpcCall {
     return observer_ == nullptr;
   }
 
+  /**
+   * Stops requesting new messages from the server once the currently pending
+   * read completes. While reads are suspended, gRPC flow control will
+   * eventually stop the server from sending more data.
+   *
+   * Can be called repeatedly; has no effect if reads are already suspended.
+   */
+  void SuspendReads();
+
+  /**
+   * Resumes requesting new messages from the server after a call to
+   * `SuspendReads`. Has no effect if reads are not suspended.
+   */
+  void ResumeReads();
+
   /**
    * Returns the metadata received from the server.
    *
@@ -239,6 +254,11 @@ class GrpcStream : public GrpcCall {
 
   // gRPC asserts that a call is finished exactly once.
   bool is_grpc_call_finished_ = false;
+
+  // Set while the observer doesn't want any more messages; `has_deferred_read_`
+  // records that a read was skipped and has to be issued upon resuming.
+  bool are_reads_suspended_ = false;
+  bool has_deferred_read_ = false;
 };
 
 }  // namespace remote
@@ -18,7 +18,9 @@
 
 #include <map>
 
+#include "Firestore/core/src/core/bound.h"
 #include "Firestore/core/src/core/database_info.h"
+#include "Firestore/core/src/core/target.h"
 #include "Firestore/core/src/model/document.h"
 #include "Firestore/core/src/model/document_key.h"
 #include "Firestore/core/src/model/mutation.h"
@@ -38,6 +40,7 @@ namespace firebase {
 namespace firestore {
 namespace remote {
 
+using core::Bound;
 using core::DatabaseInfo;
 using local::TargetData;
 using model::Document;
@@ -264,6 +267,49 @@ DatastoreSerializer::MergeLookupResponses(
   return result;
 }
 
+Message<google_firestore_v1_PartitionQueryRequest>
+DatastoreSerializer::EncodePartitionQueryRequest(
+    const core::Target& target,
+    int64_t partition_count,
+    const std::string& page_token) const {
+  Message<google_firestore_v1_PartitionQueryRequest> result;
+
+  // The request takes ownership of the encoded query.
+  google_firestore_v1_Target_QueryTarget query_target =
+      serializer_.EncodeQueryTarget(target);
+  result->parent = query_target.parent;
+  result->which_query_type =
+      google_firestore_v1_PartitionQueryRequest_structured_query_tag;
+  result->query_type.structured_query = query_target.structured_query;
+
+  result->partition_count = partition_count;
+  if (!page_token.empty()) {
+    result->page_token = nanopb::MakeBytesArray(page_token);
+  }
+
+  return result;
+}
+
+StatusOr<std::vector<Bound>> DatastoreSerializer::DecodePartitionQueryResponse(
+    const grpc::ByteBuffer& response, std::string* next_page_token) const {
+  ByteBufferReader reader{response};
+  auto message =
+      Message<google_firestore_v1_PartitionQueryResponse>::TryParse(&reader);
+  if (!reader.ok()) {
+    return reader.status();
+  }
+
+  std::vector<Bound> partitions;
+  partitions.reserve(message->partitions_count);
+  for (pb_size_t i = 0; i < message->partitions_count; ++i) {
+    partitions.push_back(serializer_.DecodeBound(message->partitions[i]));
+  }
+  *next_page_token = nanopb::MakeString(message->next_page_token);
+
+  StatusOr<std::vector<Bound>> result{std::move(partitions)};
+  return result;
+}
+
 }  // namespace remote
 }  // namespace firestore
 }  // namespace firebase
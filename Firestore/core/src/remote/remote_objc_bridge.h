@@ -17,6 +17,7 @@
 #ifndef FIRESTORE_CORE_SRC_REMOTE_REMOTE_OBJC_BRIDGE_H_
 #define FIRESTORE_CORE_SRC_REMOTE_REMOTE_OBJC_BRIDGE_H_
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <utility>
@@ -133,6 +134,23 @@ class DatastoreSerializer {
   util::StatusOr<std::vector<model::Document>> MergeLookupResponses(
       const std::vector<grpc::ByteBuffer>& responses) const;
 
+  /**
+   * Encodes a request for up to `partition_count` points that split the
+   * results of `target` into partitions. `page_token` continues an earlier
+   * request, and is empty for the first page.
+   */
+  nanopb::Message<google_firestore_v1_PartitionQueryRequest>
+  EncodePartitionQueryRequest(const core::Target& target,
+                              int64_t partition_count,
+                              const std::string& page_token) const;
+
+  /**
+   * Decodes one page of partition points. Sets `next_page_token` to the token
+   * of the following page, or to an empty string if this page is the last one.
+   */
+  util::StatusOr<std::vector<core::Bound>> DecodePartitionQueryResponse(
+      const grpc::ByteBuffer& response, std::string* next_page_token) const;
+
   const Serializer& serializer() const {
     return serializer_;
   }
@@ -16,6 +16,7 @@
 
 #include "Firestore/core/src/remote/remote_store.h"
 
+#include <algorithm>
 #include <string>
 #include <utility>
 
@@ -40,8 +41,10 @@ using local::LocalStore;
 using local::QueryPurpose;
 using local::TargetData;
 using model::BatchId;
+using model::DocumentKey;
 using model::DocumentKeySet;
 using model::kBatchIdUnknown;
+using model::Mutation;
 using model::MutationBatch;
 using model::MutationBatchResult;
 using model::MutationResult;
@@ -398,6 +401,7 @@ void RemoteStore::AddToWritePipeline(const MutationBatch& batch) {
               "AddToWritePipeline called when pipeline is full");
 
   write_pipeline_.push_back(batch);
+  last_batch_id_added_ = std::max(last_batch_id_added_, batch.batch_id());
 
   if (write_stream_->IsOpen() && write_stream_->handshake_complete()) {
     write_stream_->WriteMutations(batch.mutations());
@@ -536,6 +540,22 @@ std::shared_ptr<Transaction> RemoteStore::CreateTransaction() {
   return std::make_shared<Transaction>(datastore_);
 }
 
+void RemoteStore::LookupDocuments(const std::vector<DocumentKey>& keys,
+                                  Datastore::LookupCallback&& callback) {
+  datastore_->LookupDocuments(keys, std::move(callback));
+}
+
+void RemoteStore::CommitMutations(const std::vector<Mutation>& mutations,
+                                  Datastore::CommitCallback&& callback) {
+  datastore_->CommitMutations(mutations, std::move(callback));
+}
+
+void RemoteStore::PartitionQuery(const core::Target& target,
+                                 int64_t partition_count,
+                                 Datastore::PartitionQueryCallback&& callback) {
+  datastore_->PartitionQuery(target, partition_count, std::move(callback));
+}
+
 DocumentKeySet RemoteStore::GetRemoteKeysForTarget(TargetId target_id) const {
   return sync_engine_->GetRemoteKeys(target_id);
 }
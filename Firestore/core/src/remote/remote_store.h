@@ -17,6 +17,7 @@
 #ifndef FIRESTORE_CORE_SRC_REMOTE_REMOTE_STORE_H_
 #define FIRESTORE_CORE_SRC_REMOTE_REMOTE_STORE_H_
 
+#include <cstdint>
 #include <memory>
 #include <unordered_map>
 #include <vector>
@@ -178,6 +179,16 @@ class RemoteStore : public TargetMetadataProvider,
    */
   void FillWritePipeline();
 
+  /**
+   * Returns the highest ID of any batch that was added to the write pipeline
+   * since this `RemoteStore` was created, or `kBatchIdUnknown` if there was
+   * none. Such batches may have been sent to the backend even if the pipeline
+   * has been cleared since, so they must not change.
+   */
+  model::BatchId LastBatchIdAddedToWritePipeline() const {
+    return last_batch_id_added_;
+  }
+
   /**
    * Queues additional writes to be sent to the write stream, sending them
    * immediately if the write stream is established.
@@ -189,6 +200,29 @@ class RemoteStore : public TargetMetadataProvider,
   // `Transaction` into lambdas.
   std::shared_ptr<core::Transaction> CreateTransaction();
 
+  /**
+   * Looks up the given documents with a single BatchGetDocuments call. The
+   * callback is invoked on the worker queue.
+   */
+  void LookupDocuments(const std::vector<model::DocumentKey>& keys,
+                       Datastore::LookupCallback&& callback);
+
+  /**
+   * Commits the given mutations directly with a single Commit call, bypassing
+   * the write pipeline. The callback is invoked on the worker queue.
+   */
+  void CommitMutations(const std::vector<model::Mutation>& mutations,
+                       Datastore::CommitCallback&& callback);
+
+  /**
+   * Asks the backend for up to `partition_count` points that split the results
+   * of `target`; see `Datastore::PartitionQuery`. The callback is invoked on
+   * the worker queue.
+   */
+  void PartitionQuery(const core::Target& target,
+                      int64_t partition_count,
+                      Datastore::PartitionQueryCallback&& callback);
+
   model::DocumentKeySet GetRemoteKeysForTarget(
       model::TargetId target_id) const override;
   absl::optional<local::TargetData> GetTargetDataForTarget(
@@ -304,6 +338,9 @@ class RemoteStore : public TargetMetadataProvider,
    * the `write_pipeline_` as we receive responses.
    */
   std::vector<model::MutationBatch> write_pipeline_;
+
+  /** The highest ID of any batch that was added to `write_pipeline_`. */
+  model::BatchId last_batch_id_added_ = model::kBatchIdUnknown;
 };
 
 }  // namespace remote
@@ -54,6 +54,7 @@
 #include "Firestore/core/src/util/statusor.h"
 #include "Firestore/core/src/util/string_format.h"
 #include "absl/algorithm/container.h"
+#include "absl/strings/str_cat.h"
 #include "absl/types/span.h"
 
 namespace firebase {
@@ -183,7 +184,13 @@ pb_bytes_array_t* Serializer::EncodeDatabaseName() const {
 }
 
 pb_bytes_array_t* Serializer::EncodeKey(const DocumentKey& key) const {
-  return EncodeResourceName(database_id_, key.path());
+  // Equivalent to `EncodeResourceName(database_id_, key.path())`, without
+  // building the path of the document.
+  ResourcePath collection_name = DatabaseName(database_id_)
+                                     .Append("documents")
+                                     .Append(key.collection_path());
+  return Serializer::EncodeString(absl::StrCat(
+      collection_name.CanonicalString(), "/", key.document_id()));
 }
 
 void Serializer::ValidateDocumentKeyPath(
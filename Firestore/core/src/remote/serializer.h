@@ -196,6 +196,14 @@ class Serializer {
       util::ReadContext* context,
       google_firestore_v1_Target_QueryTarget& query) const;
 
+  google_firestore_v1_Cursor EncodeBound(const core::Bound& bound) const;
+
+  /**
+   * Decodes the cursor. Modifies the provided proto to release ownership of
+   * any Value messages.
+   */
+  core::Bound DecodeBound(google_firestore_v1_Cursor& cursor) const;
+
   core::Target DecodeStructuredQuery(
       util::ReadContext* context,
       pb_bytes_array_t* parent,
@@ -294,9 +302,6 @@ class Serializer {
       util::ReadContext* context,
       const google_firestore_v1_StructuredQuery_Order& order_by) const;
 
-  google_firestore_v1_Cursor EncodeBound(const core::Bound& bound) const;
-  core::Bound DecodeBound(google_firestore_v1_Cursor& cursor) const;
-
   std::unique_ptr<remote::WatchChange> DecodeTargetChange(
       util::ReadContext* context,
       const google_firestore_v1_TargetChange& change) const;
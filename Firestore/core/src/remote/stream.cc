@@ -260,11 +260,31 @@ void Stream::OnStreamRead(const grpc::ByteBuffer& message) {
 
   Status read_status = NotifyStreamResponse(message);
   if (!read_status.ok()) {
-    grpc_stream_->FinishImmediately();
-    // Don't expect gRPC to produce status -- since the error happened on the
-    // client, we have all the information we need.
-    OnStreamFinish(read_status);
-    return;
+    CloseWithResponseError(read_status);
+  }
+}
+
+void Stream::CloseWithResponseError(const Status& status) {
+  EnsureOnQueue();
+  HARD_ASSERT(IsOpen(), "Cannot fail a response when the stream is not open.");
+
+  grpc_stream_->FinishImmediately();
+  // Don't expect gRPC to produce status -- since the error happened on the
+  // client, we have all the information we need.
+  OnStreamFinish(status);
+}
+
+void Stream::SuspendReads() {
+  EnsureOnQueue();
+  if (grpc_stream_) {
+    grpc_stream_->SuspendReads();
+  }
+}
+
+void Stream::ResumeReads() {
+  EnsureOnQueue();
+  if (grpc_stream_) {
+    grpc_stream_->ResumeReads();
   }
 }
 
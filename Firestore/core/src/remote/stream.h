@@ -209,6 +209,21 @@ class Stream : public GrpcStreamObserver,
   void Write(grpc::ByteBuffer&& message);
   std::string GetDebugDescription() const;
 
+  // Allows subclasses that process responses asynchronously to stop and resume
+  // reading from the underlying gRPC stream. No-ops if the stream isn't open.
+  void SuspendReads();
+  void ResumeReads();
+
+  // Closes the stream with the given error after a response from the server
+  // couldn't be processed. Only valid while the stream is open.
+  void CloseWithResponseError(const util::Status& status);
+
+  // The number of times the stream has been closed. Callbacks that outlive an
+  // incarnation of the stream can compare it to tell whether they still apply.
+  int close_count() const {
+    return close_count_;
+  }
+
   ExponentialBackoff backoff_;
 
  private:
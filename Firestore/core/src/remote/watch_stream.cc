@@ -16,6 +16,8 @@
 
 #include "Firestore/core/src/remote/watch_stream.h"
 
+#include <algorithm>
+#include <thread>  // NOLINT(build/c++11)
 #include <utility>
 
 #include "Firestore/core/src/model/mutation.h"
@@ -36,9 +38,24 @@ using local::TargetData;
 using model::TargetId;
 using remote::ByteBufferReader;
 using util::AsyncQueue;
+using util::Executor;
 using util::Status;
 using util::TimerId;
 
+namespace {
+
+/**
+ * The number of responses that may be received but not yet delivered to the
+ * callback before the stream stops reading from the network. Reads resume
+ * once the backlog has dropped to half of this.
+ */
+const uint64_t kMaxPendingResponses = 64;
+
+/** The maximum number of threads used to decode responses. */
+const unsigned int kMaxDecoderThreads = 4;
+
+}  // namespace
+
 WatchStream::WatchStream(
     const std::shared_ptr<AsyncQueue>& async_queue,
     std::shared_ptr<credentials::AuthCredentialsProvider>
@@ -47,7 +64,8 @@ WatchStream::WatchStream(
         app_check_credentials_provider,
     Serializer serializer,
     GrpcConnection* grpc_connection,
-    WatchStreamCallback* callback)
+    WatchStreamCallback* callback,
+    std::unique_ptr<Executor> decoder)
     : Stream{async_queue,
              std::move(auth_credentials_provider),
              std::move(app_check_credentials_provider),
@@ -55,14 +73,29 @@ WatchStream::WatchStream(
              TimerId::ListenStreamConnectionBackoff,
              TimerId::ListenStreamIdle,
              TimerId::HealthCheckTimeout},
-      watch_serializer_{std::move(serializer)},
-      callback_{NOT_NULL(callback)} {
+      watch_serializer_{
+          std::make_shared<WatchStreamSerializer>(std::move(serializer))},
+      callback_{NOT_NULL(callback)},
+      async_queue_{async_queue},
+      decoder_{std::move(decoder)} {
+  if (decoder_) {
+    return;
+  }
+
+  auto hw_concurrency = std::thread::hardware_concurrency();
+  if (hw_concurrency == 0) {
+    // If the standard library doesn't know, guess something reasonable.
+    hw_concurrency = 4;
+  }
+  decoder_ = Executor::CreateConcurrent(
+      "com.google.firebase.firestore.watch_decoder",
+      static_cast<int>(std::min(hw_concurrency, kMaxDecoderThreads)));
 }
 
 void WatchStream::WatchQuery(const TargetData& query) {
   EnsureOnQueue();
 
-  auto request = watch_serializer_.EncodeWatchRequest(query);
+  auto request = watch_serializer_->EncodeWatchRequest(query);
   LOG_DEBUG("%s watch: %s", GetDebugDescription(), request.ToString());
   Write(MakeByteBuffer(request));
 }
@@ -70,7 +103,7 @@ void WatchStream::WatchQuery(const TargetData& query) {
 void WatchStream::UnwatchTargetId(TargetId target_id) {
   EnsureOnQueue();
 
-  auto request = watch_serializer_.EncodeUnwatchRequest(target_id);
+  auto request = watch_serializer_->EncodeUnwatchRequest(target_id);
 
   LOG_DEBUG("%s unwatch: %s", GetDebugDescription(), request.ToString());
   Write(MakeByteBuffer(request));
@@ -93,29 +126,165 @@ void WatchStream::NotifyStreamOpen() {
 }
 
 Status WatchStream::NotifyStreamResponse(const grpc::ByteBuffer& message) {
+  uint64_t sequence_number = next_sequence_number_++;
+  pending_responses_.emplace(sequence_number, message);
+  if (pending_response_count() >= kMaxPendingResponses &&
+      !are_reads_suspended_) {
+    LOG_DEBUG("%s suspending reads with %s responses pending",
+              GetDebugDescription(), pending_response_count());
+    are_reads_suspended_ = true;
+    SuspendReads();
+  }
+
+  // `Stream` is always owned by a `shared_ptr`, see `RequestCredentials`.
+  std::weak_ptr<Stream> weak_this{shared_from_this()};
+  std::shared_ptr<AsyncQueue> async_queue = async_queue_;
+  std::shared_ptr<const WatchStreamSerializer> serializer = watch_serializer_;
+  int close_count = this->close_count();
+  std::string description =
+      util::LogIsDebugEnabled() ? GetDebugDescription() : std::string{};
+
+  decoder_->Execute([weak_this, async_queue, serializer, description,
+                     close_count, sequence_number, message] {
+    // `Operation` must be copyable, hence the `shared_ptr`.
+    auto response = std::make_shared<DecodedResponse>(
+        DecodeResponse(*serializer, description, message));
+
+    async_queue->Enqueue(
+        [weak_this, close_count, sequence_number, response] {
+          auto strong_this = weak_this.lock();
+          if (!strong_this) {
+            return;
+          }
+          auto watch_stream = std::static_pointer_cast<WatchStream>(
+              std::move(strong_this));
+          watch_stream->OnResponseDecoded(close_count, sequence_number,
+                                          std::move(*response));
+        });
+  });
+
+  // Errors are reported once the response is delivered, in stream order.
+  return Status::OK();
+}
+
+WatchStream::DecodedResponse WatchStream::DecodeResponse(
+    const WatchStreamSerializer& serializer,
+    const std::string& description,
+    const grpc::ByteBuffer& message) {
+  DecodedResponse result;
+
   ByteBufferReader reader{message};
-  auto response = watch_serializer_.ParseResponse(&reader);
+  auto response = serializer.ParseResponse(&reader);
   if (!reader.ok()) {
-    return reader.status();
+    result.status = reader.status();
+    return result;
   }
 
-  LOG_DEBUG("%s response: %s", GetDebugDescription(), response.ToString());
+  LOG_DEBUG("%s response: %s", description, response.ToString());
 
-  // A successful response means the stream is healthy.
-  backoff_.Reset();
+  result.change = serializer.DecodeWatchChange(&reader, *response);
+  result.version = serializer.DecodeSnapshotVersion(&reader, *response);
+  result.status = reader.status();
+  return result;
+}
 
-  auto watch_change = watch_serializer_.DecodeWatchChange(&reader, *response);
-  auto version = watch_serializer_.DecodeSnapshotVersion(&reader, *response);
-  if (!reader.ok()) {
-    return reader.status();
+void WatchStream::OnResponseDecoded(int close_count,
+                                    uint64_t sequence_number,
+                                    DecodedResponse response) {
+  EnsureOnQueue();
+  if (close_count != this->close_count()) {
+    // The stream has been closed since the response was received.
+    return;
   }
 
-  callback_->OnWatchStreamChange(*watch_change, version);
+  decoded_responses_.emplace(sequence_number, std::move(response));
 
+  Status status = DeliverResponses(/*decode_pending=*/false);
+  if (!status.ok()) {
+    // The responses after the one that failed are never delivered.
+    DropPendingResponses();
+    CloseWithResponseError(status);
+    return;
+  }
+  if (close_count != this->close_count()) {
+    // The callback closed the stream.
+    return;
+  }
+
+  if (are_reads_suspended_ &&
+      pending_response_count() <= kMaxPendingResponses / 2) {
+    LOG_DEBUG("%s resuming reads", GetDebugDescription());
+    are_reads_suspended_ = false;
+    ResumeReads();
+  }
+}
+
+Status WatchStream::DeliverResponses(bool decode_pending) {
+  int close_count = this->close_count();
+  while (next_sequence_number_to_deliver_ < next_sequence_number_) {
+    uint64_t sequence_number = next_sequence_number_to_deliver_;
+
+    DecodedResponse next;
+    auto decoded = decoded_responses_.find(sequence_number);
+    if (decoded != decoded_responses_.end()) {
+      next = std::move(decoded->second);
+      decoded_responses_.erase(decoded);
+    } else if (decode_pending) {
+      // The decoder's result will arrive after the stream closed and be
+      // dropped.
+      std::string description =
+          util::LogIsDebugEnabled() ? GetDebugDescription() : std::string{};
+      next = DecodeResponse(*watch_serializer_, description,
+                            pending_responses_.at(sequence_number));
+    } else {
+      break;
+    }
+    pending_responses_.erase(sequence_number);
+    ++next_sequence_number_to_deliver_;
+
+    if (!next.status.ok()) {
+      return next.status;
+    }
+
+    // A successful response means the stream is healthy.
+    backoff_.Reset();
+
+    callback_->OnWatchStreamChange(*next.change, next.version);
+    if (close_count != this->close_count()) {
+      break;
+    }
+  }
   return Status::OK();
 }
 
+void WatchStream::DropPendingResponses() {
+  next_sequence_number_ = 0;
+  next_sequence_number_to_deliver_ = 0;
+  pending_responses_.clear();
+  decoded_responses_.clear();
+  are_reads_suspended_ = false;
+}
+
+void WatchStream::OnStreamFinish(const Status& status) {
+  EnsureOnQueue();
+
+  // The responses were received before the stream finished, so the callback
+  // sees them first, as it would if they were decoded on the worker queue.
+  int close_count = this->close_count();
+  Status response_status = DeliverResponses(/*decode_pending=*/true);
+  if (close_count != this->close_count()) {
+    // The callback closed the stream.
+    return;
+  }
+
+  Stream::OnStreamFinish(response_status.ok() ? status : response_status);
+}
+
 void WatchStream::NotifyStreamClose(const Status& status) {
+  // Drop any responses that haven't been delivered yet, which is only the case
+  // if the stream was stopped; the new stream will start from a clean slate.
+  DropPendingResponses();
+
   callback_->OnWatchStreamClose(status);
 }
 
@@ -17,16 +17,20 @@
 #ifndef FIRESTORE_CORE_SRC_REMOTE_WATCH_STREAM_H_
 #define FIRESTORE_CORE_SRC_REMOTE_WATCH_STREAM_H_
 
+#include <cstdint>
+#include <map>
 #include <memory>
 #include <string>
 
 #include "Firestore/core/src/model/model_fwd.h"
+#include "Firestore/core/src/model/snapshot_version.h"
 #include "Firestore/core/src/remote/grpc_connection.h"
 #include "Firestore/core/src/remote/remote_objc_bridge.h"
 #include "Firestore/core/src/remote/stream.h"
 #include "Firestore/core/src/remote/watch_change.h"
 #include "Firestore/core/src/util/async_queue.h"
-#include "Firestore/core/src/util/status_fwd.h"
+#include "Firestore/core/src/util/executor.h"
+#include "Firestore/core/src/util/status.h"
 #include "absl/strings/string_view.h"
 #include "grpcpp/support/byte_buffer.h"
 
@@ -80,9 +84,19 @@ class WatchStreamCallback {
  * Once the `WatchStream` has called the `OnWatchStreamOpen` method on the
  * callback, any number of `WatchQuery` and `UnwatchTargetId` calls can be sent
  * to control what changes will be sent from the server for WatchChanges.
+ *
+ * Responses are decoded on a pool of worker threads rather than on the worker
+ * queue. Each response is tagged with a sequence number when it arrives, and
+ * decoded changes are handed to the callback strictly in that order. If too
+ * many responses are awaiting delivery, the stream stops reading from the
+ * network until the backlog drains.
  */
 class WatchStream : public Stream {
  public:
+  /**
+   * Responses are decoded on `decoder` if given, otherwise on a pool of up to
+   * four threads.
+   */
   WatchStream(const std::shared_ptr<util::AsyncQueue>& async_queue,
               std::shared_ptr<credentials::AuthCredentialsProvider>
                   auth_credentials_provider,
@@ -90,7 +104,8 @@ class WatchStream : public Stream {
                   app_check_credentials_provider,
               Serializer serializer,
               GrpcConnection* grpc_connection,
-              WatchStreamCallback* callback);
+              WatchStreamCallback* callback,
+              std::unique_ptr<util::Executor> decoder = nullptr);
 
   /**
    * Registers interest in the results of the given query. If the query includes
@@ -108,7 +123,22 @@ class WatchStream : public Stream {
   virtual /*virtual for tests only*/ void UnwatchTargetId(
       model::TargetId target_id);
 
+  /**
+   * Whether the stream has stopped reading from the network because too many
+   * responses are awaiting delivery.
+   */
+  bool are_reads_suspended() const {
+    return are_reads_suspended_;
+  }
+
  private:
+  /** The result of decoding a single `ListenResponse`. */
+  struct DecodedResponse {
+    util::Status status;
+    std::unique_ptr<WatchChange> change;
+    model::SnapshotVersion version;
+  };
+
   std::unique_ptr<GrpcStream> CreateGrpcStream(
       GrpcConnection* grpc_connection,
       const credentials::AuthToken& auth_token,
@@ -119,12 +149,61 @@ class WatchStream : public Stream {
   util::Status NotifyStreamResponse(const grpc::ByteBuffer& message) override;
   void NotifyStreamClose(const util::Status& status) override;
 
+  /**
+   * Delivers the responses that arrived before the stream finished, decoding
+   * any that the decoder hasn't got to yet, before reporting the close.
+   */
+  void OnStreamFinish(const util::Status& status) override;
+
   std::string GetDebugName() const override {
     return "WatchStream";
   }
 
-  WatchStreamSerializer watch_serializer_;
+  /**
+   * Decodes the given response. Invoked on the `decoder_` executor, so it must
+   * not touch any state of the stream; `description` identifies the stream in
+   * log messages.
+   */
+  static DecodedResponse DecodeResponse(const WatchStreamSerializer& serializer,
+                                        const std::string& description,
+                                        const grpc::ByteBuffer& message);
+
+  /**
+   * Records the decoded response with the given sequence number and delivers
+   * all responses that are now ready, in order.
+   */
+  void OnResponseDecoded(int close_count,
+                         uint64_t sequence_number,
+                         DecodedResponse response);
+
+  /**
+   * Hands the responses that are next in stream order to the callback until
+   * one is still being decoded, or, if `decode_pending` is true, until all of
+   * them are delivered. Stops early if the callback closes the stream.
+   * Returns the error of the first response that failed to decode, if any.
+   */
+  util::Status DeliverResponses(bool decode_pending);
+
+  /** Forgets all responses that haven't been delivered yet. */
+  void DropPendingResponses();
+
+  uint64_t pending_response_count() const {
+    return next_sequence_number_ - next_sequence_number_to_deliver_;
+  }
+
+  std::shared_ptr<const WatchStreamSerializer> watch_serializer_;
   WatchStreamCallback* callback_;
+
+  std::shared_ptr<util::AsyncQueue> async_queue_;
+  std::unique_ptr<util::Executor> decoder_;
+
+  uint64_t next_sequence_number_ = 0;
+  uint64_t next_sequence_number_to_deliver_ = 0;
+  // The responses that haven't been delivered yet, and the decoded ones among
+  // them, by sequence number.
+  std::map<uint64_t, grpc::ByteBuffer> pending_responses_;
+  std::map<uint64_t, DecodedResponse> decoded_responses_;
+  bool are_reads_suspended_ = false;
 };
 
 }  // namespace remote
@@ -0,0 +1,98 @@
+/*
+ * Copyright 2021 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Firestore/core/src/util/arena.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#include "Firestore/core/src/util/hard_assert.h"
+
+namespace firebase {
+namespace firestore {
+namespace util {
+
+namespace {
+
+// Blocks start small so that short-lived arenas stay cheap, and then double
+// up to a limit so that large ones need few of them.
+const size_t kMinBlockSize = 4096;
+const size_t kMaxBlockSize = 1 << 20;
+
+size_t Padding(const char* ptr, size_t alignment) {
+  auto address = reinterpret_cast<uintptr_t>(ptr);
+  return (alignment - (address & (alignment - 1))) & (alignment - 1);
+}
+
+}  // namespace
+
+void* Arena::Allocate(size_t size, size_t alignment) {
+  HARD_ASSERT(alignment != 0 && (alignment & (alignment - 1)) == 0,
+              "Alignment must be a power of two");
+
+  size_t padding = Padding(ptr_, alignment);
+  if (ptr_ && padding + size <= remaining_) {
+    char* result = ptr_ + padding;
+    ptr_ += padding + size;
+    remaining_ -= padding + size;
+    return result;
+  }
+  return AllocateFallback(size, alignment);
+}
+
+absl::string_view Arena::CopyString(absl::string_view str) {
+  if (str.empty()) return {};
+
+  auto copy = static_cast<char*>(Allocate(str.size(), 1));
+  std::memcpy(copy, str.data(), str.size());
+  return absl::string_view(copy, str.size());
+}
+
+char* Arena::AllocateFallback(size_t size, size_t alignment) {
+  // Blocks are aligned for any type, so alignments up to that need no padding
+  // at the start of a new block.
+  size_t worst_case = size + (alignment > alignof(std::max_align_t)
+                                  ? alignment - alignof(std::max_align_t)
+                                  : 0);
+  size_t block_size =
+      std::min(std::max(kMinBlockSize, memory_usage_), kMaxBlockSize);
+
+  if (worst_case > block_size / 4) {
+    // Large objects get a block of their own, which avoids wasting the rest of
+    // the current block.
+    char* block = AllocateNewBlock(worst_case);
+    return block + Padding(block, alignment);
+  }
+
+  ptr_ = AllocateNewBlock(block_size);
+  remaining_ = block_size;
+  size_t padding = Padding(ptr_, alignment);
+  char* result = ptr_ + padding;
+  ptr_ += padding + size;
+  remaining_ -= padding + size;
+  return result;
+}
+
+char* Arena::AllocateNewBlock(size_t size) {
+  blocks_.emplace_back(new char[size]);
+  memory_usage_ += size;
+  return blocks_.back().get();
+}
+
+}  // namespace util
+}  // namespace firestore
+}  // namespace firebase
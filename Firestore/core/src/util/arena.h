@@ -0,0 +1,118 @@
+/*
+ * Copyright 2021 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FIRESTORE_CORE_SRC_UTIL_ARENA_H_
+#define FIRESTORE_CORE_SRC_UTIL_ARENA_H_
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+
+namespace firebase {
+namespace firestore {
+namespace util {
+
+/**
+ * An Arena hands out memory from large blocks, all of which are freed at once
+ * when the arena is destroyed. Individual allocations are never freed.
+ *
+ * This suits data that lives exactly as long as some owner, such as the
+ * pending writes of a transaction, where a general purpose allocator would
+ * otherwise be called several times per entry.
+ */
+class Arena {
+ public:
+  Arena() = default;
+
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+
+  /**
+   * Returns `size` bytes of uninitialized memory, aligned to `alignment`,
+   * which must be a power of two.
+   */
+  void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+  /** Copies the bytes of `str` into the arena and returns a view of them. */
+  absl::string_view CopyString(absl::string_view str);
+
+  /** Returns the total size of the blocks allocated by this arena. */
+  size_t memory_usage() const {
+    return memory_usage_;
+  }
+
+ private:
+  char* AllocateFallback(size_t size, size_t alignment);
+  char* AllocateNewBlock(size_t size);
+
+  char* ptr_ = nullptr;
+  size_t remaining_ = 0;
+  size_t memory_usage_ = 0;
+  std::vector<std::unique_ptr<char[]>> blocks_;
+};
+
+/**
+ * A standard allocator that allocates from an `Arena`, so that containers can
+ * keep their nodes in it. The arena must outlive any container using it.
+ */
+template <typename T>
+class ArenaAllocator {
+ public:
+  using value_type = T;
+
+  explicit ArenaAllocator(Arena* arena) : arena_(arena) {
+  }
+
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U>& other)  // NOLINT(runtime/explicit)
+      : arena_(other.arena()) {
+  }
+
+  T* allocate(size_t n) {
+    return static_cast<T*>(arena_->Allocate(n * sizeof(T), alignof(T)));
+  }
+
+  void deallocate(T*, size_t) {
+    // Memory is reclaimed when the arena is destroyed.
+  }
+
+  Arena* arena() const {
+    return arena_;
+  }
+
+  template <typename U>
+  friend bool operator==(const ArenaAllocator& lhs,
+                         const ArenaAllocator<U>& rhs) {
+    return lhs.arena() == rhs.arena();
+  }
+
+  template <typename U>
+  friend bool operator!=(const ArenaAllocator& lhs,
+                         const ArenaAllocator<U>& rhs) {
+    return lhs.arena() != rhs.arena();
+  }
+
+ private:
+  Arena* arena_ = nullptr;
+};
+
+}  // namespace util
+}  // namespace firestore
+}  // namespace firebase
+
+#endif  // FIRESTORE_CORE_SRC_UTIL_ARENA_H_
@@ -68,7 +68,20 @@ enum class TimerId {
    * A timer used to retry transactions. Since there can be multiple concurrent
    * transactions, multiple of these may be in the queue at a given time.
    */
-  RetryTransaction
+  RetryTransaction,
+
+  /**
+   * A timer used in `BulkWriter` to retry a failed commit. Since each batch
+   * backs off on its own, multiple of these may be in the queue at a given
+   * time.
+   */
+  RetryBulkWrite,
+
+  /**
+   * A timer used in `BulkWriter` to send more batches once the rate limiter
+   * allows it.
+   */
+  BulkWriterRateLimit
 };
 
 // A serial queue that executes given operations asynchronously, one at a time.
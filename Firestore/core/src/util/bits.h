@@ -62,12 +62,21 @@ class Bits {
   static int Log2FloorNonZero(uint32_t n);
   static int Log2FloorNonZero64(uint64_t n);
 
+  /**
+   * Return the number of trailing zero bits in n, i.e. the index of the lowest
+   * set bit. The result is undefined if n == 0.
+   */
+  static int CountTrailingZerosNonZero(uint32_t n);
+  static int CountTrailingZerosNonZero64(uint64_t n);
+
  private:
   // Portable implementations.
   static int Log2Floor_Portable(uint32_t n);
   static int Log2Floor64_Portable(uint64_t n);
   static int Log2FloorNonZero_Portable(uint32_t n);
   static int Log2FloorNonZero64_Portable(uint64_t n);
+  static int CountTrailingZerosNonZero_Portable(uint32_t n);
+  static int CountTrailingZerosNonZero64_Portable(uint64_t n);
 
   Bits(Bits const&) = delete;
   void operator=(Bits const&) = delete;
@@ -99,6 +108,14 @@ inline int Bits::Log2FloorNonZero64(uint64_t n) {
   return 63 ^ __builtin_clzll(n);
 }
 
+inline int Bits::CountTrailingZerosNonZero(uint32_t n) {
+  return __builtin_ctz(n);
+}
+
+inline int Bits::CountTrailingZerosNonZero64(uint64_t n) {
+  return __builtin_ctzll(n);
+}
+
 #elif defined(_MSC_VER)
 
 inline int Bits::Log2FloorNonZero(uint32_t n) {
@@ -138,6 +155,14 @@ inline int Bits::Log2FloorNonZero64(uint64_t n) {
   return Bits::Log2FloorNonZero64_Portable(n);
 }
 
+inline int Bits::CountTrailingZerosNonZero(uint32_t n) {
+  return Bits::CountTrailingZerosNonZero_Portable(n);
+}
+
+inline int Bits::CountTrailingZerosNonZero64(uint64_t n) {
+  return Bits::CountTrailingZerosNonZero64_Portable(n);
+}
+
 #else  // !__GNUC__ && !_MSC_VER
 
 inline int Bits::Log2Floor64(uint64_t n) {
@@ -148,6 +173,14 @@ inline int Bits::Log2FloorNonZero64(uint64_t n) {
   return Bits::Log2FloorNonZero64_Portable(n);
 }
 
+inline int Bits::CountTrailingZerosNonZero(uint32_t n) {
+  return Bits::CountTrailingZerosNonZero_Portable(n);
+}
+
+inline int Bits::CountTrailingZerosNonZero64(uint64_t n) {
+  return Bits::CountTrailingZerosNonZero64_Portable(n);
+}
+
 #endif
 
 inline int Bits::Log2FloorNonZero_Portable(uint32_t n) {
@@ -177,6 +210,15 @@ inline int Bits::Log2FloorNonZero64_Portable(uint64_t n) {
   }
 }
 
+// The lowest set bit is the only bit set in n & -n.
+inline int Bits::CountTrailingZerosNonZero_Portable(uint32_t n) {
+  return Log2FloorNonZero(n & (~n + 1));
+}
+
+inline int Bits::CountTrailingZerosNonZero64_Portable(uint64_t n) {
+  return Log2FloorNonZero64(n & (~n + 1));
+}
+
 }  // namespace util
 }  // namespace firestore
 }  // namespace firebase
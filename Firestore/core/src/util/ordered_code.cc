@@ -16,6 +16,8 @@
 
 #include "Firestore/core/src/util/ordered_code.h"
 
+#include <cstddef>
+
 #include "Firestore/core/src/util/bits.h"
 #include "Firestore/core/src/util/hard_assert.h"
 #include "absl/base/internal/endian.h"
@@ -28,6 +30,21 @@
        "ABSL_IS_LITTLE_ENDIAN must be defined"
 #endif
 
+// Vector instructions used to scan strings for the special bytes 16 or 32
+// bytes at a time. Without them, strings are scanned 8 bytes at a time.
+#if defined(__AVX2__)
+#define FIRESTORE_ORDERED_CODE_AVX2 1
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FIRESTORE_ORDERED_CODE_SSE2 1
+#include <emmintrin.h>
+#elif defined(ABSL_IS_LITTLE_ENDIAN) && \
+    (defined(__ARM_NEON) || defined(__ARM_NEON__))
+#define FIRESTORE_ORDERED_CODE_NEON 1
+#include <arm_neon.h>
+#endif
+
 #define UNALIGNED_LOAD32 ABSL_INTERNAL_UNALIGNED_LOAD32
 #define UNALIGNED_LOAD64 ABSL_INTERNAL_UNALIGNED_LOAD64
 #define UNALIGNED_STORE32 ABSL_INTERNAL_UNALIGNED_STORE32
@@ -123,6 +140,55 @@ inline static int AdvanceIfNoSpecialBytes(uint32_t v_32, const char* p) {
   }
 }
 
+#if defined(FIRESTORE_ORDERED_CODE_AVX2)
+
+static const ptrdiff_t kVectorSize = 32;
+
+/**
+ * Returns a pointer to the first special byte in the kVectorSize bytes
+ * starting at "p", or nullptr if there is none.
+ */
+inline static const char* FindSpecialByteInVector(const char* p) {
+  __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+  __m256i special =
+      _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_setzero_si256()),
+                      _mm256_cmpeq_epi8(v, _mm256_set1_epi8(kEscape2)));
+  auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(special));
+  if (mask == 0) return nullptr;
+  return p + Bits::CountTrailingZerosNonZero(mask);
+}
+
+#elif defined(FIRESTORE_ORDERED_CODE_SSE2)
+
+static const ptrdiff_t kVectorSize = 16;
+
+inline static const char* FindSpecialByteInVector(const char* p) {
+  __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+  __m128i special = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_setzero_si128()),
+                                 _mm_cmpeq_epi8(v, _mm_set1_epi8(kEscape2)));
+  auto mask = static_cast<uint32_t>(_mm_movemask_epi8(special));
+  if (mask == 0) return nullptr;
+  return p + Bits::CountTrailingZerosNonZero(mask);
+}
+
+#elif defined(FIRESTORE_ORDERED_CODE_NEON)
+
+static const ptrdiff_t kVectorSize = 16;
+
+inline static const char* FindSpecialByteInVector(const char* p) {
+  uint8x16_t v = vld1q_u8(reinterpret_cast<const uint8_t*>(p));
+  uint8x16_t special =
+      vorrq_u8(vceqq_u8(v, vdupq_n_u8(0)), vceqq_u8(v, vdupq_n_u8(0xff)));
+  // NEON has no movemask: narrowing each 16-bit lane by 4 bits leaves 4 bits
+  // per byte of the input in a 64-bit mask.
+  uint64_t mask = vget_lane_u64(
+      vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(special), 4)), 0);
+  if (mask == 0) return nullptr;
+  return p + Bits::CountTrailingZerosNonZero64(mask) / 4;
+}
+
+#endif
+
 /**
  * Return a pointer to the first byte in the range "[start..limit)"
  * whose value is 0 or 255 (kEscape1 or kEscape2).  If no such byte
@@ -134,6 +200,15 @@ inline static const char* SkipToNextSpecialByte(const char* start,
   static_assert(kEscape1 == 0, "bit fiddling needs readjusting");
   static_assert((kEscape2 & 0xff) == 255, "bit fiddling needs readjusting");
   const char* p = start;
+#if defined(FIRESTORE_ORDERED_CODE_AVX2) || \
+    defined(FIRESTORE_ORDERED_CODE_SSE2) || defined(FIRESTORE_ORDERED_CODE_NEON)
+  while (limit - p >= kVectorSize) {
+    const char* special = FindSpecialByteInVector(p);
+    if (special) return special;
+    p += kVectorSize;
+  }
+#endif
+  // Scan what's left 8 bytes at a time.
   while (p + 8 <= limit) {
     // Find out if any of the next 8 bytes are either 0 or 255 (our
     // two characters that require special handling).  We do this using
@@ -204,18 +279,11 @@ inline static void EncodeStringFragment(std::string* dest,
     if (p >= limit) break;  // No more special characters that need escaping
     char c = *(p++);
     HARD_ASSERT(IsSpecialByte(c));
-    if (c == kEscape1) {
-      AppendBytes(dest, copy_start, static_cast<size_t>(p - copy_start) - 1);
-      dest->push_back(kEscape1);
-      dest->push_back(kNullCharacter);
-      copy_start = p;
-    } else {
-      HARD_ASSERT(c == kEscape2);
-      AppendBytes(dest, copy_start, static_cast<size_t>(p - copy_start) - 1);
-      dest->push_back(kEscape2);
-      dest->push_back(kFFCharacter);
-      copy_start = p;
-    }
+    // The escape sequences for both special bytes start with the byte itself,
+    // so it's copied along with the run of bytes before it.
+    AppendBytes(dest, copy_start, static_cast<size_t>(p - copy_start));
+    dest->push_back(c == kEscape1 ? kNullCharacter : kFFCharacter);
+    copy_start = p;
   }
   if (p > copy_start) {
     AppendBytes(dest, copy_start, static_cast<size_t>(p - copy_start));
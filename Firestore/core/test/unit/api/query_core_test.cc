@@ -0,0 +1,90 @@
+/*
+ * Copyright 2021 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Firestore/core/src/api/query_core.h"
+
+#include <stdexcept>
+#include <vector>
+
+#include "Firestore/core/src/core/bound.h"
+#include "Firestore/core/src/core/field_filter.h"
+#include "Firestore/core/src/core/order_by.h"
+#include "Firestore/core/src/core/query.h"
+#include "Firestore/core/src/util/statusor.h"
+#include "Firestore/core/test/unit/testutil/testutil.h"
+#include "gtest/gtest.h"
+
+namespace firebase {
+namespace firestore {
+namespace api {
+namespace {
+
+using testutil::CollectionGroupQuery;
+using util::StatusOr;
+
+/**
+ * Calls `GetPartitions` on `query`. Only queries that fail validation may be
+ * passed, since there is no client to run the others.
+ */
+void GetPartitions(const core::Query& query, int64_t partition_count) {
+  Query{query, nullptr}.GetPartitions(
+      partition_count, [](const StatusOr<std::vector<Query>>&) {
+        FAIL() << "Invalid queries are not partitioned";
+      });
+}
+
+TEST(QueryTest, GetPartitionsRejectsNonPositiveCounts) {
+  EXPECT_THROW(GetPartitions(CollectionGroupQuery("coll"), 0),
+               std::invalid_argument);
+  EXPECT_THROW(GetPartitions(CollectionGroupQuery("coll"), -1),
+               std::invalid_argument);
+}
+
+TEST(QueryTest, GetPartitionsRejectsCollectionQueries) {
+  EXPECT_THROW(GetPartitions(testutil::Query("coll"), 2),
+               std::invalid_argument);
+}
+
+TEST(QueryTest, GetPartitionsRejectsFiltersLimitsAndCursors) {
+  core::Query query = CollectionGroupQuery("coll");
+
+  EXPECT_THROW(
+      GetPartitions(query.AddingFilter(testutil::Filter("a", "==", 1)), 2),
+      std::invalid_argument);
+  EXPECT_THROW(GetPartitions(query.WithLimitToFirst(10), 2),
+               std::invalid_argument);
+
+  core::Bound start = core::Bound::FromValue(
+      testutil::Array(testutil::Ref("p/d", "coll/a")), /*is_before=*/true);
+  EXPECT_THROW(GetPartitions(query.StartingAt(start), 2),
+               std::invalid_argument);
+}
+
+TEST(QueryTest, GetPartitionsRejectsOrdersOtherThanAscendingByKey) {
+  core::Query query = CollectionGroupQuery("coll");
+
+  EXPECT_THROW(GetPartitions(query.AddingOrderBy(testutil::OrderBy("a")), 2),
+               std::invalid_argument);
+  EXPECT_THROW(GetPartitions(query.AddingOrderBy(
+                                 testutil::OrderBy("__name__", "desc")),
+                             2),
+               std::invalid_argument);
+}
+
+}  // namespace
+}  // namespace api
+}  // namespace firestore
+}  // namespace firebase
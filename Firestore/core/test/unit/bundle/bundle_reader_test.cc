@@ -16,6 +16,7 @@
 
 #include "Firestore/core/src/bundle/bundle_reader.h"
 
+#include <cstdint>
 #include <memory>
 #include <sstream>
 #include <string>
@@ -25,6 +26,7 @@
 #include "Firestore/Protos/cpp/firestore/bundle.pb.h"
 #include "Firestore/Protos/cpp/firestore/local/maybe_document.pb.h"
 #include "Firestore/Protos/cpp/google/firestore/v1/document.pb.h"
+#include "Firestore/core/src/bundle/indexed_bundle.h"
 #include "Firestore/core/src/bundle/named_query.h"
 #include "Firestore/core/src/core/field_filter.h"
 #include "Firestore/core/src/local/local_serializer.h"
@@ -78,6 +80,7 @@ class BundleReaderTest : public ::testing::Test {
     *element.mutable_named_query() = data;
     MessageToJsonString(element, &json);
     elements_.push_back(json);
+    binary_elements_.push_back(element);
     return json;
   }
 
@@ -87,6 +90,7 @@ class BundleReaderTest : public ::testing::Test {
     *element.mutable_document_metadata() = data;
     MessageToJsonString(element, &json);
     elements_.push_back(json);
+    binary_elements_.push_back(element);
     return json;
   }
 
@@ -96,6 +100,7 @@ class BundleReaderTest : public ::testing::Test {
     *element.mutable_document() = data;
     MessageToJsonString(element, &json);
     elements_.push_back(json);
+    binary_elements_.push_back(element);
     return json;
   }
 
@@ -109,6 +114,66 @@ class BundleReaderTest : public ::testing::Test {
       bundle.append(element);
     }
 
+    ProtoBundleElement element =
+        MetadataElement(bundle_id, create_time, documents, bundle.size());
+
+    std::string metadata_str;
+    MessageToJsonString(element, &metadata_str);
+
+    return std::to_string(metadata_str.size()) + metadata_str + bundle;
+  }
+
+  /**
+   * Builds a binary bundle of the added elements, with a footer that indexes
+   * the named queries and document metadata.
+   */
+  std::string BuildBinaryBundle(const std::string& bundle_id,
+                                model::SnapshotVersion create_time,
+                                int32_t documents) {
+    // Offsets are relative to the end of the metadata until it is encoded.
+    std::string elements;
+    std::vector<std::pair<std::string, size_t>> query_offsets;
+    std::vector<size_t> document_offsets;
+    for (const auto& element : binary_elements_) {
+      if (element.has_named_query()) {
+        query_offsets.emplace_back(element.named_query().name(),
+                                   elements.size());
+      } else if (element.has_document_metadata()) {
+        document_offsets.push_back(elements.size());
+      }
+      AppendElement(&elements, element);
+    }
+
+    std::string bundle = kBinaryBundleMagic;
+    AppendElement(&bundle, MetadataElement(bundle_id, create_time, documents,
+                                           elements.size()));
+    size_t elements_start = bundle.size();
+    bundle.append(elements);
+    AppendVarint(&bundle, 0);
+
+    uint64_t footer_offset = bundle.size();
+    AppendVarint(&bundle, query_offsets.size());
+    for (const auto& query : query_offsets) {
+      AppendVarint(&bundle, query.first.size());
+      bundle.append(query.first);
+      AppendVarint(&bundle, elements_start + query.second);
+    }
+    AppendVarint(&bundle, document_offsets.size());
+    for (size_t offset : document_offsets) {
+      AppendVarint(&bundle, elements_start + offset);
+    }
+
+    for (size_t i = 0; i < sizeof(uint64_t); ++i) {
+      bundle.push_back(static_cast<char>((footer_offset >> (8 * i)) & 0xFF));
+    }
+    bundle.append(kBinaryBundleMagic);
+    return bundle;
+  }
+
+  static ProtoBundleElement MetadataElement(const std::string& bundle_id,
+                                            model::SnapshotVersion create_time,
+                                            int32_t documents,
+                                            uint64_t total_bytes) {
     ProtoBundleMetadata metadata;
     metadata.set_id(bundle_id);
     metadata.set_version(1);
@@ -117,14 +182,25 @@ class BundleReaderTest : public ::testing::Test {
         create_time.timestamp().nanoseconds());
     metadata.mutable_create_time()->set_seconds(
         create_time.timestamp().seconds());
-    metadata.set_total_bytes(bundle.size());
+    metadata.set_total_bytes(total_bytes);
     ProtoBundleElement element;
     *element.mutable_metadata() = metadata;
+    return element;
+  }
 
-    std::string metadata_str;
-    MessageToJsonString(element, &metadata_str);
+  static void AppendVarint(std::string* out, uint64_t value) {
+    while (value >= 0x80) {
+      out->push_back(static_cast<char>((value & 0x7F) | 0x80));
+      value >>= 7;
+    }
+    out->push_back(static_cast<char>(value));
+  }
 
-    return std::to_string(metadata_str.size()) + metadata_str + bundle;
+  static void AppendElement(std::string* out,
+                            const ProtoBundleElement& element) {
+    std::string bytes = element.SerializeAsString();
+    AppendVarint(out, bytes.size());
+    out->append(bytes);
   }
 
   std::unique_ptr<util::ByteStream> ToByteStream(const std::string& bundle) {
@@ -324,6 +400,7 @@ class BundleReaderTest : public ::testing::Test {
 
  private:
   std::vector<std::string> elements_;
+  std::vector<ProtoBundleElement> binary_elements_;
 };
 
 TEST_F(BundleReaderTest, ReadsQueryAndDocument) {
@@ -549,6 +626,124 @@ TEST_F(BundleReaderTest, FailsWhenBundleIsSomehowCorrupted) {
   }
 }
 
+TEST_F(BundleReaderTest, ReadsBinaryBundle) {
+  AddNamedQuery(LimitQuery());
+  AddDocumentMetadata(DocumentMetadata1());
+  AddDocument(Document1());
+  AddDocumentMetadata(DeletedDocumentMetadata());
+
+  const auto& bundle =
+      BuildBinaryBundle("bundle-1", testutil::Version(6000004000), 2);
+  BundleReader reader(bundle_serializer, ToByteStream(bundle));
+
+  std::vector<std::unique_ptr<BundleElement>> elements =
+      VerifyFullBundleParsed(reader, "bundle-1", testutil::Version(6000004000));
+
+  EXPECT_OK(reader.reader_status());
+  ASSERT_EQ(elements.size(), 4);
+  VerifyNamedQueryEncodesToOriginal(
+      *static_cast<NamedQuery*>(elements[0].get()), LimitQuery());
+  VerifyDocumentMetadataEquals(
+      *static_cast<BundledDocumentMetadata*>(elements[1].get()),
+      DocumentMetadata1());
+  VerifyDocumentEncodesToOriginal(
+      *static_cast<BundleDocument*>(elements[2].get()), Document1());
+  VerifyDocumentMetadataEquals(
+      *static_cast<BundledDocumentMetadata*>(elements[3].get()),
+      DeletedDocumentMetadata());
+}
+
+TEST_F(BundleReaderTest, FailsWhenBinaryBundleIsTruncated) {
+  AddDocumentMetadata(DocumentMetadata1());
+  AddDocument(Document1());
+
+  const auto& bundle =
+      BuildBinaryBundle("bundle-1", testutil::Version(6000004000), 1);
+  BundleReader reader(bundle_serializer,
+                      ToByteStream(bundle.substr(0, bundle.size() / 2)));
+
+  while (reader.GetNextElement() != nullptr) {
+  }
+  EXPECT_NOT_OK(reader.reader_status());
+}
+
+TEST_F(BundleReaderTest, IndexedBundleReadsElementsByIndex) {
+  AddNamedQuery(LimitQuery());
+  AddDocumentMetadata(DocumentMetadata1());
+  AddDocument(Document1());
+  AddNamedQuery(LimitToLastQuery());
+  AddDocumentMetadata(DeletedDocumentMetadata());
+  AddDocumentMetadata(DocumentMetadata2());
+  AddDocument(Document2());
+
+  const auto& bundle =
+      BuildBinaryBundle("bundle-1", testutil::Version(6000004000), 3);
+  auto maybe_indexed = IndexedBundle::Open(bundle_serializer, bundle);
+  ASSERT_OK(maybe_indexed.status());
+  const IndexedBundle& indexed = maybe_indexed.ValueOrDie();
+
+  auto metadata = indexed.GetBundleMetadata();
+  ASSERT_OK(metadata.status());
+  EXPECT_EQ(metadata.ValueOrDie().bundle_id(), "bundle-1");
+  EXPECT_EQ(metadata.ValueOrDie().create_time(),
+            testutil::Version(6000004000));
+
+  auto query = indexed.GetNamedQuery("limitToLastQuery");
+  ASSERT_OK(query.status());
+  VerifyNamedQueryEncodesToOriginal(query.ValueOrDie(), LimitToLastQuery());
+  EXPECT_EQ(indexed.GetNamedQuery("unknown").status().code(),
+            Error::kErrorNotFound);
+
+  ASSERT_EQ(indexed.document_count(), 3);
+
+  // Documents can be read in any order.
+  auto document = indexed.GetDocument(2);
+  ASSERT_OK(document.status());
+  VerifyDocumentEncodesToOriginal(document.ValueOrDie(), Document2());
+  document = indexed.GetDocument(0);
+  ASSERT_OK(document.status());
+  VerifyDocumentEncodesToOriginal(document.ValueOrDie(), Document1());
+
+  auto deleted = indexed.GetDocumentMetadata(1);
+  ASSERT_OK(deleted.status());
+  VerifyDocumentMetadataEquals(deleted.ValueOrDie(), DeletedDocumentMetadata());
+  EXPECT_EQ(indexed.GetDocument(1).status().code(), Error::kErrorNotFound);
+}
+
+TEST_F(BundleReaderTest, IndexedBundleRejectsDocumentsThatDontMatchMetadata) {
+  AddDocumentMetadata(DocumentMetadata1());
+  AddDocument(Document2());
+
+  const auto& bundle =
+      BuildBinaryBundle("bundle-1", testutil::Version(6000004000), 1);
+  auto maybe_indexed = IndexedBundle::Open(bundle_serializer, bundle);
+  ASSERT_OK(maybe_indexed.status());
+
+  EXPECT_EQ(maybe_indexed.ValueOrDie().GetDocument(0).status().code(),
+            Error::kErrorDataLoss);
+}
+
+TEST_F(BundleReaderTest, IndexedBundleRejectsJsonBundle) {
+  const auto& bundle =
+      BuildBundle("bundle-1", testutil::Version(6000004000), 0);
+
+  auto indexed = IndexedBundle::Open(bundle_serializer, bundle);
+  EXPECT_EQ(indexed.status().code(), Error::kErrorInvalidArgument);
+}
+
+TEST_F(BundleReaderTest, IndexedBundleRejectsCorruptFooter) {
+  AddDocumentMetadata(DocumentMetadata1());
+  AddDocument(Document1());
+
+  std::string bundle =
+      BuildBinaryBundle("bundle-1", testutil::Version(6000004000), 1);
+  // Point the trailer far past the end of the bundle.
+  bundle[bundle.size() - sizeof(kBinaryBundleMagic)] = '\x7f';
+
+  auto indexed = IndexedBundle::Open(bundle_serializer, bundle);
+  EXPECT_EQ(indexed.status().code(), Error::kErrorDataLoss);
+}
+
 }  //  namespace
 }  //  namespace bundle
 }  //  namespace firestore
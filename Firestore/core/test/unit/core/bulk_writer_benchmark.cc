@@ -0,0 +1,206 @@
+/*
+ * Copyright 2021 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Measures the write throughput of `BulkWriter` against a loopback gRPC server
+// that answers every Commit call after a fixed delay, standing in for the
+// round trip to the backend. Commits go through a real `Datastore`, so the
+// numbers include serialization and the gRPC transport.
+
+#include <chrono>  // NOLINT(build/c++11)
+#include <cstdint>
+#include <future>  // NOLINT(build/c++11)
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Firestore/Protos/nanopb/google/firestore/v1/firestore.nanopb.h"
+#include "Firestore/core/src/core/bulk_writer.h"
+#include "Firestore/core/src/core/database_info.h"
+#include "Firestore/core/src/credentials/empty_credentials_provider.h"
+#include "Firestore/core/src/model/database_id.h"
+#include "Firestore/core/src/model/set_mutation.h"
+#include "Firestore/core/src/nanopb/message.h"
+#include "Firestore/core/src/remote/connectivity_monitor.h"
+#include "Firestore/core/src/remote/datastore.h"
+#include "Firestore/core/src/remote/firebase_metadata_provider.h"
+#include "Firestore/core/src/remote/firebase_metadata_provider_noop.h"
+#include "Firestore/core/src/remote/grpc_nanopb.h"
+#include "Firestore/core/src/util/async_queue.h"
+#include "Firestore/core/src/util/status.h"
+#include "Firestore/core/test/unit/remote/create_noop_connectivity_monitor.h"
+#include "Firestore/core/test/unit/remote/loopback_server.h"
+#include "Firestore/core/test/unit/testutil/async_testing.h"
+#include "Firestore/core/test/unit/testutil/testutil.h"
+#include "absl/memory/memory.h"
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+namespace firebase {
+namespace firestore {
+namespace core {
+namespace {
+
+using credentials::EmptyAppCheckCredentialsProvider;
+using credentials::EmptyAuthCredentialsProvider;
+using model::DatabaseId;
+using model::Mutation;
+using nanopb::Message;
+using remote::ConnectivityMonitor;
+using remote::Datastore;
+using remote::FirebaseMetadataProvider;
+using remote::LoopbackServer;
+using util::AsyncQueue;
+using util::Status;
+
+/** The number of writes made in each iteration. */
+const int kWritesPerIteration = 2000;
+
+/** How long the server takes to answer each Commit call. */
+const std::chrono::milliseconds kServerLatency{10};
+
+/**
+ * Returns a loopback server that answers every call with an empty
+ * `CommitResponse` once `kServerLatency` has passed.
+ */
+std::unique_ptr<LoopbackServer> MakeCommitServer() {
+  Message<google_firestore_v1_CommitResponse> response;
+
+  LoopbackServer::Options options;
+  options.responses.push_back(remote::MakeByteBuffer(response));
+  options.latency = kServerLatency;
+  return absl::make_unique<LoopbackServer>(std::move(options));
+}
+
+/** A `Datastore` connected to a `LoopbackServer`. */
+class LoopbackDatastore {
+ public:
+  explicit LoopbackDatastore(int port)
+      : worker_queue_{testutil::AsyncQueueForTesting()},
+        connectivity_monitor_{remote::CreateNoOpConnectivityMonitor()},
+        metadata_provider_{remote::CreateFirebaseMetadataProviderNoOp()} {
+    DatabaseInfo database_info{DatabaseId{"p", "d"}, "",
+                               absl::StrCat("127.0.0.1:", port),
+                               /* ssl_enabled= */ false};
+    datastore_ = std::make_shared<Datastore>(
+        database_info, worker_queue_,
+        std::make_shared<EmptyAuthCredentialsProvider>(),
+        std::make_shared<EmptyAppCheckCredentialsProvider>(),
+        connectivity_monitor_.get(), metadata_provider_.get());
+    datastore_->Start();
+  }
+
+  ~LoopbackDatastore() {
+    worker_queue_->EnqueueBlocking([&] { datastore_->Shutdown(); });
+  }
+
+  const std::shared_ptr<AsyncQueue>& worker_queue() const {
+    return worker_queue_;
+  }
+
+  BulkWriter::CommitFunction commit_function() const {
+    std::shared_ptr<Datastore> datastore = datastore_;
+    return [datastore](const std::vector<Mutation>& mutations,
+                       BulkWriter::CommitCallback&& callback) {
+      datastore->CommitMutations(mutations, std::move(callback));
+    };
+  }
+
+ private:
+  std::shared_ptr<AsyncQueue> worker_queue_;
+  std::unique_ptr<ConnectivityMonitor> connectivity_monitor_;
+  std::unique_ptr<FirebaseMetadataProvider> metadata_provider_;
+  std::shared_ptr<Datastore> datastore_;
+};
+
+std::vector<Mutation> MakeWrites() {
+  std::vector<Mutation> writes;
+  writes.reserve(kWritesPerIteration);
+  for (int i = 0; i < kWritesPerIteration; ++i) {
+    writes.push_back(testutil::SetMutation(
+        absl::StrCat("imports/doc", i),
+        testutil::Map("index", i, "name", absl::StrCat("Document ", i),
+                      "imported", true)));
+  }
+  return writes;
+}
+
+/**
+ * Writes all of `writes` through `bulk_writer` and waits for them. Returns the
+ * number of writes that failed.
+ */
+int WriteAll(const std::shared_ptr<AsyncQueue>& worker_queue,
+             const std::shared_ptr<BulkWriter>& bulk_writer,
+             const std::vector<Mutation>& writes) {
+  std::promise<void> flushed;
+  auto failures = std::make_shared<int>(0);
+  worker_queue->EnqueueBlocking([&] {
+    for (const Mutation& write : writes) {
+      bulk_writer->Write(write, [failures](const Status& status) {
+        if (!status.ok()) ++*failures;
+      });
+    }
+    bulk_writer->Flush([&](const Status&) { flushed.set_value(); });
+  });
+  flushed.get_future().wait();
+  return *failures;
+}
+
+static void BM_BulkWriteOverLoopback(benchmark::State& state) {
+  BulkWriterOptions options;
+  options.max_batch_size = static_cast<int>(state.range(0));
+  options.max_concurrent_batches = static_cast<int>(state.range(1));
+  options.rate_limiting_enabled = false;
+
+  std::unique_ptr<LoopbackServer> server = MakeCommitServer();
+  LoopbackDatastore datastore{server->port()};
+  auto bulk_writer = std::make_shared<BulkWriter>(
+      datastore.worker_queue(), datastore.commit_function(), options);
+  std::vector<Mutation> writes = MakeWrites();
+
+  // Warm up the connection so that the handshake isn't counted.
+  WriteAll(datastore.worker_queue(), bulk_writer, {writes.front()});
+  int64_t initial_commits = server->calls_answered();
+
+  int64_t failures = 0;
+  for (auto _ : state) {
+    failures += WriteAll(datastore.worker_queue(), bulk_writer, writes);
+  }
+
+  state.SetItemsProcessed(state.iterations() * kWritesPerIteration);
+  state.counters["commits"] = benchmark::Counter(
+      static_cast<double>(server->calls_answered() - initial_commits),
+      benchmark::Counter::kAvgIterations);
+  state.counters["failures"] = static_cast<double>(failures);
+}
+
+void BulkWriterArguments(benchmark::internal::Benchmark* benchmark) {
+  for (int batch_size : {1, 20, 100}) {
+    for (int concurrency : {1, 4, 16}) {
+      benchmark->Args({batch_size, concurrency});
+    }
+  }
+}
+BENCHMARK(BM_BulkWriteOverLoopback)
+    ->ArgNames({"batch_size", "concurrency"})
+    ->Apply(BulkWriterArguments)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace core
+}  // namespace firestore
+}  // namespace firebase
@@ -0,0 +1,246 @@
+/*
+ * Copyright 2021 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Firestore/core/src/core/bulk_writer.h"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Firestore/core/src/model/delete_mutation.h"
+#include "Firestore/core/src/model/mutation.h"
+#include "Firestore/core/src/util/async_queue.h"
+#include "Firestore/core/src/util/status.h"
+#include "Firestore/core/test/unit/testutil/async_testing.h"
+#include "Firestore/core/test/unit/testutil/testutil.h"
+#include "gtest/gtest.h"
+
+namespace firebase {
+namespace firestore {
+namespace core {
+
+namespace {
+
+using model::Mutation;
+using util::AsyncQueue;
+using util::Status;
+using util::TimerId;
+
+BulkWriterOptions UnlimitedOptions(int max_batch_size,
+                                   int max_concurrent_batches) {
+  BulkWriterOptions options;
+  options.max_batch_size = max_batch_size;
+  options.max_concurrent_batches = max_concurrent_batches;
+  options.rate_limiting_enabled = false;
+  return options;
+}
+
+Status Unavailable() {
+  return Status{Error::kErrorUnavailable, "Unavailable"};
+}
+
+Status InvalidArgument() {
+  return Status{Error::kErrorInvalidArgument, "Invalid argument"};
+}
+
+class BulkWriterTest : public testing::Test {
+ protected:
+  struct Commit {
+    std::vector<Mutation> mutations;
+    BulkWriter::CommitCallback callback;
+  };
+
+  ~BulkWriterTest() override {
+    // Ensure that nothing remains on the AsyncQueue before destroying it.
+    worker_queue_->EnqueueBlocking([] {});
+  }
+
+  void CreateWriter(const BulkWriterOptions& options) {
+    auto commit = [this](const std::vector<Mutation>& mutations,
+                         BulkWriter::CommitCallback&& callback) {
+      commits_.push_back(Commit{mutations, std::move(callback)});
+    };
+    writer_ = std::make_shared<BulkWriter>(worker_queue_, commit, options);
+  }
+
+  /** Deletes the document at `path`, and records the result under `path`. */
+  void Write(const std::string& path) {
+    worker_queue_->EnqueueBlocking([&] {
+      writer_->Write(testutil::DeleteMutation(path),
+                     [this, path](Status status) { results_[path] = status; });
+    });
+  }
+
+  void Flush() {
+    worker_queue_->EnqueueBlocking([&] {
+      writer_->Flush([this](Status) { ++flushes_; });
+    });
+  }
+
+  /** Responds to the commit with the given index. */
+  void Respond(size_t index, const Status& status) {
+    worker_queue_->EnqueueBlocking([&] {
+      BulkWriter::CommitCallback callback = std::move(commits_[index].callback);
+      callback(status);
+    });
+  }
+
+  /** Runs retries and rate limited sends without waiting for them. */
+  void RunDelayedOperations() {
+    worker_queue_->RunScheduledOperationsUntil(TimerId::All);
+  }
+
+  size_t CommitSize(size_t index) const {
+    return commits_[index].mutations.size();
+  }
+
+  std::shared_ptr<AsyncQueue> worker_queue_ = testutil::AsyncQueueForTesting();
+  std::shared_ptr<BulkWriter> writer_;
+
+  std::vector<Commit> commits_;
+  std::map<std::string, Status> results_;
+  int flushes_ = 0;
+};
+
+}  // namespace
+
+TEST_F(BulkWriterTest, SendsFullBatches) {
+  CreateWriter(UnlimitedOptions(3, 10));
+  for (int i = 0; i < 7; ++i) {
+    Write("docs/" + std::to_string(i));
+  }
+
+  ASSERT_EQ(commits_.size(), 2u);
+  EXPECT_EQ(CommitSize(0), 3u);
+  EXPECT_EQ(CommitSize(1), 3u);
+
+  Flush();
+  ASSERT_EQ(commits_.size(), 3u);
+  EXPECT_EQ(CommitSize(2), 1u);
+}
+
+TEST_F(BulkWriterTest, LimitsConcurrentBatches) {
+  CreateWriter(UnlimitedOptions(1, 2));
+  Write("docs/a");
+  Write("docs/b");
+  Write("docs/c");
+  ASSERT_EQ(commits_.size(), 2u);
+
+  Respond(0, Status::OK());
+  ASSERT_EQ(commits_.size(), 3u);
+  EXPECT_EQ(commits_[2].mutations[0].key(), testutil::Key("docs/c"));
+}
+
+TEST_F(BulkWriterTest, FlushWaitsForEarlierWrites) {
+  CreateWriter(UnlimitedOptions(2, 10));
+  Write("docs/a");
+  Flush();
+  ASSERT_EQ(commits_.size(), 1u);
+  EXPECT_EQ(flushes_, 0);
+
+  // Writes after the flush don't hold it up.
+  Write("docs/b");
+  Respond(0, Status::OK());
+  EXPECT_EQ(flushes_, 1);
+  EXPECT_TRUE(results_["docs/a"].ok());
+  EXPECT_EQ(results_.count("docs/b"), 0u);
+  EXPECT_EQ(writer_->pending_writes(), 1u);
+}
+
+TEST_F(BulkWriterTest, FlushWithoutWritesCompletes) {
+  CreateWriter(UnlimitedOptions(2, 10));
+  Flush();
+  EXPECT_EQ(flushes_, 1);
+  EXPECT_TRUE(commits_.empty());
+}
+
+TEST_F(BulkWriterTest, RetriesBatchOnTransientError) {
+  CreateWriter(UnlimitedOptions(2, 10));
+  Write("docs/a");
+  Write("docs/b");
+  ASSERT_EQ(commits_.size(), 1u);
+
+  Respond(0, Unavailable());
+  RunDelayedOperations();
+  ASSERT_EQ(commits_.size(), 2u);
+  EXPECT_EQ(CommitSize(1), 2u);
+  EXPECT_TRUE(results_.empty());
+
+  Respond(1, Status::OK());
+  EXPECT_TRUE(results_["docs/a"].ok());
+  EXPECT_TRUE(results_["docs/b"].ok());
+}
+
+TEST_F(BulkWriterTest, GivesUpAfterMaxAttempts) {
+  CreateWriter(UnlimitedOptions(1, 10));
+  Write("docs/a");
+
+  for (size_t i = 0; i < 10; ++i) {
+    ASSERT_EQ(commits_.size(), i + 1);
+    Respond(i, Unavailable());
+    RunDelayedOperations();
+  }
+
+  EXPECT_EQ(commits_.size(), 10u);
+  EXPECT_EQ(results_["docs/a"].code(), Error::kErrorUnavailable);
+}
+
+TEST_F(BulkWriterTest, RetriesWritesOfFailedBatchIndividually) {
+  CreateWriter(UnlimitedOptions(3, 10));
+  Write("docs/a");
+  Write("docs/b");
+  Write("docs/c");
+  ASSERT_EQ(commits_.size(), 1u);
+
+  Respond(0, InvalidArgument());
+  ASSERT_EQ(commits_.size(), 4u);
+  for (size_t i = 1; i < 4; ++i) {
+    EXPECT_EQ(CommitSize(i), 1u);
+  }
+  EXPECT_EQ(commits_[1].mutations[0].key(), testutil::Key("docs/a"));
+  EXPECT_EQ(commits_[3].mutations[0].key(), testutil::Key("docs/c"));
+
+  Respond(1, Status::OK());
+  Respond(2, InvalidArgument());
+  Respond(3, Status::OK());
+
+  EXPECT_EQ(commits_.size(), 4u);
+  EXPECT_TRUE(results_["docs/a"].ok());
+  EXPECT_EQ(results_["docs/b"].code(), Error::kErrorInvalidArgument);
+  EXPECT_TRUE(results_["docs/c"].ok());
+  EXPECT_EQ(writer_->pending_writes(), 0u);
+}
+
+TEST_F(BulkWriterTest, WaitsForRateLimiter) {
+  BulkWriterOptions options = UnlimitedOptions(5, 10);
+  options.rate_limiting_enabled = true;
+  options.initial_writes_per_second = 10;
+  CreateWriter(options);
+
+  for (int i = 0; i < 15; ++i) {
+    Write("docs/" + std::to_string(i));
+  }
+
+  // The first second's worth of writes goes out at once.
+  EXPECT_EQ(commits_.size(), 2u);
+  EXPECT_TRUE(worker_queue_->IsScheduled(TimerId::BulkWriterRateLimit));
+}
+
+}  // namespace core
+}  // namespace firestore
+}  // namespace firebase
@@ -0,0 +1,638 @@
+/*
+ * Copyright 2021 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Firestore/core/src/core/firestore_client.h"
+
+#include <functional>
+#include <future>  // NOLINT(build/c++11)
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Firestore/Protos/nanopb/google/firestore/v1/firestore.nanopb.h"
+#include "Firestore/core/src/api/document_reference.h"
+#include "Firestore/core/src/api/document_snapshot.h"
+#include "Firestore/core/src/api/query_core.h"
+#include "Firestore/core/src/api/query_snapshot.h"
+#include "Firestore/core/src/api/settings.h"
+#include "Firestore/core/src/api/source.h"
+#include "Firestore/core/src/core/bound.h"
+#include "Firestore/core/src/core/database_info.h"
+#include "Firestore/core/src/core/event_listener.h"
+#include "Firestore/core/src/core/query.h"
+#include "Firestore/core/src/credentials/user.h"
+#include "Firestore/core/src/local/leveldb_persistence.h"
+#include "Firestore/core/src/model/database_id.h"
+#include "Firestore/core/src/model/mutation.h"
+#include "Firestore/core/src/model/object_value.h"
+#include "Firestore/core/src/model/set_mutation.h"
+#include "Firestore/core/src/model/value_util.h"
+#include "Firestore/core/src/nanopb/message.h"
+#include "Firestore/core/src/nanopb/nanopb_util.h"
+#include "Firestore/core/src/remote/firebase_metadata_provider_noop.h"
+#include "Firestore/core/src/remote/grpc_nanopb.h"
+#include "Firestore/core/src/remote/serializer.h"
+#include "Firestore/core/src/util/async_queue.h"
+#include "Firestore/core/src/util/executor.h"
+#include "Firestore/core/src/util/filesystem.h"
+#include "Firestore/core/src/util/path.h"
+#include "Firestore/core/src/util/status.h"
+#include "Firestore/core/src/util/statusor.h"
+#include "Firestore/core/test/unit/remote/fake_credentials_provider.h"
+#include "Firestore/core/test/unit/remote/loopback_server.h"
+#include "Firestore/core/test/unit/testutil/async_testing.h"
+#include "Firestore/core/test/unit/testutil/testutil.h"
+#include "absl/memory/memory.h"
+#include "absl/strings/str_cat.h"
+#include "absl/types/optional.h"
+#include "grpcpp/grpcpp.h"
+#include "gtest/gtest.h"
+
+namespace firebase {
+namespace firestore {
+namespace core {
+namespace {
+
+using api::DocumentReference;
+using api::DocumentSnapshot;
+using api::QuerySnapshot;
+using api::Source;
+using credentials::AuthToken;
+using credentials::User;
+using local::LevelDbPersistence;
+using model::DatabaseId;
+using model::Mutation;
+using nanopb::Message;
+using remote::CreateFirebaseMetadataProviderNoOp;
+using remote::FakeCredentialsProvider;
+using remote::LoopbackServer;
+using remote::Serializer;
+using testutil::Expectation;
+using testutil::Map;
+using util::AsyncQueue;
+using util::Executor;
+using util::Filesystem;
+using util::Path;
+using util::Status;
+using util::StatusOr;
+
+/** A page of results: the IDs of its documents and whether more follow. */
+struct Page {
+  std::vector<std::string> ids;
+  bool has_more = false;
+};
+
+Page ToPage(const QuerySnapshot& snapshot, bool has_more) {
+  Page page;
+  snapshot.ForEachDocument([&](const DocumentSnapshot& doc) {
+    page.ids.push_back(doc.document_id());
+  });
+  page.has_more = has_more;
+  return page;
+}
+
+std::string DocId(int i) {
+  return absl::StrCat(i < 10 ? "doc0" : "doc", i);
+}
+
+std::vector<std::string> DocIds(
+    const std::vector<DocumentSnapshot>& snapshots) {
+  std::vector<std::string> result;
+  for (const DocumentSnapshot& snapshot : snapshots) {
+    result.push_back(snapshot.document_id());
+  }
+  return result;
+}
+
+/** A BatchGetDocuments response that finds the document at `path`. */
+grpc::ByteBuffer FoundDocument(const std::string& path) {
+  Serializer serializer{DatabaseId{"p", "d"}};
+  Message<google_firestore_v1_BatchGetDocumentsResponse> response;
+  response->which_result =
+      google_firestore_v1_BatchGetDocumentsResponse_found_tag;
+  response->found = serializer.EncodeDocument(
+      testutil::Key(path), model::ObjectValue{Map("v", 1)});
+  response->found.has_update_time = true;
+  response->found.update_time =
+      Serializer::EncodeVersion(testutil::Version(1000));
+  return remote::MakeByteBuffer(response);
+}
+
+/** The bound of a partition at the document at `path`. */
+Bound PartitionPoint(const std::string& path) {
+  auto position = testutil::Array(
+      model::RefValue(DatabaseId{"p", "d"}, testutil::Key(path)));
+  return Bound::FromValue(std::move(position), /*is_before=*/true);
+}
+
+/** A PartitionQuery response with a partition point at each of `paths`. */
+grpc::ByteBuffer PartitionPoints(const std::vector<std::string>& paths) {
+  Serializer serializer{DatabaseId{"p", "d"}};
+  Message<google_firestore_v1_PartitionQueryResponse> response;
+  response->partitions_count = nanopb::CheckedSize(paths.size());
+  response->partitions = nanopb::MakeArray<google_firestore_v1_Cursor>(
+      response->partitions_count);
+  for (pb_size_t i = 0; i < response->partitions_count; ++i) {
+    response->partitions[i] = serializer.EncodeBound(PartitionPoint(paths[i]));
+  }
+  return remote::MakeByteBuffer(response);
+}
+
+}  // namespace
+
+class FirestoreClientTest : public testing::Test, public testutil::AsyncTest {
+ public:
+  FirestoreClientTest() : FirestoreClientTest(/*persistence_enabled=*/false) {
+  }
+
+ protected:
+  explicit FirestoreClientTest(bool persistence_enabled)
+      : worker_queue{testutil::AsyncQueueForTesting()},
+        user_executor{Executor::CreateSerial("FirestoreClientTest")},
+        persistence_enabled_{persistence_enabled} {
+  }
+
+  void SetUp() override {
+    StartClient("localhost");
+
+    // Writes stay pending in the cache rather than going to the backend.
+    Expectation disabled;
+    auto done = disabled.AsCallback();
+    client->DisableNetwork([done](const Status&) { done(); });
+    Await(disabled);
+  }
+
+  /** Starts `client` with a backend at `host`, which is reached without SSL. */
+  void StartClient(const std::string& host) {
+    DatabaseInfo database_info{DatabaseId{"p", "d"}, "FirestoreClientTest",
+                               host, /*ssl_enabled=*/false};
+    api::Settings settings;
+    settings.set_persistence_enabled(persistence_enabled_);
+    if (persistence_enabled_) {
+      EXPECT_TRUE(LevelDbPersistence::ClearPersistence(database_info).ok());
+    }
+
+    client = FirestoreClient::Create(
+        database_info, settings,
+        std::make_shared<FakeCredentialsProvider<AuthToken, User>>(),
+        std::make_shared<FakeCredentialsProvider<std::string, std::string>>(),
+        user_executor, worker_queue, CreateFirebaseMetadataProviderNoOp());
+  }
+
+  /** Writes documents "coll/doc00" to "coll/doc<count - 1>" to the cache. */
+  void WriteDocuments(int count) {
+    std::vector<Mutation> mutations;
+    for (int i = 0; i < count; ++i) {
+      mutations.push_back(
+          testutil::SetMutation("coll/" + DocId(i), Map("v", i)));
+    }
+    client->WriteMutations(std::move(mutations), [](const Status&) {});
+  }
+
+  /**
+   * Reads the results of `query` from the cache in pages of `page_size`,
+   * stopping after `max_pages` pages. Returns the pages read; an error ends
+   * the read and is stored in `error`.
+   */
+  std::vector<Page> ReadPages(const Query& query,
+                              size_t page_size,
+                              size_t max_pages = 100) {
+    auto pages = std::make_shared<std::vector<Page>>();
+    Expectation finished;
+    auto done = finished.AsCallback();
+    client->GetDocumentPagesFromLocalCache(
+        api::Query{query, nullptr}, page_size,
+        [this, pages, max_pages, done](StatusOr<QuerySnapshot> page,
+                                       bool has_more) {
+          if (!page.ok()) {
+            error = page.status();
+            done();
+            return false;
+          }
+          pages->push_back(ToPage(page.ValueOrDie(), has_more));
+          bool more = pages->size() < max_pages;
+          if (!more || !has_more) done();
+          return more;
+        });
+    Await(finished);
+
+    // Make sure that no further pages are read.
+    user_executor->ExecuteBlocking([] {});
+    worker_queue->EnqueueBlocking([] {});
+    user_executor->ExecuteBlocking([] {});
+    return *pages;
+  }
+
+  /**
+   * Executes `query` against the cache and returns the IDs of the results,
+   * once they have been delivered.
+   */
+  std::future<std::vector<std::string>> ReadQuery(const Query& query) {
+    auto result = std::make_shared<std::promise<std::vector<std::string>>>();
+    client->GetDocumentsFromLocalCache(
+        api::Query{query, nullptr},
+        EventListener<QuerySnapshot>::Create(
+            [result](const StatusOr<QuerySnapshot>& snapshot) {
+              EXPECT_TRUE(snapshot.ok());
+              result->set_value(ToPage(snapshot.ValueOrDie(), false).ids);
+            }));
+    return result->get_future();
+  }
+
+  /** Gets the documents at `paths` with `GetAll` and returns the result. */
+  StatusOr<std::vector<DocumentSnapshot>> GetAll(
+      const std::vector<std::string>& paths, Source source) {
+    std::vector<DocumentReference> docs;
+    for (const std::string& path : paths) {
+      docs.emplace_back(testutil::Key(path), nullptr);
+    }
+
+    auto result = std::make_shared<StatusOr<std::vector<DocumentSnapshot>>>();
+    Expectation finished;
+    auto done = finished.AsCallback();
+    client->GetAll(
+        std::move(docs), source,
+        EventListener<std::vector<DocumentSnapshot>>::Create(
+            [result, done](StatusOr<std::vector<DocumentSnapshot>> snapshots) {
+              *result = std::move(snapshots);
+              done();
+            }));
+    Await(finished);
+    return *result;
+  }
+
+  /** Partitions `query` with `PartitionQuery` and returns the result. */
+  StatusOr<std::vector<api::Query>> GetPartitions(const Query& query,
+                                                  int64_t partition_count) {
+    auto result = std::make_shared<StatusOr<std::vector<api::Query>>>();
+    Expectation finished;
+    auto done = finished.AsCallback();
+    client->PartitionQuery(
+        api::Query{query, nullptr}, partition_count,
+        [result, done](StatusOr<std::vector<api::Query>> partitions) {
+          *result = std::move(partitions);
+          done();
+        });
+    Await(finished);
+    return *result;
+  }
+
+  /** Runs `operation` and returns the status it passes to its callback. */
+  Status AwaitStatus(
+      const std::function<void(util::StatusCallback)>& operation) {
+    auto result = std::make_shared<Status>();
+    Expectation finished;
+    auto done = finished.AsCallback();
+    operation([result, done](const Status& status) {
+      *result = status;
+      done();
+    });
+    Await(finished);
+    return *result;
+  }
+
+  /**
+   * Keeps the worker queue busy until `UnblockWorkerQueue` is called, like a
+   * long remote event would.
+   */
+  void BlockWorkerQueue() {
+    std::shared_future<void> unblocked = unblock_.get_future().share();
+    worker_queue->Enqueue([unblocked] { unblocked.wait(); });
+  }
+
+  void UnblockWorkerQueue() {
+    unblock_.set_value();
+  }
+
+  std::shared_ptr<AsyncQueue> worker_queue;
+  std::shared_ptr<Executor> user_executor;
+  std::shared_ptr<FirestoreClient> client;
+  absl::optional<Status> error;
+
+ private:
+  bool persistence_enabled_ = false;
+  std::promise<void> unblock_;
+};
+
+/** Runs its tests with LevelDB persistence, which supports `LocalReader`. */
+class FirestoreClientWithPersistenceTest : public FirestoreClientTest {
+ public:
+  FirestoreClientWithPersistenceTest()
+      : FirestoreClientTest(/*persistence_enabled=*/true) {
+  }
+};
+
+/**
+ * Runs its tests with the network enabled. Each test starts the client itself,
+ * usually against a `LoopbackServer` that answers its calls.
+ */
+class FirestoreClientOnlineTest : public FirestoreClientTest {
+ public:
+  void SetUp() override {
+  }
+
+  /** Starts a server that answers every call with `responses`. */
+  void StartServer(std::vector<grpc::ByteBuffer> responses) {
+    LoopbackServer::Options options;
+    options.responses = std::move(responses);
+    server_ = absl::make_unique<LoopbackServer>(std::move(options));
+    StartClient(absl::StrCat("127.0.0.1:", server_->port()));
+  }
+
+  /** Starts the client against a port that nothing listens on. */
+  void StartOfflineClient() {
+    StartClient("127.0.0.1:1");
+  }
+
+ private:
+  std::unique_ptr<LoopbackServer> server_;
+};
+
+TEST_F(FirestoreClientTest, ReadsCachedPagesInKeyOrder) {
+  WriteDocuments(5);
+
+  std::vector<Page> pages = ReadPages(testutil::Query("coll"), 2);
+
+  ASSERT_EQ(pages.size(), 3u);
+  EXPECT_EQ(pages[0].ids, (std::vector<std::string>{"doc00", "doc01"}));
+  EXPECT_TRUE(pages[0].has_more);
+  EXPECT_EQ(pages[1].ids, (std::vector<std::string>{"doc02", "doc03"}));
+  EXPECT_TRUE(pages[1].has_more);
+  EXPECT_EQ(pages[2].ids, (std::vector<std::string>{"doc04"}));
+  EXPECT_FALSE(pages[2].has_more);
+  EXPECT_FALSE(error);
+}
+
+TEST_F(FirestoreClientTest, ShortensTheLastCachedPageToTheLimit) {
+  WriteDocuments(10);
+
+  std::vector<Page> pages =
+      ReadPages(testutil::Query("coll").WithLimitToFirst(5), 2);
+
+  ASSERT_EQ(pages.size(), 3u);
+  EXPECT_EQ(pages[1].ids, (std::vector<std::string>{"doc02", "doc03"}));
+  EXPECT_EQ(pages[2].ids, (std::vector<std::string>{"doc04"}));
+  EXPECT_FALSE(pages[2].has_more);
+}
+
+TEST_F(FirestoreClientTest, EndsCachedPagesAtTheLimit) {
+  WriteDocuments(10);
+
+  // The limit falls on a page boundary, so the last page is full but nothing
+  // follows it although the cache holds more documents.
+  std::vector<Page> pages =
+      ReadPages(testutil::Query("coll").WithLimitToFirst(4), 2);
+
+  ASSERT_EQ(pages.size(), 2u);
+  EXPECT_EQ(pages[1].ids, (std::vector<std::string>{"doc02", "doc03"}));
+  EXPECT_FALSE(pages[1].has_more);
+}
+
+TEST_F(FirestoreClientTest, ReadsCachedPagesInQueryOrder) {
+  WriteDocuments(5);
+
+  // Not in key order, so the results are sliced into pages.
+  Query query =
+      testutil::Query("coll").AddingOrderBy(testutil::OrderBy("v", "desc"));
+  std::vector<Page> pages = ReadPages(query, 2);
+
+  ASSERT_EQ(pages.size(), 3u);
+  EXPECT_EQ(pages[0].ids, (std::vector<std::string>{"doc04", "doc03"}));
+  EXPECT_EQ(pages[1].ids, (std::vector<std::string>{"doc02", "doc01"}));
+  EXPECT_EQ(pages[2].ids, (std::vector<std::string>{"doc00"}));
+  EXPECT_FALSE(pages[2].has_more);
+}
+
+TEST_F(FirestoreClientTest, StopsReadingCachedPagesWhenTheListenerDeclines) {
+  WriteDocuments(5);
+
+  std::vector<Page> pages =
+      ReadPages(testutil::Query("coll"), 2, /*max_pages=*/1);
+
+  ASSERT_EQ(pages.size(), 1u);
+  EXPECT_TRUE(pages[0].has_more);
+  EXPECT_FALSE(error);
+}
+
+TEST_F(FirestoreClientTest, FailsToReadCachedPagesAfterTermination) {
+  WriteDocuments(5);
+
+  auto page_count = std::make_shared<int>(0);
+  Expectation finished;
+  auto done = finished.AsCallback();
+  client->GetDocumentPagesFromLocalCache(
+      api::Query{testutil::Query("coll"), nullptr}, 2,
+      [this, page_count, done](StatusOr<QuerySnapshot> page, bool) {
+        if (!page.ok()) {
+          error = page.status();
+          done();
+          return false;
+        }
+        // Terminating turns away the read of the next page.
+        ++*page_count;
+        client->TerminateAsync(nullptr);
+        return true;
+      });
+  Await(finished);
+
+  EXPECT_EQ(*page_count, 1);
+  ASSERT_TRUE(error);
+  EXPECT_EQ(error->code(), Error::kErrorFailedPrecondition);
+}
+
+TEST_F(FirestoreClientWithPersistenceTest, ReadsWhileTheWorkerQueueIsBusy) {
+  WriteDocuments(2);
+  worker_queue->EnqueueBlocking([] {});
+
+  BlockWorkerQueue();
+  std::future<std::vector<std::string>> ids =
+      ReadQuery(testutil::Query("coll"));
+  // Only a read on the reader pool can finish while the worker queue is busy.
+  bool finished = ids.wait_for(testutil::kTimeout) == std::future_status::ready;
+  UnblockWorkerQueue();
+
+  ASSERT_TRUE(finished);
+  EXPECT_EQ(ids.get(), (std::vector<std::string>{"doc00", "doc01"}));
+}
+
+TEST_F(FirestoreClientWithPersistenceTest, ReadsAfterPendingWritesAreApplied) {
+  BlockWorkerQueue();
+  WriteDocuments(2);
+  // With the write still waiting for the worker queue, a read on the reader
+  // pool would miss it, so the read waits for the worker queue, too.
+  std::future<std::vector<std::string>> ids =
+      ReadQuery(testutil::Query("coll"));
+  UnblockWorkerQueue();
+
+  ASSERT_EQ(ids.wait_for(testutil::kTimeout), std::future_status::ready);
+  EXPECT_EQ(ids.get(), (std::vector<std::string>{"doc00", "doc01"}));
+}
+
+TEST_F(FirestoreClientTest, FailsToImportCacheSnapshotWithoutPersistence) {
+  Path file = Filesystem::Default()->TempDir().AppendUtf8("cache_snapshot");
+  Status status = AwaitStatus([&](util::StatusCallback callback) {
+    client->ImportCacheSnapshot(file, std::move(callback));
+  });
+  EXPECT_EQ(status.code(), Error::kErrorFailedPrecondition);
+}
+
+TEST_F(FirestoreClientWithPersistenceTest, ImportsExportedCacheSnapshot) {
+  Path file = Filesystem::Default()->TempDir().AppendUtf8("cache_snapshot");
+  ASSERT_TRUE(AwaitStatus([&](util::StatusCallback callback) {
+                client->ExportCacheSnapshot(file, std::move(callback));
+              }).ok());
+  ASSERT_TRUE(AwaitStatus([&](util::StatusCallback callback) {
+                client->ImportCacheSnapshot(file, std::move(callback));
+              }).ok());
+
+  // The client keeps working on the imported cache.
+  WriteDocuments(1);
+  std::future<std::vector<std::string>> ids =
+      ReadQuery(testutil::Query("coll"));
+  ASSERT_EQ(ids.wait_for(testutil::kTimeout), std::future_status::ready);
+  EXPECT_EQ(ids.get(), (std::vector<std::string>{"doc00"}));
+
+  EXPECT_TRUE(Filesystem::Default()->RemoveFile(file).ok());
+}
+
+TEST_F(FirestoreClientWithPersistenceTest, FinishesReadsWhenTerminated) {
+  WriteDocuments(2);
+  worker_queue->EnqueueBlocking([] {});
+
+  std::vector<std::future<std::vector<std::string>>> reads;
+  for (int i = 0; i < 50; ++i) {
+    reads.push_back(ReadQuery(testutil::Query("coll")));
+  }
+  Expectation terminated;
+  auto done = terminated.AsCallback();
+  client->TerminateAsync([done](const Status&) { done(); });
+  Await(terminated);
+
+  // Reads that were scheduled before terminating aren't dropped.
+  for (auto& ids : reads) {
+    ASSERT_EQ(ids.wait_for(testutil::kTimeout), std::future_status::ready);
+    EXPECT_EQ(ids.get().size(), 2u);
+  }
+}
+
+TEST_F(FirestoreClientOnlineTest, ReturnsDocumentsInRequestOrder) {
+  // The server answers in an order of its own, and only once per document.
+  StartServer({FoundDocument("coll/b"), FoundDocument("coll/a")});
+
+  StatusOr<std::vector<DocumentSnapshot>> snapshots =
+      GetAll({"coll/b", "coll/a", "coll/b"}, Source::Server);
+
+  ASSERT_TRUE(snapshots.ok()) << snapshots.status().ToString();
+  EXPECT_EQ(DocIds(snapshots.ValueOrDie()),
+            (std::vector<std::string>{"b", "a", "b"}));
+  for (const DocumentSnapshot& snapshot : snapshots.ValueOrDie()) {
+    EXPECT_TRUE(snapshot.exists());
+    EXPECT_FALSE(snapshot.metadata().from_cache());
+  }
+}
+
+TEST_F(FirestoreClientOnlineTest, FailsWhenTheServerOmitsADocument) {
+  StartServer({FoundDocument("coll/a")});
+
+  StatusOr<std::vector<DocumentSnapshot>> snapshots =
+      GetAll({"coll/a", "coll/b"}, Source::Server);
+
+  EXPECT_EQ(snapshots.status().code(), Error::kErrorInternal);
+}
+
+TEST_F(FirestoreClientOnlineTest, FallsBackToTheCacheWhileOffline) {
+  StartOfflineClient();
+  WriteDocuments(1);
+
+  StatusOr<std::vector<DocumentSnapshot>> snapshots =
+      GetAll({"coll/doc00"}, Source::Default);
+
+  ASSERT_TRUE(snapshots.ok()) << snapshots.status().ToString();
+  ASSERT_EQ(snapshots.ValueOrDie().size(), 1u);
+  const DocumentSnapshot& snapshot = snapshots.ValueOrDie()[0];
+  EXPECT_TRUE(snapshot.exists());
+  EXPECT_TRUE(snapshot.metadata().from_cache());
+  EXPECT_TRUE(snapshot.metadata().pending_writes());
+}
+
+TEST_F(FirestoreClientOnlineTest, FailsWhileOfflineWhenAskedForTheServer) {
+  StartOfflineClient();
+  WriteDocuments(1);
+
+  StatusOr<std::vector<DocumentSnapshot>> snapshots =
+      GetAll({"coll/doc00"}, Source::Server);
+
+  EXPECT_EQ(snapshots.status().code(), Error::kErrorUnavailable);
+}
+
+TEST_F(FirestoreClientOnlineTest, SplitsQueriesAtDistinctPointsInQueryOrder) {
+  // Points from different pages of the response are neither ordered nor
+  // distinct.
+  StartServer({PartitionPoints({"coll/c", "coll/a", "coll/c", "coll/b"})});
+
+  StatusOr<std::vector<api::Query>> partitions =
+      GetPartitions(testutil::CollectionGroupQuery("coll"), 5);
+
+  ASSERT_TRUE(partitions.ok()) << partitions.status().ToString();
+  const std::vector<api::Query>& queries = partitions.ValueOrDie();
+  ASSERT_EQ(queries.size(), 4u);
+  EXPECT_EQ(queries[0].query().start_at(), absl::nullopt);
+  EXPECT_EQ(queries[0].query().end_at(), PartitionPoint("coll/a"));
+  EXPECT_EQ(queries[1].query().start_at(), PartitionPoint("coll/a"));
+  EXPECT_EQ(queries[1].query().end_at(), PartitionPoint("coll/b"));
+  EXPECT_EQ(queries[2].query().start_at(), PartitionPoint("coll/b"));
+  EXPECT_EQ(queries[2].query().end_at(), PartitionPoint("coll/c"));
+  EXPECT_EQ(queries[3].query().start_at(), PartitionPoint("coll/c"));
+  EXPECT_EQ(queries[3].query().end_at(), absl::nullopt);
+}
+
+TEST_F(FirestoreClientOnlineTest, OrdersPartitionPointsAcrossCollections) {
+  StartServer({PartitionPoints({"b/1/coll/a", "a/1/coll/b"})});
+
+  StatusOr<std::vector<api::Query>> partitions =
+      GetPartitions(testutil::CollectionGroupQuery("coll"), 3);
+
+  ASSERT_TRUE(partitions.ok()) << partitions.status().ToString();
+  const std::vector<api::Query>& queries = partitions.ValueOrDie();
+  ASSERT_EQ(queries.size(), 3u);
+  EXPECT_EQ(queries[1].query().start_at(), PartitionPoint("a/1/coll/b"));
+  EXPECT_EQ(queries[1].query().end_at(), PartitionPoint("b/1/coll/a"));
+}
+
+TEST_F(FirestoreClientOnlineTest, ReturnsASinglePartitionWithoutTheBackend) {
+  StartOfflineClient();
+  Query query = testutil::CollectionGroupQuery("coll");
+
+  StatusOr<std::vector<api::Query>> partitions = GetPartitions(query, 1);
+
+  ASSERT_TRUE(partitions.ok()) << partitions.status().ToString();
+  ASSERT_EQ(partitions.ValueOrDie().size(), 1u);
+  EXPECT_EQ(partitions.ValueOrDie()[0].query(), query);
+}
+
+TEST_F(FirestoreClientOnlineTest, FailsToPartitionWhileOffline) {
+  StartOfflineClient();
+
+  StatusOr<std::vector<api::Query>> partitions =
+      GetPartitions(testutil::CollectionGroupQuery("coll"), 2);
+
+  EXPECT_EQ(partitions.status().code(), Error::kErrorUnavailable);
+}
+
+}  // namespace core
+}  // namespace firestore
+}  // namespace firebase
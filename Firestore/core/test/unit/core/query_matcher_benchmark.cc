@@ -0,0 +1,119 @@
+/*
+ * Copyright 2021 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string>
+#include <vector>
+
+#include "Firestore/core/src/core/field_filter.h"
+#include "Firestore/core/src/core/query.h"
+#include "Firestore/core/src/core/query_matcher.h"
+#include "Firestore/core/src/model/document.h"
+#include "Firestore/core/src/model/mutable_document.h"
+#include "Firestore/core/src/model/object_value.h"
+#include "Firestore/core/test/unit/testutil/testutil.h"
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+namespace firebase {
+namespace firestore {
+namespace core {
+namespace {
+
+using model::Document;
+using model::MutableDocument;
+using model::ObjectValue;
+
+const int kDocuments = 1000;
+const int kFieldsPerDocument = 20;
+
+std::vector<Document> MakeDocuments() {
+  std::vector<Document> docs;
+  for (int i = 0; i < kDocuments; ++i) {
+    ObjectValue data;
+    for (int field = 0; field < kFieldsPerDocument; ++field) {
+      data.Set(testutil::Field(absl::StrCat("f", field)),
+               field % 2 == 0 ? testutil::Value(i * field)
+                              : testutil::Value(absl::StrCat("value", i)));
+    }
+    docs.push_back(MutableDocument::FoundDocument(
+        testutil::Key(absl::StrCat("coll/doc", i)), testutil::Version(1),
+        std::move(data)));
+  }
+  return docs;
+}
+
+/**
+ * Creates a query with `filter_count` filters that every document matches, so
+ * that all filters are evaluated. Consecutive filters form range filters on
+ * the same field, alternating between number and string fields.
+ */
+Query MakeQuery(int64_t filter_count) {
+  Query query = testutil::Query("coll");
+  for (int64_t i = 0; i < filter_count; ++i) {
+    int64_t field = i / 2;
+    std::string name = absl::StrCat("f", field);
+    bool lower = i % 2 == 0;
+    if (field % 2 == 0) {
+      query = query.AddingFilter(lower ? testutil::Filter(name, ">=", 0)
+                                       : testutil::Filter(name, "<", 1 << 30));
+    } else {
+      query = query.AddingFilter(lower ? testutil::Filter(name, ">=", "value")
+                                       : testutil::Filter(name, "<", "valuf"));
+    }
+  }
+  return query;
+}
+
+/** Matches a document the way `Query::Matches` did before compilation. */
+bool MatchesPerFilter(const Query& query, const Document& doc) {
+  for (const auto& filter : query.filters()) {
+    if (!filter.Matches(doc)) return false;
+  }
+  return true;
+}
+
+void BM_MatchesPerFilter(benchmark::State& state) {
+  std::vector<Document> docs = MakeDocuments();
+  Query query = MakeQuery(state.range(0));
+
+  for (auto _ : state) {
+    for (const Document& doc : docs) {
+      bool matches = MatchesPerFilter(query, doc);
+      benchmark::DoNotOptimize(matches);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kDocuments);
+}
+BENCHMARK(BM_MatchesPerFilter)->DenseRange(1, 10);
+
+void BM_QueryMatcher(benchmark::State& state) {
+  std::vector<Document> docs = MakeDocuments();
+  QueryMatcher matcher(MakeQuery(state.range(0)));
+
+  for (auto _ : state) {
+    for (const Document& doc : docs) {
+      bool matches = matcher.Matches(doc);
+      benchmark::DoNotOptimize(matches);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kDocuments);
+}
+BENCHMARK(BM_QueryMatcher)->DenseRange(1, 10);
+
+}  // namespace
+}  // namespace core
+}  // namespace firestore
+}  // namespace firebase
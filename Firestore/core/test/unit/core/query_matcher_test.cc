@@ -0,0 +1,179 @@
+/*
+ * Copyright 2021 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Firestore/core/src/core/query_matcher.h"
+
+#include <cmath>
+#include <vector>
+
+#include "Firestore/core/src/core/bound.h"
+#include "Firestore/core/src/core/field_filter.h"
+#include "Firestore/core/src/core/query.h"
+#include "Firestore/core/src/model/mutable_document.h"
+#include "Firestore/core/test/unit/testutil/testutil.h"
+#include "gtest/gtest.h"
+
+namespace firebase {
+namespace firestore {
+namespace core {
+namespace {
+
+using model::Document;
+using model::MutableDocument;
+
+using testutil::Array;
+using testutil::Doc;
+using testutil::Filter;
+using testutil::Map;
+using testutil::OrderBy;
+using testutil::Ref;
+using testutil::Value;
+
+/** Matches `doc` against `query` by evaluating each constraint on its own. */
+bool MatchesPerFilter(const Query& query, const Document& doc) {
+  for (const auto& order_by : query.explicit_order_bys()) {
+    if (!order_by.field().IsKeyFieldPath() &&
+        !doc->field(order_by.field())) {
+      return false;
+    }
+  }
+  for (const auto& filter : query.filters()) {
+    if (!filter.Matches(doc)) return false;
+  }
+  const auto& start_at = query.start_at();
+  if (start_at && !start_at->SortsBeforeDocument(query.order_bys(), doc)) {
+    return false;
+  }
+  const auto& end_at = query.end_at();
+  if (end_at && end_at->SortsBeforeDocument(query.order_bys(), doc)) {
+    return false;
+  }
+  return true;
+}
+
+std::vector<MutableDocument> TestDocuments() {
+  return {
+      Doc("coll/empty", 0, Map()),
+      Doc("coll/null", 0, Map("a", nullptr, "b", nullptr)),
+      Doc("coll/false", 0, Map("a", false, "b", true)),
+      Doc("coll/int", 0, Map("a", 1, "b", 2)),
+      Doc("coll/int2", 0, Map("a", 2, "b", 2)),
+      Doc("coll/double", 0, Map("a", 1.0, "b", 1.5)),
+      Doc("coll/nan", 0, Map("a", NAN, "b", 1)),
+      Doc("coll/string", 0, Map("a", "bar", "b", "foo")),
+      Doc("coll/string2", 0, Map("a", "foo", "b", "bar")),
+      Doc("coll/array", 0, Map("a", Array(1, "bar"), "b", Array(2))),
+      Doc("coll/array2", 0, Map("a", Array(), "b", Array(nullptr))),
+      Doc("coll/map", 0, Map("a", Map("a", 1), "b", Map())),
+      Doc("coll/nested", 0, Map("a", Map("a", "bar"), "b", 1)),
+  };
+}
+
+std::vector<FieldFilter> TestFilters() {
+  std::vector<FieldFilter> filters;
+  for (const char* op : {"<", "<=", "==", "!=", ">=", ">"}) {
+    filters.push_back(Filter("a", op, 1));
+    filters.push_back(Filter("a", op, 1.5));
+    filters.push_back(Filter("a", op, NAN));
+    filters.push_back(Filter("a", op, "foo"));
+    filters.push_back(Filter("a", op, true));
+    filters.push_back(Filter("b", op, nullptr));
+    filters.push_back(Filter("b", op, Array(2)));
+    filters.push_back(Filter("a", op, Map("a", 1)));
+    filters.push_back(Filter("a.a", op, "bar"));
+    filters.push_back(
+        Filter("__name__", op, Ref("project/database", "coll/int")));
+  }
+  filters.push_back(Filter("a", "array-contains", 1));
+  filters.push_back(Filter("b", "array-contains", nullptr));
+  filters.push_back(Filter("a", "array-contains-any", Array(2, "bar")));
+  filters.push_back(Filter("a", "in", Array(1, "foo", Array())));
+  filters.push_back(Filter("a", "not-in", Array(1, "foo")));
+  filters.push_back(Filter("a", "not-in", Array(1, nullptr)));
+  filters.push_back(
+      Filter("__name__", "in", Array(Ref("project/database", "coll/int"))));
+  filters.push_back(Filter("__name__", "not-in",
+                           Array(Ref("project/database", "coll/int"))));
+  return filters;
+}
+
+void ExpectAgreement(const Query& query) {
+  QueryMatcher matcher(query);
+  for (const MutableDocument& doc : TestDocuments()) {
+    EXPECT_EQ(matcher.Matches(doc), MatchesPerFilter(query, doc))
+        << query.ToString() << " on " << doc.ToString();
+  }
+}
+
+TEST(QueryMatcherTest, AgreesWithPerFilterMatchingForSingleFilters) {
+  for (const FieldFilter& filter : TestFilters()) {
+    ExpectAgreement(testutil::Query("coll").AddingFilter(filter));
+  }
+}
+
+TEST(QueryMatcherTest, AgreesWithPerFilterMatchingForFilterPairs) {
+  std::vector<FieldFilter> filters = TestFilters();
+  for (const FieldFilter& first : filters) {
+    for (const FieldFilter& second : filters) {
+      ExpectAgreement(
+          testutil::Query("coll").AddingFilter(first).AddingFilter(second));
+    }
+  }
+}
+
+TEST(QueryMatcherTest, AgreesWithPerFilterMatchingForOrderBys) {
+  ExpectAgreement(testutil::Query("coll").AddingOrderBy(OrderBy("a")));
+  ExpectAgreement(testutil::Query("coll")
+                      .AddingOrderBy(OrderBy("b", "desc"))
+                      .AddingOrderBy(OrderBy("a")));
+  ExpectAgreement(
+      testutil::Query("coll").AddingOrderBy(OrderBy("__name__", "desc")));
+}
+
+TEST(QueryMatcherTest, AgreesWithPerFilterMatchingForBounds) {
+  Query base_query = testutil::Query("coll")
+                         .AddingOrderBy(OrderBy("a"))
+                         .AddingOrderBy(OrderBy("b", "desc"));
+
+  for (bool before : {true, false}) {
+    ExpectAgreement(
+        base_query.StartingAt(Bound::FromValue(Array(1), before)));
+    ExpectAgreement(base_query.EndingAt(Bound::FromValue(Array(1), before)));
+    ExpectAgreement(
+        base_query.StartingAt(Bound::FromValue(Array(1, 2), before))
+            .EndingAt(Bound::FromValue(Array("foo"), before)));
+    ExpectAgreement(base_query.StartingAt(Bound::FromValue(
+        Array(1, 2, Ref("project/database", "coll/int")), before)));
+  }
+
+  Query key_query =
+      testutil::Query("coll").AddingOrderBy(OrderBy("__name__", "desc"));
+  ExpectAgreement(key_query.StartingAt(
+      Bound::FromValue(Array(Ref("project/database", "coll/int")), false)));
+}
+
+TEST(QueryMatcherTest, AgreesWithPerFilterMatchingForInequalityBounds) {
+  // The bound is on the implicit order by the inequality field.
+  Query query = testutil::Query("coll")
+                    .AddingFilter(Filter("a", ">", 0))
+                    .StartingAt(Bound::FromValue(Array(1.5), true));
+  ExpectAgreement(query);
+}
+
+}  // namespace
+}  // namespace core
+}  // namespace firestore
+}  // namespace firebase
@@ -555,6 +555,56 @@ TEST(QueryTest, SortsDocumentsWithDescendingToo) {
   ASSERT_TRUE(CorrectComparisons(docs, query.Comparator()));
 }
 
+TEST(QueryTest, ComparatorAndSortKeysAgreeWithOrderBys) {
+  // clang-format off
+  std::vector<MutableDocument> docs = {
+      Doc("collection/a", 0, Map("sort1", nullptr, "sort2", 1)),
+      Doc("collection/b", 0, Map("sort1", false, "sort2", "a")),
+      Doc("collection/c", 0, Map("sort1", 1, "sort2", Array(1, 2))),
+      Doc("collection/d", 0, Map("sort1", 1.0, "sort2", Array(1))),
+      Doc("collection/e", 0, Map("sort1", -0.0, "sort2", Map("a", 1))),
+      Doc("collection/f", 0, Map("sort1", NAN, "sort2", Map())),
+      Doc("collection/g", 0, Map("sort1", "", "sort2", 1.5)),
+      Doc("collection/h", 0, Map("sort1", "a", "sort2", nullptr)),
+      Doc("collection/i", 0, Map("sort1", Array(), "sort2", 1)),
+      Doc("collection/j", 0, Map("sort1", Map("a", "b"), "sort2", 1)),
+      Doc("collection/k", 0,
+          Map("sort1", Ref("project", "collection/id1"), "sort2", 1)),
+      Doc("collection/l", 0, Map("sort1", 1, "sort2", Array(1, 2))),
+      Doc("collection/m", 0, Map("sort1", 2, "sort2", 1)),
+  };
+  // clang-format on
+
+  for (const char* direction1 : {"asc", "desc"}) {
+    for (const char* direction2 : {"asc", "desc"}) {
+      for (const char* key_direction : {"asc", "desc"}) {
+        auto query = testutil::Query("collection")
+                         .AddingOrderBy(OrderBy("sort1", direction1))
+                         .AddingOrderBy(OrderBy("sort2", direction2))
+                         .AddingOrderBy(OrderBy("__name__", key_direction));
+        DocumentComparator comparator = query.Comparator();
+
+        for (const MutableDocument& lhs : docs) {
+          for (const MutableDocument& rhs : docs) {
+            ComparisonResult expected = ComparisonResult::Same;
+            for (const auto& order_by : query.order_bys()) {
+              expected = order_by.Compare(lhs, rhs);
+              if (!util::Same(expected)) break;
+            }
+            ComparisonResult actual =
+                util::Compare(query.SortKey(lhs), query.SortKey(rhs));
+            EXPECT_EQ(actual, expected)
+                << query << ": " << lhs << " vs " << rhs;
+            EXPECT_EQ(comparator.Compare(comparator.WithSortKey(lhs), rhs),
+                      expected)
+                << query << ": " << lhs << " vs " << rhs;
+          }
+        }
+      }
+    }
+  }
+}
+
 TEST(QueryTest, Equality) {
   auto q11 = testutil::Query("foo")
                  .AddingFilter(Filter("i1", "<", 2))
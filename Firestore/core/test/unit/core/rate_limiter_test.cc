@@ -0,0 +1,90 @@
+/*
+ * Copyright 2021 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Firestore/core/src/core/rate_limiter.h"
+
+#include <chrono>  // NOLINT(build/c++11)
+
+#include "gtest/gtest.h"
+
+namespace firebase {
+namespace firestore {
+namespace core {
+
+namespace {
+
+using std::chrono::milliseconds;
+using std::chrono::minutes;
+using std::chrono::seconds;
+
+const RateLimiter::Clock::time_point kStart = RateLimiter::Clock::now();
+
+RateLimiter CreateLimiter() {
+  return RateLimiter(/* initial_rate= */ 500, /* multiplier= */ 1.5, minutes(5),
+                     /* max_rate= */ 1000, kStart);
+}
+
+}  // namespace
+
+TEST(RateLimiterTest, AllowsOneSecondBurst) {
+  RateLimiter limiter = CreateLimiter();
+  EXPECT_TRUE(limiter.TryAcquire(400, kStart));
+  EXPECT_TRUE(limiter.TryAcquire(100, kStart));
+  EXPECT_FALSE(limiter.TryAcquire(1, kStart));
+}
+
+TEST(RateLimiterTest, RefillsOverTime) {
+  RateLimiter limiter = CreateLimiter();
+  ASSERT_TRUE(limiter.TryAcquire(500, kStart));
+
+  EXPECT_EQ(limiter.GetDelay(50, kStart), milliseconds(100));
+  EXPECT_FALSE(limiter.TryAcquire(50, kStart + milliseconds(99)));
+  EXPECT_TRUE(limiter.TryAcquire(50, kStart + milliseconds(100)));
+  EXPECT_EQ(limiter.GetDelay(50, kStart + milliseconds(100)),
+            milliseconds(100));
+}
+
+TEST(RateLimiterTest, DoesNotStoreMoreThanOneSecond) {
+  RateLimiter limiter = CreateLimiter();
+  auto later = kStart + seconds(10);
+  EXPECT_TRUE(limiter.TryAcquire(500, later));
+  EXPECT_FALSE(limiter.TryAcquire(1, later));
+}
+
+TEST(RateLimiterTest, AllowsLargeRequestsOnceFull) {
+  RateLimiter limiter = CreateLimiter();
+  EXPECT_TRUE(limiter.TryAcquire(750, kStart));
+
+  // The request left the bucket in debt.
+  EXPECT_EQ(limiter.GetDelay(250, kStart), seconds(1));
+}
+
+TEST(RateLimiterTest, RampsUpToMaxRate) {
+  RateLimiter limiter = CreateLimiter();
+  EXPECT_EQ(limiter.GetRate(kStart), 500);
+  EXPECT_EQ(limiter.GetRate(kStart + minutes(5) - seconds(1)), 500);
+  EXPECT_EQ(limiter.GetRate(kStart + minutes(5)), 750);
+  EXPECT_EQ(limiter.GetRate(kStart + minutes(10)), 1000);
+  EXPECT_EQ(limiter.GetRate(kStart + minutes(60)), 1000);
+
+  auto later = kStart + minutes(5);
+  EXPECT_TRUE(limiter.TryAcquire(750, later));
+  EXPECT_FALSE(limiter.TryAcquire(1, later));
+}
+
+}  // namespace core
+}  // namespace firestore
+}  // namespace firebase
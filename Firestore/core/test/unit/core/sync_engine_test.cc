@@ -0,0 +1,541 @@
+/*
+ * Copyright 2021 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Firestore/core/src/core/sync_engine.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Firestore/core/src/core/database_info.h"
+#include "Firestore/core/src/core/sync_engine_callback.h"
+#include "Firestore/core/src/core/view_snapshot.h"
+#include "Firestore/core/src/credentials/empty_credentials_provider.h"
+#include "Firestore/core/src/credentials/user.h"
+#include "Firestore/core/src/local/local_store.h"
+#include "Firestore/core/src/local/memory_persistence.h"
+#include "Firestore/core/src/local/query_engine.h"
+#include "Firestore/core/src/model/database_id.h"
+#include "Firestore/core/src/model/document.h"
+#include "Firestore/core/src/model/document_key.h"
+#include "Firestore/core/src/model/mutation.h"
+#include "Firestore/core/src/model/mutation_batch.h"
+#include "Firestore/core/src/model/mutation_batch_result.h"
+#include "Firestore/core/src/model/patch_mutation.h"
+#include "Firestore/core/src/model/set_mutation.h"
+#include "Firestore/core/src/model/types.h"
+#include "Firestore/core/src/nanopb/byte_string.h"
+#include "Firestore/core/src/remote/connectivity_monitor.h"
+#include "Firestore/core/src/remote/datastore.h"
+#include "Firestore/core/src/remote/firebase_metadata_provider.h"
+#include "Firestore/core/src/remote/firebase_metadata_provider_noop.h"
+#include "Firestore/core/src/remote/remote_event.h"
+#include "Firestore/core/src/remote/remote_store.h"
+#include "Firestore/core/src/util/async_queue.h"
+#include "Firestore/core/src/util/status.h"
+#include "Firestore/core/src/util/statusor.h"
+#include "Firestore/core/test/unit/local/persistence_testing.h"
+#include "Firestore/core/test/unit/remote/create_noop_connectivity_monitor.h"
+#include "Firestore/core/test/unit/testutil/async_testing.h"
+#include "Firestore/core/test/unit/testutil/testutil.h"
+#include "absl/strings/str_cat.h"
+#include "absl/types/optional.h"
+#include "gtest/gtest.h"
+
+namespace firebase {
+namespace firestore {
+namespace core {
+namespace {
+
+using credentials::EmptyAppCheckCredentialsProvider;
+using credentials::EmptyAuthCredentialsProvider;
+using credentials::User;
+using local::LocalStore;
+using local::MemoryPersistence;
+using local::QueryEngine;
+using model::DatabaseId;
+using model::Document;
+using model::DocumentKey;
+using model::DocumentKeySet;
+using model::DocumentMap;
+using model::DocumentUpdateMap;
+using model::Mutation;
+using model::MutationBatch;
+using model::MutationBatchResult;
+using model::OnlineState;
+using model::TargetId;
+using remote::ConnectivityMonitor;
+using remote::Datastore;
+using remote::FirebaseMetadataProvider;
+using remote::RemoteEvent;
+using remote::RemoteStore;
+using remote::TargetChange;
+using util::AsyncQueue;
+using util::Status;
+using util::StatusOr;
+
+/** The most limbo documents that may be resolved with listens at once. */
+const size_t kMaxConcurrentLimboResolutions = 100;
+
+/** A `Datastore` that records lookups instead of sending them. */
+class FakeDatastore : public Datastore {
+ public:
+  struct Lookup {
+    std::vector<DocumentKey> keys;
+    LookupCallback callback;
+  };
+
+  using Datastore::Datastore;
+
+  void LookupDocuments(const std::vector<DocumentKey>& keys,
+                       LookupCallback&& callback) override {
+    lookups.push_back(Lookup{keys, std::move(callback)});
+  }
+
+  std::vector<Lookup> lookups;
+};
+
+/** Records the snapshots raised by the `SyncEngine`. */
+class FakeSyncEngineCallback : public SyncEngineCallback {
+ public:
+  void HandleOnlineStateChange(OnlineState) override {
+  }
+
+  void OnViewSnapshots(std::vector<ViewSnapshot>&& snapshots) override {
+    for (ViewSnapshot& snapshot : snapshots) {
+      this->snapshots.push_back(std::move(snapshot));
+    }
+  }
+
+  void OnError(const Query&, const Status& error) override {
+    errors.push_back(error);
+  }
+
+  std::vector<ViewSnapshot> snapshots;
+  std::vector<Status> errors;
+};
+
+/**
+ * Returns the keys of `count` documents in the "coll" collection, in key
+ * order.
+ */
+std::vector<DocumentKey> Keys(size_t count) {
+  std::vector<DocumentKey> result;
+  for (size_t i = 0; i < count; ++i) {
+    result.push_back(testutil::Key(
+        absl::StrCat("coll/doc", absl::Dec(i, absl::kZeroPad4))));
+  }
+  return result;
+}
+
+DocumentKeySet KeySet(const std::vector<DocumentKey>& keys) {
+  DocumentKeySet result;
+  for (const DocumentKey& key : keys) {
+    result = result.insert(key);
+  }
+  return result;
+}
+
+std::vector<size_t> BatchSizes(
+    const std::vector<FakeDatastore::Lookup>& lookups) {
+  std::vector<size_t> result;
+  for (const FakeDatastore::Lookup& lookup : lookups) {
+    result.push_back(lookup.keys.size());
+  }
+  return result;
+}
+
+}  // namespace
+
+/**
+ * Tests `SyncEngine` against a memory-backed `LocalStore` and a `RemoteStore`
+ * whose network is never enabled. Everything that touches the sync engine runs
+ * on the worker queue.
+ */
+class SyncEngineTest : public testing::Test {
+ public:
+  SyncEngineTest() : SyncEngineTest(/*coalesce_writes=*/false) {
+  }
+
+ protected:
+  explicit SyncEngineTest(bool coalesce_writes)
+      : worker_queue_{testutil::AsyncQueueForTesting()},
+        persistence_{local::MemoryPersistenceWithEagerGcForTesting()},
+        local_store_{persistence_.get(), &query_engine_,
+                     User::Unauthenticated()},
+        connectivity_monitor_{remote::CreateNoOpConnectivityMonitor()},
+        metadata_provider_{remote::CreateFirebaseMetadataProviderNoOp()},
+        database_info_{DatabaseId{"p", "d"}, "", "localhost",
+                       /* ssl_enabled= */ false},
+        datastore_{std::make_shared<FakeDatastore>(
+            database_info_, worker_queue_,
+            std::make_shared<EmptyAuthCredentialsProvider>(),
+            std::make_shared<EmptyAppCheckCredentialsProvider>(),
+            connectivity_monitor_.get(), metadata_provider_.get())},
+        remote_store_{&local_store_, datastore_, worker_queue_,
+                      connectivity_monitor_.get(), [](OnlineState) {}},
+        sync_engine_{&local_store_, &remote_store_, User::Unauthenticated(),
+                     kMaxConcurrentLimboResolutions,
+                     LimboResolutionStrategy::BatchLookup, coalesce_writes} {
+    local_store_.Start();
+    remote_store_.set_sync_engine(&sync_engine_);
+    sync_engine_.SetCallback(&callback_);
+  }
+
+  ~SyncEngineTest() {
+    worker_queue_->EnqueueBlocking([&] { remote_store_.Shutdown(); });
+  }
+
+  /** Listens to the "coll" collection and returns the target ID. */
+  TargetId ListenToCollection() {
+    TargetId target_id = 0;
+    worker_queue_->EnqueueBlocking(
+        [&] { target_id = sync_engine_.Listen(testutil::Query("coll")); });
+    return target_id;
+  }
+
+  void SetOnlineState(OnlineState online_state) {
+    worker_queue_->EnqueueBlocking(
+        [&] { sync_engine_.HandleOnlineStateChange(online_state); });
+  }
+
+  /**
+   * Has watch report `keys` as the current results of `target_id` at version
+   * 1000, then drop them from the target without deleting them, which puts
+   * them into limbo.
+   */
+  void PutIntoLimbo(TargetId target_id, const std::vector<DocumentKey>& keys) {
+    DocumentUpdateMap updates;
+    for (const DocumentKey& key : keys) {
+      updates.emplace(key, testutil::Doc(key.ToString(), 1000));
+    }
+
+    RemoteEvent::TargetChangeMap added;
+    added[target_id] = TargetChange{{},
+                                    /* current= */ true,
+                                    KeySet(keys),
+                                    DocumentKeySet{},
+                                    DocumentKeySet{}};
+    ApplyRemoteEvent(RemoteEvent{testutil::Version(1000), std::move(added),
+                                 {}, std::move(updates), DocumentKeySet{}});
+
+    RemoteEvent::TargetChangeMap removed;
+    removed[target_id] = TargetChange{{},
+                                      /* current= */ true,
+                                      DocumentKeySet{},
+                                      DocumentKeySet{},
+                                      KeySet(keys)};
+    ApplyRemoteEvent(RemoteEvent{testutil::Version(2000), std::move(removed),
+                                 {}, {}, DocumentKeySet{}});
+  }
+
+  void ApplyRemoteEvent(const RemoteEvent& remote_event) {
+    worker_queue_->EnqueueBlocking(
+        [&] { sync_engine_.ApplyRemoteEvent(remote_event); });
+  }
+
+  /** Completes the outstanding lookup at `index` with `result`. */
+  void CompleteLookup(size_t index,
+                      const StatusOr<std::vector<Document>>& result) {
+    worker_queue_->EnqueueBlocking([&] {
+      Datastore::LookupCallback callback =
+          std::move(datastore_->lookups[index].callback);
+      callback(result);
+    });
+  }
+
+  std::vector<FakeDatastore::Lookup>& lookups() {
+    return datastore_->lookups;
+  }
+
+  void WriteMutation(Mutation mutation,
+                     util::StatusCallback callback = [](const Status&) {}) {
+    worker_queue_->EnqueueBlocking([&] {
+      sync_engine_.WriteMutations({std::move(mutation)}, std::move(callback));
+    });
+  }
+
+  /** Returns the first batch of the mutation queue that awaits an ack. */
+  absl::optional<MutationBatch> NextMutationBatch() {
+    absl::optional<MutationBatch> result;
+    worker_queue_->EnqueueBlocking([&] {
+      result = local_store_.GetNextMutationBatch(model::kBatchIdUnknown);
+    });
+    return result;
+  }
+
+  /** Has the backend accept `batch`, as the write stream would. */
+  void AcknowledgeBatch(const MutationBatch& batch) {
+    std::vector<model::MutationResult> results;
+    for (size_t i = 0; i < batch.mutations().size(); ++i) {
+      results.push_back(testutil::MutationResult(1000));
+    }
+    worker_queue_->EnqueueBlocking([&] {
+      sync_engine_.HandleSuccessfulWrite(
+          MutationBatchResult(batch, testutil::Version(1000),
+                              std::move(results), nanopb::ByteString{}));
+    });
+  }
+
+  /** Has the backend reject `batch` with `error`. */
+  void RejectBatch(const MutationBatch& batch, const Status& error) {
+    worker_queue_->EnqueueBlocking(
+        [&] { sync_engine_.HandleRejectedWrite(batch.batch_id(), error); });
+  }
+
+  /**
+   * Looks up `keys` through the sync engine. The result is available from
+   * `lookup_result` once the lookup has been completed.
+   */
+  void LookupDocuments(const std::vector<DocumentKey>& keys) {
+    worker_queue_->EnqueueBlocking([&] {
+      sync_engine_.LookupDocuments(
+          keys, [this](const StatusOr<DocumentMap>& result) {
+            lookup_result_ = result;
+          });
+    });
+  }
+
+  const absl::optional<StatusOr<DocumentMap>>& lookup_result() const {
+    return lookup_result_;
+  }
+
+  /** The keys of documents in limbo that are resolved with listens. */
+  std::vector<DocumentKey> ListenedLimboKeys() {
+    std::vector<DocumentKey> result;
+    worker_queue_->EnqueueBlocking([&] {
+      for (const auto& entry :
+           sync_engine_.GetActiveLimboDocumentResolutions()) {
+        result.push_back(entry.first);
+      }
+      for (const DocumentKey& key :
+           sync_engine_.GetEnqueuedLimboDocumentResolutions()) {
+        result.push_back(key);
+      }
+    });
+    return result;
+  }
+
+  const ViewSnapshot& last_snapshot() const {
+    return callback_.snapshots.back();
+  }
+
+ private:
+  std::shared_ptr<AsyncQueue> worker_queue_;
+
+  QueryEngine query_engine_;
+  std::unique_ptr<MemoryPersistence> persistence_;
+  LocalStore local_store_;
+
+  std::unique_ptr<ConnectivityMonitor> connectivity_monitor_;
+  std::unique_ptr<FirebaseMetadataProvider> metadata_provider_;
+  DatabaseInfo database_info_;
+  std::shared_ptr<FakeDatastore> datastore_;
+  RemoteStore remote_store_;
+
+  FakeSyncEngineCallback callback_;
+  SyncEngine sync_engine_;
+
+  absl::optional<StatusOr<DocumentMap>> lookup_result_;
+};
+
+/** Runs its tests with write coalescing enabled. */
+class SyncEngineWithWriteCoalescingTest : public SyncEngineTest {
+ public:
+  SyncEngineWithWriteCoalescingTest()
+      : SyncEngineTest(/*coalesce_writes=*/true) {
+  }
+};
+
+TEST_F(SyncEngineTest, LooksUpLimboDocumentsInBatches) {
+  SetOnlineState(OnlineState::Online);
+  TargetId target_id = ListenToCollection();
+
+  PutIntoLimbo(target_id, Keys(1200));
+
+  EXPECT_EQ(BatchSizes(lookups()), (std::vector<size_t>{500, 500, 200}));
+  EXPECT_TRUE(ListenedLimboKeys().empty());
+  EXPECT_TRUE(last_snapshot().from_cache());
+}
+
+TEST_F(SyncEngineTest, LimitsLimboLookupsInFlight) {
+  SetOnlineState(OnlineState::Online);
+  TargetId target_id = ListenToCollection();
+  std::vector<DocumentKey> keys = Keys(4 * 500 + 1);
+
+  PutIntoLimbo(target_id, keys);
+  EXPECT_EQ(BatchSizes(lookups()), (std::vector<size_t>{500, 500, 500, 500}));
+
+  std::vector<Document> deleted;
+  for (const DocumentKey& key : lookups()[0].keys) {
+    deleted.push_back(testutil::DeletedDoc(key, 3000));
+  }
+  CompleteLookup(0, deleted);
+
+  ASSERT_EQ(lookups().size(), 5u);
+  EXPECT_EQ(lookups()[4].keys, std::vector<DocumentKey>{keys.back()});
+}
+
+TEST_F(SyncEngineTest, HoldsLimboLookupsWhileOffline) {
+  SetOnlineState(OnlineState::Offline);
+  TargetId target_id = ListenToCollection();
+  std::vector<DocumentKey> keys = Keys(3);
+
+  PutIntoLimbo(target_id, keys);
+  EXPECT_TRUE(lookups().empty());
+  EXPECT_TRUE(ListenedLimboKeys().empty());
+
+  SetOnlineState(OnlineState::Online);
+  ASSERT_EQ(lookups().size(), 1u);
+  EXPECT_EQ(lookups()[0].keys, keys);
+}
+
+TEST_F(SyncEngineTest, ResolvesDeletedLimboDocuments) {
+  SetOnlineState(OnlineState::Online);
+  TargetId target_id = ListenToCollection();
+  std::vector<DocumentKey> keys = Keys(3);
+
+  PutIntoLimbo(target_id, keys);
+  ASSERT_EQ(lookups().size(), 1u);
+
+  std::vector<Document> deleted;
+  for (const DocumentKey& key : keys) {
+    deleted.push_back(testutil::DeletedDoc(key, 3000));
+  }
+  CompleteLookup(0, deleted);
+
+  EXPECT_TRUE(ListenedLimboKeys().empty());
+  EXPECT_TRUE(last_snapshot().documents().empty());
+  EXPECT_FALSE(last_snapshot().from_cache());
+}
+
+TEST_F(SyncEngineTest, ListensForLimboDocumentsWhenLookupFails) {
+  SetOnlineState(OnlineState::Online);
+  TargetId target_id = ListenToCollection();
+  std::vector<DocumentKey> keys = Keys(3);
+
+  PutIntoLimbo(target_id, keys);
+  ASSERT_EQ(lookups().size(), 1u);
+
+  CompleteLookup(0, Status{Error::kErrorUnavailable, "Offline"});
+
+  EXPECT_EQ(ListenedLimboKeys(), keys);
+  EXPECT_EQ(lookups().size(), 1u);
+}
+
+TEST_F(SyncEngineTest, ListensForDocumentsStillInLimboAfterLookup) {
+  SetOnlineState(OnlineState::Online);
+  TargetId target_id = ListenToCollection();
+  std::vector<DocumentKey> keys = Keys(3);
+
+  PutIntoLimbo(target_id, keys);
+  ASSERT_EQ(lookups().size(), 1u);
+
+  // The first document was deleted, the others still match the query but
+  // watch hasn't reported them for its target yet.
+  std::vector<Document> found{testutil::DeletedDoc(keys[0], 3000),
+                              testutil::Doc(keys[1].ToString(), 3000),
+                              testutil::Doc(keys[2].ToString(), 3000)};
+  CompleteLookup(0, found);
+
+  EXPECT_EQ(ListenedLimboKeys(), (std::vector<DocumentKey>{keys[1], keys[2]}));
+  EXPECT_EQ(last_snapshot().documents().size(), 2u);
+  EXPECT_TRUE(last_snapshot().from_cache());
+}
+
+TEST_F(SyncEngineTest, LooksUpDocumentsWithTheirLocalWrites) {
+  std::vector<DocumentKey> keys = Keys(2);
+  WriteMutation(
+      testutil::PatchMutation(keys[0].ToString(), testutil::Map("b", 2)));
+
+  LookupDocuments(keys);
+  ASSERT_EQ(lookups().size(), 1u);
+  EXPECT_EQ(lookups()[0].keys, keys);
+  EXPECT_FALSE(lookup_result());
+
+  CompleteLookup(0, std::vector<Document>{
+                        testutil::Doc(keys[0].ToString(), 1000,
+                                      testutil::Map("a", 1)),
+                        testutil::DeletedDoc(keys[1], 1000)});
+
+  ASSERT_TRUE(lookup_result());
+  ASSERT_TRUE(lookup_result()->ok());
+  const DocumentMap& documents = lookup_result()->ValueOrDie();
+  EXPECT_EQ(documents.size(), 2u);
+  EXPECT_EQ(documents.get(keys[0]),
+            Document{testutil::Doc(keys[0].ToString(), 1000,
+                                   testutil::Map("a", 1, "b", 2))
+                         .SetHasLocalMutations()});
+  EXPECT_EQ(documents.get(keys[1]),
+            Document{testutil::DeletedDoc(keys[1], 1000)});
+}
+
+TEST_F(SyncEngineTest, FailsLookupsWithTheErrorOfTheDatastore) {
+  LookupDocuments(Keys(1));
+  ASSERT_EQ(lookups().size(), 1u);
+
+  CompleteLookup(0, Status{Error::kErrorUnavailable, "Offline"});
+
+  ASSERT_TRUE(lookup_result());
+  EXPECT_EQ(lookup_result()->status().code(), Error::kErrorUnavailable);
+}
+
+TEST_F(SyncEngineWithWriteCoalescingTest, CompletesCoalescedWritesOnAck) {
+  std::vector<Status> results;
+  auto record = [&results](const Status& status) { results.push_back(status); };
+
+  // The network is disabled, so both writes stay queued and are merged.
+  WriteMutation(testutil::SetMutation("coll/a", testutil::Map("a", 1)), record);
+  WriteMutation(testutil::PatchMutation("coll/a", testutil::Map("b", 2)),
+                record);
+
+  absl::optional<MutationBatch> batch = NextMutationBatch();
+  ASSERT_TRUE(batch);
+  EXPECT_EQ(batch->mutations(),
+            std::vector<Mutation>{testutil::SetMutation(
+                "coll/a", testutil::Map("a", 1, "b", 2))});
+  EXPECT_TRUE(results.empty());
+
+  AcknowledgeBatch(*batch);
+
+  ASSERT_EQ(results.size(), 2u);
+  EXPECT_TRUE(results[0].ok());
+  EXPECT_TRUE(results[1].ok());
+  EXPECT_FALSE(NextMutationBatch());
+}
+
+TEST_F(SyncEngineWithWriteCoalescingTest, FailsCoalescedWritesOnReject) {
+  std::vector<Status> results;
+  auto record = [&results](const Status& status) { results.push_back(status); };
+
+  WriteMutation(testutil::SetMutation("coll/a", testutil::Map("a", 1)), record);
+  WriteMutation(testutil::PatchMutation("coll/a", testutil::Map("b", 2)),
+                record);
+
+  absl::optional<MutationBatch> batch = NextMutationBatch();
+  ASSERT_TRUE(batch);
+  RejectBatch(*batch, Status{Error::kErrorPermissionDenied, "Denied"});
+
+  ASSERT_EQ(results.size(), 2u);
+  EXPECT_EQ(results[0].code(), Error::kErrorPermissionDenied);
+  EXPECT_EQ(results[1].code(), Error::kErrorPermissionDenied);
+  EXPECT_FALSE(NextMutationBatch());
+}
+
+}  // namespace core
+}  // namespace firestore
+}  // namespace firebase
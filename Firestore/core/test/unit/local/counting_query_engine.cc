@@ -84,6 +84,11 @@ void WrappedMutationQueue::RemoveMutationBatch(
   subject_->RemoveMutationBatch(batch);
 }
 
+void WrappedMutationQueue::ReplaceMutationBatch(
+    const model::MutationBatch& batch) {
+  subject_->ReplaceMutationBatch(batch);
+}
+
 std::vector<model::MutationBatch> WrappedMutationQueue::AllMutationBatches() {
   auto result = subject_->AllMutationBatches();
   query_engine_->mutations_read_by_key_ += result.size();
@@ -115,6 +120,14 @@ WrappedMutationQueue::AllMutationBatchesAffectingQuery(
   return result;
 }
 
+std::vector<model::MutationBatch>
+WrappedMutationQueue::AllMutationBatchesAffectingCollections(
+    const std::vector<model::ResourcePath>& collections) {
+  auto result = subject_->AllMutationBatchesAffectingCollections(collections);
+  query_engine_->mutations_read_by_query_ += result.size();
+  return result;
+}
+
 absl::optional<model::MutationBatch> WrappedMutationQueue::LookupMutationBatch(
     model::BatchId batch_id) {
   return subject_->LookupMutationBatch(batch_id);
@@ -173,6 +186,28 @@ model::MutableDocumentMap WrappedRemoteDocumentCache::GetMatching(
   return result;
 }
 
+std::vector<model::MutableDocumentMap>
+WrappedRemoteDocumentCache::GetMatchingCollectionGroup(
+    const core::Query& query,
+    const std::vector<model::ResourcePath>& collections,
+    const model::SnapshotVersion& since_read_time) {
+  auto result =
+      subject_->GetMatchingCollectionGroup(query, collections, since_read_time);
+  for (const auto& documents : result) {
+    query_engine_->documents_read_by_query_ += documents.size();
+  }
+  return result;
+}
+
+model::MutableDocumentMap WrappedRemoteDocumentCache::GetPage(
+    const model::ResourcePath& collection,
+    const model::DocumentKey& start_after,
+    size_t limit) {
+  auto result = subject_->GetPage(collection, start_after, limit);
+  query_engine_->documents_read_by_query_ += result.size();
+  return result;
+}
+
 }  // namespace local
 }  // namespace firestore
 }  // namespace firebase
@@ -55,7 +55,8 @@ class CountingQueryEngine : public QueryEngine {
 
   /**
    * Returns the number of documents returned by the RemoteDocumentCache's
-   * `GetMatching()` API (since the last call to `ResetCounts()`)
+   * `GetMatching()` and `GetMatchingCollectionGroup()` APIs (since the last
+   * call to `ResetCounts()`)
    */
   size_t documents_read_by_query() const {
     return documents_read_by_query_;
@@ -124,6 +125,8 @@ class WrappedMutationQueue : public MutationQueue {
 
   void RemoveMutationBatch(const model::MutationBatch& batch) override;
 
+  void ReplaceMutationBatch(const model::MutationBatch& batch) override;
+
   std::vector<model::MutationBatch> AllMutationBatches() override;
 
   std::vector<model::MutationBatch> AllMutationBatchesAffectingDocumentKeys(
@@ -135,6 +138,9 @@ class WrappedMutationQueue : public MutationQueue {
   std::vector<model::MutationBatch> AllMutationBatchesAffectingQuery(
       const core::Query& query) override;
 
+  std::vector<model::MutationBatch> AllMutationBatchesAffectingCollections(
+      const std::vector<model::ResourcePath>& collections) override;
+
   absl::optional<model::MutationBatch> LookupMutationBatch(
       model::BatchId batch_id) override;
 
@@ -175,6 +181,15 @@ class WrappedRemoteDocumentCache : public RemoteDocumentCache {
       const core::Query& query,
       const model::SnapshotVersion& since_read_time) override;
 
+  std::vector<model::MutableDocumentMap> GetMatchingCollectionGroup(
+      const core::Query& query,
+      const std::vector<model::ResourcePath>& collections,
+      const model::SnapshotVersion& since_read_time) override;
+
+  model::MutableDocumentMap GetPage(const model::ResourcePath& collection,
+                                    const model::DocumentKey& start_after,
+                                    size_t limit) override;
+
  private:
   RemoteDocumentCache* subject_ = nullptr;
   CountingQueryEngine* query_engine_ = nullptr;
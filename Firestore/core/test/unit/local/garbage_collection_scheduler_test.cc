@@ -0,0 +1,185 @@
+/*
+ * Copyright 2021 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Firestore/core/src/local/garbage_collection_scheduler.h"
+
+#include <chrono>  // NOLINT(build/c++11)
+
+#include "gtest/gtest.h"
+
+namespace firebase {
+namespace firestore {
+namespace local {
+
+namespace {
+
+using Clock = GarbageCollectionScheduler::Clock;
+using Decision = GarbageCollectionScheduler::Decision;
+using std::chrono::milliseconds;
+using std::chrono::minutes;
+using std::chrono::seconds;
+
+const int64_t kThreshold = 100 * 1024 * 1024;
+
+LruResults Removed(int documents) {
+  return LruResults{/* did_run= */ true, 1, 0, documents};
+}
+
+class GarbageCollectionSchedulerTest : public testing::Test {
+ protected:
+  /** Writes `bytes` to the simulated cache at the current time. */
+  void Write(int64_t bytes) {
+    writes_.bytes_written += bytes;
+    writes_.last_write_time = now_;
+  }
+
+  /** Advances the simulated time by the delay the scheduler asked for. */
+  void WaitForNextCheck() {
+    now_ += scheduler_.next_delay();
+  }
+
+  Decision Decide() {
+    return scheduler_.Decide(writes_, now_);
+  }
+
+  /** Decides, and records a collection with `results` if one was asked for. */
+  Decision Check(const LruResults& results = LruResults::DidNotRun()) {
+    Decision decision = Decide();
+    if (decision == Decision::Collect) {
+      scheduler_.RecordCollection(writes_, results, {});
+    }
+    return decision;
+  }
+
+  GarbageCollectionScheduler scheduler_{kThreshold};
+  CacheWriteStats writes_;
+  Clock::time_point now_ = Clock::now() + minutes(10);
+};
+
+}  // namespace
+
+TEST_F(GarbageCollectionSchedulerTest, CollectsOnceAfterStartup) {
+  WaitForNextCheck();
+  EXPECT_EQ(Check(), Decision::Collect);
+
+  WaitForNextCheck();
+  EXPECT_EQ(Check(), Decision::SkipWithoutGrowth);
+  EXPECT_EQ(scheduler_.stats().collections, 1);
+  EXPECT_EQ(scheduler_.stats().skipped, 1);
+}
+
+TEST_F(GarbageCollectionSchedulerTest, CollectsAfterTheCacheGrew) {
+  WaitForNextCheck();
+  Check();
+
+  Write(scheduler_.growth_threshold() - 1);
+  WaitForNextCheck();
+  EXPECT_EQ(Check(), Decision::SkipWithoutGrowth);
+
+  Write(1);
+  WaitForNextCheck();
+  EXPECT_EQ(Check(), Decision::Collect);
+
+  WaitForNextCheck();
+  EXPECT_EQ(Check(), Decision::SkipWithoutGrowth);
+}
+
+TEST_F(GarbageCollectionSchedulerTest, MeasuresGrowthFromTheEndOfACollection) {
+  WaitForNextCheck();
+  ASSERT_EQ(Decide(), Decision::Collect);
+  // Removing garbage writes to the cache, too.
+  Write(scheduler_.growth_threshold());
+  scheduler_.RecordCollection(writes_, LruResults{/* did_run= */ true, 0, 0, 0},
+                              {});
+
+  WaitForNextCheck();
+  EXPECT_EQ(Check(), Decision::SkipWithoutGrowth);
+}
+
+TEST_F(GarbageCollectionSchedulerTest, DefersWhileBusy) {
+  WaitForNextCheck();
+  Write(scheduler_.growth_threshold());
+  EXPECT_EQ(Check(), Decision::DeferWhileBusy);
+  EXPECT_LT(scheduler_.next_delay(), minutes(1));
+
+  // Still written to when checked again.
+  WaitForNextCheck();
+  Write(1);
+  EXPECT_EQ(Check(), Decision::DeferWhileBusy);
+
+  // Idle by the next check.
+  WaitForNextCheck();
+  EXPECT_EQ(Check(), Decision::Collect);
+  EXPECT_EQ(scheduler_.stats().deferred, 2);
+}
+
+TEST_F(GarbageCollectionSchedulerTest, StopsDeferringEventually) {
+  WaitForNextCheck();
+  int deferrals = 0;
+  for (;;) {
+    Write(1);
+    if (Check() == Decision::Collect) break;
+    ++deferrals;
+    WaitForNextCheck();
+  }
+  EXPECT_GT(deferrals, 0);
+  EXPECT_LT(deferrals, 10);
+}
+
+TEST_F(GarbageCollectionSchedulerTest, DoesNotDeferLargeGrowth) {
+  WaitForNextCheck();
+  Check();
+
+  WaitForNextCheck();
+  Write(10 * scheduler_.growth_threshold());
+  EXPECT_EQ(Check(), Decision::Collect);
+}
+
+TEST_F(GarbageCollectionSchedulerTest, FollowsUpWhileOverThreshold) {
+  WaitForNextCheck();
+  EXPECT_EQ(Check(Removed(100)), Decision::Collect);
+  EXPECT_EQ(scheduler_.next_delay(), seconds(10));
+
+  // The cache may still be over its threshold, even without new writes.
+  WaitForNextCheck();
+  EXPECT_EQ(Check(Removed(0)), Decision::Collect);
+
+  // Nothing was left to remove.
+  EXPECT_EQ(scheduler_.next_delay(), minutes(1));
+  WaitForNextCheck();
+  EXPECT_EQ(Check(), Decision::SkipWithoutGrowth);
+}
+
+TEST_F(GarbageCollectionSchedulerTest, RecordsCollectionDurations) {
+  WaitForNextCheck();
+  ASSERT_EQ(Decide(), Decision::Collect);
+  scheduler_.RecordCollection(writes_, Removed(5), milliseconds(7));
+
+  Write(scheduler_.growth_threshold());
+  now_ += minutes(1);
+  ASSERT_EQ(Decide(), Decision::Collect);
+  scheduler_.RecordCollection(writes_, Removed(5), milliseconds(3));
+
+  const GarbageCollectionScheduler::Stats& stats = scheduler_.stats();
+  EXPECT_EQ(stats.collections, 2);
+  EXPECT_EQ(stats.last_collection_duration.count(), 3);
+  EXPECT_EQ(stats.total_collection_duration.count(), 10);
+  EXPECT_EQ(stats.last_results.documents_removed, 5);
+}
+
+}  // namespace local
+}  // namespace firestore
+}  // namespace firebase
@@ -0,0 +1,259 @@
+/*
+ * Copyright 2021 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Firestore/core/src/local/leveldb_cache_snapshot.h"
+
+#include <fstream>
+#include <memory>
+#include <string>
+
+#include "Firestore/core/src/credentials/user.h"
+#include "Firestore/core/src/local/leveldb_persistence.h"
+#include "Firestore/core/src/local/local_store.h"
+#include "Firestore/core/src/local/query_engine.h"
+#include "Firestore/core/src/local/target_data.h"
+#include "Firestore/core/src/model/mutable_document.h"
+#include "Firestore/core/src/util/filesystem.h"
+#include "Firestore/core/src/util/path.h"
+#include "Firestore/core/src/util/status.h"
+#include "Firestore/core/test/unit/local/persistence_testing.h"
+#include "Firestore/core/test/unit/testutil/testutil.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace firebase {
+namespace firestore {
+namespace local {
+namespace {
+
+using credentials::User;
+using model::DocumentKeySet;
+using model::MutableDocument;
+using model::ResourcePath;
+using util::Filesystem;
+using util::Path;
+using util::Status;
+
+using testing::ElementsAre;
+using testutil::Doc;
+using testutil::Map;
+using testutil::Version;
+
+Path CleanTempPath(const char* name) {
+  auto* fs = Filesystem::Default();
+  Path path = fs->TempDir().AppendUtf8(name);
+  EXPECT_TRUE(fs->RecursivelyRemove(path).ok());
+  return path;
+}
+
+class LevelDbCacheSnapshotTest : public testing::Test {
+ public:
+  LevelDbCacheSnapshotTest()
+      : source_(LevelDbPersistenceForTesting()),
+        destination_(LevelDbPersistenceForTesting(
+            CleanTempPath("CacheSnapshotTesting"))),
+        file_(CleanTempPath("cache_snapshot")),
+        doc_a_(Doc("coll/a", 1, Map("value", 1))),
+        doc_b_(Doc("coll/b", 2, Map("value", 2))),
+        target_data_(testutil::Query("coll").ToTarget(),
+                     7,
+                     1000,
+                     QueryPurpose::Listen,
+                     Version(3),
+                     Version(3),
+                     testutil::ResumeToken(3)) {
+  }
+
+  /** Adds two documents and a target that matches them to `source_`. */
+  void PopulateSource() {
+    source_->Run("Populate", [&] {
+      source_->remote_document_cache()->Add(doc_a_, doc_a_.version());
+      source_->remote_document_cache()->Add(doc_b_, doc_b_.version());
+      source_->target_cache()->AddTarget(target_data_);
+      source_->target_cache()->AddMatchingKeys(
+          DocumentKeySet{doc_a_.key(), doc_b_.key()},
+          target_data_.target_id());
+    });
+  }
+
+  /** Flips a bit in the middle of the snapshot file. */
+  void CorruptSnapshot() {
+    std::fstream file{file_.native_value(),
+                      std::ios::in | std::ios::out | std::ios::binary};
+    file.seekg(0, std::ios::end);
+    std::streamoff offset = file.tellg() / 2;
+    file.seekg(offset);
+    char byte = static_cast<char>(file.get());
+    file.seekp(offset);
+    file.put(static_cast<char>(byte ^ 0x01));
+  }
+
+  std::unique_ptr<LevelDbPersistence> source_;
+  std::unique_ptr<LevelDbPersistence> destination_;
+  Path file_;
+
+  MutableDocument doc_a_;
+  MutableDocument doc_b_;
+  TargetData target_data_;
+};
+
+}  // namespace
+
+TEST_F(LevelDbCacheSnapshotTest, ImportsExportedCache) {
+  PopulateSource();
+  ASSERT_TRUE(source_->ExportCacheSnapshot(file_).ok());
+  ASSERT_TRUE(destination_->ImportCacheSnapshot(file_).ok());
+
+  destination_->Run("Verify", [&] {
+    EXPECT_EQ(destination_->remote_document_cache()->Get(doc_a_.key()), doc_a_);
+    EXPECT_EQ(destination_->remote_document_cache()->Get(doc_b_.key()), doc_b_);
+    EXPECT_EQ(destination_->target_cache()->GetTarget(target_data_.target()),
+              target_data_);
+    EXPECT_EQ(destination_->target_cache()->GetMatchingKeys(
+                  target_data_.target_id()),
+              (DocumentKeySet{doc_a_.key(), doc_b_.key()}));
+    EXPECT_THAT(destination_->index_manager()->GetCollectionParents("coll"),
+                ElementsAre(ResourcePath::Empty()));
+
+    // Sequence numbers continue after those in the snapshot.
+    EXPECT_EQ(destination_->current_sequence_number(), 1001);
+  });
+
+  // The target metadata is reloaded along with the rows.
+  EXPECT_EQ(destination_->target_cache()->highest_target_id(), 7);
+  EXPECT_EQ(destination_->target_cache()->size(), 1u);
+}
+
+TEST_F(LevelDbCacheSnapshotTest, AllocatesNewTargetsAfterImportedOnes) {
+  QueryEngine query_engine;
+  LocalStore local_store(destination_.get(), &query_engine,
+                         User::Unauthenticated());
+  local_store.Start();
+
+  PopulateSource();
+  ASSERT_TRUE(source_->ExportCacheSnapshot(file_).ok());
+  ASSERT_TRUE(destination_->ImportCacheSnapshot(file_).ok());
+  local_store.HandleCacheSnapshotImport();
+
+  // Imported targets keep their IDs, new ones don't reuse them.
+  EXPECT_EQ(local_store.AllocateTarget(target_data_.target()).target_id(),
+            target_data_.target_id());
+  EXPECT_GT(
+      local_store.AllocateTarget(testutil::Query("other").ToTarget())
+          .target_id(),
+      target_data_.target_id());
+}
+
+TEST_F(LevelDbCacheSnapshotTest, ExportsEmptyCache) {
+  ASSERT_TRUE(source_->ExportCacheSnapshot(file_).ok());
+  ASSERT_TRUE(destination_->ImportCacheSnapshot(file_).ok());
+
+  EXPECT_EQ(destination_->target_cache()->size(), 0u);
+}
+
+TEST_F(LevelDbCacheSnapshotTest, RefusesToImportIntoNonEmptyCache) {
+  PopulateSource();
+  ASSERT_TRUE(source_->ExportCacheSnapshot(file_).ok());
+
+  MutableDocument other = Doc("other/doc", 1, Map());
+  destination_->Run("Add document", [&] {
+    destination_->remote_document_cache()->Add(other, other.version());
+  });
+
+  Status status = destination_->ImportCacheSnapshot(file_);
+  EXPECT_EQ(status.code(), Error::kErrorFailedPrecondition);
+  destination_->Run("Verify", [&] {
+    EXPECT_FALSE(destination_->remote_document_cache()
+                     ->Get(doc_a_.key())
+                     .is_found_document());
+  });
+}
+
+TEST_F(LevelDbCacheSnapshotTest, RejectsCorruptSnapshot) {
+  PopulateSource();
+  ASSERT_TRUE(source_->ExportCacheSnapshot(file_).ok());
+
+  CorruptSnapshot();
+
+  Status status = destination_->ImportCacheSnapshot(file_);
+  EXPECT_EQ(status.code(), Error::kErrorDataLoss);
+
+  // Nothing of the snapshot is left behind.
+  destination_->Run("Verify", [&] {
+    EXPECT_FALSE(destination_->remote_document_cache()
+                     ->Get(doc_a_.key())
+                     .is_found_document());
+    EXPECT_EQ(destination_->target_cache()->GetTarget(target_data_.target()),
+              absl::nullopt);
+  });
+  EXPECT_EQ(destination_->target_cache()->size(), 0u);
+}
+
+TEST_F(LevelDbCacheSnapshotTest, RejectsCorruptSnapshotAfterWritingBatches) {
+  // Large enough for the import to write several batches.
+  PopulateSource();
+  source_->Run("Add large documents", [&] {
+    for (int i = 0; i < 6; ++i) {
+      MutableDocument doc = Doc("large/" + std::to_string(i), 1,
+                                Map("value", std::string(1024 * 1024, 'x')));
+      source_->remote_document_cache()->Add(doc, doc.version());
+    }
+  });
+  ASSERT_TRUE(source_->ExportCacheSnapshot(file_).ok());
+
+  // Flips a bit of the checksum of the last table, the target metadata.
+  {
+    std::fstream file{file_.native_value(),
+                      std::ios::in | std::ios::out | std::ios::binary};
+    file.seekg(-2, std::ios::end);
+    char byte = static_cast<char>(file.get());
+    file.seekp(-2, std::ios::end);
+    file.put(static_cast<char>(byte ^ 0x01));
+  }
+
+  Status status = destination_->ImportCacheSnapshot(file_);
+  EXPECT_EQ(status.code(), Error::kErrorDataLoss);
+
+  // Neither the collection parent index nor the target metadata, which can't
+  // be cleared, were written.
+  destination_->Run("Verify", [&] {
+    EXPECT_FALSE(destination_->remote_document_cache()
+                     ->Get(doc_a_.key())
+                     .is_found_document());
+    EXPECT_TRUE(
+        destination_->index_manager()->GetCollectionParents("coll").empty());
+  });
+  destination_->target_cache()->Start();
+  EXPECT_EQ(destination_->target_cache()->highest_target_id(), 0);
+}
+
+TEST_F(LevelDbCacheSnapshotTest, RejectsOtherFiles) {
+  std::ofstream file{file_.native_value()};
+  file << "{\"metadata\": {}}";
+  file.close();
+
+  Status status = destination_->ImportCacheSnapshot(file_);
+  EXPECT_EQ(status.code(), Error::kErrorDataLoss);
+}
+
+TEST_F(LevelDbCacheSnapshotTest, FailsOnMissingFile) {
+  Status status = destination_->ImportCacheSnapshot(file_);
+  EXPECT_EQ(status.code(), Error::kErrorNotFound);
+}
+
+}  // namespace local
+}  // namespace firestore
+}  // namespace firebase
@@ -46,6 +46,13 @@ std::string DocMutationKey(absl::string_view user_id,
   return LevelDbDocumentMutationKey::Key(user_id, testutil::Key(key), batch_id);
 }
 
+std::string CollectionMutationKey(absl::string_view user_id,
+                                  absl::string_view key,
+                                  model::BatchId batch_id) {
+  return LevelDbCollectionMutationKey::Key(user_id, testutil::Key(key),
+                                           batch_id);
+}
+
 std::string TargetDocKey(TargetId target_id, absl::string_view key) {
   return LevelDbTargetDocumentKey::Key(target_id, testutil::Key(key));
 }
@@ -222,6 +229,96 @@ TEST(LevelDbDocumentMutationKeyTest, Description) {
       "[document_mutation: user_id=user1 path=foo/bar batch_id=42]", key);
 }
 
+TEST(LevelDbCollectionMutationKeyTest, Prefixing) {
+  auto table_key = LevelDbCollectionMutationKey::KeyPrefix();
+  auto foo_user_key = LevelDbCollectionMutationKey::KeyPrefix("foo");
+  auto foo_collection_key = LevelDbCollectionMutationKey::KeyPrefix(
+      "foo", testutil::Resource("foo"));
+  auto food_collection_key = LevelDbCollectionMutationKey::KeyPrefix(
+      "foo", testutil::Resource("food"));
+
+  auto foo_bar_key =
+      LevelDbCollectionMutationKey::Key("foo", testutil::Key("foo/bar"), 2);
+  auto food_bar_key =
+      LevelDbCollectionMutationKey::Key("foo", testutil::Key("food/bar"), 2);
+
+  ASSERT_TRUE(absl::StartsWith(foo_user_key, table_key));
+  ASSERT_TRUE(absl::StartsWith(foo_collection_key, foo_user_key));
+
+  ASSERT_TRUE(absl::StartsWith(foo_bar_key, foo_collection_key));
+  ASSERT_TRUE(absl::StartsWith(food_bar_key, food_collection_key));
+
+  // Partial segments in common must not be prefixes.
+  ASSERT_FALSE(absl::StartsWith(food_bar_key, foo_collection_key));
+}
+
+TEST(LevelDbCollectionMutationKeyTest, EncodeDecodeCycle) {
+  LevelDbCollectionMutationKey key;
+  std::string user("foo");
+
+  std::vector<DocumentKey> document_keys{testutil::Key("a/b"),
+                                         testutil::Key("a/b/c/d")};
+
+  std::vector<BatchId> batch_ids{0, 1, 100, INT_MAX - 1, INT_MAX};
+
+  for (BatchId batch_id : batch_ids) {
+    for (auto&& document_key : document_keys) {
+      auto encoded =
+          LevelDbCollectionMutationKey::Key(user, document_key, batch_id);
+
+      bool ok = key.Decode(encoded);
+      ASSERT_TRUE(ok);
+      ASSERT_EQ(user, key.user_id());
+      ASSERT_EQ(document_key.path().PopLast(), key.collection_path());
+      ASSERT_EQ(document_key.path().last_segment(), key.document_id());
+      ASSERT_EQ(batch_id, key.batch_id());
+    }
+  }
+}
+
+TEST(LevelDbCollectionMutationKeyTest, Ordering) {
+  // Different user:
+  ASSERT_LT(CollectionMutationKey("1", "foo/bar", 0),
+            CollectionMutationKey("2", "foo/bar", 0));
+
+  // Different documents in the same collection:
+  ASSERT_LT(CollectionMutationKey("1", "foo/bar", 0),
+            CollectionMutationKey("1", "foo/baz", 0));
+
+  // Immediate children sort before documents in any subcollection, even when
+  // the document ID sorts after the subcollection's parent:
+  ASSERT_LT(CollectionMutationKey("1", "foo/zzz", 0),
+            CollectionMutationKey("1", "foo/bar/suffix/key", 0));
+  ASSERT_LT(CollectionMutationKey("1", "foo/bar/suffix/key", 0),
+            CollectionMutationKey("1", "foo2/bar", 0));
+
+  // Different batch_id:
+  ASSERT_LT(CollectionMutationKey("1", "foo/bar", 0),
+            CollectionMutationKey("1", "foo/bar", 1));
+}
+
+TEST(LevelDbCollectionMutationKeyTest, Description) {
+  AssertExpectedKeyDescription("[collection_mutation: incomplete key]",
+                               LevelDbCollectionMutationKey::KeyPrefix());
+
+  AssertExpectedKeyDescription(
+      "[collection_mutation: user_id=user1 incomplete key]",
+      LevelDbCollectionMutationKey::KeyPrefix("user1"));
+
+  auto key = LevelDbCollectionMutationKey::KeyPrefix(
+      "user1", testutil::Resource("foo/bar/baz"));
+  AssertExpectedKeyDescription(
+      "[collection_mutation: user_id=user1 path=foo/bar/baz incomplete key]",
+      key);
+
+  key = LevelDbCollectionMutationKey::Key("user1", testutil::Key("foo/bar"),
+                                          42);
+  AssertExpectedKeyDescription(
+      "[collection_mutation: user_id=user1 path=foo document_id=bar "
+      "batch_id=42]",
+      key);
+}
+
 TEST(LevelDbTargetGlobalKeyTest, EncodeDecodeCycle) {
   LevelDbTargetGlobalKey key;
 
@@ -18,7 +18,9 @@
 
 #include <map>
 #include <memory>
+#include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "Firestore/Protos/nanopb/firestore/local/mutation.nanopb.h"
@@ -467,6 +469,210 @@ TEST_F(LevelDbMigrationsTest, CreateCollectionParentsIndex) {
   }
 }
 
+TEST_F(LevelDbMigrationsTest, CreateCollectionMutationsIndex) {
+  // This test creates a database with schema version 7 that has a few
+  // document-mutation index rows and a stale collection-mutation row, and then
+  // ensures that the collection_mutations index mirrors the former.
+  std::vector<std::pair<std::string, BatchId>> writes{
+      {"foo/bar", 1}, {"foo/baz", 2}, {"foo/bar/sub/doc", 2}, {"qux/a", 3}};
+
+  std::string empty_buffer;
+  LevelDbMigrations::RunMigrations(db_.get(), 7, *serializer_);
+  {
+    LevelDbTransaction transaction(db_.get(), "Write Mutations");
+    // We "cheat" and only write the DbDocumentMutation index entries, since
+    // that's all the migration uses.
+    for (const auto& write : writes) {
+      transaction.Put(
+          LevelDbDocumentMutationKey::Key(
+              "user", DocumentKey::FromPathString(write.first), write.second),
+          empty_buffer);
+    }
+
+    // A row left behind by an older client that removed batch 4 without
+    // maintaining the index.
+    transaction.Put(LevelDbCollectionMutationKey::Key(
+                        "user", DocumentKey::FromPathString("foo/old"), 4),
+                    empty_buffer);
+
+    transaction.Commit();
+  }
+
+  LevelDbMigrations::RunMigrations(db_.get(), 8, *serializer_);
+  {
+    LevelDbTransaction transaction(db_.get(), "Verify");
+
+    std::vector<std::pair<std::string, BatchId>> actual;
+    auto index_iterator = transaction.NewIterator();
+    std::string index_prefix = LevelDbCollectionMutationKey::KeyPrefix("user");
+    LevelDbCollectionMutationKey row_key;
+    for (index_iterator->Seek(index_prefix); index_iterator->Valid();
+         index_iterator->Next()) {
+      if (!absl::StartsWith(index_iterator->key(), index_prefix) ||
+          !row_key.Decode(index_iterator->key()))
+        break;
+
+      actual.emplace_back(
+          row_key.collection_path().Append(row_key.document_id())
+              .CanonicalString(),
+          row_key.batch_id());
+    }
+
+    // Immediate children of "foo" sort before its subcollections.
+    std::vector<std::pair<std::string, BatchId>> expected{
+        {"foo/bar", 1}, {"foo/baz", 2}, {"foo/bar/sub/doc", 2}, {"qux/a", 3}};
+    ASSERT_EQ(actual, expected);
+  }
+}
+
+TEST_F(LevelDbMigrationsTest, AddsSentinelRowsInBatches) {
+  LevelDbMigrations::RunMigrations(db_.get(), 3, *serializer_);
+  {
+    std::string empty_buffer;
+    LevelDbTransaction transaction(db_.get(), "Setup");
+    for (int i = 0; i < 10; i++) {
+      DocumentKey key = DocumentKey::FromSegments({"docs", std::to_string(i)});
+      transaction.Put(LevelDbRemoteDocumentKey::Key(key), empty_buffer);
+    }
+    transaction.Commit();
+  }
+
+  std::vector<int64_t> progress;
+  LevelDbMigrations::RunMigrations(
+      db_.get(), 4, *serializer_,
+      [&](const LevelDbMigrations::Progress& p) {
+        ASSERT_EQ(p.version, 4);
+        progress.push_back(p.rows_processed);
+      },
+      /*batch_size=*/3);
+
+  ASSERT_EQ(progress, (std::vector<int64_t>{3, 6, 9, 10}));
+  ASSERT_EQ(LevelDbMigrations::ReadSchemaVersion(db_.get()), 4);
+
+  LevelDbTransaction transaction(db_.get(), "Verify");
+  std::string buffer;
+  Status status = transaction.Get(LevelDbMigrationProgressKey::Key(), &buffer);
+  ASSERT_TRUE(status.IsNotFound());
+  for (int i = 0; i < 10; i++) {
+    DocumentKey key = DocumentKey::FromSegments({"docs", std::to_string(i)});
+    ASSERT_TRUE(
+        transaction.Get(LevelDbDocumentTargetKey::SentinelKey(key), &buffer)
+            .ok());
+  }
+}
+
+TEST_F(LevelDbMigrationsTest, ResumesInterruptedMigration) {
+  std::vector<std::string> paths{"a/1", "a/2", "b/1", "b/2", "c/1"};
+
+  std::string empty_buffer;
+  LevelDbMigrations::RunMigrations(db_.get(), 7, *serializer_);
+  {
+    LevelDbTransaction transaction(db_.get(), "Write Mutations");
+    for (const std::string& path : paths) {
+      transaction.Put(LevelDbDocumentMutationKey::Key(
+                          "user", DocumentKey::FromPathString(path), 1),
+                      empty_buffer);
+    }
+    transaction.Put(LevelDbCollectionMutationKey::Key(
+                        "user", DocumentKey::FromPathString("a/old"), 2),
+                    empty_buffer);
+    transaction.Commit();
+  }
+
+  // Simulates the app being killed after the first batch has been committed.
+  auto interrupt = [](const LevelDbMigrations::Progress&) {
+    throw std::runtime_error("interrupted");
+  };
+  EXPECT_THROW(LevelDbMigrations::RunMigrations(db_.get(), 8, *serializer_,
+                                                interrupt, /*batch_size=*/2),
+               std::runtime_error);
+  ASSERT_EQ(LevelDbMigrations::ReadSchemaVersion(db_.get()), 7);
+
+  std::vector<int64_t> progress;
+  LevelDbMigrations::RunMigrations(
+      db_.get(), 8, *serializer_,
+      [&](const LevelDbMigrations::Progress& p) {
+        progress.push_back(p.rows_processed);
+      },
+      /*batch_size=*/2);
+
+  // The second run starts after the two rows of the first batch.
+  ASSERT_EQ(progress, (std::vector<int64_t>{4, 5}));
+  ASSERT_EQ(LevelDbMigrations::ReadSchemaVersion(db_.get()), 8);
+
+  LevelDbTransaction transaction(db_.get(), "Verify");
+  std::vector<std::string> actual;
+  auto it = transaction.NewIterator();
+  std::string index_prefix = LevelDbCollectionMutationKey::KeyPrefix("user");
+  LevelDbCollectionMutationKey row_key;
+  for (it->Seek(index_prefix);
+       it->Valid() && absl::StartsWith(it->key(), index_prefix); it->Next()) {
+    ASSERT_TRUE(row_key.Decode(it->key()));
+    actual.push_back(row_key.collection_path()
+                         .Append(row_key.document_id())
+                         .CanonicalString());
+  }
+  ASSERT_EQ(actual, paths);
+}
+
+TEST_F(LevelDbMigrationsTest, RestartsInterruptedMigrationIfRowsChanged) {
+  std::vector<std::string> paths{"a/1", "a/2", "b/1", "b/2", "c/1"};
+
+  std::string empty_buffer;
+  LevelDbMigrations::RunMigrations(db_.get(), 7, *serializer_);
+  {
+    LevelDbTransaction transaction(db_.get(), "Write Mutations");
+    for (const std::string& path : paths) {
+      transaction.Put(LevelDbDocumentMutationKey::Key(
+                          "user", DocumentKey::FromPathString(path), 1),
+                      empty_buffer);
+    }
+    transaction.Commit();
+  }
+
+  auto interrupt = [](const LevelDbMigrations::Progress&) {
+    throw std::runtime_error("interrupted");
+  };
+  EXPECT_THROW(LevelDbMigrations::RunMigrations(db_.get(), 8, *serializer_,
+                                                interrupt, /*batch_size=*/2),
+               std::runtime_error);
+
+  // A client at schema version 7 removes a batch that has already been
+  // indexed, without maintaining the collection_mutations index.
+  {
+    LevelDbTransaction transaction(db_.get(), "Remove Mutation");
+    transaction.Delete(LevelDbDocumentMutationKey::Key(
+        "user", DocumentKey::FromPathString("a/1"), 1));
+    transaction.Commit();
+  }
+
+  std::vector<int64_t> progress;
+  LevelDbMigrations::RunMigrations(
+      db_.get(), 8, *serializer_,
+      [&](const LevelDbMigrations::Progress& p) {
+        progress.push_back(p.rows_processed);
+      },
+      /*batch_size=*/2);
+
+  // The second run starts over from the first row.
+  ASSERT_EQ(progress, (std::vector<int64_t>{2, 4}));
+  ASSERT_EQ(LevelDbMigrations::ReadSchemaVersion(db_.get()), 8);
+
+  LevelDbTransaction transaction(db_.get(), "Verify");
+  std::vector<std::string> actual;
+  auto it = transaction.NewIterator();
+  std::string index_prefix = LevelDbCollectionMutationKey::KeyPrefix("user");
+  LevelDbCollectionMutationKey row_key;
+  for (it->Seek(index_prefix);
+       it->Valid() && absl::StartsWith(it->key(), index_prefix); it->Next()) {
+    ASSERT_TRUE(row_key.Decode(it->key()));
+    actual.push_back(row_key.collection_path()
+                         .Append(row_key.document_id())
+                         .CanonicalString());
+  }
+  ASSERT_EQ(actual, (std::vector<std::string>{"a/2", "b/1", "b/2", "c/1"}));
+}
+
 TEST_F(LevelDbMigrationsTest, RewritesCanonicalIds) {
   LevelDbMigrations::RunMigrations(db_.get(), 6, *serializer_);
   auto query = Query("collection").AddingFilter(Filter("foo", "==", "bar"));
@@ -0,0 +1,99 @@
+/*
+ * Copyright 2021 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Firestore/core/include/firebase/firestore/timestamp.h"
+#include "Firestore/core/src/core/query.h"
+#include "Firestore/core/src/credentials/user.h"
+#include "Firestore/core/src/local/leveldb_persistence.h"
+#include "Firestore/core/src/local/mutation_queue.h"
+#include "Firestore/core/src/model/mutation_batch.h"
+#include "Firestore/core/src/model/set_mutation.h"
+#include "Firestore/core/test/unit/local/persistence_testing.h"
+#include "Firestore/core/test/unit/testutil/testutil.h"
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+using firebase::Timestamp;
+using firebase::firestore::credentials::User;
+using firebase::firestore::local::LevelDbPersistence;
+using firebase::firestore::local::LevelDbPersistenceForTesting;
+using firebase::firestore::local::MutationQueue;
+using firebase::firestore::model::MutationBatch;
+using firebase::firestore::testutil::Map;
+using firebase::firestore::testutil::Query;
+using firebase::firestore::testutil::SetMutation;
+
+namespace {
+
+const int kImmediateChildren = 10;
+
+/**
+ * Populates the mutation queue with one batch per document: a fixed number of
+ * immediate children of "rooms" and, below each of those, a chain of nested
+ * subcollections `depth` levels deep, each holding `fanout` documents.
+ */
+void AddHierarchy(MutationQueue* queue, int64_t depth, int64_t fanout) {
+  for (int i = 0; i < kImmediateChildren; ++i) {
+    std::string parent = absl::StrCat("rooms/r", i);
+    queue->AddMutationBatch(Timestamp::Now(), {},
+                            {SetMutation(parent, Map("a", 1))});
+
+    for (int64_t level = 0; level < depth; ++level) {
+      for (int64_t j = 0; j < fanout; ++j) {
+        std::string path = absl::StrCat(parent, "/messages/m", j);
+        queue->AddMutationBatch(Timestamp::Now(), {},
+                                {SetMutation(path, Map("a", 1))});
+      }
+      parent = absl::StrCat(parent, "/messages/m0");
+    }
+  }
+}
+
+}  // namespace
+
+static void BM_AllMutationBatchesAffectingQuery(benchmark::State& state) {
+  int64_t depth = state.range(0);
+  int64_t fanout = state.range(1);
+
+  std::unique_ptr<LevelDbPersistence> persistence =
+      LevelDbPersistenceForTesting();
+  MutationQueue* queue = persistence->GetMutationQueueForUser(User("user"));
+  persistence->Run("Populate", [&] {
+    queue->Start();
+    AddHierarchy(queue, depth, fanout);
+  });
+
+  auto query = Query("rooms");
+  for (auto _ : state) {
+    persistence->Run("AllMutationBatchesAffectingQuery", [&] {
+      std::vector<MutationBatch> batches =
+          queue->AllMutationBatchesAffectingQuery(query);
+      benchmark::DoNotOptimize(batches);
+    });
+  }
+  state.SetItemsProcessed(state.iterations() * kImmediateChildren);
+}
+BENCHMARK(BM_AllMutationBatchesAffectingQuery)
+    ->Args({0, 0})
+    ->Args({1, 10})
+    ->Args({4, 10})
+    ->Args({4, 100})
+    ->Args({16, 10})
+    ->Args({16, 100});
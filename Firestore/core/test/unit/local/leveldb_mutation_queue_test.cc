@@ -16,6 +16,7 @@
 
 #include "Firestore/core/src/local/leveldb_mutation_queue.h"
 
+#include <set>
 #include <string>
 #include <vector>
 
@@ -25,6 +26,7 @@
 #include "Firestore/core/src/local/leveldb_key.h"
 #include "Firestore/core/src/local/leveldb_persistence.h"
 #include "Firestore/core/src/local/reference_set.h"
+#include "Firestore/core/src/model/mutation_batch.h"
 #include "Firestore/core/src/nanopb/byte_string.h"
 #include "Firestore/core/src/nanopb/message.h"
 #include "Firestore/core/src/nanopb/reader.h"
@@ -48,6 +50,7 @@ using leveldb::Slice;
 using leveldb::Status;
 using leveldb::WriteOptions;
 using model::BatchId;
+using model::MutationBatch;
 using nanopb::ByteString;
 using nanopb::Message;
 using nanopb::StringReader;
@@ -182,6 +185,48 @@ TEST_F(LevelDbMutationQueueTest, EmptyProtoCanBeUpgraded) {
             ByteString(default_message->last_stream_token));
 }
 
+TEST_F(LevelDbMutationQueueTest, LoadsNextBatchIdOnFirstWrite) {
+  persistence_->Run("Write", [&] { CreateBatches(2); });
+
+  // A restarted queue doesn't know the next batch ID until it's needed.
+  mutation_queue_ = persistence_->GetMutationQueueForUser(User("user"));
+  persistence_->Run("Start", [&] { mutation_queue_->Start(); });
+
+  persistence_->Run("Write again", [&] {
+    ASSERT_EQ(AddMutationBatch().batch_id(), 3);
+  });
+}
+
+TEST_F(LevelDbMutationQueueTest, DoesNotReuseBatchIdsRemovedBeforeFirstWrite) {
+  persistence_->Run("Write", [&] { CreateBatches(2); });
+
+  mutation_queue_ = persistence_->GetMutationQueueForUser(User("user"));
+  persistence_->Run("Start", [&] { mutation_queue_->Start(); });
+
+  // The batches are acknowledged and removed before the first local write.
+  persistence_->Run("Remove", [&] {
+    std::vector<MutationBatch> batches = mutation_queue_->AllMutationBatches();
+    ASSERT_EQ(batches.size(), 2u);
+    RemoveFirstBatches(2, &batches);
+  });
+
+  persistence_->Run("Write again", [&] {
+    ASSERT_EQ(AddMutationBatch().batch_id(), 3);
+  });
+}
+
+TEST_F(LevelDbMutationQueueTest, LoadsUsersOnFirstUse) {
+  auto* persistence = static_cast<LevelDbPersistence*>(persistence_.get());
+
+  // The queue of the fixture's user has no rows yet.
+  SetDummyValueForKey(LevelDbMutationKey::Key("other", 3));
+  ASSERT_EQ(persistence->users(), (std::set<std::string>{"other", "user"}));
+
+  persistence->GetMutationQueueForUser(User("third"));
+  ASSERT_EQ(persistence->users(),
+            (std::set<std::string>{"other", "third", "user"}));
+}
+
 void LevelDbMutationQueueTest::SetDummyValueForKey(const std::string& key) {
   db_->Put(WriteOptions(), key, kDummy);
 }
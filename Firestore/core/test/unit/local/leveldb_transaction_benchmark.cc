@@ -0,0 +1,141 @@
+/*
+ * Copyright 2021 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdlib>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "Firestore/core/src/local/leveldb_transaction.h"
+#include "Firestore/core/src/util/path.h"
+#include "Firestore/core/test/unit/local/persistence_testing.h"
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+#include "leveldb/db.h"
+
+// Counts every call to the global allocator, so that benchmarks can report the
+// number of allocations made by the code under test.
+static std::atomic<int64_t> allocations{0};
+
+void* operator new(size_t size) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  void* result = std::malloc(size == 0 ? 1 : size);
+  if (!result) throw std::bad_alloc();
+  return result;
+}
+
+void operator delete(void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+  std::free(ptr);
+}
+
+namespace firebase {
+namespace firestore {
+namespace local {
+namespace {
+
+std::unique_ptr<leveldb::DB> OpenDb() {
+  leveldb::Options options;
+  options.create_if_missing = true;
+
+  leveldb::DB* db = nullptr;
+  leveldb::Status status =
+      leveldb::DB::Open(options, LevelDbDir().ToUtf8String(), &db);
+  if (!status.ok()) abort();
+  return std::unique_ptr<leveldb::DB>(db);
+}
+
+/**
+ * The rows written by a remote event that updates documents in one target:
+ * the document and its read time, plus the rows that tie it to the target.
+ */
+struct RemoteEventRows {
+  explicit RemoteEventRows(int64_t documents) {
+    for (int64_t i = 0; i < documents; ++i) {
+      document_keys.push_back(absl::StrCat("remote_document/rooms/doc", i));
+      index_keys.push_back(
+          absl::StrCat("remote_document_read_time/rooms/doc", i));
+      index_keys.push_back(absl::StrCat("target_document/2/rooms/doc", i));
+      index_keys.push_back(absl::StrCat("document_target/rooms/doc", i, "/2"));
+    }
+  }
+
+  std::vector<std::string> document_keys;
+  std::vector<std::string> index_keys;
+  std::string contents = std::string(200, 'x');
+};
+
+/**
+ * Buffers the writes of a remote event and reads each document back, as the
+ * local store does while applying the event.
+ */
+void BufferRemoteEvent(LevelDbTransaction* transaction,
+                       const RemoteEventRows& rows) {
+  for (const std::string& key : rows.index_keys) {
+    transaction->Put(key, "");
+  }
+  std::string value;
+  for (const std::string& key : rows.document_keys) {
+    transaction->Put(key, rows.contents);
+    transaction->Get(key, &value);
+  }
+}
+
+void BM_BufferWrites(benchmark::State& state) {
+  std::unique_ptr<leveldb::DB> db = OpenDb();
+  int64_t documents = state.range(0);
+  RemoteEventRows rows(documents);
+
+  int64_t total_allocations = 0;
+  for (auto _ : state) {
+    int64_t before = allocations.load(std::memory_order_relaxed);
+    {
+      LevelDbTransaction transaction(db.get(), "BufferWrites");
+      BufferRemoteEvent(&transaction, rows);
+    }
+    total_allocations += allocations.load(std::memory_order_relaxed) - before;
+  }
+
+  state.SetItemsProcessed(state.iterations() * documents);
+  state.counters["allocs_per_doc"] = static_cast<double>(total_allocations) /
+                                     (state.iterations() * documents);
+}
+BENCHMARK(BM_BufferWrites)->Arg(100)->Arg(1000)->Arg(10000);
+
+void BM_BufferAndCommitWrites(benchmark::State& state) {
+  std::unique_ptr<leveldb::DB> db = OpenDb();
+  int64_t documents = state.range(0);
+  RemoteEventRows rows(documents);
+
+  for (auto _ : state) {
+    LevelDbTransaction transaction(db.get(), "BufferAndCommitWrites");
+    BufferRemoteEvent(&transaction, rows);
+    transaction.Commit();
+  }
+  state.SetItemsProcessed(state.iterations() * documents);
+}
+BENCHMARK(BM_BufferAndCommitWrites)->Arg(100)->Arg(1000)->Arg(10000);
+
+}  // namespace
+}  // namespace local
+}  // namespace firestore
+}  // namespace firebase
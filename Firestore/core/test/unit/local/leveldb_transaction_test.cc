@@ -18,6 +18,8 @@
 
 #include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "Firestore/Protos/nanopb/firestore/local/mutation.nanopb.h"
 #include "Firestore/Protos/nanopb/firestore/local/target.nanopb.h"
@@ -290,6 +292,84 @@ TEST_F(LevelDbTransactionTest, DeletingAheadOfAnIterator) {
   ASSERT_FALSE(it->Valid());
 }
 
+TEST_F(LevelDbTransactionTest, IteratesOverMergedChangesInKeyOrder) {
+  for (const char* key : {"key_1", "key_3", "key_5"}) {
+    Status status = db_->Put(LevelDbTransaction::DefaultWriteOptions(), key,
+                             "committed");
+    ASSERT_TRUE(status.ok());
+  }
+
+  LevelDbTransaction transaction(db_.get(),
+                                 "IteratesOverMergedChangesInKeyOrder");
+  transaction.Put("key_0", "first");
+  transaction.Put("key_0", "second");
+  transaction.Delete("key_1");
+  transaction.Delete("key_2");
+  transaction.Put("key_3", "changed");
+  transaction.Put("key_4", "deleted");
+  transaction.Delete("key_4");
+  ASSERT_EQ(5, transaction.changed_keys());
+
+  std::string value;
+  ASSERT_TRUE(transaction.Get("key_0", &value).ok());
+  ASSERT_EQ("second", value);
+  ASSERT_TRUE(transaction.Get("key_4", &value).IsNotFound());
+
+  std::vector<std::pair<std::string, std::string>> entries;
+  auto it = transaction.NewIterator();
+  for (it->Seek("key_0"); it->Valid(); it->Next()) {
+    entries.emplace_back(it->key(), it->value());
+  }
+  std::vector<std::pair<std::string, std::string>> expected = {
+      {"key_0", "second"}, {"key_3", "changed"}, {"key_5", "committed"}};
+  ASSERT_EQ(expected, entries);
+
+  transaction.Commit();
+  ASSERT_TRUE(db_->Get(ReadOptions(), "key_1", &value).IsNotFound());
+  ASSERT_TRUE(db_->Get(ReadOptions(), "key_3", &value).ok());
+  ASSERT_EQ("changed", value);
+}
+
+TEST_F(LevelDbTransactionTest, ReadOnlyTransactionReadsItsSnapshot) {
+  const WriteOptions& write_options = LevelDbTransaction::DefaultWriteOptions();
+  ASSERT_TRUE(db_->Put(write_options, "key_1", "before").ok());
+
+  const leveldb::Snapshot* snapshot = db_->GetSnapshot();
+  {
+    LevelDbTransaction writer(db_.get(), "Writer");
+    writer.Put("key_1", "after");
+    writer.Put("key_2", "added");
+    writer.Commit();
+  }
+
+  {
+    LevelDbTransaction reader(db_.get(), "Reader", snapshot);
+    std::string value;
+    ASSERT_TRUE(reader.Get("key_1", &value).ok());
+    ASSERT_EQ("before", value);
+    ASSERT_TRUE(reader.Get("key_2", &value).IsNotFound());
+
+    auto it = reader.NewIterator();
+    it->Seek("key_");
+    ASSERT_TRUE(it->Valid());
+    ASSERT_EQ("key_1", it->key());
+    it->Next();
+    ASSERT_FALSE(it->Valid());
+  }
+  db_->ReleaseSnapshot(snapshot);
+}
+
+TEST_F(LevelDbTransactionTest, CommitReturnsBytesWritten) {
+  {
+    LevelDbTransaction transaction(db_.get(), "Empty");
+    ASSERT_EQ(0, transaction.Commit());
+  }
+
+  LevelDbTransaction transaction(db_.get(), "NotEmpty");
+  transaction.Put("key", std::string(100, 'x'));
+  ASSERT_GT(transaction.Commit(), 100);
+}
+
 TEST_F(LevelDbTransactionTest, ToString) {
   std::string key = LevelDbMutationKey::Key("user1", 42);
   Message<firestore_client_WriteBatch> message;
@@ -0,0 +1,180 @@
+/*
+ * Copyright 2021 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Firestore/core/src/local/local_reader.h"
+
+#include <memory>
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+#include "Firestore/core/src/bundle/bundled_query.h"
+#include "Firestore/core/src/bundle/named_query.h"
+#include "Firestore/core/src/credentials/user.h"
+#include "Firestore/core/src/local/leveldb_persistence.h"
+#include "Firestore/core/src/local/leveldb_transaction.h"
+#include "Firestore/core/src/local/local_store.h"
+#include "Firestore/core/src/local/local_write_result.h"
+#include "Firestore/core/src/local/memory_persistence.h"
+#include "Firestore/core/src/local/query_engine.h"
+#include "Firestore/core/src/local/query_result.h"
+#include "Firestore/core/src/local/remote_document_cache.h"
+#include "Firestore/core/src/model/delete_mutation.h"
+#include "Firestore/core/src/model/document.h"
+#include "Firestore/core/src/model/mutable_document.h"
+#include "Firestore/core/src/model/patch_mutation.h"
+#include "Firestore/core/src/model/set_mutation.h"
+#include "Firestore/core/test/unit/local/persistence_testing.h"
+#include "Firestore/core/test/unit/testutil/testutil.h"
+#include "gtest/gtest.h"
+
+namespace firebase {
+namespace firestore {
+namespace local {
+namespace {
+
+using bundle::BundledQuery;
+using bundle::NamedQuery;
+using credentials::User;
+using model::Document;
+using model::DocumentKey;
+using model::DocumentKeySet;
+using model::DocumentMap;
+using model::MutableDocument;
+
+using testutil::Doc;
+using testutil::Key;
+using testutil::Map;
+using testutil::Version;
+
+class LocalReaderTest : public testing::Test {
+ public:
+  LocalReaderTest()
+      : persistence_(LevelDbPersistenceForTesting()),
+        local_store_(persistence_.get(),
+                     &query_engine_,
+                     User::Unauthenticated()),
+        doc_a_(Doc("coll/a", 1, Map("a", 1))),
+        doc_b_(Doc("coll/b", 2, Map("b", 2))) {
+    local_store_.Start();
+    reader_ = LocalReader::Create(persistence_.get(), User::Unauthenticated());
+  }
+
+  void AddToRemoteDocumentCache(const MutableDocument& doc) {
+    persistence_->Run("AddToRemoteDocumentCache", [&] {
+      persistence_->remote_document_cache()->Add(doc, doc.version());
+    });
+  }
+
+ protected:
+  std::unique_ptr<LevelDbPersistence> persistence_;
+  QueryEngine query_engine_;
+  LocalStore local_store_;
+  std::shared_ptr<LocalReader> reader_;
+
+  MutableDocument doc_a_;
+  MutableDocument doc_b_;
+};
+
+TEST_F(LocalReaderTest, ReadsTheLocalViewOfDocuments) {
+  ASSERT_NE(reader_, nullptr);
+  AddToRemoteDocumentCache(doc_a_);
+  AddToRemoteDocumentCache(doc_b_);
+  local_store_.WriteLocally({testutil::PatchMutation("coll/a", Map("c", 3)),
+                             testutil::SetMutation("coll/c", Map("c", 3))});
+
+  Document expected_a{
+      Doc("coll/a", 1, Map("a", 1, "c", 3)).SetHasLocalMutations()};
+  EXPECT_EQ(reader_->ReadDocument(Key("coll/a")), expected_a);
+
+  DocumentMap documents = reader_->ReadDocuments(
+      DocumentKeySet{Key("coll/a"), Key("coll/b"), Key("coll/c")});
+  EXPECT_EQ(documents.size(), 3u);
+  EXPECT_EQ(documents.get(Key("coll/a")), expected_a);
+  EXPECT_EQ(documents.get(Key("coll/b")), Document{doc_b_});
+  EXPECT_EQ(documents.get(Key("coll/c")),
+            Document{Doc("coll/c", 0, Map("c", 3)).SetHasLocalMutations()});
+}
+
+TEST_F(LocalReaderTest, ExecutesQueries) {
+  AddToRemoteDocumentCache(doc_a_);
+  AddToRemoteDocumentCache(doc_b_);
+  local_store_.WriteLocally({testutil::DeleteMutation("coll/b"),
+                             testutil::SetMutation("coll/c", Map("c", 3))});
+
+  QueryResult result = reader_->ExecuteQuery(testutil::Query("coll"));
+
+  std::vector<DocumentKey> keys;
+  for (const auto& entry : result.documents()) {
+    keys.push_back(entry.first);
+  }
+  EXPECT_EQ(keys, (std::vector<DocumentKey>{Key("coll/a"), Key("coll/c")}));
+}
+
+TEST_F(LocalReaderTest, ReadsNamedQueries) {
+  NamedQuery named_query(
+      "query-1",
+      BundledQuery(testutil::Query("coll").ToTarget(), core::LimitType::First),
+      Version(1000));
+  local_store_.SaveNamedQuery(named_query, DocumentKeySet{});
+
+  EXPECT_EQ(reader_->GetNamedQuery("query-1"), named_query);
+  EXPECT_EQ(reader_->GetNamedQuery("query-2"), absl::nullopt);
+}
+
+TEST_F(LocalReaderTest, UsesTheReadOnlyTransactionOfItsThread) {
+  persistence_->Run("Write", [&] {
+    LevelDbTransaction* read_write = persistence_->current_transaction();
+    LevelDbTransaction* read_only = nullptr;
+
+    std::thread reader([&] {
+      persistence_->RunReadOnly("Read", [&] {
+        read_only = persistence_->current_transaction();
+      });
+    });
+    reader.join();
+
+    EXPECT_NE(read_only, nullptr);
+    EXPECT_NE(read_only, read_write);
+    EXPECT_EQ(persistence_->current_transaction(), read_write);
+  });
+}
+
+TEST_F(LocalReaderTest, ReadsConcurrentlyWithAWrite) {
+  Document during_write;
+  persistence_->Run("Write", [&] {
+    persistence_->remote_document_cache()->Add(doc_a_, doc_a_.version());
+
+    // The write isn't committed yet, so it isn't visible to the reader.
+    std::thread reader(
+        [&] { during_write = reader_->ReadDocument(doc_a_.key()); });
+    reader.join();
+  });
+
+  EXPECT_FALSE(during_write->is_found_document());
+  EXPECT_EQ(reader_->ReadDocument(doc_a_.key()), Document{doc_a_});
+}
+
+TEST_F(LocalReaderTest, IsNotCreatedForMemoryPersistence) {
+  std::unique_ptr<MemoryPersistence> persistence =
+      MemoryPersistenceWithEagerGcForTesting();
+  EXPECT_EQ(LocalReader::Create(persistence.get(), User::Unauthenticated()),
+            nullptr);
+}
+
+}  // namespace
+}  // namespace local
+}  // namespace firestore
+}  // namespace firebase
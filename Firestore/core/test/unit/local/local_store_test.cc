@@ -56,6 +56,7 @@ using model::Document;
 using model::DocumentKey;
 using model::DocumentKeySet;
 using model::DocumentMap;
+using model::DocumentUpdateMap;
 using model::ListenSequenceNumber;
 using model::MutableDocument;
 using model::MutableDocumentMap;
@@ -85,6 +86,7 @@ using testutil::Map;
 using testutil::Query;
 using testutil::UnknownDoc;
 using testutil::Value;
+using testutil::Version;
 using testutil::Vector;
 
 std::vector<Document> DocMapToVector(const DocumentMap& docs) {
@@ -292,6 +294,15 @@ void LocalStoreTest::ApplyBundledDocuments(
       local_store_.ApplyBundledDocuments(DocVectorToMap(documents), "");
 }
 
+void LocalStoreTest::ApplyDocumentLookup(
+    const std::vector<MutableDocument>& docs) {
+  DocumentUpdateMap document_updates;
+  for (const MutableDocument& doc : docs) {
+    document_updates.emplace(doc.key(), doc);
+  }
+  last_changes_ = local_store_.ApplyDocumentLookup(document_updates);
+}
+
 void LocalStoreTest::ResetPersistenceStats() {
   query_engine_.ResetCounts();
 }
@@ -1011,6 +1022,69 @@ TEST_P(LocalStoreTest, CanExecuteMixedCollectionQueries) {
           Document{Doc("foo/bonk", 0, Map("a", "b")).SetHasLocalMutations()}));
 }
 
+TEST_P(LocalStoreTest, CanReadCollectionQueriesInPages) {
+  core::Query query = Query("foo");
+  AllocateQuery(query);
+  FSTAssertTargetID(2);
+
+  for (const char* path : {"foo/a", "foo/b", "foo/c", "foo/d"}) {
+    ApplyRemoteEvent(UpdateRemoteEvent(Doc(path, 10, Map("a", "b")), {2}, {}));
+  }
+  local_store_.WriteLocally({testutil::SetMutation("foo/bb", Map("a", "b")),
+                             testutil::PatchMutation("foo/c", Map("c", "d")),
+                             testutil::DeleteMutation("foo/d"),
+                             testutil::SetMutation("foo/e", Map("a", "b"))});
+
+  local::DocumentPage page =
+      local_store_.ReadDocumentsPage(query, DocumentKey{}, 2);
+  ASSERT_EQ(page.documents,
+            Vector(Document{Doc("foo/a", 10, Map("a", "b"))},
+                   Document{Doc("foo/b", 10, Map("a", "b"))}));
+  ASSERT_TRUE(page.has_more);
+
+  // Local writes in the range of a page are merged into it.
+  page = local_store_.ReadDocumentsPage(query, page.last_key, 2);
+  ASSERT_EQ(page.documents,
+            Vector(Document{Doc("foo/bb", 0, Map("a", "b"))
+                                .SetHasLocalMutations()},
+                   Document{Doc("foo/c", 10, Map("a", "b", "c", "d"))
+                                .SetHasLocalMutations()}));
+  ASSERT_TRUE(page.has_more);
+
+  page = local_store_.ReadDocumentsPage(query, page.last_key, 2);
+  ASSERT_EQ(page.documents,
+            Vector(Document{
+                Doc("foo/e", 0, Map("a", "b")).SetHasLocalMutations()}));
+  ASSERT_FALSE(page.has_more);
+}
+
+TEST_P(LocalStoreTest, CanExecuteMixedCollectionGroupQueries) {
+  core::Query query = testutil::CollectionGroupQuery("bar");
+  AllocateQuery(query);
+  FSTAssertTargetID(2);
+
+  ApplyRemoteEvent(
+      UpdateRemoteEvent(Doc("a/1/bar/x", 10, Map("a", "b")), {2}, {}));
+  ApplyRemoteEvent(
+      UpdateRemoteEvent(Doc("b/2/bar/y", 20, Map("a", "b")), {2}, {}));
+  ApplyRemoteEvent(UpdateRemoteEvent(Doc("bar/z", 30, Map("a", "b")), {2}, {}));
+
+  local_store_.WriteLocally(
+      {testutil::SetMutation("a/1/bar/w", Map("a", "b")),
+       testutil::SetMutation("a/1/baz/v", Map("a", "b")),
+       testutil::PatchMutation("b/2/bar/y", Map("c", "d"))});
+
+  QueryResult query_result = ExecuteQuery(query);
+  ASSERT_EQ(
+      DocMapToVector(query_result.documents()),
+      Vector(
+          Document{Doc("a/1/bar/w", 0, Map("a", "b")).SetHasLocalMutations()},
+          Document{Doc("a/1/bar/x", 10, Map("a", "b"))},
+          Document{Doc("b/2/bar/y", 20, Map("a", "b", "c", "d"))
+                       .SetHasLocalMutations()},
+          Document{Doc("bar/z", 30, Map("a", "b"))}));
+}
+
 TEST_P(LocalStoreTest, ReadsAllDocumentsForInitialCollectionQueries) {
   core::Query query = Query("foo");
   local_store_.AllocateTarget(query.ToTarget());
@@ -1493,6 +1567,55 @@ TEST_P(LocalStoreTest,
   FSTAssertQueryDocumentMapping(4, expected_keys);
 }
 
+TEST_P(LocalStoreTest, HandlesDocumentLookup) {
+  core::Query query = Query("foo");
+  AllocateQuery(query);
+  FSTAssertTargetID(2);
+
+  ApplyRemoteEvent(AddedRemoteEvent(Doc("foo/bar", 2, Map("val", "old")), {2}));
+  FSTAssertContains(Doc("foo/bar", 2, Map("val", "old")));
+
+  ApplyDocumentLookup({Doc("foo/bar", 1, Map("val", "stale")),
+                       Doc("foo/baz", 3, Map("val", "new")),
+                       DeletedDoc("foo/gone", 4)});
+  FSTAssertChanged(Doc("foo/baz", 3, Map("val", "new")),
+                   DeletedDoc("foo/gone", 4));
+  FSTAssertContains(Doc("foo/bar", 2, Map("val", "old")));
+  FSTAssertContains(Doc("foo/baz", 3, Map("val", "new")));
+  FSTAssertContains(DeletedDoc("foo/gone", 4));
+
+  // Lookups are not part of a watch snapshot.
+  EXPECT_EQ(local_store_.GetLastRemoteSnapshotVersion(), Version(2));
+}
+
+TEST_P(LocalStoreTest, ReadsDocuments) {
+  WriteMutation(testutil::SetMutation("foo/bar", Map("foo", "bar")));
+
+  DocumentKeySet keys{Key("foo/bar"), Key("foo/baz")};
+  DocumentMap docs = local_store_.ReadDocuments(keys);
+  EXPECT_EQ(*docs.get(Key("foo/bar")),
+            Doc("foo/bar", 0, Map("foo", "bar")).SetHasLocalMutations());
+  EXPECT_FALSE((*docs.get(Key("foo/baz")))->is_valid_document());
+}
+
+TEST_P(LocalStoreTest, GetsLocalViewOfLookedUpDocuments) {
+  WriteMutation(testutil::PatchMutation("foo/bar", Map("val", "local"), {}));
+
+  MutableDocumentMap looked_up;
+  looked_up = looked_up.insert(
+      Key("foo/bar"), Doc("foo/bar", 1, Map("val", "remote", "other", 1)));
+  looked_up = looked_up.insert(Key("foo/baz"), DeletedDoc("foo/baz", 1));
+
+  DocumentMap docs = local_store_.GetLocalViewOfDocuments(looked_up);
+  EXPECT_EQ(*docs.get(Key("foo/bar")),
+            Doc("foo/bar", 1, Map("val", "local", "other", 1))
+                .SetHasLocalMutations());
+  EXPECT_EQ(*docs.get(Key("foo/baz")), DeletedDoc("foo/baz", 1));
+
+  // The documents are neither read from nor written to the cache.
+  FSTAssertNotContains("foo/baz");
+}
+
 TEST_P(LocalStoreTest,
        HandlesMergeMutationWithTransformationThenBundledDocuments) {
   core::Query query = Query("foo");
@@ -1624,6 +1747,53 @@ TEST_P(LocalStoreTest, GetHighestUnacknowledgeBatchId) {
   ASSERT_EQ(-1, local_store_.GetHighestUnacknowledgedBatchId());
 }
 
+TEST_P(LocalStoreTest, CoalescesWritesIntoUnsentBatch) {
+  WriteMutation(testutil::SetMutation("foo/bar", Map("a", 1)));
+
+  LocalWriteResult result = local_store_.WriteLocally(
+      {testutil::PatchMutation("foo/bar", Map("b", 2))},
+      /*coalesce_after=*/model::kBatchIdUnknown);
+  EXPECT_EQ(result.batch_id(), 1);
+  EXPECT_EQ(local_store_.GetHighestUnacknowledgedBatchId(), 1);
+  FSTAssertContains(
+      Doc("foo/bar", 0, Map("a", 1, "b", 2)).SetHasLocalMutations());
+
+  absl::optional<MutationBatch> batch =
+      local_store_.GetNextMutationBatch(model::kBatchIdUnknown);
+  ASSERT_TRUE(batch);
+  EXPECT_EQ(batch->mutations(),
+            std::vector<Mutation>{
+                testutil::SetMutation("foo/bar", Map("a", 1, "b", 2))});
+}
+
+TEST_P(LocalStoreTest, DoesNotCoalesceWritesIntoSentBatch) {
+  WriteMutation(testutil::SetMutation("foo/bar", Map("a", 1)));
+
+  LocalWriteResult result = local_store_.WriteLocally(
+      {testutil::PatchMutation("foo/bar", Map("b", 2))},
+      /*coalesce_after=*/1);
+  EXPECT_EQ(result.batch_id(), 2);
+  EXPECT_EQ(local_store_.GetHighestUnacknowledgedBatchId(), 2);
+  FSTAssertContains(
+      Doc("foo/bar", 0, Map("a", 1, "b", 2)).SetHasLocalMutations());
+}
+
+TEST_P(LocalStoreTest, DoesNotCoalesceWritesIntoBatchesFromBeforeStart) {
+  WriteMutation(testutil::SetMutation("foo/bar", Map("a", 1)));
+
+  // Switching users restarts the mutation queue. An earlier instance could
+  // have sent the batch before a restart, too.
+  local_store_.HandleUserChange(User("other"));
+  local_store_.HandleUserChange(User::Unauthenticated());
+
+  LocalWriteResult result = local_store_.WriteLocally(
+      {testutil::PatchMutation("foo/bar", Map("b", 2))},
+      /*coalesce_after=*/model::kBatchIdUnknown);
+  EXPECT_EQ(result.batch_id(), 2);
+  FSTAssertContains(
+      Doc("foo/bar", 0, Map("a", 1, "b", 2)).SetHasLocalMutations());
+}
+
 TEST_P(LocalStoreTest, OnlyPersistsUpdatesForDocumentsWhenVersionChanges) {
   core::Query query = Query("foo");
   AllocateQuery(query);
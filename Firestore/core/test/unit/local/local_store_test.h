@@ -96,6 +96,7 @@ class LocalStoreTest : public ::testing::TestWithParam<FactoryFunc> {
   local::QueryResult ExecuteQuery(const core::Query& query);
   void ApplyBundledDocuments(
       const std::vector<model::MutableDocument>& documents);
+  void ApplyDocumentLookup(const std::vector<model::MutableDocument>& docs);
 
   /**
    * Applies the `from_cache` state to the given target via a synthesized
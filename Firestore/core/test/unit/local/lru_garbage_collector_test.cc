@@ -764,6 +764,31 @@ TEST_P(LruGarbageCollectorTest, GCRan) {
   ASSERT_EQ(100, results.documents_removed);
 }
 
+TEST_P(LruGarbageCollectorTest, CollectsProportionallyToExcess) {
+  LruParams params = LruParams::Default();
+  // A cache far over this threshold is collected in larger passes.
+  params.min_bytes_threshold = 100;
+  NewTestResources(params);
+
+  for (int i = 0; i < 100; i++) {
+    persistence_->Run("Add a target and some documents", [&] {
+      TargetData target_data = AddNextQueryInTransaction();
+      for (int j = 0; j < 10; j++) {
+        MutableDocument doc = CacheADocumentInTransaction();
+        AddDocument(doc.key(), target_data.target_id());
+      }
+    });
+  }
+
+  LruResults results = persistence_->Run(
+      "GC", [&] { return gc_->CollectProportionally({}); });
+
+  // The pass is capped at half of the sequence numbers.
+  ASSERT_TRUE(results.did_run);
+  ASSERT_EQ(50, results.targets_removed);
+  ASSERT_EQ(500, results.documents_removed);
+}
+
 }  // namespace local
 }  // namespace firestore
 }  // namespace firebase
@@ -28,6 +28,7 @@
 #include "Firestore/core/src/model/mutation.h"
 #include "Firestore/core/src/model/mutation_batch.h"
 #include "Firestore/core/src/model/patch_mutation.h"
+#include "Firestore/core/src/model/resource_path.h"
 #include "Firestore/core/src/model/set_mutation.h"
 #include "Firestore/core/src/nanopb/byte_string.h"
 #include "Firestore/core/test/unit/testutil/testutil.h"
@@ -43,6 +44,7 @@ using model::DocumentKeySet;
 using model::kBatchIdUnknown;
 using model::Mutation;
 using model::MutationBatch;
+using model::ResourcePath;
 using model::SetMutation;
 using nanopb::ByteString;
 using testutil::Key;
@@ -340,6 +342,77 @@ TEST_P(MutationQueueTest, AllMutationBatchesAffectingQuery) {
   });
 }
 
+TEST_P(MutationQueueTest, AllMutationBatchesAffectingQueryIgnoresDescendants) {
+  persistence_->Run(
+      "AllMutationBatchesAffectingQueryIgnoresDescendants", [&] {
+        std::vector<Mutation> mutations = {
+            testutil::SetMutation("foo/bar/foo/bar", Map("a", 1)),
+            testutil::SetMutation("foo/bar/baz/qux/foo/bar", Map("a", 1)),
+            testutil::SetMutation("foo/zzz", Map("a", 1)),
+            testutil::SetMutation("foo/bar/baz/qux", Map("a", 1)),
+            testutil::SetMutation("foo/aaa", Map("a", 1)),
+        };
+
+        std::vector<MutationBatch> batches;
+        for (const Mutation& mutation : mutations) {
+          MutationBatch batch = mutation_queue_->AddMutationBatch(
+              Timestamp::Now(), {}, {mutation});
+          batches.push_back(batch);
+        }
+
+        std::vector<MutationBatch> expected = {batches[2], batches[4]};
+        EXPECT_EQ(mutation_queue_->AllMutationBatchesAffectingQuery(
+                      Query("foo")),
+                  expected);
+
+        expected = {batches[0]};
+        EXPECT_EQ(mutation_queue_->AllMutationBatchesAffectingQuery(
+                      Query("foo/bar/foo")),
+                  expected);
+
+        expected = {batches[3]};
+        EXPECT_EQ(mutation_queue_->AllMutationBatchesAffectingQuery(
+                      Query("foo/bar/baz")),
+                  expected);
+
+        mutation_queue_->RemoveMutationBatch(batches[2]);
+        expected = {batches[4]};
+        EXPECT_EQ(mutation_queue_->AllMutationBatchesAffectingQuery(
+                      Query("foo")),
+                  expected);
+      });
+}
+
+TEST_P(MutationQueueTest, AllMutationBatchesAffectingCollections) {
+  persistence_->Run("AllMutationBatchesAffectingCollections", [&] {
+    std::vector<Mutation> mutations = {
+        testutil::SetMutation("a/1/group/x", Map("a", 1)),
+        testutil::SetMutation("b/2/group/y", Map("a", 1)),
+        testutil::SetMutation("a/1/group/x/group/z", Map("a", 1)),
+        testutil::SetMutation("a/1/other/x", Map("a", 1)),
+        testutil::SetMutation("group/w", Map("a", 1)),
+    };
+
+    std::vector<MutationBatch> batches;
+    for (const Mutation& mutation : mutations) {
+      MutationBatch batch =
+          mutation_queue_->AddMutationBatch(Timestamp::Now(), {}, {mutation});
+      batches.push_back(batch);
+    }
+
+    std::vector<ResourcePath> collections = {
+        ResourcePath::FromString("b/2/group"),
+        ResourcePath::FromString("a/1/group"),
+    };
+    std::vector<MutationBatch> expected = {batches[0], batches[1]};
+    EXPECT_EQ(
+        mutation_queue_->AllMutationBatchesAffectingCollections(collections),
+        expected);
+    EXPECT_EQ(mutation_queue_->AllMutationBatchesAffectingCollections({}),
+              std::vector<MutationBatch>{});
+  });
+}
+
 TEST_P(MutationQueueTest, RemoveMutationBatches) {
   persistence_->Run("RemoveMutationBatches", [&] {
     std::vector<MutationBatch> batches = CreateBatches(10);
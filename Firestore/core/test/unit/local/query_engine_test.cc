@@ -26,6 +26,7 @@
 #include "Firestore/core/src/local/memory_index_manager.h"
 #include "Firestore/core/src/local/memory_persistence.h"
 #include "Firestore/core/src/local/persistence.h"
+#include "Firestore/core/src/local/query_profile.h"
 #include "Firestore/core/src/local/remote_document_cache.h"
 #include "Firestore/core/src/local/target_cache.h"
 #include "Firestore/core/src/model/document_key_set.h"
@@ -378,6 +379,71 @@ TEST_F(QueryEngineTest,
                     Doc("coll/b", 1, Map("order", 3))}));
 }
 
+TEST_F(QueryEngineTest, ProfilesIndexFreeExecution) {
+  core::Query query = Query("coll").AddingFilter(Filter("matches", "==", true));
+
+  AddDocuments({kMatchingDocA, kMatchingDocB});
+  PersistQueryMapping({kMatchingDocA.key(), kMatchingDocB.key()});
+
+  QueryProfile profile;
+  {
+    ScopedQueryProfile scope(&profile);
+    ExpectOptimizedCollectionScan(
+        [&] { return RunQuery(query, kLastLimboFreeSnapshot); });
+  }
+
+  EXPECT_EQ(profile.strategy, QueryStrategy::IndexFree);
+  // Both previous results are read by key, and no document changed since.
+  EXPECT_EQ(profile.documents_scanned, 2);
+  EXPECT_EQ(profile.documents_decoded, 0);
+  EXPECT_EQ(profile.mutation_batches_applied, 0);
+}
+
+TEST_F(QueryEngineTest, ProfilesReasonForFullCollectionScan) {
+  core::Query query = Query("coll")
+                          .AddingFilter(Filter("matches", "==", true))
+                          .WithLimitToFirst(1);
+
+  AddDocuments({kNonMatchingDocA});
+  PersistQueryMapping({kMatchingDocA.key()});
+  AddDocuments({kMatchingDocB});
+
+  QueryProfile profile;
+  {
+    ScopedQueryProfile scope(&profile);
+    ExpectFullCollectionScan(
+        [&] { return RunQuery(query, kLastLimboFreeSnapshot); });
+  }
+  EXPECT_EQ(profile.strategy, QueryStrategy::FullScanNeedsRefill);
+  // The previous result, then both documents of the collection.
+  EXPECT_EQ(profile.documents_scanned, 3);
+
+  profile = QueryProfile();
+  {
+    ScopedQueryProfile scope(&profile);
+    ExpectFullCollectionScan(
+        [&] { return RunQuery(query, kMissingLastLimboFreeSnapshot); });
+  }
+  EXPECT_EQ(profile.strategy, QueryStrategy::FullScanWithoutLimboFreeSnapshot);
+  EXPECT_EQ(profile.documents_scanned, 2);
+}
+
+TEST_F(QueryEngineTest, DoesNotProfileWithoutScope) {
+  core::Query query = Query("coll");
+  AddDocuments({kMatchingDocA});
+
+  QueryProfile profile;
+  {
+    ScopedQueryProfile scope(&profile);
+    EXPECT_EQ(QueryProfile::Current(), &profile);
+  }
+  EXPECT_EQ(QueryProfile::Current(), nullptr);
+
+  ExpectFullCollectionScan(
+      [&] { return RunQuery(query, kLastLimboFreeSnapshot); });
+  EXPECT_EQ(profile.documents_scanned, 0);
+}
+
 }  // namespace local
 }  // namespace firestore
 }  // namespace firebase
@@ -59,6 +59,7 @@ using testutil::Field;
 using testutil::Key;
 using testutil::Map;
 using testutil::Query;
+using testutil::Resource;
 using testutil::Value;
 using testutil::Version;
 
@@ -210,6 +211,57 @@ TEST_P(RemoteDocumentCacheTest, DocumentsMatchingQuery) {
   });
 }
 
+TEST_P(RemoteDocumentCacheTest, GetPage) {
+  persistence_->Run("test_get_page", [&] {
+    SetTestDocument("a/1");
+    SetTestDocument("b/1");
+    SetTestDocument("b/1/z/1");
+    SetTestDocument("b/2");
+    SetTestDocument("b/3");
+    SetTestDocument("c/1");
+
+    MutableDocumentMap results =
+        cache_->GetPage(Resource("b"), DocumentKey{}, 2);
+    std::vector<MutableDocument> docs = {
+        Doc("b/1", kVersion, Map("a", 1, "b", 2)),
+        Doc("b/2", kVersion, Map("a", 1, "b", 2)),
+    };
+    EXPECT_THAT(results, HasExactlyDocs(docs));
+
+    results = cache_->GetPage(Resource("b"), Key("b/2"), 2);
+    docs = {Doc("b/3", kVersion, Map("a", 1, "b", 2))};
+    EXPECT_THAT(results, HasExactlyDocs(docs));
+
+    results = cache_->GetPage(Resource("b"), Key("b/3"), 2);
+    EXPECT_TRUE(results.empty());
+  });
+}
+
+TEST_P(RemoteDocumentCacheTest, GetPageSkipsRemovedAndDeletedDocuments) {
+  persistence_->Run("test_get_page_skips_removed_and_deleted_documents", [&] {
+    SetTestDocument("b/1");
+    SetTestDocument("b/2");
+    SetTestDocument("b/3");
+    SetTestDocument("b/4");
+    absl::optional<MutableDocument> deleted_doc = DeletedDoc("b/2", kVersion);
+    cache_->Add(*deleted_doc, deleted_doc->version());
+    cache_->Remove(Key("b/3"));
+    SetTestDocument("b/1");
+
+    MutableDocumentMap results =
+        cache_->GetPage(Resource("b"), DocumentKey{}, 2);
+    std::vector<MutableDocument> docs = {
+        Doc("b/1", kVersion, Map("a", 1, "b", 2)),
+        Doc("b/4", kVersion, Map("a", 1, "b", 2)),
+    };
+    EXPECT_THAT(results, HasExactlyDocs(docs));
+
+    results = cache_->GetPage(Resource("b"), Key("b/1"), 2);
+    docs = {Doc("b/4", kVersion, Map("a", 1, "b", 2))};
+    EXPECT_THAT(results, HasExactlyDocs(docs));
+  });
+}
+
 TEST_P(RemoteDocumentCacheTest, DocumentsMatchingQuerySinceReadTime) {
   persistence_->Run("test_documents_matching_query_since_read_time", [&] {
     SetTestDocument("b/old", /* updateTime= */ 1, /* readTime= */ 11);
@@ -240,6 +292,59 @@ TEST_P(RemoteDocumentCacheTest, DocumentsMatchingUsesReadTimeNotUpdateTime) {
       });
 }
 
+TEST_P(RemoteDocumentCacheTest, DocumentsMatchingQueryUsesLatestReadTime) {
+  persistence_->Run("test_documents_matching_query_uses_latest_read_time", [&] {
+    SetTestDocument("b/updated", /* updateTime= */ 1, /* readTime= */ 11);
+    SetTestDocument("b/unchanged", /* updateTime= */ 2, /* readTime= */ 12);
+    SetTestDocument("b/removed", /* updateTime= */ 3, /* readTime= */ 13);
+    SetTestDocument("b/updated", /* updateTime= */ 4, /* readTime= */ 14);
+    cache_->Remove(Key("b/removed"));
+
+    core::Query query = Query("b");
+    MutableDocumentMap results = cache_->GetMatching(query, Version(12));
+    std::vector<MutableDocument> docs = {
+        Doc("b/updated", 4, Map("a", 1, "b", 2)),
+    };
+    EXPECT_THAT(results, HasExactlyDocs(docs));
+  });
+}
+
+TEST_P(RemoteDocumentCacheTest, DocumentsMatchingCollectionGroupQuery) {
+  persistence_->Run("test_documents_matching_collection_group_query", [&] {
+    SetTestDocument("a/1/c/1");
+    SetTestDocument("a/1/c/2", /* updateTime= */ 1, /* readTime= */ 11);
+    SetTestDocument("a/1/d/1");
+    SetTestDocument("a/2/c/1/c/1");
+    SetTestDocument("c/1");
+
+    core::Query query = testutil::CollectionGroupQuery("c");
+    std::vector<model::ResourcePath> collections = {
+        model::ResourcePath::FromString("a/1/c"),
+        model::ResourcePath::FromString("a/3/c"),
+        model::ResourcePath::FromString("c"),
+    };
+    std::vector<MutableDocumentMap> results =
+        cache_->GetMatchingCollectionGroup(query, collections,
+                                           SnapshotVersion::None());
+    ASSERT_EQ(results.size(), 3u);
+    EXPECT_THAT(results[0], HasExactlyDocs(std::vector<MutableDocument>{
+                                Doc("a/1/c/1", kVersion, Map("a", 1, "b", 2)),
+                                Doc("a/1/c/2", 1, Map("a", 1, "b", 2)),
+                            }));
+    EXPECT_TRUE(results[1].empty());
+    EXPECT_THAT(results[2], HasExactlyDocs(std::vector<MutableDocument>{
+                                Doc("c/1", kVersion, Map("a", 1, "b", 2)),
+                            }));
+
+    results =
+        cache_->GetMatchingCollectionGroup(query, collections, Version(11));
+    ASSERT_EQ(results.size(), 3u);
+    EXPECT_THAT(results[0], HasExactlyDocs(std::vector<MutableDocument>{
+                                Doc("a/1/c/1", kVersion, Map("a", 1, "b", 2)),
+                            }));
+  });
+}
+
 TEST_P(RemoteDocumentCacheTest, DoesNotApplyDocumentModificationsToCache) {
   // This test verifies that the MemoryMutationCache returns copies of all
   // data to ensure that the documents in the cache cannot be modified.
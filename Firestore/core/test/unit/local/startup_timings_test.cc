@@ -0,0 +1,74 @@
+/*
+ * Copyright 2021 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Firestore/core/src/local/startup_timings.h"
+
+#include <chrono>  // NOLINT(build/c++11)
+#include <thread>  // NOLINT(build/c++11)
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace firebase {
+namespace firestore {
+namespace local {
+namespace {
+
+using testing::HasSubstr;
+
+TEST(StartupTimingsTest, RecordsPhasesInOrder) {
+  StartupTimings timings;
+  std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  timings.EndPhase("open");
+  timings.EndPhase("migrations");
+
+  ASSERT_EQ(timings.phases().size(), 2u);
+  EXPECT_EQ(timings.phases()[0].name, "open");
+  EXPECT_EQ(timings.phases()[1].name, "migrations");
+  EXPECT_GE(timings.phases()[0].duration, std::chrono::milliseconds(2));
+  EXPECT_EQ(timings.total(),
+            timings.phases()[0].duration + timings.phases()[1].duration);
+}
+
+TEST(StartupTimingsTest, AppendsPrefixedPhases) {
+  StartupTimings inner;
+  inner.EndPhase("open");
+  inner.EndPhase("migrations");
+
+  StartupTimings outer;
+  outer.Append("persistence ", inner);
+  outer.EndPhase("local store");
+
+  ASSERT_EQ(outer.phases().size(), 3u);
+  EXPECT_EQ(outer.phases()[0].name, "persistence open");
+  EXPECT_EQ(outer.phases()[1].name, "persistence migrations");
+  EXPECT_EQ(outer.phases()[2].name, "local store");
+}
+
+TEST(StartupTimingsTest, Describes) {
+  StartupTimings timings;
+  EXPECT_EQ(timings.ToString(), "");
+
+  timings.EndPhase("open");
+  timings.EndPhase("migrations");
+  EXPECT_THAT(timings.ToString(), HasSubstr("open: "));
+  EXPECT_THAT(timings.ToString(), HasSubstr("ms, migrations: "));
+}
+
+}  // namespace
+}  // namespace local
+}  // namespace firestore
+}  // namespace firebase
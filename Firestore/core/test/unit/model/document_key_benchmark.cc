@@ -0,0 +1,137 @@
+/*
+ * Copyright 2021 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "Firestore/core/src/model/document_key.h"
+#include "Firestore/core/src/model/resource_path.h"
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+#if defined(__APPLE__)
+#include <malloc/malloc.h>  // NOLINT(build/include)
+#elif defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+namespace firebase {
+namespace firestore {
+namespace model {
+namespace {
+
+const int kKeys = 100000;
+
+/**
+ * Returns the number of bytes currently allocated by the process, or 0 if the
+ * platform doesn't report it.
+ */
+size_t AllocatedBytes() {
+#if defined(__APPLE__)
+  malloc_statistics_t stats{};
+  malloc_zone_statistics(nullptr, &stats);
+  return stats.size_in_use;
+#elif defined(__GLIBC__) && \
+    (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+  return mallinfo2().uordblks;
+#else
+  return 0;
+#endif
+}
+
+/**
+ * Returns the path of the i-th document, spread over a few collections that
+ * are nested `depth` levels deep.
+ */
+ResourcePath MakePath(int64_t depth, int i) {
+  std::vector<std::string> segments;
+  for (int64_t level = 0; level < depth; ++level) {
+    segments.push_back(absl::StrCat("collection", level));
+    segments.push_back(absl::StrCat("parent", i % 10));
+  }
+  segments.back() = absl::StrCat("document", i);
+  return ResourcePath(std::move(segments));
+}
+
+/**
+ * Reports the memory retained by `kKeys` document keys, next to the memory of
+ * the equivalent resource paths.
+ */
+void BM_KeyMemory(benchmark::State& state) {
+  size_t key_bytes = 0;
+  size_t path_bytes = 0;
+
+  for (auto _ : state) {
+    size_t before = AllocatedBytes();
+    std::vector<ResourcePath> paths;
+    paths.reserve(kKeys);
+    for (int i = 0; i < kKeys; ++i) {
+      paths.push_back(MakePath(state.range(0), i));
+    }
+    path_bytes = AllocatedBytes() - before;
+
+    before = AllocatedBytes();
+    std::vector<DocumentKey> keys;
+    keys.reserve(kKeys);
+    for (const ResourcePath& path : paths) {
+      keys.emplace_back(path);
+    }
+    key_bytes = AllocatedBytes() - before;
+    benchmark::DoNotOptimize(keys);
+  }
+  state.counters["bytes_per_key"] = static_cast<double>(key_bytes) / kKeys;
+  state.counters["bytes_per_path"] = static_cast<double>(path_bytes) / kKeys;
+}
+BENCHMARK(BM_KeyMemory)->Arg(1)->Arg(3);
+
+void BM_SortKeys(benchmark::State& state) {
+  std::vector<DocumentKey> keys;
+  keys.reserve(kKeys);
+  for (int i = 0; i < kKeys; ++i) {
+    keys.emplace_back(MakePath(state.range(0), i));
+  }
+
+  for (auto _ : state) {
+    std::vector<DocumentKey> sorted = keys;
+    std::sort(sorted.begin(), sorted.end());
+    benchmark::DoNotOptimize(sorted);
+  }
+  state.SetItemsProcessed(state.iterations() * kKeys);
+}
+BENCHMARK(BM_SortKeys)->Arg(1)->Arg(3);
+
+void BM_CopyKeys(benchmark::State& state) {
+  std::vector<DocumentKey> keys;
+  keys.reserve(kKeys);
+  for (int i = 0; i < kKeys; ++i) {
+    keys.emplace_back(MakePath(state.range(0), i));
+  }
+
+  for (auto _ : state) {
+    std::vector<DocumentKey> copy = keys;
+    benchmark::DoNotOptimize(copy);
+  }
+  state.SetItemsProcessed(state.iterations() * kKeys);
+}
+BENCHMARK(BM_CopyKeys)->Arg(1)->Arg(3);
+
+}  // namespace
+}  // namespace model
+}  // namespace firestore
+}  // namespace firebase
@@ -155,6 +155,57 @@ TEST(DocumentKey, Comparison) {
   EXPECT_TRUE(ab >= a);
 }
 
+TEST(DocumentKey, CollectionPathAndDocumentId) {
+  DocumentKey key = Key("rooms/firestore/messages/1");
+  EXPECT_EQ(ResourcePath({"rooms", "firestore", "messages"}),
+            key.collection_path());
+  EXPECT_EQ("1", key.document_id());
+  EXPECT_EQ(key.path().PopLast(), key.collection_path());
+  EXPECT_EQ(key.path().last_segment(), key.document_id());
+
+  DocumentKey empty;
+  EXPECT_TRUE(empty.collection_path().empty());
+  EXPECT_EQ("", empty.document_id());
+}
+
+TEST(DocumentKey, SharesCollectionPaths) {
+  DocumentKey a = Key("rooms/a");
+  DocumentKey b = Key("rooms/b");
+  DocumentKey c = DocumentKey(ResourcePath{"rooms", "c"});
+  EXPECT_EQ(&a.collection_path(), &b.collection_path());
+  EXPECT_EQ(&a.collection_path(), &c.collection_path());
+  EXPECT_NE(&a.collection_path(), &Key("messages/a").collection_path());
+}
+
+TEST(DocumentKey, EqualityAndHashOfSeparatelyCreatedKeys) {
+  DocumentKey key = Key("rooms/firestore/messages/1");
+  DocumentKey same = DocumentKey::FromSegments({"rooms", "firestore",
+                                                "messages", "1"});
+  EXPECT_EQ(key, same);
+  EXPECT_EQ(key.Hash(), same.Hash());
+  EXPECT_EQ(DocumentKeyHash()(key), DocumentKeyHash()(same));
+
+  EXPECT_NE(key, Key("rooms/firestore/messages/2"));
+  EXPECT_NE(key, Key("rooms/firestore/message/1"));
+}
+
+TEST(DocumentKey, ComparisonAgreesWithPaths) {
+  std::vector<DocumentKey> keys = {
+      DocumentKey(),      Key("a/a"),         Key("a/a/b/a"),
+      Key("a/a/b/b"),     Key("a/a/b/b/c/c"), Key("a/ab"),
+      Key("a/b"),         Key("a/b/a/a"),     Key("a0/a"),
+      Key("aa/a"),        Key("b/a"),         Key("b/a/a/a"),
+      Key("b/b"),
+  };
+  for (const DocumentKey& lhs : keys) {
+    for (const DocumentKey& rhs : keys) {
+      EXPECT_EQ(lhs.path().CompareTo(rhs.path()), lhs.CompareTo(rhs))
+          << lhs << " vs " << rhs;
+      EXPECT_EQ(lhs.path() == rhs.path(), lhs == rhs) << lhs << " vs " << rhs;
+    }
+  }
+}
+
 TEST(DocumentKey, Comparator) {
   DocumentKey abcd = Key("a/b/c/d");
   DocumentKey xyzw = Key("x/y/z/w");
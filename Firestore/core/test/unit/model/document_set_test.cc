@@ -16,9 +16,11 @@
 
 #include "Firestore/core/src/model/document_set.h"
 
+#include <string>
 #include <vector>
 
 #include "Firestore/core/src/model/document.h"
+#include "Firestore/core/src/model/resource_path.h"
 #include "Firestore/core/src/util/delayed_constructor.h"
 #include "Firestore/core/test/unit/testutil/testutil.h"
 #include "gmock/gmock.h"
@@ -80,6 +82,31 @@ TEST_F(DocumentSetTest, KeepsDocumentsInTheRightOrder) {
   ASSERT_THAT(set, ElementsAre(doc3_, doc1_, doc2_));
 }
 
+TEST_F(DocumentSetTest, ComputesSortKeysOncePerDocument) {
+  int sort_keys = 0;
+  // Sorts in reverse order of the documents' IDs.
+  DocumentComparator comparator =
+      DocumentComparator::BySortKey([&sort_keys](const Document& doc) {
+        ++sort_keys;
+        return std::string(1, static_cast<char>(
+                                  '9' - doc->key().path().last_segment()[0]));
+      });
+
+  DocumentSet set = DocSet(comparator, {doc1_, doc2_, doc3_});
+  EXPECT_EQ(sort_keys, 3);
+  EXPECT_THAT(set, ElementsAre(doc3_, doc2_, doc1_));
+
+  // Documents in the set are looked up by the key they carry.
+  EXPECT_EQ(set.IndexOf(doc1_->key()), 2u);
+  set = set.erase(doc2_->key());
+  EXPECT_EQ(sort_keys, 3);
+  EXPECT_THAT(set, ElementsAre(doc3_, doc1_));
+
+  // Documents that don't carry their key are encoded when compared.
+  EXPECT_TRUE(util::Ascending(comparator.Compare(doc2_, doc1_)));
+  EXPECT_EQ(sort_keys, 5);
+}
+
 TEST_F(DocumentSetTest, Deletes) {
   DocumentSet set = DocSet(comp_, {doc1_, doc2_, doc3_});
 
@@ -494,6 +494,83 @@ TEST(MutationTest, Transitions) {
   // TODO(rsgowman)
 }
 
+TEST(MutationTest, CoalescesPatchIntoSet) {
+  Mutation set = SetMutation("collection/key",
+                             Map("foo", "foo-value", "baz", "baz-value"));
+  Mutation patch = PatchMutation("collection/key", Map("foo.bar", "bar-value"));
+
+  absl::optional<Mutation> merged = CoalesceMutations(set, patch);
+  ASSERT_TRUE(merged);
+  EXPECT_EQ(*merged,
+            SetMutation("collection/key", Map("foo", Map("bar", "bar-value"),
+                                              "baz", "baz-value")));
+}
+
+TEST(MutationTest, CoalescesFieldDeletesIntoSet) {
+  Mutation set = SetMutation("collection/key",
+                             Map("foo", "foo-value", "baz", "baz-value"));
+  Mutation patch = MergeMutation("collection/key", Map(), {Field("foo")});
+
+  absl::optional<Mutation> merged = CoalesceMutations(set, patch);
+  ASSERT_TRUE(merged);
+  EXPECT_EQ(*merged, SetMutation("collection/key", Map("baz", "baz-value")));
+}
+
+TEST(MutationTest, CoalescesPatches) {
+  Mutation first =
+      PatchMutation("collection/key", Map("foo", "foo-value", "bar", "old"));
+  Mutation second = PatchMutation("collection/key", Map("bar.baz", "new"));
+
+  absl::optional<Mutation> merged = CoalesceMutations(first, second);
+  ASSERT_TRUE(merged);
+  EXPECT_EQ(*merged,
+            model::PatchMutation(
+                Key("collection/key"),
+                WrapObject("foo", "foo-value", "bar", Map("baz", "new")),
+                FieldMask{Field("foo"), Field("bar")},
+                Precondition::Exists(true)));
+}
+
+TEST(MutationTest, CoalescesPatchesOfNestedFields) {
+  Mutation first = PatchMutation("collection/key", Map("foo.bar", "old"));
+  Mutation second = PatchMutation("collection/key",
+                                  Map("foo.baz", "new", "foo.bar.qux", "new"));
+
+  absl::optional<Mutation> merged = CoalesceMutations(first, second);
+  ASSERT_TRUE(merged);
+  EXPECT_EQ(model::PatchMutation(*merged).mask(),
+            (FieldMask{Field("foo.bar"), Field("foo.baz")}));
+}
+
+TEST(MutationTest, CoalescesSetAfterWriteWithoutPrecondition) {
+  Mutation merge = MergeMutation("collection/key", Map("foo", "foo-value"),
+                                 {Field("foo")});
+  Mutation set = SetMutation("collection/key", Map("bar", "bar-value"));
+
+  absl::optional<Mutation> merged = CoalesceMutations(merge, set);
+  ASSERT_TRUE(merged);
+  EXPECT_EQ(*merged, set);
+}
+
+TEST(MutationTest, DoesNotCoalesceSetAfterUpdate) {
+  // The update fails if the document doesn't exist, while the set wouldn't.
+  Mutation patch = PatchMutation("collection/key", Map("foo", "foo-value"));
+  Mutation set = SetMutation("collection/key", Map("bar", "bar-value"));
+
+  EXPECT_FALSE(CoalesceMutations(patch, set));
+}
+
+TEST(MutationTest, DoesNotCoalesceOtherMutations) {
+  Mutation set = SetMutation("collection/key", Map("foo", "foo-value"));
+
+  EXPECT_FALSE(CoalesceMutations(
+      set, SetMutation("collection/other", Map("foo", "foo-value"))));
+  EXPECT_FALSE(CoalesceMutations(set, DeleteMutation("collection/key")));
+  EXPECT_FALSE(CoalesceMutations(
+      set, PatchMutation("collection/key", Map(),
+                         {testutil::Increment("sum", Value(1))})));
+}
+
 }  // namespace
 }  // namespace model
 }  // namespace firestore
@@ -0,0 +1,152 @@
+/*
+ * Copyright 2021 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Firestore/core/src/model/field_path.h"
+#include "Firestore/core/src/model/object_value.h"
+#include "Firestore/core/src/model/value_util.h"
+#include "Firestore/core/test/unit/testutil/testutil.h"
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+#if defined(__APPLE__)
+#include <malloc/malloc.h>  // NOLINT(build/include)
+#elif defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+namespace firebase {
+namespace firestore {
+namespace model {
+namespace {
+
+/** The number of versions kept by `BM_PatchHistory`. */
+const int kVersions = 100;
+
+/**
+ * Returns the number of bytes currently allocated by the process, or 0 if the
+ * platform doesn't report it.
+ */
+size_t AllocatedBytes() {
+#if defined(__APPLE__)
+  malloc_statistics_t stats{};
+  malloc_zone_statistics(nullptr, &stats);
+  return stats.size_in_use;
+#elif defined(__GLIBC__) && \
+    (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+  return mallinfo2().uordblks;
+#else
+  return 0;
+#endif
+}
+
+FieldPath FieldName(int64_t i) {
+  return testutil::Field(absl::StrCat("field", i));
+}
+
+/** Creates an object with `field_count` string fields. */
+ObjectValue MakeObject(int64_t field_count) {
+  ObjectValue result;
+  for (int64_t i = 0; i < field_count; ++i) {
+    result.Set(FieldName(i), testutil::Value(absl::StrCat("value", i)));
+  }
+  return result;
+}
+
+/** Copies an object and modifies one field, like applying a patch mutation. */
+void BM_CopyAndPatch(benchmark::State& state) {
+  ObjectValue base = MakeObject(state.range(0));
+
+  int64_t i = 0;
+  for (auto _ : state) {
+    ObjectValue patched = base;
+    patched.Set(FieldName(i % state.range(0)), testutil::Value(i));
+    benchmark::DoNotOptimize(patched);
+    ++i;
+  }
+}
+BENCHMARK(BM_CopyAndPatch)->Arg(10)->Arg(200)->Arg(1000);
+
+/** The same as `BM_CopyAndPatch`, with a deep copy of the object. */
+void BM_DeepCopyAndPatch(benchmark::State& state) {
+  ObjectValue base = MakeObject(state.range(0));
+
+  int64_t i = 0;
+  for (auto _ : state) {
+    ObjectValue patched{DeepClone(base.Get())};
+    patched.Set(FieldName(i % state.range(0)), testutil::Value(i));
+    benchmark::DoNotOptimize(patched);
+    ++i;
+  }
+}
+BENCHMARK(BM_DeepCopyAndPatch)->Arg(10)->Arg(200)->Arg(1000);
+
+/**
+ * Applies a chain of patches and keeps every version, like the overlays of a
+ * document with many pending writes, and reports the memory they retain.
+ */
+void BM_PatchHistory(benchmark::State& state) {
+  ObjectValue base = MakeObject(state.range(0));
+  size_t retained_bytes = 0;
+
+  for (auto _ : state) {
+    size_t before = AllocatedBytes();
+    std::vector<ObjectValue> versions;
+    versions.reserve(kVersions);
+    versions.push_back(base);
+    for (int64_t i = 1; i < kVersions; ++i) {
+      ObjectValue next = versions.back();
+      next.Set(FieldName(i % state.range(0)), testutil::Value(i));
+      versions.push_back(std::move(next));
+    }
+    retained_bytes = AllocatedBytes() - before;
+    benchmark::DoNotOptimize(versions);
+  }
+  state.counters["bytes_per_version"] =
+      static_cast<double>(retained_bytes) / kVersions;
+}
+BENCHMARK(BM_PatchHistory)->Arg(10)->Arg(200)->Arg(1000);
+
+/** Copies an object and modifies a field nested `state.range(0)` deep. */
+void BM_NestedPatch(benchmark::State& state) {
+  ObjectValue base;
+  FieldPath path;
+  for (int depth = 0; depth < state.range(0); ++depth) {
+    path = path.Append(absl::StrCat("level", depth));
+    // Siblings at every level, which are shared by the copies.
+    for (int i = 0; i < 10; ++i) {
+      base.Set(path.Append(absl::StrCat("sibling", i)), testutil::Value(i));
+    }
+  }
+  path = path.Append("leaf");
+
+  int64_t i = 0;
+  for (auto _ : state) {
+    ObjectValue patched = base;
+    patched.Set(path, testutil::Value(i++));
+    benchmark::DoNotOptimize(patched);
+  }
+}
+BENCHMARK(BM_NestedPatch)->Arg(1)->Arg(4)->Arg(16);
+
+}  // namespace
+}  // namespace model
+}  // namespace firestore
+}  // namespace firebase
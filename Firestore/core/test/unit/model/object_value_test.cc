@@ -16,6 +16,8 @@
 
 #include "Firestore/core/src/model/object_value.h"
 
+#include <vector>
+
 #include "Firestore/core/src/model/value_util.h"
 #include "Firestore/core/src/remote/serializer.h"
 #include "Firestore/core/test/unit/testutil/testutil.h"
@@ -335,6 +337,60 @@ TEST_F(ObjectValueTest, DoesNotRequireSortedInserts) {
   EXPECT_EQ(*Value(2), *object_value.Get(Field("nested.nested.c")));
 }
 
+TEST_F(ObjectValueTest, CopiesAreNotAffectedBySet) {
+  ObjectValue object_value = WrapObject("a", Map("b", 1, "c", 2), "d", 3);
+  ObjectValue copy = object_value;
+
+  object_value.Set(Field("a.b"), Value(kFooString));
+  object_value.Set(Field("d.e"), Value(kBarString));
+
+  EXPECT_EQ(WrapObject("a", Map("b", 1, "c", 2), "d", 3), copy);
+  EXPECT_EQ(WrapObject("a", Map("b", kFooString, "c", 2), "d",
+                       Map("e", kBarString)),
+            object_value);
+}
+
+TEST_F(ObjectValueTest, CopiesAreNotAffectedByDelete) {
+  ObjectValue object_value = WrapObject("a", Map("b", 1, "c", 2), "d", 3);
+  ObjectValue copy = object_value;
+
+  object_value.Delete(Field("a.b"));
+  object_value.Delete(Field("d"));
+
+  EXPECT_EQ(WrapObject("a", Map("b", 1, "c", 2), "d", 3), copy);
+  EXPECT_EQ(WrapObject("a", Map("c", 2)), object_value);
+}
+
+TEST_F(ObjectValueTest, CopiesAreNotAffectedBySetAll) {
+  ObjectValue object_value = WrapObject("a", Map("b", 1), "c", 2);
+  ObjectValue copy = object_value;
+
+  TransformMap data;
+  data[Field("a.b")] = absl::nullopt;
+  data[Field("a.d")] = Value(kFooString);
+  data[Field("c")] = Map("e", kBarString);
+  object_value.SetAll(std::move(data));
+
+  EXPECT_EQ(WrapObject("a", Map("b", 1), "c", 2), copy);
+  EXPECT_EQ(WrapObject("a", Map("d", kFooString), "c", Map("e", kBarString)),
+            object_value);
+}
+
+TEST_F(ObjectValueTest, KeepsAllVersionsOfRepeatedlyModifiedObjects) {
+  // Enough modifications for the entries to be compacted several times.
+  ObjectValue object_value = WrapObject("a", Map("b", 0), "c", 0);
+  std::vector<ObjectValue> versions;
+  for (int i = 0; i < 50; ++i) {
+    object_value.Set(Field("a.b"), Value(i));
+    object_value.Set(Field("c"), Value(i));
+    versions.push_back(object_value);
+  }
+
+  for (int i = 0; i < 50; ++i) {
+    EXPECT_EQ(WrapObject("a", Map("b", i), "c", i), versions[i]);
+  }
+}
+
 }  // namespace
 
 }  // namespace model
@@ -0,0 +1,254 @@
+/*
+ * Copyright 2021 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Firestore/core/src/model/sort_key.h"
+
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "Firestore/core/include/firebase/firestore/geo_point.h"
+#include "Firestore/core/include/firebase/firestore/timestamp.h"
+#include "Firestore/core/src/model/database_id.h"
+#include "Firestore/core/src/model/document_key.h"
+#include "Firestore/core/src/model/server_timestamp_util.h"
+#include "Firestore/core/src/model/value_util.h"
+#include "Firestore/core/src/nanopb/message.h"
+#include "Firestore/core/src/util/comparison.h"
+#include "Firestore/core/test/unit/testutil/testutil.h"
+#include "absl/strings/string_view.h"
+#include "gtest/gtest.h"
+
+namespace firebase {
+namespace firestore {
+namespace model {
+namespace {
+
+using nanopb::Message;
+using testutil::Array;
+using testutil::BlobValue;
+using testutil::DbId;
+using testutil::Key;
+using testutil::Map;
+using testutil::Value;
+using util::ComparisonResult;
+
+std::vector<Message<google_firestore_v1_Value>> TestValues() {
+  const int64_t kInt64Min = std::numeric_limits<int64_t>::min();
+  const int64_t kInt64Max = std::numeric_limits<int64_t>::max();
+  const double kInfinity = std::numeric_limits<double>::infinity();
+  const double kDenormMin = std::numeric_limits<double>::denorm_min();
+
+  std::vector<Message<google_firestore_v1_Value>> values;
+  values.push_back(Value(nullptr));
+
+  values.push_back(Value(false));
+  values.push_back(Value(true));
+
+  values.push_back(Value(NAN));
+  values.push_back(Value(-kInfinity));
+  values.push_back(Value(-1e20));
+  values.push_back(Value(std::nextafter(-9223372036854775808.0, -kInfinity)));
+  values.push_back(Value(-9223372036854775808.0));
+  values.push_back(Value(kInt64Min));
+  values.push_back(Value(kInt64Min + 1));
+  values.push_back(Value(-9007199254740993LL));
+  values.push_back(Value(-9007199254740992.0));
+  values.push_back(Value(-2.5));
+  values.push_back(Value(-2));
+  values.push_back(Value(-2.0));
+  values.push_back(Value(-1.5));
+  values.push_back(Value(-1));
+  values.push_back(Value(-0.5));
+  values.push_back(Value(-kDenormMin));
+  values.push_back(Value(-0.0));
+  values.push_back(Value(0.0));
+  values.push_back(Value(0));
+  values.push_back(Value(kDenormMin));
+  values.push_back(Value(0.1));
+  values.push_back(Value(0.5));
+  values.push_back(Value(1));
+  values.push_back(Value(1.0));
+  values.push_back(Value(std::nextafter(1.0, 2.0)));
+  values.push_back(Value(1.5));
+  values.push_back(Value(9007199254740992.0));
+  values.push_back(Value(9007199254740993LL));
+  values.push_back(Value(9007199254740994.0));
+  values.push_back(Value(std::nextafter(9223372036854775808.0, 0.0)));
+  values.push_back(Value(kInt64Max - 1));
+  values.push_back(Value(kInt64Max));
+  values.push_back(Value(9223372036854775808.0));
+  values.push_back(Value(1e20));
+  values.push_back(Value(kInfinity));
+
+  values.push_back(Value(Timestamp(-1, 999999999)));
+  values.push_back(Value(Timestamp(0, 0)));
+  values.push_back(Value(Timestamp(0, 1)));
+  values.push_back(Value(Timestamp(1463739600, 0)));
+  values.push_back(EncodeServerTimestamp(Timestamp(0, 0), absl::nullopt));
+  values.push_back(
+      EncodeServerTimestamp(Timestamp(1463739600, 0), absl::nullopt));
+  values.push_back(
+      EncodeServerTimestamp(Timestamp(1463739600, 1), absl::nullopt));
+
+  values.push_back(Value(""));
+  values.push_back(Value(std::string("\0", 1)));
+  values.push_back(Value(std::string("\0\0", 2)));
+  values.push_back(Value(std::string("\0\xff", 2)));
+  values.push_back(Value("\001\ud7ff\ue000\uffff"));
+  values.push_back(Value("a"));
+  values.push_back(Value(std::string("a\0", 2)));
+  values.push_back(Value(std::string("a\0b", 3)));
+  values.push_back(Value("a b"));
+  values.push_back(Value("ab"));
+  values.push_back(Value("e\u0301b"));
+  values.push_back(Value("\u00e9a"));
+  values.push_back(Value("\xff"));
+  values.push_back(Value("\xff\xff"));
+
+  values.push_back(BlobValue());
+  values.push_back(BlobValue(0));
+  values.push_back(BlobValue(0, 0));
+  values.push_back(BlobValue(0, 1, 2, 3, 4));
+  values.push_back(BlobValue(0, 1, 2, 4, 3));
+  values.push_back(BlobValue(1));
+  values.push_back(BlobValue(255));
+
+  values.push_back(RefValue(DbId("p1/d1"), Key("c1/doc1")));
+  values.push_back(RefValue(DbId("p1/d1"), Key("c1/doc1/c2/doc2")));
+  values.push_back(RefValue(DbId("p1/d1"), Key("c1/doc2")));
+  values.push_back(RefValue(DbId("p1/d1"), Key("c10/doc1")));
+  values.push_back(RefValue(DbId("p1/d1"), Key("c2/doc1")));
+  values.push_back(RefValue(DbId("p1/d2"), Key("c1/doc1")));
+  values.push_back(RefValue(DbId("p2/d1"), Key("c1/doc1")));
+
+  values.push_back(Value(GeoPoint(-90, -180)));
+  values.push_back(Value(GeoPoint(-90, 0)));
+  values.push_back(Value(GeoPoint(-0.5, 180)));
+  values.push_back(Value(GeoPoint(0, -180)));
+  values.push_back(Value(GeoPoint(-0.0, -0.0)));
+  values.push_back(Value(GeoPoint(0, 0)));
+  values.push_back(Value(GeoPoint(90, 180)));
+
+  values.push_back(Value(Array()));
+  values.push_back(Value(Array(nullptr)));
+  values.push_back(Value(Array(nullptr, nullptr)));
+  values.push_back(Value(Array(1)));
+  values.push_back(Value(Array(1.0, "a")));
+  values.push_back(Value(Array(1, Array())));
+  values.push_back(Value(Array("")));
+  values.push_back(Value(Array("bar")));
+  values.push_back(Value(Array("foo", 1)));
+  values.push_back(Value(Array("foo", 2)));
+  values.push_back(Value(Array("foo", "0")));
+  values.push_back(Value(Array(Array())));
+  values.push_back(Value(Array(Map())));
+
+  values.push_back(Map());
+  values.push_back(Map("", nullptr));
+  values.push_back(Map("a", nullptr));
+  values.push_back(Map("a", 1));
+  values.push_back(Map("a", 1, "b", 2));
+  values.push_back(Map("a", 1.5));
+  values.push_back(Map("a", Array()));
+  values.push_back(Map("a", Map()));
+  values.push_back(Map("ab", 0));
+  values.push_back(Map("b", 0));
+  values.push_back(Map("bar", 0, "foo", 1));
+  values.push_back(Map("foo", "0"));
+  return values;
+}
+
+std::string SortKey(const google_firestore_v1_Value& value) {
+  std::string result;
+  WriteSortKey(&result, value);
+  return result;
+}
+
+ComparisonResult CompareKeys(const std::string& lhs, const std::string& rhs) {
+  return util::Compare(absl::string_view(lhs), absl::string_view(rhs));
+}
+
+TEST(SortKeyTest, AgreesWithCompare) {
+  std::vector<Message<google_firestore_v1_Value>> values = TestValues();
+  for (const auto& lhs : values) {
+    for (const auto& rhs : values) {
+      EXPECT_EQ(CompareKeys(SortKey(*lhs), SortKey(*rhs)), Compare(*lhs, *rhs))
+          << CanonicalId(*lhs) << " vs " << CanonicalId(*rhs);
+    }
+  }
+}
+
+TEST(SortKeyTest, AgreesWithCompareForTuples) {
+  std::vector<Message<google_firestore_v1_Value>> values = TestValues();
+
+  // Sorts by the first value in descending order, then the second ascending.
+  struct Tuple {
+    const google_firestore_v1_Value* first;
+    const google_firestore_v1_Value* second;
+    std::string sort_key;
+  };
+
+  // Every fifth value keeps the number of combinations manageable.
+  std::vector<Tuple> tuples;
+  for (size_t i = 0; i < values.size(); i += 5) {
+    for (size_t j = 1; j < values.size(); j += 5) {
+      Tuple tuple{values[i].get(), values[j].get(), ""};
+      WriteSortKey(&tuple.sort_key, *tuple.first);
+      InvertSortKey(&tuple.sort_key, 0);
+      WriteSortKey(&tuple.sort_key, *tuple.second);
+      tuples.push_back(std::move(tuple));
+    }
+  }
+
+  for (const Tuple& lhs : tuples) {
+    for (const Tuple& rhs : tuples) {
+      ComparisonResult expected =
+          util::ReverseOrder(Compare(*lhs.first, *rhs.first));
+      if (util::Same(expected)) {
+        expected = Compare(*lhs.second, *rhs.second);
+      }
+      EXPECT_EQ(CompareKeys(lhs.sort_key, rhs.sort_key), expected)
+          << "(" << CanonicalId(*lhs.first) << ", " << CanonicalId(*lhs.second)
+          << ") vs (" << CanonicalId(*rhs.first) << ", "
+          << CanonicalId(*rhs.second) << ")";
+    }
+  }
+}
+
+TEST(SortKeyTest, DocumentKeysAgreeWithCompareTo) {
+  std::vector<DocumentKey> keys = {
+      Key("a/a"),     Key("a/a/b/a"), Key("a/a/b/b"), Key("a/ab"),
+      Key("a/b"),     Key("a0/a"),    Key("aa/a"),    Key("b/a"),
+      Key("b/a/a/a"), Key("b/b"),
+  };
+  for (const DocumentKey& lhs : keys) {
+    for (const DocumentKey& rhs : keys) {
+      std::string lhs_key;
+      std::string rhs_key;
+      WriteSortKey(&lhs_key, lhs);
+      WriteSortKey(&rhs_key, rhs);
+      EXPECT_EQ(CompareKeys(lhs_key, rhs_key), lhs.CompareTo(rhs))
+          << lhs << " vs " << rhs;
+    }
+  }
+}
+
+}  // namespace
+}  // namespace model
+}  // namespace firestore
+}  // namespace firebase
@@ -0,0 +1,132 @@
+/*
+ * Copyright 2021 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Firestore/core/src/model/value_set.h"
+
+#include <cmath>
+#include <vector>
+
+#include "Firestore/core/include/firebase/firestore/geo_point.h"
+#include "Firestore/core/include/firebase/firestore/timestamp.h"
+#include "Firestore/core/src/model/database_id.h"
+#include "Firestore/core/src/model/server_timestamp_util.h"
+#include "Firestore/core/src/model/value_util.h"
+#include "Firestore/core/src/nanopb/message.h"
+#include "Firestore/core/test/unit/testutil/testutil.h"
+#include "absl/base/casts.h"
+#include "gtest/gtest.h"
+
+namespace firebase {
+namespace firestore {
+namespace model {
+namespace {
+
+using nanopb::Message;
+using testutil::Array;
+using testutil::BlobValue;
+using testutil::DbId;
+using testutil::Key;
+using testutil::Map;
+using testutil::Value;
+
+std::vector<Message<google_firestore_v1_Value>> TestValues() {
+  std::vector<Message<google_firestore_v1_Value>> values;
+  values.push_back(Value(nullptr));
+  values.push_back(Value(false));
+  values.push_back(Value(true));
+  values.push_back(Value(0));
+  values.push_back(Value(0.0));
+  values.push_back(Value(-0.0));
+  values.push_back(Value(1));
+  values.push_back(Value(1.0));
+  values.push_back(Value(NAN));
+  values.push_back(Value(absl::bit_cast<double>(0x7fff000000000000ULL)));
+  values.push_back(Value(Timestamp(0, 1)));
+  values.push_back(Value(Timestamp(1, 0)));
+  values.push_back(EncodeServerTimestamp(Timestamp(1, 0), absl::nullopt));
+  values.push_back(EncodeServerTimestamp(Timestamp(1, 0), *Value(1)));
+  values.push_back(Value(""));
+  values.push_back(Value("a"));
+  values.push_back(Value("b"));
+  values.push_back(BlobValue());
+  values.push_back(Value(nanopb::ByteString()));
+  values.push_back(BlobValue(0));
+  values.push_back(BlobValue(1));
+  values.push_back(RefValue(DbId("p1/d1"), Key("c1/doc1")));
+  values.push_back(RefValue(DbId("p1/d1"), Key("c1/doc2")));
+  values.push_back(Value(GeoPoint(0, 0)));
+  values.push_back(Value(GeoPoint(-0.0, -0.0)));
+  values.push_back(Value(GeoPoint(1, 0)));
+  values.push_back(Value(Array()));
+  values.push_back(Value(Array(1)));
+  values.push_back(Value(Array(1.0)));
+  values.push_back(Value(Array(1, "a")));
+  values.push_back(Value(Array("a", 1)));
+  values.push_back(Map());
+  values.push_back(Map("a", 1));
+  values.push_back(Map("a", 1.0));
+  values.push_back(Map("b", 1));
+  values.push_back(Map("a", 1, "b", 2));
+  values.push_back(Map("a", Array(1)));
+  return values;
+}
+
+TEST(ValueSetTest, HashIsConsistentWithEquals) {
+  std::vector<Message<google_firestore_v1_Value>> values = TestValues();
+  for (const auto& lhs : values) {
+    for (const auto& rhs : values) {
+      if (Equals(*lhs, *rhs)) {
+        EXPECT_EQ(Hash(*lhs), Hash(*rhs))
+            << CanonicalId(*lhs) << " vs " << CanonicalId(*rhs);
+      }
+    }
+  }
+}
+
+TEST(ValueSetTest, ContainsAgreesWithEquals) {
+  std::vector<Message<google_firestore_v1_Value>> values = TestValues();
+  for (size_t i = 0; i < values.size(); ++i) {
+    ValueSet set;
+    set.Insert(*values[i]);
+    for (const auto& value : values) {
+      EXPECT_EQ(set.Contains(*value), Equals(*values[i], *value))
+          << CanonicalId(*values[i]) << " vs " << CanonicalId(*value);
+    }
+  }
+}
+
+TEST(ValueSetTest, InsertSkipsEqualValues) {
+  Message<google_firestore_v1_ArrayValue> array = Array(1, "a", 1.0, "a", NAN);
+  ValueSet set(*array);
+  EXPECT_EQ(set.size(), 4u);
+
+  Message<google_firestore_v1_Value> nan = Value(NAN);
+  EXPECT_FALSE(set.Insert(*nan));
+  Message<google_firestore_v1_Value> two = Value(2);
+  EXPECT_TRUE(set.Insert(*two));
+  EXPECT_EQ(set.size(), 5u);
+
+  EXPECT_TRUE(set.Contains(*Value(1)));
+  EXPECT_TRUE(set.Contains(*Value(1.0)));
+  EXPECT_TRUE(set.Contains(*Value(2)));
+  EXPECT_FALSE(set.Contains(*Value(2.0)));
+  EXPECT_FALSE(set.Contains(*Value("b")));
+}
+
+}  // namespace
+}  // namespace model
+}  // namespace firestore
+}  // namespace firebase
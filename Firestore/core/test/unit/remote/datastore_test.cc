@@ -22,8 +22,11 @@
 
 #include "Firestore/Protos/nanopb/google/firestore/v1/document.nanopb.h"
 #include "Firestore/Protos/nanopb/google/firestore/v1/firestore.nanopb.h"
+#include "Firestore/core/src/core/bound.h"
+#include "Firestore/core/src/core/query.h"
 #include "Firestore/core/src/model/document.h"
 #include "Firestore/core/src/model/mutation.h"
+#include "Firestore/core/src/model/value_util.h"
 #include "Firestore/core/src/nanopb/message.h"
 #include "Firestore/core/src/nanopb/nanopb_util.h"
 #include "Firestore/core/src/remote/firebase_metadata_provider.h"
@@ -58,8 +61,10 @@ using credentials::AuthToken;
 using credentials::User;
 using model::DatabaseId;
 using model::Document;
+using model::RefValue;
 using nanopb::MakeArray;
 using nanopb::Message;
+using testing::ElementsAre;
 using testing::Not;
 using testutil::Value;
 using util::AsyncQueue;
@@ -94,6 +99,31 @@ grpc::ByteBuffer MakeFakeDocument(const std::string& doc_name) {
   return MakeByteBuffer(response);
 }
 
+/**
+ * Makes a page of a PartitionQuery response with a partition point at each of
+ * the given documents.
+ */
+grpc::ByteBuffer MakeFakePartitions(const std::vector<std::string>& doc_names,
+                                    const std::string& next_page_token) {
+  Message<google_firestore_v1_PartitionQueryResponse> response;
+
+  response->partitions_count = nanopb::CheckedSize(doc_names.size());
+  response->partitions =
+      MakeArray<google_firestore_v1_Cursor>(response->partitions_count);
+  for (pb_size_t i = 0; i < response->partitions_count; ++i) {
+    google_firestore_v1_Cursor& cursor = response->partitions[i];
+    cursor.values_count = 1;
+    cursor.values = MakeArray<google_firestore_v1_Value>(1);
+    cursor.values[0] =
+        *RefValue(DatabaseId{"p", "d"}, testutil::Key(doc_names[i])).release();
+  }
+  if (!next_page_token.empty()) {
+    response->next_page_token = nanopb::MakeBytesArray(next_page_token);
+  }
+
+  return MakeByteBuffer(response);
+}
+
 class FakeDatastore : public Datastore {
  public:
   using Datastore::Datastore;
@@ -279,6 +309,43 @@ TEST_F(DatastoreTest, LookupDocumentsTwoSuccessfulReads) {
   EXPECT_TRUE(resulting_status.ok());
 }
 
+TEST_F(DatastoreTest, PartitionQueryReadsAllPages) {
+  bool done = false;
+  std::vector<core::Bound> resulting_partitions;
+  Status resulting_status;
+  datastore->PartitionQuery(
+      testutil::CollectionGroupQuery("foo").ToTarget(), 3,
+      [&](const StatusOr<std::vector<core::Bound>>& partitions) {
+        done = true;
+        if (partitions.ok()) {
+          resulting_partitions = partitions.ValueOrDie();
+        }
+        resulting_status = partitions.status();
+      });
+  // Make sure Auth has a chance to run.
+  worker_queue->EnqueueBlocking([] {});
+
+  ForceFinish({{Type::Finish, MakeFakePartitions({"foo/2", "bar/1/foo/1"}, "2"),
+                grpc::Status::OK}});
+  EXPECT_FALSE(done);
+
+  ForceFinish(
+      {{Type::Finish, MakeFakePartitions({"foo/1"}, ""), grpc::Status::OK}});
+
+  EXPECT_TRUE(done);
+  EXPECT_TRUE(resulting_status.ok());
+  std::vector<std::string> positions;
+  for (const core::Bound& partition : resulting_partitions) {
+    ASSERT_EQ(partition.position()->values_count, 1);
+    positions.push_back(nanopb::MakeString(
+        partition.position()->values[0].reference_value));
+  }
+  EXPECT_THAT(positions,
+              ElementsAre("projects/p/databases/d/documents/foo/2",
+                          "projects/p/databases/d/documents/bar/1/foo/1",
+                          "projects/p/databases/d/documents/foo/1"));
+}
+
 // gRPC errors
 
 TEST_F(DatastoreTest, CommitMutationsError) {
@@ -341,6 +408,26 @@ TEST_F(DatastoreTest, LookupDocumentsErrorAfterFirstRead) {
   EXPECT_EQ(resulting_status.code(), Error::kErrorUnavailable);
 }
 
+TEST_F(DatastoreTest, PartitionQueryErrorOnLaterPage) {
+  bool done = false;
+  Status resulting_status;
+  datastore->PartitionQuery(
+      testutil::CollectionGroupQuery("foo").ToTarget(), 3,
+      [&](const StatusOr<std::vector<core::Bound>>& partitions) {
+        done = true;
+        resulting_status = partitions.status();
+      });
+  // Make sure Auth has a chance to run.
+  worker_queue->EnqueueBlocking([] {});
+
+  ForceFinish({{Type::Finish, MakeFakePartitions({"foo/1"}, "2"),
+                grpc::Status::OK}});
+  ForceFinish({{Type::Finish, grpc::Status{grpc::UNAVAILABLE, ""}}});
+
+  EXPECT_TRUE(done);
+  EXPECT_EQ(resulting_status.code(), Error::kErrorUnavailable);
+}
+
 // Auth errors
 
 TEST_F(DatastoreTest, CommitMutationsAuthFailure) {
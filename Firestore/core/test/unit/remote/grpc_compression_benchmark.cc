@@ -0,0 +1,389 @@
+/*
+ * Copyright 2021 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Measures the effect of `GrpcOptions::Compression` on a Listen-like stream
+// served by a loopback gRPC server. The client is a `GrpcConnection` configured
+// through `GrpcOptions`, so the channel arguments the SDK sets apply as well.
+// All traffic passes through a TCP proxy that counts the bytes on the wire; the
+// client decodes every response the way `WatchStream` does.
+
+#include <arpa/inet.h>    // NOLINT(build/include)
+#include <netinet/in.h>  // NOLINT(build/include)
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstdint>
+#include <future>  // NOLINT(build/c++11)
+#include <memory>
+#include <mutex>  // NOLINT(build/c++11)
+#include <string>
+#include <thread>  // NOLINT(build/c++11)
+#include <utility>
+#include <vector>
+
+#include "Firestore/Protos/nanopb/google/firestore/v1/firestore.nanopb.h"
+#include "Firestore/core/src/core/database_info.h"
+#include "Firestore/core/src/credentials/auth_token.h"
+#include "Firestore/core/src/credentials/user.h"
+#include "Firestore/core/src/model/database_id.h"
+#include "Firestore/core/src/model/object_value.h"
+#include "Firestore/core/src/nanopb/message.h"
+#include "Firestore/core/src/nanopb/nanopb_util.h"
+#include "Firestore/core/src/nanopb/reader.h"
+#include "Firestore/core/src/remote/connectivity_monitor.h"
+#include "Firestore/core/src/remote/firebase_metadata_provider.h"
+#include "Firestore/core/src/remote/firebase_metadata_provider_noop.h"
+#include "Firestore/core/src/remote/grpc_completion.h"
+#include "Firestore/core/src/remote/grpc_connection.h"
+#include "Firestore/core/src/remote/grpc_nanopb.h"
+#include "Firestore/core/src/remote/grpc_options.h"
+#include "Firestore/core/src/remote/grpc_streaming_reader.h"
+#include "Firestore/core/src/remote/remote_objc_bridge.h"
+#include "Firestore/core/src/remote/serializer.h"
+#include "Firestore/core/src/util/async_queue.h"
+#include "Firestore/core/src/util/hard_assert.h"
+#include "Firestore/core/src/util/statusor.h"
+#include "Firestore/core/test/unit/remote/create_noop_connectivity_monitor.h"
+#include "Firestore/core/test/unit/remote/loopback_server.h"
+#include "Firestore/core/test/unit/testutil/async_testing.h"
+#include "Firestore/core/test/unit/testutil/testutil.h"
+#include "absl/memory/memory.h"
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+#include "grpcpp/grpcpp.h"
+
+namespace firebase {
+namespace firestore {
+namespace remote {
+namespace {
+
+using credentials::AuthToken;
+using credentials::User;
+using model::DatabaseId;
+using nanopb::Message;
+using util::AsyncQueue;
+using util::StatusOr;
+
+const char* const kListenRpc = "/google.firestore.v1.Firestore/Listen";
+
+/** The number of responses the server sends on each call. */
+const int kResponsesPerCall = 100;
+
+/**
+ * Creates a `ListenResponse` carrying a document change for a document with
+ * `field_count` fields of chat-message-like content.
+ */
+grpc::ByteBuffer MakeListenResponse(const Serializer& serializer,
+                                    int field_count) {
+  Message<google_firestore_v1_Value> fields = testutil::Map();
+  model::ObjectValue value{std::move(fields)};
+  for (int i = 0; i < field_count; ++i) {
+    value.Set(testutil::Field(absl::StrCat("message", i)),
+              testutil::Map("author", absl::StrCat("user", i % 7), "text",
+                            "The quick brown fox jumps over the lazy dog",
+                            "likes", i * 3, "edited", i % 2 == 0));
+  }
+
+  Message<google_firestore_v1_ListenResponse> response;
+  response->which_response_type =
+      google_firestore_v1_ListenResponse_document_change_tag;
+  google_firestore_v1_DocumentChange& change = response->document_change;
+  change.document = serializer.EncodeDocument(
+      testutil::Key("rooms/eros/messages/page"), value);
+  change.document.has_update_time = true;
+  change.document.update_time =
+      Serializer::EncodeVersion(testutil::Version(1000));
+  change.target_ids_count = 1;
+  change.target_ids = nanopb::MakeArray<int32_t>(1);
+  change.target_ids[0] = 1;
+
+  return MakeByteBuffer(response);
+}
+
+/**
+ * Forwards TCP connections from a loopback port to `target_port`, counting
+ * the bytes sent in each direction.
+ */
+class CountingProxy {
+ public:
+  explicit CountingProxy(int target_port) : target_port_{target_port} {
+    listen_fd_ = socket(AF_INET, SOCK_STREAM, 0);
+    HARD_ASSERT(listen_fd_ >= 0, "Failed to create proxy socket");
+
+    sockaddr_in address = LoopbackAddress(0);
+    HARD_ASSERT(bind(listen_fd_, reinterpret_cast<sockaddr*>(&address),
+                     sizeof(address)) == 0,
+                "Failed to bind proxy socket");
+    HARD_ASSERT(listen(listen_fd_, 4) == 0, "Failed to listen on proxy");
+
+    socklen_t length = sizeof(address);
+    getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&address), &length);
+    port_ = ntohs(address.sin_port);
+
+    accept_thread_ = std::thread([this] { AcceptLoop(); });
+  }
+
+  ~CountingProxy() {
+    shutdown(listen_fd_, SHUT_RDWR);
+    close(listen_fd_);
+    accept_thread_.join();
+
+    {
+      std::lock_guard<std::mutex> lock{mutex_};
+      for (int fd : connection_fds_) {
+        shutdown(fd, SHUT_RDWR);
+      }
+    }
+    for (std::thread& pump : pumps_) {
+      pump.join();
+    }
+    for (int fd : connection_fds_) {
+      close(fd);
+    }
+  }
+
+  int port() const {
+    return port_;
+  }
+
+  int64_t bytes_to_client() const {
+    return bytes_to_client_;
+  }
+
+ private:
+  static sockaddr_in LoopbackAddress(int port) {
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(static_cast<uint16_t>(port));
+    return address;
+  }
+
+  void AcceptLoop() {
+    while (true) {
+      int client_fd = accept(listen_fd_, nullptr, nullptr);
+      if (client_fd < 0) {
+        return;
+      }
+
+      int server_fd = socket(AF_INET, SOCK_STREAM, 0);
+      sockaddr_in address = LoopbackAddress(target_port_);
+      if (connect(server_fd, reinterpret_cast<sockaddr*>(&address),
+                  sizeof(address)) != 0) {
+        close(client_fd);
+        close(server_fd);
+        continue;
+      }
+
+      std::lock_guard<std::mutex> lock{mutex_};
+      connection_fds_.push_back(client_fd);
+      connection_fds_.push_back(server_fd);
+      pumps_.emplace_back(
+          [=] { Pump(client_fd, server_fd, &bytes_to_server_); });
+      pumps_.emplace_back(
+          [=] { Pump(server_fd, client_fd, &bytes_to_client_); });
+    }
+  }
+
+  static void Pump(int from, int to, std::atomic<int64_t>* counter) {
+    char buffer[16 * 1024];
+    while (true) {
+      ssize_t read = recv(from, buffer, sizeof(buffer), 0);
+      if (read <= 0) {
+        break;
+      }
+      *counter += read;
+
+      ssize_t written = 0;
+      while (written < read) {
+        ssize_t result = send(to, buffer + written, read - written, 0);
+        if (result <= 0) {
+          shutdown(from, SHUT_RDWR);
+          return;
+        }
+        written += result;
+      }
+    }
+    shutdown(to, SHUT_WR);
+  }
+
+  int target_port_ = 0;
+  int listen_fd_ = -1;
+  int port_ = 0;
+
+  std::thread accept_thread_;
+  std::mutex mutex_;
+  std::vector<int> connection_fds_;
+  std::vector<std::thread> pumps_;
+
+  std::atomic<int64_t> bytes_to_server_{0};
+  std::atomic<int64_t> bytes_to_client_{0};
+};
+
+/**
+ * A `GrpcConnection` to a loopback server, with the gRPC completion queue
+ * polled on a dedicated thread the way `Datastore` does it.
+ */
+class LoopbackConnection {
+ public:
+  LoopbackConnection(int port, const GrpcOptions& grpc_options)
+      : worker_queue_{testutil::AsyncQueueForTesting()},
+        connectivity_monitor_{CreateNoOpConnectivityMonitor()},
+        metadata_provider_{CreateFirebaseMetadataProviderNoOp()},
+        database_info_{DatabaseId{"p", "d"}, "",
+                       absl::StrCat("127.0.0.1:", port),
+                       /* ssl_enabled= */ false, grpc_options} {
+    GrpcConnection::UseInsecureChannel(database_info_.host());
+    connection_ = absl::make_unique<GrpcConnection>(
+        database_info_, worker_queue_, &grpc_queue_,
+        connectivity_monitor_.get(), metadata_provider_.get());
+    poll_thread_ = std::thread([this] { PollGrpcQueue(); });
+  }
+
+  ~LoopbackConnection() {
+    // As in `Datastore::Shutdown`, the connection must finish its calls before
+    // the gRPC queue is shut down.
+    worker_queue_->EnqueueBlocking([&] { connection_->Shutdown(); });
+    grpc_queue_.Shutdown();
+    poll_thread_.join();
+  }
+
+  /**
+   * Runs a single Listen call and returns the responses, or an error if the
+   * call failed.
+   */
+  StatusOr<std::vector<grpc::ByteBuffer>> Listen() {
+    std::promise<StatusOr<std::vector<grpc::ByteBuffer>>> result;
+    std::unique_ptr<GrpcStreamingReader> call;
+
+    worker_queue_->EnqueueBlocking([&] {
+      call = connection_->CreateStreamingReader(
+          kListenRpc, AuthToken{"", User{}}, "", grpc::ByteBuffer{});
+      call->Start(
+          [&](const StatusOr<std::vector<grpc::ByteBuffer>>& responses) {
+            result.set_value(responses);
+          });
+    });
+
+    auto responses = result.get_future().get();
+    worker_queue_->EnqueueBlocking([&] { call.reset(); });
+    return responses;
+  }
+
+ private:
+  void PollGrpcQueue() {
+    void* tag = nullptr;
+    bool ok = false;
+    while (grpc_queue_.Next(&tag, &ok)) {
+      static_cast<GrpcCompletion*>(tag)->Complete(ok);
+    }
+  }
+
+  std::shared_ptr<AsyncQueue> worker_queue_;
+  std::unique_ptr<ConnectivityMonitor> connectivity_monitor_;
+  std::unique_ptr<FirebaseMetadataProvider> metadata_provider_;
+  core::DatabaseInfo database_info_;
+
+  grpc::CompletionQueue grpc_queue_;
+  std::unique_ptr<GrpcConnection> connection_;
+  std::thread poll_thread_;
+};
+
+/**
+ * Runs a single Listen-like call over `connection` and decodes every response.
+ * Returns the number of responses received.
+ */
+int RunCall(LoopbackConnection* connection,
+            const WatchStreamSerializer& serializer) {
+  StatusOr<std::vector<grpc::ByteBuffer>> responses = connection->Listen();
+  HARD_ASSERT(responses.ok(), "Listen call failed: %s",
+              responses.status().ToString());
+
+  for (const grpc::ByteBuffer& buffer : responses.ValueOrDie()) {
+    ByteBufferReader reader{buffer};
+    auto response = serializer.ParseResponse(&reader);
+    auto change = serializer.DecodeWatchChange(&reader, *response);
+    HARD_ASSERT(reader.ok(), "Failed to decode response: %s",
+                reader.status().ToString());
+    benchmark::DoNotOptimize(change);
+  }
+
+  return static_cast<int>(responses.ValueOrDie().size());
+}
+
+static void BM_ListenOverLoopback(benchmark::State& state) {
+  GrpcOptions grpc_options;
+  grpc_options.set_compression(
+      static_cast<GrpcOptions::Compression>(state.range(0)));
+  // Non-default values, so that the channel arguments are applied as well.
+  grpc_options.set_keepalive_time_ms(10 * 1000);
+  grpc_options.set_keepalive_timeout_ms(5 * 1000);
+  grpc_options.set_max_receive_message_size(16 * 1024 * 1024);
+  auto field_count = static_cast<int>(state.range(1));
+
+  Serializer serializer{DatabaseId{"p", "d"}};
+  WatchStreamSerializer watch_serializer{Serializer{DatabaseId{"p", "d"}}};
+  grpc::ByteBuffer response = MakeListenResponse(serializer, field_count);
+
+  LoopbackServer::Options server_options;
+  server_options.responses.assign(kResponsesPerCall, response);
+  server_options.compression =
+      GrpcConnection::ToGrpcCompression(grpc_options.compression());
+  LoopbackServer server{std::move(server_options)};
+  CountingProxy proxy{server.port()};
+  LoopbackConnection connection{proxy.port(), grpc_options};
+
+  // Warm up the connection so that the handshake isn't counted.
+  RunCall(&connection, watch_serializer);
+  int64_t initial_bytes = proxy.bytes_to_client();
+
+  int64_t responses = 0;
+  for (auto _ : state) {
+    responses += RunCall(&connection, watch_serializer);
+  }
+
+  int64_t wire_bytes = proxy.bytes_to_client() - initial_bytes;
+  state.SetItemsProcessed(responses);
+  state.SetBytesProcessed(static_cast<int64_t>(response.Length()) *
+                          responses);
+  state.counters["message_bytes"] = static_cast<double>(response.Length());
+  state.counters["wire_bytes_per_message"] =
+      responses == 0 ? 0.0
+                     : static_cast<double>(wire_bytes) /
+                           static_cast<double>(responses);
+}
+
+void CompressionArguments(benchmark::internal::Benchmark* benchmark) {
+  for (auto compression :
+       {GrpcOptions::Compression::None, GrpcOptions::Compression::Deflate,
+        GrpcOptions::Compression::Gzip}) {
+    for (int fields : {10, 100, 1000}) {
+      benchmark->Args({static_cast<int>(compression), fields});
+    }
+  }
+}
+BENCHMARK(BM_ListenOverLoopback)
+    ->ArgNames({"compression", "fields"})
+    ->Apply(CompressionArguments)
+    // Calls complete on the worker queue, not the benchmark thread.
+    ->UseRealTime();
+
+}  // namespace
+
+}  // namespace remote
+}  // namespace firestore
+}  // namespace firebase
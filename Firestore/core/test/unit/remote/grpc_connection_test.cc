@@ -104,6 +104,32 @@ class GrpcConnectionTest : public testing::Test {
   GrpcStreamTester tester;
 };
 
+TEST_F(GrpcConnectionTest, StreamingCallsUseConfiguredCompression) {
+  GrpcOptions options;
+  options.set_compression(GrpcOptions::Compression::Gzip);
+  GrpcStreamTester gzip_tester{worker_queue, connectivity_monitor.get(),
+                               options};
+
+  ConnectivityObserver observer;
+  std::unique_ptr<GrpcStream> stream = gzip_tester.CreateStream(&observer);
+  EXPECT_EQ(stream->context()->compression_algorithm(), GRPC_COMPRESS_GZIP);
+
+  std::unique_ptr<GrpcStreamingReader> reader =
+      gzip_tester.CreateStreamingReader();
+  EXPECT_EQ(reader->context()->compression_algorithm(), GRPC_COMPRESS_GZIP);
+
+  // Unary calls carry small messages and are left uncompressed.
+  std::unique_ptr<GrpcUnaryCall> unary_call = gzip_tester.CreateUnaryCall();
+  EXPECT_EQ(unary_call->context()->compression_algorithm(),
+            GRPC_COMPRESS_NONE);
+}
+
+TEST_F(GrpcConnectionTest, StreamingCallsAreUncompressedByDefault) {
+  ConnectivityObserver observer;
+  std::unique_ptr<GrpcStream> stream = tester.CreateStream(&observer);
+  EXPECT_EQ(stream->context()->compression_algorithm(), GRPC_COMPRESS_NONE);
+}
+
 TEST_F(GrpcConnectionTest, GrpcStreamsNoticeChangeInConnectivity) {
   ConnectivityObserver observer;
 
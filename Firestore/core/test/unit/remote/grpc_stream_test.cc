@@ -202,6 +202,29 @@ TEST_F(GrpcStreamTest, ReadIsAutomaticallyReadded) {
                                        "OnStreamRead(bar)"}));
 }
 
+TEST_F(GrpcStreamTest, ReadsCanBeSuspendedAndResumed) {
+  worker_queue->EnqueueBlocking([&] {
+    stream->Start();
+    stream->SuspendReads();
+  });
+
+  // The read issued before suspending still completes, but no new read is
+  // issued after it.
+  ForceFinish({{Type::Read, MakeByteBuffer("foo")}});
+  EXPECT_EQ(observed_states(), States({"OnStreamStart", "OnStreamRead(foo)"}));
+
+  worker_queue->EnqueueBlocking([&] {
+    stream->SuspendReads();
+    stream->ResumeReads();
+    // Resuming twice must not issue a second concurrent read.
+    stream->ResumeReads();
+  });
+
+  ForceFinish({{Type::Read, MakeByteBuffer("bar")}});
+  EXPECT_EQ(observed_states(), States({"OnStreamStart", "OnStreamRead(foo)",
+                                       "OnStreamRead(bar)"}));
+}
+
 TEST_F(GrpcStreamTest, CanAddSeveralWrites) {
   worker_queue->EnqueueBlocking([&] { stream->Start(); });
 
@@ -203,10 +203,11 @@ std::future<void> FakeGrpcQueue::KeepPolling(
 
 GrpcStreamTester::GrpcStreamTester(
     const std::shared_ptr<AsyncQueue>& worker_queue,
-    ConnectivityMonitor* connectivity_monitor)
+    ConnectivityMonitor* connectivity_monitor,
+    const GrpcOptions& grpc_options)
     : worker_queue_{NOT_NULL(worker_queue)},
       database_info_{DatabaseId{"foo", "bar"}, "", "firestore.googleapis.com",
-                     false},
+                     false, grpc_options},
       fake_grpc_queue_{&grpc_queue_},
       firebase_metadata_provider_{CreateFirebaseMetadataProviderNoOp()},
       grpc_connection_{database_info_, worker_queue, fake_grpc_queue_.queue(),
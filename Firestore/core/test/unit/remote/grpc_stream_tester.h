@@ -134,7 +134,8 @@ class GrpcStreamTester {
   using CompletionCallback = FakeGrpcQueue::CompletionCallback;
 
   GrpcStreamTester(const std::shared_ptr<util::AsyncQueue>& worker_queue,
-                   ConnectivityMonitor* connectivity_monitor);
+                   ConnectivityMonitor* connectivity_monitor,
+                   const GrpcOptions& grpc_options = {});
   ~GrpcStreamTester();
 
   /** Finishes the stream and shuts down the gRPC completion queue. */
@@ -0,0 +1,141 @@
+/*
+ * Copyright 2021 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Firestore/core/test/unit/remote/loopback_server.h"
+
+#include <utility>
+
+#include "Firestore/core/src/util/hard_assert.h"
+#include "grpcpp/alarm.h"
+
+namespace firebase {
+namespace firestore {
+namespace remote {
+
+namespace {
+
+enum class Step { Accepted, Read, Delayed, Wrote, Finished, Cancelled };
+
+}  // namespace
+
+// Each call has a single operation outstanding at a time, so the call itself
+// is the tag and `step` says which operation completed.
+struct LoopbackServer::Call {
+  grpc::GenericServerContext context;
+  grpc::GenericServerAsyncReaderWriter stream{&context};
+  grpc::ByteBuffer request;
+  grpc::Alarm alarm;
+  Step step = Step::Accepted;
+  size_t writes = 0;
+};
+
+LoopbackServer::LoopbackServer(Options options)
+    : options_{std::move(options)} {
+  HARD_ASSERT(!options_.responses.empty(),
+              "Each call must be answered with a response");
+
+  grpc::ServerBuilder builder;
+  builder.AddListeningPort("127.0.0.1:0", grpc::InsecureServerCredentials(),
+                           &port_);
+  builder.RegisterAsyncGenericService(&service_);
+  queue_ = builder.AddCompletionQueue();
+  server_ = builder.BuildAndStart();
+  HARD_ASSERT(server_ && port_ != 0, "Failed to start loopback server");
+
+  thread_ = std::thread([this] { Serve(); });
+}
+
+LoopbackServer::~LoopbackServer() {
+  server_->Shutdown();
+  queue_->Shutdown();
+  thread_.join();
+}
+
+void LoopbackServer::Serve() {
+  RequestCall();
+
+  void* tag = nullptr;
+  bool ok = false;
+  while (queue_->Next(&tag, &ok)) {
+    auto* call = static_cast<Call*>(tag);
+    if (!ok) {
+      // Either the server is shutting down or the client went away.
+      if (call->step == Step::Read) {
+        call->step = Step::Cancelled;
+        call->stream.Finish(grpc::Status::CANCELLED, call);
+      } else {
+        delete call;
+      }
+      continue;
+    }
+
+    switch (call->step) {
+      case Step::Accepted:
+        RequestCall();
+        call->context.set_compression_algorithm(options_.compression);
+        call->step = Step::Read;
+        call->stream.Read(&call->request, call);
+        break;
+
+      case Step::Read:
+        if (options_.latency.count() > 0) {
+          call->step = Step::Delayed;
+          call->alarm.Set(queue_.get(),
+                          std::chrono::system_clock::now() + options_.latency,
+                          call);
+        } else {
+          Respond(call);
+        }
+        break;
+
+      case Step::Delayed:
+      case Step::Wrote:
+        Respond(call);
+        break;
+
+      case Step::Finished:
+        ++calls_answered_;
+        delete call;
+        break;
+
+      case Step::Cancelled:
+        delete call;
+        break;
+    }
+  }
+}
+
+void LoopbackServer::RequestCall() {
+  auto* call = new Call();
+  service_.RequestCall(&call->context, &call->stream, queue_.get(),
+                       queue_.get(), call);
+}
+
+void LoopbackServer::Respond(Call* call) {
+  const grpc::ByteBuffer& response = options_.responses[call->writes++];
+  if (call->writes < options_.responses.size()) {
+    call->step = Step::Wrote;
+    call->stream.Write(response, call);
+  } else {
+    call->step = Step::Finished;
+    call->stream.WriteAndFinish(response, grpc::WriteOptions{},
+                                grpc::Status::OK, call);
+  }
+}
+
+}  // namespace remote
+}  // namespace firestore
+}  // namespace firebase
@@ -0,0 +1,83 @@
+/*
+ * Copyright 2021 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FIRESTORE_CORE_TEST_UNIT_REMOTE_LOOPBACK_SERVER_H_
+#define FIRESTORE_CORE_TEST_UNIT_REMOTE_LOOPBACK_SERVER_H_
+
+#include <atomic>
+#include <chrono>  // NOLINT(build/c++11)
+#include <cstdint>
+#include <memory>
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+#include "grpc/compression.h"
+#include "grpcpp/generic/async_generic_service.h"
+#include "grpcpp/grpcpp.h"
+
+namespace firebase {
+namespace firestore {
+namespace remote {
+
+/**
+ * A gRPC server on a loopback port, for tests and benchmarks that need a real
+ * transport. It answers calls to any method the same way: it reads the
+ * request, waits for `latency`, writes `responses` in order and finishes the
+ * call successfully. Calls are served concurrently on a thread of its own.
+ */
+class LoopbackServer {
+ public:
+  struct Options {
+    std::vector<grpc::ByteBuffer> responses;
+    /** Stands in for the round trip to the backend. */
+    std::chrono::milliseconds latency{0};
+    grpc_compression_algorithm compression = GRPC_COMPRESS_NONE;
+  };
+
+  explicit LoopbackServer(Options options);
+  ~LoopbackServer();
+
+  int port() const {
+    return port_;
+  }
+
+  /** The number of calls that were answered in full so far. */
+  int64_t calls_answered() const {
+    return calls_answered_;
+  }
+
+ private:
+  struct Call;
+
+  void Serve();
+  void RequestCall();
+  void Respond(Call* call);
+
+  Options options_;
+
+  grpc::AsyncGenericService service_;
+  std::unique_ptr<grpc::ServerCompletionQueue> queue_;
+  std::unique_ptr<grpc::Server> server_;
+  int port_ = 0;
+  std::thread thread_;
+  std::atomic<int64_t> calls_answered_{0};
+};
+
+}  // namespace remote
+}  // namespace firestore
+}  // namespace firebase
+
+#endif  // FIRESTORE_CORE_TEST_UNIT_REMOTE_LOOPBACK_SERVER_H_
@@ -0,0 +1,366 @@
+/*
+ * Copyright 2021 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Firestore/core/src/remote/watch_stream.h"
+
+#include <chrono>  // NOLINT(build/c++11)
+#include <future>  // NOLINT(build/c++11)
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Firestore/Protos/cpp/google/firestore/v1/firestore.pb.h"
+#include "Firestore/core/src/model/database_id.h"
+#include "Firestore/core/src/remote/grpc_completion.h"
+#include "Firestore/core/src/remote/grpc_stream.h"
+#include "Firestore/core/src/remote/serializer.h"
+#include "Firestore/core/src/util/async_queue.h"
+#include "Firestore/core/src/util/executor.h"
+#include "Firestore/core/src/util/status.h"
+#include "Firestore/core/test/unit/remote/create_noop_connectivity_monitor.h"
+#include "Firestore/core/test/unit/remote/fake_credentials_provider.h"
+#include "Firestore/core/test/unit/remote/grpc_stream_tester.h"
+#include "Firestore/core/test/unit/testutil/async_testing.h"
+#include "absl/types/optional.h"
+#include "grpcpp/client_context.h"
+#include "gtest/gtest.h"
+
+namespace firebase {
+namespace firestore {
+namespace remote {
+namespace {
+
+using credentials::AppCheckCredentialsProvider;
+using credentials::AuthCredentialsProvider;
+using credentials::AuthToken;
+using credentials::User;
+using model::DatabaseId;
+using model::SnapshotVersion;
+using model::TargetId;
+using util::AsyncQueue;
+using util::Executor;
+using util::Status;
+
+using ProtoListenResponse = ::google::firestore::v1::ListenResponse;
+using ProtoTargetChange = ::google::firestore::v1::TargetChange;
+using Type = GrpcCompletion::Type;
+
+/** Returns a `ListenResponse` that reports no change to `target_id`. */
+grpc::ByteBuffer NoChangeResponse(TargetId target_id) {
+  ProtoListenResponse response;
+  ProtoTargetChange* change = response.mutable_target_change();
+  change->set_target_change_type(ProtoTargetChange::NO_CHANGE);
+  change->add_target_ids(target_id);
+  return MakeByteBuffer(response.SerializeAsString());
+}
+
+/** Returns bytes that can't be parsed as a `ListenResponse`. */
+grpc::ByteBuffer MalformedResponse() {
+  // A length-delimited field whose length exceeds the message.
+  return MakeByteBuffer(std::string{"\x0a\x7f", 2});
+}
+
+/**
+ * Records the target ID of every change, the close status and how many changes
+ * came before it.
+ */
+class FakeWatchStreamCallback : public WatchStreamCallback {
+ public:
+  void OnWatchStreamOpen() override {
+  }
+
+  void OnWatchStreamChange(const WatchChange& change,
+                           const SnapshotVersion&) override {
+    const auto& target_change = static_cast<const WatchTargetChange&>(change);
+    target_ids.push_back(target_change.target_ids().front());
+  }
+
+  void OnWatchStreamClose(const Status& status) override {
+    close_status = status;
+    changes_before_close = target_ids.size();
+  }
+
+  std::vector<TargetId> target_ids;
+  absl::optional<Status> close_status;
+  size_t changes_before_close = 0;
+};
+
+/** A `WatchStream` whose gRPC stream is driven by a `GrpcStreamTester`. */
+class TestWatchStream : public WatchStream {
+ public:
+  TestWatchStream(const std::shared_ptr<AsyncQueue>& worker_queue,
+                  GrpcStreamTester* tester,
+                  std::shared_ptr<AuthCredentialsProvider> auth_credentials,
+                  std::shared_ptr<AppCheckCredentialsProvider>
+                      app_check_credentials,
+                  WatchStreamCallback* callback,
+                  std::unique_ptr<Executor> decoder)
+      : WatchStream{worker_queue,
+                    std::move(auth_credentials),
+                    std::move(app_check_credentials),
+                    Serializer{DatabaseId{"p", "d"}},
+                    /*grpc_connection=*/nullptr,
+                    callback,
+                    std::move(decoder)},
+        tester_{tester} {
+  }
+
+  grpc::ClientContext* context() {
+    return context_;
+  }
+
+ private:
+  std::unique_ptr<GrpcStream> CreateGrpcStream(GrpcConnection*,
+                                               const AuthToken&,
+                                               const std::string&) override {
+    auto result = tester_->CreateStream(this);
+    context_ = result->context();
+    return result;
+  }
+
+  GrpcStreamTester* tester_ = nullptr;
+  grpc::ClientContext* context_ = nullptr;
+};
+
+}  // namespace
+
+class WatchStreamTest : public testing::Test, public testutil::AsyncTest {
+ public:
+  WatchStreamTest()
+      : worker_queue{testutil::AsyncQueueForTesting()},
+        connectivity_monitor{CreateNoOpConnectivityMonitor()},
+        tester{worker_queue, connectivity_monitor.get()},
+        app_check_credentials{std::make_shared<
+            FakeCredentialsProvider<std::string, std::string>>()},
+        auth_credentials{
+            std::make_shared<FakeCredentialsProvider<AuthToken, User>>()} {
+  }
+
+  ~WatchStreamTest() {
+    // Let any decoding still in progress finish.
+    Unblock();
+    worker_queue->EnqueueBlocking([&] {
+      if (stream && stream->IsStarted()) {
+        tester.KeepPollingGrpcQueue();
+        stream->Stop();
+      }
+    });
+    tester.Shutdown();
+  }
+
+  /** Starts a stream that decodes responses on a concurrent pool. */
+  void StartStream() {
+    StartStream(Executor::CreateConcurrent("WatchStreamTest", 4));
+  }
+
+  void StartStream(std::unique_ptr<Executor> decoder) {
+    decoder_ = decoder.get();
+    stream = std::make_shared<TestWatchStream>(
+        worker_queue, &tester, auth_credentials, app_check_credentials,
+        &callback, std::move(decoder));
+    worker_queue->EnqueueBlocking([&] { stream->Start(); });
+    worker_queue->EnqueueBlocking([] {});
+  }
+
+  /** Stops the decoder from decoding anything until `Unblock` is called. */
+  void BlockDecoder() {
+    std::shared_future<void> unblocked = unblock_.get_future().share();
+    decoder_->Execute([unblocked] { unblocked.wait(); });
+  }
+
+  void Unblock() {
+    if (!is_unblocked_) {
+      is_unblocked_ = true;
+      unblock_.set_value();
+    }
+  }
+
+  void Receive(const grpc::ByteBuffer& message) {
+    tester.ForceFinish(stream->context(), {{Type::Read, message}});
+  }
+
+  /** Waits until the callback has seen `count` changes or the stream closed. */
+  void AwaitChanges(size_t count) {
+    auto deadline = std::chrono::steady_clock::now() + testutil::kTimeout;
+    while (std::chrono::steady_clock::now() < deadline) {
+      bool done = false;
+      worker_queue->EnqueueBlocking([&] {
+        done = callback.target_ids.size() >= count || callback.close_status;
+      });
+      if (done) return;
+      SleepFor(1);
+    }
+    ADD_FAILURE() << "Timed out waiting for " << count << " changes";
+  }
+
+  /** Waits until everything submitted to the decoder has been delivered. */
+  void DrainDecoder() {
+    decoder_->ExecuteBlocking([] {});
+    worker_queue->EnqueueBlocking([] {});
+  }
+
+  bool AreReadsSuspended() {
+    bool result = false;
+    worker_queue->EnqueueBlocking(
+        [&] { result = stream->are_reads_suspended(); });
+    return result;
+  }
+
+  std::shared_ptr<AsyncQueue> worker_queue;
+  std::unique_ptr<ConnectivityMonitor> connectivity_monitor;
+  GrpcStreamTester tester;
+
+  std::shared_ptr<FakeCredentialsProvider<std::string, std::string>>
+      app_check_credentials;
+  std::shared_ptr<FakeCredentialsProvider<AuthToken, User>> auth_credentials;
+
+  FakeWatchStreamCallback callback;
+  std::shared_ptr<TestWatchStream> stream;
+
+ private:
+  Executor* decoder_ = nullptr;
+  std::promise<void> unblock_;
+  bool is_unblocked_ = false;
+};
+
+TEST_F(WatchStreamTest, DeliversResponsesInStreamOrder) {
+  StartStream();
+
+  std::vector<TargetId> expected;
+  for (TargetId target_id = 1; target_id <= 50; ++target_id) {
+    Receive(NoChangeResponse(target_id));
+    expected.push_back(target_id);
+  }
+
+  AwaitChanges(expected.size());
+  worker_queue->EnqueueBlocking(
+      [&] { EXPECT_EQ(callback.target_ids, expected); });
+}
+
+TEST_F(WatchStreamTest, ClosesOnDecodeErrorWhenItsTurnComes) {
+  StartStream();
+
+  Receive(NoChangeResponse(1));
+  Receive(MalformedResponse());
+  Receive(NoChangeResponse(3));
+  // Closing the stream waits for gRPC to finish the call.
+  tester.KeepPollingGrpcQueue();
+
+  AwaitChanges(2);
+  worker_queue->EnqueueBlocking([&] {
+    // The response before the malformed one is still delivered, the one after
+    // it isn't.
+    EXPECT_EQ(callback.target_ids, std::vector<TargetId>{1});
+    ASSERT_TRUE(callback.close_status.has_value());
+    EXPECT_FALSE(callback.close_status->ok());
+    EXPECT_FALSE(stream->IsStarted());
+  });
+}
+
+TEST_F(WatchStreamTest, DeliversResponsesReceivedBeforeTheStreamFinished) {
+  StartStream(Executor::CreateSerial("WatchStreamTest"));
+  BlockDecoder();
+
+  Receive(NoChangeResponse(1));
+  Receive(NoChangeResponse(2));
+  tester.ForceFinish(stream->context(),
+                     {{Type::Read, CompletionResult::Error},
+                      {Type::Finish, grpc::Status{grpc::UNAVAILABLE, ""}}});
+
+  // The responses are decoded on the worker queue rather than waiting for the
+  // decoder, whose results are then dropped.
+  worker_queue->EnqueueBlocking([&] {
+    ASSERT_TRUE(callback.close_status.has_value());
+    EXPECT_EQ(callback.close_status->code(), Error::kErrorUnavailable);
+    EXPECT_EQ(callback.target_ids, (std::vector<TargetId>{1, 2}));
+    EXPECT_EQ(callback.changes_before_close, 2u);
+  });
+
+  Unblock();
+  DrainDecoder();
+  worker_queue->EnqueueBlocking([&] {
+    EXPECT_EQ(callback.target_ids, (std::vector<TargetId>{1, 2}));
+  });
+}
+
+TEST_F(WatchStreamTest, ClosesOnDecodeErrorWhenTheStreamFinishes) {
+  StartStream(Executor::CreateSerial("WatchStreamTest"));
+  BlockDecoder();
+
+  Receive(NoChangeResponse(1));
+  Receive(MalformedResponse());
+  Receive(NoChangeResponse(3));
+  tester.ForceFinish(stream->context(),
+                     {{Type::Read, CompletionResult::Error},
+                      {Type::Finish, grpc::Status::OK}});
+
+  worker_queue->EnqueueBlocking([&] {
+    EXPECT_EQ(callback.target_ids, std::vector<TargetId>{1});
+    ASSERT_TRUE(callback.close_status.has_value());
+    EXPECT_FALSE(callback.close_status->ok());
+  });
+}
+
+TEST_F(WatchStreamTest, DropsPendingResponsesWhenStopped) {
+  StartStream(Executor::CreateSerial("WatchStreamTest"));
+  BlockDecoder();
+
+  Receive(NoChangeResponse(1));
+  worker_queue->EnqueueBlocking([&] {
+    tester.KeepPollingGrpcQueue();
+    stream->Stop();
+  });
+
+  Unblock();
+  DrainDecoder();
+  worker_queue->EnqueueBlocking([&] {
+    ASSERT_TRUE(callback.close_status.has_value());
+    EXPECT_TRUE(callback.close_status->ok());
+    EXPECT_TRUE(callback.target_ids.empty());
+  });
+}
+
+TEST_F(WatchStreamTest, SuspendsReadsWhileResponsesArePending) {
+  StartStream(Executor::CreateSerial("WatchStreamTest"));
+  BlockDecoder();
+
+  std::vector<TargetId> expected;
+  for (TargetId target_id = 1; target_id < 64; ++target_id) {
+    Receive(NoChangeResponse(target_id));
+    expected.push_back(target_id);
+  }
+  EXPECT_FALSE(AreReadsSuspended());
+
+  Receive(NoChangeResponse(64));
+  expected.push_back(64);
+  EXPECT_TRUE(AreReadsSuspended());
+
+  // Reads resume once the backlog has been delivered.
+  Unblock();
+  AwaitChanges(expected.size());
+  EXPECT_FALSE(AreReadsSuspended());
+
+  Receive(NoChangeResponse(65));
+  expected.push_back(65);
+  AwaitChanges(expected.size());
+  worker_queue->EnqueueBlocking(
+      [&] { EXPECT_EQ(callback.target_ids, expected); });
+}
+
+}  // namespace remote
+}  // namespace firestore
+}  // namespace firebase
@@ -0,0 +1,96 @@
+/*
+ * Copyright 2021 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Firestore/core/src/util/arena.h"
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <utility>
+
+#include "gtest/gtest.h"
+
+namespace firebase {
+namespace firestore {
+namespace util {
+
+namespace {
+
+bool IsAligned(const void* ptr, size_t alignment) {
+  return reinterpret_cast<uintptr_t>(ptr) % alignment == 0;
+}
+
+}  // namespace
+
+TEST(ArenaTest, AllocationsAreAligned) {
+  Arena arena;
+  arena.Allocate(1, 1);
+  for (size_t alignment : {1, 2, 4, 8, 16}) {
+    EXPECT_TRUE(IsAligned(arena.Allocate(3, alignment), alignment));
+  }
+  EXPECT_TRUE(IsAligned(arena.Allocate(64 * 1024, 64), 64));
+}
+
+TEST(ArenaTest, CopiesStrings) {
+  Arena arena;
+  std::string original = "value";
+  absl::string_view copy = arena.CopyString(original);
+  original[0] = 'V';
+
+  EXPECT_EQ(copy, "value");
+  EXPECT_EQ(arena.CopyString(""), "");
+}
+
+TEST(ArenaTest, SharesBlocksBetweenSmallAllocations) {
+  Arena arena;
+  EXPECT_EQ(arena.memory_usage(), 0);
+
+  arena.Allocate(16);
+  size_t first_block = arena.memory_usage();
+  for (int i = 0; i < 100; ++i) {
+    arena.Allocate(16);
+  }
+  EXPECT_EQ(arena.memory_usage(), first_block);
+}
+
+TEST(ArenaTest, KeepsLargeAllocationsSeparate) {
+  Arena arena;
+  void* small = arena.Allocate(16);
+  arena.Allocate(1 << 20);
+  void* next = arena.Allocate(16);
+
+  // The rest of the first block is still used after the large allocation.
+  EXPECT_EQ(static_cast<char*>(next) - static_cast<char*>(small), 16);
+}
+
+TEST(ArenaTest, BacksContainers) {
+  Arena arena;
+  using Allocator = ArenaAllocator<std::pair<const int, std::string>>;
+  std::map<int, std::string, std::less<int>, Allocator> map{Allocator(&arena)};
+  for (int i = 0; i < 1000; ++i) {
+    map[i] = std::to_string(i);
+  }
+  map.erase(500);
+
+  EXPECT_EQ(map.size(), 999);
+  EXPECT_EQ(map[999], "999");
+  EXPECT_GT(arena.memory_usage(), 1000 * sizeof(int));
+}
+
+}  // namespace util
+}  // namespace firestore
+}  // namespace firebase
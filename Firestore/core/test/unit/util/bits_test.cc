@@ -95,6 +95,22 @@ TEST_F(BitsTest, Log2Random64) {
   }
 }
 
+TEST_F(BitsTest, CountTrailingZeros) {
+  for (int i = 0; i < 32; i++) {
+    uint32_t n = 1U << i;
+    EXPECT_EQ(i, Bits::CountTrailingZerosNonZero(n));
+    EXPECT_EQ(i, Bits::CountTrailingZerosNonZero(n | (n << 1)));
+    EXPECT_EQ(i, Bits::CountTrailingZerosNonZero(~(n - 1)));
+  }
+
+  for (int i = 0; i < 64; i++) {
+    uint64_t n = 1ULL << i;
+    EXPECT_EQ(i, Bits::CountTrailingZerosNonZero64(n));
+    EXPECT_EQ(i, Bits::CountTrailingZerosNonZero64(n | (n << 1)));
+    EXPECT_EQ(i, Bits::CountTrailingZerosNonZero64(~(n - 1)));
+  }
+}
+
 TEST(Bits, Port32) {
   for (int shift = 0; shift < 32; shift++) {
     for (uint32_t delta = 0; delta <= 2; delta++) {
@@ -106,6 +122,12 @@ TEST(Bits, Port32) {
       }
     }
   }
+  for (int shift = 0; shift < 32; shift++) {
+    const uint32_t v = ~static_cast<uint32_t>(0) << shift;
+    EXPECT_EQ(Bits::CountTrailingZerosNonZero_Portable(v),
+              Bits::CountTrailingZerosNonZero(v))
+        << v;
+  }
   static const uint32_t M32 = std::numeric_limits<uint32_t>::max();
   EXPECT_EQ(Bits::Log2Floor_Portable(M32), Bits::Log2Floor(M32)) << M32;
   EXPECT_EQ(Bits::Log2FloorNonZero_Portable(M32), Bits::Log2FloorNonZero(M32))
@@ -124,6 +146,12 @@ TEST(Bits, Port64) {
       }
     }
   }
+  for (int shift = 0; shift < 64; shift++) {
+    const uint64_t v = ~static_cast<uint64_t>(0) << shift;
+    EXPECT_EQ(Bits::CountTrailingZerosNonZero64_Portable(v),
+              Bits::CountTrailingZerosNonZero64(v))
+        << v;
+  }
   static const uint64_t M64 = std::numeric_limits<uint64_t>::max();
   EXPECT_EQ(Bits::Log2Floor64_Portable(M64), Bits::Log2Floor64(M64)) << M64;
   EXPECT_EQ(Bits::Log2FloorNonZero64_Portable(M64),
@@ -14,6 +14,11 @@
  * limitations under the License.
  */
 
+#include <algorithm>
+#include <iterator>
+#include <string>
+#include <vector>
+
 #include "Firestore/core/src/util/ordered_code.h"
 #include "Firestore/core/src/util/secure_random.h"
 #include "benchmark/benchmark.h"
@@ -61,3 +66,69 @@ BENCHMARK(BM_SkipToNextSpecialByte)
     ->Arg(1 << 9)
     ->Arg(1 << 10)
     ->Arg(1 << 15);
+
+/**
+ * Creates strings of `len` bytes with one special byte in every
+ * `special_interval` bytes on average, or none if `special_interval` is 0.
+ */
+static std::vector<std::string> MakeStrings(int64_t len,
+                                            int64_t special_interval) {
+  SecureRandom rnd;
+  const int kValues = 1024;
+  std::vector<std::string> values(kValues);
+  for (std::string& s : values) {
+    std::generate_n(std::back_inserter(s), len, [&] {
+      if (special_interval > 0 &&
+          rnd.OneIn(static_cast<uint32_t>(special_interval))) {
+        return static_cast<char>(rnd.OneIn(2) ? 0 : 255);
+      }
+      return static_cast<char>(rnd.Uniform(254) + 1);
+    });
+  }
+  return values;
+}
+
+static void BM_WriteString(benchmark::State& state) {
+  std::vector<std::string> values = MakeStrings(state.range(0), state.range(1));
+
+  size_t index = 0;
+  std::string dest;
+  for (auto _ : state) {
+    dest.clear();
+    OrderedCode::WriteString(&dest, values[index++ % values.size()]);
+    benchmark::DoNotOptimize(dest);
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_WriteString)
+    ->Args({16, 0})
+    ->Args({64, 0})
+    ->Args({256, 0})
+    ->Args({4096, 0})
+    ->Args({256, 64})
+    ->Args({256, 8});
+
+static void BM_ReadString(benchmark::State& state) {
+  std::vector<std::string> values = MakeStrings(state.range(0), state.range(1));
+  std::vector<std::string> encoded(values.size());
+  for (size_t i = 0; i < values.size(); ++i) {
+    OrderedCode::WriteString(&encoded[i], values[i]);
+  }
+
+  size_t index = 0;
+  std::string result;
+  for (auto _ : state) {
+    absl::string_view src = encoded[index++ % encoded.size()];
+    result.clear();
+    bool ok = OrderedCode::ReadString(&src, &result);
+    benchmark::DoNotOptimize(ok);
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ReadString)
+    ->Args({16, 0})
+    ->Args({64, 0})
+    ->Args({256, 0})
+    ->Args({4096, 0})
+    ->Args({256, 64})
+    ->Args({256, 8});
@@ -289,6 +289,33 @@ TEST(OrderedCode, ExhaustiveFindSpecial) {
   EXPECT_EQ(count, 256 * 256 * 256 * 2);
 }
 
+TEST(OrderedCode, SkipToNextSpecialByteAtAllAlignments) {
+  // Scans start at every offset within the widest vector, so that special
+  // bytes are found at every position of the vectors and in the bytes scanned
+  // after the last whole vector.
+  SecureRandom rnd;
+  std::string buf;
+  for (int i = 0; i < 128; i++) {
+    buf += static_cast<char>(1 + rnd.Uniform(254));
+  }
+
+  for (size_t start = 0; start < 32; start++) {
+    for (size_t len = 0; start + len <= buf.size(); len++) {
+      const char* p = buf.data() + start;
+      EXPECT_EQ(p + len, OrderedCode::TEST_SkipToNextSpecialByte(p, p + len));
+
+      for (size_t special_pos = 0; special_pos < len; special_pos++) {
+        std::string special_buf = buf;
+        special_buf[start + special_pos] = rnd.OneIn(2) ? 0 : '\xff';
+        const char* q = special_buf.data() + start;
+        EXPECT_EQ(q + special_pos,
+                  OrderedCode::TEST_SkipToNextSpecialByte(q, q + len))
+            << "start=" << start << " len=" << len;
+      }
+    }
+  }
+}
+
 TEST(OrderedCodeUint64, EncodeDecode) {
   TestNumbers<uint64_t>(1);
 }
@@ -454,6 +481,25 @@ TEST(OrderedCodeString, EncodeDecode) {
   }
 }
 
+TEST(OrderedCodeString, EncodeDecodeLongRuns) {
+  // Long runs without special bytes are copied in bulk; special bytes at
+  // either end of a run must still be escaped.
+  SecureRandom rnd;
+  for (int len = 0; len < 512; len += 7) {
+    for (int special_interval : {0, 2, 17, 64}) {
+      std::string value;
+      for (int i = 0; i < len; i++) {
+        if (special_interval > 0 && i % special_interval == 0) {
+          value += rnd.OneIn(2) ? '\0' : '\xff';
+        } else {
+          value += static_cast<char>(1 + rnd.Uniform(254));
+        }
+      }
+      TestWriteRead(INCREASING, value);
+    }
+  }
+}
+
 // 'str' is a static C-style string that may contain '\0'
 #define STATIC_STR(str) absl::string_view((str), sizeof(str) - 1)
 
@@ -21,6 +21,7 @@
 #include "Firestore/core/src/local/leveldb_key.h"
 #include "Firestore/core/src/local/leveldb_util.h"
 
+using firebase::firestore::local::LevelDbCollectionMutationKey;
 using firebase::firestore::local::LevelDbDocumentMutationKey;
 using firebase::firestore::local::LevelDbDocumentTargetKey;
 using firebase::firestore::local::LevelDbMutationKey;
@@ -80,6 +81,20 @@ extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
     // Ignore caught errors and assertions.
   }
 
+  // Test LevelDbCollectionMutationKey methods.
+  try {
+    LevelDbCollectionMutationKey::KeyPrefix(str);
+  } catch (...) {
+    // Ignore caught errors and assertions.
+  }
+
+  try {
+    LevelDbCollectionMutationKey key;
+    (void)key.Decode(str);
+  } catch (...) {
+    // Ignore caught errors and assertions.
+  }
+
   // Test LevelDbMutationQueueKey methods.
   try {
     LevelDbMutationQueueKey::Key(str);